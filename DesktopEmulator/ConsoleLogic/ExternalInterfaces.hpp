@@ -78,24 +78,31 @@ namespace V32
     // =============================================================================
     
     
-    // note that providing all these callbacks is required:
-    // the console will invoke them without any checks
-    namespace Callbacks
+    // Each console is given a frontend implementing these
+    // functions. Since they are called on an object, a process
+    // can run several consoles, each one with its own frontend.
+    // Note that a frontend must be set before using the console:
+    // it will invoke these functions without any checks
+    class VirconFrontendInterface
     {
-        // callbacks to the video library
-        extern void( *ClearScreen )( V32::GPUColor );
-        extern void( *DrawQuad )( V32::GPUQuad& );
-        extern void( *SetMultiplyColor )( V32::GPUColor );
-        extern void( *SetBlendingMode )( int );
-        extern void( *SelectTexture )( int );
-        extern void( *LoadTexture )( int, void* );
-        extern void( *UnloadCartridgeTextures )();
-        extern void( *UnloadBiosTexture )();
-        
-        // callbacks to the log library
-        extern void( *LogLine )( const std::string& );
-        extern void( *ThrowException )( const std::string& );
-    }
+        public:
+            
+            virtual ~VirconFrontendInterface() {}
+            
+            // callbacks to the video library
+            virtual void ClearScreen( GPUColor ClearColor ) = 0;
+            virtual void DrawQuad( GPUQuad& DrawnQuad ) = 0;
+            virtual void SetMultiplyColor( GPUColor NewMultiplyColor ) = 0;
+            virtual void SetBlendingMode( int NewBlendingMode ) = 0;
+            virtual void SelectTexture( int GPUTextureID ) = 0;
+            virtual void LoadTexture( int GPUTextureID, void* Pixels, int Width, int Height ) = 0;
+            virtual void UnloadCartridgeTextures() = 0;
+            virtual void UnloadBiosTexture() = 0;
+            
+            // callbacks to the log library
+            virtual void LogLine( const std::string& Message ) = 0;
+            virtual void ThrowException( const std::string& Message ) = 0;
+    };
     
     
     // =============================================================================
@@ -0,0 +1,569 @@
+// *****************************************************************************
+    // include console logic headers
+    #include "GPUTraces.hpp"
+    #include "AuxiliaryFunctions.hpp"
+    
+    // include C/C++ headers
+    #include <cstring>          // [ ANSI C ] Strings
+    
+    // declare used namespaces
+    using namespace std;
+// *****************************************************************************
+
+
+namespace V32
+{
+    // =============================================================================
+    //      AUXILIARY FUNCTIONS
+    // =============================================================================
+    
+    
+    bool IsRectangleQuad( const GPUQuad& Quad )
+    {
+        const GPUPoint* V = Quad.Vertices;
+        
+        // vertices are top-left, top-right,
+        // bottom-left and bottom-right
+        return V[ 0 ].y == V[ 1 ].y && V[ 2 ].y == V[ 3 ].y
+            && V[ 0 ].x == V[ 2 ].x && V[ 1 ].x == V[ 3 ].x
+            && V[ 0 ].texture_y == V[ 1 ].texture_y && V[ 2 ].texture_y == V[ 3 ].texture_y
+            && V[ 0 ].texture_x == V[ 2 ].texture_x && V[ 1 ].texture_x == V[ 3 ].texture_x;
+    }
+    
+    // -----------------------------------------------------------------------------
+    
+    static bool IsValidTextureID( int32_t GPUTextureID )
+    {
+        return IsBetween( GPUTextureID, -1, Constants::GPUMaximumCartridgeTextures - 1 );
+    }
+    
+    
+    // =============================================================================
+    //      GPU TRACE RECORDER: INSTANCE HANDLING
+    // =============================================================================
+    
+    
+    GPUTraceRecorder::GPUTraceRecorder()
+    {
+        Target = nullptr;
+        memset( &Header, 0, sizeof(Header) );
+        
+        InitialStatePending = false;
+        InitialMultiplyColor = LastMultiplyColor = { 255, 255, 255, 255 };
+        InitialBlendingMode = LastBlendingMode = (int32_t)IOPortValues::GPUBlendingMode_Alpha;
+        InitialTexture = LastTexture = -1;
+    }
+    
+    
+    // =============================================================================
+    //      GPU TRACE RECORDER: WRITING COMMANDS
+    // =============================================================================
+    
+    
+    void GPUTraceRecorder::WriteCommand( GPUTraceCommands Command, const void* Parameters, int Size )
+    {
+        OutputFile.put( (char)Command );
+        
+        if( Size > 0 )
+          OutputFile.write( (const char*)Parameters, Size );
+    }
+    
+    // -----------------------------------------------------------------------------
+    
+    // the initial textures end when the render state is written
+    void GPUTraceRecorder::WriteInitialState()
+    {
+        Header.InitialTexturesSize = (int32_t)OutputFile.tellp() - sizeof(Header);
+        InitialStatePending = false;
+        
+        WriteCommand( GPUTraceCommands::SetMultiplyColor, &InitialMultiplyColor, 4 );
+        WriteCommand( GPUTraceCommands::SetBlendingMode, &InitialBlendingMode, 4 );
+        WriteCommand( GPUTraceCommands::SelectTexture, &InitialTexture, 4 );
+    }
+    
+    // -----------------------------------------------------------------------------
+    
+    // any command other than the initial texture loads
+    void GPUTraceRecorder::WriteRenderCommand( GPUTraceCommands Command, const void* Parameters, int Size )
+    {
+        if( InitialStatePending )
+          WriteInitialState();
+        
+        WriteCommand( Command, Parameters, Size );
+    }
+    
+    
+    // =============================================================================
+    //      GPU TRACE RECORDER: CONTROL OF RECORDING
+    // =============================================================================
+    
+    
+    void GPUTraceRecorder::StartRecording( V32Console& Console, const string& FilePath )
+    {
+        if( IsRecording() )
+          Console.Frontend->ThrowException( "A GPU trace is already being recorded" );
+        
+        OpenOutputFile( OutputFile, FilePath, ios_base::binary | ios_base::trunc );
+        
+        if( OutputFile.fail() )
+          Console.Frontend->ThrowException( "Cannot create GPU trace file" );
+        
+        // the header is written again when stopping,
+        // once the sizes are known
+        memset( &Header, 0, sizeof(Header) );
+        memcpy( Header.Signature, GPUTraceFileFormat::Signature, 8 );
+        Header.Version = GPUTraceFileFormat::Version;
+        
+        if( Console.HasCartridge() )
+          strncpy( Header.CartridgeTitle, Console.CartridgeController.CartridgeTitle.c_str(), sizeof(Header.CartridgeTitle) - 1 );
+        
+        OutputFile.write( (char*)&Header, sizeof(Header) );
+        
+        // the GPU sends every change of these to the
+        // frontend, so they match the current render state
+        InitialMultiplyColor = LastMultiplyColor = Console.GPU.MultiplyColor;
+        InitialBlendingMode = LastBlendingMode = Console.GPU.ActiveBlending;
+        InitialTexture = LastTexture = Console.GPU.SelectedTexture;
+        InitialStatePending = true;
+        
+        // from now on, video calls go through us
+        Target = Console.Frontend;
+        Console.SetFrontend( this );
+        Target->LogLine( "Started recording GPU trace" );
+    }
+    
+    // -----------------------------------------------------------------------------
+    
+    void GPUTraceRecorder::RecordTexture( int GPUTextureID, void* Pixels, int Width, int Height )
+    {
+        int32_t Parameters[ 3 ] = { GPUTextureID, Width, Height };
+        WriteCommand( GPUTraceCommands::LoadTexture, Parameters, sizeof(Parameters) );
+        OutputFile.write( (char*)Pixels, Width * Height * 4 );
+    }
+    
+    // -----------------------------------------------------------------------------
+    
+    void GPUTraceRecorder::EndFrame()
+    {
+        if( !IsRecording() )
+          return;
+        
+        WriteRenderCommand( GPUTraceCommands::EndFrame );
+        Header.NumberOfFrames++;
+    }
+    
+    // -----------------------------------------------------------------------------
+    
+    void GPUTraceRecorder::Stop( V32Console& Console )
+    {
+        if( !IsRecording() )
+          return;
+        
+        // make sure the initial state is included
+        if( InitialStatePending )
+          WriteInitialState();
+        
+        Console.SetFrontend( Target );
+        Target = nullptr;
+        
+        OutputFile.seekp( 0 );
+        OutputFile.write( (char*)&Header, sizeof(Header) );
+        bool WriteFailed = OutputFile.fail();
+        
+        OutputFile.close();
+        OutputFile.clear();
+        
+        if( WriteFailed )
+          Console.Frontend->ThrowException( "Cannot write GPU trace file" );
+        
+        Console.Frontend->LogLine( "Saved GPU trace (" + to_string( Header.NumberOfFrames ) + " frames)" );
+    }
+    
+    // -----------------------------------------------------------------------------
+    
+    bool GPUTraceRecorder::IsRecording()
+    {
+        return (Target != nullptr);
+    }
+    
+    // -----------------------------------------------------------------------------
+    
+    int32_t GPUTraceRecorder::GetRecordedFrames()
+    {
+        return Header.NumberOfFrames;
+    }
+    
+    
+    // =============================================================================
+    //      GPU TRACE RECORDER: FRONTEND FUNCTIONS
+    // =============================================================================
+    
+    
+    void GPUTraceRecorder::ClearScreen( GPUColor ClearColor )
+    {
+        WriteRenderCommand( GPUTraceCommands::ClearScreen, &ClearColor, 4 );
+        Target->ClearScreen( ClearColor );
+    }
+    
+    // -----------------------------------------------------------------------------
+    
+    void GPUTraceRecorder::DrawQuad( GPUQuad& DrawnQuad )
+    {
+        if( IsRectangleQuad( DrawnQuad ) )
+        {
+            GPUPoint Corners[ 2 ] = { DrawnQuad.Vertices[ 0 ], DrawnQuad.Vertices[ 3 ] };
+            WriteRenderCommand( GPUTraceCommands::DrawRectangle, Corners, sizeof(Corners) );
+        }
+        
+        else
+          WriteRenderCommand( GPUTraceCommands::DrawQuad, &DrawnQuad, sizeof(GPUQuad) );
+        
+        Target->DrawQuad( DrawnQuad );
+    }
+    
+    // -----------------------------------------------------------------------------
+    
+    // the GPU notifies every register write, but only
+    // actual changes of the render state are recorded
+    void GPUTraceRecorder::SetMultiplyColor( GPUColor NewMultiplyColor )
+    {
+        if( memcmp( &NewMultiplyColor, &LastMultiplyColor, 4 ) )
+        {
+            WriteRenderCommand( GPUTraceCommands::SetMultiplyColor, &NewMultiplyColor, 4 );
+            LastMultiplyColor = NewMultiplyColor;
+        }
+        
+        Target->SetMultiplyColor( NewMultiplyColor );
+    }
+    
+    // -----------------------------------------------------------------------------
+    
+    void GPUTraceRecorder::SetBlendingMode( int NewBlendingMode )
+    {
+        if( NewBlendingMode != LastBlendingMode )
+        {
+            int32_t Mode = NewBlendingMode;
+            WriteRenderCommand( GPUTraceCommands::SetBlendingMode, &Mode, 4 );
+            LastBlendingMode = Mode;
+        }
+        
+        Target->SetBlendingMode( NewBlendingMode );
+    }
+    
+    // -----------------------------------------------------------------------------
+    
+    void GPUTraceRecorder::SelectTexture( int GPUTextureID )
+    {
+        if( GPUTextureID != LastTexture )
+        {
+            int32_t TextureID = GPUTextureID;
+            WriteRenderCommand( GPUTraceCommands::SelectTexture, &TextureID, 4 );
+            LastTexture = TextureID;
+        }
+        
+        Target->SelectTexture( GPUTextureID );
+    }
+    
+    // -----------------------------------------------------------------------------
+    
+    void GPUTraceRecorder::LoadTexture( int GPUTextureID, void* Pixels, int Width, int Height )
+    {
+        int32_t Parameters[ 3 ] = { GPUTextureID, Width, Height };
+        WriteRenderCommand( GPUTraceCommands::LoadTexture, Parameters, sizeof(Parameters) );
+        OutputFile.write( (char*)Pixels, Width * Height * 4 );
+        
+        Target->LoadTexture( GPUTextureID, Pixels, Width, Height );
+    }
+    
+    // -----------------------------------------------------------------------------
+    
+    void GPUTraceRecorder::UnloadCartridgeTextures()
+    {
+        WriteRenderCommand( GPUTraceCommands::UnloadCartridgeTextures );
+        Target->UnloadCartridgeTextures();
+    }
+    
+    // -----------------------------------------------------------------------------
+    
+    void GPUTraceRecorder::UnloadBiosTexture()
+    {
+        WriteRenderCommand( GPUTraceCommands::UnloadBiosTexture );
+        Target->UnloadBiosTexture();
+    }
+    
+    // -----------------------------------------------------------------------------
+    
+    void GPUTraceRecorder::LogLine( const string& Message )
+    {
+        Target->LogLine( Message );
+    }
+    
+    // -----------------------------------------------------------------------------
+    
+    void GPUTraceRecorder::ThrowException( const string& Message )
+    {
+        Target->ThrowException( Message );
+    }
+    
+    
+    // =============================================================================
+    //      GPU TRACE PLAYER: INSTANCE HANDLING
+    // =============================================================================
+    
+    
+    GPUTracePlayer::GPUTracePlayer()
+    {
+        memset( &Header, 0, sizeof(Header) );
+        Position = 0;
+        CurrentFrame = 0;
+    }
+    
+    
+    // =============================================================================
+    //      GPU TRACE PLAYER: FILE HANDLING
+    // =============================================================================
+    
+    
+    void GPUTracePlayer::LoadFile( VirconFrontendInterface& Frontend, const string& FilePath )
+    {
+        Commands.clear();
+        Position = 0;
+        CurrentFrame = 0;
+        
+        ifstream InputFile;
+        OpenInputFile( InputFile, FilePath, ios_base::binary | ios_base::ate );
+        
+        if( InputFile.fail() )
+          Frontend.ThrowException( "Cannot open GPU trace file" );
+        
+        size_t FileBytes = InputFile.tellg();
+        InputFile.seekg( 0 );
+        InputFile.read( (char*)&Header, sizeof(Header) );
+        
+        if( InputFile.fail() || !CheckSignature( Header.Signature, GPUTraceFileFormat::Signature ) )
+          Frontend.ThrowException( "GPU trace file does not have a valid signature" );
+        
+        if( Header.Version != GPUTraceFileFormat::Version )
+          Frontend.ThrowException( "GPU trace file has an unsupported version" );
+        
+        // make sure the title is terminated
+        Header.CartridgeTitle[ sizeof(Header.CartridgeTitle) - 1 ] = 0;
+        
+        Commands.resize( FileBytes - sizeof(Header) );
+        InputFile.read( (char*)Commands.data(), Commands.size() );
+        
+        if( InputFile.fail() )
+          Frontend.ThrowException( "GPU trace file is incomplete" );
+        
+        // check all commands now, so that
+        // playback does not need to check them
+        int32_t NumberOfFrames = 0;
+        bool InitialTexturesFound = (Header.InitialTexturesSize == 0);
+        
+        while( Position < Commands.size() )
+        {
+            if( (int32_t)Position == Header.InitialTexturesSize )
+              InitialTexturesFound = true;
+            
+            GPUTraceCommands Command = (GPUTraceCommands)Commands[ Position++ ];
+            size_t ParametersSize = 4;
+            
+            if( !InitialTexturesFound && Command != GPUTraceCommands::LoadTexture )
+              Frontend.ThrowException( "GPU trace file has incorrect initial textures" );
+            
+            switch( Command )
+            {
+                case GPUTraceCommands::EndFrame:
+                    NumberOfFrames++;
+                    ParametersSize = 0;
+                    break;
+                
+                case GPUTraceCommands::UnloadCartridgeTextures:
+                case GPUTraceCommands::UnloadBiosTexture:
+                    ParametersSize = 0;
+                    break;
+                
+                case GPUTraceCommands::ClearScreen:
+                case GPUTraceCommands::SetMultiplyColor:
+                case GPUTraceCommands::SetBlendingMode:
+                    break;
+                
+                case GPUTraceCommands::DrawQuad:
+                    ParametersSize = sizeof(GPUQuad);
+                    break;
+                
+                case GPUTraceCommands::DrawRectangle:
+                    ParametersSize = 2 * sizeof(GPUPoint);
+                    break;
+                
+                case GPUTraceCommands::SelectTexture:
+                {
+                    int32_t TextureID = -1;
+                    
+                    if( Position + 4 <= Commands.size() )
+                      memcpy( &TextureID, &Commands[ Position ], 4 );
+                    
+                    if( !IsValidTextureID( TextureID ) )
+                      Frontend.ThrowException( "GPU trace file selects an incorrect texture" );
+                    
+                    break;
+                }
+                
+                case GPUTraceCommands::LoadTexture:
+                {
+                    int32_t Parameters[ 3 ] = { 0, 0, 0 };
+                    
+                    if( Position + 12 <= Commands.size() )
+                      memcpy( Parameters, &Commands[ Position ], 12 );
+                    
+                    if( !IsValidTextureID( Parameters[ 0 ] )
+                    ||  !IsBetween( Parameters[ 1 ], 1, Constants::GPUTextureSize )
+                    ||  !IsBetween( Parameters[ 2 ], 1, Constants::GPUTextureSize ) )
+                      Frontend.ThrowException( "GPU trace file loads an incorrect texture" );
+                    
+                    ParametersSize = 12 + 4 * Parameters[ 1 ] * Parameters[ 2 ];
+                    break;
+                }
+                
+                default:
+                    Frontend.ThrowException( "GPU trace file contains an unknown command" );
+            }
+            
+            Position += ParametersSize;
+            
+            if( Position > Commands.size() )
+              Frontend.ThrowException( "GPU trace file is incomplete" );
+        }
+        
+        if( (int32_t)Position == Header.InitialTexturesSize )
+          InitialTexturesFound = true;
+        
+        if( !InitialTexturesFound || NumberOfFrames != Header.NumberOfFrames )
+          Frontend.ThrowException( "GPU trace file has incorrect sizes" );
+        
+        Position = 0;
+    }
+    
+    
+    // =============================================================================
+    //      GPU TRACE PLAYER: PLAYBACK
+    // =============================================================================
+    
+    
+    void GPUTracePlayer::LoadInitialTextures( VirconFrontendInterface& Frontend )
+    {
+        Position = 0;
+        
+        while( Position < (size_t)Header.InitialTexturesSize )
+        {
+            int32_t Parameters[ 3 ];
+            memcpy( Parameters, &Commands[ Position + 1 ], 12 );
+            Frontend.LoadTexture( Parameters[ 0 ], &Commands[ Position + 13 ], Parameters[ 1 ], Parameters[ 2 ] );
+            Position += 13 + 4 * Parameters[ 1 ] * Parameters[ 2 ];
+        }
+        
+        CurrentFrame = 0;
+    }
+    
+    // -----------------------------------------------------------------------------
+    
+    bool GPUTracePlayer::PlayNextFrame( VirconFrontendInterface& Frontend )
+    {
+        if( CurrentFrame >= Header.NumberOfFrames )
+          return false;
+        
+        while( true )
+        {
+            GPUTraceCommands Command = (GPUTraceCommands)Commands[ Position++ ];
+            const uint8_t* Parameters = &Commands[ Position ];
+            
+            switch( Command )
+            {
+                case GPUTraceCommands::EndFrame:
+                {
+                    CurrentFrame++;
+                    return true;
+                }
+                
+                case GPUTraceCommands::ClearScreen:
+                {
+                    GPUColor Color;
+                    memcpy( &Color, Parameters, 4 );
+                    Frontend.ClearScreen( Color );
+                    Position += 4;
+                    break;
+                }
+                
+                case GPUTraceCommands::DrawQuad:
+                {
+                    GPUQuad Quad;
+                    memcpy( &Quad, Parameters, sizeof(GPUQuad) );
+                    Frontend.DrawQuad( Quad );
+                    Position += sizeof(GPUQuad);
+                    break;
+                }
+                
+                case GPUTraceCommands::DrawRectangle:
+                {
+                    // rebuild the other 2 vertices
+                    GPUQuad Quad;
+                    memcpy( &Quad.Vertices[ 0 ], Parameters, sizeof(GPUPoint) );
+                    memcpy( &Quad.Vertices[ 3 ], Parameters + sizeof(GPUPoint), sizeof(GPUPoint) );
+                    Quad.Vertices[ 1 ] = { Quad.Vertices[ 3 ].x, Quad.Vertices[ 0 ].y, Quad.Vertices[ 3 ].texture_x, Quad.Vertices[ 0 ].texture_y };
+                    Quad.Vertices[ 2 ] = { Quad.Vertices[ 0 ].x, Quad.Vertices[ 3 ].y, Quad.Vertices[ 0 ].texture_x, Quad.Vertices[ 3 ].texture_y };
+                    Frontend.DrawQuad( Quad );
+                    Position += 2 * sizeof(GPUPoint);
+                    break;
+                }
+                
+                case GPUTraceCommands::SetMultiplyColor:
+                {
+                    GPUColor Color;
+                    memcpy( &Color, Parameters, 4 );
+                    Frontend.SetMultiplyColor( Color );
+                    Position += 4;
+                    break;
+                }
+                
+                case GPUTraceCommands::SetBlendingMode:
+                {
+                    int32_t Mode;
+                    memcpy( &Mode, Parameters, 4 );
+                    Frontend.SetBlendingMode( Mode );
+                    Position += 4;
+                    break;
+                }
+                
+                case GPUTraceCommands::SelectTexture:
+                {
+                    int32_t TextureID;
+                    memcpy( &TextureID, Parameters, 4 );
+                    Frontend.SelectTexture( TextureID );
+                    Position += 4;
+                    break;
+                }
+                
+                case GPUTraceCommands::LoadTexture:
+                {
+                    int32_t Sizes[ 3 ];
+                    memcpy( Sizes, Parameters, 12 );
+                    Frontend.LoadTexture( Sizes[ 0 ], (void*)(Parameters + 12), Sizes[ 1 ], Sizes[ 2 ] );
+                    Position += 12 + 4 * Sizes[ 1 ] * Sizes[ 2 ];
+                    break;
+                }
+                
+                case GPUTraceCommands::UnloadCartridgeTextures:
+                {
+                    Frontend.UnloadCartridgeTextures();
+                    break;
+                }
+                
+                case GPUTraceCommands::UnloadBiosTexture:
+                {
+                    Frontend.UnloadBiosTexture();
+                    break;
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,180 @@
+// *****************************************************************************
+    // start include guard
+    #ifndef GPUTRACES_HPP
+    #define GPUTRACES_HPP
+    
+    // include console logic headers
+    #include "V32Console.hpp"
+    
+    // include C/C++ headers
+    #include <string>         // [ C++ STL ] Strings
+    #include <vector>         // [ C++ STL ] Vectors
+    #include <fstream>        // [ C++ STL ] File streams
+// *****************************************************************************
+
+
+namespace V32
+{
+    // =============================================================================
+    //      GPU TRACE FILE FORMAT
+    // =============================================================================
+    
+    
+    // A GPU trace stores everything the console sent to its
+    // frontend's video functions, so that the same frames can
+    // be rendered again without running the console. Traces
+    // can start at any point: the textures loaded at that time
+    // and the current render state are written first.
+    namespace GPUTraceFileFormat
+    {
+        const char Signature[] = "V32-GTRC";
+        const uint32_t Version = 1;
+        
+        typedef struct
+        {
+            char Signature[ 8 ];        // no null termination! (always taken as 8 characters)
+            uint32_t Version;
+            
+            // the cartridge the trace was recorded with
+            char CartridgeTitle[ 64 ];
+            
+            // number of EndFrame commands in the trace
+            int32_t NumberOfFrames;
+            
+            // the commands that follow start by loading the
+            // initial textures, taking this many bytes, so
+            // that frames can be played again after them
+            int32_t InitialTexturesSize;
+        }
+        Header;
+    }
+    
+    // -----------------------------------------------------------------------------
+    
+    // After the header, the file is a sequence of commands.
+    // Each one is a single byte followed by its parameters,
+    // which are always 4-byte words (texture pixels included)
+    enum class GPUTraceCommands: uint8_t
+    {
+        EndFrame = 0,               // no parameters
+        ClearScreen,                // color
+        DrawQuad,                   // 4 vertices (16 floats)
+        DrawRectangle,              // 2 opposite vertices (8 floats)
+        SetMultiplyColor,           // color
+        SetBlendingMode,            // mode
+        SelectTexture,              // texture ID
+        LoadTexture,                // texture ID, width, height, pixels
+        UnloadCartridgeTextures,    // no parameters
+        UnloadBiosTexture           // no parameters
+    };
+    
+    // most quads drawn by the GPU are not rotated, and those
+    // only need vertices 0 and 3 to be stored (DrawRectangle)
+    bool IsRectangleQuad( const GPUQuad& Quad );
+    
+    
+    // =============================================================================
+    //      GPU TRACE RECORDER
+    // =============================================================================
+    
+    
+    // While recording, the recorder becomes the console's
+    // frontend: it writes all video calls to the trace and
+    // then passes them on to the previous frontend. Textures
+    // loaded before recording have to be provided by the
+    // program with RecordTexture, since the console does not
+    // keep the texture pixels. Frames are ended by calling
+    // EndFrame after each frame that is presented
+    class GPUTraceRecorder: public VirconFrontendInterface
+    {
+        protected:
+            
+            VirconFrontendInterface* Target;
+            std::ofstream OutputFile;
+            GPUTraceFileFormat::Header Header;
+            
+            // render state last written to the trace; the
+            // initial one is written after initial textures
+            bool InitialStatePending;
+            GPUColor InitialMultiplyColor;
+            int32_t InitialBlendingMode;
+            int32_t InitialTexture;
+            GPUColor LastMultiplyColor;
+            int32_t LastBlendingMode;
+            int32_t LastTexture;
+            
+            void WriteCommand( GPUTraceCommands Command, const void* Parameters = nullptr, int Size = 0 );
+            void WriteInitialState();
+            void WriteRenderCommand( GPUTraceCommands Command, const void* Parameters = nullptr, int Size = 0 );
+            
+        public:
+            
+            // instance handling
+            GPUTraceRecorder();
+            
+            // control of recording
+            void StartRecording( V32Console& Console, const std::string& FilePath );
+            void RecordTexture( int GPUTextureID, void* Pixels, int Width, int Height );
+            void EndFrame();
+            void Stop( V32Console& Console );
+            bool IsRecording();
+            int32_t GetRecordedFrames();
+            
+            // video functions callable by the console
+            void ClearScreen( GPUColor ClearColor ) override;
+            void DrawQuad( GPUQuad& DrawnQuad ) override;
+            void SetMultiplyColor( GPUColor NewMultiplyColor ) override;
+            void SetBlendingMode( int NewBlendingMode ) override;
+            void SelectTexture( int GPUTextureID ) override;
+            void LoadTexture( int GPUTextureID, void* Pixels, int Width, int Height ) override;
+            void UnloadCartridgeTextures() override;
+            void UnloadBiosTexture() override;
+            
+            // log functions callable by the console
+            void LogLine( const std::string& Message ) override;
+            void ThrowException( const std::string& Message ) override;
+    };
+    
+    
+    // =============================================================================
+    //      GPU TRACE PLAYER
+    // =============================================================================
+    
+    
+    // The whole trace is loaded in memory and checked when
+    // loaded, so that playing it adds as little overhead as
+    // possible to the frontend that renders it
+    class GPUTracePlayer
+    {
+        public:
+            
+            GPUTraceFileFormat::Header Header;
+            std::vector< uint8_t > Commands;
+            
+            // progress of playback
+            size_t Position;
+            int32_t CurrentFrame;
+            
+        public:
+            
+            // instance handling
+            GPUTracePlayer();
+            
+            // file handling (errors are reported through
+            // the given frontend, as the console would)
+            void LoadFile( VirconFrontendInterface& Frontend, const std::string& FilePath );
+            
+            // playback: initial textures are loaded first
+            // (this also goes back to the first frame), and
+            // then frames can be played; it returns false
+            // when there are no more frames
+            void LoadInitialTextures( VirconFrontendInterface& Frontend );
+            bool PlayNextFrame( VirconFrontendInterface& Frontend );
+    };
+}
+
+
+// *****************************************************************************
+    // end include guard
+    #endif
+// *****************************************************************************
@@ -0,0 +1,342 @@
+// *****************************************************************************
+    // include console logic headers
+    #include "InputMovies.hpp"
+    #include "AuxiliaryFunctions.hpp"
+    
+    // include C/C++ headers
+    #include <cstring>          // [ ANSI C ] Strings
+    
+    // declare used namespaces
+    using namespace std;
+// *****************************************************************************
+
+
+namespace V32
+{
+    // =============================================================================
+    //      AUXILIARY FUNCTIONS
+    // =============================================================================
+    
+    
+    // FNV-1a applied to whole words: it is not
+    // meant to be secure, only fast and sensitive
+    // to any change in the hashed values
+    static void HashWord( uint32_t& Hash, uint32_t Word )
+    {
+        Hash ^= Word;
+        Hash *= 16777619u;
+    }
+    
+    // -----------------------------------------------------------------------------
+    
+    uint32_t GetConsoleChecksum( const V32Console& Console )
+    {
+        uint32_t Hash = 2166136261u;
+        
+        // any difference in execution will
+        // sooner or later show up in RAM
+        for( const V32Word& Word: Console.RAM.Memory )
+          HashWord( Hash, Word.AsBinary );
+        
+        // include the CPU state
+        const V32CPU& CPU = Console.CPU;
+        
+        for( int i = 0; i < 11; i++ )
+          HashWord( Hash, CPU.Registers[ i ].AsBinary );
+        
+        HashWord( Hash, CPU.CountRegister.AsBinary );
+        HashWord( Hash, CPU.SourceRegister.AsBinary );
+        HashWord( Hash, CPU.DestinationRegister.AsBinary );
+        HashWord( Hash, CPU.BasePointer.AsBinary );
+        HashWord( Hash, CPU.StackPointer.AsBinary );
+        HashWord( Hash, CPU.InstructionPointer.AsBinary );
+        HashWord( Hash, CPU.Halted );
+        HashWord( Hash, CPU.Waiting );
+        
+        // include the minor chips
+        HashWord( Hash, Console.Timer.CurrentDate );
+        HashWord( Hash, Console.Timer.CurrentTime );
+        HashWord( Hash, Console.Timer.FrameCounter );
+        HashWord( Hash, Console.Timer.CycleCounter );
+        HashWord( Hash, Console.RNG.CurrentValue );
+        
+        return Hash;
+    }
+    
+    // -----------------------------------------------------------------------------
+    
+    uint32_t GetMovieInput( const GamepadState& Gamepad )
+    {
+        uint32_t Input = (Gamepad.Connected? MovieInputConnected : 0);
+        const int32_t* Controls = &Gamepad.Left;
+        
+        for( int i = 0; i < 11; i++ )
+        {
+            // other times can only come from increasing
+            // the previous ones at the start of the frame
+            MovieControlCodes Code = MovieControlCodes::Continues;
+            
+            if( Controls[ i ] == 1 )     Code = MovieControlCodes::JustPressed;
+            if( Controls[ i ] == -1 )    Code = MovieControlCodes::JustReleased;
+            if( Controls[ i ] == -3600 ) Code = MovieControlCodes::ReleasedLong;
+            
+            Input |= (uint32_t)Code << (1 + 2*i);
+        }
+        
+        return Input;
+    }
+    
+    // -----------------------------------------------------------------------------
+    
+    // the gamepad must be in its state from the previous
+    // frame, so that times of unchanged controls continue
+    void ApplyMovieInput( GamepadState& Gamepad, uint32_t Input )
+    {
+        Gamepad.Connected = ((Input & MovieInputConnected) != 0);
+        int32_t* Controls = &Gamepad.Left;
+        
+        for( int i = 0; i < 11; i++ )
+        {
+            MovieControlCodes Code = (MovieControlCodes)((Input >> (1 + 2*i)) & 3);
+            
+            if( Code == MovieControlCodes::JustPressed )  Controls[ i ] = 1;
+            if( Code == MovieControlCodes::JustReleased ) Controls[ i ] = -1;
+            if( Code == MovieControlCodes::ReleasedLong ) Controls[ i ] = -3600;
+        }
+    }
+    
+    
+    // =============================================================================
+    //      INPUT MOVIE: INSTANCE HANDLING
+    // =============================================================================
+    
+    
+    InputMovie::InputMovie()
+    {
+        Mode = InputMovieModes::Idle;
+        memset( &Header, 0, sizeof(Header) );
+        CurrentFrame = 0;
+        DivergenceFrame = -1;
+    }
+    
+    
+    // =============================================================================
+    //      INPUT MOVIE: RECORDING AND PLAYBACK
+    // =============================================================================
+    
+    
+    // puts the console in the initial state of the movie
+    void InputMovie::ResetConsole( V32Console& Console )
+    {
+        Console.Reset();
+        Console.Timer.CurrentDate = Header.InitialDate;
+        Console.Timer.CurrentTime = Header.InitialTime;
+        Console.RNG.CurrentValue = Header.InitialRandomSeed;
+        
+        // gamepads start with all controls released, since
+        // their previous times are not part of the movie
+        for( int Gamepad = 0; Gamepad < Constants::GamepadPorts; Gamepad++ )
+        {
+            Console.GamepadController.ResetGamepad( Gamepad );
+            PlayedGamepadStates[ Gamepad ] = Console.GamepadController.RealTimeGamepadStates[ Gamepad ];
+        }
+        
+        CurrentFrame = 0;
+        DivergenceFrame = -1;
+    }
+    
+    // -----------------------------------------------------------------------------
+    
+    void InputMovie::StartRecording( V32Console& Console, int32_t ChecksumInterval )
+    {
+        if( !Console.IsPowerOn() || !Console.HasCartridge() )
+          Console.Frontend->ThrowException( "Input movies can only be recorded with the console on and a cartridge" );
+        
+        if( ChecksumInterval <= 0 )
+          Console.Frontend->ThrowException( "Input movie checksum interval must be positive" );
+        
+        // identify the cartridge
+        memset( &Header, 0, sizeof(Header) );
+        memcpy( Header.Signature, InputMovieFileFormat::Signature, 8 );
+        Header.Version = InputMovieFileFormat::Version;
+        strncpy( Header.CartridgeTitle, Console.CartridgeController.CartridgeTitle.c_str(), sizeof(Header.CartridgeTitle) - 1 );
+        Header.ProgramROMSize = Console.CartridgeController.MemorySize;
+        
+        // keep the current date and time; the random
+        // seed is the one the console gets on reset
+        Header.InitialDate = Console.Timer.CurrentDate;
+        Header.InitialTime = Console.Timer.CurrentTime;
+        Console.RNG.Reset();
+        Header.InitialRandomSeed = Console.RNG.CurrentValue;
+        Header.ChecksumInterval = ChecksumInterval;
+        
+        Inputs.clear();
+        Checksums.clear();
+        ResetConsole( Console );
+        
+        Mode = InputMovieModes::Recording;
+        Console.Frontend->LogLine( "Started recording input movie" );
+    }
+    
+    // -----------------------------------------------------------------------------
+    
+    void InputMovie::StartPlayback( V32Console& Console )
+    {
+        if( !Console.IsPowerOn() || !Console.HasCartridge() )
+          Console.Frontend->ThrowException( "Input movies can only be played with the console on and a cartridge" );
+        
+        // reject movies from other cartridges
+        if( strncmp( Header.CartridgeTitle, Console.CartridgeController.CartridgeTitle.c_str(), sizeof(Header.CartridgeTitle) - 1 )
+        ||  Header.ProgramROMSize != Console.CartridgeController.MemorySize )
+          Console.Frontend->ThrowException( "Input movie was recorded with a different cartridge" );
+        
+        ResetConsole( Console );
+        
+        Mode = InputMovieModes::Playing;
+        Console.Frontend->LogLine( "Started playing input movie (" + to_string( Header.NumberOfFrames ) + " frames)" );
+    }
+    
+    // -----------------------------------------------------------------------------
+    
+    void InputMovie::Stop()
+    {
+        if( Mode == InputMovieModes::Recording )
+        {
+            Header.NumberOfFrames = CurrentFrame;
+            Header.NumberOfChecksums = Checksums.size();
+        }
+        
+        Mode = InputMovieModes::Idle;
+    }
+    
+    // -----------------------------------------------------------------------------
+    
+    void InputMovie::RunNextFrame( V32Console& Console )
+    {
+        // movies only advance while the console runs
+        if( Mode == InputMovieModes::Idle || !Console.IsPowerOn() )
+        {
+            Console.RunNextFrame();
+            return;
+        }
+        
+        GamepadState* RealTimeStates = Console.GamepadController.RealTimeGamepadStates;
+        
+        // the console's gamepads are the source when recording
+        if( Mode == InputMovieModes::Recording )
+        {
+            for( int Gamepad = 0; Gamepad < Constants::GamepadPorts; Gamepad++ )
+              Inputs.push_back( GetMovieInput( RealTimeStates[ Gamepad ] ) );
+        }
+        
+        // when playing, discard any changes made since
+        // the last frame and apply the recorded ones
+        else
+        {
+            if( CurrentFrame >= Header.NumberOfFrames )
+            {
+                Mode = InputMovieModes::Idle;
+                Console.Frontend->LogLine( "Finished playing input movie" );
+                Console.RunNextFrame();
+                return;
+            }
+            
+            for( int Gamepad = 0; Gamepad < Constants::GamepadPorts; Gamepad++ )
+            {
+                RealTimeStates[ Gamepad ] = PlayedGamepadStates[ Gamepad ];
+                ApplyMovieInput( RealTimeStates[ Gamepad ], Inputs[ CurrentFrame * Constants::GamepadPorts + Gamepad ] );
+            }
+        }
+        
+        Console.RunNextFrame();
+        
+        if( Mode == InputMovieModes::Playing )
+          memcpy( PlayedGamepadStates, RealTimeStates, sizeof(PlayedGamepadStates) );
+        
+        CurrentFrame++;
+        
+        // checksums are taken at the end of every interval
+        if( CurrentFrame % Header.ChecksumInterval )
+          return;
+        
+        uint32_t Checksum = GetConsoleChecksum( Console );
+        
+        if( Mode == InputMovieModes::Recording )
+        {
+            Checksums.push_back( Checksum );
+            return;
+        }
+        
+        // only report the first divergence, since
+        // after it all checksums are expected to fail
+        unsigned ChecksumIndex = CurrentFrame / Header.ChecksumInterval - 1;
+        
+        if( ChecksumIndex < Checksums.size() && Checksums[ ChecksumIndex ] != Checksum && DivergenceFrame < 0 )
+        {
+            DivergenceFrame = CurrentFrame - 1;
+            Console.Frontend->LogLine( "Input movie diverged from the recording at frame " + to_string( DivergenceFrame ) );
+        }
+    }
+    
+    
+    // =============================================================================
+    //      INPUT MOVIE: FILE HANDLING
+    // =============================================================================
+    
+    
+    void InputMovie::SaveFile( V32Console& Console, const string& FilePath )
+    {
+        if( Mode == InputMovieModes::Recording )
+          Console.Frontend->ThrowException( "Input movie recording has to be stopped before saving it" );
+        
+        ofstream OutputFile;
+        OpenOutputFile( OutputFile, FilePath, ios_base::binary );
+        
+        if( OutputFile.fail() )
+          Console.Frontend->ThrowException( "Cannot create input movie file" );
+        
+        OutputFile.write( (char*)&Header, sizeof(Header) );
+        OutputFile.write( (char*)Inputs.data(), Inputs.size() * 4 );
+        OutputFile.write( (char*)Checksums.data(), Checksums.size() * 4 );
+        
+        if( OutputFile.fail() )
+          Console.Frontend->ThrowException( "Cannot write input movie file" );
+    }
+    
+    // -----------------------------------------------------------------------------
+    
+    void InputMovie::LoadFile( V32Console& Console, const string& FilePath )
+    {
+        Mode = InputMovieModes::Idle;
+        
+        ifstream InputFile;
+        OpenInputFile( InputFile, FilePath, ios_base::binary );
+        
+        if( InputFile.fail() )
+          Console.Frontend->ThrowException( "Cannot open input movie file" );
+        
+        InputFile.read( (char*)&Header, sizeof(Header) );
+        
+        if( InputFile.fail() || !CheckSignature( Header.Signature, InputMovieFileFormat::Signature ) )
+          Console.Frontend->ThrowException( "Input movie file does not have a valid signature" );
+        
+        if( Header.Version != InputMovieFileFormat::Version )
+          Console.Frontend->ThrowException( "Input movie file has an unsupported version" );
+        
+        // check that sizes are coherent
+        if( Header.NumberOfFrames < 0 || Header.ChecksumInterval <= 0
+        ||  !IsBetween( Header.NumberOfChecksums, 0, Header.NumberOfFrames / Header.ChecksumInterval ) )
+          Console.Frontend->ThrowException( "Input movie file has incorrect sizes" );
+        
+        // make sure the title is terminated
+        Header.CartridgeTitle[ sizeof(Header.CartridgeTitle) - 1 ] = 0;
+        
+        Inputs.resize( Header.NumberOfFrames * Constants::GamepadPorts );
+        Checksums.resize( Header.NumberOfChecksums );
+        InputFile.read( (char*)Inputs.data(), Inputs.size() * 4 );
+        InputFile.read( (char*)Checksums.data(), Checksums.size() * 4 );
+        
+        if( InputFile.fail() )
+          Console.Frontend->ThrowException( "Input movie file is incomplete" );
+    }
+}
@@ -0,0 +1,151 @@
+// *****************************************************************************
+    // start include guard
+    #ifndef INPUTMOVIES_HPP
+    #define INPUTMOVIES_HPP
+    
+    // include console logic headers
+    #include "V32Console.hpp"
+    
+    // include C/C++ headers
+    #include <string>         // [ C++ STL ] Strings
+    #include <vector>         // [ C++ STL ] Vectors
+// *****************************************************************************
+
+
+namespace V32
+{
+    // =============================================================================
+    //      INPUT MOVIE FILE FORMAT
+    // =============================================================================
+    
+    
+    // An input movie makes a cartridge run exactly the same
+    // way every time. It starts from a console reset with a
+    // known date, time and random seed, and then provides
+    // the inputs of all gamepads on each frame.
+    // Memory cards are not part of the movie, so cartridges
+    // that use them will only replay correctly when the card
+    // has the same contents it had when recording.
+    namespace InputMovieFileFormat
+    {
+        const char Signature[] = "V32-MOVI";
+        const uint32_t Version = 1;
+        
+        typedef struct
+        {
+            char Signature[ 8 ];        // no null termination! (always taken as 8 characters)
+            uint32_t Version;
+            
+            // the cartridge the movie was recorded with
+            char CartridgeTitle[ 64 ];
+            int32_t ProgramROMSize;
+            
+            // console state after the initial reset
+            int32_t InitialDate;
+            int32_t InitialTime;
+            int32_t InitialRandomSeed;
+            
+            // sizes of the 2 sections that follow the header:
+            // first, 1 input word per frame for each gamepad port;
+            // then 1 checksum word every ChecksumInterval frames
+            int32_t NumberOfFrames;
+            int32_t ChecksumInterval;
+            int32_t NumberOfChecksums;
+        }
+        Header;
+    }
+    
+    // -----------------------------------------------------------------------------
+    
+    // Each input word stores the state of a gamepad on a frame.
+    // Bit 0 is the connection, and each control i (in the order
+    // of GamepadControls) uses 2 bits starting at bit 1+2*i.
+    // Storing only the pressed state would not be enough: the
+    // console counts the frames since each change, and within
+    // a frame a control can be pressed and released again, or
+    // a gamepad can be reconnected, resetting all its times.
+    // So the codes store the values that these events can set
+    enum class MovieControlCodes: uint32_t
+    {
+        Continues = 0,      // no events: time keeps increasing
+        JustPressed,        // time is 1
+        JustReleased,       // time is -1
+        ReleasedLong        // time is -3600 (as after a reset)
+    };
+    
+    const uint32_t MovieInputConnected = 1;
+    
+    
+    // =============================================================================
+    //      INPUT MOVIE CLASS
+    // =============================================================================
+    
+    
+    enum class InputMovieModes
+    {
+        Idle,
+        Recording,
+        Playing
+    };
+    
+    // -----------------------------------------------------------------------------
+    
+    // To record or play a movie, call its RunNextFrame
+    // instead of the console's. Any gamepad events given
+    // to the console during playback are discarded
+    class InputMovie
+    {
+        public:
+            
+            InputMovieModes Mode;
+            InputMovieFileFormat::Header Header;
+            std::vector< uint32_t > Inputs;
+            std::vector< uint32_t > Checksums;
+            
+            // progress of recording or playback
+            int32_t CurrentFrame;
+            int32_t DivergenceFrame;    // first frame with a wrong checksum, or -1
+            
+            // gamepad states as left by the last played frame
+            GamepadState PlayedGamepadStates[ Constants::GamepadPorts ];
+            
+        protected:
+            
+            void ResetConsole( V32Console& Console );
+            
+        public:
+            
+            // instance handling
+            InputMovie();
+            
+            // control of recording and playback
+            void StartRecording( V32Console& Console, int32_t ChecksumInterval = 60 );
+            void StartPlayback( V32Console& Console );
+            void Stop();
+            void RunNextFrame( V32Console& Console );
+            
+            // file handling
+            void SaveFile( V32Console& Console, const std::string& FilePath );
+            void LoadFile( V32Console& Console, const std::string& FilePath );
+    };
+    
+    
+    // =============================================================================
+    //      AUXILIARY FUNCTIONS
+    // =============================================================================
+    
+    
+    // summarizes the state of the console in a single word, so that
+    // we can detect when 2 executions stop behaving the same way
+    uint32_t GetConsoleChecksum( const V32Console& Console );
+    
+    // conversions between gamepad states and movie inputs
+    uint32_t GetMovieInput( const GamepadState& Gamepad );
+    void ApplyMovieInput( GamepadState& Gamepad, uint32_t Input );
+}
+
+
+// *****************************************************************************
+    // end include guard
+    #endif
+// *****************************************************************************
@@ -121,6 +121,7 @@ namespace V32
     {
         MemoryBus = nullptr;
         ControlBus = nullptr;
+        Frontend = nullptr;
     }
     
     // -----------------------------------------------------------------------------
@@ -144,6 +145,9 @@ namespace V32
         // clear instruction registers
         memset( &Instruction, 0, sizeof(V32Word) );
         ImmediateValue.AsBinary = 0;
+        
+        // previously seen loops are no longer valid
+        IdleLoops.Reset();
     }
     
     // -----------------------------------------------------------------------------
@@ -151,6 +155,9 @@ namespace V32
     void V32CPU::ChangeFrame()
     {
         Waiting = false;
+        
+        // an iteration can't continue after a frame change
+        IdleLoops.StopObserving( false );
     }
     
     // -----------------------------------------------------------------------------
@@ -158,12 +165,18 @@ namespace V32
     void V32CPU::RunNextCycle()
     {
         // fetch next instruction
+        int32_t InstructionAddress = InstructionPointer.AsInteger;
         MemoryBus->ReadAddress( InstructionPointer.AsInteger++, (V32Word&)Instruction );
         
         // fetch its immediate value, if needed
         if( Instruction.UsesImmediate )
           MemoryBus->ReadAddress( InstructionPointer.AsInteger++, ImmediateValue );
         
+        // when observing a loop, this may advance
+        // the cycle counter before the loop head runs
+        if( IdleLoops.Observing )
+          IdleLoops.CheckInstruction( *this, InstructionAddress );
+        
         // run the instruction
         // (redirect to the needed specific processor)
         int32_t OpCode = Instruction.OpCode;
@@ -172,6 +185,10 @@ namespace V32
           MOVProcessorTable[ Instruction.AddressingMode ]( *this, Instruction );
         else
           InstructionProcessorTable[ Instruction.OpCode ]( *this, Instruction );
+        
+        // jumping back may close a waiting loop
+        if( InstructionPointer.AsInteger < InstructionAddress )
+          IdleLoops.CheckBackwardJump( *this, InstructionAddress );
     }
     
     // -----------------------------------------------------------------------------
@@ -193,6 +210,9 @@ namespace V32
         // jump to BIOS handler routine
         InstructionPointer.AsInteger = Constants::BiosProgramROMFirstAddress;
         
+        // an observed loop can't be idle after this
+        IdleLoops.StopObserving( true );
+        
         // abort any normal instruction processing
         throw CPUException();
     }
@@ -8,6 +8,8 @@
     
     // include console logic headers
     #include "V32Buses.hpp"
+    #include "V32IdleLoopDetector.hpp"
+    #include "ExternalInterfaces.hpp"
 // *****************************************************************************
 
 
@@ -40,11 +42,15 @@ namespace V32
             int32_t Halted;
             int32_t Waiting;
             
+            // skips cycles in loops that only wait
+            V32IdleLoopDetector IdleLoops;
+            
         public:
             
             // connections with the host Vircon system
             V32MemoryBus* MemoryBus;
             V32ControlBus* ControlBus;
+            VirconFrontendInterface* Frontend;
             
         public:
             
@@ -63,7 +63,7 @@ namespace V32
     void ProcessHLT( V32CPU& CPU, CPUInstruction Instruction )
     {
         CPU.Halted = true;
-        Callbacks::LogLine( "CPU halted" );
+        CPU.Frontend->LogLine( "CPU halted" );
     }
     
     // -----------------------------------------------------------------------------
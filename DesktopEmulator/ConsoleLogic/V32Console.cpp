@@ -18,10 +18,6 @@
 
 namespace V32
 {
-    // buffer used to transmit textures from loaded ROM files to the video library
-    static GPUColor LoadedTexture[ Constants::GPUTextureSize ][ Constants::GPUTextureSize ];
-    
-    
     // =============================================================================
     //      V32 CONSOLE: INSTANCE HANDLING
     // =============================================================================
@@ -56,9 +52,18 @@ namespace V32
         // connect main RAM
         RAM.Connect( Constants::RAMSize );
         
+        // connect idle loop detection with the
+        // components it needs to observe
+        CPU.IdleLoops.Timer = &Timer;
+        CPU.IdleLoops.RAM = &RAM;
+        CPU.IdleLoops.GamepadController = &GamepadController;
+        
         // set initial state
         PowerIsOn = false;
         
+        // no frontend until one is set
+        SetFrontend( nullptr );
+        
         // initial loads are 0
         LastCPULoads[ 0 ] = LastCPULoads[ 1 ] = 0;
         LastGPULoads[ 0 ] = LastGPULoads[ 1 ] = 0;
@@ -77,6 +82,21 @@ namespace V32
     }
     
     
+    // =============================================================================
+    //      V32 CONSOLE: CONNECTION WITH THE FRONTEND
+    // =============================================================================
+    
+    
+    // components that need the frontend get their own
+    // pointer to it, so they don't depend on the console
+    void V32Console::SetFrontend( VirconFrontendInterface* NewFrontend )
+    {
+        Frontend = NewFrontend;
+        CPU.Frontend = NewFrontend;
+        GPU.Frontend = NewFrontend;
+    }
+    
+    
     // =============================================================================
     //      V32 CONSOLE: CONTROL SIGNALS
     // =============================================================================
@@ -92,14 +112,14 @@ namespace V32
         // to take care of initializations
         if( On )
         {
-            Callbacks::LogLine( "Console power ON" );
+            Frontend->LogLine( "Console power ON" );
             Reset();
         }
         
         // at power off, stop all sound
         else
         {
-            Callbacks::LogLine( "Console power OFF" );
+            Frontend->LogLine( "Console power OFF" );
             SPU.StopAllChannels();
         }
     }
@@ -108,7 +128,7 @@ namespace V32
     
     void V32Console::Reset()
     {
-        Callbacks::LogLine( "Console reset" );
+        Frontend->LogLine( "Console reset" );
         
         // first: transmit the message to all components that need it
         Timer.Reset();
@@ -143,9 +163,11 @@ namespace V32
         GamepadController.ChangeFrame();
         
         // STEP 2: Run a frame's worth of cycles
+        // (the CPU can advance the cycle counter
+        // by itself when it detects idle loops)
         try
         {
-            for( int i = 0; i < Constants::CyclesPerFrame; i++ )
+            while( Timer.CycleCounter < Constants::CyclesPerFrame )
             {
                 // end loop early when CPU is set to wait
                 if( CPU.Waiting || CPU.Halted )
@@ -176,6 +198,16 @@ namespace V32
           SaveMemoryCard();
     }
     
+    // -----------------------------------------------------------------------------
+    
+    // the console state evolves the same way with or without
+    // output: only calls to the frontend and mixing are skipped
+    void V32Console::SetOutputSkipping( bool SkipVideo, bool SkipAudio )
+    {
+        GPU.SkipRendering = SkipVideo;
+        SPU.SkipOutput = SkipAudio;
+    }
+    
     
     // =============================================================================
     //      V32 CONSOLE: GENERAL STATUS QUERIES
@@ -222,8 +254,8 @@ namespace V32
     
     void V32Console::LoadBios( const std::string& FilePath )
     {
-        Callbacks::LogLine( "Loading bios" );
-        Callbacks::LogLine( "File path: \"" + FilePath + "\"" );
+        Frontend->LogLine( "Loading bios" );
+        Frontend->LogLine( "File path: \"" + FilePath + "\"" );
         
         // unload any previous bios
         UnloadBios();
@@ -233,7 +265,7 @@ namespace V32
         OpenInputFile( InputFile, FilePath, ios_base::binary | ios_base::ate );
         
         if( InputFile.fail() )
-          Callbacks::ThrowException( "Cannot open BIOS file" );
+          Frontend->ThrowException( "Cannot open BIOS file" );
         
         // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
         // STEP 1: Load global information
@@ -244,11 +276,11 @@ namespace V32
         unsigned FileBytes = InputFile.tellg();
         
         if( (FileBytes % 4) != 0 )
-          Callbacks::ThrowException( "Incorrect V32 file format (file size must be a multiple of 4)" );
+          Frontend->ThrowException( "Incorrect V32 file format (file size must be a multiple of 4)" );
         
         // ensure that we can at least load the file header
         if( FileBytes < sizeof(ROMFileFormat::Header) )
-          Callbacks::ThrowException( "Incorrect V32 file format (file is too small)" );
+          Frontend->ThrowException( "Incorrect V32 file format (file is too small)" );
         
         // now we can safely read the global header
         InputFile.seekg( 0, ios_base::beg );
@@ -257,20 +289,20 @@ namespace V32
         
         // check if the ROM is actually a cartridge
         if( CheckSignature( ROMHeader.Signature, ROMFileFormat::CartridgeSignature ) )
-          Callbacks::ThrowException( "Input V32 ROM cannot be loaded as a BIOS (is it a cartridge instead)" );
+          Frontend->ThrowException( "Input V32 ROM cannot be loaded as a BIOS (is it a cartridge instead)" );
         
         // now check the actual BIOS signature
         if( !CheckSignature( ROMHeader.Signature, ROMFileFormat::BiosSignature ) )
-          Callbacks::ThrowException( "Incorrect V32 file format (file does not have a valid signature)" );
+          Frontend->ThrowException( "Incorrect V32 file format (file does not have a valid signature)" );
         
         // check current Vircon version
         if( ROMHeader.VirconVersion  > (unsigned)Constants::VirconVersion
         ||  ROMHeader.VirconRevision > (unsigned)Constants::VirconRevision )
-          Callbacks::ThrowException( "This BIOS was made for a more recent version of Vircon32. Please use an updated emulator" );
+          Frontend->ThrowException( "This BIOS was made for a more recent version of Vircon32. Please use an updated emulator" );
         
         // report the title
         ROMHeader.Title[ 63 ] = 0;
-        Callbacks::LogLine( string("BIOS title: \"") + ROMHeader.Title + "\"" );
+        Frontend->LogLine( string("BIOS title: \"") + ROMHeader.Title + "\"" );
         
         // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
         // STEP 2: Check the declared rom contents
@@ -278,33 +310,33 @@ namespace V32
         
         // ensure that there is exactly 1 texture
         if( ROMHeader.NumberOfTextures != 1 )
-          Callbacks::ThrowException( "A BIOS video rom should have exactly 1 texture" );
+          Frontend->ThrowException( "A BIOS video rom should have exactly 1 texture" );
         
         // ensure that there is exactly 1 sound
         if( ROMHeader.NumberOfSounds != 1 )
-          Callbacks::ThrowException( "A BIOS audio rom should have exactly 1 sound" );
+          Frontend->ThrowException( "A BIOS audio rom should have exactly 1 sound" );
         
         // check for correct program rom location
         if( ROMHeader.ProgramROMLocation.StartOffset != sizeof(ROMFileFormat::Header) )
-          Callbacks::ThrowException( "Incorrect V32 file format (program ROM is not located after file header)" );
+          Frontend->ThrowException( "Incorrect V32 file format (program ROM is not located after file header)" );
         
         // check for correct video rom location
         uint32_t SizeAfterProgramROM = ROMHeader.ProgramROMLocation.StartOffset + ROMHeader.ProgramROMLocation.Length;
         
         if( ROMHeader.VideoROMLocation.StartOffset != SizeAfterProgramROM )
-          Callbacks::ThrowException( "Incorrect V32 file format (video ROM is not located after program ROM)" );
+          Frontend->ThrowException( "Incorrect V32 file format (video ROM is not located after program ROM)" );
         
         // check for correct audio rom location
         uint32_t SizeAfterVideoROM = ROMHeader.VideoROMLocation.StartOffset + ROMHeader.VideoROMLocation.Length;
         
         if( ROMHeader.AudioROMLocation.StartOffset != SizeAfterVideoROM )
-          Callbacks::ThrowException( "Incorrect V32 file format (audio ROM is not located after video ROM)" );
+          Frontend->ThrowException( "Incorrect V32 file format (audio ROM is not located after video ROM)" );
         
         // check for correct file size
         uint32_t SizeAfterAudioROM = ROMHeader.AudioROMLocation.StartOffset + ROMHeader.AudioROMLocation.Length;
         
         if( FileBytes != SizeAfterAudioROM )
-          Callbacks::ThrowException( "Incorrect V32 file format (file size does not match indicated ROM contents)" );
+          Frontend->ThrowException( "Incorrect V32 file format (file size does not match indicated ROM contents)" );
         
         // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
         // STEP 3: Load program rom
@@ -316,11 +348,11 @@ namespace V32
         
         // check signature for embedded binary
         if( !CheckSignature( BinaryHeader.Signature, BinaryFileFormat::Signature ) )
-          Callbacks::ThrowException( "BIOS binary does not have a valid signature" );
+          Frontend->ThrowException( "BIOS binary does not have a valid signature" );
         
         // checking program rom size limitations
         if( !IsBetween( BinaryHeader.NumberOfWords, 1, Constants::MaximumBiosProgramROM ) )
-          Callbacks::ThrowException( "BIOS binary does not have a correct size (from 1 word up to 1M words)" );
+          Frontend->ThrowException( "BIOS binary does not have a correct size (from 1 word up to 1M words)" );
         
         // load the binary contents
         vector< V32Word > LoadedBinary;
@@ -341,27 +373,25 @@ namespace V32
         
         // check signature for embedded texture
         if( !CheckSignature( TextureHeader.Signature, TextureFileFormat::Signature ) )
-          Callbacks::ThrowException( "BIOS texture does not have a valid signature" );
+          Frontend->ThrowException( "BIOS texture does not have a valid signature" );
         
         // report texture size
-        Callbacks::LogLine( "BIOS texture is " + to_string( TextureHeader.TextureWidth )
+        Frontend->LogLine( "BIOS texture is " + to_string( TextureHeader.TextureWidth )
            + "x" + to_string( TextureHeader.TextureHeight ) );
         
         // check texture size limitations
         if( !IsBetween( TextureHeader.TextureWidth , 1, Constants::GPUTextureSize )
         ||  !IsBetween( TextureHeader.TextureHeight, 1, Constants::GPUTextureSize ) )
-          Callbacks::ThrowException( "BIOS texture does not have correct dimensions (from 1x1 up to 1024x1024 pixels)" );
-        
-        // clear all texture pixels
-        memset( LoadedTexture, 0, sizeof(LoadedTexture) );
+          Frontend->ThrowException( "BIOS texture does not have correct dimensions (from 1x1 up to 1024x1024 pixels)" );
         
-        // load the texture pixels line by line,
-        // in order to expand it to full size
-        for( unsigned y = 0; y < TextureHeader.TextureHeight; y++ )
-          InputFile.read( (char*)(LoadedTexture[ y ]), TextureHeader.TextureWidth * 4 );
+        // load the texture pixels at their actual size; the
+        // video library will treat the rest of the 1024x1024
+        // texture space as transparent
+        vector< GPUColor > LoadedTexture( TextureHeader.TextureWidth * TextureHeader.TextureHeight );
+        InputFile.read( (char*)(&LoadedTexture[ 0 ]), LoadedTexture.size() * 4 );
         
         // send bios texture to the video library
-        Callbacks::LoadTexture( -1, LoadedTexture );
+        Frontend->LoadTexture( -1, &LoadedTexture[ 0 ], TextureHeader.TextureWidth, TextureHeader.TextureHeight );
         
         // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
         // STEP 5: Load audio rom
@@ -373,14 +403,14 @@ namespace V32
         
         // check signature for embedded sound
         if( !CheckSignature( SoundHeader.Signature, SoundFileFormat::Signature ) )
-          Callbacks::ThrowException( "BIOS sound does not have a valid signature" );
+          Frontend->ThrowException( "BIOS sound does not have a valid signature" );
         
         // report sound length
-        Callbacks::LogLine( "BIOS sound is " + to_string( SoundHeader.SoundSamples ) + " samples" );
+        Frontend->LogLine( "BIOS sound is " + to_string( SoundHeader.SoundSamples ) + " samples" );
         
         // check sound length limitations
         if( !IsBetween( SoundHeader.SoundSamples, 1, Constants::SPUMaximumBiosSamples ) )
-          Callbacks::ThrowException( "BIOS sound does not have a correct length (from 1 up to 1M samples)" );
+          Frontend->ThrowException( "BIOS sound does not have a correct length (from 1 up to 1M samples)" );
         
         // load the sound samples
         vector< SPUSample > LoadedSound;
@@ -400,7 +430,7 @@ namespace V32
         
         // close the file and report success
         InputFile.close();
-        Callbacks::LogLine( "Finished loading BIOS" );
+        Frontend->LogLine( "Finished loading BIOS" );
     }
     
     // -----------------------------------------------------------------------------
@@ -409,7 +439,7 @@ namespace V32
     {
         // do nothing if a bios is not loaded
         if( !HasBios() ) return;
-        Callbacks::LogLine( "Unloading bios" );
+        Frontend->LogLine( "Unloading bios" );
         
         // release bios program ROM
         BiosProgramROM.Disconnect();
@@ -419,7 +449,7 @@ namespace V32
         BiosRevision = 0;
         
         // release the bios texture
-        Callbacks::UnloadBiosTexture();
+        Frontend->UnloadBiosTexture();
         
         // tell SPU to release the bios sounds
         SPU.UnloadSound( SPU.BiosSound );
@@ -440,8 +470,8 @@ namespace V32
     
     void V32Console::LoadCartridge( const std::string& FilePath )
     {
-        Callbacks::LogLine( "Loading cartridge" );
-        Callbacks::LogLine( "File path: \"" + FilePath + "\"" );
+        Frontend->LogLine( "Loading cartridge" );
+        Frontend->LogLine( "File path: \"" + FilePath + "\"" );
     
         // unload any previous cartridge
         UnloadCartridge();
@@ -451,7 +481,7 @@ namespace V32
         OpenInputFile( InputFile, FilePath, ios_base::binary | ios_base::ate );
         
         if( InputFile.fail() )
-          Callbacks::ThrowException( "Cannot open cartridge file" );
+          Frontend->ThrowException( "Cannot open cartridge file" );
         
         // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
         // STEP 1: Load global information
@@ -462,11 +492,11 @@ namespace V32
         unsigned FileBytes = InputFile.tellg();
         
         if( (FileBytes % 4) != 0 )
-          Callbacks::ThrowException( "Incorrect V32 file format (file size must be a multiple of 4)" );
+          Frontend->ThrowException( "Incorrect V32 file format (file size must be a multiple of 4)" );
         
         // ensure that we can at least load the file header
         if( FileBytes < sizeof(ROMFileFormat::Header) )
-          Callbacks::ThrowException( "Incorrect V32 file format (file is too small)" );
+          Frontend->ThrowException( "Incorrect V32 file format (file is too small)" );
         
         // now we can safely read the global header
         InputFile.seekg( 0, ios_base::beg );
@@ -475,64 +505,64 @@ namespace V32
         
         // check if the ROM is actually a BIOS
         if( CheckSignature( ROMHeader.Signature, ROMFileFormat::BiosSignature ) )
-          Callbacks::ThrowException( "Input V32 ROM cannot be loaded as a cartridge (is it a BIOS instead)" );
+          Frontend->ThrowException( "Input V32 ROM cannot be loaded as a cartridge (is it a BIOS instead)" );
         
         // now check the actual cartridge signature
         if( !CheckSignature( ROMHeader.Signature, ROMFileFormat::CartridgeSignature ) )
-          Callbacks::ThrowException( "Incorrect V32 file format (file does not have a valid signature)" );
+          Frontend->ThrowException( "Incorrect V32 file format (file does not have a valid signature)" );
         
         // check current Vircon version
         if( ROMHeader.VirconVersion  > (unsigned)Constants::VirconVersion
         ||  ROMHeader.VirconRevision > (unsigned)Constants::VirconRevision )
-          Callbacks::ThrowException( "This cartridge was made for a more recent version of Vircon32. Please use an updated emulator" );
+          Frontend->ThrowException( "This cartridge was made for a more recent version of Vircon32. Please use an updated emulator" );
         
         // report the title
         ROMHeader.Title[ 63 ] = 0;
-        Callbacks::LogLine( string("Cartridge title: \"") + ROMHeader.Title + "\"" );
+        Frontend->LogLine( string("Cartridge title: \"") + ROMHeader.Title + "\"" );
         
         // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
         // STEP 2: Check the declared rom contents
         // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
         
         // check that there are not too many textures
-        Callbacks::LogLine( "Video ROM contains " + to_string( ROMHeader.NumberOfTextures ) + " textures" );
+        Frontend->LogLine( "Video ROM contains " + to_string( ROMHeader.NumberOfTextures ) + " textures" );
         
         if( ROMHeader.NumberOfTextures > (uint32_t)Constants::GPUMaximumCartridgeTextures )
-          Callbacks::ThrowException( "Video ROM contains too many textures (Vircon GPU only allows up to 256)" );
+          Frontend->ThrowException( "Video ROM contains too many textures (Vircon GPU only allows up to 256)" );
         
         // check that there are not too many sounds
-        Callbacks::LogLine( "Audio ROM contains " + to_string( ROMHeader.NumberOfSounds ) + " sounds" );
+        Frontend->LogLine( "Audio ROM contains " + to_string( ROMHeader.NumberOfSounds ) + " sounds" );
         
         if( ROMHeader.NumberOfSounds > (uint32_t)Constants::SPUMaximumCartridgeSounds )
-          Callbacks::ThrowException( "Audio ROM contains too many sounds (Vircon SPU only allows up to 1024)" );
+          Frontend->ThrowException( "Audio ROM contains too many sounds (Vircon SPU only allows up to 1024)" );
         
         // check for correct program rom location
         if( ROMHeader.ProgramROMLocation.StartOffset != sizeof(ROMFileFormat::Header) )
-          Callbacks::ThrowException( "Incorrect V32 file format (program ROM is not located after file header)" );
+          Frontend->ThrowException( "Incorrect V32 file format (program ROM is not located after file header)" );
         
         // check for correct video rom location
         uint32_t SizeAfterProgramROM = ROMHeader.ProgramROMLocation.StartOffset + ROMHeader.ProgramROMLocation.Length;
         
         if( ROMHeader.VideoROMLocation.StartOffset != SizeAfterProgramROM )
-          Callbacks::ThrowException( "Incorrect V32 file format (video ROM is not located after program ROM)" );
+          Frontend->ThrowException( "Incorrect V32 file format (video ROM is not located after program ROM)" );
         
         // check for correct audio rom location
         uint32_t SizeAfterVideoROM = ROMHeader.VideoROMLocation.StartOffset + ROMHeader.VideoROMLocation.Length;
         
         if( ROMHeader.AudioROMLocation.StartOffset != SizeAfterVideoROM )
-          Callbacks::ThrowException( "Incorrect V32 file format (audio ROM is not located after video ROM)" );
+          Frontend->ThrowException( "Incorrect V32 file format (audio ROM is not located after video ROM)" );
         
         // check for correct file size
         uint32_t SizeAfterAudioROM = ROMHeader.AudioROMLocation.StartOffset + ROMHeader.AudioROMLocation.Length;
         
         if( FileBytes != SizeAfterAudioROM )
-          Callbacks::ThrowException( "Incorrect V32 file format (file size does not match indicated ROM contents)" );
+          Frontend->ThrowException( "Incorrect V32 file format (file size does not match indicated ROM contents)" );
         
         // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
         // STEP 3: Load program rom
         // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
         
-        Callbacks::LogLine( "Loading cartridge program ROM" );
+        Frontend->LogLine( "Loading cartridge program ROM" );
         
         // load a binary file signature
         BinaryFileFormat::Header BinaryHeader;
@@ -540,13 +570,13 @@ namespace V32
         
         // check signature for embedded binary
         if( !CheckSignature( BinaryHeader.Signature, BinaryFileFormat::Signature ) )
-          Callbacks::ThrowException( "Cartridge binary does not have a valid signature" );
+          Frontend->ThrowException( "Cartridge binary does not have a valid signature" );
         
-        Callbacks::LogLine( "-> Program ROM is " + to_string( BinaryHeader.NumberOfWords ) + " words" );
+        Frontend->LogLine( "-> Program ROM is " + to_string( BinaryHeader.NumberOfWords ) + " words" );
         
         // check program rom size limitations
         if( !IsBetween( BinaryHeader.NumberOfWords, 1, Constants::MaximumCartridgeProgramROM ) )
-          Callbacks::ThrowException( "Cartridge program ROM does not have a correct size (from 1 word up to 128M words)" );
+          Frontend->ThrowException( "Cartridge program ROM does not have a correct size (from 1 word up to 128M words)" );
         
         // load the binary contents
         vector< V32Word > LoadedBinary;
@@ -561,7 +591,10 @@ namespace V32
         // STEP 4: Load video rom
         // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
         
-        Callbacks::LogLine( "Loading cartridge video ROM" );
+        Frontend->LogLine( "Loading cartridge video ROM" );
+        
+        // buffer reused for all textures
+        vector< GPUColor > LoadedTexture;
         
         // load all textures in sequence
         for( unsigned i = 0; i < ROMHeader.NumberOfTextures; i++ )
@@ -572,27 +605,23 @@ namespace V32
             
             // check signature for embedded texture
             if( !CheckSignature( TextureHeader.Signature, TextureFileFormat::Signature ) )
-              Callbacks::ThrowException( "Cartridge texture does not have a valid signature" );
+              Frontend->ThrowException( "Cartridge texture does not have a valid signature" );
             
             // report texture size
-            Callbacks::LogLine( "-> Texture " + to_string( i ) + ": " + to_string( TextureHeader.TextureWidth )
+            Frontend->LogLine( "-> Texture " + to_string( i ) + ": " + to_string( TextureHeader.TextureWidth )
                + " x " + to_string( TextureHeader.TextureHeight ) + " pixels" );
             
             // check texture size limitations
             if( !IsBetween( TextureHeader.TextureWidth , 1, Constants::GPUTextureSize )
             ||  !IsBetween( TextureHeader.TextureHeight, 1, Constants::GPUTextureSize ) )
-              Callbacks::ThrowException( "Cartridge texture does not have correct dimensions (1x1 up to 1024x1024 pixels)" );
-            
-            // clear all texture pixels
-            memset( LoadedTexture, 0, sizeof(LoadedTexture) );
+              Frontend->ThrowException( "Cartridge texture does not have correct dimensions (1x1 up to 1024x1024 pixels)" );
             
-            // load the texture pixels line by line,
-            // in order to expand it to full size
-            for( unsigned y = 0; y < TextureHeader.TextureHeight; y++ )
-              InputFile.read( (char*)(LoadedTexture[ y ]), TextureHeader.TextureWidth * 4 );
+            // load the texture pixels at their actual size
+            LoadedTexture.resize( TextureHeader.TextureWidth * TextureHeader.TextureHeight );
+            InputFile.read( (char*)(&LoadedTexture[ 0 ]), LoadedTexture.size() * 4 );
             
             // send this texture to the video library
-            Callbacks::LoadTexture( i, LoadedTexture );
+            Frontend->LoadTexture( i, &LoadedTexture[ 0 ], TextureHeader.TextureWidth, TextureHeader.TextureHeight );
         }
         
         // now update GPU with the inserted textures
@@ -602,7 +631,7 @@ namespace V32
         // STEP 5: Load audio rom
         // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
         
-        Callbacks::LogLine( "Loading cartridge audio ROM" );
+        Frontend->LogLine( "Loading cartridge audio ROM" );
         
         // keep count of the total sound samples
         uint32_t TotalSPUSamples = 0;
@@ -616,21 +645,21 @@ namespace V32
             
             // check signature for embedded sound
             if( !CheckSignature( SoundHeader.Signature, SoundFileFormat::Signature ) )
-              Callbacks::ThrowException( "Cartridge sound does not have a valid signature" );
+              Frontend->ThrowException( "Cartridge sound does not have a valid signature" );
             
             // report sound length
-            Callbacks::LogLine( "-> Sound " + to_string( i ) + ": " + to_string( SoundHeader.SoundSamples )
+            Frontend->LogLine( "-> Sound " + to_string( i ) + ": " + to_string( SoundHeader.SoundSamples )
                + " samples (" + to_string( SoundHeader.SoundSamples/44100.0f ) + " seconds)" );
             
             // check length limitations for this sound
             if( !IsBetween( SoundHeader.SoundSamples, 1, Constants::SPUMaximumCartridgeSamples ) )
-              Callbacks::ThrowException( "Cartridge sound does not have correct length (1 up to 256M samples)" );
+              Frontend->ThrowException( "Cartridge sound does not have correct length (1 up to 256M samples)" );
             
             // check length limitations for the whole SPU
             TotalSPUSamples += SoundHeader.SoundSamples;
             
             if( TotalSPUSamples > (uint32_t)Constants::SPUMaximumCartridgeSamples )
-              Callbacks::ThrowException( "Cartridge sounds contain too many total samples (Vircon SPU only allows up to 256M total samples)" );
+              Frontend->ThrowException( "Cartridge sounds contain too many total samples (Vircon SPU only allows up to 256M total samples)" );
             
             // load the sound samples
             vector< SPUSample > LoadedSound;
@@ -665,9 +694,9 @@ namespace V32
         
         // save the file name
         CartridgeController.CartridgeFileName = GetPathFileName( FilePath );
-        Callbacks::LogLine( "FilePath = \"" + FilePath );
-        Callbacks::LogLine( "CartridgeFileName = \"" + CartridgeController.CartridgeFileName );
-        Callbacks::LogLine( "Finished loading cartridge" );
+        Frontend->LogLine( "FilePath = \"" + FilePath );
+        Frontend->LogLine( "CartridgeFileName = \"" + CartridgeController.CartridgeFileName );
+        Frontend->LogLine( "Finished loading cartridge" );
     }
     
     // -----------------------------------------------------------------------------
@@ -676,7 +705,7 @@ namespace V32
     {
         // do nothing if a cartridge is not loaded
         if( !HasCartridge() ) return;
-        Callbacks::LogLine( "Unloading cartridge" );
+        Frontend->LogLine( "Unloading cartridge" );
         
         // release cartridge program ROM
         CartridgeController.Disconnect();
@@ -726,15 +755,15 @@ namespace V32
     
     void V32Console::CreateMemoryCard( const std::string& FilePath )
     {
-        Callbacks::LogLine( "Creating memory card" );
-        Callbacks::LogLine( "File path: \"" + FilePath + "\"" );
+        Frontend->LogLine( "Creating memory card" );
+        Frontend->LogLine( "File path: \"" + FilePath + "\"" );
         
         // open the file
         ofstream OutputFile;
         OpenOutputFile( OutputFile, FilePath, ios_base::binary | ios::trunc );
         
         if( OutputFile.fail() )
-          Callbacks::ThrowException( "Cannot create memory card file" );
+          Frontend->ThrowException( "Cannot create memory card file" );
         
         // save the signature
         WriteSignature( OutputFile, MemoryCardFileFormat::Signature );
@@ -746,15 +775,15 @@ namespace V32
         
         // close the file
         OutputFile.close();
-        Callbacks::LogLine( "Finished creating memory card" );
+        Frontend->LogLine( "Finished creating memory card" );
     }
     
     // -----------------------------------------------------------------------------
     
     void V32Console::LoadMemoryCard( const std::string& FilePath )
     {
-        Callbacks::LogLine( "Loading memory card" );
-        Callbacks::LogLine( "File path: \"" + FilePath + "\"" );
+        Frontend->LogLine( "Loading memory card" );
+        Frontend->LogLine( "File path: \"" + FilePath + "\"" );
     
         // unload any previous card
         UnloadMemoryCard();
@@ -764,7 +793,7 @@ namespace V32
         OpenInputOutputFile( InputFile, FilePath, ios_base::in | ios_base::out | ios::binary | ios::ate );
         
         if( InputFile.fail() )
-          Callbacks::ThrowException( "Cannot open memory card file" );
+          Frontend->ThrowException( "Cannot open memory card file" );
         
         // check file size coherency
         int NumberOfBytes = InputFile.tellg();
@@ -773,7 +802,7 @@ namespace V32
         if( NumberOfBytes != ExpectedBytes )
         {
             InputFile.close();
-            Callbacks::ThrowException( "Invalid memory card: File does not match the size of a Vircon memory card" );
+            Frontend->ThrowException( "Invalid memory card: File does not match the size of a Vircon memory card" );
         }
         
         // read and check signature
@@ -782,7 +811,7 @@ namespace V32
         InputFile.read( FileSignature, 8 );
         
         if( !CheckSignature( FileSignature, MemoryCardFileFormat::Signature ) )
-          Callbacks::ThrowException( "Memory card file does not have a valid signature" );
+          Frontend->ThrowException( "Memory card file does not have a valid signature" );
         
         // connect the memory
         MemoryCardController.Connect( Constants::MemoryCardSize );
@@ -796,7 +825,7 @@ namespace V32
         
         // save the file name
         MemoryCardController.CardFileName = GetPathFileName( FilePath );
-        Callbacks::LogLine( "Finished loading memory card" );
+        Frontend->LogLine( "Finished loading memory card" );
     }
     
     // -----------------------------------------------------------------------------
@@ -805,7 +834,7 @@ namespace V32
     {
         // do nothing if a card is not loaded
         if( !HasMemoryCard() ) return;
-        Callbacks::LogLine( "Unloading memory card" );
+        Frontend->LogLine( "Unloading memory card" );
         
         // save the card if it was modified
         if( MemoryCardController.PendingSave )
@@ -816,7 +845,7 @@ namespace V32
         
         // close the open file
         MemoryCardController.LinkedFile.close();
-        Callbacks::LogLine( "Finished unloading memory card" );
+        Frontend->LogLine( "Finished unloading memory card" );
     }
     
     // -----------------------------------------------------------------------------
@@ -830,7 +859,7 @@ namespace V32
         fstream& OutputFile = MemoryCardController.LinkedFile;
         
         if( !OutputFile.is_open() || OutputFile.fail() )
-          Callbacks::ThrowException( "Cannot save memory card file" );
+          Frontend->ThrowException( "Cannot save memory card file" );
         
         // save the signature
         OutputFile.seekp( ios_base::beg );
@@ -53,6 +53,9 @@ namespace V32
             // internal state
             bool PowerIsOn;
             
+            // functions provided by the program running the console
+            VirconFrontendInterface* Frontend;
+            
             // additional data about the connected bios
             std::string BiosFileName;
             std::string BiosTitle;
@@ -73,11 +76,18 @@ namespace V32
             //   EXTERNAL INTERFACES: API FUNCTIONS
             // - - - - - - - - - - - - - - - - - - - - - - - -
             
+            // connection with the frontend
+            void SetFrontend( VirconFrontendInterface* NewFrontend );
+            
             // control signals
             void SetPower( bool On );
             void Reset();
             void RunNextFrame();
             
+            // frontends can run frames without producing
+            // video and/or audio output, to skip them faster
+            void SetOutputSkipping( bool SkipVideo, bool SkipAudio );
+            
             // general status queries
             bool IsPowerOn();
             bool IsCPUHalted();
@@ -9,6 +9,7 @@
     
     // include C/C++ headers
     #include <cmath>            // [ ANSI C ] Mathematics
+    #include <cstring>          // [ ANSI C ] Strings
     
     // declare used namespaces
     using namespace std;
@@ -50,6 +51,23 @@ namespace V32
     };
     
     
+    // =============================================================================
+    //      GPU TEXTURES
+    // =============================================================================
+    
+    
+    // (static storage is zero-initialized)
+    GPURegionPage GPUZeroRegionPage;
+    
+    // -----------------------------------------------------------------------------
+    
+    GPUTexture::GPUTexture()
+    {
+        for( int32_t i = 0; i < GPURegionPagesPerTexture; i++ )
+          Pages[ i ] = &GPUZeroRegionPage;
+    }
+    
+    
     // =============================================================================
     //      V32 GPU: INSTANCE HANDLING
     // =============================================================================
@@ -61,11 +79,12 @@ namespace V32
         PointedTexture = nullptr;
         PointedRegion = nullptr;
         
-        // size the array
-        CartridgeTextures.resize( Constants::GPUMaximumCartridgeTextures );
-        
         // no cartridge loaded yet
         LoadedCartridgeTextures = 0;
+        
+        // not connected yet
+        Frontend = nullptr;
+        SkipRendering = false;
     }
     
     // -----------------------------------------------------------------------------
@@ -74,6 +93,12 @@ namespace V32
     {
         // don't release any textures
         // (this is done at console destructor)
+        
+        // but do release region pages
+        ReleaseWrittenPages( false );
+        
+        for( GPURegionPage* Page: FreePages )
+          delete Page;
     }
     
     
@@ -85,8 +110,11 @@ namespace V32
     void V32GPU::InsertCartridgeTextures( uint32_t NumberOfCartridgeTextures )
     {
         if( NumberOfCartridgeTextures > Constants::GPUMaximumCartridgeTextures )
-          Callbacks::ThrowException( "Attempting to insert too many cartridge textures" );
+          Frontend->ThrowException( "Attempting to insert too many cartridge textures" );
         
+        // previous cartridge regions can't be kept
+        ClearCartridgeTextures();
+        CartridgeTextures.resize( NumberOfCartridgeTextures );
         LoadedCartridgeTextures = NumberOfCartridgeTextures;
     }
     
@@ -94,8 +122,107 @@ namespace V32
     
     void V32GPU::RemoveCartridgeTextures()
     {
+        ClearCartridgeTextures();
+        Frontend->UnloadCartridgeTextures();
+    }
+    
+    // -----------------------------------------------------------------------------
+    
+    void V32GPU::ClearCartridgeTextures()
+    {
+        // a selected cartridge texture would no longer
+        // exist, so select the BIOS texture instead
+        if( PointedTexture && PointedTexture != &BiosTexture )
+        {
+            SelectedTexture = -1;
+            PointedTexture = &BiosTexture;
+        }
+        
+        ReleaseWrittenPages( true );
+        CartridgeTextures.clear();
         LoadedCartridgeTextures = 0;
-        Callbacks::UnloadCartridgeTextures();
+    }
+    
+    
+    // =============================================================================
+    //      V32 GPU: HANDLING REGION PAGES
+    // =============================================================================
+    
+    
+    GPUTexture& V32GPU::GetTexture( int32_t TextureID )
+    {
+        if( TextureID == -1 )
+          return BiosTexture;
+        
+        return CartridgeTextures[ TextureID ];
+    }
+    
+    // -----------------------------------------------------------------------------
+    
+    // gives the page its own copy on its first write
+    GPURegionPage* V32GPU::GetWritablePage( int32_t TextureID, int32_t PageIndex )
+    {
+        GPURegionPage*& Page = GetTexture( TextureID ).Pages[ PageIndex ];
+        
+        if( Page != &GPUZeroRegionPage )
+          return Page;
+        
+        // reuse released pages when possible
+        if( !FreePages.empty() )
+        {
+            Page = FreePages.back();
+            FreePages.pop_back();
+        }
+        
+        else Page = new GPURegionPage;
+        
+        // all unwritten regions are zero
+        memset( Page, 0, sizeof(GPURegionPage) );
+        
+        GPUWrittenPage Written = { TextureID, PageIndex };
+        WrittenPages.push_back( Written );
+        return Page;
+    }
+    
+    // -----------------------------------------------------------------------------
+    
+    GPURegion* V32GPU::GetWritableRegion()
+    {
+        int32_t PageIndex = SelectedRegion / GPURegionsPerPage;
+        GPURegionPage* Page = GetWritablePage( SelectedTexture, PageIndex );
+        
+        // the region may have moved to a new page
+        GPURegion* Region = &Page->Regions[ SelectedRegion % GPURegionsPerPage ];
+        PointedRegion = Region;
+        return Region;
+    }
+    
+    // -----------------------------------------------------------------------------
+    
+    // returns all written pages to their initial state
+    // (BIOS pages can be kept when only the cartridge changes)
+    void V32GPU::ReleaseWrittenPages( bool KeepBiosPages )
+    {
+        vector< GPUWrittenPage > KeptPages;
+        
+        for( GPUWrittenPage& Written: WrittenPages )
+        {
+            if( KeepBiosPages && Written.TextureID == -1 )
+            {
+                KeptPages.push_back( Written );
+                continue;
+            }
+            
+            GPURegionPage*& Page = GetTexture( Written.TextureID ).Pages[ Written.PageIndex ];
+            FreePages.push_back( Page );
+            Page = &GPUZeroRegionPage;
+        }
+        
+        WrittenPages.swap( KeptPages );
+        
+        // the pointed region may have been released
+        if( PointedTexture )
+          PointedRegion = PointedTexture->GetRegion( SelectedRegion );
     }
     
     
@@ -124,7 +251,7 @@ namespace V32
         // CASE 2: Read from region-level parameters
         else
         {
-            V32Word* RegionRegisters = (V32Word*)PointedRegion;
+            const V32Word* RegionRegisters = (const V32Word*)PointedRegion;
             int32_t RegionPort = LocalPort - (int32_t)GPU_LocalPorts::RegionMinX;
             Result = RegionRegisters[ RegionPort ];
         }
@@ -179,40 +306,22 @@ namespace V32
         SelectedRegion = 0;
         
         // notify video library of parameter changes
-        Callbacks::SelectTexture( SelectedTexture );
-        Callbacks::SetMultiplyColor( MultiplyColor );
-        Callbacks::SetBlendingMode( ActiveBlending );
+        Frontend->SelectTexture( SelectedTexture );
+        Frontend->SetMultiplyColor( MultiplyColor );
+        Frontend->SetBlendingMode( ActiveBlending );
         
         // reset pointed entities
         PointedTexture = &BiosTexture;
-        PointedRegion = &BiosTexture.Regions[ 0 ];
-        
-        // reset all regions for every textures
-        // (but keep all existent textures reloaded!)
-        for( int i = 0; i < Constants::GPUMaximumCartridgeTextures; i++ )
-        for( int j = 0; j < Constants::GPURegionsPerTexture; j++ )
-        {
-            CartridgeTextures[ i ].Regions[ j ].MinX     = 0;
-            CartridgeTextures[ i ].Regions[ j ].MinX     = 0;
-            CartridgeTextures[ i ].Regions[ j ].MaxX     = 0;
-            CartridgeTextures[ i ].Regions[ j ].MaxY     = 0;
-            CartridgeTextures[ i ].Regions[ j ].HotspotX = 0;
-            CartridgeTextures[ i ].Regions[ j ].HotspotY = 0;
-        }
+        PointedRegion = BiosTexture.GetRegion( 0 );
         
-        // same for BIOS texture
-        for( int j = 0; j < Constants::GPURegionsPerTexture; j++ )
-        {
-            BiosTexture.Regions[ j ].MinX     = 0;
-            BiosTexture.Regions[ j ].MinX     = 0;
-            BiosTexture.Regions[ j ].MaxX     = 0;
-            BiosTexture.Regions[ j ].MaxY     = 0;
-            BiosTexture.Regions[ j ].HotspotX = 0;
-            BiosTexture.Regions[ j ].HotspotY = 0;
-        }
+        // reset all regions for every texture, including BIOS
+        // (but keep all existent textures reloaded!); only
+        // written pages need to be dropped, since all others
+        // still point to the shared page of zeroes
+        ReleaseWrittenPages( false );
         
         // initial screen clear to black
-        Callbacks::ClearScreen( ClearColor );
+        Frontend->ClearScreen( ClearColor );
     }
     
     
@@ -241,7 +350,8 @@ namespace V32
         }
         
         // clear the screen
-        Callbacks::ClearScreen( ClearColor );
+        if( !SkipRendering )
+          Frontend->ClearScreen( ClearColor );
     }
     
     // -----------------------------------------------------------------------------
@@ -290,6 +400,11 @@ namespace V32
             return;
         }
         
+        // on skipped frames there is no need to
+        // calculate the quad, since it is not drawn
+        if( SkipRendering )
+          return;
+        
         // calculate absolute texture coordinates
         // (initially, they are pixel-centered and uncorrected)
         float TextureMinX = Region.MinX + 0.5;
@@ -420,6 +535,6 @@ namespace V32
         }
         
         // draw rectangle defined as a quad (4-vertex polygon)
-        Callbacks::DrawQuad( RegionQuad );
+        Frontend->DrawQuad( RegionQuad );
     }
 }
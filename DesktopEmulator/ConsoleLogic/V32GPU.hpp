@@ -65,11 +65,55 @@ namespace V32
     
     // -----------------------------------------------------------------------------
     
+    // regions are stored in pages, which only
+    // get allocated when one of them is written
+    const int32_t GPURegionsPerPage = 64;
+    const int32_t GPURegionPagesPerTexture = Constants::GPURegionsPerTexture / GPURegionsPerPage;
+    
     typedef struct
     {
-        GPURegion Regions[ Constants::GPURegionsPerTexture ];
+        GPURegion Regions[ GPURegionsPerPage ];
     }
-    GPUTexture;
+    GPURegionPage;
+    
+    // all pages not written yet share this one,
+    // which only contains zeroes and is never written
+    extern GPURegionPage GPUZeroRegionPage;
+    
+    // -----------------------------------------------------------------------------
+    
+    // Games usually define only a few regions in each texture,
+    // so storing all of them would waste a lot of memory (and
+    // time when they need to be reset). Pages not written yet
+    // just point to the shared page of zeroes, and the GPU
+    // replaces them with their own copy when first written.
+    class GPUTexture
+    {
+        public:
+            
+            GPURegionPage* Pages[ GPURegionPagesPerTexture ];
+            
+        public:
+            
+            // all pages are initially unwritten
+            GPUTexture();
+            
+            const GPURegion* GetRegion( int32_t RegionID ) const
+            {
+                return &Pages[ RegionID / GPURegionsPerPage ]->Regions[ RegionID % GPURegionsPerPage ];
+            }
+    };
+    
+    // -----------------------------------------------------------------------------
+    
+    // identifies each page that was written
+    // (texture ID is -1 for the BIOS texture)
+    typedef struct
+    {
+        int32_t TextureID;
+        int32_t PageIndex;
+    }
+    GPUWrittenPage;
     
     
     // =============================================================================
@@ -83,12 +127,18 @@ namespace V32
             
             // textures loaded into GPU
             GPUTexture BiosTexture;
-            std::vector< GPUTexture > CartridgeTextures;    // do not use a plain array: it is too large to hold in stack
+            std::vector< GPUTexture > CartridgeTextures;    // only as many as loaded
             unsigned LoadedCartridgeTextures;
             
+            // region pages currently owned by textures, and
+            // released ones that can be used again
+            std::vector< GPUWrittenPage > WrittenPages;
+            std::vector< GPURegionPage* > FreePages;
+            
             // accessors to active entities
-            GPUTexture* PointedTexture;
-            GPURegion*  PointedRegion;
+            // (to write regions use GetWritableRegion)
+            GPUTexture*      PointedTexture;
+            const GPURegion* PointedRegion;
             
             // GPU registers: GPU control
             int32_t Command;
@@ -111,6 +161,14 @@ namespace V32
             // quad coordinates for drawing regions
             GPUQuad RegionQuad;
             
+            // connection with the host Vircon system
+            VirconFrontendInterface* Frontend;
+            
+            // when set, commands are executed and accounted
+            // for as usual but nothing is sent to the frontend
+            // (used by frontends to skip frames efficiently)
+            bool SkipRendering;
+            
         public:
             
             // instance handling
@@ -120,6 +178,13 @@ namespace V32
             // handling video resources
             void InsertCartridgeTextures( uint32_t NumberOfCartridgeTextures );
             void RemoveCartridgeTextures();
+            void ClearCartridgeTextures();
+            
+            // handling region pages
+            GPUTexture& GetTexture( int32_t TextureID );
+            GPURegionPage* GetWritablePage( int32_t TextureID, int32_t PageIndex );
+            GPURegion* GetWritableRegion();
+            void ReleaseWrittenPages( bool KeepBiosPages );
             
             // connection to control bus
             virtual bool ReadPort( int32_t LocalPort, V32Word& Result );
@@ -81,7 +81,7 @@ namespace V32
         GPU.MultiplyColor = Value.AsColor;
         
         // notify the video library
-        Callbacks::SetMultiplyColor( Value.AsColor );
+        GPU.Frontend->SetMultiplyColor( Value.AsColor );
         return true;
     }
     
@@ -115,7 +115,7 @@ namespace V32
         }
         
         // for valid modes, notify the video library
-        Callbacks::SetBlendingMode( Value.AsInteger );
+        GPU.Frontend->SetBlendingMode( Value.AsInteger );
         return true;
     }
     
@@ -131,20 +131,20 @@ namespace V32
         GPU.SelectedTexture = Value.AsInteger;
         
         // notify the video library
-        Callbacks::SelectTexture( Value.AsInteger );
+        GPU.Frontend->SelectTexture( Value.AsInteger );
         
         // now update the pointed entities
         if( Value.AsInteger == -1 )
         {
             // special case for BIOS texture
             GPU.PointedTexture = &GPU.BiosTexture;
-            GPU.PointedRegion = &GPU.PointedTexture->Regions[ GPU.SelectedRegion ];
+            GPU.PointedRegion = GPU.PointedTexture->GetRegion( GPU.SelectedRegion );
         }
         else
         {
             // regular cartridge textures
             GPU.PointedTexture = &GPU.CartridgeTextures[ GPU.SelectedTexture ];
-            GPU.PointedRegion = &GPU.PointedTexture->Regions[ GPU.SelectedRegion ];
+            GPU.PointedRegion = GPU.PointedTexture->GetRegion( GPU.SelectedRegion );
         }
         
         return true;
@@ -162,7 +162,7 @@ namespace V32
         GPU.SelectedRegion = Value.AsInteger;
         
         // update pointed entity
-        GPU.PointedRegion = &GPU.PointedTexture->Regions[ GPU.SelectedRegion ];
+        GPU.PointedRegion = GPU.PointedTexture->GetRegion( GPU.SelectedRegion );
         return true;
     }
     
@@ -235,7 +235,7 @@ namespace V32
         // out of texture values are accepted,
         // but they are clamped to texture limits
         Clamp( Value.AsInteger, 0, Constants::GPUTextureSize-1 );
-        GPU.PointedRegion->MinX = Value.AsInteger;
+        GPU.GetWritableRegion()->MinX = Value.AsInteger;
         return true;
     }
     
@@ -246,7 +246,7 @@ namespace V32
         // out of texture values are accepted,
         // but they are clamped to texture limits
         Clamp( Value.AsInteger, 0, Constants::GPUTextureSize-1 );
-        GPU.PointedRegion->MinY = Value.AsInteger;
+        GPU.GetWritableRegion()->MinY = Value.AsInteger;
         return true;
     }
     
@@ -259,7 +259,7 @@ namespace V32
         int32_t ValidX = Value.AsInteger;
         Clamp( ValidX, 0, Constants::GPUTextureSize-1 );
         
-        GPU.PointedRegion->MaxX = ValidX;
+        GPU.GetWritableRegion()->MaxX = ValidX;
         return true;
     }
     
@@ -270,7 +270,7 @@ namespace V32
         // out of texture values are accepted,
         // but they are clamped to texture limits
         Clamp( Value.AsInteger, 0, Constants::GPUTextureSize-1 );
-        GPU.PointedRegion->MaxY = Value.AsInteger;
+        GPU.GetWritableRegion()->MaxY = Value.AsInteger;
         return true;
     }
     
@@ -281,7 +281,7 @@ namespace V32
         // out of texture values are valid up to
         // a certain range, then they get clamped
         Clamp( Value.AsInteger, -Constants::GPUTextureSize, (2*Constants::GPUTextureSize)-1 );
-        GPU.PointedRegion->HotspotX = Value.AsInteger;
+        GPU.GetWritableRegion()->HotspotX = Value.AsInteger;
         return true;
     }
     
@@ -291,7 +291,7 @@ namespace V32
     {
         // out of texture values are valid
         Clamp( Value.AsInteger, -Constants::GPUTextureSize, (2*Constants::GPUTextureSize)-1 );
-        GPU.PointedRegion->HotspotY = Value.AsInteger;
+        GPU.GetWritableRegion()->HotspotY = Value.AsInteger;
         return true;
     }
 }
@@ -0,0 +1,484 @@
+// *****************************************************************************
+    // include common Vircon32 headers
+    #include "../VirconDefinitions/Constants.hpp"
+    #include "../VirconDefinitions/Enumerations.hpp"
+    
+    // include console logic headers
+    #include "V32IdleLoopDetector.hpp"
+    #include "V32CPU.hpp"
+    
+    // include C/C++ headers
+    #include <cstring>          // [ ANSI C ] Strings
+    #include <cstdint>          // [ ANSI C ] Standard integer types
+    
+    // declare used namespaces
+    using namespace std;
+// *****************************************************************************
+
+
+namespace V32
+{
+    // =============================================================================
+    //      CLASS: V32 IDLE LOOP DETECTOR
+    // =============================================================================
+    
+    
+    V32IdleLoopDetector::V32IdleLoopDetector()
+    {
+        Timer = nullptr;
+        RAM = nullptr;
+        GamepadController = nullptr;
+        
+        Enabled = true;
+        Reset();
+    }
+    
+    // -----------------------------------------------------------------------------
+    
+    void V32IdleLoopDetector::Reset()
+    {
+        Observing = false;
+        
+        // forget all previous loops
+        for( IdleLoopHistoryEntry& Entry: History )
+        {
+            Entry.LoopHead = -1;
+            Entry.Failures = 0;
+            Entry.IgnoredJumps = 0;
+        }
+    }
+    
+    // -----------------------------------------------------------------------------
+    
+    void V32IdleLoopDetector::StopObserving( bool Failed )
+    {
+        if( !Observing )
+          return;
+        
+        Observing = false;
+        IdleLoopHistoryEntry& Entry = History[ LoopHead & (IdleLoopHistorySize-1) ];
+        
+        if( !Failed )
+        {
+            Entry.Failures = 0;
+            Entry.IgnoredJumps = 0;
+            return;
+        }
+        
+        // back off from loops that don't qualify
+        // so that they don't slow down execution
+        if( Entry.Failures < 10 )
+          Entry.Failures++;
+        
+        Entry.IgnoredJumps = min( 1 << Entry.Failures, IdleLoopMaximumBackoff );
+    }
+    
+    
+    // =============================================================================
+    //      V32 IDLE LOOP DETECTOR: OBSERVATION CONTROL
+    // =============================================================================
+    
+    
+    void V32IdleLoopDetector::CheckBackwardJump( V32CPU& CPU, int32_t JumpAddress )
+    {
+        if( !Enabled || Observing )
+          return;
+        
+        // only jumps can close a loop, not
+        // returns or calls to other functions
+        InstructionOpCodes OpCode = (InstructionOpCodes)CPU.Instruction.OpCode;
+        
+        if( OpCode != InstructionOpCodes::JMP
+        &&  OpCode != InstructionOpCodes::JT
+        &&  OpCode != InstructionOpCodes::JF )
+          return;
+        
+        // discard loops that are too long
+        int32_t JumpTarget = CPU.InstructionPointer.AsInteger;
+        
+        if( JumpAddress - JumpTarget > IdleLoopMaximumSize )
+          return;
+        
+        // find this loop in history, or replace
+        // whatever other loop occupied its place
+        IdleLoopHistoryEntry& Entry = History[ JumpTarget & (IdleLoopHistorySize-1) ];
+        
+        if( Entry.LoopHead != JumpTarget )
+        {
+            Entry.LoopHead = JumpTarget;
+            Entry.Failures = 0;
+            Entry.IgnoredJumps = 0;
+        }
+        
+        if( Entry.IgnoredJumps > 0 )
+        {
+            Entry.IgnoredJumps--;
+            return;
+        }
+        
+        // observe the next iteration
+        Observing = true;
+        LoopHead = JumpTarget;
+        StartIteration( CPU );
+    }
+    
+    // -----------------------------------------------------------------------------
+    
+    void V32IdleLoopDetector::CheckInstruction( V32CPU& CPU, int32_t InstructionAddress )
+    {
+        int32_t ElapsedCycles = Timer->CycleCounter - StartCycle;
+        
+        // coming back to the loop head closes the iteration
+        if( InstructionAddress == LoopHead && ElapsedCycles > 0 )
+        {
+            FinishIteration( CPU );
+            return;
+        }
+        
+        if( ElapsedCycles > IdleLoopMaximumCycles )
+        {
+            StopObserving( true );
+            return;
+        }
+        
+        if( !ObserveInstruction( CPU, CPU.Instruction ) )
+          StopObserving( true );
+    }
+    
+    // -----------------------------------------------------------------------------
+    
+    // called just after the jump, so the loop
+    // head will be run in the next cycle
+    void V32IdleLoopDetector::StartIteration( V32CPU& CPU )
+    {
+        StartCycle = Timer->CycleCounter + 1;
+        memcpy( StartRegisters, &CPU.Registers[ 0 ], 16 * sizeof(V32Word) );
+        NumberOfWrites = 0;
+        
+        CycleRegisters = 0;
+        MinimumAdvance = INT64_MAX;
+    }
+    
+    // -----------------------------------------------------------------------------
+    
+    void V32IdleLoopDetector::FinishIteration( V32CPU& CPU )
+    {
+        // the iteration must have left everything as it was
+        bool IsIdle = !CycleRegisters
+                   && !CPU.Waiting
+                   && !CPU.Halted
+                   && !memcmp( StartRegisters, &CPU.Registers[ 0 ], 16 * sizeof(V32Word) );
+        
+        for( int i = 0; i < NumberOfWrites; i++ )
+        {
+            int32_t LocalAddress = Writes[ i ].Address - Constants::RAMFirstAddress;
+            
+            if( RAM->Memory[ LocalAddress ].AsBinary != Writes[ i ].PreviousValue.AsBinary )
+              IsIdle = false;
+        }
+        
+        StopObserving( !IsIdle );
+        
+        if( !IsIdle )
+          return;
+        
+        // all iterations before the first one that
+        // can change any comparison will be the same
+        // (the current one, starting now, is the 1st)
+        int32_t IterationCycles = Timer->CycleCounter - StartCycle;
+        int64_t SkippedIterations = (Constants::CyclesPerFrame - Timer->CycleCounter) / IterationCycles;
+        
+        if( MinimumAdvance != INT64_MAX )
+        {
+            int64_t FirstChange = (MinimumAdvance + IterationCycles - 1) / IterationCycles;
+            SkippedIterations = min( SkippedIterations, FirstChange - 1 );
+        }
+        
+        // the loop head still runs normally after this
+        if( SkippedIterations > 0 )
+          Timer->CycleCounter += SkippedIterations * IterationCycles;
+    }
+    
+    
+    // -----------------------------------------------------------------------------
+    
+    // keeps the first value seen at each written address;
+    // writes outside of RAM (or too many) are not allowed
+    bool V32IdleLoopDetector::RecordWrite( int32_t Address )
+    {
+        int32_t LocalAddress = Address - Constants::RAMFirstAddress;
+        
+        if( LocalAddress < 0 || LocalAddress >= RAM->MemorySize )
+          return false;
+        
+        for( int i = 0; i < NumberOfWrites; i++ )
+          if( Writes[ i ].Address == Address )
+            return true;
+        
+        if( NumberOfWrites >= IdleLoopMaximumWrites )
+          return false;
+        
+        Writes[ NumberOfWrites ].Address = Address;
+        Writes[ NumberOfWrites ].PreviousValue = RAM->Memory[ LocalAddress ];
+        NumberOfWrites++;
+        return true;
+    }
+    
+    
+    // =============================================================================
+    //      V32 IDLE LOOP DETECTOR: CYCLE COUNTER TRACKING
+    // =============================================================================
+    
+    
+    bool V32IdleLoopDetector::IsCycleRegister( int32_t Register )
+    {
+        return (CycleRegisters >> Register) & 1;
+    }
+    
+    // -----------------------------------------------------------------------------
+    
+    // returns false when the register can't be followed:
+    // registers that the CPU uses implicitly (CR, SR, DR,
+    // BP, SP) could make a skipped iteration use different
+    // addresses than the observed one
+    bool V32IdleLoopDetector::SetCycleRegister( int32_t Register, bool IsCycle )
+    {
+        if( !IsCycle )
+        {
+            CycleRegisters &= ~(1u << Register);
+            return true;
+        }
+        
+        if( Register >= 11 )
+          return false;
+        
+        CycleRegisters |= (1u << Register);
+        return true;
+    }
+    
+    // -----------------------------------------------------------------------------
+    
+    // comparing a value that increases with the cycle counter
+    // to a constant gives the same result until the value
+    // reaches (or exceeds) that constant
+    bool V32IdleLoopDetector::ObserveComparison( V32CPU& CPU, CPUInstruction Instruction )
+    {
+        bool IsCycle1 = IsCycleRegister( Instruction.Register1 );
+        bool IsCycle2 = !Instruction.UsesImmediate && IsCycleRegister( Instruction.Register2 );
+        
+        // comparing 2 cycle values is the same as comparing
+        // their constant difference, so the result never changes
+        if( IsCycle1 == IsCycle2 )
+          return SetCycleRegister( Instruction.Register1, false );
+        
+        V32Word Operand2 = (Instruction.UsesImmediate? CPU.ImmediateValue : CPU.Registers[ Instruction.Register2 ]);
+        int64_t CycleValue = (IsCycle1? CPU.Registers[ Instruction.Register1 ].AsInteger : Operand2.AsInteger);
+        int64_t Constant = (IsCycle1? Operand2.AsInteger : CPU.Registers[ Instruction.Register1 ].AsInteger);
+        
+        // don't follow values that could overflow
+        if( CycleValue > INT32_MAX - Constants::CyclesPerFrame )
+          return false;
+        
+        // when the cycle value is the 2nd operand,
+        // use the equivalent comparison with swapped
+        // operands (i.e. 5 < X is the same as X > 5)
+        InstructionOpCodes OpCode = (InstructionOpCodes)Instruction.OpCode;
+        
+        if( IsCycle2 )
+          switch( OpCode )
+          {
+              case InstructionOpCodes::IGT: OpCode = InstructionOpCodes::ILT; break;
+              case InstructionOpCodes::IGE: OpCode = InstructionOpCodes::ILE; break;
+              case InstructionOpCodes::ILT: OpCode = InstructionOpCodes::IGT; break;
+              case InstructionOpCodes::ILE: OpCode = InstructionOpCodes::IGE; break;
+              default: break;
+          }
+        
+        int64_t Advance = INT64_MAX;
+        
+        switch( OpCode )
+        {
+            // result changes when the value reaches the constant
+            case InstructionOpCodes::ILT:
+            case InstructionOpCodes::IGE:
+                if( CycleValue < Constant )
+                  Advance = Constant - CycleValue;
+                break;
+            
+            // result changes when the value exceeds the constant
+            case InstructionOpCodes::ILE:
+            case InstructionOpCodes::IGT:
+                if( CycleValue <= Constant )
+                  Advance = Constant - CycleValue + 1;
+                break;
+            
+            // result changes when the value passes by the constant
+            // (the exact cycle may be skipped, but stopping earlier
+            // is always safe: the loop will just be detected again)
+            default:
+                if( CycleValue == Constant )
+                  Advance = 1;
+                else if( CycleValue < Constant )
+                  Advance = Constant - CycleValue;
+                break;
+        }
+        
+        MinimumAdvance = min( MinimumAdvance, Advance );
+        return SetCycleRegister( Instruction.Register1, false );
+    }
+    
+    // -----------------------------------------------------------------------------
+    
+    // called before the instruction is run; returns false
+    // when the instruction may behave differently in other
+    // iterations, or has effects other than on registers
+    bool V32IdleLoopDetector::ObserveInstruction( V32CPU& CPU, CPUInstruction Instruction )
+    {
+        int32_t Register1 = Instruction.Register1;
+        int32_t Register2 = Instruction.Register2;
+        bool UsesImmediate = Instruction.UsesImmediate;
+        
+        bool IsCycle1 = IsCycleRegister( Register1 );
+        bool IsCycle2 = !UsesImmediate && IsCycleRegister( Register2 );
+        
+        switch( (InstructionOpCodes)Instruction.OpCode )
+        {
+            // these stop the loop until next frame
+            case InstructionOpCodes::HLT:
+            case InstructionOpCodes::WAIT:
+                return false;
+            
+            // jump targets and conditions must be constant
+            case InstructionOpCodes::JMP:
+                return UsesImmediate || !IsCycle1;
+            
+            case InstructionOpCodes::CALL:
+                if( !UsesImmediate && IsCycle1 ) return false;
+                return RecordWrite( CPU.StackPointer.AsInteger - 1 );
+            
+            case InstructionOpCodes::RET:
+                return true;
+            
+            case InstructionOpCodes::JT:
+            case InstructionOpCodes::JF:
+                return !IsCycle1 && !IsCycle2;
+            
+            // comparisons can involve cycle values
+            case InstructionOpCodes::IEQ:
+            case InstructionOpCodes::INE:
+            case InstructionOpCodes::IGT:
+            case InstructionOpCodes::IGE:
+            case InstructionOpCodes::ILT:
+            case InstructionOpCodes::ILE:
+                return ObserveComparison( CPU, Instruction );
+            
+            // adding or subtracting constants to a cycle value
+            // keeps it increasing at the same rate
+            case InstructionOpCodes::IADD:
+                if( IsCycle1 && IsCycle2 ) return false;
+                return SetCycleRegister( Register1, IsCycle1 || IsCycle2 );
+            
+            case InstructionOpCodes::ISUB:
+                if( IsCycle2 && !IsCycle1 ) return false;
+                return SetCycleRegister( Register1, IsCycle1 && !IsCycle2 );
+            
+            // memory accesses must use constant addresses and values
+            case InstructionOpCodes::MOV:
+                switch( (AddressingModes)Instruction.AddressingMode )
+                {
+                    case AddressingModes::RegisterFromImmediate:
+                    case AddressingModes::RegisterFromImmediateAddress:
+                        return SetCycleRegister( Register1, false );
+                    
+                    case AddressingModes::RegisterFromRegister:
+                        return SetCycleRegister( Register1, IsCycle2 );
+                    
+                    case AddressingModes::RegisterFromRegisterAddress:
+                    case AddressingModes::RegisterFromAddressOffset:
+                        if( IsCycleRegister( Register2 ) ) return false;
+                        return SetCycleRegister( Register1, false );
+                    
+                    case AddressingModes::ImmediateAddressFromRegister:
+                        if( IsCycleRegister( Register2 ) ) return false;
+                        return RecordWrite( CPU.ImmediateValue.AsInteger );
+                    
+                    case AddressingModes::RegisterAddressFromRegister:
+                        if( IsCycle1 || IsCycleRegister( Register2 ) ) return false;
+                        return RecordWrite( CPU.Registers[ Register1 ].AsInteger );
+                    
+                    default:
+                        if( IsCycle1 || IsCycleRegister( Register2 ) ) return false;
+                        return RecordWrite( CPU.Registers[ Register1 ].AsInteger + CPU.ImmediateValue.AsInteger );
+                }
+            
+            case InstructionOpCodes::LEA:
+                if( IsCycleRegister( Register2 ) ) return false;
+                return SetCycleRegister( Register1, false );
+            
+            case InstructionOpCodes::PUSH:
+                if( IsCycle1 ) return false;
+                return RecordWrite( CPU.StackPointer.AsInteger - 1 );
+            
+            case InstructionOpCodes::POP:
+            case InstructionOpCodes::CMPS:
+                return SetCycleRegister( Register1, false );
+            
+            // string writes can cover any amount of memory
+            case InstructionOpCodes::MOVS:
+            case InstructionOpCodes::SETS:
+                return false;
+            
+            // port reads will give the same value for the whole
+            // frame, except for the cycle counter and the RNG
+            case InstructionOpCodes::IN:
+            {
+                int32_t DeviceID = (Instruction.PortNumber >> 8) & 7;
+                int32_t LocalPort = Instruction.PortNumber & 0xFF;
+                
+                // reading a random value changes the generator
+                if( DeviceID == 1 )
+                  return false;
+                
+                bool ReadsCycles = (DeviceID == 0 && LocalPort == (int32_t)CLK_LocalPorts::CycleCounter);
+                return SetCycleRegister( Register1, ReadsCycles );
+            }
+            
+            // port writes are only allowed if they have no effect;
+            // this happens when programs select the same gamepad
+            case InstructionOpCodes::OUT:
+            {
+                int32_t DeviceID = (Instruction.PortNumber >> 8) & 7;
+                int32_t LocalPort = Instruction.PortNumber & 0xFF;
+                
+                if( DeviceID != 4 || LocalPort != (int32_t)INP_LocalPorts::SelectedGamepad || IsCycle2 )
+                  return false;
+                
+                V32Word Value = (UsesImmediate? CPU.ImmediateValue : CPU.Registers[ Register2 ]);
+                return (Value.AsInteger == GamepadController->SelectedGamepad);
+            }
+            
+            // operations on a single register
+            case InstructionOpCodes::CIF:
+            case InstructionOpCodes::CFI:
+            case InstructionOpCodes::CIB:
+            case InstructionOpCodes::CFB:
+            case InstructionOpCodes::NOT:
+            case InstructionOpCodes::BNOT:
+            case InstructionOpCodes::ISGN:
+            case InstructionOpCodes::IABS:
+            case InstructionOpCodes::FSGN:
+            case InstructionOpCodes::FABS:
+            case InstructionOpCodes::FLR:
+            case InstructionOpCodes::CEIL:
+            case InstructionOpCodes::ROUND:
+            case InstructionOpCodes::SIN:
+            case InstructionOpCodes::ACOS:
+            case InstructionOpCodes::LOG:
+                return !IsCycle1;
+            
+            // any other operations on 2 values
+            default:
+                return !IsCycle1 && !IsCycle2;
+        }
+    }
+}
@@ -0,0 +1,152 @@
+// *****************************************************************************
+    // start include guard
+    #ifndef V32IDLELOOPDETECTOR_HPP
+    #define V32IDLELOOPDETECTOR_HPP
+    
+    // include common Vircon32 headers
+    #include "../VirconDefinitions/DataStructures.hpp"
+    
+    // include console logic headers
+    #include "V32Memory.hpp"
+    #include "V32Timer.hpp"
+    #include "V32GamepadController.hpp"
+// *****************************************************************************
+
+
+namespace V32
+{
+    // forward declaration, since the CPU
+    // contains its own idle loop detector
+    class V32CPU;
+    
+    
+    // =============================================================================
+    //      IDLE LOOP DETECTION DEFINITIONS
+    // =============================================================================
+    
+    
+    // only backward jumps of up to this many words
+    // can be considered as the end of an idle loop
+    const int32_t IdleLoopMaximumSize = 64;
+    
+    // observation stops if a single iteration
+    // of the loop takes longer than this
+    const int32_t IdleLoopMaximumCycles = 256;
+    
+    // after repeated failures on the same loop,
+    // it is observed again only after this many
+    // jumps at most (the wait doubles each time)
+    const int32_t IdleLoopMaximumBackoff = 1024;
+    
+    // number of loops remembered at the same time
+    const int32_t IdleLoopHistorySize = 64;
+    
+    // number of different RAM addresses that an
+    // iteration of the loop can write to
+    const int32_t IdleLoopMaximumWrites = 16;
+    
+    // -----------------------------------------------------------------------------
+    
+    typedef struct
+    {
+        int32_t LoopHead;
+        int32_t Failures;
+        int32_t IgnoredJumps;
+    }
+    IdleLoopHistoryEntry;
+    
+    // -----------------------------------------------------------------------------
+    
+    typedef struct
+    {
+        int32_t Address;
+        V32Word PreviousValue;
+    }
+    IdleLoopMemoryWrite;
+    
+    
+    // =============================================================================
+    //      V32 IDLE LOOP DETECTOR CLASS
+    // =============================================================================
+    
+    
+    // Programs often wait for something by polling a port in a
+    // short loop (frame counter, cycle counter, gamepad). When
+    // one iteration of such a loop leaves registers and memory
+    // the same as they were, all following iterations will do
+    // the exact same thing until some value read from a port
+    // changes. In that case we can advance the cycle counter
+    // to the point where that happens without running them.
+    // Within a frame only the cycle counter can change, so we
+    // follow values derived from it and find out how many
+    // iterations it takes for any comparison to change result
+    class V32IdleLoopDetector
+    {
+        public:
+            
+            // can be disabled (i.e. to compare executions)
+            bool Enabled;
+            
+            // state of the observed loop
+            bool Observing;
+            int32_t LoopHead;
+            int32_t StartCycle;
+            V32Word StartRegisters[ 16 ];
+            
+            // RAM contents before the iteration wrote
+            // to them (i.e. when calling functions)
+            IdleLoopMemoryWrite Writes[ IdleLoopMaximumWrites ];
+            int32_t NumberOfWrites;
+            
+            // 1 bit per register, set when its value is
+            // the cycle counter plus some constant
+            uint32_t CycleRegisters;
+            
+            // how much the cycle counter has to advance
+            // for some comparison to give a different result
+            int64_t MinimumAdvance;
+            
+            // loops that were observed recently
+            IdleLoopHistoryEntry History[ IdleLoopHistorySize ];
+            
+        public:
+            
+            // connections with observed components
+            V32Timer* Timer;
+            V32RAM* RAM;
+            V32GamepadController* GamepadController;
+            
+        protected:
+            
+            // observation control
+            void StartIteration( V32CPU& CPU );
+            void FinishIteration( V32CPU& CPU );
+            bool RecordWrite( int32_t Address );
+            
+            // tracking of values taken from the cycle counter
+            bool IsCycleRegister( int32_t Register );
+            bool SetCycleRegister( int32_t Register, bool IsCycle );
+            bool ObserveComparison( V32CPU& CPU, CPUInstruction Instruction );
+            bool ObserveInstruction( V32CPU& CPU, CPUInstruction Instruction );
+            
+        public:
+            
+            // instance handling
+            V32IdleLoopDetector();
+            
+            // general operation
+            void Reset();
+            void StopObserving( bool Failed );
+            
+            // called by the CPU on each backward jump, and on
+            // each instruction while a loop is being observed
+            void CheckBackwardJump( V32CPU& CPU, int32_t JumpAddress );
+            void CheckInstruction( V32CPU& CPU, int32_t InstructionAddress );
+    };
+}
+
+
+// *****************************************************************************
+    // end include guard
+    #endif
+// *****************************************************************************
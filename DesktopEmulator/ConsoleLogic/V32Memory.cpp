@@ -17,6 +17,7 @@ namespace V32
     V32RAM::V32RAM()
     {
         MemorySize = 0;
+        UsedCaptureBuffers = 0;
     }
     
     // -----------------------------------------------------------------------------
@@ -29,6 +30,7 @@ namespace V32
         // connect new one
         Memory.resize( NumberOfWords );
         MemorySize = NumberOfWords;
+        ModifiedPages.resize( (NumberOfWords + RAMPageSize - 1) / RAMPageSize );
         
         // initially, set to zeroes
         ClearContents();
@@ -39,6 +41,7 @@ namespace V32
     void V32RAM::Disconnect()
     {
         Memory.clear();
+        ModifiedPages.clear();
         MemorySize = 0;
     }
     
@@ -47,6 +50,17 @@ namespace V32
     void V32RAM::ClearContents()
     {
         memset( &Memory[ 0 ], 0, Memory.size() * 4 );
+        MarkAllPagesModified();
+    }
+    
+    // -----------------------------------------------------------------------------
+    
+    // needed whenever memory contents are written directly
+    // instead of going through the memory bus
+    void V32RAM::MarkAllPagesModified()
+    {
+        for( uint32_t& PageMask: ModifiedPages )
+          PageMask = 0xFFFFFFFF;
     }
     
     // -----------------------------------------------------------------------------
@@ -72,6 +86,7 @@ namespace V32
         
         // write value
         Memory[ LocalAddress ] = Value;
+        ModifiedPages[ LocalAddress >> RAMPageSizeBits ] = 0xFFFFFFFF;
         return true;
     }
     
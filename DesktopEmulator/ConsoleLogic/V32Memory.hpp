@@ -18,6 +18,17 @@ namespace V32
     // =============================================================================
     
     
+    // RAM keeps track of which of its pages have been
+    // written, so that frontends can capture its state
+    // by copying only the pages that actually changed;
+    // this is tracked separately for each of up to 32
+    // capture buffers, using 1 bit for each of them
+    const int32_t RAMPageSizeBits = 12;
+    const int32_t RAMPageSize = 1 << RAMPageSizeBits;   // in words
+    const int32_t RAMCaptureBuffers = 32;
+    
+    // -----------------------------------------------------------------------------
+    
     class V32RAM: public VirconMemoryInterface
     {
         public:
@@ -25,6 +36,13 @@ namespace V32
             std::vector< V32Word > Memory;
             int32_t MemorySize;
             
+            // 1 bit mask per page, all set when it is written;
+            // only the frontend clears them, when it copies RAM
+            std::vector< uint32_t > ModifiedPages;
+            
+            // capture buffers that the frontend is using
+            uint32_t UsedCaptureBuffers;
+            
         public:
             
             // instance handling
@@ -36,6 +54,7 @@ namespace V32
             
             // memory contents
             void ClearContents();
+            void MarkAllPagesModified();
             
             // bus connection
             virtual bool ReadAddress( int32_t LocalAddress, V32Word& Result );
@@ -53,6 +53,7 @@ namespace V32
         
         // no cartridge loaded yet
         LoadedCartridgeSounds = 0;
+        SkipOutput = false;
     }
     
     // -----------------------------------------------------------------------------
@@ -326,14 +327,17 @@ namespace V32
                 if( ThisChannel->State != IOPortValues::SPUChannelState_Playing )
                   continue;
                 
-                // pick sample at this position
+                // pick sample at this position and mix it
+                // (skipped frames only need to advance)
                 SPUSound* ChannelSound = GetChannelSound( ThisChannel );
-                SPUSample PickedSample = ChannelSound->Samples[ (int)ThisChannel->Position ];
                 
-                // mix the sample
-                float TotalVolume = GlobalVolume * ThisChannel->Volume;
-                ThisSample.LeftSample  += TotalVolume * PickedSample.LeftSample;
-                ThisSample.RightSample += TotalVolume * PickedSample.RightSample;
+                if( !SkipOutput )
+                {
+                    SPUSample PickedSample = ChannelSound->Samples[ (int)ThisChannel->Position ];
+                    float TotalVolume = GlobalVolume * ThisChannel->Volume;
+                    ThisSample.LeftSample  += TotalVolume * PickedSample.LeftSample;
+                    ThisSample.RightSample += TotalVolume * PickedSample.RightSample;
+                }
                 
                 // advance at current speed
                 double PreviousPosition = ThisChannel->Position;
@@ -362,7 +366,8 @@ namespace V32
                   StopChannel( *ThisChannel );
             }
             
-            OutputBuffer.Samples[ s ] = ThisSample;
+            if( !SkipOutput )
+              OutputBuffer.Samples[ s ] = ThisSample;
         }
     }
 }
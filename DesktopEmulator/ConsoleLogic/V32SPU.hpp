@@ -113,6 +113,10 @@ namespace V32
             // sound buffer configuration
             SPUOutputBuffer OutputBuffer;
             
+            // when set, channels advance as usual but
+            // no samples are mixed into the output buffer
+            bool SkipOutput;
+            
         public:
             
             // instance handling
@@ -14,6 +14,7 @@
     #include <stdexcept>        // [ C++ STL ] Exceptions
     #include <iostream>         // [ C++ STL ] I/O Streams
     #include <climits>          // [ ANSI C ] Numeric limits
+    #include <cmath>            // [ ANSI C ] Mathematics
     
     // declare used namespaces
     using namespace std;
@@ -90,6 +91,12 @@ AudioOutput::AudioOutput()
     // initial state for output volume control
     OutputVolume = 1.0;
     Mute = false;
+    
+    // initial state for rate control
+    PlaybackSpeed = 1;
+    AverageQueuedBuffers = NumberOfBuffers / 2;
+    ResamplingPosition = -1;
+    LastFrameSample.LeftSample = LastFrameSample.RightSample = 0;
 }
 
 // -----------------------------------------------------------------------------
@@ -201,6 +208,12 @@ void AudioOutput::Reset()
         PlaybackBuffers[ i ].Contents.SequenceNumber = 0;
     }
     
+    // restart rate control
+    PlaybackSpeed = 1;
+    AverageQueuedBuffers = NumberOfBuffers / 2;
+    ResamplingPosition = -1;
+    LastFrameSample.LeftSample = LastFrameSample.RightSample = 0;
+    
     // reinitialize audio playback
     InitializeBufferQueue();
     ThreadPauseFlag = false;
@@ -293,6 +306,24 @@ bool AudioOutput::IsMuted()
 }
 
 
+// =============================================================================
+//      AUDIO OUTPUT: RATE CONTROL STATISTICS
+// =============================================================================
+
+
+double AudioOutput::GetQueuedTime()
+{
+    return AverageQueuedBuffers / Constants::FramesPerSecond;
+}
+
+// -----------------------------------------------------------------------------
+
+double AudioOutput::GetRateAdjustment()
+{
+    return PlaybackSpeed - 1;
+}
+
+
 // =============================================================================
 //      AUDIO OUTPUT: GENERATING SOUND
 // =============================================================================
@@ -302,23 +333,78 @@ bool AudioOutput::IsMuted()
 // returns true if successful
 bool AudioOutput::FillNextSoundBuffer()
 {
+    // this is done even when the frame can't be
+    // queued, since the queue is then too long
+    UpdatePlaybackSpeed();
+    
     SoundBuffer* Buffer = FindNextBufferToFill();
     if( !Buffer ) return false;
     
     // obtain sound output for the current frame
     Console.GetFrameSoundOutput( Buffer->Contents );
+    int NumberOfSamples = ResampleFrame( Buffer->Contents );
     
     // ignore OpenAL errors so far
     alGetError();
     
     // copy our local buffer to internal OpenAL one
-    alBufferData( Buffer->BufferID, AL_FORMAT_STEREO16, Buffer->Contents.Samples, Constants::SPUSamplesPerFrame * 4, Constants::SPUSamplingRate );
+    alBufferData( Buffer->BufferID, AL_FORMAT_STEREO16, ResampledSamples, NumberOfSamples * 4, Constants::SPUSamplingRate );
     
     // finally, change buffer state
     Buffer->State = SoundBufferStates::Filled;
     return (alGetError() == AL_NO_ERROR);
 }
 
+// -----------------------------------------------------------------------------
+
+// the target is to keep half of the buffers queued,
+// which is the same amount that is queued on reset
+void AudioOutput::UpdatePlaybackSpeed()
+{
+    // queue size is only known in whole buffers,
+    // so take an average over many frames
+    AverageQueuedBuffers += 0.02 * (GetPendingBuffers() - AverageQueuedBuffers);
+    
+    // play faster when too much sound is queued,
+    // and slower when there is not enough
+    double TargetBuffers = NumberOfBuffers / 2;
+    double Deviation = (AverageQueuedBuffers - TargetBuffers) / TargetBuffers;
+    
+    PlaybackSpeed = 1 + 0.02 * Deviation;
+    Clamp( PlaybackSpeed, 1 - MAX_AUDIO_RATE_ADJUSTMENT, 1 + MAX_AUDIO_RATE_ADJUSTMENT );
+}
+
+// -----------------------------------------------------------------------------
+
+// resamples the frame with linear interpolation at the
+// current playback speed; returns the number of samples
+int AudioOutput::ResampleFrame( const SPUOutputBuffer& FrameSound )
+{
+    const int FrameSamples = Constants::SPUSamplesPerFrame;
+    int NumberOfSamples = 0;
+    
+    // position -1 is the last sample of the previous frame
+    while( ResamplingPosition < (FrameSamples - 1) && NumberOfSamples < MAX_RESAMPLED_SAMPLES )
+    {
+        int Index = (int)floor( ResamplingPosition );
+        float Fraction = ResamplingPosition - Index;
+        
+        const SPUSample& Sample1 = (Index < 0? LastFrameSample : FrameSound.Samples[ Index ]);
+        const SPUSample& Sample2 = FrameSound.Samples[ Index + 1 ];
+        
+        SPUSample& Result = ResampledSamples[ NumberOfSamples++ ];
+        Result.LeftSample  = Sample1.LeftSample  + Fraction * (Sample2.LeftSample  - Sample1.LeftSample);
+        Result.RightSample = Sample1.RightSample + Fraction * (Sample2.RightSample - Sample1.RightSample);
+        
+        ResamplingPosition += PlaybackSpeed;
+    }
+    
+    // continue from here on the next frame
+    ResamplingPosition -= FrameSamples;
+    LastFrameSample = FrameSound.Samples[ FrameSamples - 1 ];
+    return NumberOfSamples;
+}
+
 
 // =============================================================================
 //      AUDIO OUTPUT: SEARCHING FOR SOUND BUFFERS
@@ -401,6 +487,20 @@ int AudioOutput::GetProcessedBuffers()
 
 // -----------------------------------------------------------------------------
 
+// counts buffers with sound that has not been played yet
+int AudioOutput::GetPendingBuffers()
+{
+    int FilledBuffers = 0;
+    
+    for( int i = 0; i < NumberOfBuffers; i++ )
+      if( PlaybackBuffers[ i ].State == SoundBufferStates::Filled )
+        FilledBuffers++;
+    
+    return FilledBuffers + GetQueuedBuffers() - GetProcessedBuffers();
+}
+
+// -----------------------------------------------------------------------------
+
 // NOTE: read the documentation for alSourceUnqueueBuffers
 // (will only work right with source state AL_STOPPED)
 void AudioOutput::ClearBufferQueue()
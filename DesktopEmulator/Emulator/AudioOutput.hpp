@@ -44,6 +44,19 @@
 
 // -----------------------------------------------------------------------------
 
+// The display and the audio device never run at exactly
+// the rates we expect, so the amount of queued sound would
+// slowly grow or shrink, until frames are dropped or audio
+// runs out. To prevent it, each frame of sound is resampled
+// to play slightly faster or slower (by up to this fraction,
+// which is not perceptible) to keep the queue on target.
+#define MAX_AUDIO_RATE_ADJUSTMENT  0.005
+
+// resampled frames can have a few more samples
+#define MAX_RESAMPLED_SAMPLES  (V32::Constants::SPUSamplesPerFrame + 8)
+
+// -----------------------------------------------------------------------------
+
 // We will use these 3 states to handle audio buffers.
 // Thread safety is achieved by making each thread act
 // only over different sets of buffer states, so they
@@ -118,6 +131,13 @@ class AudioOutput
         float OutputVolume;
         bool Mute;
         
+        // dynamic rate control
+        double PlaybackSpeed;               // frame samples used per output sample
+        double AverageQueuedBuffers;        // smoothed number of buffers pending to play
+        double ResamplingPosition;          // position within next frame's samples
+        V32::SPUSample LastFrameSample;     // needed to interpolate at frame start
+        V32::SPUSample ResampledSamples[ MAX_RESAMPLED_SAMPLES ];
+        
     private:
         
         // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -126,6 +146,8 @@ class AudioOutput
         
         // generate sound to play
         bool FillNextSoundBuffer();
+        void UpdatePlaybackSpeed();
+        int ResampleFrame( const V32::SPUOutputBuffer& FrameSound );
         
         // searching for sound buffers
         SoundBuffer& FindBufferFromID( ALuint TargetID );
@@ -135,6 +157,7 @@ class AudioOutput
         // handling playback buffer queue
         int GetQueuedBuffers();
         int GetProcessedBuffers();
+        int GetPendingBuffers();
         void UnqueuePlayedBuffers();
         void QueueFilledBuffers();
         void ClearBufferQueue();
@@ -169,6 +192,10 @@ class AudioOutput
         void SetOutputVolume( float Volume );
         bool IsMuted();
         void SetMute( bool Mute );
+        
+        // rate control statistics
+        double GetQueuedTime();         // in seconds
+        double GetRateAdjustment();     // as a fraction of normal speed
 };
 
 
@@ -4,6 +4,7 @@
     
     // include infrastructure headers
     #include "DesktopInfrastructure/Logger.hpp"
+    #include "DesktopInfrastructure/NumericFunctions.hpp"
     
     // include emulator headers
     #include "EmulatorControl.hpp"
@@ -11,6 +12,8 @@
     #include "Settings.hpp"
     #include "AudioOutput.hpp"
     #include "VideoOutput.hpp"
+    #include "GamepadsInput.hpp"
+    #include "StopWatch.hpp"
     
     // include C/C++ headers
     #include <stdexcept>        // [ C++ STL ] Exceptions
@@ -30,9 +33,19 @@
 
 
 EmulatorControl::EmulatorControl()
+:   RunAheadState( Console )
 {
     Paused = false;
     AutoCardHandling = true;
+    
+    // start at normal speed
+    FastForward = 1;
+    FramesInPeriod = 0;
+    PeriodStartTicks = 0;
+    EmulatedFPS = 0;
+    
+    // run-ahead is disabled by default
+    RunAheadFrames = 0;
 }
 
 // -----------------------------------------------------------------------------
@@ -49,19 +62,8 @@ void EmulatorControl::Initialize()
     // prepare audio system
     Audio.Initialize();
     
-    // set console's video callbacks
-    V32::Callbacks::ClearScreen = CallbackFunctions::ClearScreen;
-    V32::Callbacks::DrawQuad = CallbackFunctions::DrawQuad;
-    V32::Callbacks::SetMultiplyColor = CallbackFunctions::SetMultiplyColor;
-    V32::Callbacks::SetBlendingMode = CallbackFunctions::SetBlendingMode;
-    V32::Callbacks::SelectTexture = CallbackFunctions::SelectTexture;
-    V32::Callbacks::LoadTexture = CallbackFunctions::LoadTexture;
-    V32::Callbacks::UnloadCartridgeTextures = CallbackFunctions::UnloadCartridgeTextures;
-    V32::Callbacks::UnloadBiosTexture = CallbackFunctions::UnloadBiosTexture;
-    
-    // set console's log callbacks
-    V32::Callbacks::LogLine = CallbackFunctions::LogLine;
-    V32::Callbacks::ThrowException = CallbackFunctions::ThrowException;
+    // connect console to our video and log systems
+    Console.SetFrontend( &Frontend );
     
     // obtain current time
     time_t CreationTime;
@@ -78,6 +80,11 @@ void EmulatorControl::Initialize()
 
 void EmulatorControl::Terminate()
 {
+    // save any movie or trace being recorded
+    StopMovie();
+    StopNetplay();
+    StopGPUTrace();
+    
     Console.SetPower( false );
     Audio.Terminate();
 }
@@ -131,6 +138,8 @@ bool EmulatorControl::IsCardHandlingAuto()
 
 void EmulatorControl::SetPower( bool On )
 {
+    StopMovie();
+    StopNetplay();
     Video.RenderToFramebuffer();
     Console.SetPower( On );
 
@@ -150,6 +159,8 @@ bool EmulatorControl::IsPowerOn()
 void EmulatorControl::Reset()
 {
     LOG( "EmulatorControl::Reset" );
+    StopMovie();
+    StopNetplay();
     Paused = false;
     Video.RenderToFramebuffer();
     Console.Reset();
@@ -158,15 +169,365 @@ void EmulatorControl::Reset()
 
 // -----------------------------------------------------------------------------
 
-void EmulatorControl::RunNextFrame()
+void EmulatorControl::RunNextFrame( bool Skipped )
+{
+    // movies and netplay need each frame to go through them once
+    bool UseRunAhead = !Skipped && RunAheadFrames > 0
+                    && Movie.Mode == InputMovieModes::Idle && !Netplay;
+    
+    // skipped frames send no video to OpenGL; when fast-forwarding
+    // their audio is also dropped, since the audio output could
+    // not keep up with it anyway (so it gets decimated instead)
+    bool SkipVideo = Skipped || UseRunAhead;
+    bool SkipAudio = Skipped && IsFastForwarding();
+    Console.SetOutputSkipping( SkipVideo, SkipAudio );
+    
+    // netplay or the movie run the console, when active
+    // (netplay may need to wait without running the frame)
+    bool FrameWasRun = true;
+    
+    if( Netplay )
+      FrameWasRun = Netplay->RunNextFrame( SkipVideo, SkipAudio );
+    else
+      Movie.RunNextFrame( Console );
+    
+    Console.SetOutputSkipping( false, false );
+    
+    if( !SkipAudio && FrameWasRun )
+      Audio.ChangeFrame();
+    
+    if( Netplay && Netplay->GetState() == NetplayStates::Disconnected )
+      StopNetplay();
+    
+    // with run-ahead the video comes from a later frame
+    if( UseRunAhead )
+      RunAhead();
+    
+    if( !Skipped )
+    {
+        // ensure that all queued quads are rendered
+        Video.RenderQuadQueue();
+        
+        // after running, ensure that all GPU
+        // commands run in the current frame are drawn
+        glFlush();
+        
+        // traces only contain presented frames
+        if( FrameWasRun )
+          Trace.EndFrame();
+    }
+    
+    // update the measured frame rate once per second
+    if( FrameWasRun )
+      FramesInPeriod++;
+    
+    Uint32 ElapsedTicks = SDL_GetTicks() - PeriodStartTicks;
+    
+    if( ElapsedTicks >= 1000 )
+    {
+        EmulatedFPS = 1000.0 * FramesInPeriod / ElapsedTicks;
+        FramesInPeriod = 0;
+        PeriodStartTicks += ElapsedTicks;
+    }
+}
+
+// -----------------------------------------------------------------------------
+
+void EmulatorControl::RunFrames( int NumberOfFrames )
+{
+    for( int i = 1; i <= NumberOfFrames; i++ )
+      RunNextFrame( i < NumberOfFrames );
+}
+
+// -----------------------------------------------------------------------------
+
+// runs skipped frames until the given time has passed, and
+// then a final rendered one (so at least 1 frame is run)
+void EmulatorControl::RunFramesFor( double Seconds )
+{
+    StopWatch Watch;
+    double ElapsedTime = 0;
+    
+    while( ElapsedTime < Seconds )
+    {
+        RunNextFrame( true );
+        ElapsedTime += Watch.GetStepTime();
+    }
+    
+    RunNextFrame( false );
+}
+
+
+// -----------------------------------------------------------------------------
+
+void EmulatorControl::RunAhead()
 {
-    Console.RunNextFrame();
-    Audio.ChangeFrame();
+    RunAheadState.Capture();
     
-    // ensure that all queued quads are rendered
-    Video.RenderQuadQueue();
+    // hidden frames keep the current inputs; only
+    // the last one is drawn, and none produce audio
+    for( int i = 1; i <= RunAheadFrames; i++ )
+    {
+        Console.SetOutputSkipping( i < RunAheadFrames, true );
+        Console.RunNextFrame();
+    }
     
-    // after running, ensure that all GPU
-    // commands run in the current frame are drawn
-    glFlush();   
+    Console.SetOutputSkipping( false, false );
+    RunAheadState.Restore();
+}
+
+
+// =============================================================================
+//      EMULATOR CONTROL: FAST-FORWARD
+// =============================================================================
+
+
+void EmulatorControl::SetFastForward( int Speed )
+{
+    // the remote player could not keep up
+    if( Netplay && Speed != 1 )
+      return;
+    
+    FastForward = Speed;
+    
+    // restart frame rate measurement
+    FramesInPeriod = 0;
+    PeriodStartTicks = SDL_GetTicks();
+    EmulatedFPS = 0;
+    
+    if( Speed == FAST_FORWARD_UNCAPPED )
+      LOG( "Fast-forward set to uncapped speed" );
+    else
+      LOG( "Fast-forward set to speed " + to_string( Speed ) + "x" );
+}
+
+// -----------------------------------------------------------------------------
+
+// goes through speeds 1x, 2x, 4x and uncapped
+void EmulatorControl::CycleFastForward()
+{
+    switch( FastForward )
+    {
+        case 1:  SetFastForward( 2 ); break;
+        case 2:  SetFastForward( 4 ); break;
+        case 4:  SetFastForward( FAST_FORWARD_UNCAPPED ); break;
+        default: SetFastForward( 1 ); break;
+    }
+}
+
+// -----------------------------------------------------------------------------
+
+int EmulatorControl::GetFastForward()
+{
+    return FastForward;
+}
+
+// -----------------------------------------------------------------------------
+
+bool EmulatorControl::IsFastForwarding()
+{
+    return (FastForward != 1);
+}
+
+// -----------------------------------------------------------------------------
+
+float EmulatorControl::GetEmulatedFPS()
+{
+    return EmulatedFPS;
+}
+
+
+// =============================================================================
+//      EMULATOR CONTROL: RUN-AHEAD
+// =============================================================================
+
+
+void EmulatorControl::SetRunAhead( int Frames )
+{
+    RunAheadFrames = Frames;
+    Clamp( RunAheadFrames, 0, MAX_RUN_AHEAD_FRAMES );
+    LOG( "Run-ahead set to " + to_string( RunAheadFrames ) + " frames" );
+}
+
+// -----------------------------------------------------------------------------
+
+void EmulatorControl::CycleRunAhead()
+{
+    SetRunAhead( (RunAheadFrames + 1) % (MAX_RUN_AHEAD_FRAMES + 1) );
+}
+
+// -----------------------------------------------------------------------------
+
+int EmulatorControl::GetRunAhead()
+{
+    return RunAheadFrames;
+}
+
+
+// =============================================================================
+//      EMULATOR CONTROL: INPUT MOVIES
+// =============================================================================
+
+
+// recording starts with a console reset, and the
+// movie is saved to the given path when it stops
+void EmulatorControl::StartMovieRecording( const string& FilePath )
+{
+    StopMovie();
+    Paused = false;
+    Video.RenderToFramebuffer();
+    Movie.StartRecording( Console );
+    MoviePath = FilePath;
+    Audio.Reset();
+}
+
+// -----------------------------------------------------------------------------
+
+void EmulatorControl::StartMoviePlayback( const string& FilePath )
+{
+    StopMovie();
+    Movie.LoadFile( Console, FilePath );
+    
+    Paused = false;
+    Video.RenderToFramebuffer();
+    Movie.StartPlayback( Console );
+    Audio.Reset();
+}
+
+// -----------------------------------------------------------------------------
+
+void EmulatorControl::StopMovie()
+{
+    bool WasRecording = IsRecordingMovie();
+    Movie.Stop();
+    
+    if( WasRecording )
+    {
+        LOG( "Saving input movie (" + to_string( Movie.Header.NumberOfFrames ) + " frames) to \"" + MoviePath + "\"" );
+        Movie.SaveFile( Console, MoviePath );
+    }
+}
+
+// -----------------------------------------------------------------------------
+
+bool EmulatorControl::IsRecordingMovie()
+{
+    return (Movie.Mode == InputMovieModes::Recording);
+}
+
+// -----------------------------------------------------------------------------
+
+bool EmulatorControl::IsPlayingMovie()
+{
+    return (Movie.Mode == InputMovieModes::Playing);
+}
+
+
+// =============================================================================
+//      EMULATOR CONTROL: NETPLAY
+// =============================================================================
+
+
+// the session takes ownership of the transport
+void EmulatorControl::StartNetplay( NetplayTransport* Transport, bool Host )
+{
+    unique_ptr< NetplayTransport > NewTransport( Transport );
+    
+    if( !Console.IsPowerOn() || !Console.HasCartridge() )
+      THROW( "Netplay can only be started with the console on and a cartridge" );
+    
+    StopMovie();
+    StopNetplay();
+    SetFastForward( 1 );
+    Paused = false;
+    
+    // the console is reset once both players connect
+    Netplay.reset( new NetplaySession( Console, NewTransport.release(), Host ) );
+}
+
+// -----------------------------------------------------------------------------
+
+void EmulatorControl::StartNetplayHost( int Port )
+{
+    StartNetplay( new UDPTransport( Port ), true );
+}
+
+// -----------------------------------------------------------------------------
+
+void EmulatorControl::StartNetplayGuest( const string& HostName, int Port )
+{
+    StartNetplay( new UDPTransport( HostName, Port ), false );
+}
+
+// -----------------------------------------------------------------------------
+
+void EmulatorControl::StopNetplay()
+{
+    if( !Netplay )
+      return;
+    
+    LOG( "Netplay: session ended" );
+    Netplay.reset();
+    
+    // give back all gamepads to the frontend
+    Gamepads.AssignInputDevices();
+}
+
+// -----------------------------------------------------------------------------
+
+bool EmulatorControl::IsNetplayActive()
+{
+    return (bool)Netplay;
+}
+
+// -----------------------------------------------------------------------------
+
+NetplaySession* EmulatorControl::GetNetplaySession()
+{
+    return Netplay.get();
+}
+
+
+// =============================================================================
+//      EMULATOR CONTROL: GPU TRACES
+// =============================================================================
+
+
+void EmulatorControl::StartGPUTrace( const string& FilePath )
+{
+    if( !Console.IsPowerOn() )
+      THROW( "GPU traces can only be recorded with the console on" );
+    
+    Trace.StartRecording( Console, FilePath );
+    LOG( "Recording GPU trace to \"" + FilePath + "\"" );
+    
+    // the console does not keep texture pixels, so
+    // the ones already loaded are read back from video
+    vector< GPUColor > Pixels;
+    int Width, Height;
+    
+    for( int TextureID = -1; TextureID < Constants::GPUMaximumCartridgeTextures; TextureID++ )
+      if( Video.ReadTexture( TextureID, Pixels, Width, Height ) )
+        Trace.RecordTexture( TextureID, Pixels.data(), Width, Height );
+}
+
+// -----------------------------------------------------------------------------
+
+void EmulatorControl::StopGPUTrace()
+{
+    Trace.Stop( Console );
+}
+
+// -----------------------------------------------------------------------------
+
+bool EmulatorControl::IsRecordingGPUTrace()
+{
+    return Trace.IsRecording();
+}
+
+// -----------------------------------------------------------------------------
+
+int32_t EmulatorControl::GetGPUTraceFrames()
+{
+    return Trace.GetRecordedFrames();
 }
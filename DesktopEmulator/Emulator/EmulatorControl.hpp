@@ -6,9 +6,50 @@
     // include SDL2 headers
     #define SDL_MAIN_HANDLED
     #include "SDL.h"            // [ SDL2 ] Main header
+    
+    // include console logic headers
+    #include "ConsoleLogic/InputMovies.hpp"
+    #include "ConsoleLogic/GPUTraces.hpp"
+    
+    // include emulator headers
+    #include "Savestates.hpp"
+    #include "NetplaySession.hpp"
+    
+    // include C/C++ headers
+    #include <string>           // [ C++ STL ] Strings
+    #include <memory>           // [ C++ STL ] Dynamic memory
 // *****************************************************************************
 
 
+// =============================================================================
+//      DEFINITIONS FOR FAST-FORWARD
+// =============================================================================
+
+
+// Fast-forward speeds are given as multiples of the console's
+// normal speed. When uncapped, emulation runs as fast as the
+// host allows while still updating the window regularly.
+#define FAST_FORWARD_UNCAPPED      0
+
+// portion of each window update that can be spent
+// running frames when fast-forward is uncapped
+#define UNCAPPED_TIME_BUDGET  (0.75 / 60)
+
+
+// =============================================================================
+//      DEFINITIONS FOR RUN-AHEAD
+// =============================================================================
+
+
+// Run-ahead reduces input latency: after each presented frame
+// is run, its state is captured and the console runs some more
+// hidden frames with the same inputs. Only the last of those
+// is shown, and then the captured state is restored. This
+// removes the game's own latency of up to that many frames.
+// (It is not applied while an input movie or netplay is active)
+#define MAX_RUN_AHEAD_FRAMES       3
+
+
 // =============================================================================
 //      CLASS FOR EMULATOR CENTRAL CONTROL
 // =============================================================================
@@ -20,6 +61,31 @@ class EmulatorControl
         
         bool Paused;
         bool AutoCardHandling;
+        
+        // input movie being recorded or played
+        V32::InputMovie Movie;
+        std::string MoviePath;
+        
+        // fast-forward speed, and measurement
+        // of the actual emulated frame rate
+        int FastForward;
+        int FramesInPeriod;
+        Uint32 PeriodStartTicks;
+        float EmulatedFPS;
+        
+        // run-ahead configuration, and the real
+        // console state kept during hidden frames
+        int RunAheadFrames;
+        StateSnapshot RunAheadState;
+        
+        // netplay session, when one is active
+        std::unique_ptr< NetplaySession > Netplay;
+        
+        // GPU trace being recorded
+        V32::GPUTraceRecorder Trace;
+        
+        void RunAhead();
+        void StartNetplay( NetplayTransport* Transport, bool Host );
     
     public:
         
@@ -42,7 +108,44 @@ class EmulatorControl
         void SetPower( bool On );
         bool IsPowerOn();
         void Reset();
-        void RunNextFrame();
+        
+        // running frames: only the last frame of each
+        // batch is rendered, all others are skipped
+        void RunNextFrame( bool Skipped = false );
+        void RunFrames( int NumberOfFrames );
+        void RunFramesFor( double Seconds );
+        
+        // fast-forward
+        void SetFastForward( int Speed );
+        void CycleFastForward();
+        int GetFastForward();
+        bool IsFastForwarding();
+        float GetEmulatedFPS();
+        
+        // run-ahead
+        void SetRunAhead( int Frames );
+        void CycleRunAhead();
+        int GetRunAhead();
+        
+        // input movies
+        void StartMovieRecording( const std::string& FilePath );
+        void StartMoviePlayback( const std::string& FilePath );
+        void StopMovie();
+        bool IsRecordingMovie();
+        bool IsPlayingMovie();
+        
+        // netplay
+        void StartNetplayHost( int Port );
+        void StartNetplayGuest( const std::string& HostName, int Port );
+        void StopNetplay();
+        bool IsNetplayActive();
+        NetplaySession* GetNetplaySession();
+        
+        // GPU traces
+        void StartGPUTrace( const std::string& FilePath );
+        void StopGPUTrace();
+        bool IsRecordingGPUTrace();
+        int32_t GetGPUTraceFrames();
 };
 
 
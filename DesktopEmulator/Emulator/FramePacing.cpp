@@ -0,0 +1,195 @@
+// *****************************************************************************
+    // include infrastructure headers
+    #include "DesktopInfrastructure/Logger.hpp"
+    
+    // include emulator headers
+    #include "FramePacing.hpp"
+    
+    // include C/C++ headers
+    #include <cmath>            // [ ANSI C ] Mathematics
+    #include <algorithm>        // [ C++ STL ] Algorithms
+    #include <string>           // [ C++ STL ] Strings
+    
+    // declare used namespaces
+    using namespace std;
+// *****************************************************************************
+
+
+// =============================================================================
+//      FRAME PACER: INSTANCE HANDLING
+// =============================================================================
+
+
+FramePacer::FramePacer()
+{
+    ReportedRefreshRate = 0;
+    Reset();
+    
+    // no statistics until a full period is measured
+    AverageFrameTime = 0;
+    MaximumFrameTime = 0;
+    IrregularFrames = 0;
+}
+
+// -----------------------------------------------------------------------------
+
+void FramePacer::Reset()
+{
+    PendingFrames = 0;
+    
+    // until measured, assume that VSync works
+    MeasuredPeriod = 1.0 / (ReportedRefreshRate? ReportedRefreshRate : 60);
+    SyncedToDisplay = (ReportedRefreshRate > 0);
+    UpdateWatch.GetStepTime();
+    
+    PeriodSteps = 0;
+    PeriodTime = 0;
+    PeriodMaximumStep = 0;
+    PeriodIrregularSteps = 0;
+}
+
+
+// =============================================================================
+//      FRAME PACER: PACING OPERATION
+// =============================================================================
+
+
+// must be called at start and whenever the window
+// may have changed to a different display mode
+void FramePacer::UpdateDisplayMode( SDL_Window* Window )
+{
+    SDL_DisplayMode Mode;
+    int RefreshRate = 0;
+    
+    if( !SDL_GetCurrentDisplayMode( SDL_GetWindowDisplayIndex( Window ), &Mode ) )
+      RefreshRate = Mode.refresh_rate;
+    
+    if( RefreshRate == ReportedRefreshRate )
+      return;
+    
+    LOG( "Display refresh rate: " + to_string( RefreshRate ) + " Hz" );
+    ReportedRefreshRate = RefreshRate;
+    Reset();
+}
+
+// -----------------------------------------------------------------------------
+
+// the step is the time since the last call; speed
+// is the fast-forward multiplier (1 = normal speed)
+int FramePacer::GetFramesToRun( double TimeStep, int Speed )
+{
+    double NewFrames = 0;
+    
+    if( SyncedToDisplay )
+    {
+        double FramesPerRefresh = 60.0 * MeasuredPeriod;
+        
+        // lock to 1 frame every N refreshes when possible
+        for( int N = 1; N <= MAX_CATCH_UP_FRAMES; N++ )
+          if( fabs( FramesPerRefresh * N - 1 ) < MAX_REFRESH_MISMATCH )
+            FramesPerRefresh = 1.0 / N;
+        
+        // refreshes missed by a slow update still count
+        int Refreshes = (int)round( TimeStep / MeasuredPeriod );
+        Refreshes = max( 1, min( Refreshes, MAX_CATCH_UP_FRAMES ) );
+        NewFrames = Refreshes * FramesPerRefresh * Speed;
+    }
+    
+    // without VSync, use the measured time
+    else
+      NewFrames = min( TimeStep * 60.0, (double)MAX_CATCH_UP_FRAMES ) * Speed;
+    
+    PendingFrames += NewFrames;
+    
+    // a small margin prevents frames from being
+    // delayed by the precision of time measures
+    int FramesToRun = (int)(PendingFrames + 0.1);
+    PendingFrames -= FramesToRun;
+    
+    // count updates that did not follow the expected
+    // cadence (they cause a visible stutter)
+    if( FramesToRun < floor( NewFrames ) || FramesToRun > ceil( NewFrames ) )
+      PeriodIrregularSteps++;
+    
+    return FramesToRun;
+}
+
+// -----------------------------------------------------------------------------
+
+// call just after each window update is shown
+void FramePacer::WindowUpdated()
+{
+    double UpdateTime = UpdateWatch.GetStepTime();
+    
+    // with VSync, updates happen at the refresh rate;
+    // longer steps are limited to not distort the
+    // measure (reported rates are integers, so
+    // some difference is still accepted)
+    if( ReportedRefreshRate > 0 )
+    {
+        double ReportedPeriod = 1.0 / ReportedRefreshRate;
+        MeasuredPeriod += 0.02 * (min( UpdateTime, 1.5 * ReportedPeriod ) - MeasuredPeriod);
+        SyncedToDisplay = fabs( MeasuredPeriod - ReportedPeriod ) < 0.03 * ReportedPeriod;
+    }
+    
+    // update statistics once per second
+    PeriodSteps++;
+    PeriodTime += UpdateTime;
+    PeriodMaximumStep = max( PeriodMaximumStep, UpdateTime );
+    
+    if( PeriodTime >= 1 )
+    {
+        AverageFrameTime = PeriodTime / PeriodSteps;
+        MaximumFrameTime = PeriodMaximumStep;
+        IrregularFrames = PeriodIrregularSteps;
+        
+        PeriodSteps = 0;
+        PeriodTime = 0;
+        PeriodMaximumStep = 0;
+        PeriodIrregularSteps = 0;
+    }
+}
+
+
+// =============================================================================
+//      FRAME PACER: STATISTICS
+// =============================================================================
+
+
+double FramePacer::GetRefreshRate()
+{
+    if( SyncedToDisplay )
+      return 1.0 / MeasuredPeriod;
+    
+    return ReportedRefreshRate;
+}
+
+// -----------------------------------------------------------------------------
+
+bool FramePacer::IsSyncedToDisplay()
+{
+    return SyncedToDisplay;
+}
+
+// -----------------------------------------------------------------------------
+
+double FramePacer::GetAverageFrameTime()
+{
+    return AverageFrameTime;
+}
+
+// -----------------------------------------------------------------------------
+
+double FramePacer::GetMaximumFrameTime()
+{
+    return MaximumFrameTime;
+}
+
+// -----------------------------------------------------------------------------
+
+// number of window updates in the last second that
+// ran a different number of frames than expected
+int FramePacer::GetIrregularFrames()
+{
+    return IrregularFrames;
+}
@@ -0,0 +1,89 @@
+// *****************************************************************************
+    // start include guard
+    #ifndef FRAMEPACING_HPP
+    #define FRAMEPACING_HPP
+    
+    // include SDL2 headers
+    #define SDL_MAIN_HANDLED
+    #include "SDL.h"            // [ SDL2 ] Main header
+    
+    // include emulator headers
+    #include "StopWatch.hpp"
+// *****************************************************************************
+
+
+// =============================================================================
+//      DEFINITIONS FOR FRAME PACING
+// =============================================================================
+
+
+// The main loop is blocked by VSync on each window update,
+// so it runs at the display's refresh rate. When that rate
+// is close enough to 60 Hz (or to a multiple of it), each
+// update runs a fixed number of frames: the remaining small
+// mismatch is compensated by audio rate control. Otherwise
+// frames are distributed among updates at the right pace.
+// When VSync does not work, the measured time is used.
+
+// maximum difference with an exact 60 Hz multiple
+// that can still be locked to the display
+#define MAX_REFRESH_MISMATCH    0.005
+
+// longer steps are not caught up with (the
+// program was blocked, i.e. by a file dialog)
+#define MAX_CATCH_UP_FRAMES     4
+
+
+// =============================================================================
+//      CLASS FOR FRAME PACING
+// =============================================================================
+
+
+class FramePacer
+{
+    private:
+        
+        // display timing
+        int ReportedRefreshRate;        // as given by SDL (0 if unknown)
+        double MeasuredPeriod;          // smoothed time between window updates
+        bool SyncedToDisplay;
+        StopWatch UpdateWatch;
+        
+        // emulation frames due but not yet run
+        double PendingFrames;
+        
+        // statistics for the current period
+        int PeriodSteps;
+        double PeriodTime;
+        double PeriodMaximumStep;
+        int PeriodIrregularSteps;
+        
+        // statistics for the last full period
+        double AverageFrameTime;
+        double MaximumFrameTime;
+        int IrregularFrames;
+        
+    public:
+        
+        // instance handling
+        FramePacer();
+        void Reset();
+        
+        // pacing operation
+        void UpdateDisplayMode( SDL_Window* Window );
+        int GetFramesToRun( double TimeStep, int Speed );
+        void WindowUpdated();
+        
+        // statistics (times are in seconds)
+        double GetRefreshRate();
+        bool IsSyncedToDisplay();
+        double GetAverageFrameTime();
+        double GetMaximumFrameTime();
+        int GetIrregularFrames();
+};
+
+
+// *****************************************************************************
+    // end include guard
+    #endif
+// *****************************************************************************
@@ -12,6 +12,7 @@
     #include "GamepadsInput.hpp"
     #include "VideoOutput.hpp"
     #include "AudioOutput.hpp"
+    #include "FramePacing.hpp"
     #include "Texture.hpp"
     #include "Savestates.hpp"
     #include "Globals.hpp"
@@ -21,6 +22,7 @@
     // include C/C++ headers
     #include <time.h>               // [ ANSI C ] Time and date
     #include <stdexcept>            // [ C++ STL ] Exceptions
+    #include <cstdlib>              // [ ANSI C ] Standard library
     
     // include osdialog headers
     #include <osdialog/osdialog.h>  // [ Dear ImGui ] Main header
@@ -400,6 +402,30 @@ string GetAutomaticSaveStatePath( const string& CartridgePath )
     return SavestatesFolder + PathSeparator + SavestateFileName;
 }
 
+// -----------------------------------------------------------------------------
+
+// input movies are kept along with savestates,
+// with a single movie for each cartridge
+string GetAutomaticMoviePath( const string& CartridgePath )
+{
+    string SavestatesFolder = EmulatorFolder + "Savestates";
+    string CartridgeFileName = GetPathFileName( CartridgePath );
+    string MovieFileName = GetFileWithoutExtension( CartridgeFileName ) + ".movie";
+    return SavestatesFolder + PathSeparator + MovieFileName;
+}
+
+// -----------------------------------------------------------------------------
+
+// same for GPU traces, which are only
+// meant to be replayed by a separate tool
+string GetAutomaticGPUTracePath( const string& CartridgePath )
+{
+    string SavestatesFolder = EmulatorFolder + "Savestates";
+    string CartridgeFileName = GetPathFileName( CartridgePath );
+    string TraceFileName = GetFileWithoutExtension( CartridgeFileName ) + ".gputrace";
+    return SavestatesFolder + PathSeparator + TraceFileName;
+}
+
 
 // =============================================================================
 //      ENCAPSULATED GUI FUNCTIONS
@@ -706,12 +732,90 @@ void GUI_SaveScreenshot( string FilePath )
 
 // -----------------------------------------------------------------------------
 
+void GUI_ToggleMovieRecording()
+{
+    try
+    {
+        if( Emulator.IsRecordingMovie() )
+          Emulator.StopMovie();
+        
+        else if( Emulator.IsPowerOn() && Console.HasCartridge() )
+          Emulator.StartMovieRecording( GetAutomaticMoviePath( Console.GetCartridgeFileName() ) );
+    }
+    catch( exception& e )
+    {
+        DelayedMessageBox( SDL_MESSAGEBOX_ERROR, "Error", e.what() );
+    }
+}
+
+// -----------------------------------------------------------------------------
+
+void GUI_ToggleMoviePlayback()
+{
+    try
+    {
+        if( Emulator.IsPlayingMovie() )
+          Emulator.StopMovie();
+        
+        else if( Emulator.IsPowerOn() && Console.HasCartridge() )
+          Emulator.StartMoviePlayback( GetAutomaticMoviePath( Console.GetCartridgeFileName() ) );
+    }
+    catch( exception& e )
+    {
+        DelayedMessageBox( SDL_MESSAGEBOX_ERROR, "Error", e.what() );
+    }
+}
+
+// -----------------------------------------------------------------------------
+
+void GUI_ToggleGPUTrace()
+{
+    try
+    {
+        if( Emulator.IsRecordingGPUTrace() )
+          Emulator.StopGPUTrace();
+        
+        else if( Emulator.IsPowerOn() && Console.HasCartridge() )
+          Emulator.StartGPUTrace( GetAutomaticGPUTracePath( Console.GetCartridgeFileName() ) );
+    }
+    catch( exception& e )
+    {
+        DelayedMessageBox( SDL_MESSAGEBOX_ERROR, "Error", e.what() );
+    }
+}
+
+// -----------------------------------------------------------------------------
+
+// an empty host name means that we are the host
+void GUI_StartNetplay( const string& HostName, const string& Port )
+{
+    try
+    {
+        int PortNumber = atoi( Port.c_str() );
+        
+        if( PortNumber <= 0 || PortNumber > 65535 )
+          THROW( "Invalid netplay port: " + Port );
+        
+        if( HostName.empty() )
+          Emulator.StartNetplayHost( PortNumber );
+        else
+          Emulator.StartNetplayGuest( HostName, PortNumber );
+    }
+    catch( exception& e )
+    {
+        DelayedMessageBox( SDL_MESSAGEBOX_ERROR, "Error", e.what() );
+    }
+}
+
+// -----------------------------------------------------------------------------
+
 void GUI_LoadState()
 {
     try
     {
         string SavestatePath = GetAutomaticSaveStatePath( Console.GetCartridgeFileName() );
-        LoadState( SavestatePath );
+        LOG( "Loading state from slot " + to_string(SavestatesSlot) );
+        LoadState( Console, SavestatePath );
     }
     catch( exception& e )
     {
@@ -727,7 +831,8 @@ void GUI_SaveState()
     try
     {
         string SavestatePath = GetAutomaticSaveStatePath( Console.GetCartridgeFileName() );
-        SaveState( SavestatePath );
+        LOG( "Saving state in slot " + to_string(SavestatesSlot) );
+        SaveState( Console, SavestatePath );
     }
     catch( exception& e )
     {
@@ -1200,6 +1305,43 @@ void ProcessMenuHelp()
 
 // -----------------------------------------------------------------------------
 
+// timing statistics, to diagnose stutter or audio problems
+void ProcessTimingTooltip()
+{
+    ImGui::BeginTooltip();
+    
+    if( Pacer.IsSyncedToDisplay() )
+      ImGui::Text( "Display: %.2f Hz (synced)", Pacer.GetRefreshRate() );
+    else
+      ImGui::Text( "Display: not synced" );
+    
+    ImGui::Text( "Frame time: %.1f ms avg, %.1f ms max", 1000 * Pacer.GetAverageFrameTime(), 1000 * Pacer.GetMaximumFrameTime() );
+    ImGui::Text( "Irregular frames: %d per second", Pacer.GetIrregularFrames() );
+    ImGui::Text( "Audio queue: %.0f ms, rate %+.2f%%", 1000 * Audio.GetQueuedTime(), 100 * Audio.GetRateAdjustment() );
+    
+    // netplay status, when active
+    NetplaySession* Netplay = Emulator.GetNetplaySession();
+    
+    if( Netplay && Netplay->GetState() == NetplayStates::Connecting )
+      ImGui::Text( "Netplay: connecting" );
+    
+    else if( Netplay )
+    {
+        ImGui::Text( "Netplay: frame %d, round trip %.0f ms", Netplay->GetCurrentFrame(), Netplay->GetRoundTripTime() );
+        ImGui::Text( "Rolled back: %d frames (max %d at once)", Netplay->GetRolledBackFrames(), Netplay->GetMaximumRollback() );
+        
+        if( Netplay->GetDesyncFrame() >= 0 )
+          ImGui::Text( "Desync detected at frame %d", Netplay->GetDesyncFrame() );
+    }
+    
+    if( Emulator.IsRecordingGPUTrace() )
+      ImGui::Text( "GPU trace: recording, %d frames", Emulator.GetGPUTraceFrames() );
+    
+    ImGui::EndTooltip();
+}
+
+// -----------------------------------------------------------------------------
+
 void ProcessLabelCPU()
 {
     ImGui::PushStyleVar(ImGuiStyleVar_Alpha, ImGui::GetStyle().Alpha * 0.5f);
@@ -1221,6 +1363,41 @@ void ProcessLabelCPU()
     }
     
     ImGui::PopStyleVar();
+    
+    if( ImGui::IsItemHovered() )
+      ProcessTimingTooltip();
+}
+
+
+// -----------------------------------------------------------------------------
+
+// small overlay showing the actual emulation speed
+// (it ignores input, so the game remains usable)
+void ProcessFastForwardIndicator()
+{
+    const ImGuiViewport* Viewport = ImGui::GetMainViewport();
+    ImVec2 Position( Viewport->WorkPos.x + 10, Viewport->WorkPos.y + Viewport->WorkSize.y - 10 );
+    ImGui::SetNextWindowPos( Position, ImGuiCond_Always, ImVec2( 0, 1 ) );
+    ImGui::SetNextWindowBgAlpha( 0.5 );
+    
+    ImGuiWindowFlags Flags = ImGuiWindowFlags_NoDecoration
+                           | ImGuiWindowFlags_AlwaysAutoResize
+                           | ImGuiWindowFlags_NoSavedSettings
+                           | ImGuiWindowFlags_NoFocusOnAppearing
+                           | ImGuiWindowFlags_NoNav
+                           | ImGuiWindowFlags_NoInputs;
+    
+    if( ImGui::Begin( "FastForward", nullptr, Flags ) )
+    {
+        int FPS = Emulator.GetEmulatedFPS();
+        
+        if( Emulator.GetFastForward() == FAST_FORWARD_UNCAPPED )
+          ImGui::Text( ">> Uncapped: %d fps", FPS );
+        else
+          ImGui::Text( ">> %dx: %d fps", Emulator.GetFastForward(), FPS );
+    }
+    
+    ImGui::End();
 }
 
 
@@ -1297,6 +1474,15 @@ void RenderGUI()
     ImGui_ImplSDL2_NewFrame( Video.GetWindow() );
     ImGui::NewFrame();
     
+    // when only the fast-forward indicator has to be
+    // shown, menus are still processed (so that they can
+    // react to the mouse) but they are fully transparent
+    bool ShowFastForward = Emulator.IsPowerOn() && Emulator.IsFastForwarding();
+    bool OnlyFastForward = ShowFastForward && !GUIMustBeDrawn();
+    
+    if( OnlyFastForward )
+      ImGui::PushStyleVar( ImGuiStyleVar_Alpha, 0 );
+    
     // show the main menu bar
     if( ImGui::BeginMainMenuBar() )
     {
@@ -1314,8 +1500,15 @@ void RenderGUI()
         ImGui::EndMainMenuBar();
     }
     
+    if( OnlyFastForward )
+      ImGui::PopStyleVar();
+    
+    // show the emulation speed on screen
+    if( ShowFastForward )
+      ProcessFastForwardIndicator();
+    
     // (2) Render imgui
-    if( GUIMustBeDrawn() )
+    if( GUIMustBeDrawn() || OnlyFastForward )
     {
         ImGui::Render();
         ImGui_ImplOpenGL3_RenderDrawData( ImGui::GetDrawData() );
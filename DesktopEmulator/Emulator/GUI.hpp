@@ -41,6 +41,8 @@ void CheckCartridgePaths();
 void CheckMemoryCardPaths();
 std::string GetAutomaticMemoryCardPath( const std::string& CartridgePath );
 std::string GetAutomaticSaveStatePath( const std::string& CartridgePath );
+std::string GetAutomaticMoviePath( const std::string& CartridgePath );
+std::string GetAutomaticGPUTracePath( const std::string& CartridgePath );
 
 
 // =============================================================================
@@ -59,6 +61,10 @@ void GUI_ChangeCartridge( std::string CartridgePath = "" );
 void GUI_SaveScreenshot( std::string FilePath = "" );
 void GUI_LoadState();
 void GUI_SaveState();
+void GUI_ToggleMovieRecording();
+void GUI_ToggleMoviePlayback();
+void GUI_ToggleGPUTrace();
+void GUI_StartNetplay( const std::string& HostName, const std::string& Port );
 
 
 // =============================================================================
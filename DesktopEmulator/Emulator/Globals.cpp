@@ -8,6 +8,7 @@
     // include emulator headers
     #include "EmulatorControl.hpp"
     #include "GamepadsInput.hpp"
+    #include "FramePacing.hpp"
     #include "VideoOutput.hpp"
     #include "AudioOutput.hpp"
     #include "Texture.hpp"
@@ -43,6 +44,10 @@ int SavestatesSlot;
 
 
 // instance of the Vircon virtual machine
+// (its frontend is defined first so that it
+// is still available when the console is
+// destroyed and unloads its media)
+DesktopFrontend Frontend;
 V32::V32Console Console;
 
 // wrappers for console I/O operation
@@ -50,6 +55,7 @@ EmulatorControl Emulator;
 VideoOutput Video;
 AudioOutput Audio;
 GamepadsInput Gamepads;
+FramePacer Pacer;
 
 // video resources
 Texture NoSignalTexture;
@@ -76,92 +82,88 @@ void InitializeGlobalVariables()
 
 
 // =============================================================================
-//      CALLBACK FUNCTIONS FOR CONSOLE LOGIC
+//      FRONTEND FUNCTIONS FOR CONSOLE LOGIC
 // =============================================================================
 
 
-namespace CallbackFunctions
+void DesktopFrontend::ClearScreen( V32::GPUColor ClearColor )
 {
-    void ClearScreen( V32::GPUColor ClearColor )
-    {
-        Video.ClearScreen( ClearColor );
-    }
-
-    // -----------------------------------------------------------------------------
-
-    void DrawQuad( V32::GPUQuad& DrawnQuad )
-    {
-        Video.AddQuadToQueue( DrawnQuad );
-    }
-
-    // -----------------------------------------------------------------------------
-
-    void SetMultiplyColor( V32::GPUColor NewMultiplyColor )
-    {
-        // GPU colors are not directly comparable so use words
-        V32::V32Word New, Old;
-        New.AsColor = NewMultiplyColor;
-        Old.AsColor = Video.GetMultiplyColor();
-        
-        // set multiply color only when needed, so that
-        // quad groups are not broken without need
-        if( New.AsInteger != Old.AsInteger )
-          Video.SetMultiplyColor( NewMultiplyColor );
-    }
-
-    // -----------------------------------------------------------------------------
-
-    void SetBlendingMode( int NewBlendingMode )
-    {
-        // set blending mode only when needed, so that
-        // quad groups are not broken without need
-        if( NewBlendingMode != (int)Video.GetBlendingMode() )
-          Video.SetBlendingMode( (V32::IOPortValues)NewBlendingMode );
-    }
-
-    // -----------------------------------------------------------------------------
-
-    void SelectTexture( int GPUTextureID )
-    {
-        // select texture only when needed, so that
-        // quad groups are not broken without need
-        if( GPUTextureID != Video.GetSelectedTexture() )
-          Video.SelectTexture( GPUTextureID );
-    }
-
-    // -----------------------------------------------------------------------------
-
-    void LoadTexture( int GPUTextureID, void* Pixels )
-    {
-        Video.LoadTexture( GPUTextureID, Pixels );
-    }
-
-    // -----------------------------------------------------------------------------
-
-    void UnloadCartridgeTextures()
-    {
-        for( int i = 0; i < V32::Constants::GPUMaximumCartridgeTextures; i++ )
-          Video.UnloadTexture( i );
-    }
-    
-    // -----------------------------------------------------------------------------
+    Video.ClearScreen( ClearColor );
+}
 
-    void UnloadBiosTexture()
-    {
-        Video.UnloadTexture( -1 );
-    }
-    
-    // -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
 
-    void LogLine( const string& Message )
-    {
-        LOG( Message );
-    }
+void DesktopFrontend::DrawQuad( V32::GPUQuad& DrawnQuad )
+{
+    Video.AddQuadToQueue( DrawnQuad );
+}
+
+// -----------------------------------------------------------------------------
+
+void DesktopFrontend::SetMultiplyColor( V32::GPUColor NewMultiplyColor )
+{
+    // GPU colors are not directly comparable so use words
+    V32::V32Word New, Old;
+    New.AsColor = NewMultiplyColor;
+    Old.AsColor = Video.GetMultiplyColor();
     
-    // -----------------------------------------------------------------------------
+    // set multiply color only when needed, so that
+    // quad groups are not broken without need
+    if( New.AsInteger != Old.AsInteger )
+      Video.SetMultiplyColor( NewMultiplyColor );
+}
+
+// -----------------------------------------------------------------------------
+
+void DesktopFrontend::SetBlendingMode( int NewBlendingMode )
+{
+    // set blending mode only when needed, so that
+    // quad groups are not broken without need
+    if( NewBlendingMode != (int)Video.GetBlendingMode() )
+      Video.SetBlendingMode( (V32::IOPortValues)NewBlendingMode );
+}
+
+// -----------------------------------------------------------------------------
+
+void DesktopFrontend::SelectTexture( int GPUTextureID )
+{
+    // select texture only when needed, so that
+    // quad groups are not broken without need
+    if( GPUTextureID != Video.GetSelectedTexture() )
+      Video.SelectTexture( GPUTextureID );
+}
+
+// -----------------------------------------------------------------------------
 
-    void ThrowException( const string& Message )
-    {
-        THROW( Message );
-    }
+void DesktopFrontend::LoadTexture( int GPUTextureID, void* Pixels, int Width, int Height )
+{
+    Video.LoadTexture( GPUTextureID, Pixels, Width, Height );
+}
+
+// -----------------------------------------------------------------------------
+
+void DesktopFrontend::UnloadCartridgeTextures()
+{
+    Video.UnloadCartridgeTextures();
+}
+
+// -----------------------------------------------------------------------------
+
+void DesktopFrontend::UnloadBiosTexture()
+{
+    Video.UnloadTexture( -1 );
+}
+
+// -----------------------------------------------------------------------------
+
+void DesktopFrontend::LogLine( const string& Message )
+{
+    LOG( Message );
+}
+
+// -----------------------------------------------------------------------------
+
+void DesktopFrontend::ThrowException( const string& Message )
+{
+    THROW( Message );
 }
@@ -16,9 +16,11 @@
     namespace V32{ class V32Console; }
     class EmulatorControl;
     class GamepadsInput;
+    class FramePacer;
     class VideoOutput;
     class AudioOutput;
     class Texture;
+    class DesktopFrontend;
 // *****************************************************************************
 
 
@@ -47,6 +49,7 @@ extern int SavestatesSlot;
 
 
 // instance of the Vircon virtual machine
+extern DesktopFrontend Frontend;
 extern V32::V32Console Console;
 
 // wrappers for console I/O operation
@@ -54,6 +57,7 @@ extern EmulatorControl Emulator;
 extern VideoOutput Video;
 extern AudioOutput Audio;
 extern GamepadsInput Gamepads;
+extern FramePacer Pacer;
 
 // video resources
 extern Texture NoSignalTexture;
@@ -68,26 +72,30 @@ void InitializeGlobalVariables();
 
 
 // =============================================================================
-//      CALLBACK FUNCTIONS FOR CONSOLE LOGIC
+//      FRONTEND FUNCTIONS FOR CONSOLE LOGIC
 // =============================================================================
 
 
-namespace CallbackFunctions
+// the console reaches the emulator's video and log
+// systems through this object, set in EmulatorControl
+class DesktopFrontend: public V32::VirconFrontendInterface
 {
-    // video functions callable by the console
-    void ClearScreen( V32::GPUColor ClearColor );
-    void DrawQuad( V32::GPUQuad& DrawnQuad );
-    void SetMultiplyColor( V32::GPUColor NewMultiplyColor );
-    void SetBlendingMode( int NewBlendingMode );
-    void SelectTexture( int GPUTextureID );
-    void LoadTexture( int GPUTextureID, void* Pixels );
-    void UnloadCartridgeTextures();
-    void UnloadBiosTexture();
-    
-    // log functions callable by the console
-    void LogLine( const std::string& Message );
-    void ThrowException( const std::string& Message );
-}
+    public:
+        
+        // video functions callable by the console
+        void ClearScreen( V32::GPUColor ClearColor ) override;
+        void DrawQuad( V32::GPUQuad& DrawnQuad ) override;
+        void SetMultiplyColor( V32::GPUColor NewMultiplyColor ) override;
+        void SetBlendingMode( int NewBlendingMode ) override;
+        void SelectTexture( int GPUTextureID ) override;
+        void LoadTexture( int GPUTextureID, void* Pixels, int Width, int Height ) override;
+        void UnloadCartridgeTextures() override;
+        void UnloadBiosTexture() override;
+        
+        // log functions callable by the console
+        void LogLine( const std::string& Message ) override;
+        void ThrowException( const std::string& Message ) override;
+};
 
 
 // *****************************************************************************
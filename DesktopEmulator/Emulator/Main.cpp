@@ -16,6 +16,7 @@
     #include "Globals.hpp"
     #include "Languages.hpp"
     #include "StopWatch.hpp"
+    #include "FramePacing.hpp"
     #include "Texture.hpp"
     
     // include C/C++ headers
@@ -129,9 +130,13 @@ string GetProgramFolder()
 
 int main( int NumberOfArguments, char* Arguments[] )
 {
-    if( NumberOfArguments > 2 )
+    // netplay options can follow the ROM file
+    bool NetplayHost = (NumberOfArguments == 4 && string( Arguments[ 2 ] ) == "-host");
+    bool NetplayGuest = (NumberOfArguments == 5 && string( Arguments[ 2 ] ) == "-join");
+    
+    if( NumberOfArguments > 2 && !NetplayHost && !NetplayGuest )
     {
-        cout << "USAGE: Vircon32 <optional: ROM file>" << endl;
+        cout << "USAGE: Vircon32 <optional: ROM file> <optional: -host PORT | -join ADDRESS PORT>" << endl;
         return 1;
     }
     
@@ -293,7 +298,7 @@ int main( int NumberOfArguments, char* Arguments[] )
         
         // if a cartridge file has been specified, load it
         // (this will also turn on the console)
-        if( NumberOfArguments == 2 )
+        if( NumberOfArguments >= 2 )
         {
             #if defined(WINDOWS_OS)
             
@@ -315,6 +320,13 @@ int main( int NumberOfArguments, char* Arguments[] )
             #endif
         }
         
+        // start netplay with the loaded cartridge
+        if( NetplayHost )
+          GUI_StartNetplay( "", Arguments[ 3 ] );
+        
+        if( NetplayGuest )
+          GUI_StartNetplay( Arguments[ 3 ], Arguments[ 4 ] );
+        
         // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
         
         // program state control
@@ -323,10 +335,10 @@ int main( int NumberOfArguments, char* Arguments[] )
         LOG( "---------------------------------------------------------------------" );
         GlobalLoopActive = true;
         bool WindowActive = true;
-        float PendingFrames = 1;
         
         // timing control
         StopWatch Watch;
+        Pacer.UpdateDisplayMode( Video.GetWindow() );
         
         // begin message loop
         while( GlobalLoopActive )
@@ -381,6 +393,12 @@ int main( int NumberOfArguments, char* Arguments[] )
                         SDL_GL_SwapWindow( Video.GetWindow() );
                     }
                     
+                    // the window may now be on a different display
+                    // (or changed its mode when going full screen)
+                    if( Event.window.event == SDL_WINDOWEVENT_MOVED
+                    ||  Event.window.event == SDL_WINDOWEVENT_SIZE_CHANGED )
+                      Pacer.UpdateDisplayMode( Video.GetWindow() );
+                    
                     // keep track of when mouse is inside our window
                     if( Event.window.event == SDL_WINDOWEVENT_ENTER )
                       MouseIsOnWindow = true;
@@ -410,6 +428,21 @@ int main( int NumberOfArguments, char* Arguments[] )
                     // Key F4 loads state from the current slot
                     if( Key == SDLK_F4 ) GUI_LoadState();
                     
+                    // Key F6 starts/stops recording an input movie
+                    if( Key == SDLK_F6 ) GUI_ToggleMovieRecording();
+                    
+                    // Key F7 starts/stops playing an input movie
+                    if( Key == SDLK_F7 ) GUI_ToggleMoviePlayback();
+                    
+                    // Key F8 cycles fast-forward speeds
+                    if( Key == SDLK_F8 ) Emulator.CycleFastForward();
+                    
+                    // Key F9 cycles run-ahead frames
+                    if( Key == SDLK_F9 ) Emulator.CycleRunAhead();
+                    
+                    // Key F10 starts/stops recording a GPU trace
+                    if( Key == SDLK_F10 ) GUI_ToggleGPUTrace();
+                    
                     // when CTRL is pressed, process keyboard shortcuts
                     bool ControlIsPressed = (SDL_GetModState() & KMOD_CTRL);
                     
@@ -500,15 +533,24 @@ int main( int NumberOfArguments, char* Arguments[] )
             
             if( Emulator.IsPowerOn() && !Emulator.IsPaused() )
             {
-                // execute frames as needed
-                PendingFrames += TimeStep * 60.0;
-                if( PendingFrames < 0.9 ) continue;
+                // when uncapped, run as many frames as
+                // possible until the window is updated
+                if( Emulator.GetFastForward() == FAST_FORWARD_UNCAPPED )
+                  Emulator.RunFramesFor( UNCAPPED_TIME_BUDGET );
                 
-                while( PendingFrames >= 0.9 )
+                else
                 {
-                    // run another frame
-                    Emulator.RunNextFrame();
-                    PendingFrames -= 1;
+                    // execute frames as needed
+                    int FramesToRun = Pacer.GetFramesToRun( TimeStep, Emulator.GetFastForward() );
+                    
+                    // without VSync, the window is only
+                    // updated when there are new frames
+                    if( !FramesToRun && !Pacer.IsSyncedToDisplay() )
+                      continue;
+                    
+                    // only the last of them needs to be rendered
+                    if( FramesToRun > 0 )
+                      Emulator.RunFrames( FramesToRun );
                 }
             }
             
@@ -523,6 +565,7 @@ int main( int NumberOfArguments, char* Arguments[] )
             
             // (3) Show updates on screen
             SDL_GL_SwapWindow( Video.GetWindow() );
+            Pacer.WindowUpdated();
             
             // (4) Show message boxes when needed
             ShowDelayedMessageBox();
@@ -0,0 +1,577 @@
+// *****************************************************************************
+    // include console logic headers
+    #include "ConsoleLogic/InputMovies.hpp"
+    #include "ConsoleLogic/AuxiliaryFunctions.hpp"
+    
+    // include infrastructure headers
+    #include "DesktopInfrastructure/Logger.hpp"
+    
+    // include emulator headers
+    #include "NetplaySession.hpp"
+    #include "StopWatch.hpp"
+    
+    // include C/C++ headers
+    #include <cstring>          // [ ANSI C ] Strings
+    #include <cstddef>          // [ ANSI C ] Standard definitions
+    
+    // declare used namespaces
+    using namespace std;
+    using namespace V32;
+// *****************************************************************************
+
+
+// =============================================================================
+//      AUXILIARY FUNCTIONS
+// =============================================================================
+
+
+const char NetplaySignature[] = "V32-NETP";
+
+// -----------------------------------------------------------------------------
+
+// position of a frame in the circular input buffers
+int32_t InputIndex( int32_t Frame )
+{
+    return Frame & (NETPLAY_INPUT_HISTORY - 1);
+}
+
+// -----------------------------------------------------------------------------
+
+// input used before any player input can arrive:
+// gamepad connected, with all controls released
+uint32_t GetNeutralInput()
+{
+    uint32_t Input = MovieInputConnected;
+    
+    for( int i = 0; i < 11; i++ )
+      Input |= (uint32_t)MovieControlCodes::ReleasedLong << (1 + 2*i);
+    
+    return Input;
+}
+
+// -----------------------------------------------------------------------------
+
+// remote players are predicted to keep their controls as
+// they were: events from their last known input are not
+// repeated, except for the ones that change nothing
+uint32_t PredictInput( uint32_t LastInput )
+{
+    uint32_t Prediction = LastInput & MovieInputConnected;
+    
+    for( int i = 0; i < 11; i++ )
+    {
+        uint32_t CodeBits = LastInput & (3u << (1 + 2*i));
+        
+        if( CodeBits == ((uint32_t)MovieControlCodes::ReleasedLong << (1 + 2*i)) )
+          Prediction |= CodeBits;
+    }
+    
+    return Prediction;
+}
+
+
+// =============================================================================
+//      NETPLAY SESSION: INSTANCE HANDLING
+// =============================================================================
+
+
+NetplaySession::NetplaySession( V32Console& TargetConsole, NetplayTransport* NewTransport, bool Host, int32_t Delay )
+:   Console( TargetConsole )
+{
+    Transport.reset( NewTransport );
+    State = NetplayStates::Connecting;
+    IsHost = Host;
+    InputDelay = Delay;
+    Clamp( InputDelay, 0, NETPLAY_MAX_INPUT_DELAY );
+    LastReceivedTicks = SDL_GetTicks();
+    
+    InitialDate = InitialTime = InitialRandomSeed = 0;
+    
+    LocalPort = (IsHost? 0 : 1);
+    RemotePort = 1 - LocalPort;
+    
+    RoundTripTime = 0;
+    RolledBackFrames = 0;
+    MaximumRollback = 0;
+    RollbackTime = 0;
+    
+    for( unique_ptr< StateSnapshot >& Snapshot: Snapshots )
+      Snapshot.reset( new StateSnapshot( Console ) );
+    
+    // the rest is initialized when both connect
+    ResetConsole();
+}
+
+
+// =============================================================================
+//      NETPLAY SESSION: PROTOCOL
+// =============================================================================
+
+
+void NetplaySession::InitializePacket( NetplayPacket& Packet, NetplayPacketTypes Type )
+{
+    memset( &Packet, 0, sizeof(Packet) );
+    memcpy( Packet.Signature, NetplaySignature, 8 );
+    Packet.Type = (int32_t)Type;
+    
+    strncpy( Packet.CartridgeTitle, Console.CartridgeController.CartridgeTitle.c_str(), sizeof(Packet.CartridgeTitle) - 1 );
+    Packet.ProgramROMSize = Console.CartridgeController.MemorySize;
+}
+
+// -----------------------------------------------------------------------------
+
+// both players need to have the same cartridge
+bool NetplaySession::CheckCartridge( const NetplayPacket& Packet )
+{
+    if( !strncmp( Packet.CartridgeTitle, Console.CartridgeController.CartridgeTitle.c_str(), sizeof(Packet.CartridgeTitle) - 1 )
+    &&  Packet.ProgramROMSize == Console.CartridgeController.MemorySize )
+      return true;
+    
+    LOG( "Netplay: the remote player has a different cartridge" );
+    State = NetplayStates::Disconnected;
+    return false;
+}
+
+// -----------------------------------------------------------------------------
+
+void NetplaySession::SendStart()
+{
+    NetplayPacket Packet;
+    InitializePacket( Packet, NetplayPacketTypes::Start );
+    
+    Packet.InitialDate = InitialDate;
+    Packet.InitialTime = InitialTime;
+    Packet.InitialRandomSeed = InitialRandomSeed;
+    Packet.InputDelay = InputDelay;
+    
+    Transport->Send( &Packet, offsetof( NetplayPacket, Inputs ) );
+}
+
+// -----------------------------------------------------------------------------
+
+void NetplaySession::SendInputs()
+{
+    NetplayPacket Packet;
+    InitializePacket( Packet, NetplayPacketTypes::Inputs );
+    
+    Packet.CurrentFrame = CurrentFrame;
+    Packet.LastReceivedFrame = LastRemoteFrame;
+    Packet.FrameAdvantage = CurrentFrame - RemoteFrame;
+    Packet.SendTicks = SDL_GetTicks();
+    Packet.EchoedTicks = RemoteSendTicks;
+    
+    // send the latest checksum that can no longer change:
+    // all inputs before it must be known, and correct
+    Packet.ChecksumFrame = -1;
+    
+    for( int i = 0; i < 4; i++ )
+    {
+        int32_t Frame = LocalChecksumFrames[ i ];
+        bool IsFinal = (Frame - 1 <= LastRemoteFrame) && (FirstMispredictedFrame < 0 || FirstMispredictedFrame >= Frame);
+        
+        if( IsFinal && Frame > Packet.ChecksumFrame )
+        {
+            Packet.ChecksumFrame = Frame;
+            Packet.Checksum = LocalChecksums[ i ];
+        }
+    }
+    
+    // repeat all inputs the remote player does not have
+    Packet.FirstInputFrame = RemoteAckFrame + 1;
+    Packet.NumberOfInputs = min( LastLocalFrame - RemoteAckFrame, NETPLAY_INPUTS_PER_PACKET );
+    
+    for( int i = 0; i < Packet.NumberOfInputs; i++ )
+      Packet.Inputs[ i ] = LocalInputs[ InputIndex( Packet.FirstInputFrame + i ) ];
+    
+    Transport->Send( &Packet, offsetof( NetplayPacket, Inputs ) + 4 * Packet.NumberOfInputs );
+}
+
+// -----------------------------------------------------------------------------
+
+void NetplaySession::ReceivePackets()
+{
+    NetplayPacket Packet;
+    int Size;
+    
+    while( (Size = Transport->Receive( &Packet, sizeof(Packet) )) > 0 )
+    {
+        // ignore anything that is not a valid packet
+        if( Size < (int)offsetof( NetplayPacket, Inputs ) || !CheckSignature( Packet.Signature, NetplaySignature ) )
+          continue;
+        
+        if( !IsBetween( Packet.NumberOfInputs, 0, NETPLAY_INPUTS_PER_PACKET )
+        ||  Size < (int)offsetof( NetplayPacket, Inputs ) + 4 * Packet.NumberOfInputs )
+          continue;
+        
+        LastReceivedTicks = SDL_GetTicks();
+        NetplayPacketTypes Type = (NetplayPacketTypes)Packet.Type;
+        
+        // the host starts when a guest joins; it
+        // has to reply again if its reply was lost
+        if( Type == NetplayPacketTypes::Join && IsHost && State != NetplayStates::Disconnected )
+        {
+            if( !CheckCartridge( Packet ) )
+              return;
+            
+            if( State == NetplayStates::Connecting )
+            {
+                InitialDate = Console.Timer.CurrentDate;
+                InitialTime = Console.Timer.CurrentTime;
+                Console.RNG.Reset();
+                InitialRandomSeed = Console.RNG.CurrentValue;
+                
+                ResetConsole();
+                State = NetplayStates::Running;
+                LOG( "Netplay: guest joined, session started" );
+            }
+            
+            SendStart();
+        }
+        
+        // guests take the initial state from their host
+        if( Type == NetplayPacketTypes::Start && !IsHost && State == NetplayStates::Connecting )
+        {
+            if( !CheckCartridge( Packet ) )
+              return;
+            
+            InitialDate = Packet.InitialDate;
+            InitialTime = Packet.InitialTime;
+            InitialRandomSeed = Packet.InitialRandomSeed;
+            InputDelay = Packet.InputDelay;
+            Clamp( InputDelay, 0, NETPLAY_MAX_INPUT_DELAY );
+            
+            ResetConsole();
+            State = NetplayStates::Running;
+            LOG( "Netplay: joined host, session started" );
+        }
+        
+        if( Type == NetplayPacketTypes::Inputs && State == NetplayStates::Running )
+          ProcessInputs( Packet );
+    }
+}
+
+// -----------------------------------------------------------------------------
+
+void NetplaySession::ProcessInputs( const NetplayPacket& Packet )
+{
+    // packets can arrive out of order, so
+    // only keep information that is newer
+    if( Packet.CurrentFrame > RemoteFrame )
+    {
+        RemoteFrame = Packet.CurrentFrame;
+        RemoteAdvantage = 0.9 * RemoteAdvantage + 0.1 * Packet.FrameAdvantage;
+        RemoteSendTicks = Packet.SendTicks;
+    }
+    
+    RemoteAckFrame = max( RemoteAckFrame, Packet.LastReceivedFrame );
+    
+    // measure the time our last packet took to return
+    if( Packet.EchoedTicks != 0 && Packet.EchoedTicks != LastEchoedTicks )
+    {
+        float Sample = SDL_GetTicks() - Packet.EchoedTicks;
+        RoundTripTime = (RoundTripTime > 0? 0.9 * RoundTripTime + 0.1 * Sample : Sample);
+        LastEchoedTicks = Packet.EchoedTicks;
+    }
+    
+    if( Packet.ChecksumFrame > RemoteChecksumFrame )
+    {
+        RemoteChecksumFrame = Packet.ChecksumFrame;
+        RemoteChecksum = Packet.Checksum;
+    }
+    
+    // take only the inputs that follow the ones we have
+    for( int i = 0; i < Packet.NumberOfInputs; i++ )
+    {
+        int32_t Frame = Packet.FirstInputFrame + i;
+        
+        if( Frame <= LastRemoteFrame )
+          continue;
+        
+        // never overwrite inputs that may still be needed
+        if( Frame != LastRemoteFrame + 1 || Frame >= CurrentFrame + NETPLAY_INPUT_HISTORY - NETPLAY_MAX_ROLLBACK_FRAMES - 1 )
+          break;
+        
+        // frames already run with a wrong prediction
+        // will need to be run again from the first one
+        uint32_t& StoredInput = RemoteInputs[ InputIndex( Frame ) ];
+        
+        if( Frame < CurrentFrame && StoredInput != Packet.Inputs[ i ] && FirstMispredictedFrame < 0 )
+          FirstMispredictedFrame = Frame;
+        
+        StoredInput = Packet.Inputs[ i ];
+        LastRemoteFrame = Frame;
+    }
+}
+
+
+// =============================================================================
+//      NETPLAY SESSION: EMULATION
+// =============================================================================
+
+
+// both consoles start from a reset with the same
+// date, time and random seed (as in input movies)
+void NetplaySession::ResetConsole()
+{
+    if( State == NetplayStates::Running )
+    {
+        Console.Reset();
+        Console.Timer.CurrentDate = InitialDate;
+        Console.Timer.CurrentTime = InitialTime;
+        Console.RNG.CurrentValue = InitialRandomSeed;
+    }
+    
+    // all gamepads start disconnected and released,
+    // except for the local one that the frontend uses
+    GamepadState* RealTimeStates = Console.GamepadController.RealTimeGamepadStates;
+    int32_t LocalConnected = RealTimeStates[ 0 ].Connected;
+    
+    for( int Gamepad = 0; Gamepad < Constants::GamepadPorts; Gamepad++ )
+    {
+        RealTimeStates[ Gamepad ].Connected = false;
+        Console.GamepadController.ResetGamepad( Gamepad );
+        SyncedGamepads[ Gamepad ] = RealTimeStates[ Gamepad ];
+    }
+    
+    LocalGamepad.RealTimeGamepadStates[ 0 ] = RealTimeStates[ 0 ];
+    LocalGamepad.RealTimeGamepadStates[ 0 ].Connected = LocalConnected;
+    RealTimeStates[ 0 ] = LocalGamepad.RealTimeGamepadStates[ 0 ];
+    
+    // inputs for the first frames are fixed, since
+    // they are used before any input can arrive
+    CurrentFrame = 0;
+    uint32_t NeutralInput = GetNeutralInput();
+    
+    for( int i = 0; i < NETPLAY_INPUT_HISTORY; i++ )
+      LocalInputs[ i ] = RemoteInputs[ i ] = NeutralInput;
+    
+    LastLocalFrame = LastRemoteFrame = RemoteAckFrame = InputDelay - 1;
+    FirstMispredictedFrame = -1;
+    
+    for( int i = 0; i < 4; i++ )
+      LocalChecksumFrames[ i ] = -1;
+    
+    RemoteChecksumFrame = -1;
+    LastComparedFrame = -1;
+    DesyncFrame = -1;
+    
+    RemoteFrame = 0;
+    LocalAdvantage = RemoteAdvantage = 0;
+    FramesSinceWait = 0;
+    RemoteSendTicks = LastEchoedTicks = 0;
+    LastReceivedTicks = SDL_GetTicks();
+}
+
+// -----------------------------------------------------------------------------
+
+// the console gamepads must hold the actual states
+// from the previous frame when this is called
+void NetplaySession::RunFrame( int32_t Frame )
+{
+    // keep the state at the start of every frame
+    Snapshots[ Frame % (NETPLAY_MAX_ROLLBACK_FRAMES + 1) ]->Capture();
+    
+    // checksums are taken at the start of some frames
+    // (they are replaced if these frames are run again)
+    if( Frame > 0 && !(Frame % NETPLAY_CHECKSUM_INTERVAL) )
+    {
+        int Slot = (Frame / NETPLAY_CHECKSUM_INTERVAL) % 4;
+        LocalChecksumFrames[ Slot ] = Frame;
+        LocalChecksums[ Slot ] = GetConsoleChecksum( Console );
+    }
+    
+    // predict remote inputs that did not arrive yet
+    if( Frame > LastRemoteFrame )
+      RemoteInputs[ InputIndex( Frame ) ] = PredictInput( RemoteInputs[ InputIndex( LastRemoteFrame ) ] );
+    
+    // unused gamepads stay disconnected
+    GamepadState* RealTimeStates = Console.GamepadController.RealTimeGamepadStates;
+    
+    for( int Gamepad = 0; Gamepad < Constants::GamepadPorts; Gamepad++ )
+    {
+        uint32_t Input = 0;
+        
+        if( Gamepad == LocalPort )  Input = LocalInputs[ InputIndex( Frame ) ];
+        if( Gamepad == RemotePort ) Input = RemoteInputs[ InputIndex( Frame ) ];
+        
+        ApplyMovieInput( RealTimeStates[ Gamepad ], Input );
+    }
+    
+    Console.RunNextFrame();
+}
+
+// -----------------------------------------------------------------------------
+
+void NetplaySession::CheckChecksums()
+{
+    if( RemoteChecksumFrame <= LastComparedFrame )
+      return;
+    
+    // the remote checksum is final, but ours may not be yet
+    int Slot = (RemoteChecksumFrame / NETPLAY_CHECKSUM_INTERVAL) % 4;
+    
+    if( LocalChecksumFrames[ Slot ] != RemoteChecksumFrame || RemoteChecksumFrame - 1 > LastRemoteFrame )
+      return;
+    
+    if( FirstMispredictedFrame >= 0 && FirstMispredictedFrame < RemoteChecksumFrame )
+      return;
+    
+    LastComparedFrame = RemoteChecksumFrame;
+    
+    // only report the first desync, since after
+    // it all checksums are expected to fail
+    if( LocalChecksums[ Slot ] != RemoteChecksum && DesyncFrame < 0 )
+    {
+        DesyncFrame = RemoteChecksumFrame;
+        LOG( "Netplay: consoles are no longer synchronized (checksum at frame " + to_string( DesyncFrame ) + " is different)" );
+    }
+}
+
+// -----------------------------------------------------------------------------
+
+bool NetplaySession::RunNextFrame( bool SkipVideo, bool SkipAudio )
+{
+    if( State == NetplayStates::Disconnected )
+      return false;
+    
+    ReceivePackets();
+    
+    // guests keep asking until the host replies
+    if( State == NetplayStates::Connecting )
+    {
+        if( !IsHost )
+        {
+            NetplayPacket Packet;
+            InitializePacket( Packet, NetplayPacketTypes::Join );
+            Transport->Send( &Packet, offsetof( NetplayPacket, Inputs ) );
+        }
+        
+        return false;
+    }
+    
+    if( State != NetplayStates::Running )
+      return false;
+    
+    if( SDL_GetTicks() - LastReceivedTicks > NETPLAY_TIMEOUT_MS )
+    {
+        LOG( "Netplay: connection lost" );
+        State = NetplayStates::Disconnected;
+        return false;
+    }
+    
+    CheckChecksums();
+    
+    // we cannot get further from the remote player than
+    // we can roll back, or than the inputs we can resend
+    bool MustWait = (CurrentFrame > LastRemoteFrame + NETPLAY_MAX_ROLLBACK_FRAMES)
+                 || (CurrentFrame + InputDelay - RemoteAckFrame > NETPLAY_INPUTS_PER_PACKET);
+    
+    // both players see the other behind by the time datagrams
+    // take to arrive; beyond that, the one ahead has to wait
+    LocalAdvantage = 0.9 * LocalAdvantage + 0.1 * (CurrentFrame - RemoteFrame);
+    FramesSinceWait++;
+    
+    if( !MustWait && FramesSinceWait > NETPLAY_FRAMES_BETWEEN_WAITS && LocalAdvantage - RemoteAdvantage >= 2 )
+    {
+        MustWait = true;
+        FramesSinceWait = 0;
+    }
+    
+    if( MustWait )
+    {
+        SendInputs();
+        return false;
+    }
+    
+    // take the local input, and update times
+    // of the local gamepad for the next frame
+    GamepadState* RealTimeStates = Console.GamepadController.RealTimeGamepadStates;
+    LastLocalFrame = CurrentFrame + InputDelay;
+    LocalInputs[ InputIndex( LastLocalFrame ) ] = GetMovieInput( RealTimeStates[ 0 ] );
+    
+    LocalGamepad.RealTimeGamepadStates[ 0 ] = RealTimeStates[ 0 ];
+    LocalGamepad.ChangeFrame();
+    memcpy( RealTimeStates, SyncedGamepads, sizeof(SyncedGamepads) );
+    
+    // go back to the first wrong prediction and run all
+    // frames since then again, with no video or audio
+    if( FirstMispredictedFrame >= 0 )
+    {
+        StopWatch Watch;
+        int32_t Rollback = CurrentFrame - FirstMispredictedFrame;
+        
+        Snapshots[ FirstMispredictedFrame % (NETPLAY_MAX_ROLLBACK_FRAMES + 1) ]->Restore();
+        Console.SetOutputSkipping( true, true );
+        
+        for( int32_t Frame = FirstMispredictedFrame; Frame < CurrentFrame; Frame++ )
+          RunFrame( Frame );
+        
+        FirstMispredictedFrame = -1;
+        RolledBackFrames += Rollback;
+        MaximumRollback = max( MaximumRollback, Rollback );
+        RollbackTime += Watch.GetStepTime();
+    }
+    
+    Console.SetOutputSkipping( SkipVideo, SkipAudio );
+    RunFrame( CurrentFrame );
+    CurrentFrame++;
+    
+    memcpy( SyncedGamepads, RealTimeStates, sizeof(SyncedGamepads) );
+    RealTimeStates[ 0 ] = LocalGamepad.RealTimeGamepadStates[ 0 ];
+    
+    SendInputs();
+    return true;
+}
+
+
+// =============================================================================
+//      NETPLAY SESSION: STATUS
+// =============================================================================
+
+
+NetplayStates NetplaySession::GetState()
+{
+    return State;
+}
+
+// -----------------------------------------------------------------------------
+
+int32_t NetplaySession::GetCurrentFrame()
+{
+    return CurrentFrame;
+}
+
+// -----------------------------------------------------------------------------
+
+int32_t NetplaySession::GetDesyncFrame()
+{
+    return DesyncFrame;
+}
+
+// -----------------------------------------------------------------------------
+
+float NetplaySession::GetRoundTripTime()
+{
+    return RoundTripTime;
+}
+
+// -----------------------------------------------------------------------------
+
+int32_t NetplaySession::GetRolledBackFrames()
+{
+    return RolledBackFrames;
+}
+
+// -----------------------------------------------------------------------------
+
+int32_t NetplaySession::GetMaximumRollback()
+{
+    return MaximumRollback;
+}
+
+// -----------------------------------------------------------------------------
+
+double NetplaySession::GetRollbackTime()
+{
+    return RollbackTime;
+}
@@ -0,0 +1,235 @@
+// *****************************************************************************
+    // start include guard
+    #ifndef NETPLAYSESSION_HPP
+    #define NETPLAYSESSION_HPP
+    
+    // include console logic headers
+    #include "ConsoleLogic/V32Console.hpp"
+    
+    // include emulator headers
+    #include "NetplayTransport.hpp"
+    #include "Savestates.hpp"
+    
+    // include C/C++ headers
+    #include <memory>           // [ C++ STL ] Dynamic memory
+// *****************************************************************************
+
+
+// =============================================================================
+//      DEFINITIONS FOR NETPLAY
+// =============================================================================
+
+
+// In a netplay session 2 emulators run the same game, with
+// the host on gamepad port 1 and the guest on port 2 (each
+// player uses the first gamepad of their own emulator).
+// On each frame both send their local input to each other.
+// When the remote input for a frame has not arrived yet,
+// it is predicted to stay the same. If the prediction turns
+// out wrong, the console goes back to the state saved for
+// that frame and runs all frames since then again, without
+// any video or audio. Checksums are exchanged periodically
+// to detect if both consoles stopped running the same way
+
+// frames that can run ahead of the last remote input
+// (a state is kept for each of them, plus the current)
+#define NETPLAY_MAX_ROLLBACK_FRAMES     8
+
+// local inputs are applied this many frames later, so
+// that they can reach the remote player in time
+#define NETPLAY_DEFAULT_INPUT_DELAY     2
+#define NETPLAY_MAX_INPUT_DELAY         8
+
+// size of the circular buffers for inputs
+#define NETPLAY_INPUT_HISTORY           128
+
+// a datagram repeats all inputs the remote player
+// has not confirmed yet, up to this many of them
+#define NETPLAY_INPUTS_PER_PACKET       64
+
+// when ahead of the remote player, 1 frame is skipped
+// to let it catch up, but not more often than this
+#define NETPLAY_FRAMES_BETWEEN_WAITS    10
+
+// frames between checksums of the console state
+#define NETPLAY_CHECKSUM_INTERVAL       60
+
+// the session ends after this long without datagrams
+#define NETPLAY_TIMEOUT_MS              5000
+
+// -----------------------------------------------------------------------------
+
+enum class NetplayPacketTypes: int32_t
+{
+    Join = 1,       // guest asks to join the host's game
+    Start,          // host sends initial console state
+    Inputs          // both send inputs for each frame
+};
+
+// -----------------------------------------------------------------------------
+
+// both emulators are expected to use the same byte order
+typedef struct
+{
+    char Signature[ 8 ];        // no null termination! (always taken as 8 characters)
+    int32_t Type;
+    
+    // (Join, Start) the cartridge being played
+    char CartridgeTitle[ 64 ];
+    int32_t ProgramROMSize;
+    
+    // (Start) initial console state, and input
+    // delay, which has to be the same for both
+    int32_t InitialDate;
+    int32_t InitialTime;
+    int32_t InitialRandomSeed;
+    int32_t InputDelay;
+    
+    // (Inputs) frame the sender is running, and the
+    // last frame of the receiver's inputs it has
+    int32_t CurrentFrame;
+    int32_t LastReceivedFrame;
+    
+    // (Inputs) how many frames the sender sees itself
+    // ahead of the receiver, to keep both in time
+    int32_t FrameAdvantage;
+    
+    // (Inputs) timestamps to measure round trip times
+    Uint32 SendTicks;
+    Uint32 EchoedTicks;
+    
+    // (Inputs) latest confirmed checksum, taken
+    // at the start of the given frame
+    int32_t ChecksumFrame;
+    uint32_t Checksum;
+    
+    // (Inputs) consecutive inputs of the sender
+    int32_t FirstInputFrame;
+    int32_t NumberOfInputs;
+    uint32_t Inputs[ NETPLAY_INPUTS_PER_PACKET ];
+}
+NetplayPacket;
+
+
+// =============================================================================
+//      CLASS FOR NETPLAY SESSIONS
+// =============================================================================
+
+
+enum class NetplayStates
+{
+    Connecting,
+    Running,
+    Disconnected
+};
+
+// -----------------------------------------------------------------------------
+
+class NetplaySession
+{
+    private:
+        
+        V32::V32Console& Console;
+        std::unique_ptr< NetplayTransport > Transport;
+        NetplayStates State;
+        bool IsHost;
+        int32_t InputDelay;
+        Uint32 LastReceivedTicks;
+        
+        // console state when the session started
+        int32_t InitialDate;
+        int32_t InitialTime;
+        int32_t InitialRandomSeed;
+        
+        // console gamepad port for each player
+        int32_t LocalPort;
+        int32_t RemotePort;
+        
+        // next frame to run
+        int32_t CurrentFrame;
+        
+        // inputs for both players; remote inputs after
+        // the last one received are the predicted ones
+        uint32_t LocalInputs[ NETPLAY_INPUT_HISTORY ];
+        uint32_t RemoteInputs[ NETPLAY_INPUT_HISTORY ];
+        int32_t LastLocalFrame;
+        int32_t LastRemoteFrame;
+        int32_t RemoteAckFrame;
+        
+        // first frame that needs to be run again, or -1
+        int32_t FirstMispredictedFrame;
+        
+        // between frames, the console's first gamepad holds
+        // the local player's own gamepad so that the frontend
+        // applies events to it; the actual gamepads are kept
+        // here meanwhile (the local gamepad uses a controller
+        // of its own, only to have its times updated)
+        V32::GamepadState SyncedGamepads[ V32::Constants::GamepadPorts ];
+        V32::V32GamepadController LocalGamepad;
+        
+        // console states at the start of recent frames
+        std::unique_ptr< StateSnapshot > Snapshots[ NETPLAY_MAX_ROLLBACK_FRAMES + 1 ];
+        
+        // checksums for the last few intervals
+        int32_t LocalChecksumFrames[ 4 ];
+        uint32_t LocalChecksums[ 4 ];
+        int32_t RemoteChecksumFrame;
+        uint32_t RemoteChecksum;
+        int32_t LastComparedFrame;
+        int32_t DesyncFrame;
+        
+        // time synchronization
+        int32_t RemoteFrame;
+        float LocalAdvantage;
+        float RemoteAdvantage;
+        int32_t FramesSinceWait;
+        Uint32 RemoteSendTicks;
+        Uint32 LastEchoedTicks;
+        
+        // statistics
+        float RoundTripTime;
+        int32_t RolledBackFrames;
+        int32_t MaximumRollback;
+        double RollbackTime;
+        
+        // protocol
+        void InitializePacket( NetplayPacket& Packet, NetplayPacketTypes Type );
+        bool CheckCartridge( const NetplayPacket& Packet );
+        void SendStart();
+        void SendInputs();
+        void ReceivePackets();
+        void ProcessInputs( const NetplayPacket& Packet );
+        
+        // emulation
+        void ResetConsole();
+        void RunFrame( int32_t Frame );
+        void CheckChecksums();
+        
+    public:
+        
+        // instance handling (the session runs the given
+        // console, and takes ownership of the transport)
+        NetplaySession( V32::V32Console& TargetConsole, NetplayTransport* NewTransport, bool Host, int32_t Delay = NETPLAY_DEFAULT_INPUT_DELAY );
+        
+        // runs the next frame, rolling back first if
+        // needed; it returns false when the frame had
+        // to wait for the remote player (or to connect)
+        bool RunNextFrame( bool SkipVideo, bool SkipAudio );
+        
+        // status
+        NetplayStates GetState();
+        int32_t GetCurrentFrame();
+        int32_t GetDesyncFrame();
+        float GetRoundTripTime();
+        
+        // totals since the session started
+        int32_t GetRolledBackFrames();
+        int32_t GetMaximumRollback();
+        double GetRollbackTime();
+};
+
+
+// *****************************************************************************
+    // end include guard
+    #endif
+// *****************************************************************************
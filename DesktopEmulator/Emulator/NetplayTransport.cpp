@@ -0,0 +1,290 @@
+// *****************************************************************************
+    // include infrastructure headers
+    #include "DesktopInfrastructure/Logger.hpp"
+    
+    // include emulator headers
+    #include "NetplayTransport.hpp"
+    
+    // include C/C++ headers
+    #include <algorithm>        // [ C++ STL ] Algorithms
+    #include <cstring>          // [ ANSI C ] Strings
+    
+    // include socket headers for each system
+    #if defined(__WIN32__) || defined(_WIN32) || defined(_WIN64)
+      #define WINDOWS_OS
+      #include <winsock2.h>     // [ WINDOWS ] Sockets 2
+      #include <ws2tcpip.h>     // [ WINDOWS ] TCP/IP extensions
+    #else
+      #include <sys/socket.h>   // [ POSIX ] Sockets
+      #include <netinet/in.h>   // [ POSIX ] Internet addresses
+      #include <netdb.h>        // [ POSIX ] Host name resolution
+      #include <fcntl.h>        // [ POSIX ] File control
+      #include <unistd.h>       // [ POSIX ] Standard symbols
+    #endif
+    
+    // declare used namespaces
+    using namespace std;
+// *****************************************************************************
+
+
+// =============================================================================
+//      AUXILIARY SOCKET FUNCTIONS
+// =============================================================================
+
+
+#if defined(WINDOWS_OS)
+  const intptr_t NoSocket = (intptr_t)INVALID_SOCKET;
+#else
+  const intptr_t NoSocket = -1;
+#endif
+
+// -----------------------------------------------------------------------------
+
+// on Windows the sockets library needs to be started
+// once before using it; it is left open until exit
+void StartSockets()
+{
+    #if defined(WINDOWS_OS)
+      
+      static bool Started = false;
+      WSADATA SocketsData;
+      
+      if( !Started && WSAStartup( MAKEWORD( 2, 2 ), &SocketsData ) )
+        THROW( "Cannot initialize Windows sockets" );
+      
+      Started = true;
+    
+    #endif
+}
+
+// -----------------------------------------------------------------------------
+
+void CloseSocket( intptr_t Socket )
+{
+    #if defined(WINDOWS_OS)
+      closesocket( (SOCKET)Socket );
+    #else
+      close( (int)Socket );
+    #endif
+}
+
+// -----------------------------------------------------------------------------
+
+// sockets must not block, since the emulator
+// checks for datagrams once in every frame
+bool SetNonBlocking( intptr_t Socket )
+{
+    #if defined(WINDOWS_OS)
+      u_long NonBlocking = 1;
+      return !ioctlsocket( (SOCKET)Socket, FIONBIO, &NonBlocking );
+    #else
+      int Flags = fcntl( (int)Socket, F_GETFL, 0 );
+      return (Flags >= 0 && !fcntl( (int)Socket, F_SETFL, Flags | O_NONBLOCK ));
+    #endif
+}
+
+
+// =============================================================================
+//      UDP TRANSPORT: INSTANCE HANDLING
+// =============================================================================
+
+
+UDPTransport::UDPTransport( int LocalPort )
+{
+    RemoteIsKnown = false;
+    RemoteIP = 0;
+    RemotePort = 0;
+    OpenSocket( LocalPort );
+    
+    LOG( "Netplay: listening on UDP port " + to_string( LocalPort ) );
+}
+
+// -----------------------------------------------------------------------------
+
+UDPTransport::UDPTransport( const string& HostName, int HostPort )
+{
+    RemoteIsKnown = false;
+    RemoteIP = 0;
+    RemotePort = 0;
+    StartSockets();
+    
+    // find an IPv4 address for the host
+    addrinfo Hints;
+    memset( &Hints, 0, sizeof(Hints) );
+    Hints.ai_family = AF_INET;
+    Hints.ai_socktype = SOCK_DGRAM;
+    
+    addrinfo* Results = nullptr;
+    
+    if( getaddrinfo( HostName.c_str(), to_string( HostPort ).c_str(), &Hints, &Results ) || !Results )
+      THROW( "Cannot find netplay host \"" + HostName + "\"" );
+    
+    sockaddr_in* HostAddress = (sockaddr_in*)Results->ai_addr;
+    RemoteIP = HostAddress->sin_addr.s_addr;
+    RemotePort = HostAddress->sin_port;
+    RemoteIsKnown = true;
+    freeaddrinfo( Results );
+    
+    // port 0 lets the system choose any free one
+    OpenSocket( 0 );
+    
+    LOG( "Netplay: connecting to " + HostName + " on UDP port " + to_string( HostPort ) );
+}
+
+// -----------------------------------------------------------------------------
+
+UDPTransport::~UDPTransport()
+{
+    CloseSocket( Socket );
+}
+
+// -----------------------------------------------------------------------------
+
+void UDPTransport::OpenSocket( int LocalPort )
+{
+    StartSockets();
+    Socket = (intptr_t)socket( AF_INET, SOCK_DGRAM, IPPROTO_UDP );
+    
+    if( Socket == NoSocket )
+      THROW( "Cannot create a UDP socket for netplay" );
+    
+    sockaddr_in LocalAddress;
+    memset( &LocalAddress, 0, sizeof(LocalAddress) );
+    LocalAddress.sin_family = AF_INET;
+    LocalAddress.sin_addr.s_addr = htonl( INADDR_ANY );
+    LocalAddress.sin_port = htons( (uint16_t)LocalPort );
+    
+    if( bind( Socket, (sockaddr*)&LocalAddress, sizeof(LocalAddress) ) || !SetNonBlocking( Socket ) )
+    {
+        CloseSocket( Socket );
+        THROW( "Cannot use UDP port " + to_string( LocalPort ) + " for netplay" );
+    }
+}
+
+
+// =============================================================================
+//      UDP TRANSPORT: SENDING AND RECEIVING
+// =============================================================================
+
+
+void UDPTransport::Send( const void* Data, int Size )
+{
+    // a host cannot reply until it is reached
+    if( !RemoteIsKnown )
+      return;
+    
+    sockaddr_in Destination;
+    memset( &Destination, 0, sizeof(Destination) );
+    Destination.sin_family = AF_INET;
+    Destination.sin_addr.s_addr = RemoteIP;
+    Destination.sin_port = RemotePort;
+    
+    // errors are treated as lost datagrams
+    sendto( Socket, (const char*)Data, Size, 0, (sockaddr*)&Destination, sizeof(Destination) );
+}
+
+// -----------------------------------------------------------------------------
+
+int UDPTransport::Receive( void* Buffer, int BufferSize )
+{
+    while( true )
+    {
+        sockaddr_in Source;
+        socklen_t SourceSize = sizeof(Source);
+        int Received = recvfrom( Socket, (char*)Buffer, BufferSize, 0, (sockaddr*)&Source, &SourceSize );
+        
+        // there is nothing left to read
+        if( Received < 0 )
+          return 0;
+        
+        // a host takes the first sender as its guest
+        if( !RemoteIsKnown )
+        {
+            RemoteIP = Source.sin_addr.s_addr;
+            RemotePort = Source.sin_port;
+            RemoteIsKnown = true;
+        }
+        
+        // discard datagrams from anyone else
+        if( Source.sin_addr.s_addr == RemoteIP && Source.sin_port == RemotePort )
+          return Received;
+    }
+}
+
+
+// =============================================================================
+//      LOOPBACK TRANSPORT
+// =============================================================================
+
+
+LoopbackTransport::LoopbackTransport( int Latency, int Jitter, int Loss )
+{
+    Peer = nullptr;
+    LatencyMS = Latency;
+    JitterMS = Jitter;
+    LossPercentage = Loss;
+    
+    // fixed seed, so that tests can be repeated
+    RandomState = 1;
+}
+
+// -----------------------------------------------------------------------------
+
+LoopbackTransport::~LoopbackTransport()
+{
+    if( Peer )
+      Peer->Peer = nullptr;
+}
+
+// -----------------------------------------------------------------------------
+
+void LoopbackTransport::Connect( LoopbackTransport& Other )
+{
+    Peer = &Other;
+    Other.Peer = this;
+}
+
+// -----------------------------------------------------------------------------
+
+// simple linear congruential generator; it does not
+// need any quality, only to give the same sequence
+uint32_t LoopbackTransport::GetRandomNumber( uint32_t Limit )
+{
+    RandomState = RandomState * 1103515245u + 12345u;
+    return (RandomState >> 16) % Limit;
+}
+
+// -----------------------------------------------------------------------------
+
+void LoopbackTransport::Send( const void* Data, int Size )
+{
+    if( !Peer )
+      return;
+    
+    if( LossPercentage > 0 && (int)GetRandomNumber( 100 ) < LossPercentage )
+      return;
+    
+    Uint32 DeliveryTime = SDL_GetTicks() + LatencyMS;
+    
+    if( JitterMS > 0 )
+      DeliveryTime += GetRandomNumber( JitterMS + 1 );
+    
+    const uint8_t* Bytes = (const uint8_t*)Data;
+    Peer->Incoming.insert( make_pair( DeliveryTime, vector< uint8_t >( Bytes, Bytes + Size ) ) );
+}
+
+// -----------------------------------------------------------------------------
+
+int LoopbackTransport::Receive( void* Buffer, int BufferSize )
+{
+    if( Incoming.empty() || Incoming.begin()->first > SDL_GetTicks() )
+      return 0;
+    
+    // like UDP, datagrams too large get truncated
+    vector< uint8_t >& Datagram = Incoming.begin()->second;
+    int Received = min( BufferSize, (int)Datagram.size() );
+    memcpy( Buffer, Datagram.data(), Received );
+    
+    Incoming.erase( Incoming.begin() );
+    return Received;
+}
@@ -0,0 +1,120 @@
+// *****************************************************************************
+    // start include guard
+    #ifndef NETPLAYTRANSPORT_HPP
+    #define NETPLAYTRANSPORT_HPP
+    
+    // include SDL2 headers
+    #define SDL_MAIN_HANDLED
+    #include "SDL.h"            // [ SDL2 ] Main header
+    
+    // include C/C++ headers
+    #include <string>           // [ C++ STL ] Strings
+    #include <vector>           // [ C++ STL ] Vectors
+    #include <map>              // [ C++ STL ] Maps
+    #include <cstdint>          // [ ANSI C ] Standard integer types
+// *****************************************************************************
+
+
+// =============================================================================
+//      BASE CLASS FOR NETPLAY TRANSPORTS
+// =============================================================================
+
+
+// A transport moves datagrams between the 2 emulators in a
+// netplay session. Like UDP, it does not guarantee delivery
+// or order: the session itself takes care of resending and
+// ignoring what it does not need. Neither function can block
+class NetplayTransport
+{
+    public:
+        
+        virtual ~NetplayTransport() {}
+        
+        virtual void Send( const void* Data, int Size ) = 0;
+        
+        // returns the received size, or 0 if nothing is pending
+        virtual int Receive( void* Buffer, int BufferSize ) = 0;
+};
+
+
+// =============================================================================
+//      UDP TRANSPORT
+// =============================================================================
+
+
+class UDPTransport: public NetplayTransport
+{
+    private:
+        
+        // (on Windows sockets are not file descriptors
+        // but handles, so this can hold either of them)
+        intptr_t Socket;
+        
+        // a host only knows its remote address
+        // after it receives the first datagram
+        // (IPv4 address and port, in network order)
+        bool RemoteIsKnown;
+        uint32_t RemoteIP;
+        uint16_t RemotePort;
+        
+        void OpenSocket( int LocalPort );
+        
+    public:
+        
+        // hosts listen on a given port, while guests
+        // use any free port to reach their host
+        UDPTransport( int LocalPort );
+        UDPTransport( const std::string& HostName, int HostPort );
+       ~UDPTransport();
+        
+        virtual void Send( const void* Data, int Size );
+        virtual int Receive( void* Buffer, int BufferSize );
+};
+
+
+// =============================================================================
+//      LOOPBACK TRANSPORT
+// =============================================================================
+
+
+// Connects 2 sessions within the same program, so that
+// netplay can be tested without a network. To simulate
+// real connections, datagrams can be delayed by a time
+// with random variations (so they can arrive in a
+// different order), and a percentage of them is lost
+class LoopbackTransport: public NetplayTransport
+{
+    private:
+        
+        LoopbackTransport* Peer;
+        
+        // datagrams sent to us, by delivery time
+        std::multimap< Uint32, std::vector< uint8_t > > Incoming;
+        
+        // simulated network conditions
+        int LatencyMS;
+        int JitterMS;
+        int LossPercentage;
+        uint32_t RandomState;
+        
+        uint32_t GetRandomNumber( uint32_t Limit );
+        
+    public:
+        
+        // instance handling (times are in milliseconds,
+        // and loss is the percentage of datagrams lost)
+        LoopbackTransport( int Latency = 0, int Jitter = 0, int Loss = 0 );
+       ~LoopbackTransport();
+        
+        // both endpoints get connected to each other
+        void Connect( LoopbackTransport& Other );
+        
+        virtual void Send( const void* Data, int Size );
+        virtual int Receive( void* Buffer, int BufferSize );
+};
+
+
+// *****************************************************************************
+    // end include guard
+    #endif
+// *****************************************************************************
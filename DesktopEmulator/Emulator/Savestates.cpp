@@ -5,11 +5,12 @@
     // include emulator headers
     #include "Savestates.hpp"
     #include "VideoOutput.hpp"
-    #include "Globals.hpp"
     
     // include C/C++ headers
     #include <memory>             // [ C++ STL ] Dynamic memory
+    #include <vector>             // [ C++ STL ] Vectors
     #include <string.h>           // [ ANSI C ] Strings
+    #include <stddef.h>           // [ ANSI C ] Standard definitions
     
     // declare used namespaces
     using namespace std;
@@ -22,7 +23,7 @@
 // =============================================================================
 
 
-void SaveCPUState( CPUState& State )
+void SaveCPUState( V32Console& Console, CPUState& State )
 {
     // all fields should be adjacent in memory
     // so read registers and flags together
@@ -31,24 +32,30 @@ void SaveCPUState( CPUState& State )
 
 // -----------------------------------------------------------------------------
 
-void SaveGPUState( GPUState& State )
+void SaveGPUState( V32Console& Console, GPUState& State, vector< GPURegionPageState >& RegionPages )
 {
     V32GPU& GPU = Console.GPU;
     
     // read all registers as adjacent
     memcpy( State.Registers, &GPU.Command, sizeof(State.Registers) );
     
-    // copy the BIOS texture
-    memcpy( &State.BiosTexture, &GPU.BiosTexture, sizeof(GPUTexture) );
+    // copy only the written region pages
+    State.NumberOfRegionPages = GPU.WrittenPages.size();
+    RegionPages.resize( GPU.WrittenPages.size() );
     
-    // copy only the needed cartridge textures
-    unsigned TexturesSize = sizeof(GPUTexture) * GPU.LoadedCartridgeTextures;
-    memcpy( State.CartridgeTextures, &GPU.CartridgeTextures[ 0 ], TexturesSize );
+    for( unsigned i = 0; i < GPU.WrittenPages.size(); i++ )
+    {
+        GPUWrittenPage& Written = GPU.WrittenPages[ i ];
+        GPURegionPageState& PageState = RegionPages[ i ];
+        
+        PageState.Position = Written;
+        memcpy( &PageState.Contents, GPU.GetTexture( Written.TextureID ).Pages[ Written.PageIndex ], sizeof(GPURegionPage) );
+    }
 }
 
 // -----------------------------------------------------------------------------
 
-void SaveSPUState( SPUState& State )
+void SaveSPUState( V32Console& Console, SPUState& State )
 {
     V32SPU& SPU = Console.SPU;
     
@@ -73,7 +80,7 @@ void SaveSPUState( SPUState& State )
 
 // -----------------------------------------------------------------------------
 
-void SaveGamepadControllerState( GamepadControllerState& State )
+void SaveGamepadControllerState( V32Console& Console, GamepadControllerState& State )
 {
     State.SelectedGamepad = Console.GamepadController.SelectedGamepad;
     
@@ -83,7 +90,7 @@ void SaveGamepadControllerState( GamepadControllerState& State )
 
 // -----------------------------------------------------------------------------
 
-void SaveOtherConsoleState( OtherConsoleState& State )
+void SaveOtherConsoleState( V32Console& Console, OtherConsoleState& State )
 {
     // save state for minor chips
     memcpy( State.TimerRegisters, &Console.Timer.CurrentDate, sizeof(State.TimerRegisters) );
@@ -95,7 +102,7 @@ void SaveOtherConsoleState( OtherConsoleState& State )
 
 // -----------------------------------------------------------------------------
 
-void SaveGameInfo( ROMInfo& Info )
+void SaveGameInfo( V32Console& Console, ROMInfo& Info )
 {
     // ensure title does not exceed 64 bytes and
     // that its unused characters are all null
@@ -111,7 +118,7 @@ void SaveGameInfo( ROMInfo& Info )
 
 // -----------------------------------------------------------------------------
 
-void SaveBiosInfo( ROMInfo& Info )
+void SaveBiosInfo( V32Console& Console, ROMInfo& Info )
 {
     // ensure title does not exceed 64 bytes and
     // that its unused characters are all null
@@ -127,18 +134,18 @@ void SaveBiosInfo( ROMInfo& Info )
 
 // -----------------------------------------------------------------------------
 
-void SaveState( ConsoleState* State )
+void SaveState( V32Console& Console, ConsoleState* State, vector< GPURegionPageState >& RegionPages )
 {
     // save info to identify the game and BIOS
-    SaveGameInfo( State->Game );
-    SaveBiosInfo( State->Bios );
+    SaveGameInfo( Console, State->Game );
+    SaveBiosInfo( Console, State->Bios );
     
     // save console state
-    SaveCPUState( State->CPU );
-    SaveGPUState( State->GPU );
-    SaveSPUState( State->SPU );
-    SaveGamepadControllerState( State->GamepadController );
-    SaveOtherConsoleState( State->Others );
+    SaveCPUState( Console, State->CPU );
+    SaveGPUState( Console, State->GPU, RegionPages );
+    SaveSPUState( Console, State->SPU );
+    SaveGamepadControllerState( Console, State->GamepadController );
+    SaveOtherConsoleState( Console, State->Others );
 }
 
 
@@ -147,7 +154,7 @@ void SaveState( ConsoleState* State )
 // =============================================================================
 
 
-void LoadCPUState( const CPUState& State )
+void LoadCPUState( V32Console& Console, const CPUState& State )
 {
     // all fields should be adjacent in memory
     // so write registers and flags together
@@ -156,47 +163,41 @@ void LoadCPUState( const CPUState& State )
 
 // -----------------------------------------------------------------------------
 
-void LoadGPUState( const GPUState& State )
+void LoadGPUState( V32Console& Console, const GPUState& State, const vector< GPURegionPageState >& RegionPages )
 {
     V32GPU& GPU = Console.GPU;
     
     // write all registers as adjacent
     memcpy( &GPU.Command, State.Registers, sizeof(State.Registers) );
     
-    // copy the BIOS texture
-    memcpy( &GPU.BiosTexture, &State.BiosTexture, sizeof(GPUTexture) );
-    
-    // copy only the needed cartridge textures
-    unsigned TexturesSize = sizeof(GPUTexture) * GPU.LoadedCartridgeTextures;
-    memcpy( &GPU.CartridgeTextures[ 0 ], State.CartridgeTextures, TexturesSize );
+    // selected texture may not exist for this game
+    if( GPU.SelectedTexture < -1 || GPU.SelectedTexture >= (int32_t)GPU.LoadedCartridgeTextures )
+      THROW( "Savestate has a non-existent texture selected" );
     
     // update GPU pointers for the loaded selections
-    if( GPU.SelectedTexture == -1 )
-      GPU.PointedTexture = &GPU.BiosTexture;
-    else
-      GPU.PointedTexture = &GPU.CartridgeTextures[ GPU.SelectedTexture ];
+    GPU.PointedTexture = &GPU.GetTexture( GPU.SelectedTexture );
     
-    GPU.PointedRegion = &GPU.PointedTexture->Regions[ GPU.SelectedRegion ];
+    // all regions not in the saved pages are zero
+    GPU.ReleaseWrittenPages( false );
     
-    // reset any previous OpenGL errors
-    while( glGetError() != GL_NO_ERROR )
+    for( const GPURegionPageState& PageState: RegionPages )
     {
-        // (empty block instead of ";" to avoid warnings)
+        GPURegionPage* Page = GPU.GetWritablePage( PageState.Position.TextureID, PageState.Position.PageIndex );
+        memcpy( Page, &PageState.Contents, sizeof(GPURegionPage) );
     }
     
-    // make the needed updates in video output
-    Video.SelectTexture( GPU.SelectedTexture );
-    Video.SetMultiplyColor( GPU.MultiplyColor );
-    Video.SetBlendingMode( (IOPortValues)GPU.ActiveBlending );
+    GPU.PointedRegion = GPU.PointedTexture->GetRegion( GPU.SelectedRegion );
     
-    // check for success
-    if( glGetError() != GL_NO_ERROR )
-      THROW( "There was an OpenGL error" );
+    // make the needed updates in video output
+    // (through the frontend, so that GPU traces see them)
+    Console.Frontend->SelectTexture( GPU.SelectedTexture );
+    Console.Frontend->SetMultiplyColor( GPU.MultiplyColor );
+    Console.Frontend->SetBlendingMode( GPU.ActiveBlending );
 }
 
 // -----------------------------------------------------------------------------
 
-void LoadSPUState( const SPUState& State )
+void LoadSPUState( V32Console& Console, const SPUState& State )
 {
     V32SPU& SPU = Console.SPU;
     
@@ -238,7 +239,7 @@ void LoadSPUState( const SPUState& State )
 
 // -----------------------------------------------------------------------------
 
-void LoadGamepadControllerState( const GamepadControllerState& State )
+void LoadGamepadControllerState( V32Console& Console, const GamepadControllerState& State )
 {
     // write the single exposed register
     Console.GamepadController.SelectedGamepad = State.SelectedGamepad;
@@ -249,7 +250,7 @@ void LoadGamepadControllerState( const GamepadControllerState& State )
 
 // -----------------------------------------------------------------------------
 
-void LoadOtherConsoleState( const OtherConsoleState& State )
+void LoadOtherConsoleState( V32Console& Console, const OtherConsoleState& State )
 {
     // load state for minor chips
     memcpy( &Console.Timer.CurrentDate, State.TimerRegisters, sizeof(State.TimerRegisters) );
@@ -257,17 +258,18 @@ void LoadOtherConsoleState( const OtherConsoleState& State )
     
     // load the full RAM
     memcpy( &Console.RAM.Memory[ 0 ], State.RAM, sizeof(State.RAM) );
+    Console.RAM.MarkAllPagesModified();
 }
 
 // -----------------------------------------------------------------------------
 
-void LoadState( const ConsoleState* State )
+void LoadState( V32Console& Console, const ConsoleState* State, const vector< GPURegionPageState >& RegionPages )
 {
     // try to identify the game and BIOS and see if they
     // match current ones, to avoid loading incompatible states
     ROMInfo CurrentGame, CurrentBios;
-    SaveGameInfo( CurrentGame );
-    SaveBiosInfo( CurrentBios );
+    SaveGameInfo( Console, CurrentGame );
+    SaveBiosInfo( Console, CurrentBios );
     
     if( memcmp( &State->Game, &CurrentGame, sizeof(ROMInfo) ) )
       THROW( "Current cartridge is not the same one that was saved" );
@@ -275,45 +277,149 @@ void LoadState( const ConsoleState* State )
     if( memcmp( &State->Bios, &CurrentBios, sizeof(ROMInfo) ) )
       THROW( "Current BIOS is not the same one that was used when saving" );
     
+    // only pages for existing textures can be loaded
+    if( State->GPU.NumberOfRegionPages != (int32_t)RegionPages.size() )
+      THROW( "Savestate has an incorrect number of region pages" );
+    
+    for( const GPURegionPageState& PageState: RegionPages )
+    {
+        const GPUWrittenPage& Position = PageState.Position;
+        
+        if( Position.TextureID < -1 || Position.TextureID >= (int32_t)Console.GPU.LoadedCartridgeTextures )
+          THROW( "Savestate contains regions for a non-existent texture" );
+        
+        if( Position.PageIndex < 0 || Position.PageIndex >= GPURegionPagesPerTexture )
+          THROW( "Savestate contains an incorrect region page" );
+    }
+    
     // load console state
-    LoadCPUState( State->CPU );
-    LoadSPUState( State->SPU );
-    LoadGPUState( State->GPU );
-    LoadGamepadControllerState( State->GamepadController );
-    LoadOtherConsoleState( State->Others );
+    LoadCPUState( Console, State->CPU );
+    LoadSPUState( Console, State->SPU );
+    LoadGPUState( Console, State->GPU, RegionPages );
+    LoadGamepadControllerState( Console, State->GamepadController );
+    LoadOtherConsoleState( Console, State->Others );
 }
 
 
 // =============================================================================
-//      RLE BUFFER COMPRESSION
-// -----------------------------------------------------------------------------
-//      The full size of a Vircon32 savestate is 16+ MB, however most of the
-//      RAM will typically be zeroes so we will store savestates on disk
-//      using a very simple RLE compression that should reduce size a lot
+//      FAST CAPTURE AND RESTORE IN MEMORY
 // =============================================================================
 
 
-unsigned GetSavestateSize()
+// copies RAM pages that were modified since the last copy
+// for the given buffer; after that, RAM and the buffer are
+// equal again (and when RAM was the destination, it is
+// now modified as seen by all other capture buffers)
+void CopyModifiedRAMPages( V32RAM& RAM, V32Word* Destination, const V32Word* Source, int32_t BufferIndex, bool ToRAM )
 {
-    // savestates may be a different size for each
-    // game, that is fine by libretro as long as
-    // that size is always the same for each game
-    unsigned UnusedCartridgeTextures = V32::Constants::GPUMaximumCartridgeTextures;
+    vector< uint32_t >& ModifiedPages = RAM.ModifiedPages;
+    uint32_t BufferBit = 1u << BufferIndex;
+    
+    for( unsigned Page = 0; Page < ModifiedPages.size(); Page++ )
+      if( ModifiedPages[ Page ] & BufferBit )
+      {
+          unsigned Offset = Page * RAMPageSize;
+          memcpy( Destination + Offset, Source + Offset, RAMPageSize * 4 );
+          
+          if( ToRAM ) ModifiedPages[ Page ] = ~BufferBit;
+          else ModifiedPages[ Page ] &= ~BufferBit;
+      }
+}
+
+
+// =============================================================================
+//      CLASS: STATE SNAPSHOT
+// =============================================================================
+
+
+StateSnapshot::StateSnapshot( V32Console& TargetConsole )
+:   Console( TargetConsole )
+{
+    BufferIndex = -1;
+}
+
+// -----------------------------------------------------------------------------
+
+StateSnapshot::~StateSnapshot()
+{
+    if( BufferIndex >= 0 )
+      Console.RAM.UsedCaptureBuffers &= ~(1u << BufferIndex);
+}
+
+// -----------------------------------------------------------------------------
+
+void StateSnapshot::Capture()
+{
+    // on first use, take a free buffer and
+    // make sure that all RAM gets copied
+    if( !State )
+    {
+        for( int32_t i = 0; i < RAMCaptureBuffers && BufferIndex < 0; i++ )
+          if( !(Console.RAM.UsedCaptureBuffers & (1u << i)) )
+            BufferIndex = i;
+        
+        if( BufferIndex < 0 )
+          THROW( "There are too many state snapshots in use" );
+        
+        Console.RAM.UsedCaptureBuffers |= (1u << BufferIndex);
+        State.reset( new ConsoleState );
+        
+        for( uint32_t& PageMask: Console.RAM.ModifiedPages )
+          PageMask |= (1u << BufferIndex);
+    }
     
-    if( Console.HasCartridge() )
-      UnusedCartridgeTextures -= Console.GPU.LoadedCartridgeTextures;
+    // these are small, so they are always copied
+    SaveCPUState( Console, State->CPU );
+    SaveGPUState( Console, State->GPU, RegionPages );
+    SaveSPUState( Console, State->SPU );
+    SaveGamepadControllerState( Console, State->GamepadController );
     
-    return sizeof( ConsoleState ) - UnusedCartridgeTextures * sizeof( V32::GPUTexture );
+    memcpy( State->Others.TimerRegisters, &Console.Timer.CurrentDate, sizeof(State->Others.TimerRegisters) );
+    State->Others.RNGCurrentValue = Console.RNG.CurrentValue;
+    
+    // RAM is by far the largest part
+    CopyModifiedRAMPages( Console.RAM, State->Others.RAM, &Console.RAM.Memory[ 0 ], BufferIndex, false );
 }
 
 // -----------------------------------------------------------------------------
 
-void SaveBufferToRLEFile( ofstream& OutputFile, const void* Buffer )
+void StateSnapshot::Restore()
+{
+    if( !State )
+      THROW( "Cannot restore a state snapshot that was never captured" );
+    
+    LoadCPUState( Console, State->CPU );
+    LoadSPUState( Console, State->SPU );
+    LoadGPUState( Console, State->GPU, RegionPages );
+    LoadGamepadControllerState( Console, State->GamepadController );
+    
+    memcpy( &Console.Timer.CurrentDate, State->Others.TimerRegisters, sizeof(State->Others.TimerRegisters) );
+    Console.RNG.CurrentValue = State->Others.RNGCurrentValue;
+    
+    CopyModifiedRAMPages( Console.RAM, &Console.RAM.Memory[ 0 ], State->Others.RAM, BufferIndex, true );
+}
+
+// -----------------------------------------------------------------------------
+
+bool StateSnapshot::IsEmpty()
+{
+    return !State;
+}
+
+
+// =============================================================================
+//      RLE BUFFER COMPRESSION
+// -----------------------------------------------------------------------------
+//      The full size of a Vircon32 savestate is 16+ MB, however most of the
+//      RAM will typically be zeroes so we will store savestates on disk
+//      using a very simple RLE compression that should reduce size a lot
+// =============================================================================
+
+
+void SaveBufferToRLEFile( ofstream& OutputFile, const void* Buffer, unsigned SavestateSize )
 {
     LOG( "Compressing state file" );
     
-    // determine buffer size
-    unsigned SavestateSize = GetSavestateSize();
     unsigned CompressedSize = 0;
     unsigned SavedSize = 0;
     
@@ -357,12 +463,11 @@ void SaveBufferToRLEFile( ofstream& OutputFile, const void* Buffer )
 
 // -----------------------------------------------------------------------------
 
-void LoadBufferFromRLEFile( ifstream& InputFile, void* Buffer )
+void LoadBufferFromRLEFile( ifstream& InputFile, vector< uint8_t >& Buffer, unsigned MaximumSize )
 {
     LOG( "Decompressing state file" );
     
-    unsigned DecompressedSize = 0;
-    uint8_t* CurrentByteSaved = (uint8_t*)Buffer;
+    Buffer.clear();
     uint8_t QuantityByte;
     uint8_t CurrentValue;
     
@@ -377,23 +482,12 @@ void LoadBufferFromRLEFile( ifstream& InputFile, void* Buffer )
         InputFile.read( (char*)&CurrentValue, 1 );
         
         // write the string of values to the buffer
-        memset( CurrentByteSaved, CurrentValue, QuantityByte );
-        
-        CurrentByteSaved += QuantityByte;
-        DecompressedSize += QuantityByte;
+        Buffer.insert( Buffer.end(), QuantityByte, CurrentValue );
         
         // we should never exceed the maximum savestate size
-        // (or else we will write into unknown memory areas)
-        if( DecompressedSize >= sizeof(ConsoleState) )
+        if( Buffer.size() > MaximumSize )
           THROW( "Decompressed file size is too large" );
     }
-    
-    // determine the actual savestate size for this game
-    unsigned SavestateSize = GetSavestateSize();
-    
-    // verify final buffer size
-    if( DecompressedSize != SavestateSize )
-      THROW( "Decompressed file size is not correct" );
 }
 
 
@@ -402,13 +496,27 @@ void LoadBufferFromRLEFile( ifstream& InputFile, void* Buffer )
 // =============================================================================
 
 
-void SaveState( const string& FileName )
+// files store the written region pages right after the
+// state, and then the padding found at the end of it
+// (as when pages were the last field of the state)
+const unsigned StoredConsoleStateSize = offsetof( ConsoleState, GPU ) + sizeof( GPUState );
+
+// -----------------------------------------------------------------------------
+
+void SaveState( V32Console& Console, const string& FileName )
 {
-    LOG( "Saving state in slot " + to_string(SavestatesSlot) );
+    // save the state from console
+    unique_ptr< ConsoleState > State( new ConsoleState );
+    vector< GPURegionPageState > RegionPages;
+    SaveState( Console, State.get(), RegionPages );
     
-    // save the state from console into the buffer
-    unique_ptr< ConsoleState > StateBuffer( new ConsoleState );
-    SaveState( StateBuffer.get() );
+    // join the state and region pages in a buffer
+    unsigned RegionPagesSize = RegionPages.size() * sizeof( GPURegionPageState );
+    vector< uint8_t > StateBuffer( sizeof( ConsoleState ) + RegionPagesSize );
+    memcpy( &StateBuffer[ 0 ], State.get(), StoredConsoleStateSize );
+    
+    if( RegionPagesSize > 0 )
+      memcpy( &StateBuffer[ StoredConsoleStateSize ], &RegionPages[ 0 ], RegionPagesSize );
     
     // open the file
     ofstream OutputFile;
@@ -418,16 +526,14 @@ void SaveState( const string& FileName )
       THROW( "Cannot open output file" );
     
     // save and compress the console state into that file
-    SaveBufferToRLEFile( OutputFile, StateBuffer.get() );
+    SaveBufferToRLEFile( OutputFile, &StateBuffer[ 0 ], StateBuffer.size() );
     OutputFile.close();
 }
 
 // -----------------------------------------------------------------------------
 
-void LoadState( const string& FileName )
+void LoadState( V32Console& Console, const string& FileName )
 {
-    LOG( "Loading state from slot " + to_string(SavestatesSlot) );
-    
     // open the file
     ifstream InputFile;
     OpenInputFile( InputFile, FileName, ios_base::in | ios_base::binary );
@@ -436,10 +542,45 @@ void LoadState( const string& FileName )
       THROW( "Cannot open input file" );
     
     // load and decompressed the console state from that file
-    unique_ptr< ConsoleState > StateBuffer( new ConsoleState );
-    LoadBufferFromRLEFile( InputFile, StateBuffer.get() );
+    vector< uint8_t > StateBuffer;
+    unsigned MaximumSize = sizeof( ConsoleState ) + MaximumGPURegionPages * sizeof( GPURegionPageState );
+    LoadBufferFromRLEFile( InputFile, StateBuffer, MaximumSize );
     InputFile.close();
     
+    // the number of region pages must have been read
+    // before the actual savestate size can be known
+    if( StateBuffer.size() < StoredConsoleStateSize )
+      THROW( "Decompressed file size is not correct" );
+    
+    unique_ptr< ConsoleState > State( new ConsoleState );
+    memcpy( State.get(), &StateBuffer[ 0 ], StoredConsoleStateSize );
+    
+    if( State->GPU.NumberOfRegionPages < 0 || State->GPU.NumberOfRegionPages > MaximumGPURegionPages )
+      THROW( "Decompressed file has an incorrect number of region pages" );
+    
+    // verify final buffer size
+    unsigned RegionPagesSize = State->GPU.NumberOfRegionPages * sizeof( GPURegionPageState );
+    
+    if( StateBuffer.size() != sizeof( ConsoleState ) + RegionPagesSize )
+      THROW( "Decompressed file size is not correct" );
+    
+    vector< GPURegionPageState > RegionPages( State->GPU.NumberOfRegionPages );
+    
+    if( RegionPagesSize > 0 )
+      memcpy( &RegionPages[ 0 ], &StateBuffer[ StoredConsoleStateSize ], RegionPagesSize );
+    
+    // reset any previous OpenGL errors
+    while( glGetError() != GL_NO_ERROR )
+    {
+        // (empty block instead of ";" to avoid warnings)
+    }
+    
     // load the state from the buffer into the console
-    LoadState( StateBuffer.get() );
+    LoadState( Console, State.get(), RegionPages );
+    
+    // check for success in video output (snapshots
+    // skip this: they are restored on every frame,
+    // and may be used by consoles without video)
+    if( glGetError() != GL_NO_ERROR )
+      THROW( "There was an OpenGL error" );
 }
@@ -12,6 +12,8 @@
     
     // include C/C++ headers
     #include <string>         // [ C++ STL ] Strings
+    #include <vector>         // [ C++ STL ] Vectors
+    #include <memory>         // [ C++ STL ] Dynamic memory
 // *****************************************************************************
 
 
@@ -34,6 +36,23 @@ CPUState;
 
 // -----------------------------------------------------------------------------
 
+// the most region pages that can be written,
+// counting the BIOS texture and all cartridge textures
+const int32_t MaximumGPURegionPages = (1 + V32::Constants::GPUMaximumCartridgeTextures) * V32::GPURegionPagesPerTexture;
+
+// -----------------------------------------------------------------------------
+
+typedef struct
+{
+    // texture ID is -1 for the BIOS texture
+    // (note that this ties each savestate to a particular BIOS)
+    V32::GPUWrittenPage Position;
+    V32::GPURegionPage Contents;
+}
+GPURegionPageState;
+
+// -----------------------------------------------------------------------------
+
 typedef struct
 {
     // all exposed GPU registers that are not
@@ -41,12 +60,11 @@ typedef struct
     // (12 words in total)
     V32::V32Word Registers[ 12 ];
     
-    // configuration for the BIOS texture
-    // (note that this ties each savestate to a particular BIOS)
-    V32::GPUTexture BiosTexture;
-    
-    // configuration for cartridge textures
-    V32::GPUTexture CartridgeTextures[ V32::Constants::GPUMaximumCartridgeTextures ];
+    // only region pages that were written are saved,
+    // since all others contain zeroes; their number
+    // varies, so they are kept apart from this state
+    // (in files they are stored right after it)
+    int32_t NumberOfRegionPages;
 }
 GPUState;
 
@@ -149,9 +167,8 @@ typedef struct
     ROMInfo Bios;
     
     // data for all stateful console components;
-    // make GPU last so that we can adjust size
-    // using a texture array (the last field)
-    // only as large as needed for each game
+    // make GPU last, since files store its region
+    // pages right after it (as a variable array)
     OtherConsoleState Others;
     GamepadControllerState GamepadController;
     CPUState CPU;
@@ -166,13 +183,51 @@ ConsoleState;
 // =============================================================================
 
 
-// load/save to a memory buffer
-void SaveState( ConsoleState* State );
-void LoadState( const ConsoleState* State );
+// load/save to memory, with written region pages separately
+void SaveState( V32::V32Console& Console, ConsoleState* State, std::vector< GPURegionPageState >& RegionPages );
+void LoadState( V32::V32Console& Console, const ConsoleState* State, const std::vector< GPURegionPageState >& RegionPages );
 
 // load/save to a file
-void SaveState( const std::string& FileName );
-void LoadState( const std::string& FileName );
+void SaveState( V32::V32Console& Console, const std::string& FileName );
+void LoadState( V32::V32Console& Console, const std::string& FileName );
+
+
+// =============================================================================
+//      CLASS FOR FAST CAPTURE AND RESTORE IN MEMORY
+// =============================================================================
+
+
+// A snapshot keeps a console state in memory to restore it
+// later. After its first capture, each capture or restore
+// only copies the RAM pages written since the last copy of
+// this same snapshot, so up to 32 snapshots can be in use
+// at the same time (for each console). These do not check
+// the game and BIOS
+class StateSnapshot
+{
+    private:
+        
+        V32::V32Console& Console;
+        
+        // created on first capture
+        std::unique_ptr< ConsoleState > State;
+        std::vector< GPURegionPageState > RegionPages;
+        
+        // capture buffer used in RAM modified
+        // pages, or -1 when not assigned yet
+        int32_t BufferIndex;
+        
+    public:
+        
+        // instance handling
+        StateSnapshot( V32::V32Console& TargetConsole );
+       ~StateSnapshot();
+        
+        // copies between the console and the snapshot
+        void Capture();
+        void Restore();
+        bool IsEmpty();
+};
 
 
 // *****************************************************************************
@@ -76,6 +76,11 @@ void Texture::Load( const string& FileName )
     ImageWidth  = LoadedImage->w;
     ImageHeight = LoadedImage->h;
     
+    // images are drawn as Vircon textures, so they
+    // cannot be larger than those (see Draw)
+    if( ImageWidth > (unsigned)Constants::GPUTextureSize || ImageHeight > (unsigned)Constants::GPUTextureSize )
+      THROW( "Images cannot be larger than " + to_string( Constants::GPUTextureSize ) + "x" + to_string( Constants::GPUTextureSize ) );
+    
     // read image dimensions
     TextureWidth  = NextPowerOf2( ImageWidth  );
     TextureHeight = NextPowerOf2( ImageHeight );
@@ -177,9 +182,6 @@ void Texture::Draw( int HotSpotPositionX, int HotSpotPositionY ) const
     if( !TextureID )
       return;
     
-    // select current texture
-    glBindTexture( GL_TEXTURE_2D, TextureID );
-    
     // precalculate limit coordinates
     float RenderXMin = HotSpotPositionX - HotSpotX;
     float RenderYMin = HotSpotPositionY - HotSpotY;
@@ -203,12 +205,21 @@ void Texture::Draw( int RenderXMin, int RenderYMin, int RenderXMax, int RenderYM
     // applying any new render configurations
     Video.RenderQuadQueue();
     
-    // select current texture
-    glBindTexture( GL_TEXTURE_2D, TextureID );
+    // select current texture; the shader expects the
+    // same location info as for Vircon textures
+    TextureLocation Location =
+    {
+        TextureID, false,
+        0, 0, (int)ImageWidth, (int)ImageHeight,
+        (int)TextureWidth, (int)TextureHeight
+    };
+    
+    Video.BindTexture( Location );
     
-    // calculate proportions of the image within the texture
-    float XFactor = (float)ImageWidth/TextureWidth;
-    float YFactor = (float)ImageHeight/TextureHeight;
+    // texture coordinates are relative to a
+    // full Vircon texture, not to our own size
+    float XFactor = (float)ImageWidth / Constants::GPUTextureSize;
+    float YFactor = (float)ImageHeight / Constants::GPUTextureSize;
     
     // build a quad to draw the texture
     GPUQuad DrawnQuad =
@@ -227,6 +238,6 @@ void Texture::Draw( int RenderXMin, int RenderYMin, int RenderXMax, int RenderYM
     Video.AddQuadToQueue( DrawnQuad );
     Video.RenderQuadQueue();
     
-    // deselect texture
-    glBindTexture( GL_TEXTURE_2D, 0 );
+    // restore the texture selected in the console
+    Video.SelectTexture( Video.GetSelectedTexture() );
 }
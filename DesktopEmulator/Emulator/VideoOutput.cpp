@@ -104,16 +104,31 @@ const string VertexShaderCode =
     "}                                                                                          \n";
 
 const string FragmentShaderCode =
-    "#version 100                                                                    \n"
-    "                                                                                \n"
-    "uniform mediump vec4 MultiplyColor;                                             \n"
-    "uniform sampler2D TextureUnit;                                                  \n"
-    "varying highp vec2 TextureCoordinate;                                           \n"
-    "                                                                                \n"
-    "void main()                                                                     \n"
-    "{                                                                               \n"
-    "    gl_FragColor = MultiplyColor * texture2D( TextureUnit, TextureCoordinate ); \n"
-    "}                                                                               \n";
+    "#version 100                                                                       \n"
+    "                                                                                   \n"
+    "uniform mediump vec4 MultiplyColor;                                                \n"
+    "uniform sampler2D TextureUnit;                                                     \n"
+    "uniform highp vec4 TextureArea;        // x,y = image position; z,w = image size   \n"
+    "uniform highp vec2 TextureUnitSize;                                                \n"
+    "varying highp vec2 TextureCoordinate;                                              \n"
+    "                                                                                   \n"
+    "void main()                                                                        \n"
+    "{                                                                                  \n"
+    "    // coordinates are relative to a full 1024x1024 texture;                       \n"
+    "    // select a texel the same way GL_NEAREST would for it                         \n"
+    "    highp vec2 Texel = clamp( floor( TextureCoordinate * 1024.0 ), 0.0, 1023.0 );  \n"
+    "                                                                                   \n"
+    "    // texels outside the loaded image are transparent black                       \n"
+    "    if( Texel.x >= TextureArea.z || Texel.y >= TextureArea.w )                     \n"
+    "      gl_FragColor = vec4( 0.0 );                                                  \n"
+    "                                                                                   \n"
+    "    // otherwise sample the center of that texel where the image is stored         \n"
+    "    else                                                                           \n"
+    "    {                                                                              \n"
+    "        highp vec2 Position = (TextureArea.xy + Texel + 0.5) / TextureUnitSize;    \n"
+    "        gl_FragColor = MultiplyColor * texture2D( TextureUnit, Position );         \n"
+    "    }                                                                              \n"
+    "}                                                                                  \n";
 
 
 // =============================================================================
@@ -143,12 +158,17 @@ VideoOutput::VideoOutput()
     SelectedTexture = -1;
     QueuedQuads = 0;
     
-    // all texture IDs are initially 0
-    BiosTextureID = 0;
+    // no textures are initially loaded
+    TextureLocation NoTexture = { 0, false, 0, 0, 0, 0, 0, 0 };
+    BiosTexture = NoTexture;
     WhiteTextureID = 0;
     
     for( int i = 0; i < Constants::GPUMaximumCartridgeTextures; i++ )
-      CartridgeTextureIDs[ i ] = 0;
+      CartridgeTextures[ i ] = NoTexture;
+    
+    AtlasShelfX = AtlasShelfY = 0;
+    AtlasShelfHeight = 0;
+    TextureMemory = 0;
     
     // initialize vertex indices; they are organized
     // assuming each quad will be given as 4 vertices,
@@ -477,6 +497,8 @@ void VideoOutput::InitRendering()
     // find the position for all our input uniforms within the shader program
     TextureUnitLocation = glGetUniformLocation( ShaderProgramID, "TextureUnit" );
     MultiplyColorLocation = glGetUniformLocation( ShaderProgramID, "MultiplyColor" );
+    TextureAreaLocation = glGetUniformLocation( ShaderProgramID, "TextureArea" );
+    TextureUnitSizeLocation = glGetUniformLocation( ShaderProgramID, "TextureUnitSize" );
     
     // on a core OpenGL profile, we need this since
     // the default VAO is not valid!
@@ -588,12 +610,9 @@ void VideoOutput::Destroy()
     // release all textures
     if( OpenGLContext )
     {
-        UnloadTexture( BiosTextureID );
-        UnloadTexture( WhiteTextureID );
-        
-        for( int i = 0; i < Constants::GPUMaximumCartridgeTextures; i++ )
-          if( CartridgeTextureIDs[ i ] != 0 )
-            UnloadTexture( CartridgeTextureIDs[ i ] );
+        UnloadTexture( -1 );
+        UnloadCartridgeTextures();
+        glDeleteTextures( 1, &WhiteTextureID );
     }
     
     // destroy in reverse order
@@ -893,8 +912,16 @@ void VideoOutput::ClearScreen( GPUColor ClearColor )
     GPUColor PreviousMultiplyColor = MultiplyColor;
     SetMultiplyColor( ClearColor );
     
-    // bind white texture
-    glBindTexture( GL_TEXTURE_2D, WhiteTextureID );
+    // bind white texture, making its single
+    // pixel cover the whole 1024x1024 area
+    TextureLocation WhiteTexture =
+    {
+        WhiteTextureID, false,
+        0, 0, Constants::GPUTextureSize, Constants::GPUTextureSize,
+        1, 1
+    };
+    
+    BindTexture( WhiteTexture );
     
     // set a full-screen quad with the same texture pixel
     const GPUQuad ScreenQuad =
@@ -924,32 +951,39 @@ void VideoOutput::ClearScreen( GPUColor ClearColor )
 // =============================================================================
 
 
-void VideoOutput::LoadTexture( int GPUTextureID, void* Pixels )
+TextureLocation& VideoOutput::GetTextureLocation( int GPUTextureID )
 {
-    GLuint* OpenGLTextureID = &BiosTextureID;
-    
     if( GPUTextureID >= 0 )
-      OpenGLTextureID = &CartridgeTextureIDs[ GPUTextureID ];
+      return CartridgeTextures[ GPUTextureID ];
     
+    return BiosTexture;
+}
+
+// -----------------------------------------------------------------------------
+
+GLuint VideoOutput::CreateOpenGLTexture( int Width, int Height, void* Pixels )
+{
     // create a new OpenGL texture and select it
-    glGenTextures( 1, OpenGLTextureID );
-    glBindTexture( GL_TEXTURE_2D, *OpenGLTextureID );
+    GLuint OpenGLTextureID = 0;
+    glGenTextures( 1, &OpenGLTextureID );
+    glBindTexture( GL_TEXTURE_2D, OpenGLTextureID );
     
     // check correct texture ID
     if( !OpenGLTextureID )
       THROW( "OpenGL failed to generate a new texture" );
     
     // clear OpenGL errors
-    glGetError();
+    ClearOpenGLErrors();
     
     // create an OpenGL texture from the received pixel data
+    // (when no pixels are given, contents are left undefined)
     glTexImage2D
     (
         GL_TEXTURE_2D,              // texture is a 2D rectangle
         0,                          // level of detail (0 = normal size)
         GL_RGBA,                    // color components in the texture
-        Constants::GPUTextureSize,  // texture width in pixels
-        Constants::GPUTextureSize,  // texture height in pixels
+        Width,                      // texture width in pixels
+        Height,                     // texture height in pixels
         0,                          // border width (must be 0 or 1)
         GL_RGBA,                    // color components in the source
         GL_UNSIGNED_BYTE,           // each color component is a byte
@@ -961,25 +995,168 @@ void VideoOutput::LoadTexture( int GPUTextureID, void* Pixels )
       THROW( "Could not create an OpenGL texture from pixel data" );
     
     // textures must be scaled using only nearest neighbour
-    glTexParameterf( GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST );         
+    glTexParameterf( GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST );
     glTexParameterf( GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST );
     
     // out-of-texture coordinates must clamp, not wrap
+    // (sizes may not be powers of 2, and that is only
+    // allowed in OpenGL ES 2 when wrapping is disabled)
     glTexParameterf( GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE );
     glTexParameterf( GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE );
+    
+    TextureMemory += Width * Height * 4;
+    return OpenGLTextureID;
+}
+
+// -----------------------------------------------------------------------------
+
+// finds a free area for the texture in the last atlas
+// page, and starts a new one when it does not fit
+void VideoOutput::PlaceInAtlas( TextureLocation& Location )
+{
+    const int PageSize = Constants::GPUTextureSize;
+    
+    // when this shelf is full, start a new one below
+    if( AtlasShelfX + Location.Width > PageSize )
+    {
+        AtlasShelfX = 0;
+        AtlasShelfY += AtlasShelfHeight;
+        AtlasShelfHeight = 0;
+    }
+    
+    // when the page is full, start a new page
+    if( AtlasPageIDs.empty() || AtlasShelfY + Location.Height > PageSize )
+    {
+        AtlasPageIDs.push_back( CreateOpenGLTexture( PageSize, PageSize, nullptr ) );
+        AtlasShelfX = AtlasShelfY = 0;
+        AtlasShelfHeight = 0;
+    }
+    
+    Location.OpenGLID = AtlasPageIDs.back();
+    Location.IsInAtlas = true;
+    Location.X = AtlasShelfX;
+    Location.Y = AtlasShelfY;
+    Location.OpenGLWidth = PageSize;
+    Location.OpenGLHeight = PageSize;
+    
+    AtlasShelfX += Location.Width;
+    AtlasShelfHeight = max( AtlasShelfHeight, Location.Height );
 }
 
 // -----------------------------------------------------------------------------
 
+void VideoOutput::BindTexture( const TextureLocation& Location )
+{
+    glBindTexture( GL_TEXTURE_2D, Location.OpenGLID );
+    
+    // tell the shader where to find the image
+    glUniform4f
+    (
+        TextureAreaLocation,
+        Location.X, Location.Y,
+        Location.Width, Location.Height
+    );
+    
+    glUniform2f
+    (
+        TextureUnitSizeLocation,
+        Location.OpenGLWidth, Location.OpenGLHeight
+    );
+}
+
+// -----------------------------------------------------------------------------
+
+// pixels are given at the actual size of the image,
+// not expanded to the full 1024x1024 texture size
+void VideoOutput::LoadTexture( int GPUTextureID, void* Pixels, int Width, int Height )
+{
+    TextureLocation& Location = GetTextureLocation( GPUTextureID );
+    Location.Width = Width;
+    Location.Height = Height;
+    
+    // small cartridge textures go to an atlas page; the
+    // BIOS texture is never placed there since it has to
+    // remain loaded when cartridge textures are released
+    bool UseAtlas = (GPUTextureID >= 0)
+                 && (Width  <= ATLAS_TEXTURE_LIMIT)
+                 && (Height <= ATLAS_TEXTURE_LIMIT);
+    
+    if( UseAtlas )
+    {
+        PlaceInAtlas( Location );
+        glBindTexture( GL_TEXTURE_2D, Location.OpenGLID );
+        ClearOpenGLErrors();
+        
+        glTexSubImage2D
+        (
+            GL_TEXTURE_2D,          // texture is a 2D rectangle
+            0,                      // level of detail (0 = normal size)
+            Location.X,             // position within the atlas page
+            Location.Y,
+            Width,                  // size of the copied area
+            Height,
+            GL_RGBA,                // color components in the source
+            GL_UNSIGNED_BYTE,       // each color component is a byte
+            Pixels                  // buffer storing the texture data
+        );
+        
+        if( glGetError() != GL_NO_ERROR )
+          THROW( "Could not copy pixel data to an OpenGL texture atlas" );
+    }
+    
+    // other textures get an OpenGL texture of their exact size
+    else
+    {
+        Location.OpenGLID = CreateOpenGLTexture( Width, Height, Pixels );
+        Location.IsInAtlas = false;
+        Location.X = Location.Y = 0;
+        Location.OpenGLWidth = Width;
+        Location.OpenGLHeight = Height;
+    }
+    
+    // report video memory usage
+    string Storage = UseAtlas? ("atlas page " + to_string( AtlasPageIDs.size()-1 )) : "own texture";
+    LOG( "-> Stored in " + Storage + "; texture video memory is now " + to_string( TextureMemory / 1024 ) + " KB" );
+    
+    // restore the selected texture
+    glBindTexture( GL_TEXTURE_2D, GetTextureLocation( SelectedTexture ).OpenGLID );
+}
+
+// -----------------------------------------------------------------------------
+
+// space in atlas pages is not reused individually:
+// it is only released along with all cartridge textures
 void VideoOutput::UnloadTexture( int GPUTextureID )
 {
-    GLuint* OpenGLTextureID = &BiosTextureID;
+    TextureLocation& Location = GetTextureLocation( GPUTextureID );
     
-    if( GPUTextureID >= 0 )
-      OpenGLTextureID = &CartridgeTextureIDs[ GPUTextureID ];
+    if( Location.OpenGLID && !Location.IsInAtlas )
+    {
+        glDeleteTextures( 1, &Location.OpenGLID );
+        TextureMemory -= Location.OpenGLWidth * Location.OpenGLHeight * 4;
+    }
     
-    glDeleteTextures( 1, OpenGLTextureID );
-    *OpenGLTextureID = 0;
+    TextureLocation NoTexture = { 0, false, 0, 0, 0, 0, 0, 0 };
+    Location = NoTexture;
+}
+
+// -----------------------------------------------------------------------------
+
+void VideoOutput::UnloadCartridgeTextures()
+{
+    for( int i = 0; i < Constants::GPUMaximumCartridgeTextures; i++ )
+      UnloadTexture( i );
+    
+    // now release all atlas pages
+    for( GLuint PageID: AtlasPageIDs )
+    {
+        glDeleteTextures( 1, &PageID );
+        TextureMemory -= Constants::GPUTextureSize * Constants::GPUTextureSize * 4;
+    }
+    
+    AtlasPageIDs.clear();
+    AtlasShelfX = AtlasShelfY = 0;
+    AtlasShelfHeight = 0;
 }
 
 // -----------------------------------------------------------------------------
@@ -991,12 +1168,7 @@ void VideoOutput::SelectTexture( int GPUTextureID )
     RenderQuadQueue();
     
     SelectedTexture = GPUTextureID;
-    GLuint* OpenGLTextureID = &BiosTextureID;
-    
-    if( GPUTextureID >= 0 )
-      OpenGLTextureID = &CartridgeTextureIDs[ GPUTextureID ];
-    
-    glBindTexture( GL_TEXTURE_2D, *OpenGLTextureID );
+    BindTexture( GetTextureLocation( GPUTextureID ) );
 }
 
 // -----------------------------------------------------------------------------
@@ -1005,3 +1177,50 @@ int32_t VideoOutput::GetSelectedTexture()
 {
     return SelectedTexture;
 }
+
+// -----------------------------------------------------------------------------
+
+unsigned VideoOutput::GetTextureMemory()
+{
+    return TextureMemory;
+}
+
+// -----------------------------------------------------------------------------
+
+// textures cannot be read directly in OpenGL ES 2, so
+// this attaches them to a temporary framebuffer instead
+bool VideoOutput::ReadTexture( int GPUTextureID, vector< GPUColor >& Pixels, int& Width, int& Height )
+{
+    const TextureLocation& Location = GetTextureLocation( GPUTextureID );
+    
+    if( !Location.OpenGLID )
+      return false;
+    
+    Width = Location.Width;
+    Height = Location.Height;
+    Pixels.resize( Width * Height );
+    
+    // any pending quads have to be drawn on the
+    // framebuffer that is currently bound
+    RenderQuadQueue();
+    
+    GLint PreviousFramebufferID = 0;
+    glGetIntegerv( GL_FRAMEBUFFER_BINDING, &PreviousFramebufferID );
+    
+    GLuint ReadFramebufferID = 0;
+    glGenFramebuffers( 1, &ReadFramebufferID );
+    glBindFramebuffer( GL_FRAMEBUFFER, ReadFramebufferID );
+    glFramebufferTexture2D( GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, Location.OpenGLID, 0 );
+    
+    bool Success = (glCheckFramebufferStatus( GL_FRAMEBUFFER ) == GL_FRAMEBUFFER_COMPLETE);
+    
+    if( Success )
+    {
+        glPixelStorei( GL_PACK_ALIGNMENT, 4 );
+        glReadPixels( Location.X, Location.Y, Width, Height, GL_RGBA, GL_UNSIGNED_BYTE, Pixels.data() );
+    }
+    
+    glBindFramebuffer( GL_FRAMEBUFFER, PreviousFramebufferID );
+    glDeleteFramebuffers( 1, &ReadFramebufferID );
+    return Success;
+}
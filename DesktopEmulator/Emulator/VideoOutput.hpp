@@ -16,6 +16,9 @@
     
     // include OpenGL headers
     #include <glad/glad.h>      // [ OpenGL ] GLAD Loader (already includes <GL/gl.h>)
+    
+    // include C/C++ headers
+    #include <vector>           // [ C++ STL ] Vectors
 // *****************************************************************************
 
 
@@ -24,6 +27,32 @@
 // queue size and acts as group size limit
 #define QUAD_QUEUE_SIZE 20
 
+// textures with both sizes up to this limit are
+// packed together in shared atlas pages, so that
+// they don't each need an OpenGL texture
+#define ATLAS_TEXTURE_LIMIT 256
+
+
+// =============================================================================
+//      LOCATION OF TEXTURES IN OPENGL
+// =============================================================================
+
+
+// Vircon textures are always sampled as 1024x1024, but
+// only the area of their loaded image is stored. The
+// fragment shader finds it from this location, and any
+// pixels outside that area are transparent black
+typedef struct
+{
+    GLuint OpenGLID;        // 0 when not loaded
+    bool IsInAtlas;         // atlas pages are released together
+    int X, Y;               // position of the image within the OpenGL texture
+    int Width, Height;      // size of the loaded image
+    int OpenGLWidth;        // size of the whole OpenGL texture
+    int OpenGLHeight;
+}
+TextureLocation;
+
 
 // =============================================================================
 //      2D-SPECIALIZED OPENGL CONTEXT
@@ -52,11 +81,20 @@ class VideoOutput
         V32::GPUColor MultiplyColor;
         V32::IOPortValues BlendingMode;
         
-        // OpenGL IDs of loaded textures
-        GLuint BiosTextureID;
-        GLuint CartridgeTextureIDs[ V32::Constants::GPUMaximumCartridgeTextures ];
+        // locations of loaded textures
+        TextureLocation BiosTexture;
+        TextureLocation CartridgeTextures[ V32::Constants::GPUMaximumCartridgeTextures ];
         int32_t SelectedTexture;
         
+        // atlas pages for small cartridge textures; the last
+        // one is filled in rows ("shelves") from top to bottom
+        std::vector< GLuint > AtlasPageIDs;
+        int AtlasShelfX, AtlasShelfY;
+        int AtlasShelfHeight;
+        
+        // video memory currently used by loaded textures
+        unsigned TextureMemory;
+        
         // white texture used to draw solid colors
         GLuint WhiteTextureID;
         
@@ -79,6 +117,13 @@ class VideoOutput
         GLuint VertexInfoLocation;
         GLuint TextureUnitLocation;
         GLuint MultiplyColorLocation;
+        GLuint TextureAreaLocation;
+        GLuint TextureUnitSizeLocation;
+        
+        // texture helpers
+        TextureLocation& GetTextureLocation( int GPUTextureID );
+        GLuint CreateOpenGLTexture( int Width, int Height, void* Pixels );
+        void PlaceInAtlas( TextureLocation& Location );
         
     public:
         
@@ -126,10 +171,20 @@ class VideoOutput
         void RenderQuadQueue();
         
         // texture handling
-        void LoadTexture( int GPUTextureID, void* Pixels );
+        void LoadTexture( int GPUTextureID, void* Pixels, int Width, int Height );
         void UnloadTexture( int GPUTextureID );
+        void UnloadCartridgeTextures();
         void SelectTexture( int GPUTextureID );
         int32_t GetSelectedTexture();
+        unsigned GetTextureMemory();
+        
+        // also used to draw textures outside the console
+        // (afterwards, restore the console's selection)
+        void BindTexture( const TextureLocation& Location );
+        
+        // reads back the pixels of a loaded texture;
+        // returns false if that texture is not loaded
+        bool ReadTexture( int GPUTextureID, std::vector< V32::GPUColor >& Pixels, int& Width, int& Height );
 };
 
 
@@ -0,0 +1,474 @@
+// *****************************************************************************
+    // include common Vircon headers
+    #include "../VirconDefinitions/Constants.hpp"
+    #include "../VirconDefinitions/Enumerations.hpp"
+    
+    // include infrastructure headers
+    #include "DesktopInfrastructure/FilePaths.hpp"
+    #include "DesktopInfrastructure/Logger.hpp"
+    
+    // include console logic headers
+    #include "ConsoleLogic/GPUTraces.hpp"
+    
+    // include emulator headers
+    #include "Emulator/VideoOutput.hpp"
+    #include "Emulator/StopWatch.hpp"
+    
+    // include project headers
+    #include "SoftwareRenderer.hpp"
+    #include "ReplayFrontends.hpp"
+    
+    // include C/C++ headers
+    #include <string>           // [ C++ STL ] Strings
+    #include <iostream>         // [ C++ STL ] I/O Streams
+    #include <stdexcept>        // [ C++ STL ] Exceptions
+    #include <vector>           // [ C++ STL ] Vectors
+    #include <algorithm>        // [ C++ STL ] Algorithms
+    #include <memory>           // [ C++ STL ] Dynamic memory
+    #include <cstdio>           // [ ANSI C ] Standard I/O
+    #include <cstdlib>          // [ ANSI C ] Standard library
+    
+    // include SDL2 headers
+    #define SDL_MAIN_HANDLED
+    #include "SDL.h"            // [ SDL2 ] Main header
+    
+    // on Windows include headers for unicode conversion
+    #if defined(__WIN32__) || defined(_WIN32) || defined(_WIN64)
+      #define WINDOWS_OS
+      #include <windows.h>      // [ WINDOWS ] Main header
+      #include <shellapi.h>     // [ WINDOWS ] Shell API
+    #endif
+    
+    // declare used namespaces
+    using namespace std;
+    using namespace V32;
+// *****************************************************************************
+
+
+// =============================================================================
+//      GLOBAL VARIABLES
+// =============================================================================
+
+
+bool VerboseMode = false;
+bool UseOpenGL = true;
+int NumberOfLoops = 1;
+
+// the emulator's video output is used
+// when replaying traces through OpenGL
+VideoOutput Video;
+
+
+// =============================================================================
+//      AUXILIARY FUNCTIONS
+// =============================================================================
+
+
+void PrintUsage()
+{
+    cout << "USAGE: ReplayGPUTrace [options] file" << endl;
+    cout << "File: a GPU trace recorded by the emulator" << endl;
+    cout << "Options:" << endl;
+    cout << "  --help       Displays this information" << endl;
+    cout << "  --version    Displays program version" << endl;
+    cout << "  -r <name>    Renderer to use: opengl (default) or software" << endl;
+    cout << "  -n <loops>   Number of times to replay the trace, default is 1" << endl;
+    cout << "  -v           Displays statistics for every frame (verbose)" << endl;
+}
+
+// -----------------------------------------------------------------------------
+
+void PrintVersion()
+{
+    cout << "ReplayGPUTrace v25.2.2" << endl;
+    cout << "GPU trace replayer for Vircon32 emulator" << endl;
+}
+
+// -----------------------------------------------------------------------------
+
+// use this funcion to get the executable path
+// in a portable way (can't be done without libraries)
+string GetProgramFolder()
+{
+    if( SDL_Init( 0 ) )
+      THROW( "cannot initialize SDL" );
+    
+    char* SDLString = SDL_GetBasePath();
+    string Result = SDLString;
+    
+    SDL_free( SDLString );
+    SDL_Quit();
+    
+    return Result;
+}
+
+// -----------------------------------------------------------------------------
+
+// same hash used for console checksums in input movies
+uint32_t GetFramebufferChecksum( const vector< GPUColor >& Pixels )
+{
+    uint32_t Hash = 2166136261u;
+    
+    for( const GPUColor& Pixel: Pixels )
+    {
+        V32Word Word;
+        Word.AsColor = Pixel;
+        Hash ^= Word.AsBinary;
+        Hash *= 16777619u;
+    }
+    
+    return Hash;
+}
+
+// -----------------------------------------------------------------------------
+
+// OpenGL rows start from the bottom, so they
+// are reversed to get the same order as the
+// software renderer's framebuffer
+vector< GPUColor > ReadOpenGLFramebuffer()
+{
+    vector< GPUColor > Pixels( Constants::ScreenPixels );
+    Video.RenderToFramebuffer();
+    glPixelStorei( GL_PACK_ALIGNMENT, 4 );
+    glReadPixels( 0, 0, Constants::ScreenWidth, Constants::ScreenHeight, GL_RGBA, GL_UNSIGNED_BYTE, Pixels.data() );
+    
+    for( int y = 0; y < Constants::ScreenHeight / 2; y++ )
+      swap_ranges
+      (
+          Pixels.begin() + y * Constants::ScreenWidth,
+          Pixels.begin() + (y + 1) * Constants::ScreenWidth,
+          Pixels.begin() + (Constants::ScreenHeight - 1 - y) * Constants::ScreenWidth
+      );
+    
+    return Pixels;
+}
+
+// -----------------------------------------------------------------------------
+
+void InitializeOpenGL()
+{
+    Video.CreateOpenGLWindow();
+    SDL_SetWindowTitle( Video.GetWindow(), "ReplayGPUTrace" );
+    
+    // frames must not wait for the display
+    SDL_GL_SetSwapInterval( 0 );
+    
+    // same configuration as the emulator
+    Video.InitRendering();
+    Video.CreateFramebuffer();
+    Video.RenderToScreen();
+    glEnable( GL_BLEND );
+    Video.SetBlendingMode( IOPortValues::GPUBlendingMode_Alpha );
+    
+    Video.RenderToFramebuffer();
+    Video.BeginFrame();
+}
+
+// -----------------------------------------------------------------------------
+
+// rendered frames are shown, but this is not timed;
+// returns false if the window was closed meanwhile
+bool PresentOpenGLFrame()
+{
+    Video.RenderToScreen();
+    Video.DrawFramebufferOnScreen();
+    SDL_GL_SwapWindow( Video.GetWindow() );
+    
+    Video.RenderToFramebuffer();
+    Video.BeginFrame();
+    
+    SDL_Event Event;
+    bool WindowClosed = false;
+    
+    while( SDL_PollEvent( &Event ) )
+    {
+        if( Event.type == SDL_QUIT )
+          WindowClosed = true;
+        
+        if( Event.type == SDL_KEYDOWN && Event.key.keysym.sym == SDLK_ESCAPE )
+          WindowClosed = true;
+    }
+    
+    return !WindowClosed;
+}
+
+// -----------------------------------------------------------------------------
+
+// takes values in seconds, and prints them in ms
+void PrintFrameTimes( vector< double > FrameTimes )
+{
+    if( FrameTimes.empty() )
+      return;
+    
+    sort( FrameTimes.begin(), FrameTimes.end() );
+    double TotalTime = 0;
+    
+    for( double Time: FrameTimes )
+      TotalTime += Time;
+    
+    size_t Percentile95 = min( FrameTimes.size() - 1, (size_t)(0.95 * FrameTimes.size()) );
+    
+    printf
+    (
+        "frame time: %.3f ms average, %.3f ms 95th percentile, %.3f ms max\n",
+        1000 * TotalTime / FrameTimes.size(),
+        1000 * FrameTimes[ Percentile95 ],
+        1000 * FrameTimes.back()
+    );
+}
+
+
+// =============================================================================
+//      MAIN FUNCTION
+// =============================================================================
+
+
+int main( int NumberOfArguments, char* Arguments[] )
+{
+    try
+    {
+        // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+        // Process command line arguments
+        
+        // variables to capture input parameters
+        string InputPath;
+        
+        // to treat arguments the same in any OS we
+        // will convert them to UTF-8 in all cases
+        vector< string > ArgumentsUTF8;
+        
+        #if defined(WINDOWS_OS)
+          
+          // on Windows we can't rely on the arguments received
+          // in main: ask Windows for the UTF-16 command line
+          wchar_t* CommandLineUTF16 = GetCommandLineW();
+          wchar_t** ArgumentsUTF16 = CommandLineToArgvW( CommandLineUTF16, &NumberOfArguments );
+          
+          // now convert every program argument to UTF-8
+          for( int i = 0; i < NumberOfArguments; i++ )
+            ArgumentsUTF8.push_back( ToUTF8( ArgumentsUTF16[i] ) );
+          
+          LocalFree( ArgumentsUTF16 );
+        
+        #else
+          
+          // on Linux/Mac arguments in main are already UTF-8
+          for( int i = 0; i < NumberOfArguments; i++ )
+            ArgumentsUTF8.push_back( Arguments[i] );
+        
+        #endif
+        
+        // process arguments
+        for( int i = 1; i < NumberOfArguments; i++ )
+        {
+            if( ArgumentsUTF8[i] == string("--help") )
+            {
+                PrintUsage();
+                return 0;
+            }
+            
+            if( ArgumentsUTF8[i] == string("--version") )
+            {
+                PrintVersion();
+                return 0;
+            }
+            
+            if( ArgumentsUTF8[i] == string("-v") )
+            {
+                VerboseMode = true;
+                continue;
+            }
+            
+            if( ArgumentsUTF8[i] == string("-r") )
+            {
+                // expect another argument
+                i++;
+                
+                if( i >= NumberOfArguments )
+                  throw runtime_error( "missing renderer name after '-r'" );
+                
+                if( ArgumentsUTF8[ i ] == string("opengl") )
+                  UseOpenGL = true;
+                
+                else if( ArgumentsUTF8[ i ] == string("software") )
+                  UseOpenGL = false;
+                
+                else
+                  throw runtime_error( string("unknown renderer '") + ArgumentsUTF8[ i ] + "'" );
+                
+                continue;
+            }
+            
+            if( ArgumentsUTF8[i] == string("-n") )
+            {
+                // expect another argument
+                i++;
+                
+                if( i >= NumberOfArguments )
+                  throw runtime_error( "missing number of loops after '-n'" );
+                
+                NumberOfLoops = atoi( ArgumentsUTF8[ i ].c_str() );
+                
+                if( NumberOfLoops <= 0 )
+                  throw runtime_error( "number of loops must be positive" );
+                
+                continue;
+            }
+            
+            // discard any other parameters starting with '-'
+            if( ArgumentsUTF8[i][0] == '-' )
+              throw runtime_error( string("unrecognized command line option '") + ArgumentsUTF8[i] + "'" );
+            
+            // any non-option parameter is taken as the input file
+            if( InputPath.empty() )
+            {
+                InputPath = ArgumentsUTF8[i];
+            }
+            
+            // only a single input file is supported!
+            else
+              throw runtime_error( "too many input files, only 1 is supported" );
+        }
+        
+        // check if an input path was given
+        if( InputPath.empty() )
+          throw runtime_error( "no input file" );
+        
+        // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+        // STEP 1: Prepare the renderer
+        
+        // renderers report their errors in the log too
+        LOG_TO_FILE( GetProgramFolder() + "ReplayGPUTraceLog" );
+        
+        if( SDL_Init( UseOpenGL? (SDL_INIT_VIDEO | SDL_INIT_TIMER) : SDL_INIT_TIMER ) != 0 )
+          THROW( string("Cannot initialize SDL: ") + SDL_GetError() );
+        
+        unique_ptr< OpenGLFrontend > OpenGL;
+        unique_ptr< SoftwareRenderer > Software;
+        VirconFrontendInterface* Renderer = nullptr;
+        
+        if( UseOpenGL )
+        {
+            InitializeOpenGL();
+            OpenGL.reset( new OpenGLFrontend( Video ) );
+            Renderer = OpenGL.get();
+        }
+        
+        else
+        {
+            Software.reset( new SoftwareRenderer );
+            Renderer = Software.get();
+        }
+        
+        // textures are loaded directly, while frames
+        // go through the statistics frontend
+        VirconFrontendInterface& Target = *Renderer;
+        StatisticsFrontend Statistics( Target );
+        
+        // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+        // STEP 2: Load the trace
+        
+        GPUTracePlayer Player;
+        Player.LoadFile( Target, InputPath );
+        
+        if( VerboseMode )
+        {
+            cout << "loaded GPU trace for \"" << Player.Header.CartridgeTitle << "\"" << endl;
+            cout << "trace has " << Player.Header.NumberOfFrames << " frames" << endl;
+        }
+        
+        // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+        // STEP 3: Replay all frames as fast as possible
+        
+        vector< double > FrameTimes;
+        int64_t DrawnQuads = 0, ClearedScreens = 0, StateChanges = 0;
+        double DrawnPixels = 0;
+        bool WindowClosed = false;
+        StopWatch Watch;
+        
+        for( int Loop = 1; Loop <= NumberOfLoops && !WindowClosed; Loop++ )
+        {
+            // every loop starts with the same textures,
+            // in case the trace loads or unloads any
+            Target.UnloadCartridgeTextures();
+            Target.UnloadBiosTexture();
+            Player.LoadInitialTextures( Target );
+            
+            while( !WindowClosed )
+            {
+                Statistics.ResetCounts();
+                Watch.GetStepTime();
+                
+                if( !Player.PlayNextFrame( Statistics ) )
+                  break;
+                
+                // with OpenGL, wait for the frame to be rendered
+                if( UseOpenGL )
+                {
+                    Video.RenderQuadQueue();
+                    glFinish();
+                }
+                
+                double FrameTime = Watch.GetStepTime();
+                FrameTimes.push_back( FrameTime );
+                
+                DrawnQuads += Statistics.DrawnQuads;
+                ClearedScreens += Statistics.ClearedScreens;
+                StateChanges += Statistics.StateChanges;
+                DrawnPixels += Statistics.DrawnPixels;
+                
+                if( VerboseMode )
+                  printf
+                  (
+                      "frame %d: %.3f ms, %d quads, %d state changes, %.0f pixels\n",
+                      Player.CurrentFrame,
+                      1000 * FrameTime,
+                      (int)Statistics.DrawnQuads,
+                      (int)Statistics.StateChanges,
+                      Statistics.DrawnPixels
+                  );
+                
+                if( UseOpenGL )
+                  WindowClosed = !PresentOpenGLFrame();
+            }
+        }
+        
+        // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+        // STEP 4: Report results
+        
+        double TotalTime = 0;
+        
+        for( double Time: FrameTimes )
+          TotalTime += Time;
+        
+        int RenderedFrames = FrameTimes.size();
+        printf( "renderer: %s\n", UseOpenGL? "opengl" : "software" );
+        printf( "frames: %d (%.1f per second)\n", RenderedFrames, RenderedFrames / max( TotalTime, 1e-9 ) );
+        PrintFrameTimes( FrameTimes );
+        
+        if( RenderedFrames > 0 )
+        {
+            printf( "quads: %.1f per frame, clears: %.2f per frame\n", (double)DrawnQuads / RenderedFrames, (double)ClearedScreens / RenderedFrames );
+            printf( "state changes: %.1f per frame\n", (double)StateChanges / RenderedFrames );
+            printf( "fill rate: %.1f screens per frame, %.1f Mpixels/s\n", DrawnPixels / Constants::ScreenPixels / RenderedFrames, DrawnPixels / 1e6 / max( TotalTime, 1e-9 ) );
+        }
+        
+        // the final image can be compared between runs
+        vector< GPUColor > FinalImage = (UseOpenGL? ReadOpenGLFramebuffer() : Software->Framebuffer);
+        printf( "final framebuffer checksum: %08X\n", GetFramebufferChecksum( FinalImage ) );
+        
+        // clean-up in reverse order
+        if( UseOpenGL )
+          Video.Destroy();
+        
+        SDL_Quit();
+    }
+    
+    catch( const exception& e )
+    {
+        cerr << "ReplayGPUTrace: error: " << e.what() << endl;
+        return 1;
+    }
+    
+    return 0;
+}
@@ -0,0 +1,282 @@
+// *****************************************************************************
+    // include common Vircon headers
+    #include "../VirconDefinitions/Constants.hpp"
+    
+    // include infrastructure headers
+    #include "DesktopInfrastructure/Logger.hpp"
+    
+    // include project headers
+    #include "ReplayFrontends.hpp"
+    
+    // include C/C++ headers
+    #include <vector>           // [ C++ STL ] Vectors
+    #include <cmath>            // [ ANSI C ] Mathematics
+    
+    // declare used namespaces
+    using namespace std;
+    using namespace V32;
+// *****************************************************************************
+
+
+// =============================================================================
+//      AUXILIARY FUNCTIONS
+// =============================================================================
+
+
+// only vertex positions are used here
+typedef struct
+{
+    double x, y;
+}
+Point2D;
+
+// -----------------------------------------------------------------------------
+
+// keeps the part of a polygon on the inner side of one
+// screen edge, given as: Side * (coordinate - Limit) >= 0
+static vector< Point2D > ClipPolygon( const vector< Point2D >& Polygon, bool ClipX, double Limit, double Side )
+{
+    vector< Point2D > Result;
+    
+    for( unsigned i = 0; i < Polygon.size(); i++ )
+    {
+        const Point2D& P1 = Polygon[ i ];
+        const Point2D& P2 = Polygon[ (i + 1) % Polygon.size() ];
+        double D1 = Side * ((ClipX? P1.x : P1.y) - Limit);
+        double D2 = Side * ((ClipX? P2.x : P2.y) - Limit);
+        
+        if( D1 >= 0 )
+          Result.push_back( P1 );
+        
+        // add the point where the side crosses the edge
+        if( (D1 >= 0) != (D2 >= 0) )
+        {
+            double t = D1 / (D1 - D2);
+            Result.push_back( Point2D{ P1.x + t * (P2.x - P1.x), P1.y + t * (P2.y - P1.y) } );
+        }
+    }
+    
+    return Result;
+}
+
+// -----------------------------------------------------------------------------
+
+// area of the quad that is within the screen
+static double GetVisibleArea( const GPUQuad& Quad )
+{
+    // vertices are top-left, top-right, bottom-left and
+    // bottom-right, so go around them in the right order
+    const int Order[ 4 ] = { 0, 1, 3, 2 };
+    vector< Point2D > Polygon;
+    
+    for( int i: Order )
+      Polygon.push_back( Point2D{ Quad.Vertices[ i ].x, Quad.Vertices[ i ].y } );
+    
+    Polygon = ClipPolygon( Polygon, true,  0, +1 );
+    Polygon = ClipPolygon( Polygon, true,  Constants::ScreenWidth, -1 );
+    Polygon = ClipPolygon( Polygon, false, 0, +1 );
+    Polygon = ClipPolygon( Polygon, false, Constants::ScreenHeight, -1 );
+    
+    // shoelace formula
+    double DoubleArea = 0;
+    
+    for( unsigned i = 0; i < Polygon.size(); i++ )
+    {
+        const Point2D& P1 = Polygon[ i ];
+        const Point2D& P2 = Polygon[ (i + 1) % Polygon.size() ];
+        DoubleArea += P1.x * P2.y - P2.x * P1.y;
+    }
+    
+    return fabs( DoubleArea ) / 2;
+}
+
+
+// =============================================================================
+//      OPENGL FRONTEND
+// =============================================================================
+
+
+OpenGLFrontend::OpenGLFrontend( VideoOutput& TargetVideo )
+:   Video( TargetVideo )
+{
+    // (nothing else to initialize)
+}
+
+// -----------------------------------------------------------------------------
+
+void OpenGLFrontend::ClearScreen( GPUColor ClearColor )
+{
+    Video.ClearScreen( ClearColor );
+}
+
+// -----------------------------------------------------------------------------
+
+void OpenGLFrontend::DrawQuad( GPUQuad& DrawnQuad )
+{
+    Video.AddQuadToQueue( DrawnQuad );
+}
+
+// -----------------------------------------------------------------------------
+
+void OpenGLFrontend::SetMultiplyColor( GPUColor NewMultiplyColor )
+{
+    // GPU colors are not directly comparable so use words
+    V32Word New, Old;
+    New.AsColor = NewMultiplyColor;
+    Old.AsColor = Video.GetMultiplyColor();
+    
+    // set multiply color only when needed, so that
+    // quad groups are not broken without need
+    if( New.AsInteger != Old.AsInteger )
+      Video.SetMultiplyColor( NewMultiplyColor );
+}
+
+// -----------------------------------------------------------------------------
+
+void OpenGLFrontend::SetBlendingMode( int NewBlendingMode )
+{
+    if( NewBlendingMode != (int)Video.GetBlendingMode() )
+      Video.SetBlendingMode( (IOPortValues)NewBlendingMode );
+}
+
+// -----------------------------------------------------------------------------
+
+void OpenGLFrontend::SelectTexture( int GPUTextureID )
+{
+    if( GPUTextureID != Video.GetSelectedTexture() )
+      Video.SelectTexture( GPUTextureID );
+}
+
+// -----------------------------------------------------------------------------
+
+void OpenGLFrontend::LoadTexture( int GPUTextureID, void* Pixels, int Width, int Height )
+{
+    Video.LoadTexture( GPUTextureID, Pixels, Width, Height );
+}
+
+// -----------------------------------------------------------------------------
+
+void OpenGLFrontend::UnloadCartridgeTextures()
+{
+    Video.UnloadCartridgeTextures();
+}
+
+// -----------------------------------------------------------------------------
+
+void OpenGLFrontend::UnloadBiosTexture()
+{
+    Video.UnloadTexture( -1 );
+}
+
+// -----------------------------------------------------------------------------
+
+void OpenGLFrontend::LogLine( const string& Message )
+{
+    LOG( Message );
+}
+
+// -----------------------------------------------------------------------------
+
+void OpenGLFrontend::ThrowException( const string& Message )
+{
+    THROW( Message );
+}
+
+
+// =============================================================================
+//      STATISTICS FRONTEND
+// =============================================================================
+
+
+StatisticsFrontend::StatisticsFrontend( VirconFrontendInterface& TargetFrontend )
+:   Target( TargetFrontend )
+{
+    ResetCounts();
+}
+
+// -----------------------------------------------------------------------------
+
+void StatisticsFrontend::ResetCounts()
+{
+    DrawnQuads = 0;
+    ClearedScreens = 0;
+    StateChanges = 0;
+    DrawnPixels = 0;
+}
+
+// -----------------------------------------------------------------------------
+
+void StatisticsFrontend::ClearScreen( GPUColor ClearColor )
+{
+    ClearedScreens++;
+    DrawnPixels += Constants::ScreenPixels;
+    Target.ClearScreen( ClearColor );
+}
+
+// -----------------------------------------------------------------------------
+
+void StatisticsFrontend::DrawQuad( GPUQuad& DrawnQuad )
+{
+    DrawnQuads++;
+    DrawnPixels += GetVisibleArea( DrawnQuad );
+    Target.DrawQuad( DrawnQuad );
+}
+
+// -----------------------------------------------------------------------------
+
+void StatisticsFrontend::SetMultiplyColor( GPUColor NewMultiplyColor )
+{
+    StateChanges++;
+    Target.SetMultiplyColor( NewMultiplyColor );
+}
+
+// -----------------------------------------------------------------------------
+
+void StatisticsFrontend::SetBlendingMode( int NewBlendingMode )
+{
+    StateChanges++;
+    Target.SetBlendingMode( NewBlendingMode );
+}
+
+// -----------------------------------------------------------------------------
+
+void StatisticsFrontend::SelectTexture( int GPUTextureID )
+{
+    StateChanges++;
+    Target.SelectTexture( GPUTextureID );
+}
+
+// -----------------------------------------------------------------------------
+
+void StatisticsFrontend::LoadTexture( int GPUTextureID, void* Pixels, int Width, int Height )
+{
+    Target.LoadTexture( GPUTextureID, Pixels, Width, Height );
+}
+
+// -----------------------------------------------------------------------------
+
+void StatisticsFrontend::UnloadCartridgeTextures()
+{
+    Target.UnloadCartridgeTextures();
+}
+
+// -----------------------------------------------------------------------------
+
+void StatisticsFrontend::UnloadBiosTexture()
+{
+    Target.UnloadBiosTexture();
+}
+
+// -----------------------------------------------------------------------------
+
+void StatisticsFrontend::LogLine( const string& Message )
+{
+    Target.LogLine( Message );
+}
+
+// -----------------------------------------------------------------------------
+
+void StatisticsFrontend::ThrowException( const string& Message )
+{
+    Target.ThrowException( Message );
+}
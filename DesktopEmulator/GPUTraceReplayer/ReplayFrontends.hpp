@@ -0,0 +1,99 @@
+// *****************************************************************************
+    // start include guard
+    #ifndef REPLAYFRONTENDS_HPP
+    #define REPLAYFRONTENDS_HPP
+    
+    // include console logic headers
+    #include "ConsoleLogic/ExternalInterfaces.hpp"
+    
+    // include emulator headers
+    #include "Emulator/VideoOutput.hpp"
+    
+    // include C/C++ headers
+    #include <cstdint>          // [ ANSI C ] Standard integer types
+// *****************************************************************************
+
+
+// =============================================================================
+//      FRONTEND FOR OPENGL VIDEO OUTPUT
+// =============================================================================
+
+
+// sends the trace to the same video output that
+// the emulator uses, in the same way it does
+class OpenGLFrontend: public V32::VirconFrontendInterface
+{
+    private:
+        
+        VideoOutput& Video;
+        
+    public:
+        
+        // instance handling
+        OpenGLFrontend( VideoOutput& TargetVideo );
+        
+        // video functions callable by the console
+        void ClearScreen( V32::GPUColor ClearColor ) override;
+        void DrawQuad( V32::GPUQuad& DrawnQuad ) override;
+        void SetMultiplyColor( V32::GPUColor NewMultiplyColor ) override;
+        void SetBlendingMode( int NewBlendingMode ) override;
+        void SelectTexture( int GPUTextureID ) override;
+        void LoadTexture( int GPUTextureID, void* Pixels, int Width, int Height ) override;
+        void UnloadCartridgeTextures() override;
+        void UnloadBiosTexture() override;
+        
+        // log functions callable by the console
+        void LogLine( const std::string& Message ) override;
+        void ThrowException( const std::string& Message ) override;
+};
+
+
+// =============================================================================
+//      FRONTEND TO MEASURE THE RENDERED WORK
+// =============================================================================
+
+
+// counts what is sent to the actual renderer, so that
+// statistics do not depend on how each renderer works;
+// drawn pixels are the areas of quads within the screen
+// (counting overlaps), which gives the fill rate needed
+class StatisticsFrontend: public V32::VirconFrontendInterface
+{
+    private:
+        
+        V32::VirconFrontendInterface& Target;
+        
+    public:
+        
+        // totals since the last reset
+        int64_t DrawnQuads;
+        int64_t ClearedScreens;
+        int64_t StateChanges;
+        double DrawnPixels;
+        
+    public:
+        
+        // instance handling
+        StatisticsFrontend( V32::VirconFrontendInterface& TargetFrontend );
+        void ResetCounts();
+        
+        // video functions callable by the console
+        void ClearScreen( V32::GPUColor ClearColor ) override;
+        void DrawQuad( V32::GPUQuad& DrawnQuad ) override;
+        void SetMultiplyColor( V32::GPUColor NewMultiplyColor ) override;
+        void SetBlendingMode( int NewBlendingMode ) override;
+        void SelectTexture( int GPUTextureID ) override;
+        void LoadTexture( int GPUTextureID, void* Pixels, int Width, int Height ) override;
+        void UnloadCartridgeTextures() override;
+        void UnloadBiosTexture() override;
+        
+        // log functions callable by the console
+        void LogLine( const std::string& Message ) override;
+        void ThrowException( const std::string& Message ) override;
+};
+
+
+// *****************************************************************************
+    // end include guard
+    #endif
+// *****************************************************************************
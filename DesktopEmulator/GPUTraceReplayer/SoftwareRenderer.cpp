@@ -0,0 +1,299 @@
+// *****************************************************************************
+    // include common Vircon headers
+    #include "../VirconDefinitions/Enumerations.hpp"
+    
+    // include infrastructure headers
+    #include "DesktopInfrastructure/NumericFunctions.hpp"
+    #include "DesktopInfrastructure/Logger.hpp"
+    
+    // include project headers
+    #include "SoftwareRenderer.hpp"
+    
+    // include C/C++ headers
+    #include <algorithm>        // [ C++ STL ] Algorithms
+    #include <cstring>          // [ ANSI C ] Strings
+    #include <cmath>            // [ ANSI C ] Mathematics
+    
+    // declare used namespaces
+    using namespace std;
+    using namespace V32;
+// *****************************************************************************
+
+
+// =============================================================================
+//      AUXILIARY FUNCTIONS FOR RASTERIZATION
+// =============================================================================
+
+
+// positive when point P is to the same side of
+// the edge from A to B as the triangle interior
+// (once triangles are given in the same winding)
+static inline double EdgeFunction( const GPUPoint& A, const GPUPoint& B, double PX, double PY )
+{
+    return (B.x - A.x) * (PY - A.y) - (B.y - A.y) * (PX - A.x);
+}
+
+// -----------------------------------------------------------------------------
+
+// pixels exactly on an edge belong to only one of the
+// 2 triangles sharing it; since the shared edge goes in
+// opposite directions for each, only 1 of them owns it
+static inline bool OwnsEdgePixels( const GPUPoint& A, const GPUPoint& B )
+{
+    return (B.y > A.y) || (B.y == A.y && B.x > A.x);
+}
+
+// -----------------------------------------------------------------------------
+
+static inline bool IsInsideEdge( double Edge, bool OwnsEdge )
+{
+    return (Edge > 0) || (Edge == 0 && OwnsEdge);
+}
+
+// -----------------------------------------------------------------------------
+
+// products of 8-bit color components, rounded
+static inline int MultiplyComponents( int A, int B )
+{
+    return (A * B + 127) / 255;
+}
+
+
+// =============================================================================
+//      SOFTWARE RENDERER: INSTANCE HANDLING
+// =============================================================================
+
+
+SoftwareRenderer::SoftwareRenderer()
+{
+    BiosTexture.Width = BiosTexture.Height = 0;
+    
+    for( SoftwareTexture& Texture: CartridgeTextures )
+      Texture.Width = Texture.Height = 0;
+    
+    // same initial state as video output
+    SelectedTexture = -1;
+    MultiplyColor = GPUColor{ 255, 255, 255, 255 };
+    BlendingMode = (int)IOPortValues::GPUBlendingMode_Alpha;
+    
+    Framebuffer.resize( Constants::ScreenPixels, GPUColor{ 0, 0, 0, 255 } );
+}
+
+
+// =============================================================================
+//      SOFTWARE RENDERER: AUXILIARY RENDER FUNCTIONS
+// =============================================================================
+
+
+SoftwareTexture& SoftwareRenderer::GetTexture( int GPUTextureID )
+{
+    if( GPUTextureID >= 0 )
+      return CartridgeTextures[ GPUTextureID ];
+    
+    return BiosTexture;
+}
+
+// -----------------------------------------------------------------------------
+
+// source alpha is always the source factor, and
+// only the destination factor and operation vary
+void SoftwareRenderer::DrawPixel( GPUColor& Destination, GPUColor Source )
+{
+    uint8_t* D = &Destination.R;
+    const uint8_t* S = &Source.R;
+    int SourceAlpha = Source.A;
+    
+    if( BlendingMode == (int)IOPortValues::GPUBlendingMode_Alpha )
+    {
+        for( int i = 0; i < 4; i++ )
+          D[ i ] = (S[ i ] * SourceAlpha + D[ i ] * (255 - SourceAlpha) + 127) / 255;
+    }
+    
+    else if( BlendingMode == (int)IOPortValues::GPUBlendingMode_Add )
+    {
+        for( int i = 0; i < 4; i++ )
+          D[ i ] = min( 255, D[ i ] + MultiplyComponents( S[ i ], SourceAlpha ) );
+    }
+    
+    // subtraction is reversed: source from destination
+    else
+    {
+        for( int i = 0; i < 4; i++ )
+          D[ i ] = max( 0, D[ i ] - MultiplyComponents( S[ i ], SourceAlpha ) );
+    }
+}
+
+// -----------------------------------------------------------------------------
+
+// all pixels whose center is within the triangle are
+// drawn, sampling textures like the fragment shader does
+void SoftwareRenderer::DrawTriangle( const GPUPoint& V0, const GPUPoint& V1, const GPUPoint& V2 )
+{
+    // use the same winding for all triangles
+    const GPUPoint* A = &V0;
+    const GPUPoint* B = &V1;
+    const GPUPoint* C = &V2;
+    double Area = EdgeFunction( *A, *B, C->x, C->y );
+    
+    if( Area == 0 )
+      return;
+    
+    if( Area < 0 )
+    {
+        swap( B, C );
+        Area = -Area;
+    }
+    
+    bool OwnsAB = OwnsEdgePixels( *A, *B );
+    bool OwnsBC = OwnsEdgePixels( *B, *C );
+    bool OwnsCA = OwnsEdgePixels( *C, *A );
+    
+    // only check pixels within the bounding box
+    int MinX = max( 0, (int)floor( min( { A->x, B->x, C->x } ) ) );
+    int MinY = max( 0, (int)floor( min( { A->y, B->y, C->y } ) ) );
+    int MaxX = min( Constants::ScreenWidth - 1, (int)ceil( max( { A->x, B->x, C->x } ) ) );
+    int MaxY = min( Constants::ScreenHeight - 1, (int)ceil( max( { A->y, B->y, C->y } ) ) );
+    
+    const SoftwareTexture& Texture = GetTexture( SelectedTexture );
+    
+    for( int y = MinY; y <= MaxY; y++ )
+    {
+        double PY = y + 0.5;
+        GPUColor* Row = &Framebuffer[ y * Constants::ScreenWidth ];
+        
+        for( int x = MinX; x <= MaxX; x++ )
+        {
+            double PX = x + 0.5;
+            double EdgeAB = EdgeFunction( *A, *B, PX, PY );
+            double EdgeBC = EdgeFunction( *B, *C, PX, PY );
+            double EdgeCA = EdgeFunction( *C, *A, PX, PY );
+            
+            if( !IsInsideEdge( EdgeAB, OwnsAB )
+            ||  !IsInsideEdge( EdgeBC, OwnsBC )
+            ||  !IsInsideEdge( EdgeCA, OwnsCA ) )
+              continue;
+            
+            // interpolate texture coordinates
+            double WeightA = EdgeBC / Area;
+            double WeightB = EdgeCA / Area;
+            double WeightC = EdgeAB / Area;
+            double TextureX = WeightA * A->texture_x + WeightB * B->texture_x + WeightC * C->texture_x;
+            double TextureY = WeightA * A->texture_y + WeightB * B->texture_y + WeightC * C->texture_y;
+            
+            // select a texel relative to the full 1024x1024 texture
+            int TexelX = (int)floor( TextureX * Constants::GPUTextureSize );
+            int TexelY = (int)floor( TextureY * Constants::GPUTextureSize );
+            Clamp( TexelX, 0, Constants::GPUTextureSize - 1 );
+            Clamp( TexelY, 0, Constants::GPUTextureSize - 1 );
+            
+            // texels outside the loaded image are transparent black
+            GPUColor Texel = { 0, 0, 0, 0 };
+            
+            if( TexelX < Texture.Width && TexelY < Texture.Height )
+            {
+                Texel = Texture.Pixels[ TexelY * Texture.Width + TexelX ];
+                Texel.R = MultiplyComponents( Texel.R, MultiplyColor.R );
+                Texel.G = MultiplyComponents( Texel.G, MultiplyColor.G );
+                Texel.B = MultiplyComponents( Texel.B, MultiplyColor.B );
+                Texel.A = MultiplyComponents( Texel.A, MultiplyColor.A );
+            }
+            
+            DrawPixel( Row[ x ], Texel );
+        }
+    }
+}
+
+
+// =============================================================================
+//      SOFTWARE RENDERER: FRONTEND FUNCTIONS
+// =============================================================================
+
+
+// like in video output, the clear color is
+// applied to the whole screen as a quad would
+void SoftwareRenderer::ClearScreen( GPUColor ClearColor )
+{
+    for( GPUColor& Pixel: Framebuffer )
+      DrawPixel( Pixel, ClearColor );
+}
+
+// -----------------------------------------------------------------------------
+
+// quads are split in 2 triangles like in video output
+void SoftwareRenderer::DrawQuad( GPUQuad& DrawnQuad )
+{
+    const GPUPoint* Vertices = DrawnQuad.Vertices;
+    DrawTriangle( Vertices[ 0 ], Vertices[ 1 ], Vertices[ 2 ] );
+    DrawTriangle( Vertices[ 1 ], Vertices[ 2 ], Vertices[ 3 ] );
+}
+
+// -----------------------------------------------------------------------------
+
+void SoftwareRenderer::SetMultiplyColor( GPUColor NewMultiplyColor )
+{
+    MultiplyColor = NewMultiplyColor;
+}
+
+// -----------------------------------------------------------------------------
+
+void SoftwareRenderer::SetBlendingMode( int NewBlendingMode )
+{
+    // ignore invalid values
+    if( NewBlendingMode != (int)IOPortValues::GPUBlendingMode_Alpha
+    &&  NewBlendingMode != (int)IOPortValues::GPUBlendingMode_Add
+    &&  NewBlendingMode != (int)IOPortValues::GPUBlendingMode_Subtract )
+      return;
+    
+    BlendingMode = NewBlendingMode;
+}
+
+// -----------------------------------------------------------------------------
+
+void SoftwareRenderer::SelectTexture( int GPUTextureID )
+{
+    SelectedTexture = GPUTextureID;
+}
+
+// -----------------------------------------------------------------------------
+
+void SoftwareRenderer::LoadTexture( int GPUTextureID, void* Pixels, int Width, int Height )
+{
+    SoftwareTexture& Texture = GetTexture( GPUTextureID );
+    Texture.Width = Width;
+    Texture.Height = Height;
+    Texture.Pixels.resize( Width * Height );
+    memcpy( Texture.Pixels.data(), Pixels, Width * Height * 4 );
+}
+
+// -----------------------------------------------------------------------------
+
+void SoftwareRenderer::UnloadCartridgeTextures()
+{
+    for( SoftwareTexture& Texture: CartridgeTextures )
+    {
+        Texture.Width = Texture.Height = 0;
+        Texture.Pixels.clear();
+    }
+}
+
+// -----------------------------------------------------------------------------
+
+void SoftwareRenderer::UnloadBiosTexture()
+{
+    BiosTexture.Width = BiosTexture.Height = 0;
+    BiosTexture.Pixels.clear();
+}
+
+// -----------------------------------------------------------------------------
+
+void SoftwareRenderer::LogLine( const string& Message )
+{
+    LOG( Message );
+}
+
+// -----------------------------------------------------------------------------
+
+void SoftwareRenderer::ThrowException( const string& Message )
+{
+    THROW( Message );
+}
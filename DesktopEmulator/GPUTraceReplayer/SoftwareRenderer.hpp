@@ -0,0 +1,88 @@
+// *****************************************************************************
+    // start include guard
+    #ifndef SOFTWARERENDERER_HPP
+    #define SOFTWARERENDERER_HPP
+    
+    // include common Vircon headers
+    #include "../VirconDefinitions/DataStructures.hpp"
+    #include "../VirconDefinitions/Constants.hpp"
+    
+    // include console logic headers
+    #include "ConsoleLogic/ExternalInterfaces.hpp"
+    
+    // include C/C++ headers
+    #include <vector>           // [ C++ STL ] Vectors
+// *****************************************************************************
+
+
+// =============================================================================
+//      TEXTURES IN THE SOFTWARE RENDERER
+// =============================================================================
+
+
+// as in video output, only the area of the loaded
+// image is kept, and anything outside is transparent
+typedef struct
+{
+    int Width, Height;      // 0 when not loaded
+    std::vector< V32::GPUColor > Pixels;
+}
+SoftwareTexture;
+
+
+// =============================================================================
+//      CLASS FOR SOFTWARE RENDERING
+// =============================================================================
+
+
+// A reference renderer that follows the same rules as the
+// shaders and blending modes of the emulator's video output,
+// working only on the CPU. Shared edges between triangles
+// are only drawn once, so results do not depend on the GPU
+// or drivers and can be compared between runs
+class SoftwareRenderer: public V32::VirconFrontendInterface
+{
+    private:
+        
+        SoftwareTexture BiosTexture;
+        SoftwareTexture CartridgeTextures[ V32::Constants::GPUMaximumCartridgeTextures ];
+        
+        // render state
+        int32_t SelectedTexture;
+        V32::GPUColor MultiplyColor;
+        int BlendingMode;
+        
+        SoftwareTexture& GetTexture( int GPUTextureID );
+        void DrawPixel( V32::GPUColor& Destination, V32::GPUColor Source );
+        void DrawTriangle( const V32::GPUPoint& V0, const V32::GPUPoint& V1, const V32::GPUPoint& V2 );
+        
+    public:
+        
+        // screen contents, starting from the top row
+        std::vector< V32::GPUColor > Framebuffer;
+        
+    public:
+        
+        // instance handling
+        SoftwareRenderer();
+        
+        // video functions callable by the console
+        void ClearScreen( V32::GPUColor ClearColor ) override;
+        void DrawQuad( V32::GPUQuad& DrawnQuad ) override;
+        void SetMultiplyColor( V32::GPUColor NewMultiplyColor ) override;
+        void SetBlendingMode( int NewBlendingMode ) override;
+        void SelectTexture( int GPUTextureID ) override;
+        void LoadTexture( int GPUTextureID, void* Pixels, int Width, int Height ) override;
+        void UnloadCartridgeTextures() override;
+        void UnloadBiosTexture() override;
+        
+        // log functions callable by the console
+        void LogLine( const std::string& Message ) override;
+        void ThrowException( const std::string& Message ) override;
+};
+
+
+// *****************************************************************************
+    // end include guard
+    #endif
+// *****************************************************************************
@@ -0,0 +1,471 @@
+// *****************************************************************************
+    // include common Vircon headers
+    #include "../VirconDefinitions/Constants.hpp"
+    
+    // include infrastructure headers
+    #include "DesktopInfrastructure/FilePaths.hpp"
+    #include "DesktopInfrastructure/Logger.hpp"
+    #include "DesktopInfrastructure/StringFunctions.hpp"
+    
+    // include console logic headers
+    #include "ConsoleLogic/V32Console.hpp"
+    
+    // include emulator headers
+    #include "Emulator/NetplaySession.hpp"
+    #include "Emulator/NetplayTransport.hpp"
+    
+    // include C/C++ headers
+    #include <string>           // [ C++ STL ] Strings
+    #include <iostream>         // [ C++ STL ] I/O Streams
+    #include <stdexcept>        // [ C++ STL ] Exceptions
+    #include <vector>           // [ C++ STL ] Vectors
+    #include <memory>           // [ C++ STL ] Dynamic memory
+    #include <cstdio>           // [ ANSI C ] Standard I/O
+    #include <cstdlib>          // [ ANSI C ] Standard library
+    
+    // include SDL2 headers
+    #define SDL_MAIN_HANDLED
+    #include "SDL.h"            // [ SDL2 ] Main header
+    
+    // on Windows include headers for unicode conversion
+    #if defined(__WIN32__) || defined(_WIN32) || defined(_WIN64)
+      #define WINDOWS_OS
+      #include <windows.h>      // [ WINDOWS ] Main header
+      #include <shellapi.h>     // [ WINDOWS ] Shell API
+    #endif
+    
+    // declare used namespaces
+    using namespace std;
+    using namespace V32;
+// *****************************************************************************
+
+
+// =============================================================================
+//      GLOBAL VARIABLES
+// =============================================================================
+
+
+bool VerboseMode = false;
+int NumberOfFrames = 600;
+int LatencyMS = 0;
+int JitterMS = 0;
+int LossPercentage = 0;
+int CorruptedFrame = -1;
+
+
+// =============================================================================
+//      FRONTEND FOR CONSOLES WITHOUT OUTPUT
+// =============================================================================
+
+
+// both consoles run in the same process, and
+// none of them needs to show video or play audio
+class HeadlessFrontend: public VirconFrontendInterface
+{
+    public:
+        
+        // video functions callable by the console
+        void ClearScreen( GPUColor ClearColor ) override {}
+        void DrawQuad( GPUQuad& DrawnQuad ) override {}
+        void SetMultiplyColor( GPUColor NewMultiplyColor ) override {}
+        void SetBlendingMode( int NewBlendingMode ) override {}
+        void SelectTexture( int GPUTextureID ) override {}
+        void LoadTexture( int GPUTextureID, void* Pixels, int Width, int Height ) override {}
+        void UnloadCartridgeTextures() override {}
+        void UnloadBiosTexture() override {}
+        
+        // log functions callable by the console
+        void LogLine( const string& Message ) override { LOG( Message ); }
+        void ThrowException( const string& Message ) override { THROW( Message ); }
+};
+
+
+// =============================================================================
+//      PLAYERS IN THE SESSION
+// =============================================================================
+
+
+// each player has its own console, which holds
+// that player's gamepad in its first port
+class NetplayTester
+{
+    public:
+        
+        string Name;
+        HeadlessFrontend Frontend;
+        V32Console Console;
+        LoopbackTransport* Transport;
+        unique_ptr< NetplaySession > Session;
+        
+        // inputs change randomly, but the same way in every run
+        uint32_t RandomState;
+        int32_t WaitedSteps;
+        
+    public:
+        
+        NetplayTester( const string& PlayerName, uint32_t RandomSeed );
+        void Start( const string& BiosPath, const string& CartridgePath, bool Host );
+        void ChangeInputs();
+        void PrintResults();
+};
+
+// -----------------------------------------------------------------------------
+
+NetplayTester::NetplayTester( const string& PlayerName, uint32_t RandomSeed )
+{
+    Name = PlayerName;
+    Transport = new LoopbackTransport( LatencyMS, JitterMS, LossPercentage );
+    RandomState = RandomSeed;
+    WaitedSteps = 0;
+    
+    Console.SetFrontend( &Frontend );
+}
+
+// -----------------------------------------------------------------------------
+
+// transports must be connected before starting
+void NetplayTester::Start( const string& BiosPath, const string& CartridgePath, bool Host )
+{
+    Console.LoadBios( BiosPath );
+    Console.LoadCartridge( CartridgePath );
+    Console.SetPower( true );
+    Console.SetGamepadConnection( 0, true );
+    
+    Session.reset( new NetplaySession( Console, Transport, Host ) );
+}
+
+// -----------------------------------------------------------------------------
+
+// presses or releases a control about every 4 frames
+void NetplayTester::ChangeInputs()
+{
+    RandomState = RandomState * 1103515245u + 12345u;
+    uint32_t RandomValue = RandomState >> 8;
+    
+    if( RandomValue % 4 )
+      return;
+    
+    GamepadControls Control = (GamepadControls)((RandomValue >> 4) % 11);
+    bool Pressed = (RandomValue >> 8) & 1;
+    Console.SetGamepadControl( 0, Control, Pressed );
+}
+
+// -----------------------------------------------------------------------------
+
+void NetplayTester::PrintResults()
+{
+    const char* StateNames[] = { "connecting", "running", "disconnected" };
+    int32_t RolledBackFrames = Session->GetRolledBackFrames();
+    
+    printf( "%s: %s, frame %d\n", Name.c_str(), StateNames[ (int)Session->GetState() ], Session->GetCurrentFrame() );
+    printf( "  round trip: %.1f ms\n", Session->GetRoundTripTime() );
+    printf( "  waits: %d steps\n", WaitedSteps );
+    printf( "  rolled back: %d frames (max %d at once)", RolledBackFrames, Session->GetMaximumRollback() );
+    
+    if( RolledBackFrames > 0 )
+      printf( ", %.3f ms per frame", 1000 * Session->GetRollbackTime() / RolledBackFrames );
+    
+    printf( "\n" );
+    
+    if( Session->GetDesyncFrame() >= 0 )
+      printf( "  desync detected at frame %d\n", Session->GetDesyncFrame() );
+}
+
+
+// =============================================================================
+//      AUXILIARY FUNCTIONS
+// =============================================================================
+
+
+void PrintUsage()
+{
+    cout << "USAGE: TestNetplay [options] file" << endl;
+    cout << "File: a cartridge that both players will run" << endl;
+    cout << "Options:" << endl;
+    cout << "  --help       Displays this information" << endl;
+    cout << "  --version    Displays program version" << endl;
+    cout << "  -b <file>    BIOS to use, default is the standard BIOS" << endl;
+    cout << "  -f <frames>  Number of frames to run, default is 600" << endl;
+    cout << "  -l <ms>      Latency for datagrams, default is 0" << endl;
+    cout << "  -j <ms>      Random variation in latency, default is 0" << endl;
+    cout << "  -p <percent> Percentage of datagrams lost, default is 0" << endl;
+    cout << "  -d <frame>   Changes the guest's RAM at that frame, to test desync detection" << endl;
+    cout << "  -v           Displays progress every 60 frames (verbose)" << endl;
+}
+
+// -----------------------------------------------------------------------------
+
+void PrintVersion()
+{
+    cout << "TestNetplay v25.2.2" << endl;
+    cout << "Netplay tester for Vircon32 emulator" << endl;
+}
+
+// -----------------------------------------------------------------------------
+
+// use this funcion to get the executable path
+// in a portable way (can't be done without libraries)
+string GetProgramFolder()
+{
+    if( SDL_Init( 0 ) )
+      THROW( "cannot initialize SDL" );
+    
+    char* SDLString = SDL_GetBasePath();
+    string Result = SDLString;
+    
+    SDL_free( SDLString );
+    SDL_Quit();
+    
+    return Result;
+}
+
+// -----------------------------------------------------------------------------
+
+// reads the number after an option
+int GetOptionNumber( const vector< string >& Arguments, int& Position, int Minimum )
+{
+    string Option = Arguments[ Position ];
+    Position++;
+    
+    if( Position >= (int)Arguments.size() )
+      throw runtime_error( string("missing number after '") + Option + "'" );
+    
+    int Number = atoi( Arguments[ Position ].c_str() );
+    
+    if( Number < Minimum )
+      throw runtime_error( string("number after '") + Option + "' must be at least " + to_string( Minimum ) );
+    
+    return Number;
+}
+
+
+// =============================================================================
+//      MAIN FUNCTION
+// =============================================================================
+
+
+int main( int NumberOfArguments, char* Arguments[] )
+{
+    try
+    {
+        // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+        // Process command line arguments
+        
+        // variables to capture input parameters
+        string InputPath, BiosPath;
+        
+        // to treat arguments the same in any OS we
+        // will convert them to UTF-8 in all cases
+        vector< string > ArgumentsUTF8;
+        
+        #if defined(WINDOWS_OS)
+          
+          // on Windows we can't rely on the arguments received
+          // in main: ask Windows for the UTF-16 command line
+          wchar_t* CommandLineUTF16 = GetCommandLineW();
+          wchar_t** ArgumentsUTF16 = CommandLineToArgvW( CommandLineUTF16, &NumberOfArguments );
+          
+          // now convert every program argument to UTF-8
+          for( int i = 0; i < NumberOfArguments; i++ )
+            ArgumentsUTF8.push_back( ToUTF8( ArgumentsUTF16[i] ) );
+          
+          LocalFree( ArgumentsUTF16 );
+        
+        #else
+          
+          // on Linux/Mac arguments in main are already UTF-8
+          for( int i = 0; i < NumberOfArguments; i++ )
+            ArgumentsUTF8.push_back( Arguments[i] );
+        
+        #endif
+        
+        // process arguments
+        for( int i = 1; i < NumberOfArguments; i++ )
+        {
+            if( ArgumentsUTF8[i] == string("--help") )
+            {
+                PrintUsage();
+                return 0;
+            }
+            
+            if( ArgumentsUTF8[i] == string("--version") )
+            {
+                PrintVersion();
+                return 0;
+            }
+            
+            if( ArgumentsUTF8[i] == string("-v") )
+            {
+                VerboseMode = true;
+                continue;
+            }
+            
+            if( ArgumentsUTF8[i] == string("-b") )
+            {
+                // expect another argument
+                i++;
+                
+                if( i >= NumberOfArguments )
+                  throw runtime_error( "missing BIOS file after '-b'" );
+                
+                BiosPath = ArgumentsUTF8[ i ];
+                continue;
+            }
+            
+            if( ArgumentsUTF8[i] == string("-f") )
+            {
+                NumberOfFrames = GetOptionNumber( ArgumentsUTF8, i, 1 );
+                continue;
+            }
+            
+            if( ArgumentsUTF8[i] == string("-l") )
+            {
+                LatencyMS = GetOptionNumber( ArgumentsUTF8, i, 0 );
+                continue;
+            }
+            
+            if( ArgumentsUTF8[i] == string("-j") )
+            {
+                JitterMS = GetOptionNumber( ArgumentsUTF8, i, 0 );
+                continue;
+            }
+            
+            if( ArgumentsUTF8[i] == string("-p") )
+            {
+                LossPercentage = GetOptionNumber( ArgumentsUTF8, i, 0 );
+                
+                if( LossPercentage > 100 )
+                  throw runtime_error( "loss percentage cannot be over 100" );
+                
+                continue;
+            }
+            
+            if( ArgumentsUTF8[i] == string("-d") )
+            {
+                CorruptedFrame = GetOptionNumber( ArgumentsUTF8, i, 0 );
+                continue;
+            }
+            
+            // discard any other parameters starting with '-'
+            if( ArgumentsUTF8[i][0] == '-' )
+              throw runtime_error( string("unrecognized command line option '") + ArgumentsUTF8[i] + "'" );
+            
+            // any non-option parameter is taken as the input file
+            if( InputPath.empty() )
+            {
+                InputPath = ArgumentsUTF8[i];
+            }
+            
+            // only a single input file is supported!
+            else
+              throw runtime_error( "too many input files, only 1 is supported" );
+        }
+        
+        // check if an input path was given
+        if( InputPath.empty() )
+          throw runtime_error( "no input file" );
+        
+        // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+        // STEP 1: Connect both players
+        
+        // sessions report their events in the log
+        string ProgramFolder = GetProgramFolder();
+        LOG_TO_FILE( ProgramFolder + "TestNetplayLog" );
+        
+        if( BiosPath.empty() )
+          BiosPath = ProgramFolder + "Bios" + PathSeparator + "StandardBios.v32";
+        
+        if( SDL_Init( SDL_INIT_TIMER ) != 0 )
+          THROW( string("Cannot initialize SDL: ") + SDL_GetError() );
+        
+        // each console is large, so they are not on the stack
+        unique_ptr< NetplayTester > Host( new NetplayTester( "host", 1 ) );
+        unique_ptr< NetplayTester > Guest( new NetplayTester( "guest", 2 ) );
+        Host->Transport->Connect( *Guest->Transport );
+        
+        Host->Start( BiosPath, InputPath, true );
+        Guest->Start( BiosPath, InputPath, false );
+        NetplayTester* Players[ 2 ] = { Host.get(), Guest.get() };
+        
+        // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+        // STEP 2: Run both sessions at 60 fps
+        
+        // connecting and waits can take some steps
+        // beyond the frames, but not indefinitely;
+        // both keep running until the last one ends,
+        // since each one needs inputs from the other
+        int MaximumSteps = 2 * NumberOfFrames + 600;
+        Uint32 StartTicks = SDL_GetTicks();
+        bool Finished = false;
+        
+        for( int Step = 0; Step < MaximumSteps && !Finished; Step++ )
+        {
+            for( NetplayTester* Player: Players )
+            {
+                Player->ChangeInputs();
+                
+                bool FrameWasRun = Player->Session->RunNextFrame( false, false );
+                
+                if( !FrameWasRun && Player->Session->GetState() == NetplayStates::Running )
+                  Player->WaitedSteps++;
+                
+                if( Player->Session->GetState() == NetplayStates::Disconnected )
+                  THROW( Player->Name + " was disconnected" );
+            }
+            
+            Finished = (Host->Session->GetCurrentFrame() >= NumberOfFrames && Guest->Session->GetCurrentFrame() >= NumberOfFrames);
+            
+            // a single change is enough to desync
+            if( Guest->Session->GetCurrentFrame() == CorruptedFrame )
+            {
+                V32Word Value;
+                Value.AsInteger = 12345;
+                Guest->Console.RAM.WriteAddress( Constants::RAMSize - 1, Value );
+                CorruptedFrame = -1;
+            }
+            
+            if( VerboseMode && !(Step % 60) )
+              printf( "step %d: host frame %d, guest frame %d\n", Step, Host->Session->GetCurrentFrame(), Guest->Session->GetCurrentFrame() );
+            
+            // both sessions measure time, so pace steps as frames
+            Uint32 NextStepTicks = StartTicks + (Uint32)((Step + 1) * 1000.0 / Constants::FramesPerSecond);
+            
+            while( SDL_GetTicks() < NextStepTicks )
+              SDL_Delay( 1 );
+        }
+        
+        // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+        // STEP 3: Report results
+        
+        printf( "network: %d ms latency, %d ms jitter, %d%% loss\n", LatencyMS, JitterMS, LossPercentage );
+        Host->PrintResults();
+        Guest->PrintResults();
+        
+        bool Desynced = (Host->Session->GetDesyncFrame() >= 0 || Guest->Session->GetDesyncFrame() >= 0);
+        
+        if( !Finished )
+          cout << "TestNetplay: sessions did not reach frame " << NumberOfFrames << endl;
+        
+        else if( Desynced )
+          cout << "TestNetplay: consoles are not synchronized" << endl;
+        
+        else
+          cout << "TestNetplay: consoles stayed synchronized" << endl;
+        
+        // clean-up in reverse order
+        Guest.reset();
+        Host.reset();
+        SDL_Quit();
+        
+        if( !Finished || Desynced )
+          return 1;
+    }
+    
+    catch( const exception& e )
+    {
+        cerr << "TestNetplay: error: " << e.what() << endl;
+        return 1;
+    }
+    
+    return 0;
+}
@@ -0,0 +1,320 @@
+// *****************************************************************************
+    // include common Vircon headers
+    #include "../VirconDefinitions/Constants.hpp"
+    
+    // include infrastructure headers
+    #include "DesktopInfrastructure/FilePaths.hpp"
+    #include "DesktopInfrastructure/Logger.hpp"
+    #include "DesktopInfrastructure/StringFunctions.hpp"
+    
+    // include console logic headers
+    #include "ConsoleLogic/V32Console.hpp"
+    
+    // include C/C++ headers
+    #include <string>           // [ C++ STL ] Strings
+    #include <iostream>         // [ C++ STL ] I/O Streams
+    #include <stdexcept>        // [ C++ STL ] Exceptions
+    #include <vector>           // [ C++ STL ] Vectors
+    #include <memory>           // [ C++ STL ] Dynamic memory
+    #include <cstdio>           // [ ANSI C ] Standard I/O
+    #include <cstdlib>          // [ ANSI C ] Standard library
+    
+    // include SDL2 headers
+    #define SDL_MAIN_HANDLED
+    #include "SDL.h"            // [ SDL2 ] Main header
+    
+    // on Windows include headers for unicode conversion
+    #if defined(__WIN32__) || defined(_WIN32) || defined(_WIN64)
+      #define WINDOWS_OS
+      #include <windows.h>      // [ WINDOWS ] Main header
+      #include <shellapi.h>     // [ WINDOWS ] Shell API
+    #endif
+    
+    // declare used namespaces
+    using namespace std;
+    using namespace V32;
+// *****************************************************************************
+
+
+// =============================================================================
+//      GLOBAL VARIABLES
+// =============================================================================
+
+
+bool VerboseMode = false;
+int MaximumFrames = 600;
+bool CheckResult = false;
+int32_t ExpectedResult = 0;
+
+
+// =============================================================================
+//      FRONTEND FOR A CONSOLE WITHOUT OUTPUT
+// =============================================================================
+
+
+// tested programs only compute a result,
+// so there is no video or audio to show
+class HeadlessFrontend: public VirconFrontendInterface
+{
+    public:
+        
+        // video functions callable by the console
+        void ClearScreen( GPUColor ClearColor ) override {}
+        void DrawQuad( GPUQuad& DrawnQuad ) override {}
+        void SetMultiplyColor( GPUColor NewMultiplyColor ) override {}
+        void SetBlendingMode( int NewBlendingMode ) override {}
+        void SelectTexture( int GPUTextureID ) override {}
+        void LoadTexture( int GPUTextureID, void* Pixels, int Width, int Height ) override {}
+        void UnloadCartridgeTextures() override {}
+        void UnloadBiosTexture() override {}
+        
+        // log functions callable by the console
+        void LogLine( const string& Message ) override { LOG( Message ); }
+        void ThrowException( const string& Message ) override { THROW( Message ); }
+};
+
+
+// =============================================================================
+//      AUXILIARY FUNCTIONS
+// =============================================================================
+
+
+void PrintUsage()
+{
+    cout << "USAGE: TestProgram [options] file" << endl;
+    cout << "File: a cartridge whose program ends with hlt" << endl;
+    cout << "Options:" << endl;
+    cout << "  --help       Displays this information" << endl;
+    cout << "  --version    Displays program version" << endl;
+    cout << "  -b <file>    BIOS to use, default is the standard BIOS" << endl;
+    cout << "  -f <frames>  Maximum frames to run, default is 600" << endl;
+    cout << "  -r <value>   Fails unless the program ends with R0 = value" << endl;
+    cout << "  -v           Displays additional information (verbose)" << endl;
+    cout << "The value left in R0 is the result of main() for" << endl;
+    cout << "programs built with the C compiler" << endl;
+}
+
+// -----------------------------------------------------------------------------
+
+void PrintVersion()
+{
+    cout << "TestProgram v25.2.2" << endl;
+    cout << "Program tester for Vircon32 emulator" << endl;
+}
+
+// -----------------------------------------------------------------------------
+
+// use this funcion to get the executable path
+// in a portable way (can't be done without libraries)
+string GetProgramFolder()
+{
+    if( SDL_Init( 0 ) )
+      THROW( "cannot initialize SDL" );
+    
+    char* SDLString = SDL_GetBasePath();
+    string Result = SDLString;
+    
+    SDL_free( SDLString );
+    SDL_Quit();
+    
+    return Result;
+}
+
+// -----------------------------------------------------------------------------
+
+// reads the number after an option
+int GetOptionNumber( const vector< string >& Arguments, int& Position, int Minimum )
+{
+    string Option = Arguments[ Position ];
+    Position++;
+    
+    if( Position >= (int)Arguments.size() )
+      throw runtime_error( string("missing number after '") + Option + "'" );
+    
+    int Number = atoi( Arguments[ Position ].c_str() );
+    
+    if( Number < Minimum )
+      throw runtime_error( string("number after '") + Option + "' must be at least " + to_string( Minimum ) );
+    
+    return Number;
+}
+
+
+// =============================================================================
+//      MAIN FUNCTION
+// =============================================================================
+
+
+int main( int NumberOfArguments, char* Arguments[] )
+{
+    try
+    {
+        // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+        // Process command line arguments
+        
+        // variables to capture input parameters
+        string InputPath, BiosPath;
+        
+        // to treat arguments the same in any OS we
+        // will convert them to UTF-8 in all cases
+        vector< string > ArgumentsUTF8;
+        
+        #if defined(WINDOWS_OS)
+          
+          // on Windows we can't rely on the arguments received
+          // in main: ask Windows for the UTF-16 command line
+          wchar_t* CommandLineUTF16 = GetCommandLineW();
+          wchar_t** ArgumentsUTF16 = CommandLineToArgvW( CommandLineUTF16, &NumberOfArguments );
+          
+          // now convert every program argument to UTF-8
+          for( int i = 0; i < NumberOfArguments; i++ )
+            ArgumentsUTF8.push_back( ToUTF8( ArgumentsUTF16[i] ) );
+          
+          LocalFree( ArgumentsUTF16 );
+        
+        #else
+          
+          // on Linux/Mac arguments in main are already UTF-8
+          for( int i = 0; i < NumberOfArguments; i++ )
+            ArgumentsUTF8.push_back( Arguments[i] );
+        
+        #endif
+        
+        // process arguments
+        for( int i = 1; i < NumberOfArguments; i++ )
+        {
+            if( ArgumentsUTF8[i] == string("--help") )
+            {
+                PrintUsage();
+                return 0;
+            }
+            
+            if( ArgumentsUTF8[i] == string("--version") )
+            {
+                PrintVersion();
+                return 0;
+            }
+            
+            if( ArgumentsUTF8[i] == string("-v") )
+            {
+                VerboseMode = true;
+                continue;
+            }
+            
+            if( ArgumentsUTF8[i] == string("-b") )
+            {
+                // expect another argument
+                i++;
+                
+                if( i >= NumberOfArguments )
+                  throw runtime_error( "missing BIOS file after '-b'" );
+                
+                BiosPath = ArgumentsUTF8[ i ];
+                continue;
+            }
+            
+            if( ArgumentsUTF8[i] == string("-f") )
+            {
+                MaximumFrames = GetOptionNumber( ArgumentsUTF8, i, 1 );
+                continue;
+            }
+            
+            // (results can be negative)
+            if( ArgumentsUTF8[i] == string("-r") )
+            {
+                ExpectedResult = GetOptionNumber( ArgumentsUTF8, i, INT32_MIN );
+                CheckResult = true;
+                continue;
+            }
+            
+            // discard any other parameters starting with '-'
+            if( ArgumentsUTF8[i][0] == '-' )
+              throw runtime_error( string("unrecognized command line option '") + ArgumentsUTF8[i] + "'" );
+            
+            // any non-option parameter is taken as the input file
+            if( InputPath.empty() )
+            {
+                InputPath = ArgumentsUTF8[i];
+            }
+            
+            // only a single input file is supported!
+            else
+              throw runtime_error( "too many input files, only 1 is supported" );
+        }
+        
+        // check if an input path was given
+        if( InputPath.empty() )
+          throw runtime_error( "no input file" );
+        
+        // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+        // STEP 1: Start the console
+        
+        // console messages are only shown in verbose mode
+        string ProgramFolder = GetProgramFolder();
+        
+        if( VerboseMode )
+          LOG_TO_CONSOLE();
+        else
+          LOG_TO_FILE( ProgramFolder + "TestProgramLog" );
+        
+        if( BiosPath.empty() )
+          BiosPath = ProgramFolder + "Bios" + PathSeparator + "StandardBios.v32";
+        
+        // the console is large, so it is not on the stack
+        HeadlessFrontend Frontend;
+        unique_ptr< V32Console > Console( new V32Console );
+        Console->SetFrontend( &Frontend );
+        
+        Console->LoadBios( BiosPath );
+        Console->LoadCartridge( InputPath );
+        Console->SetPower( true );
+        
+        // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+        // STEP 2: Run until the CPU halts
+        
+        // there is no need to pace frames,
+        // since nothing is shown or played
+        int Frame = 0;
+        
+        while( Frame < MaximumFrames && !Console->IsCPUHalted() )
+        {
+            Console->RunNextFrame();
+            Frame++;
+        }
+        
+        // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+        // STEP 3: Report results
+        
+        bool Halted = Console->IsCPUHalted();
+        V32Word Result = Console->CPU.Registers[ 0 ];
+        bool Passed = Halted;
+        
+        if( !Halted )
+          cout << "TestProgram: program did not halt in " << MaximumFrames << " frames" << endl;
+        
+        else
+        {
+            printf( "halted at frame %d: R0 = %d (0x%08X, %g as float)\n", Frame, Result.AsInteger, (unsigned)Result.AsBinary, Result.AsFloat );
+            
+            if( CheckResult && Result.AsInteger != ExpectedResult )
+            {
+                cout << "TestProgram: expected R0 = " << ExpectedResult << endl;
+                Passed = false;
+            }
+        }
+        
+        // clean-up in reverse order
+        Console.reset();
+        
+        if( !Passed )
+          return 1;
+    }
+    
+    catch( const exception& e )
+    {
+        cerr << "TestProgram: error: " << e.what() << endl;
+        return 1;
+    }
+    
+    return 0;
+}
@@ -16,6 +16,8 @@
 // *****************************************************************************
 
 
+namespace VirconASM
+{
 // =============================================================================
 //      GENERIC EMIT FUNCTIONS
 // =============================================================================
@@ -963,3 +965,4 @@ void EmitPOW( VirconASMEmitter &Emitter, InstructionNode& Node )
 {
     EmitInstructionWith2Registers( Emitter, Node );
 }
+}
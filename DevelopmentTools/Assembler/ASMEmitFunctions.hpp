@@ -9,6 +9,8 @@
 // *****************************************************************************
 
 
+namespace VirconASM
+{
 // we keep them outside the Assembler class to make
 // it easier to use an [instruction -> emitter] map.
 // However these functions do depend on Assembler
@@ -85,6 +87,7 @@ void EmitACOS ( VirconASMEmitter &Emitter, InstructionNode& Node );
 void EmitATAN2( VirconASMEmitter &Emitter, InstructionNode& Node );
 void EmitLOG  ( VirconASMEmitter &Emitter, InstructionNode& Node );
 void EmitPOW  ( VirconASMEmitter &Emitter, InstructionNode& Node );
+}
 
 
 // *****************************************************************************
@@ -1,6 +1,7 @@
 // *****************************************************************************
     // include infrastructure headers
     #include "../DevToolsInfrastructure/EnumStringConversions.hpp"
+    #include "../DevToolsInfrastructure/MemoryPools.hpp"
     
     // include project headers
     #include "ASTNodes.hpp"
@@ -10,6 +11,26 @@
 // *****************************************************************************
 
 
+namespace VirconASM
+{
+// =============================================================================
+//      BASE AST NODE CLASS
+// =============================================================================
+
+
+void* ASTNode::operator new( size_t Size )
+{
+    return NodesPool().Allocate( Size );
+}
+
+// -----------------------------------------------------------------------------
+
+void ASTNode::operator delete( void* Node, size_t Size )
+{
+    NodesPool().Release( Node, Size );
+}
+
+
 // =============================================================================
 //      BASIC VALUE CLASS
 // =============================================================================
@@ -19,6 +40,7 @@ BasicValue::BasicValue()
 {
     Type = BasicValueTypes::LiteralInteger;
     IntegerField = 0;
+    LabelOffset = 0;
 }
 
 // -----------------------------------------------------------------------------
@@ -38,7 +60,15 @@ string BasicValue::ToString()
         case BasicValueTypes::IOPortValue:
             return "PortValue " + PortValueToString( PortValueField );
         default:  // label
+        {
+            if( LabelOffset > 0 )
+              return "Label " + LabelField + " + " + to_string(LabelOffset);
+            
+            if( LabelOffset < 0 )
+              return "Label " + LabelField + " - " + to_string(-LabelOffset);
+            
             return "Label " + LabelField;
+        }
     }
 }
 
@@ -190,3 +220,26 @@ string DataFileNode::ToString()
     return Result;
 }
 
+
+
+// =============================================================================
+//      RAM VARIABLE NODE
+// =============================================================================
+
+
+string RAMVariableNode::ToString()
+{
+    return "RAMVariable: " + Name + ", " + to_string(SizeInWords) + " words";
+}
+
+
+// =============================================================================
+//      SHARED SYMBOL NODE
+// =============================================================================
+
+
+string SharedSymbolNode::ToString()
+{
+    return "SharedSymbol: " + Name;
+}
+}
@@ -19,6 +19,8 @@
 // *****************************************************************************
 
 
+namespace VirconASM
+{
 // =============================================================================
 //      DEFINITIONS
 // =============================================================================
@@ -34,7 +36,9 @@ enum class ASTNodeTypes
     StringData,
     PointerData,
     Label,
-    DataFile
+    DataFile,
+    RAMVariable,
+    SharedSymbol
 };
 
 
@@ -53,6 +57,11 @@ class ASTNode
     public:
         
         virtual ~ASTNode() {};
+        
+        // nodes are taken from their own memory pool
+        static void* operator new( size_t Size );
+        static void operator delete( void* Node, size_t Size );
+        
         virtual ASTNodeTypes Type() = 0;
         virtual std::string ToString() = 0;
 };
@@ -94,6 +103,7 @@ class BasicValue
         V32::IOPorts        PortField;
         V32::IOPortValues   PortValueField;
         std::string         LabelField;
+        int32_t             LabelOffset;    // as in "label+2"
     
     public:
         
@@ -231,6 +241,45 @@ class DataFileNode: public ASTNode
         virtual std::string ToString();
 };
 
+// -----------------------------------------------------------------------------
+
+// RAM variables do not occupy ROM: they just give
+// a name to a group of words in RAM, so that
+// modules can be linked with their own variables
+class RAMVariableNode: public ASTNode
+{
+    public:
+        
+        std::string Name;
+        int32_t SizeInWords;
+        
+        // assigned during RAM address allocation
+        int32_t AddressInRAM;
+        
+    public:
+        
+        virtual ASTNodeTypes Type() { return ASTNodeTypes::RAMVariable; };
+        virtual std::string ToString();
+};
+
+// -----------------------------------------------------------------------------
+
+// shared symbols can be defined in several modules
+// (such as variables and functions from C headers),
+// and the linker will use only one of them for all
+class SharedSymbolNode: public ASTNode
+{
+    public:
+        
+        std::string Name;
+        
+    public:
+        
+        virtual ASTNodeTypes Type() { return ASTNodeTypes::SharedSymbol; };
+        virtual std::string ToString();
+};
+}
+
 
 // *****************************************************************************
     // end include guard
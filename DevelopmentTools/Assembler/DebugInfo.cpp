@@ -8,15 +8,18 @@
     #include "DebugInfo.hpp"
     
     // include C/C++ headers
-    #include <fstream>      // [ C++ STL ] File streams
-    #include <algorithm>    // [ C++ STL ] Algorithms
-    #include <cstring>      // [ ANSI C ] Strings
+    #include <fstream>          // [ C++ STL ] File streams
+    #include <algorithm>        // [ C++ STL ] Algorithms
+    #include <unordered_map>    // [ C++ STL ] Unordered maps
+    #include <cstring>          // [ ANSI C ] Strings
     
     // declare used namespaces
     using namespace std;
 // *****************************************************************************
 
 
+namespace VirconASM
+{
 // =============================================================================
 //      AUXILIARY FUNCTIONS
 // =============================================================================
@@ -42,7 +45,7 @@ string NormalizePath( const string& Path )
 // =============================================================================
 
 
-void SaveDebugInfoFile( const string& FilePath, const VirconASMParser& Parser, const VirconASMEmitter& Emitter )
+void SaveDebugInfoFile( const string& FilePath, const NodeList& ProgramAST, const VirconASMEmitter& Emitter )
 {
     if( VerboseMode )
       cout << "saving debug info file" << endl;
@@ -54,9 +57,26 @@ void SaveDebugInfoFile( const string& FilePath, const VirconASMParser& Parser, c
     if( DebugInfoFile.fail() )
       throw runtime_error( "cannot open debug info file \"" + FilePath + "\"" );
     
+    // find the label for each address; when there are several
+    // the first one in alphabetical order is used
+    unordered_map< int32_t, const string* > AddressLabels;
+    
+    for( uint32_t SymbolID = 0; SymbolID < Emitter.Symbols.Size(); SymbolID++ )
+    {
+        const ProgramSymbol& Symbol = Emitter.Symbols[ SymbolID ];
+        
+        if( Symbol.Type != ProgramSymbolTypes::Label )
+          continue;
+        
+        const string*& Label = AddressLabels[ Symbol.Address ];
+        
+        if( !Label || Symbol.Name < *Label )
+          Label = &Symbol.Name;
+    }
+    
     // for each instruction in the file output a line with this
     // information (CSV format): ROM address, relative file path, line number
-    for( ASTNode* Node: Parser.ProgramAST )
+    for( ASTNode* Node: ProgramAST )
     {
         if( Node->Type() != ASTNodeTypes::Instruction )
           continue;
@@ -67,16 +87,12 @@ void SaveDebugInfoFile( const string& FilePath, const VirconASMParser& Parser, c
         
         // check if this line corresponds to a label;
         // in that case add its name as a 4th column
-        for( auto Pair : Emitter.LabelAddresses )
-        {
-            if( Pair.second == Node->AddressInROM )
-            {
-                DebugInfoFile << "," << Pair.first;
-                break;
-            }
-        }
+        auto Label = AddressLabels.find( Node->AddressInROM );
+        
+        if( Label != AddressLabels.end() )
+          DebugInfoFile << "," << *Label->second;
         
-        DebugInfoFile << endl;
+        DebugInfoFile << '\n';
     }
     
     // close output
@@ -116,7 +132,7 @@ void SaveLexerLog( const string& FilePath, const VirconASMPreprocessor& Preproce
 
 // -----------------------------------------------------------------------------
 
-void SaveParserLog( const string& FilePath, const VirconASMParser& Parser )
+void SaveParserLog( const string& FilePath, const NodeList& ProgramAST )
 {
     if( VerboseMode )
       cout << "Debug mode: Saving parser log" << endl;
@@ -128,7 +144,7 @@ void SaveParserLog( const string& FilePath, const VirconASMParser& Parser )
       throw runtime_error( "cannot open parser log file \"" + FilePath + "\"" );
     
     // log full AST tree
-    for( ASTNode* Node: Parser.ProgramAST )
+    for( ASTNode* Node: ProgramAST )
       LogFile << Node->ToString() << endl;
     
     LogFile.close();
@@ -136,7 +152,7 @@ void SaveParserLog( const string& FilePath, const VirconASMParser& Parser )
 
 // -----------------------------------------------------------------------------
 
-void SaveEmitterLog( const string& FilePath, const VirconASMParser& Parser )
+void SaveEmitterLog( const string& FilePath, const NodeList& ProgramAST )
 {
     if( VerboseMode )
       cout << "Debug mode: Saving emitter log" << endl;
@@ -147,8 +163,9 @@ void SaveEmitterLog( const string& FilePath, const VirconASMParser& Parser )
     if( LogFile.fail() )
       throw runtime_error( "cannot open emitter log file \"" + FilePath + "\"" );
     
-    for( ASTNode* Node: Parser.ProgramAST )
+    for( ASTNode* Node: ProgramAST )
       LogFile << Hex( Node->AddressInROM, 8 ) << ": " << Node->ToString() << endl;
     
     LogFile.close();
 }
+}
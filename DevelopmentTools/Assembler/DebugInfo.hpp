@@ -1,20 +1,23 @@
 // *****************************************************************************
     // include project headers
     #include "VirconASMPreprocessor.hpp"
-    #include "VirconASMParser.hpp"
     #include "VirconASMEmitter.hpp"
+    #include "ASTNodes.hpp"
 // *****************************************************************************
 
 
+namespace VirconASM
+{
 // =============================================================================
 //      FUNCTIONS TO OUTPUT FILES WITH DEBUG INFORMATION
 // =============================================================================
 
 
 // save debug info for the program
-void SaveDebugInfoFile( const std::string& FilePath, const VirconASMParser& Parser, const VirconASMEmitter& Emitter );
+void SaveDebugInfoFile( const std::string& FilePath, const NodeList& ProgramAST, const VirconASMEmitter& Emitter );
 
 // save debug logs for the internal stages of the assembler itself
 void SaveLexerLog( const std::string& FilePath, const VirconASMPreprocessor& Preprocessor );
-void SaveParserLog( const std::string& FilePath, const VirconASMParser& Parser );
-void SaveEmitterLog( const std::string& FilePath, const VirconASMParser& Parser );
+void SaveParserLog( const std::string& FilePath, const NodeList& ProgramAST );
+void SaveEmitterLog( const std::string& FilePath, const NodeList& ProgramAST );
+}
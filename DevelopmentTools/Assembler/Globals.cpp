@@ -11,6 +11,8 @@
 // *****************************************************************************
 
 
+namespace VirconASM
+{
 // =============================================================================
 //      GLOBAL VARIABLES
 // =============================================================================
@@ -23,4 +25,6 @@ bool VerboseMode = false;
 // assembler configuration (for the generated binary)
 string AssemblerFolder;
 int InitialROMAddress = Constants::CartridgeProgramROMFirstAddress;
-bool CreateDebugVersion = false;
\ No newline at end of file
+bool CreateDebugVersion = false;
+bool CreateObjectFile = false;
+}
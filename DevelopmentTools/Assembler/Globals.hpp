@@ -1,13 +1,15 @@
 // *****************************************************************************
     // start include guard
-    #ifndef GLOBALS_HPP
-    #define GLOBALS_HPP
+    #ifndef ASSEMBLERGLOBALS_HPP
+    #define ASSEMBLERGLOBALS_HPP
     
     // include C/C++ headers
     #include <string>           // [ C++ STL ] Strings
 // *****************************************************************************
 
 
+namespace VirconASM
+{
 // =============================================================================
 //      GLOBAL VARIABLES
 // =============================================================================
@@ -22,6 +24,11 @@ extern std::string AssemblerFolder;
 extern int InitialROMAddress;
 extern bool CreateDebugVersion;
 
+// when set, output is an object file to be linked
+// (references to labels are kept as relocations)
+extern bool CreateObjectFile;
+}
+
 
 // *****************************************************************************
     // end include guard
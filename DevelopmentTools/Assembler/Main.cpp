@@ -1,24 +1,18 @@
 // *****************************************************************************
     // include common Vircon headers
     #include "../../VirconDefinitions/Constants.hpp"
-    #include "../../VirconDefinitions/FileFormats.hpp"
     
     // include infrastructure headers
     #include "../DevToolsInfrastructure/FilePaths.hpp"
     #include "../DevToolsInfrastructure/StringFunctions.hpp"
     
     // include project headers
-    #include "VirconASMLexer.hpp"
-    #include "VirconASMPreprocessor.hpp"
-    #include "VirconASMParser.hpp"
-    #include "VirconASMEmitter.hpp"
+    #include "ProgramAssembly.hpp"
     #include "Globals.hpp"
-    #include "DebugInfo.hpp"
     
     // include C/C++ headers
-    #include <fstream>      // [ C++ STL ] File streams
+    #include <iostream>     // [ C++ STL ] I/O Streams
     #include <vector>       // [ C++ STL ] Vectors
-    #include <cstring>      // [ ANSI C ] Strings
     
     // include SDL headers
     #define SDL_MAIN_HANDLED
@@ -34,6 +28,7 @@
     // declare used namespaces
     using namespace std;
     using namespace V32;
+    using namespace VirconASM;
 // *****************************************************************************
 
 
@@ -53,6 +48,7 @@ void PrintUsage()
     cout << "  -b           Assembles the code as a BIOS" << endl;
     cout << "  -v           Displays additional information (verbose)" << endl;
     cout << "  -g           Outputs an additional file with debug info" << endl;
+    cout << "  -c           Outputs an object file to be linked with others" << endl;
     cout << "Also, the following options are accepted for compatibility" << endl;
     cout << "but have no effect: -s" << endl;
 }
@@ -158,6 +154,12 @@ int main( int NumberOfArguments, char* Arguments[] )
                 continue;
             }
             
+            if( ArgumentsUTF8[i] == string("-c") )
+            {
+                CreateObjectFile = true;
+                continue;
+            }
+            
             if( ArgumentsUTF8[i] == string("--debugmode") )
             {
                 DebugMode = true;
@@ -210,7 +212,7 @@ int main( int NumberOfArguments, char* Arguments[] )
         // replace the extension in the input
         if( OutputPath.empty() )
         {
-            OutputPath = ReplaceFileExtension( InputPath, "vbin" );
+            OutputPath = ReplaceFileExtension( InputPath, CreateObjectFile? "vobj" : "vbin" );
             
             if( VerboseMode )
               cout << "using output path: \"" << OutputPath << "\"" << endl;
@@ -220,102 +222,8 @@ int main( int NumberOfArguments, char* Arguments[] )
         if( VerboseMode && CreateDebugVersion )
           cout << "assembler will output debug information of the binary" << endl;
         
-        // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-        
-        // simple compilation checks to ensure correct ROM creation
-        if( sizeof( CPUInstruction ) != 4 )
-          throw runtime_error( "ABI is incorrect: CPU instructions must be 4 bytes in size" );
-          
-        if( sizeof( float ) != 4 )
-          throw runtime_error( "ABI is incorrect: floating point numbers must be 4 bytes in size" );
-        
-        // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-        // STAGE 1: Run lexer
-        // (Text --> List of tokens)
-        if( VerboseMode )
-          cout << "stage 1: running lexer" << endl;
-        
-        VirconASMLexer Lexer;
-        Lexer.TokenizeFile( InputPath );
-        
-        // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-        // STAGE 2: Run preprocessor
-        // (Token sequence --> Token sequence)
-        if( VerboseMode )
-          cout << "stage 2: running preprocessor" << endl;
-          
-        VirconASMPreprocessor Preprocessor;
-        Preprocessor.Preprocess( Lexer );
-        
-        // when requested, log results of lexer + preprocessor stages
-        if( DebugMode )
-          SaveLexerLog( OutputPath + ".lexer.log", Preprocessor );
-        
-        // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-        // STAGE 3: Run parser
-        // (Token sequence --> List of AST statement nodes)
-        if( VerboseMode )
-          cout << "stage 3: running parser" << endl;
-          
-        VirconASMParser Parser;
-        Parser.ParseTopLevel( Preprocessor.ProcessedTokens );
-        
-        // when requested, log results of parser stage
-        if( DebugMode )
-          SaveParserLog( OutputPath + ".parser.log", Parser );
-        
-        // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-        // STAGE 4: Run emitter
-        // (AST nodes --> binary ROM)
-        if( VerboseMode )
-          cout << "stage 4: running emitter" << endl;
-        
-        VirconASMEmitter Emitter;
-        Emitter.Emit( Parser.ProgramAST );
-        
-        // when requested, log results of emitter stage
-        if( DebugMode )
-          SaveEmitterLog( OutputPath + ".emitter.log", Parser );
-        
-        // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-        // open output file, in binary!
-        // otherwise it replaces bytes '\n' with '\r\n', breaking the ROM
-        if( VerboseMode )
-          cout << "saving binary file" << endl;
-        
-        ofstream OutputFile;
-        OpenOutputFile( OutputFile, OutputPath, ios_base::out | ios_base::binary );
-        
-        if( OutputFile.fail() )
-          throw runtime_error( "cannot open output file \"" + OutputPath + "\"" );
-        
-        // determine program size
-        uint32_t ROMSizeInWords = Emitter.ROM.size();
-        uint32_t ROMSizeInBytes = ROMSizeInWords * 4;
-        
-        // create the VBIN file header
-        BinaryFileFormat::Header VBINHeader;
-        memcpy( VBINHeader.Signature, BinaryFileFormat::Signature, 8 );
-        VBINHeader.NumberOfWords = ROMSizeInWords;
-        
-        // write the header in the file
-        OutputFile.seekp( 0, ios_base::beg );
-        OutputFile.write( (char*)(&VBINHeader), sizeof(BinaryFileFormat::Header) );
-        
-        // now add the whole ROM to the output
-        OutputFile.write( (char*)(&Emitter.ROM[0]), ROMSizeInBytes );
-        
-        // close output
-        OutputFile.close();
-        
-        // finally, report size of the produced ROM
-        if( VerboseMode )
-          cout << "output file created, size: " << ROMSizeInWords << " dwords = " << ROMSizeInBytes << " bytes" << endl;
-        
-        // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-        // on debug assembly output an additional debug info file
-        if( CreateDebugVersion )
-          SaveDebugInfoFile( OutputPath + ".debug", Parser, Emitter );
+        // run all assembly stages
+        AssembleFile( InputPath, OutputPath );
     }
     
     catch( const exception& e )
@@ -0,0 +1,225 @@
+// *****************************************************************************
+    // include common Vircon headers
+    #include "../../VirconDefinitions/Constants.hpp"
+    #include "../../VirconDefinitions/FileFormats.hpp"
+    
+    // include infrastructure headers
+    #include "../DevToolsInfrastructure/FilePaths.hpp"
+    #include "../DevToolsInfrastructure/ObjectFiles.hpp"
+    
+    // include project headers
+    #include "ProgramAssembly.hpp"
+    #include "VirconASMLexer.hpp"
+    #include "VirconASMPreprocessor.hpp"
+    #include "VirconASMParser.hpp"
+    #include "VirconASMEmitter.hpp"
+    #include "Globals.hpp"
+    #include "DebugInfo.hpp"
+    
+    // include C/C++ headers
+    #include <iostream>     // [ C++ STL ] I/O Streams
+    #include <fstream>      // [ C++ STL ] File streams
+    #include <stdexcept>    // [ C++ STL ] Exceptions
+    #include <cstring>      // [ ANSI C ] Strings
+    
+    // declare used namespaces
+    using namespace std;
+    using namespace V32;
+// *****************************************************************************
+
+
+namespace VirconASM
+{
+// =============================================================================
+//      AUXILIARY FUNCTIONS
+// =============================================================================
+
+
+void CheckAssemblyOptions()
+{
+    // addresses in objects are only known after linking
+    if( CreateObjectFile && CreateDebugVersion )
+      throw runtime_error( "debug info cannot be created for object files" );
+    
+    if( CreateObjectFile && InitialROMAddress != Constants::CartridgeProgramROMFirstAddress )
+      throw runtime_error( "a BIOS cannot be assembled as an object file" );
+    
+    // simple compilation checks to ensure correct ROM creation
+    if( sizeof( CPUInstruction ) != 4 )
+      throw runtime_error( "ABI is incorrect: CPU instructions must be 4 bytes in size" );
+    
+    if( sizeof( float ) != 4 )
+      throw runtime_error( "ABI is incorrect: floating point numbers must be 4 bytes in size" );
+}
+
+// -----------------------------------------------------------------------------
+
+// last stage, shared by all ways to obtain the nodes
+void AssembleNodes( NodeList& ProgramAST, const string& OutputPath )
+{
+    // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+    // STAGE 4: Run emitter
+    // (AST nodes --> binary ROM)
+    if( VerboseMode )
+      cout << "stage 4: running emitter" << endl;
+    
+    VirconASMEmitter Emitter;
+    Emitter.Emit( ProgramAST );
+    
+    // when requested, log results of emitter stage
+    if( DebugMode )
+      SaveEmitterLog( OutputPath + ".emitter.log", ProgramAST );
+    
+    // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+    // object files have their own format
+    if( CreateObjectFile )
+    {
+        if( VerboseMode )
+          cout << "saving object file" << endl;
+        
+        ObjectFile Object;
+        Emitter.CreateObject( Object );
+        Object.Save( OutputPath );
+        
+        if( VerboseMode )
+        {
+            cout << "output file created, size: " << Object.Words.size() << " dwords, ";
+            cout << Object.Symbols.size() << " symbols, " << Object.Relocations.size() << " relocations" << endl;
+        }
+        
+        return;
+    }
+    
+    // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+    // open output file, in binary!
+    // otherwise it replaces bytes '\n' with '\r\n', breaking the ROM
+    if( VerboseMode )
+      cout << "saving binary file" << endl;
+    
+    ofstream OutputFile;
+    OpenOutputFile( OutputFile, OutputPath, ios_base::out | ios_base::binary );
+    
+    if( OutputFile.fail() )
+      throw runtime_error( "cannot open output file \"" + OutputPath + "\"" );
+    
+    // determine program size
+    uint32_t ROMSizeInWords = Emitter.ROM.size();
+    uint32_t ROMSizeInBytes = ROMSizeInWords * 4;
+    
+    // create the VBIN file header
+    BinaryFileFormat::Header VBINHeader;
+    memcpy( VBINHeader.Signature, BinaryFileFormat::Signature, 8 );
+    VBINHeader.NumberOfWords = ROMSizeInWords;
+    
+    // write the header in the file
+    OutputFile.seekp( 0, ios_base::beg );
+    OutputFile.write( (char*)(&VBINHeader), sizeof(BinaryFileFormat::Header) );
+    
+    // now add the whole ROM to the output
+    OutputFile.write( (char*)(&Emitter.ROM[0]), ROMSizeInBytes );
+    
+    // close output
+    OutputFile.close();
+    
+    // finally, report size of the produced ROM
+    if( VerboseMode )
+      cout << "output file created, size: " << ROMSizeInWords << " dwords = " << ROMSizeInBytes << " bytes" << endl;
+    
+    // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+    // on debug assembly output an additional debug info file
+    if( CreateDebugVersion )
+      SaveDebugInfoFile( OutputPath + ".debug", ProgramAST, Emitter );
+}
+
+// -----------------------------------------------------------------------------
+
+// stages that follow the lexer are the
+// same regardless of where the input is
+void AssembleTokens( VirconASMLexer& Lexer, const string& OutputPath )
+{
+    // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+    // STAGE 2: Run preprocessor
+    // (Token sequence --> Token sequence)
+    if( VerboseMode )
+      cout << "stage 2: running preprocessor" << endl;
+    
+    VirconASMPreprocessor Preprocessor;
+    Preprocessor.Preprocess( Lexer );
+    
+    // when requested, log results of lexer + preprocessor stages
+    if( DebugMode )
+      SaveLexerLog( OutputPath + ".lexer.log", Preprocessor );
+    
+    // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+    // STAGE 3: Run parser
+    // (Token sequence --> List of AST statement nodes)
+    if( VerboseMode )
+      cout << "stage 3: running parser" << endl;
+    
+    VirconASMParser Parser;
+    Parser.ParseTopLevel( Preprocessor.ProcessedTokens );
+    
+    // when requested, log results of parser stage
+    if( DebugMode )
+      SaveParserLog( OutputPath + ".parser.log", Parser.ProgramAST );
+    
+    AssembleNodes( Parser.ProgramAST, OutputPath );
+}
+
+
+// =============================================================================
+//      FULL ASSEMBLY OF A PROGRAM
+// =============================================================================
+
+
+void AssembleFile( const string& InputPath, const string& OutputPath )
+{
+    CheckAssemblyOptions();
+    
+    // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+    // STAGE 1: Run lexer
+    // (Text --> List of tokens)
+    if( VerboseMode )
+      cout << "stage 1: running lexer" << endl;
+    
+    VirconASMLexer Lexer;
+    Lexer.TokenizeFile( InputPath );
+    
+    AssembleTokens( Lexer, OutputPath );
+}
+
+// -----------------------------------------------------------------------------
+
+void AssembleText( const string& SourceText, const string& SourcePath, const string& OutputPath )
+{
+    CheckAssemblyOptions();
+    
+    // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+    // STAGE 1: Run lexer
+    // (Text --> List of tokens)
+    if( VerboseMode )
+      cout << "stage 1: running lexer" << endl;
+    
+    VirconASMLexer Lexer;
+    Lexer.TokenizeText( SourceText, SourcePath );
+    
+    AssembleTokens( Lexer, OutputPath );
+}
+
+// -----------------------------------------------------------------------------
+
+void AssembleLines( const vector< string >& ProgramLines, const vector< string >& DataLines, const string& SourcePath, const string& OutputPath )
+{
+    // join the lines as they would be in the ASM file,
+    // so that locations and debug info are the same
+    string SourceText;
+    
+    for( const string& Line: ProgramLines )
+      SourceText += Line + '\n';
+    
+    for( const string& Line: DataLines )
+      SourceText += Line + '\n';
+    
+    AssembleText( SourceText, SourcePath, OutputPath );
+}
+}
@@ -0,0 +1,39 @@
+// *****************************************************************************
+    // start include guard
+    #ifndef PROGRAMASSEMBLY_HPP
+    #define PROGRAMASSEMBLY_HPP
+    
+    // include C/C++ headers
+    #include <string>           // [ C++ STL ] Strings
+    #include <vector>           // [ C++ STL ] Vectors
+// *****************************************************************************
+
+
+namespace VirconASM
+{
+// =============================================================================
+//      FULL ASSEMBLY OF A PROGRAM
+// =============================================================================
+
+
+// These run all assembler stages and save the results in the
+// output path: a binary, or an object file when it is enabled
+// in the globals. The C compiler passes its lines directly to
+// build binaries without writing and reading an ASM file.
+// (on errors, these functions will throw an exception)
+
+void AssembleFile( const std::string& InputPath, const std::string& OutputPath );
+
+// the source path is used for locations and includes
+void AssembleText( const std::string& SourceText, const std::string& SourcePath, const std::string& OutputPath );
+
+// lines are assembled as the equivalent ASM file would be
+void AssembleLines( const std::vector< std::string >& ProgramLines, const std::vector< std::string >& DataLines,
+                    const std::string& SourcePath, const std::string& OutputPath );
+}
+
+
+// *****************************************************************************
+    // end include guard
+    #endif
+// *****************************************************************************
@@ -7,6 +7,8 @@
 // *****************************************************************************
 
 
+namespace VirconASM
+{
 // =============================================================================
 //      WORKING WITH LOCATIONS
 // =============================================================================
@@ -22,3 +24,4 @@ bool AreInSameLine( const SourceLocation& L1, const SourceLocation& L2 )
     
     return (L1.Line == L2.Line);
 }
+}
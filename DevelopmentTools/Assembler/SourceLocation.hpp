@@ -8,6 +8,8 @@
 // *****************************************************************************
 
 
+namespace VirconASM
+{
 // =============================================================================
 //      LOCATIONS IN SOURCE FILES
 // =============================================================================
@@ -28,7 +30,7 @@ class SourceLocation
 
 
 bool AreInSameLine( const SourceLocation& L1, const SourceLocation& L2 );
-
+}
 
 
 // *****************************************************************************
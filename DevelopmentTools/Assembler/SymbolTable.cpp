@@ -0,0 +1,142 @@
+// *****************************************************************************
+    // include project headers
+    #include "SymbolTable.hpp"
+    
+    // declare used namespaces
+    using namespace std;
+// *****************************************************************************
+
+
+namespace VirconASM
+{
+// =============================================================================
+//      SYMBOL TABLE: INSTANCE HANDLING
+// =============================================================================
+
+
+SymbolTable::SymbolTable()
+{
+    Clear();
+}
+
+// -----------------------------------------------------------------------------
+
+void SymbolTable::Clear()
+{
+    Symbols.clear();
+    
+    // start with enough slots for small programs
+    HashSlot EmptySlot = { 0, NoSymbol };
+    Slots.assign( 1024, EmptySlot );
+}
+
+
+// =============================================================================
+//      SYMBOL TABLE: HASHING
+// =============================================================================
+
+
+// FNV-1a: simple, and good enough for the
+// kind of names produced by the compiler
+uint32_t SymbolTable::HashName( const string& Name )
+{
+    uint32_t Hash = 2166136261u;
+    
+    for( unsigned char c: Name )
+    {
+        Hash ^= c;
+        Hash *= 16777619u;
+    }
+    
+    return Hash;
+}
+
+// -----------------------------------------------------------------------------
+
+// doubles the slots and places all symbols again
+// (hashes are kept, so no names need to be read)
+void SymbolTable::Grow()
+{
+    HashSlot EmptySlot = { 0, NoSymbol };
+    vector< HashSlot > OldSlots( Slots.size() * 2, EmptySlot );
+    OldSlots.swap( Slots );
+    
+    uint32_t Mask = Slots.size() - 1;
+    
+    for( const HashSlot& Slot: OldSlots )
+    {
+        if( Slot.SymbolID == NoSymbol )
+          continue;
+        
+        uint32_t Position = Slot.Hash & Mask;
+        
+        while( Slots[ Position ].SymbolID != NoSymbol )
+          Position = (Position + 1) & Mask;
+        
+        Slots[ Position ] = Slot;
+    }
+}
+
+
+// =============================================================================
+//      SYMBOL TABLE: LOOKUPS
+// =============================================================================
+
+
+uint32_t SymbolTable::Find( const string& Name ) const
+{
+    uint32_t Hash = HashName( Name );
+    uint32_t Mask = Slots.size() - 1;
+    uint32_t Position = Hash & Mask;
+    
+    // look at consecutive slots until an empty one
+    while( Slots[ Position ].SymbolID != NoSymbol )
+    {
+        const HashSlot& Slot = Slots[ Position ];
+        
+        if( Slot.Hash == Hash && Symbols[ Slot.SymbolID ].Name == Name )
+          return Slot.SymbolID;
+        
+        Position = (Position + 1) & Mask;
+    }
+    
+    return NoSymbol;
+}
+
+// -----------------------------------------------------------------------------
+
+uint32_t SymbolTable::Intern( const string& Name )
+{
+    uint32_t Hash = HashName( Name );
+    uint32_t Mask = Slots.size() - 1;
+    uint32_t Position = Hash & Mask;
+    
+    while( Slots[ Position ].SymbolID != NoSymbol )
+    {
+        const HashSlot& Slot = Slots[ Position ];
+        
+        if( Slot.Hash == Hash && Symbols[ Slot.SymbolID ].Name == Name )
+          return Slot.SymbolID;
+        
+        Position = (Position + 1) & Mask;
+    }
+    
+    // not found: add it at the empty slot
+    uint32_t SymbolID = Symbols.size();
+    Symbols.emplace_back();
+    Symbols.back().Name = Name;
+    Symbols.back().Type = ProgramSymbolTypes::Undeclared;
+    Symbols.back().Address = 0;
+    Symbols.back().IsShared = false;
+    
+    Slots[ Position ].Hash = Hash;
+    Slots[ Position ].SymbolID = SymbolID;
+    
+    // keep slots at most half full so
+    // that searches remain short
+    if( 2 * Symbols.size() > Slots.size() )
+      Grow();
+    
+    return SymbolID;
+}
+}
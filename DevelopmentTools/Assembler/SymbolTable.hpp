@@ -0,0 +1,100 @@
+// *****************************************************************************
+    // start include guard
+    #ifndef SYMBOLTABLE_HPP
+    #define SYMBOLTABLE_HPP
+    
+    // include C/C++ headers
+    #include <string>           // [ C++ STL ] Strings
+    #include <vector>           // [ C++ STL ] Vectors
+    #include <cstdint>          // [ ANSI C ] Standard integer types
+// *****************************************************************************
+
+
+namespace VirconASM
+{
+// =============================================================================
+//      PROGRAM SYMBOLS
+// =============================================================================
+
+
+// (named like this to not be confused with SymbolTypes,
+// which are the symbol characters recognized by the lexer)
+enum class ProgramSymbolTypes
+{
+    Undeclared,     // only referenced so far
+    Label,
+    RAMVariable
+};
+
+// -----------------------------------------------------------------------------
+
+class ProgramSymbol
+{
+    public:
+        
+        std::string Name;
+        ProgramSymbolTypes Type;
+        int32_t Address;
+        bool IsShared;          // only used in object files
+};
+
+
+// =============================================================================
+//      SYMBOL TABLE
+// =============================================================================
+
+
+// Programs produced by the compiler can have hundreds of
+// thousands of labels. Each name is stored only once and
+// identified by its position in the table, so references
+// to it can be kept as a plain integer. Names are found
+// with a hash table using open addressing, so that lookups
+// don't need to compare strings more than once or follow
+// pointers to separately allocated nodes.
+class SymbolTable
+{
+    protected:
+        
+        // symbols in the order they first appeared
+        std::vector< ProgramSymbol > Symbols;
+        
+        // hash slots: their number is always a power of 2
+        // and they are never more than half full
+        struct HashSlot
+        {
+            uint32_t Hash;
+            uint32_t SymbolID;
+        };
+        
+        std::vector< HashSlot > Slots;
+        
+        // helpers
+        static uint32_t HashName( const std::string& Name );
+        void Grow();
+        
+    public:
+        
+        // returned when a name is not in the table
+        static const uint32_t NoSymbol = 0xFFFFFFFF;
+        
+        // instance handling
+        SymbolTable();
+        void Clear();
+        
+        // Intern adds the name as undeclared if not
+        // present; in both cases it returns its ID
+        uint32_t Intern( const std::string& Name );
+        uint32_t Find( const std::string& Name ) const;
+        
+        // access to symbols by their ID
+        ProgramSymbol& operator[]( uint32_t SymbolID )             { return Symbols[ SymbolID ]; }
+        const ProgramSymbol& operator[]( uint32_t SymbolID ) const { return Symbols[ SymbolID ]; }
+        uint32_t Size() const                                      { return Symbols.size(); }
+};
+}
+
+
+// *****************************************************************************
+    // end include guard
+    #endif
+// *****************************************************************************
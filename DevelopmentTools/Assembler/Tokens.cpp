@@ -5,6 +5,7 @@
     // include infrastructure headers
     #include "../DevToolsInfrastructure/StringFunctions.hpp"
     #include "../DevToolsInfrastructure/EnumStringConversions.hpp"
+    #include "../DevToolsInfrastructure/MemoryPools.hpp"
     
     // include project headers
     #include "Tokens.hpp"
@@ -21,6 +22,8 @@
 // *****************************************************************************
 
 
+namespace VirconASM
+{
 // =============================================================================
 //      TOKEN TYPES --> STRING MAPS
 // =============================================================================
@@ -32,7 +35,9 @@ const map< KeywordTypes, string > KeywordNames =
     { KeywordTypes::Float,    "float"    },
     { KeywordTypes::String,   "string"   },
     { KeywordTypes::Pointer,  "pointer"  },
-    { KeywordTypes::DataFile, "datafile" }
+    { KeywordTypes::DataFile, "datafile" },
+    { KeywordTypes::RAM,      "ram"      },
+    { KeywordTypes::Shared,   "shared"   }
 };
 
 // -----------------------------------------------------------------------------
@@ -232,6 +237,24 @@ string SymbolToken::ToString()
 }
 
 
+// =============================================================================
+//      BASE TOKEN CLASS: MEMORY ALLOCATION
+// =============================================================================
+
+
+void* Token::operator new( size_t Size )
+{
+    return TokensPool().Allocate( Size );
+}
+
+// -----------------------------------------------------------------------------
+
+void Token::operator delete( void* Token, size_t Size )
+{
+    TokensPool().Release( Token, Size );
+}
+
+
 // =============================================================================
 //      TOKEN CLASSES: CLONING
 // =============================================================================
@@ -536,3 +559,4 @@ bool AreInSameLine( Token* T1, Token*T2 )
     // now we can just compare
     return (T1->Location.Line == T2->Location.Line);
 }
+}
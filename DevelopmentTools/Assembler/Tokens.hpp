@@ -15,6 +15,8 @@
 // *****************************************************************************
 
 
+namespace VirconASM
+{
 // =============================================================================
 //      DEFINITIONS
 // =============================================================================
@@ -45,7 +47,9 @@ enum class KeywordTypes
     Float,       // statement to define non-executable data floats as literals
     String,      // statement to define a non-executable data string as a literal
     Pointer,     // statement to define a non-executable data pointers as labels
-    DataFile     // statement to insert data from another file
+    DataFile,    // statement to insert data from another file
+    RAM,         // statement to reserve RAM words for a named variable
+    Shared       // statement to let other modules define the same symbol
 };
 
 // -----------------------------------------------------------------------------
@@ -94,6 +98,11 @@ class Token
     public:
         
         virtual ~Token() {};   // needed for base classes to be destructed
+        
+        // tokens are taken from their own memory pool
+        static void* operator new( size_t Size );
+        static void operator delete( void* Token, size_t Size );
+        
         virtual TokenTypes Type() = 0;
         virtual std::string ToString() = 0;
         virtual Token* Clone() = 0;
@@ -318,6 +327,7 @@ bool TokenIsThisSymbol( Token* T, SymbolTypes Which );
 TokenIterator Previous( const TokenIterator& TokenPosition );
 TokenIterator Next( const TokenIterator& TokenPosition );
 bool AreInSameLine( Token* T1, Token*T2 );
+}
 
 
 // *****************************************************************************
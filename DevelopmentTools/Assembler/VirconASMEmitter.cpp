@@ -1,4 +1,7 @@
 // *****************************************************************************
+    // include common Vircon headers
+    #include "../../VirconDefinitions/Constants.hpp"
+    
     // include project headers
     #include "VirconASMEmitter.hpp"
     #include "ASMEmitFunctions.hpp"
@@ -11,6 +14,7 @@
     // include C/C++ headers
     #include <iostream>             // [ C++ STL ] I/O Streams
     #include <fstream>              // [ C++ STL ] File streams
+    #include <algorithm>            // [ C++ STL ] Algorithms
     
     // declare used namespaces
     using namespace std;
@@ -18,6 +22,8 @@
 // *****************************************************************************
 
 
+namespace VirconASM
+{
 // =============================================================================
 //      MAPPING OF EACH OPCODE TO ITS SPECIFIC EMIT FUNCTION
 // =============================================================================
@@ -104,6 +110,7 @@ EmitFunction InstructionEmitFunctions[] =
 VirconASMEmitter::VirconASMEmitter()
 {
     ProgramAST = nullptr;
+    RAMSize = 0;
 }
 
 
@@ -155,18 +162,36 @@ void VirconASMEmitter::CheckOperands( InstructionNode& Node, int NumberOfOperand
 
 // -----------------------------------------------------------------------------
 
-// first checks that the label exists!!
-int32_t VirconASMEmitter::GetLabelAddress( ASTNode& ReferringNode, string LabelName )
+// The given word address is the ROM position where the label
+// address will be stored. Labels not declared yet return 0
+// and their position is noted, to add their address later
+int32_t VirconASMEmitter::GetLabelAddress( ASTNode& ReferringNode, string LabelName, int32_t WordAddress )
 {
-    auto AddressPair = LabelAddresses.find( LabelName );
-    
-    if( AddressPair == LabelAddresses.end() )
+    // in object files, addresses are only known after
+    // linking; labels not declared here are taken as
+    // references to other modules, resolved by the linker
+    if( CreateObjectFile )
     {
-        EmitError( ReferringNode.Location, string("label \"") + LabelName + "\" was not declared" );
-        throw runtime_error( "Aborted" );
+        ObjectRelocation Relocation;
+        Relocation.WordOffset = WordAddress - InitialROMAddress;
+        Relocation.SymbolName = LabelName;
+        Relocations.push_back( Relocation );
+        return 0;
     }
     
-    return AddressPair->second;
+    uint32_t SymbolID = Symbols.Intern( LabelName );
+    
+    if( Symbols[ SymbolID ].Type != ProgramSymbolTypes::Undeclared )
+      return Symbols[ SymbolID ].Address;
+    
+    // callers will add any offset to the
+    // value returned, so it must start as 0
+    PendingReference Reference;
+    Reference.ROMIndex = WordAddress - InitialROMAddress;
+    Reference.SymbolID = SymbolID;
+    Reference.ReferringNode = &ReferringNode;
+    PendingReferences.push_back( Reference );
+    return 0;
 }
 
 // -----------------------------------------------------------------------------
@@ -184,10 +209,11 @@ void VirconASMEmitter::ReadDataFile( DataFileNode& Node )
     if( (FileSize % 4) != 0 )
       EmitError( Node.Location, "data file size must be a multiple of 4 to be inserted in a rom" );
     
-    // read it into the vector
-    Node.FileContents.resize( FileSize / 4 );
+    // read it directly at the end of the ROM
+    size_t FirstWord = ROM.size();
+    ROM.resize( FirstWord + FileSize / 4 );
     InputFile.seekg( 0, ios_base::beg );
-    InputFile.read( (char*)(&Node.FileContents[0]), FileSize );
+    InputFile.read( (char*)(ROM.data() + FirstWord), FileSize );
     
     // close the file
     InputFile.close();
@@ -207,7 +233,7 @@ int32_t VirconASMEmitter::GetValueAsAddress( InstructionNode& Node, BasicValue&
     if( Value.Type == BasicValueTypes::Label )
     {
         string LabelName = Value.LabelField;
-        return GetLabelAddress( Node, LabelName );
+        return GetLabelAddress( Node, LabelName, Node.AddressInROM + 1 ) + Value.LabelOffset;
     }
     
     EmitError( Node.Location, OpCodeName + " expected a memory address (integer or label)" );
@@ -235,7 +261,7 @@ V32Word VirconASMEmitter::GetValueAsImmediate( InstructionNode& Node, BasicValue
     else if( Value.Type == BasicValueTypes::Label )
     {
         string LabelName = Value.LabelField;
-        Result.AsInteger = GetLabelAddress( Node, LabelName );
+        Result.AsInteger = GetLabelAddress( Node, LabelName, Node.AddressInROM + 1 ) + Value.LabelOffset;
     }
     
     // other cases
@@ -262,65 +288,72 @@ void VirconASMEmitter::EmitInstructionFromNode( InstructionNode& Node )
 // =============================================================================
 
 
-void VirconASMEmitter::Emit( NodeList& ProgramAST_ )
+void VirconASMEmitter::DeclareSymbol( ASTNode& Node, const string& Name, ProgramSymbolTypes Type, int32_t Address )
 {
-    // restart assembly
-    ProgramAST = &ProgramAST_;
+    ProgramSymbol& Symbol = Symbols[ Symbols.Intern( Name ) ];
     
-    // delete any previous results
-    ROM.clear();
-    LabelAddresses.clear();
+    // check for double declaration!
+    if( Symbol.Type == Type )
+    {
+        if( Type == ProgramSymbolTypes::Label )
+          EmitError( Node.Location, "label \"" + Name + "\" has already been declared" );
+        else
+          EmitError( Node.Location, "variable \"" + Name + "\" has already been declared" );
+    }
     
-    // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-    // PASS 1: Allocate ROM addresses
-    // (in the same pass, we will also locate all labels)
-    uint32_t ROMAddress = InitialROMAddress;
+    // labels and RAM variables share the same namespace
+    if( Symbol.Type != ProgramSymbolTypes::Undeclared )
+      EmitError( Node.Location, "name \"" + Name + "\" is used both as a label and a RAM variable" );
     
-    for( ASTNode* Node: *ProgramAST )
+    Symbol.Type = Type;
+    Symbol.Address = Address;
+}
+
+// -----------------------------------------------------------------------------
+
+// all names are known at the end, so add their
+// addresses to the ROM words that referred to them
+void VirconASMEmitter::ResolvePendingReferences()
+{
+    for( const PendingReference& Reference: PendingReferences )
     {
-        Node->AddressInROM = ROMAddress;
-        
-        if( Node->Type() == ASTNodeTypes::Instruction )
-          ROMAddress += ((InstructionNode*)Node)->SizeInWords();
+        const ProgramSymbol& Symbol = Symbols[ Reference.SymbolID ];
         
-        else if( Node->Type() == ASTNodeTypes::IntegerData )
-          ROMAddress += ((IntegerDataNode*)Node)->Values.size();
-        
-        else if( Node->Type() == ASTNodeTypes::FloatData )
-          ROMAddress += ((FloatDataNode*)Node)->Values.size();
-        
-        else if( Node->Type() == ASTNodeTypes::StringData )
-          ROMAddress += ((StringDataNode*)Node)->Value.size() + 1;  // strings are zero-terminated!
-        
-        else if( Node->Type() == ASTNodeTypes::PointerData )
-          ROMAddress += ((PointerDataNode*)Node)->LabelNames.size();
-        
-        else if( Node->Type() == ASTNodeTypes::Label )
-        {
-            string LabelName = ((LabelNode*)Node)->Name;
-            
-            // check for double declaration!
-            if( LabelAddresses.find( LabelName ) !=  LabelAddresses.end() )
-              EmitError( Node->Location, "label \"" + LabelName + "\" has already been declared" );
-            
-            LabelAddresses[ LabelName ] = ROMAddress;
-        }
-        
-        else if( Node->Type() == ASTNodeTypes::DataFile )
+        if( Symbol.Type == ProgramSymbolTypes::Undeclared )
         {
-            DataFileNode* DFN = (DataFileNode*)Node;
-            ReadDataFile( *DFN );
-            ROMAddress += DFN->FileContents.size();
+            EmitError( Reference.ReferringNode->Location, string("label \"") + Symbol.Name + "\" was not declared" );
+            throw runtime_error( "Aborted" );
         }
         
-        // (do nothing with definition nodes:
-        // (they neither occupy nor reference addresses)
+        ROM[ Reference.ROMIndex ].AsInteger += Symbol.Address;
     }
     
-    // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-    // PASS 2: Emit binary ROM
+    PendingReferences.clear();
+}
+
+// -----------------------------------------------------------------------------
+
+// Emission needs a single pass on the AST: every node is placed
+// at the current end of the ROM, so labels get their address
+// when reached. Uses of labels that appear later are completed
+// at the end (in object files the linker does that instead)
+void VirconASMEmitter::Emit( NodeList& ProgramAST_ )
+{
+    // restart assembly
+    ProgramAST = &ProgramAST_;
+    
+    // delete any previous results
+    ROM.clear();
+    Symbols.Clear();
+    PendingReferences.clear();
+    SharedSymbols.clear();
+    Relocations.clear();
+    RAMSize = 0;
+    
     for( ASTNode* Node: *ProgramAST )
     {
+        Node->AddressInROM = InitialROMAddress + ROM.size();
+        
         // CASE 1: Instructions -> Call its specialized function
         if( Node->Type() == ASTNodeTypes::Instruction )
         {
@@ -381,22 +414,116 @@ void VirconASMEmitter::Emit( NodeList& ProgramAST_ )
         {
             PointerDataNode* PDN = (PointerDataNode*)Node;
             
-            for( std::string LabelName: PDN->LabelNames )
+            for( const std::string& LabelName: PDN->LabelNames )
             {
+                int32_t WordAddress = InitialROMAddress + ROM.size();
                 ROM.emplace_back();
-                ROM.back().AsInteger = GetLabelAddress( *Node, LabelName );
+                ROM.back().AsInteger = GetLabelAddress( *Node, LabelName, WordAddress );
             }
         }
         
-        // CASE 5: Data Files -> Add all its contents to ROM
+        // CASE 5: Labels -> Take the current ROM address
+        else if( Node->Type() == ASTNodeTypes::Label )
+        {
+            LabelNode* LN = (LabelNode*)Node;
+            DeclareSymbol( *Node, LN->Name, ProgramSymbolTypes::Label, Node->AddressInROM );
+        }
+        
+        // CASE 6: Data Files -> Add all its contents to ROM
         else if( Node->Type() == ASTNodeTypes::DataFile )
         {
             DataFileNode* DFN = (DataFileNode*)Node;
+            ReadDataFile( *DFN );
+        }
+        
+        // CASE 7: RAM variables are placed consecutively
+        // from the start of RAM (for object files the
+        // linker will place them after others)
+        else if( Node->Type() == ASTNodeTypes::RAMVariable )
+        {
+            RAMVariableNode* RVN = (RAMVariableNode*)Node;
+            RVN->AddressInRAM = Constants::RAMFirstAddress + RAMSize;
+            DeclareSymbol( *Node, RVN->Name, ProgramSymbolTypes::RAMVariable, RVN->AddressInRAM );
+            RAMSize += RVN->SizeInWords;
             
-            for( V32Word Word: DFN->FileContents )
-              ROM.push_back( Word );
+            if( RAMSize > Constants::RAMSize )
+              EmitError( Node->Location, "RAM variables exceed the available RAM" );
+        }
+        
+        // CASE 8: Shared symbols just mark their name,
+        // which can be used before or after this
+        else if( Node->Type() == ASTNodeTypes::SharedSymbol )
+        {
+            SharedSymbolNode* SSN = (SharedSymbolNode*)Node;
+            Symbols[ Symbols.Intern( SSN->Name ) ].IsShared = true;
+            SharedSymbols.push_back( SSN );
         }
         
         // (define nodes are ignored)
     }
+    
+    ResolvePendingReferences();
+    
+    // names marked as shared must be defined here too,
+    // since the linker may take this module's definition
+    for( SharedSymbolNode* SSN: SharedSymbols )
+      if( Symbols[ Symbols.Intern( SSN->Name ) ].Type == ProgramSymbolTypes::Undeclared )
+        EmitError( SSN->Location, "shared symbol \"" + SSN->Name + "\" is not defined" );
+}
+
+// -----------------------------------------------------------------------------
+
+// call after emission, to build the object file for this module
+void VirconASMEmitter::CreateObject( ObjectFile& Object )
+{
+    Object.Words = ROM;
+    Object.RAMSize = RAMSize;
+    Object.Relocations = Relocations;
+    Object.Symbols.clear();
+    
+    // all labels are exported, and the linker will resolve
+    // each reference to the one in the same module if it exists
+    // (names referred to but not declared are not exported)
+    for( uint32_t SymbolID = 0; SymbolID < Symbols.Size(); SymbolID++ )
+    {
+        const ProgramSymbol& Declared = Symbols[ SymbolID ];
+        
+        if( Declared.Type == ProgramSymbolTypes::Undeclared )
+          continue;
+        
+        ObjectSymbol Symbol;
+        Symbol.Name = Declared.Name;
+        Symbol.IsShared = Declared.IsShared;
+        
+        if( Declared.Type == ProgramSymbolTypes::Label )
+        {
+            Symbol.Section = ObjectSections::ROM;
+            Symbol.Offset = Declared.Address - InitialROMAddress;
+        }
+        
+        else
+        {
+            Symbol.Section = ObjectSections::RAM;
+            Symbol.Offset = Declared.Address - Constants::RAMFirstAddress;
+        }
+        
+        Object.Symbols.push_back( Symbol );
+    }
+    
+    // keep symbols in a fixed order: labels first,
+    // then RAM variables, each sorted by name
+    sort
+    (
+        Object.Symbols.begin(), Object.Symbols.end(),
+        []( const ObjectSymbol& S1, const ObjectSymbol& S2 )
+        {
+            if( S1.Section != S2.Section )
+              return S1.Section == ObjectSections::ROM;
+            
+            return S1.Name < S2.Name;
+        }
+    );
+    
+    Object.IndexSymbols();
+}
 }
@@ -6,14 +6,20 @@
     // include common Vircon headers
     #include "../../VirconDefinitions/DataStructures.hpp"
     
+    // include infrastructure headers
+    #include "../DevToolsInfrastructure/ObjectFiles.hpp"
+    
     // include project headers
     #include "ASTNodes.hpp"
+    #include "SymbolTable.hpp"
     
     // include C/C++ headers
-    #include <map>              // [ C++ STL ] Maps
+    #include <vector>           // [ C++ STL ] Vectors
 // *****************************************************************************
 
 
+namespace VirconASM
+{
 // =============================================================================
 //      EMIT FROM GENERIC INSTRUCTION NODE
 // =============================================================================
@@ -26,11 +32,35 @@ class VirconASMEmitter
         // link to source data
         NodeList* ProgramAST;
         
+        // uses of labels or variables not declared
+        // yet, to be filled when emission ends
+        struct PendingReference
+        {
+            uint32_t ROMIndex;
+            uint32_t SymbolID;
+            ASTNode* ReferringNode;
+        };
+        
+        std::vector< PendingReference > PendingReferences;
+        
+        // names marked as shared, to check that
+        // they are defined when emission ends
+        std::vector< SharedSymbolNode* > SharedSymbols;
+        
+        // helpers for the main function
+        void DeclareSymbol( ASTNode& Node, const std::string& Name, ProgramSymbolTypes Type, int32_t Address );
+        void ResolvePendingReferences();
+        
     public:
         
         // results
         std::vector< V32::V32Word > ROM;
-        std::map< std::string, int32_t > LabelAddresses;
+        SymbolTable Symbols;
+        int32_t RAMSize;
+        
+        // only for object files: every use of
+        // a label or variable needs a relocation
+        std::vector< ObjectRelocation > Relocations;
         
     public:
         
@@ -40,7 +70,7 @@ class VirconASMEmitter
         
         // helpers for emit functions
         void CheckOperands( InstructionNode& Node, int NumberOfOperands );
-        int32_t GetLabelAddress( ASTNode& ReferringNode, std::string LabelName );
+        int32_t GetLabelAddress( ASTNode& ReferringNode, std::string LabelName, int32_t WordAddress );
         void ReadDataFile( DataFileNode& Node );
         
         int32_t      GetValueAsAddress  ( InstructionNode& Node, BasicValue& Value );
@@ -56,7 +86,11 @@ class VirconASMEmitter
         
         // main assembly function
         void Emit( NodeList& ProgramAST_ );
+        
+        // output for separate assembly
+        void CreateObject( ObjectFile& Object );
 };
+}
 
 
 // *****************************************************************************
@@ -12,6 +12,8 @@
     // include C/C++ headers
     #include <cstring>      // [ ANSI C ] Stringds
     #include <stdexcept>    // [ C++ STL ] Exceptions
+    #include <fstream>      // [ C++ STL ] File streams
+    #include <sstream>      // [ C++ STL ] String streams
     #include <map>          // [ C++ STL ] Maps
     
     // declare used namespaces
@@ -20,6 +22,8 @@
 // *****************************************************************************
 
 
+namespace VirconASM
+{
 // =============================================================================
 //      CHARACTER CLASSIFICATION FUNCTIONS
 // =============================================================================
@@ -92,7 +96,7 @@ VirconASMLexer::VirconASMLexer()
 
 VirconASMLexer::~VirconASMLexer()
 {
-    for( TokenList Line: TokenLines )
+    for( TokenList& Line: TokenLines )
     {
         for( Token* T : Line )
           delete T;
@@ -111,28 +115,41 @@ VirconASMLexer::~VirconASMLexer()
 
 void VirconASMLexer::OpenFile( const string& FilePath )
 {
-    // reset any previous state
-    Input.close();
-    Input.clear();
-    
     // open the file as binary, not as text!
-    // (otherwise there can be bugs using tellg/seekg and unget)
-    OpenInputFile( Input, FilePath, ios_base::in | ios_base::binary );
-    Input.seekg( 0, ios::beg );
+    // (otherwise line breaks would not be kept as they are)
+    ifstream InputFile;
+    OpenInputFile( InputFile, FilePath, ios_base::in | ios_base::binary );
     
-    if( Input.fail() )
+    if( InputFile.fail() )
       throw runtime_error( "cannot open input file \"" + FilePath + "\"" );
     
+    // read all file contents at once
+    stringstream FileContents;
+    FileContents << InputFile.rdbuf();
+    InputFile.close();
+    
+    OpenText( FileContents.str(), FilePath );
+}
+
+// -----------------------------------------------------------------------------
+
+void VirconASMLexer::OpenText( const string& SourceText, const string& SourcePath )
+{
+    // reset any previous state
+    InputText = SourceText;
+    InputPosition = 0;
+    InputEnded = false;
+    
     // capture the input file directory
-    InputDirectory = GetPathDirectory( FilePath );
+    InputDirectory = GetPathDirectory( SourcePath );
     
     // reset any previous reads
-    ReadLocation.FilePath = FilePath;
+    ReadLocation.FilePath = SourcePath;
     ReadLocation.Line = 1;
     PreviousChar = ' ';
     
     // reset any previous results
-    for( TokenList Line: TokenLines )
+    for( TokenList& Line: TokenLines )
     {
         for( Token* T : Line )
           delete T;
@@ -154,8 +171,8 @@ void VirconASMLexer::OpenFile( const string& FilePath )
 
 void VirconASMLexer::CloseFile()
 {
-    // we are finished with the input file
-    Input.close();
+    // we are finished with the input text
+    InputText.clear();
     
     // complete the list with an end-of-file indicator
     EndOfFileToken* LastToken = new EndOfFileToken;
@@ -171,13 +188,20 @@ void VirconASMLexer::CloseFile()
 // =============================================================================
 
 
-// use this instead of just Input.get()
+// use this to read characters
 // so that we can keep track of file position
 char VirconASMLexer::GetChar()
 {
     // don't attempt to get characters from an ended file
-    if( Input.eof() ) return ' ';
-    char c = Input.get();
+    if( InputEnded ) return ' ';
+    
+    // reading past the end gives EOF, like a stream would
+    char c = (char)EOF;
+    
+    if( InputPosition < InputText.size() )
+      c = InputText[ InputPosition++ ];
+    else
+      InputEnded = true;
     
     // always check that read characters are valid
     if( IsInvalidAscii( c ) )
@@ -203,26 +227,23 @@ char VirconASMLexer::GetChar()
 
 // -----------------------------------------------------------------------------
 
-// use this instead of just Input.peek()
-// to reliably detect the end of file
+// use this to reliably detect the end of file
 char VirconASMLexer::PeekChar()
 {
-    int c = Input.peek();
-    
-    if( c == EOF )
+    if( InputPosition >= InputText.size() )
       return GetChar();
     
-    return (char)c;
+    return InputText[ InputPosition ];
 }
 
 // -----------------------------------------------------------------------------
 
 // use this for reliability!
-// (input will not set eof() until a read past the end has been attempted)
+// (input is not marked as ended until a read past the end has been attempted)
 bool VirconASMLexer::InputHasEnded()
 {
     PeekChar();
-    return Input.eof();
+    return InputEnded;
 }
 
 
@@ -702,13 +723,28 @@ TokenList VirconASMLexer::TokenizeNextLine()
 
 // -----------------------------------------------------------------------------
 
-void VirconASMLexer::TokenizeFile( const std::string& FilePath )
+void VirconASMLexer::TokenizeInput()
 {
-    OpenFile( FilePath );
-    
-    // recognize all file text as tokens
+    // recognize all input text as tokens
     while( !InputHasEnded() )
       TokenLines.push_back( TokenizeNextLine() );
     
     CloseFile();
 }
+
+// -----------------------------------------------------------------------------
+
+void VirconASMLexer::TokenizeFile( const std::string& FilePath )
+{
+    OpenFile( FilePath );
+    TokenizeInput();
+}
+
+// -----------------------------------------------------------------------------
+
+void VirconASMLexer::TokenizeText( const std::string& SourceText, const std::string& SourcePath )
+{
+    OpenText( SourceText, SourcePath );
+    TokenizeInput();
+}
+}
@@ -8,11 +8,13 @@
     
     // include C/C++ headers
     #include <iostream>     // [ C++ STL ] I/O Streams
-    #include <fstream>      // [ C++ STL ] File streams
+    #include <string>       // [ C++ STL ] Strings
     #include <vector>       // [ C++ STL ] Vectors
 // *****************************************************************************
 
 
+namespace VirconASM
+{
 // =============================================================================
 //      CHARACTER CLASSIFICATION FUNCTIONS
 // =============================================================================
@@ -36,8 +38,11 @@ class VirconASMLexer
 {
     public:
         
-        // source input file
-        std::ifstream Input;
+        // source input text (file contents are
+        // read in full before starting to lex)
+        std::string InputText;
+        size_t InputPosition;
+        bool InputEnded;
         std::string InputDirectory;
         
         // lexing state
@@ -54,6 +59,7 @@ class VirconASMLexer
         
         // input file handling
         void OpenFile( const std::string& FilePath );
+        void OpenText( const std::string& SourceText, const std::string& SourcePath );
         void CloseFile();
         
         // reading from input
@@ -82,6 +88,7 @@ class VirconASMLexer
         // partial lexing functions
         Token* ReadNextToken();        
         TokenList TokenizeNextLine();
+        void TokenizeInput();
         
     public:
         
@@ -89,9 +96,12 @@ class VirconASMLexer
         VirconASMLexer();
        ~VirconASMLexer();
         
-        // full lexing function
+        // full lexing functions; for text, the path
+        // is only used for locations and includes
         void TokenizeFile( const std::string& FilePath );
+        void TokenizeText( const std::string& SourceText, const std::string& SourcePath );
 };
+}
 
 
 // *****************************************************************************
@@ -10,6 +10,8 @@
 // *****************************************************************************
 
 
+namespace VirconASM
+{
 // =============================================================================
 //      VIRCON ASM PARSER: INSTANCE HANDLING
 // =============================================================================
@@ -187,6 +189,24 @@ InstructionOperand VirconASMParser::ParseOperand( TokenIterator& TokenPosition )
     // read operand base
     Operand.Base = ParseBasicValue( TokenPosition );
     
+    // labels can be followed by an offset to
+    // form addresses within a group of words
+    if( !Operand.IsMemoryAddress && Operand.Base.Type == BasicValueTypes::Label )
+    {
+        Token* AfterBaseToken = *TokenPosition;
+        
+        if( AreInSameLine( StartToken, AfterBaseToken ) )
+          if( TokenIsThisSymbol( AfterBaseToken, SymbolTypes::Plus ) || TokenIsThisSymbol( AfterBaseToken, SymbolTypes::Minus ) )
+          {
+              BasicValue Offset = ParseBasicValue( TokenPosition );
+              
+              if( Offset.Type != BasicValueTypes::LiteralInteger )
+                EmitError( StartToken->Location, "label offsets must be in the form label +/- integer" );
+              
+              Operand.Base.LabelOffset = Offset.IntegerField;
+          }
+    }
+    
     // extra parsing after a base offset
     if( Operand.IsMemoryAddress )
     {
@@ -220,11 +240,19 @@ InstructionOperand VirconASMParser::ParseOperand( TokenIterator& TokenPosition )
     // operand has been parsed, now validate it
     
     // addresses with offsets can only be [register + integer]
+    // or [label + integer]; the latter is just a fixed address
     if( Operand.HasOffset )
     {
-        if( Operand.Base.Type != BasicValueTypes::CPURegister
+        if( Operand.Base.Type == BasicValueTypes::Label
+        &&  Operand.Offset.Type == BasicValueTypes::LiteralInteger )
+        {
+            Operand.Base.LabelOffset = Operand.Offset.IntegerField;
+            Operand.HasOffset = false;
+        }
+        
+        else if( Operand.Base.Type != BasicValueTypes::CPURegister
         ||  Operand.Offset.Type != BasicValueTypes::LiteralInteger )
-          EmitError( StartToken->Location, "memory addresses with offset must be in the form [register +/- integer]" );
+          EmitError( StartToken->Location, "memory addresses with offset must be in the form [register/label +/- integer]" );
     }
     
     // addresses without offsets must be either register, integer or label
@@ -521,6 +549,84 @@ DataFileNode* VirconASMParser::ParseDataFile( TokenIterator& TokenPosition )
     return NewNode;
 }
 
+// -----------------------------------------------------------------------------
+
+RAMVariableNode* VirconASMParser::ParseRAMVariable( TokenIterator& TokenPosition )
+{
+    // consume the definition keyword
+    Token* KeywordToken = *TokenPosition;
+    TokenPosition++;
+    
+    // create a node
+    RAMVariableNode* NewNode = new RAMVariableNode;
+    NewNode->Location = KeywordToken->Location;
+    NewNode->AddressInRAM = 0;
+    
+    // expect a name in the same line
+    ExpectSameLine( KeywordToken, *TokenPosition );
+    Token* NameToken = *TokenPosition;
+    
+    if( NameToken->Type() != TokenTypes::Label )
+      EmitError( KeywordToken->Location, "expected a label as variable name" );
+    
+    NewNode->Name = ((LabelToken*)NameToken)->Name;
+    TokenPosition++;
+    
+    // expect a comma in the same line
+    ExpectSameLine( KeywordToken, *TokenPosition );
+    
+    if( !TokenIsThisSymbol( *TokenPosition, SymbolTypes::Comma ) )
+      EmitError( KeywordToken->Location, "expected comma after variable name" );
+    
+    TokenPosition++;
+    
+    // expect the size as an integer
+    ExpectSameLine( KeywordToken, *TokenPosition );
+    Token* SizeToken = *TokenPosition;
+    
+    if( SizeToken->Type() != TokenTypes::LiteralInteger )
+      EmitError( KeywordToken->Location, "expected variable size as an integer" );
+    
+    NewNode->SizeInWords = ((LiteralIntegerToken*)SizeToken)->Value;
+    
+    if( NewNode->SizeInWords <= 0 )
+      EmitError( KeywordToken->Location, "variable size must be positive" );
+    
+    // expect an end of line
+    TokenPosition++;
+    ExpectEndOfLine( KeywordToken, *TokenPosition );
+    
+    return NewNode;
+}
+
+// -----------------------------------------------------------------------------
+
+SharedSymbolNode* VirconASMParser::ParseSharedSymbol( TokenIterator& TokenPosition )
+{
+    // consume the definition keyword
+    Token* KeywordToken = *TokenPosition;
+    TokenPosition++;
+    
+    // create a node
+    SharedSymbolNode* NewNode = new SharedSymbolNode;
+    NewNode->Location = KeywordToken->Location;
+    
+    // expect a name in the same line
+    ExpectSameLine( KeywordToken, *TokenPosition );
+    Token* NameToken = *TokenPosition;
+    
+    if( NameToken->Type() != TokenTypes::Label )
+      EmitError( KeywordToken->Location, "expected a label as shared symbol name" );
+    
+    NewNode->Name = ((LabelToken*)NameToken)->Name;
+    
+    // expect an end of line
+    TokenPosition++;
+    ExpectEndOfLine( KeywordToken, *TokenPosition );
+    
+    return NewNode;
+}
+
 
 // =============================================================================
 //      VIRCON ASM PARSER: MAIN PARSER FUNCTION
@@ -540,10 +646,9 @@ void VirconASMParser::ParseTopLevel( TokenList& Tokens_ )
     
     Tokens.clear();
     
-    // copy the source list, cloning all tokens
+    // take all tokens from the source list
     // (to ensure we don't leave dangling pointers)
-    for( Token* T : Tokens_ )
-      Tokens.push_back( T->Clone() );
+    Tokens.splice( Tokens.end(), Tokens_ );
     
     // parse the whole token list
     TokenIterator TokenPosition = Tokens.begin();
@@ -619,7 +724,24 @@ void VirconASMParser::ParseTopLevel( TokenList& Tokens_ )
             continue;
         }
         
+        // CASE 8: RAM variable
+        if( TokenIsThisKeyword( NextToken, KeywordTypes::RAM ) )
+        {
+            RAMVariableNode* ParsedVariable = ParseRAMVariable( TokenPosition );
+            ProgramAST.push_back( ParsedVariable );
+            continue;
+        }
+        
+        // CASE 9: Shared symbol
+        if( TokenIsThisKeyword( NextToken, KeywordTypes::Shared ) )
+        {
+            SharedSymbolNode* ParsedSymbol = ParseSharedSymbol( TokenPosition );
+            ProgramAST.push_back( ParsedSymbol );
+            continue;
+        }
+        
         // other (not valid)
         EmitError( NextToken->Location, "invalid start of sentence: " + NextToken->ToString() );
     }
 }
+}
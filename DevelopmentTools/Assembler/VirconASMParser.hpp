@@ -12,6 +12,8 @@
 // *****************************************************************************
 
 
+namespace VirconASM
+{
 // =============================================================================
 //      VIRCON ASM PARSER
 // =============================================================================
@@ -50,6 +52,8 @@ class VirconASMParser
         PointerDataNode* ParsePointerData( TokenIterator& TokenPosition );
         LabelNode* ParseLabel( TokenIterator& TokenPosition );
         DataFileNode* ParseDataFile( TokenIterator& TokenPosition );
+        RAMVariableNode* ParseRAMVariable( TokenIterator& TokenPosition );
+        SharedSymbolNode* ParseSharedSymbol( TokenIterator& TokenPosition );
         
     public:
         
@@ -59,6 +63,7 @@ class VirconASMParser
         // main parsing function
         void ParseTopLevel( TokenList& Tokens_ );
 };
+}
 
 
 // *****************************************************************************
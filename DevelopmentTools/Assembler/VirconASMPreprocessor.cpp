@@ -12,6 +12,8 @@
 // *****************************************************************************
 
 
+namespace VirconASM
+{
 // =============================================================================
 //      PROCESSING CONTEXT CLASS
 // =============================================================================
@@ -26,8 +28,8 @@ ProcessingContext::ProcessingContext()
 
 ProcessingContext::~ProcessingContext()
 {
-    // delete all cloned tokens
-    for( TokenList Line: SourceLines )
+    // delete all remaining tokens
+    for( TokenList& Line: SourceLines )
       for( Token* T: Line )
         delete T;
 }
@@ -133,17 +135,13 @@ void VirconASMPreprocessor::PushContext( VirconASMLexer& Lexer )
     TokenList& FirstLine = Lexer.TokenLines.front();
     NewContext.FilePath = FirstLine.front()->Location.FilePath;
     
-    // clone all lexer lines into the current context
-    for( TokenList Line: Lexer.TokenLines )
-    {
-        // insert a new empty line after the last one
-        NewContext.SourceLines.emplace_back();
-        TokenList& ClonedList = NewContext.SourceLines.back();
-        
-        // clone all tokens into the new line
-        for( Token* T: Line )
-          ClonedList.push_back( T->Clone() );
-    }
+    // take all lexer lines into the current context
+    // (moving them avoids cloning every token, and the
+    // lexer is not used again after being preprocessed)
+    for( TokenList& Line: Lexer.TokenLines )
+      NewContext.SourceLines.emplace_back( move( Line ) );
+    
+    Lexer.TokenLines.clear();
     
     // finally initialize iteration
     NewContext.LinePosition = NewContext.SourceLines.begin();
@@ -176,7 +174,7 @@ void VirconASMPreprocessor::PopContext()
     if( ContextStack.empty() )
       return;
     
-    // cloned token lines are deleted by the destructor
+    // remaining token lines are deleted by the destructor
     ContextStack.pop_back();
 }
 
@@ -314,7 +312,7 @@ void VirconASMPreprocessor::ProcessLine()
     bool LineIsIgnored = !ContextStack.back().AreAllIfConditionsMet();
     bool LineIsDirective = TokenIsThisSymbol( Line.front(), SymbolTypes::Percent );
     
-    // CASE 3: non-directive lines are just cloned and appended to the output
+    // CASE 3: non-directive lines are just moved to the output
     // (after performing replacements on defined identifiers)
     if( !LineIsDirective )
     {
@@ -331,9 +329,8 @@ void VirconASMPreprocessor::ProcessLine()
                   EmitError( Line.front()->Location, "definition replacement is too deep (possible circular reference)" );
             }
             
-            // now copy the replaced line to the output
-            for( Token* T: Line )
-              ProcessedTokens.push_back( T->Clone() );
+            // now move the replaced line to the output
+            ProcessedTokens.splice( ProcessedTokens.end(), Line );
         }
         
         return;
@@ -650,3 +647,4 @@ void VirconASMPreprocessor::Preprocess( VirconASMLexer& Lexer )
         PopContext();
     }
 }
+}
@@ -13,6 +13,8 @@
 // *****************************************************************************
 
 
+namespace VirconASM
+{
 /* ------------------------------- GENERAL NOTES--------------------------------
 
   1) Since we need to iterate on processing contexts, instead of using the
@@ -47,7 +49,7 @@ class ProcessingContext
         std::string ReferenceFolder;
         
         // parsing progress within lexer lines
-        std::list< TokenList > SourceLines;   // copies so that nested lexers can be destroyed
+        std::list< TokenList > SourceLines;   // taken from lexers so they can be destroyed
         std::list< TokenList >::iterator LinePosition;
         
         // nested "if" contexts
@@ -121,6 +123,7 @@ class VirconASMPreprocessor
         // main processing function
         void Preprocess( VirconASMLexer& Lexer );
 };
+}
 
 
 // *****************************************************************************
@@ -5,6 +5,7 @@
     // include project headers
     #include "CNodes.hpp"
     #include "CompilerInfrastructure.hpp"
+    #include "../DevToolsInfrastructure/MemoryPools.hpp"
     
     // declare used namespaces
     using namespace std;
@@ -31,6 +32,20 @@ CNode::CNode( CNode* Parent_ )
 
 // -----------------------------------------------------------------------------
 
+void* CNode::operator new( size_t Size )
+{
+    return NodesPool().Allocate( Size );
+}
+
+// -----------------------------------------------------------------------------
+
+void CNode::operator delete( void* Node, size_t Size )
+{
+    NodesPool().Release( Node, Size );
+}
+
+// -----------------------------------------------------------------------------
+
 ScopeNode* CNode::FindClosestScope( bool IncludeItself )
 {
     // find its closest containing scope
@@ -195,7 +210,7 @@ ScopeNode::~ScopeNode()
 
 // -----------------------------------------------------------------------------
 
-CNode* ScopeNode::ResolveIdentifier( std::string Name )
+CNode* ScopeNode::ResolveIdentifier( const string& Name )
 {
     // search for it in local scope
     auto Pair = DeclaredIdentifiers.find( Name );
@@ -221,7 +236,7 @@ CNode* ScopeNode::ResolveIdentifier( std::string Name )
 
 // -----------------------------------------------------------------------------
 
-void ScopeNode::DeclareNewIdentifier( string Name, CNode* NewDeclaration )
+void ScopeNode::DeclareNewIdentifier( const string& Name, CNode* NewDeclaration )
 {
     // when the name was not in use, simply add it
     auto Pair = DeclaredIdentifiers.find( Name );
@@ -127,6 +127,10 @@ class CNode
         CNode( CNode* Parent_ );
         virtual ~CNode() {};
         
+        // nodes are taken from their own memory pool
+        static void* operator new( size_t Size );
+        static void operator delete( void* Node, size_t Size );
+        
         // node classification
         virtual CNodeTypes Type() = 0;
         virtual bool IsExpression()         { return false; };
@@ -226,8 +230,8 @@ class ScopeNode: public CNode
         virtual std::string ToXML() = 0;
         
         // allocation and resolution of names
-        CNode* ResolveIdentifier( std::string Name );
-        void DeclareNewIdentifier( std::string Name, CNode* NewDeclaration );
+        CNode* ResolveIdentifier( const std::string& Name );
+        void DeclareNewIdentifier( const std::string& Name, CNode* NewDeclaration );
         
         // allocation of variable space in caller's stack frame
         void AllocateVariablesInStack();
@@ -1,11 +1,13 @@
 // *****************************************************************************
     // include project headers
     #include "CTokens.hpp"
+    #include "../DevToolsInfrastructure/MemoryPools.hpp"
     
     // include C/C++ headers
     #include <iostream>     // [ C++ STL ] I/O Streams
     #include <fstream>      // [ C++ STL ] File streams
     #include <map>          // [ C++ STL ] Maps
+    #include <unordered_map>    // [ C++ STL ] Unordered maps
     
     // declare used namespaces
     using namespace std;
@@ -110,6 +112,30 @@ const map< SpecialSymbolTypes, char > SpecialSymbolNames =
 };
 
 
+// =============================================================================
+//      STRING --> TOKEN TYPES MAPS
+// =============================================================================
+
+
+// the lexer checks every word it reads against keywords
+// and operators, so those checks need direct lookups
+template< typename T >
+unordered_map< string, T > InvertNamesMap( const map< T, string >& NamesMap )
+{
+    unordered_map< string, T > Result;
+    
+    for( const auto& MapPair : NamesMap )
+      Result[ MapPair.second ] = MapPair.first;
+    
+    return Result;
+}
+
+// -----------------------------------------------------------------------------
+
+const unordered_map< string, KeywordTypes > KeywordsByName = InvertNamesMap( KeywordNames );
+const unordered_map< string, OperatorTypes > OperatorsByName = InvertNamesMap( OperatorNames );
+
+
 // =============================================================================
 //      TOKEN TYPES: DETECTION FROM A STRING
 // =============================================================================
@@ -117,24 +143,14 @@ const map< SpecialSymbolTypes, char > SpecialSymbolNames =
 
 bool IsKeyword( const std::string& Word )
 {
-    // search in the map
-    for( auto MapPair : KeywordNames )
-      if( MapPair.second == Word )
-        return true;
-    
-    return false;
+    return (KeywordsByName.find( Word ) != KeywordsByName.end());
 }
 
 // -----------------------------------------------------------------------------
 
 bool IsOperator( const std::string& Word )
 {
-    // search in the map
-    for( auto MapPair : OperatorNames )
-      if( MapPair.second == Word )
-        return true;
-    
-    return false;    
+    return (OperatorsByName.find( Word ) != OperatorsByName.end());
 }
 
 // -----------------------------------------------------------------------------
@@ -170,9 +186,9 @@ bool IsSpecialSymbol( const char c )
 KeywordTypes WhichKeyword( const string& Name )
 {
     // search in the map
-    for( auto MapPair : KeywordNames )
-      if( MapPair.second == Name )
-        return MapPair.first;
+    auto MapPair = KeywordsByName.find( Name );
+    if( MapPair != KeywordsByName.end() )
+      return MapPair->second;
     
     // not found
     throw runtime_error( "string cannot be converted to a keyword" );
@@ -183,9 +199,9 @@ KeywordTypes WhichKeyword( const string& Name )
 OperatorTypes WhichOperator( const string& Name )
 {
     // search in the map
-    for( auto MapPair : OperatorNames )
-      if( MapPair.second == Name )
-        return MapPair.first;
+    auto MapPair = OperatorsByName.find( Name );
+    if( MapPair != OperatorsByName.end() )
+      return MapPair->second;
     
     // not found
     throw runtime_error( "string cannot be converted to an operator" );
@@ -280,6 +296,24 @@ string SpecialSymbolToString( SpecialSymbolTypes Which )
 }
 
 
+// =============================================================================
+//      TOKEN CLASSES: MEMORY ALLOCATION
+// =============================================================================
+
+
+void* CToken::operator new( size_t Size )
+{
+    return TokensPool().Allocate( Size );
+}
+
+// -----------------------------------------------------------------------------
+
+void CToken::operator delete( void* Token, size_t Size )
+{
+    TokensPool().Release( Token, Size );
+}
+
+
 // =============================================================================
 //      TOKEN CLASSES: STRING CONVERSIONS
 // =============================================================================
@@ -172,6 +172,10 @@ class CToken
         
         virtual ~CToken() {};   // needed for base classes to be destructed
         
+        // tokens are taken from their own memory pool
+        static void* operator new( size_t Size );
+        static void operator delete( void* Token, size_t Size );
+        
         virtual CTokenTypes Type() = 0;
         virtual std::string ToString() = 0;
         virtual CToken* Clone() = 0;
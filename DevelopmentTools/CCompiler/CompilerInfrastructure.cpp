@@ -11,6 +11,7 @@
     #include <iostream>     // [ C++ STL ] I/O Streams
     #include <fstream>      // [ C++ STL ] File streams
     #include <map>          // [ C++ STL ] Maps
+    #include <cctype>       // [ ANSI C ] Character handling
     
     // declare used namespaces
     using namespace std;
@@ -98,7 +99,7 @@ void RaiseWarning( SourceLocation Location, const std::string& Description )
     }
     
     // otherwise report the warning normally
-    cerr << Location.FilePath << ':' << Location.Line << ':' << Location.Column;
+    cerr << *Location.FilePath << ':' << Location.Line << ':' << Location.Column;
     cerr << ": warning: " << Description << endl;
 }
 
@@ -113,7 +114,7 @@ void RaiseError( SourceLocation Location, const std::string& Description )
       throw runtime_error( "error: maximum errors have been reached" );
     
     // otherwise report the error normally
-    cerr << Location.FilePath << ':' << Location.Line << ':' << Location.Column;
+    cerr << *Location.FilePath << ':' << Location.Line << ':' << Location.Column;
     cerr << ": error: " << Description << endl;
 }
 
@@ -122,7 +123,7 @@ void RaiseError( SourceLocation Location, const std::string& Description )
 void RaiseFatalError( SourceLocation Location, const std::string& Description )
 {
     // report the fatal error
-    cerr << Location.FilePath << ':' << Location.Line << ':' << Location.Column;
+    cerr << *Location.FilePath << ':' << Location.Line << ':' << Location.Column;
     cerr << ": fatal error: " << Description << endl;
     
     // stop compilation
@@ -305,3 +306,56 @@ string ExpectIdentifier( CTokenIterator& TokenPosition )
     // avoid compiler warning
     return "";
 }
+
+
+// =============================================================================
+//      SUPPORT FUNCTIONS FOR ASSEMBLY TEXT
+// =============================================================================
+
+
+// separates an assembly line into its words (mnemonic, registers,
+// port names, etc) so that the used registers can be identified
+vector< string > SplitAssemblyWords( const string& Line )
+{
+    vector< string > Words;
+    string CurrentWord;
+    
+    for( char c: Line )
+    {
+        if( isalnum( (unsigned char)c ) || c == '_' )
+          CurrentWord += toupper( (unsigned char)c );
+        
+        else if( !CurrentWord.empty() )
+        {
+            Words.push_back( CurrentWord );
+            CurrentWord.clear();
+        }
+    }
+    
+    if( !CurrentWord.empty() )
+      Words.push_back( CurrentWord );
+    
+    return Words;
+}
+
+// -----------------------------------------------------------------------------
+
+// returns the register number for a register name, or -1 for any other word
+int AssemblyRegisterNumber( const string& Word )
+{
+    if( Word == "CR" ) return 11;
+    if( Word == "SR" ) return 12;
+    if( Word == "DR" ) return 13;
+    if( Word == "BP" ) return 14;
+    if( Word == "SP" ) return 15;
+    
+    if( Word.size() < 2 || Word.size() > 3 || Word[0] != 'R' )
+      return -1;
+    
+    for( unsigned i = 1; i < Word.size(); i++ )
+      if( !isdigit( (unsigned char)Word[i] ) )
+        return -1;
+    
+    int Number = stoi( Word.substr( 1 ) );
+    return (Number <= 15? Number : -1);
+}
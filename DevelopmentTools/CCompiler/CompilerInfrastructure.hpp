@@ -9,6 +9,7 @@
     
     // include C/C++ headers
     #include <string>           // [ C++ STL ] Strings
+    #include <vector>           // [ C++ STL ] Vectors
 // *****************************************************************************
 
 
@@ -51,6 +52,18 @@ void ExpectOperator( CTokenIterator& TokenPosition, OperatorTypes Expected );
 std::string ExpectIdentifier( CTokenIterator& TokenPosition );
 
 
+// =============================================================================
+//      SUPPORT FUNCTIONS FOR ASSEMBLY TEXT
+// =============================================================================
+
+
+// words are returned in upper case
+std::vector< std::string > SplitAssemblyWords( const std::string& Line );
+
+// returns -1 when the word is not a register name
+int AssemblyRegisterNumber( const std::string& Word );
+
+
 // *****************************************************************************
     // end include guard
     #endif
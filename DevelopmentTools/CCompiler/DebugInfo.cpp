@@ -57,7 +57,7 @@ void SaveDebugInfoFile( const string& FilePath, const string& ASMFilePath, const
     {
         DebugInfoFile << NormalizedASMPath;
         DebugInfoFile << "," << MapPair.first;
-        DebugInfoFile << "," << NormalizePath( MapPair.second->Location.FilePath );
+        DebugInfoFile << "," << NormalizePath( *MapPair.second->Location.FilePath );
         DebugInfoFile << "," << MapPair.second->Location.Line;
         
         // check if this line corresponds to a function;
@@ -93,10 +93,10 @@ void SaveLexerLog( const string& FilePath, const VirconCPreprocessor& Preprocess
     
     for( auto T : Preprocessor.ProcessedTokens )
     {
-        if( T->Location.FilePath != PathContext )
+        if( *T->Location.FilePath != PathContext )
         {
-            LogFile << endl << "File " + T->Location.FilePath + ":" << endl << endl;
-            PathContext = T->Location.FilePath;
+            LogFile << endl << "File " + *T->Location.FilePath + ":" << endl << endl;
+            PathContext = *T->Location.FilePath;
         }
         
         LogFile << "[" + to_string( T->Location.Line ) + "] ";
@@ -125,3 +125,50 @@ void SaveParserLog( const string& FilePath, const VirconCParser& Parser )
     
     LogFile.close();
 }
+
+// -----------------------------------------------------------------------------
+
+void SaveOptimizerLog( const string& FilePath, const VirconCOptimizer& Optimizer )
+{
+    if( VerboseMode )
+      cout << "Debug mode: Saving optimizer log" << endl;
+    
+    ofstream LogFile;
+    OpenOutputFile( LogFile, FilePath );
+    
+    if( LogFile.fail() )
+      throw runtime_error( "cannot open optimizer log file \"" + FilePath + "\"" );
+    
+    // log a summary of the results
+    LogFile << "optimization results:" << endl;
+    LogFile << "  basic blocks: " << Optimizer.Blocks.size() << endl;
+    LogFile << "  removed lines: " << Optimizer.RemovedLines << endl;
+    LogFile << "  rewritten lines: " << Optimizer.RewrittenLines << endl;
+    
+    // log every basic block, marking which
+    // lines were removed or rewritten and why
+    for( unsigned b = 0; b < Optimizer.Blocks.size(); b++ )
+    {
+        const BasicBlock& Block = Optimizer.Blocks[ b ];
+        LogFile << endl << "block " << b << ":" << endl;
+        
+        for( int i = Block.FirstLine; i < Block.EndLine; i++ )
+        {
+            const OptimizedLine& Line = Optimizer.Lines[ i ];
+            
+            if( Line.Type == AssemblyLineTypes::NonCode )
+              continue;
+            
+            if( Line.Removed )
+              LogFile << "  - " << Line.OriginalText << "    ; " << Line.Note << endl;
+            
+            else if( !Line.Note.empty() )
+              LogFile << "  * " << Line.Text << "    ; " << Line.Note << endl;
+            
+            else
+              LogFile << "    " << Line.Text << endl;
+        }
+    }
+    
+    LogFile.close();
+}
@@ -3,6 +3,7 @@
     #include "VirconCPreprocessor.hpp"
     #include "VirconCParser.hpp"
     #include "VirconCEmitter.hpp"
+    #include "VirconCOptimizer.hpp"
 // *****************************************************************************
 
 
@@ -17,3 +18,4 @@ void SaveDebugInfoFile( const std::string& FilePath, const std::string& ASMFileP
 // save debug logs for the internal stages of the compiler itself
 void SaveLexerLog( const std::string& FilePath, const VirconCPreprocessor& Preprocessor );
 void SaveParserLog( const std::string& FilePath, const VirconCParser& Parser );
+void SaveOptimizerLog( const std::string& FilePath, const VirconCOptimizer& Optimizer );
@@ -2,6 +2,10 @@
     // include project headers
     #include "VirconCEmitter.hpp"
     #include "CompilerInfrastructure.hpp"
+    #include "Globals.hpp"
+    
+    // include C/C++ headers
+    #include <set>              // [ C++ STL ] Sets
     
     // declare used namespaces
     using namespace std;
@@ -13,11 +17,40 @@
 // =============================================================================
 
 
+// finds the stack frame where a call keeps its temporaries
+StackFrameNode* GetCallingStackFrame( FunctionCallNode* FunctionCall )
+{
+    CNode* CurrentParent = FunctionCall->Parent;
+    
+    while( CurrentParent )
+    {
+        if( CurrentParent->HasStackFrame() )
+          return (StackFrameNode*)CurrentParent;
+        
+        CurrentParent = CurrentParent->Parent;
+    }
+    
+    return nullptr;
+}
+
+// -----------------------------------------------------------------------------
+
 void VirconCEmitter::EmitExpressionAtom( ExpressionAtomNode* ExpressionAtom, RegisterAllocation& Registers, int ResultRegister )
 {
     // if this function gets called, the atom is not static
     // (which means it can only be a variable)
     string ResultRegisterName = "R" + to_string(ResultRegister);
+    
+    // arguments of an inlined function are not in
+    // memory: they were already evaluated to registers
+    auto InlinedPosition = InlinedArguments.find( ExpressionAtom->ResolvedVariable );
+    
+    if( InlinedPosition != InlinedArguments.end() )
+    {
+        ProgramLines.push_back( "mov " + ResultRegisterName + ", R" + to_string( InlinedPosition->second ) );
+        return;
+    }
+    
     string VariableAddress = ExpressionAtom->ResolvedVariable->Placement.AccessAddressString();
     
     // place the variable value in the register
@@ -31,6 +64,14 @@ void VirconCEmitter::EmitFunctionCall( FunctionCallNode* FunctionCall, RegisterA
     // obtain the called function
     FunctionNode* Function = FunctionCall->ResolvedFunction;
     
+    // OPTIMIZATION: small leaf functions can be expanded
+    // in place, avoiding the whole calling convention
+    if( OptimizeCode && InlineFunctions && IsInlinableFunction( Function ) )
+    {
+        EmitInlinedFunctionCall( FunctionCall, Registers, ResultRegister );
+        return;
+    }
+    
     // use a single register for all parameters
     // (but avoid reserving a register if not needed)
     int ParameterRegister = 0;
@@ -41,19 +82,7 @@ void VirconCEmitter::EmitFunctionCall( FunctionCallNode* FunctionCall, RegisterA
     string ParameterRegisterName = "R" + to_string( ParameterRegister );
     
     // find the stack frame where this call is allocated
-    StackFrameNode* CallingStackFrame = nullptr;
-    CNode* CurrentParent = FunctionCall->Parent;
-    
-    while( CurrentParent )
-    {
-        if( CurrentParent->HasStackFrame() )
-        {
-            CallingStackFrame = (StackFrameNode*)CurrentParent;
-            break;
-        }
-        
-        CurrentParent = CurrentParent->Parent;
-    }
+    StackFrameNode* CallingStackFrame = GetCallingStackFrame( FunctionCall );
     
     // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
     // First pass: precalculate and save any parameters that use
@@ -488,3 +517,386 @@ void VirconCEmitter::EmitTypeConversion( TypeConversionNode* TypeConversion, Reg
       if( RequestedType->Type() == DataTypes::Primitive )
         EmitRegisterTypeConversion( ResultRegister, ((PrimitiveType*)OriginalType)->Which, ((PrimitiveType*)RequestedType)->Which );
 }
+
+
+// =============================================================================
+//      EMIT FUNCTIONS FOR INLINED FUNCTION CALLS
+// =============================================================================
+
+
+// maximum size for a function to be inlined, measured as
+// assembly lines for asm functions, and as the number of
+// operations for functions that just return an expression
+const int MaximumInlinedSize = 8;
+
+// -----------------------------------------------------------------------------
+
+// returns all registers named anywhere in the assembly of a function body
+set< int > GetAssemblyRegisters( FunctionNode* Function )
+{
+    set< int > Result;
+    
+    for( CNode* Statement: Function->Statements )
+    {
+        if( Statement->Type() != CNodeTypes::AssemblyBlock )
+          continue;
+        
+        for( auto& AssemblyLine: ((AssemblyBlockNode*)Statement)->AssemblyLines )
+          for( const string& Word: SplitAssemblyWords( AssemblyLine.Text ) )
+          {
+              int Register = AssemblyRegisterNumber( Word );
+              
+              if( Register >= 0 )
+                Result.insert( Register );
+          }
+    }
+    
+    return Result;
+}
+
+// -----------------------------------------------------------------------------
+
+bool VirconCEmitter::IsInlinableFunction( FunctionNode* Function )
+{
+    // each function only needs to be checked once
+    auto CachedPosition = InlinableFunctions.find( Function );
+    
+    if( CachedPosition != InlinableFunctions.end() )
+      return CachedPosition->second;
+    
+    // assume the function cannot be inlined until proven otherwise
+    bool& Inlinable = InlinableFunctions[ Function ];
+    Inlinable = false;
+    
+    // we need the body, and the function cannot have local
+    // variables or use the stack for anything other than calls
+    if( !Function->HasBody || Function->Statements.empty() )
+      return false;
+    
+    if( Function->StackSizeForVariables > 0 || Function->StackSizeForTemporaries > 0 )
+      return false;
+    
+    // all arguments have to be passed in a single register
+    for( VariableNode* Argument: Function->Arguments )
+      if( Argument->DeclaredType->SizeInWords() != 1
+      ||  Argument->DeclaredType->Type() == DataTypes::Array
+      ||  Argument->DeclaredType->Type() == DataTypes::Structure )
+        return false;
+    
+    int InlinedSize = 0;
+    CNode* FirstStatement = Function->Statements.front();
+    
+    // CASE 1: a function made only of a single return;
+    // no other statements can follow it, and the returned
+    // expression cannot contain calls or side effects
+    if( FirstStatement->Type() == CNodeTypes::Return )
+    {
+        ReturnNode* Return = (ReturnNode*)FirstStatement;
+        
+        if( Function->Statements.size() != 1 || !Return->ReturnedExpression )
+          return false;
+        
+        if( !IsInlinableExpression( Function, Return->ReturnedExpression, InlinedSize ) )
+          return false;
+    }
+    
+    // CASE 2: a function made only of assembly blocks
+    else
+    {
+        for( CNode* Statement: Function->Statements )
+        {
+            if( Statement->Type() != CNodeTypes::AssemblyBlock )
+              return false;
+            
+            if( !IsInlinableAssembly( Function, (AssemblyBlockNode*)Statement, InlinedSize ) )
+              return false;
+        }
+    }
+    
+    // arguments need free registers, so avoid
+    // asm that would leave too few of them
+    if( GetAssemblyRegisters( Function ).size() > 6 )
+      return false;
+    
+    // apply the size heuristic
+    Inlinable = (InlinedSize <= MaximumInlinedSize);
+    return Inlinable;
+}
+
+// -----------------------------------------------------------------------------
+
+bool VirconCEmitter::IsInlinableAssembly( FunctionNode* Function, AssemblyBlockNode* AssemblyBlock, int& InlinedSize )
+{
+    for( auto& AssemblyLine: AssemblyBlock->AssemblyLines )
+    {
+        // lines defining labels would be duplicated at each call
+        // site; directives and strings are not safe to inspect
+        if( AssemblyLine.Text.find_first_of( ":%\"" ) != string::npos )
+          return false;
+        
+        vector< string > Words = SplitAssemblyWords( AssemblyLine.Text );
+        
+        // empty lines have no cost
+        if( Words.empty() )
+          continue;
+        
+        // control flow relies on the function's own frame and
+        // return address, and LEA needs a memory operand
+        const string& Mnemonic = Words[ 0 ];
+        
+        if( Mnemonic == "CALL" || Mnemonic == "RET" || Mnemonic == "JMP"
+        ||  Mnemonic == "JT"   || Mnemonic == "JF"  || Mnemonic == "LEA" )
+          return false;
+        
+        // the frame registers belong to the caller after inlining
+        for( const string& Word: Words )
+        {
+            int Register = AssemblyRegisterNumber( Word );
+            
+            if( Register == 14 || Register == 15 )
+              return false;
+        }
+        
+        // embedded variables must be arguments (which will be in
+        // registers) or globals (which keep their address)
+        if( AssemblyLine.EmbeddedAtom )
+        {
+            VariableNode* EmbeddedVariable = AssemblyLine.EmbeddedAtom->ResolvedVariable;
+            bool IsArgument = false;
+            
+            for( VariableNode* Argument: Function->Arguments )
+              if( Argument == EmbeddedVariable )
+                IsArgument = true;
+            
+            if( !IsArgument && !EmbeddedVariable->Placement.IsGlobal )
+              return false;
+        }
+        
+        InlinedSize++;
+    }
+    
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+
+bool VirconCEmitter::IsInlinableExpression( FunctionNode* Function, ExpressionNode* Expression, int& InlinedSize )
+{
+    // static parts are emitted as a single value
+    if( Expression->IsStatic() )
+      return true;
+    
+    switch( Expression->Type() )
+    {
+        case CNodeTypes::ExpressionAtom:
+        {
+            // only scalar variables: arguments or globals
+            VariableNode* Variable = ((ExpressionAtomNode*)Expression)->ResolvedVariable;
+            
+            if( !Variable || Variable->DeclaredType->SizeInWords() != 1 )
+              return false;
+            
+            if( Variable->DeclaredType->Type() == DataTypes::Array )
+              return false;
+            
+            for( VariableNode* Argument: Function->Arguments )
+              if( Argument == Variable )
+                return true;
+            
+            return (Variable->Placement.IsGlobal && !Variable->Placement.IsEmbedded);
+        }
+        
+        case CNodeTypes::EnclosedExpression:
+            return IsInlinableExpression( Function, ((EnclosedExpressionNode*)Expression)->InternalExpression, InlinedSize );
+            
+        case CNodeTypes::TypeConversion:
+            InlinedSize++;
+            return IsInlinableExpression( Function, ((TypeConversionNode*)Expression)->ConvertedExpression, InlinedSize );
+            
+        case CNodeTypes::UnaryOperation:
+        {
+            // operations modifying or addressing memory are excluded
+            UnaryOperationNode* Operation = (UnaryOperationNode*)Expression;
+            
+            if( Operation->Operator != UnaryOperators::PlusSign
+            &&  Operation->Operator != UnaryOperators::MinusSign
+            &&  Operation->Operator != UnaryOperators::LogicalNot
+            &&  Operation->Operator != UnaryOperators::BitwiseNot )
+              return false;
+            
+            InlinedSize++;
+            return IsInlinableExpression( Function, Operation->Operand, InlinedSize );
+        }
+        
+        case CNodeTypes::BinaryOperation:
+        {
+            // exclude assignments, which modify memory, and
+            // short-circuit operations, which emit labels
+            BinaryOperationNode* Operation = (BinaryOperationNode*)Expression;
+            
+            if( Operation->Operator == BinaryOperators::LogicalOr
+            ||  Operation->Operator == BinaryOperators::LogicalAnd
+            ||  Operation->Operator == BinaryOperators::MemberAccess
+            ||  Operation->Operator == BinaryOperators::PointedMemberAccess
+            ||  Operation->Operator >= BinaryOperators::Assignment )
+              return false;
+            
+            InlinedSize++;
+            return IsInlinableExpression( Function, Operation->LeftOperand, InlinedSize )
+                && IsInlinableExpression( Function, Operation->RightOperand, InlinedSize );
+        }
+        
+        // anything else (calls, array and member accesses,
+        // literal strings...) is never inlined
+        default:
+            return false;
+    }
+}
+
+// -----------------------------------------------------------------------------
+
+void VirconCEmitter::EmitInlinedFunctionCall( FunctionCallNode* FunctionCall, RegisterAllocation& Registers, int ResultRegister )
+{
+    FunctionNode* Function = FunctionCall->ResolvedFunction;
+    StackFrameNode* CallingStackFrame = GetCallingStackFrame( FunctionCall );
+    int FirstTemporaryOffset = CallingStackFrame->StackSizeForVariables + 1;
+    
+    // as in a normal call, parameters that use function calls
+    // are evaluated first and saved in the stack of temporaries:
+    // otherwise those calls could overwrite the registers that
+    // hold previous arguments (reverse order, since it is LIFO)
+    auto ArgumentPositionRev = Function->Arguments.rbegin();
+    auto ParameterPositionRev = FunctionCall->Parameters.rbegin();
+    
+    while( ArgumentPositionRev != Function->Arguments.rend() )
+    {
+        ExpressionNode* Parameter = *ParameterPositionRev;
+        VariableNode* Argument = *ArgumentPositionRev;
+        
+        if( Parameter->UsesFunctionCalls() )
+        {
+            int ParameterRegister = Registers.FirstFreeRegister();
+            EmitDependentExpression( Parameter, Registers, ParameterRegister );
+            EmitRegisterTypeConversion( ParameterRegister, Parameter->ReturnedType, Argument->DeclaredType );
+            
+            // (careful! stack allocation starts at [BP-1])
+            int TemporaryOffsetFromBP = FirstTemporaryOffset + Registers.TemporariesStackSize;
+            ProgramLines.push_back( "mov [BP-" + to_string(TemporaryOffsetFromBP) + "], R" + to_string(ParameterRegister) );
+            
+            Registers.TemporariesStackSize += 1;
+            Registers.RegisterUsed[ ParameterRegister ] = false;
+        }
+        
+        ArgumentPositionRev++;
+        ParameterPositionRev++;
+    }
+    
+    // registers named in the inlined assembly can be overwritten
+    // by it, so they must not be used to hold the arguments
+    vector< int > ReservedRegisters;
+    
+    for( int Register: GetAssemblyRegisters( Function ) )
+      if( Register < 14 && !Registers.RegisterUsed[ Register ] )
+      {
+          Registers.RegisterUsed[ Register ] = true;
+          ReservedRegisters.push_back( Register );
+      }
+    
+    // evaluate every parameter to its own register, in the
+    // same order that they would be passed in a normal call
+    map< VariableNode*, int > ArgumentRegisters;
+    auto ArgumentPosition = Function->Arguments.begin();
+    auto ParameterPosition = FunctionCall->Parameters.begin();
+    
+    while( ArgumentPosition != Function->Arguments.end() )
+    {
+        ExpressionNode* Parameter = *ParameterPosition;
+        VariableNode* Argument = *ArgumentPosition;
+        
+        int ArgumentRegister = Registers.FirstFreeRegister();
+        
+        // take precalculated parameters from the stack of temporaries
+        if( Parameter->UsesFunctionCalls() )
+        {
+            Registers.TemporariesStackSize -= 1;
+            int TemporaryOffsetFromBP = FirstTemporaryOffset + Registers.TemporariesStackSize;
+            ProgramLines.push_back( "mov R" + to_string(ArgumentRegister) + ", [BP-" + to_string(TemporaryOffsetFromBP) + "]" );
+        }
+        
+        else
+        {
+            EmitDependentExpression( Parameter, Registers, ArgumentRegister );
+            
+            // perform type promotion where needed
+            EmitRegisterTypeConversion( ArgumentRegister, Parameter->ReturnedType, Argument->DeclaredType );
+        }
+        
+        ArgumentRegisters[ Argument ] = ArgumentRegister;
+        
+        ArgumentPosition++;
+        ParameterPosition++;
+    }
+    
+    for( int Register: ReservedRegisters )
+      Registers.RegisterUsed[ Register ] = false;
+    
+    // now emit the function body in place
+    EmittingInlinedCode = true;
+    CNode* FirstStatement = Function->Statements.front();
+    
+    // CASE 1: evaluate the returned expression, taking its
+    // arguments from their registers instead of the stack
+    if( FirstStatement->Type() == CNodeTypes::Return )
+    {
+        ExpressionNode* ReturnedExpression = ((ReturnNode*)FirstStatement)->ReturnedExpression;
+        InlinedArguments = ArgumentRegisters;
+        
+        EmitDependentExpression( ReturnedExpression, Registers, ResultRegister );
+        EmitRegisterTypeConversion( ResultRegister, ReturnedExpression->ReturnedType, Function->ReturnType );
+        
+        InlinedArguments.clear();
+    }
+    
+    // CASE 2: copy the assembly, replacing embedded arguments
+    // with their registers; as in a normal call, the result
+    // (if any) is left in R0
+    else
+    {
+        for( CNode* Statement: Function->Statements )
+          for( auto AssemblyLine: ((AssemblyBlockNode*)Statement)->AssemblyLines )
+          {
+              if( !AssemblyLine.EmbeddedAtom )
+              {
+                  ProgramLines.push_back( AssemblyLine.Text );
+                  continue;
+              }
+              
+              // delimit the embedded variable
+              unsigned OpenBracePosition = AssemblyLine.Text.find( '{' );
+              unsigned CloseBracePosition = AssemblyLine.Text.find( '}', OpenBracePosition );
+              unsigned Length = (CloseBracePosition - OpenBracePosition + 1);
+              
+              // arguments are replaced by their register,
+              // and globals keep their memory address
+              VariableNode* EmbeddedVariable = AssemblyLine.EmbeddedAtom->ResolvedVariable;
+              auto ArgumentRegister = ArgumentRegisters.find( EmbeddedVariable );
+              string Replacement;
+              
+              if( ArgumentRegister != ArgumentRegisters.end() )
+                Replacement = "R" + to_string( ArgumentRegister->second );
+              else
+                Replacement = "[" + EmbeddedVariable->Placement.AccessAddressString() + "]";
+              
+              ProgramLines.push_back( AssemblyLine.Text.replace( OpenBracePosition, Length, Replacement ) );
+          }
+        
+        if( ResultRegister != 0 )
+          ProgramLines.push_back( "mov R" + to_string(ResultRegister) + ", R0" );
+    }
+    
+    EmittingInlinedCode = false;
+    
+    // release the argument registers
+    for( auto& Pair: ArgumentRegisters )
+      Registers.RegisterUsed[ Pair.second ] = false;
+}
@@ -97,13 +97,17 @@ int VirconCEmitter::EmitFunction( FunctionNode* Function )
     if( !Function->HasBody )
       return 0;
     
-    // add info to determine line correspondence
-    AddDebugInfo( Function );
-    
     // build labels
     string FunctionLabel = "__function_" + Function->Name;
     string ReturnLabel = "__function_" + Function->Name + "_return";
     
+    // other modules can define the same function
+    if( IsSharedDefinition( Function ) )
+      ProgramLines.push_back( "shared " + FunctionLabel );
+    
+    // add info to determine line correspondence
+    AddDebugInfo( Function );
+    
     // (1) function call label
     EmitLabel( FunctionLabel );
     
@@ -16,6 +16,24 @@ string CompilerFolder;
 bool CompileOnly = false;
 bool DisableWarnings = false;
 bool EnableAllWarnings = false;
+string CacheFolder;
+
+
+// =============================================================================
+//      OPTIMIZATIONS
+// =============================================================================
+
+
+// master switch, enabled by any -O option
+bool OptimizeCode = false;
+
+// individual optimization passes
+bool InlineFunctions = true;
+bool PropagateConstants = true;
+bool PropagateCopies = true;
+bool RemoveDeadCode = true;
+bool RemoveDeadStores = true;
+bool EliminateCommonSubexpressions = true;
 
 
 // =============================================================================
@@ -18,6 +18,27 @@ extern bool CompileOnly;
 extern bool DisableWarnings;
 extern bool EnableAllWarnings;
 
+// folder to store preprocessed included files
+// (empty when the cache is disabled)
+extern std::string CacheFolder;
+
+
+// =============================================================================
+//      OPTIMIZATIONS
+// =============================================================================
+
+
+// master switch, enabled by any -O option
+extern bool OptimizeCode;
+
+// individual optimization passes
+extern bool InlineFunctions;
+extern bool PropagateConstants;
+extern bool PropagateCopies;
+extern bool RemoveDeadCode;
+extern bool RemoveDeadStores;
+extern bool EliminateCommonSubexpressions;
+
 
 // =============================================================================
 //      DEBUG
@@ -0,0 +1,560 @@
+// *****************************************************************************
+    // include infrastructure headers
+    #include "../DevToolsInfrastructure/FilePaths.hpp"
+    
+    // include project headers
+    #include "HeaderCache.hpp"
+    #include "Globals.hpp"
+    
+    // include C/C++ headers
+    #include <iostream>         // [ C++ STL ] I/O Streams
+    #include <fstream>          // [ C++ STL ] File streams
+    #include <sstream>          // [ C++ STL ] String streams
+    #include <algorithm>        // [ C++ STL ] Algorithms
+    #include <random>           // [ C++ STL ] Random numbers
+    #include <cstdio>           // [ ANSI C ] Standard I/O
+    
+    // declare used namespaces
+    using namespace std;
+// *****************************************************************************
+
+
+// =============================================================================
+//      CACHE FILE FORMAT
+// =============================================================================
+
+
+// increase the version whenever tokens or preprocessing change
+// in any way, so that files written by older compilers are not used
+const char HeaderCacheSignature[ 8 ] = { 'V','3','2','-','H','D','R','S' };
+const int32_t HeaderCacheVersion = 1;
+
+// -----------------------------------------------------------------------------
+
+// FNV-1a hash, used to name the cache files
+uint64_t HashText( const string& Text, uint64_t Hash = 0xCBF29CE484222325ULL )
+{
+    for( char c: Text )
+    {
+        Hash ^= (unsigned char)c;
+        Hash *= 0x100000001B3ULL;
+    }
+    
+    return Hash;
+}
+
+// -----------------------------------------------------------------------------
+
+string GetCacheFilePath( uint64_t Key )
+{
+    char HashName[ 20 ];
+    snprintf( HashName, sizeof(HashName), "%016llX", (unsigned long long)Key );
+    return CacheFolder + PathSeparator + HashName + ".header";
+}
+
+
+// =============================================================================
+//      AUXILIARY FUNCTIONS FOR BINARY I/O
+// =============================================================================
+
+
+void WriteInteger( ostream& Output, int32_t Value )
+{
+    Output.write( (char*)(&Value), 4 );
+}
+
+// -----------------------------------------------------------------------------
+
+void WriteHash( ostream& Output, uint64_t Value )
+{
+    Output.write( (char*)(&Value), 8 );
+}
+
+// -----------------------------------------------------------------------------
+
+void WriteString( ostream& Output, const string& Value )
+{
+    WriteInteger( Output, Value.size() );
+    Output.write( Value.data(), Value.size() );
+}
+
+// -----------------------------------------------------------------------------
+
+int32_t ReadInteger( istream& Input )
+{
+    int32_t Value = 0;
+    Input.read( (char*)(&Value), 4 );
+    return Value;
+}
+
+// -----------------------------------------------------------------------------
+
+uint64_t ReadHash( istream& Input )
+{
+    uint64_t Value = 0;
+    Input.read( (char*)(&Value), 8 );
+    return Value;
+}
+
+// -----------------------------------------------------------------------------
+
+string ReadString( istream& Input )
+{
+    int32_t Length = ReadInteger( Input );
+    
+    if( Length < 0 || Input.fail() )
+      return "";
+    
+    string Value( Length, ' ' );
+    Input.read( &Value[ 0 ], Length );
+    return Value;
+}
+
+
+// =============================================================================
+//      SERIALIZATION OF TOKENS
+// =============================================================================
+
+
+// tokens can come from several files, so each one
+// refers to its file by a position in a path table
+typedef map< const string*, int32_t > PathTable;
+
+// -----------------------------------------------------------------------------
+
+// locations are not written when hashing definitions:
+// where a value was defined does not change the result
+void WriteToken( ostream& Output, CToken* T, PathTable* Paths )
+{
+    WriteInteger( Output, (int32_t)T->Type() );
+    
+    if( Paths )
+    {
+        auto Position = Paths->find( T->Location.FilePath );
+        
+        if( Position == Paths->end() )
+          Position = Paths->insert( make_pair( T->Location.FilePath, (int32_t)Paths->size() ) ).first;
+        
+        WriteInteger( Output, Position->second );
+        WriteInteger( Output, T->Location.LogicalLine );
+        WriteInteger( Output, T->Location.Line );
+        WriteInteger( Output, T->Location.Column );
+    }
+    
+    switch( T->Type() )
+    {
+        case CTokenTypes::LiteralValue:
+        {
+            LiteralValueToken* Literal = (LiteralValueToken*)T;
+            WriteInteger( Output, (int32_t)Literal->ValueType );
+            
+            if( Literal->ValueType == LiteralValueTypes::Bool )
+              WriteInteger( Output, Literal->BoolValue? 1 : 0 );
+            
+            else if( Literal->ValueType == LiteralValueTypes::Int )
+              WriteInteger( Output, Literal->IntValue );
+            
+            else
+              Output.write( (char*)(&Literal->FloatValue), 4 );
+            
+            break;
+        }
+        
+        case CTokenTypes::LiteralString:
+            WriteString( Output, ((LiteralStringToken*)T)->Value );
+            break;
+        
+        case CTokenTypes::Identifier:
+            WriteString( Output, ((IdentifierToken*)T)->Name );
+            break;
+        
+        case CTokenTypes::Keyword:
+            WriteInteger( Output, (int32_t)((KeywordToken*)T)->Which );
+            break;
+        
+        case CTokenTypes::Operator:
+            WriteInteger( Output, (int32_t)((OperatorToken*)T)->Which );
+            break;
+        
+        case CTokenTypes::Delimiter:
+            WriteInteger( Output, (int32_t)((DelimiterToken*)T)->Which );
+            break;
+        
+        case CTokenTypes::SpecialSymbol:
+            WriteInteger( Output, (int32_t)((SpecialSymbolToken*)T)->Which );
+            break;
+        
+        // start and end of file have no contents
+        default:
+            break;
+    }
+}
+
+// -----------------------------------------------------------------------------
+
+void WriteTokenList( ostream& Output, const CTokenList& Tokens, PathTable* Paths )
+{
+    WriteInteger( Output, Tokens.size() );
+    
+    for( CToken* T: Tokens )
+      WriteToken( Output, T, Paths );
+}
+
+// -----------------------------------------------------------------------------
+
+// returns nullptr if the token could not be read
+CToken* ReadToken( istream& Input, const vector< const string* >& Paths )
+{
+    SourceLocation Location;
+    CTokenTypes Type = (CTokenTypes)ReadInteger( Input );
+    int32_t PathIndex = ReadInteger( Input );
+    Location.LogicalLine = ReadInteger( Input );
+    Location.Line = ReadInteger( Input );
+    Location.Column = ReadInteger( Input );
+    
+    if( Input.fail() || PathIndex < 0 || PathIndex >= (int32_t)Paths.size() )
+      return nullptr;
+    
+    Location.FilePath = Paths[ PathIndex ];
+    CToken* NewToken = nullptr;
+    
+    switch( Type )
+    {
+        case CTokenTypes::StartOfFile:
+            NewToken = new StartOfFileToken;
+            NewToken->Location = Location;
+            break;
+        
+        case CTokenTypes::EndOfFile:
+            NewToken = new EndOfFileToken;
+            NewToken->Location = Location;
+            break;
+        
+        case CTokenTypes::LiteralValue:
+        {
+            LiteralValueTypes ValueType = (LiteralValueTypes)ReadInteger( Input );
+            
+            if( ValueType == LiteralValueTypes::Bool )
+              NewToken = NewBoolToken( Location, ReadInteger( Input ) != 0 );
+            
+            else if( ValueType == LiteralValueTypes::Int )
+              NewToken = NewIntToken( Location, ReadInteger( Input ) );
+            
+            else
+            {
+                float Value = 0;
+                Input.read( (char*)(&Value), 4 );
+                NewToken = NewFloatToken( Location, Value );
+            }
+            
+            break;
+        }
+        
+        case CTokenTypes::LiteralString:
+            NewToken = NewStringToken( Location, ReadString( Input ) );
+            break;
+        
+        case CTokenTypes::Identifier:
+            NewToken = NewIdentifierToken( Location, ReadString( Input ) );
+            break;
+        
+        case CTokenTypes::Keyword:
+            NewToken = NewKeywordToken( Location, (KeywordTypes)ReadInteger( Input ) );
+            break;
+        
+        case CTokenTypes::Operator:
+            NewToken = NewOperatorToken( Location, (OperatorTypes)ReadInteger( Input ) );
+            break;
+        
+        case CTokenTypes::Delimiter:
+            NewToken = NewDelimiterToken( Location, (DelimiterTypes)ReadInteger( Input ) );
+            break;
+        
+        case CTokenTypes::SpecialSymbol:
+            NewToken = NewSpecialSymbolToken( Location, (SpecialSymbolTypes)ReadInteger( Input ) );
+            break;
+        
+        default:
+            return nullptr;
+    }
+    
+    // a truncated file may fail while reading contents
+    if( Input.fail() )
+    {
+        delete NewToken;
+        return nullptr;
+    }
+    
+    return NewToken;
+}
+
+// -----------------------------------------------------------------------------
+
+// tokens read before a failure are kept in the list
+bool ReadTokenList( istream& Input, CTokenList& Tokens, const vector< const string* >& Paths )
+{
+    int32_t NumberOfTokens = ReadInteger( Input );
+    
+    if( Input.fail() || NumberOfTokens < 0 )
+      return false;
+    
+    for( int32_t i = 0; i < NumberOfTokens; i++ )
+    {
+        CToken* NewToken = ReadToken( Input, Paths );
+        
+        if( !NewToken )
+          return false;
+        
+        Tokens.push_back( NewToken );
+    }
+    
+    return true;
+}
+
+
+// =============================================================================
+//      CACHED HEADER CLASS
+// =============================================================================
+
+
+CachedHeader::~CachedHeader()
+{
+    for( CToken* T: ProcessedTokens )
+      delete T;
+    
+    for( auto& Pair: Definitions )
+      for( CToken* T: Pair.second )
+        delete T;
+}
+
+
+// =============================================================================
+//      FUNCTIONS TO USE THE CACHE
+// =============================================================================
+
+
+string FindIncludeFile( const string& ReferenceFolder, const string& FilePath )
+{
+    string PathToInclude = ReferenceFolder + PathSeparator + FilePath;
+    
+    if( FileExists( PathToInclude ) )
+      return PathToInclude;
+    
+    PathToInclude = CompilerFolder + "include" + PathSeparator + FilePath;
+    
+    if( FileExists( PathToInclude ) )
+      return PathToInclude;
+    
+    return "";
+}
+
+// -----------------------------------------------------------------------------
+
+bool HashFileContents( const string& FilePath, uint64_t& Hash )
+{
+    ifstream InputFile;
+    OpenInputFile( InputFile, FilePath, ios_base::in | ios_base::binary );
+    
+    if( InputFile.fail() )
+      return false;
+    
+    stringstream Contents;
+    Contents << InputFile.rdbuf();
+    Hash = HashText( Contents.str() );
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+
+// file paths are hashed too, since tokens store their
+// locations and these are later shown in error messages
+uint64_t GetHeaderCacheKey( const string& HeaderPath, uint64_t ContentsHash, const map< string, CTokenList >& Definitions )
+{
+    stringstream KeyData;
+    WriteInteger( KeyData, HeaderCacheVersion );
+    WriteString( KeyData, HeaderPath );
+    WriteHash( KeyData, ContentsHash );
+    WriteInteger( KeyData, Definitions.size() );
+    
+    for( auto& Pair: Definitions )
+    {
+        WriteString( KeyData, Pair.first );
+        WriteTokenList( KeyData, Pair.second, nullptr );
+    }
+    
+    return HashText( KeyData.str() );
+}
+
+// -----------------------------------------------------------------------------
+
+bool LoadCachedHeader( uint64_t Key, const string& HeaderPath, CachedHeader& Header )
+{
+    string CachePath = GetCacheFilePath( Key );
+    
+    if( !FileExists( CachePath ) )
+      return false;
+    
+    ifstream InputFile;
+    OpenInputFile( InputFile, CachePath, ios_base::in | ios_base::binary );
+    
+    if( InputFile.fail() )
+      return false;
+    
+    // check the file header
+    char Signature[ 8 ];
+    InputFile.read( Signature, 8 );
+    
+    if( InputFile.fail() || !equal( Signature, Signature + 8, HeaderCacheSignature ) )
+      return false;
+    
+    if( ReadInteger( InputFile ) != HeaderCacheVersion )
+      return false;
+    
+    // also check the header itself, in case of hash collisions
+    if( ReadString( InputFile ) != HeaderPath )
+      return false;
+    
+    // every included file must still be found in
+    // the same place, and with the same contents
+    int32_t NumberOfDependencies = ReadInteger( InputFile );
+    
+    if( InputFile.fail() || NumberOfDependencies < 0 )
+      return false;
+    
+    for( int32_t i = 0; i < NumberOfDependencies; i++ )
+    {
+        HeaderDependency Dependency;
+        Dependency.ReferenceFolder = ReadString( InputFile );
+        Dependency.FilePath = ReadString( InputFile );
+        Dependency.ResolvedPath = ReadString( InputFile );
+        Dependency.ContentsHash = ReadHash( InputFile );
+        
+        if( InputFile.fail() )
+          return false;
+        
+        uint64_t CurrentHash;
+        
+        if( FindIncludeFile( Dependency.ReferenceFolder, Dependency.FilePath ) != Dependency.ResolvedPath )
+          return false;
+        
+        if( !HashFileContents( Dependency.ResolvedPath, CurrentHash ) || CurrentHash != Dependency.ContentsHash )
+          return false;
+        
+        Header.Dependencies.push_back( Dependency );
+    }
+    
+    // read the path table
+    vector< const string* > Paths;
+    int32_t NumberOfPaths = ReadInteger( InputFile );
+    
+    if( InputFile.fail() || NumberOfPaths < 0 )
+      return false;
+    
+    for( int32_t i = 0; i < NumberOfPaths; i++ )
+    {
+        string Path = ReadString( InputFile );
+        
+        if( InputFile.fail() )
+          return false;
+        
+        Paths.push_back( InternFilePath( Path ) );
+    }
+    
+    // read the results; on failure any tokens
+    // read so far are deleted with the header
+    if( !ReadTokenList( InputFile, Header.ProcessedTokens, Paths ) )
+      return false;
+    
+    int32_t NumberOfDefinitions = ReadInteger( InputFile );
+    
+    if( InputFile.fail() || NumberOfDefinitions < 0 )
+      return false;
+    
+    for( int32_t i = 0; i < NumberOfDefinitions; i++ )
+    {
+        string Name = ReadString( InputFile );
+        
+        if( InputFile.fail() )
+          return false;
+        
+        if( !ReadTokenList( InputFile, Header.Definitions[ Name ], Paths ) )
+          return false;
+    }
+    
+    if( VerboseMode )
+      cout << "using cached results for \"" << HeaderPath << "\"" << endl;
+    
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+
+void SaveCachedHeader( uint64_t Key, const string& HeaderPath, const vector< HeaderDependency >& Dependencies,
+                       CTokenIterator FirstToken, CTokenIterator LastToken, const map< string, CTokenList >& Definitions )
+{
+    // write tokens and definitions first, to know the paths they use
+    PathTable Paths;
+    stringstream Results;
+    CTokenList Tokens( FirstToken, LastToken );
+    WriteTokenList( Results, Tokens, &Paths );
+    WriteInteger( Results, Definitions.size() );
+    
+    for( auto& Pair: Definitions )
+    {
+        WriteString( Results, Pair.first );
+        WriteTokenList( Results, Pair.second, &Paths );
+    }
+    
+    // order paths by their position in the table
+    vector< const string* > PathList( Paths.size() );
+    
+    for( auto& Pair: Paths )
+      PathList[ Pair.second ] = Pair.first;
+    
+    // write to a temporary file first: other compilations
+    // running in parallel may want to read the same file
+    if( !DirectoryExists( CacheFolder ) )
+      CreateNewDirectory( CacheFolder );
+    
+    string CachePath = GetCacheFilePath( Key );
+    random_device RandomSource;
+    string TemporaryPath = CachePath + "." + to_string( RandomSource() ) + ".tmp";
+    
+    ofstream OutputFile;
+    OpenOutputFile( OutputFile, TemporaryPath, ios_base::out | ios_base::binary );
+    
+    // the cache is optional, so failing
+    // to write it is not considered an error
+    if( OutputFile.fail() )
+      return;
+    
+    OutputFile.write( HeaderCacheSignature, 8 );
+    WriteInteger( OutputFile, HeaderCacheVersion );
+    WriteString( OutputFile, HeaderPath );
+    WriteInteger( OutputFile, Dependencies.size() );
+    
+    for( const HeaderDependency& Dependency: Dependencies )
+    {
+        WriteString( OutputFile, Dependency.ReferenceFolder );
+        WriteString( OutputFile, Dependency.FilePath );
+        WriteString( OutputFile, Dependency.ResolvedPath );
+        WriteHash( OutputFile, Dependency.ContentsHash );
+    }
+    
+    WriteInteger( OutputFile, PathList.size() );
+    
+    for( const string* Path: PathList )
+      WriteString( OutputFile, *Path );
+    
+    OutputFile << Results.rdbuf();
+    bool Success = !OutputFile.fail();
+    OutputFile.close();
+    
+    // if another compilation already created
+    // the file, it will have the same contents
+    if( !Success || rename( TemporaryPath.c_str(), CachePath.c_str() ) != 0 )
+      remove( TemporaryPath.c_str() );
+    
+    else if( VerboseMode )
+      cout << "saved cached results for \"" << HeaderPath << "\"" << endl;
+}
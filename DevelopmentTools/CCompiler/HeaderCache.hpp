@@ -0,0 +1,91 @@
+// *****************************************************************************
+    // start include guard
+    #ifndef HEADERCACHE_HPP
+    #define HEADERCACHE_HPP
+    
+    // include project headers
+    #include "CTokens.hpp"
+    
+    // include C/C++ headers
+    #include <string>           // [ C++ STL ] Strings
+    #include <vector>           // [ C++ STL ] Vectors
+    #include <map>              // [ C++ STL ] Maps
+    #include <cstdint>          // [ ANSI C ] Standard integer types
+// *****************************************************************************
+
+
+// =============================================================================
+//      CACHE OF PREPROCESSED INCLUDED FILES
+// =============================================================================
+
+
+// The result of including a file depends on the file itself, on
+// the definitions active when it is included and on any files it
+// includes in turn. Cache files are named after a hash of the
+// first two, and they store the other files with the hashes of
+// their contents so that they can be checked when reused. Each
+// cache file holds the preprocessed tokens produced by the file
+// and all definitions that are active after including it.
+
+// a file that was included while preprocessing another one
+class HeaderDependency
+{
+    public:
+        
+        // what the #include directive asked for
+        std::string ReferenceFolder;
+        std::string FilePath;
+        
+        // what was found
+        std::string ResolvedPath;
+        uint64_t ContentsHash;
+};
+
+// -----------------------------------------------------------------------------
+
+// all results of preprocessing an included file
+class CachedHeader
+{
+    public:
+        
+        std::vector< HeaderDependency > Dependencies;
+        CTokenList ProcessedTokens;
+        std::map< std::string, CTokenList > Definitions;
+        
+    public:
+        
+        // tokens not taken by the preprocessor are deleted
+       ~CachedHeader();
+};
+
+
+// =============================================================================
+//      FUNCTIONS TO USE THE CACHE
+// =============================================================================
+
+
+// looks for a file the same way as #include: first in the folder
+// of the including file, then in the compiler's include folder
+// (returns an empty string when the file is not found)
+std::string FindIncludeFile( const std::string& ReferenceFolder, const std::string& FilePath );
+
+// hashes the contents of a file, returns false on failure
+bool HashFileContents( const std::string& FilePath, uint64_t& Hash );
+
+// identifies the results of including a file with these definitions
+uint64_t GetHeaderCacheKey( const std::string& HeaderPath, uint64_t ContentsHash, const std::map< std::string, CTokenList >& Definitions );
+
+// returns false if there is no valid cache file for this key,
+// or if any of the files it depends on has changed since then
+bool LoadCachedHeader( uint64_t Key, const std::string& HeaderPath, CachedHeader& Header );
+
+// write the results of including a file into the cache folder,
+// taking the tokens produced between the 2 given positions
+void SaveCachedHeader( uint64_t Key, const std::string& HeaderPath, const std::vector< HeaderDependency >& Dependencies,
+                       CTokenIterator FirstToken, CTokenIterator LastToken, const std::map< std::string, CTokenList >& Definitions );
+
+
+// *****************************************************************************
+    // end include guard
+    #endif
+// *****************************************************************************
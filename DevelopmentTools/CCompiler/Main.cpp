@@ -5,6 +5,11 @@
     
     // include infrastructure headers
     #include "../DevToolsInfrastructure/FilePaths.hpp"
+    #include "../DevToolsInfrastructure/StringFunctions.hpp"
+    
+    // include assembler headers
+    #include "../Assembler/ProgramAssembly.hpp"
+    #include "../Assembler/Globals.hpp"
     
     // include project headers
     #include "VirconCLexer.hpp"
@@ -12,6 +17,7 @@
     #include "VirconCParser.hpp"
     #include "VirconCAnalyzer.hpp"
     #include "VirconCEmitter.hpp"
+    #include "VirconCOptimizer.hpp"
     #include "CompilerInfrastructure.hpp"
     #include "Globals.hpp"
     #include "DebugInfo.hpp"
@@ -52,13 +58,23 @@ void PrintUsage()
     cout << "  --version    Displays compiler version" << endl;
     cout << "  --debugmode  Creates files with results of internal stages" << endl;
     cout << "  -o <file>    Output file, default name is the same as input" << endl;
+    cout << "               (a .vbin output, or .vobj with -c, is assembled directly)" << endl;
     cout << "  -b           Compiles the program as a BIOS" << endl;
     cout << "  -v           Displays additional information (verbose)" << endl;
     cout << "  -g           Outputs an additional file with debug info" << endl;
+    cout << "  -c           Compiles a module to be linked with others" << endl;
     cout << "  -w           Inhibit all warnings" << endl;
     cout << "  -Wall        Enable all warnings" << endl;
+    cout << "  --cachedir <folder>  Reuse preprocessed included files" << endl;
+    cout << "  -O1,-O2,-O3  Optimize the generated code" << endl;
+    cout << "  -fno-inline               Do not inline calls to small functions" << endl;
+    cout << "  -fno-constant-propagation Do not replace registers with known constants" << endl;
+    cout << "  -fno-copy-propagation     Do not remove redundant copies" << endl;
+    cout << "  -fno-dead-code            Do not remove unused register writes" << endl;
+    cout << "  -fno-dead-stores          Do not remove overwritten memory stores" << endl;
+    cout << "  -fno-cse                  Do not reuse results of repeated operations" << endl;
     cout << "Also, the following options are accepted for compatibility" << endl;
-    cout << "but have no effect: -c,-s,-O1,-O2,-O3" << endl;
+    cout << "but have no effect: -s,-O0" << endl;
 }
 
 // -----------------------------------------------------------------------------
@@ -193,6 +209,18 @@ int main( int NumberOfArguments, char* Arguments[] )
                 continue;
             }
             
+            if( ArgumentsUTF8[i] == string("--cachedir") )
+            {
+                // expect another argument
+                i++;
+                
+                if( i >= NumberOfArguments )
+                  throw runtime_error( "missing folder after '--cachedir'" );
+                
+                CacheFolder = ArgumentsUTF8[ i ];
+                continue;
+            }
+            
             if( ArgumentsUTF8[i] == string("-o") )
             {
                 // expect another argument
@@ -206,11 +234,55 @@ int main( int NumberOfArguments, char* Arguments[] )
                 continue;
             }
             
+            // all optimization levels are the same
+            if( ArgumentsUTF8[i] == string("-O1")
+            ||  ArgumentsUTF8[i] == string("-O2")
+            ||  ArgumentsUTF8[i] == string("-O3") )
+            {
+                OptimizeCode = true;
+                continue;
+            }
+            
+            // individual optimizations can be disabled
+            if( ArgumentsUTF8[i] == string("-fno-inline") )
+            {
+                InlineFunctions = false;
+                continue;
+            }
+            
+            if( ArgumentsUTF8[i] == string("-fno-constant-propagation") )
+            {
+                PropagateConstants = false;
+                continue;
+            }
+            
+            if( ArgumentsUTF8[i] == string("-fno-copy-propagation") )
+            {
+                PropagateCopies = false;
+                continue;
+            }
+            
+            if( ArgumentsUTF8[i] == string("-fno-dead-code") )
+            {
+                RemoveDeadCode = false;
+                continue;
+            }
+            
+            if( ArgumentsUTF8[i] == string("-fno-dead-stores") )
+            {
+                RemoveDeadStores = false;
+                continue;
+            }
+            
+            if( ArgumentsUTF8[i] == string("-fno-cse") )
+            {
+                EliminateCommonSubexpressions = false;
+                continue;
+            }
+            
             // these options are accepted but have no effect
             if( ArgumentsUTF8[i] == string("-s")  )  continue;
-            if( ArgumentsUTF8[i] == string("-O1") )  continue;
-            if( ArgumentsUTF8[i] == string("-O2") )  continue;
-            if( ArgumentsUTF8[i] == string("-O3") )  continue;
+            if( ArgumentsUTF8[i] == string("-O0") )  continue;
             
             // discard any other parameters starting with '-'
             if( ArgumentsUTF8[i][0] == '-' )
@@ -231,6 +303,10 @@ int main( int NumberOfArguments, char* Arguments[] )
         if( InputPath.empty() )
           throw runtime_error( "no input file" );
         
+        // a BIOS needs its specific start section
+        if( CompileOnly && ProgramIsBios )
+          throw runtime_error( "a BIOS cannot be compiled as a separate module" );
+        
         // if output path was not given, just
         // replace the extension in the input
         if( OutputPath.empty() )
@@ -241,6 +317,23 @@ int main( int NumberOfArguments, char* Arguments[] )
               cout << "using output path: \"" << OutputPath << "\"" << endl;
         }
         
+        // binaries and object files are assembled here too,
+        // without going through an intermediate ASM file
+        string OutputExtension = ToLowerCase( GetFileExtension( OutputPath ) );
+        bool AssembleOutput = (OutputExtension == "vbin" || OutputExtension == "vobj");
+        
+        if( OutputExtension == "vobj" && !CompileOnly )
+          throw runtime_error( "object files can only be created for modules compiled with '-c'" );
+        
+        if( OutputExtension == "vbin" && CompileOnly )
+          throw runtime_error( "modules compiled with '-c' must be output as object or ASM files" );
+        
+        // the ASM file is then only saved for debugging
+        string ASMPath = OutputPath;
+        
+        if( AssembleOutput )
+          ASMPath = ReplaceFileExtension( OutputPath, "asm" );
+        
         // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
         // Begin a new compilation
         CompilationErrors = 0;
@@ -270,7 +363,7 @@ int main( int NumberOfArguments, char* Arguments[] )
         
         // when requested, log results of lexer + preprocessor stages
         if( DebugMode )
-          SaveLexerLog( OutputPath + ".lexer.log", Preprocessor );
+          SaveLexerLog( ASMPath + ".lexer.log", Preprocessor );
         
         // avoid later stages if any error was found
         if( CompilationErrors != 0 )
@@ -287,7 +380,7 @@ int main( int NumberOfArguments, char* Arguments[] )
         
         // when requested, log results of parser stage
         if( DebugMode )
-          SaveParserLog( OutputPath + ".parser.log", Parser );
+          SaveParserLog( ASMPath + ".parser.log", Parser );
         
         // avoid later stages if any error was found
         if( CompilationErrors != 0 )
@@ -319,16 +412,68 @@ int main( int NumberOfArguments, char* Arguments[] )
         if( CompilationErrors != 0 )
           throw runtime_error( "emitter finished with errors" );
         
-        // no need for debug output here (result is final)
-        if( VerboseMode )
-          cout << "saving output file" << endl;
+        // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+        // STAGE 6: Run optimizer
+        // (Assembly lines --> Assembly lines)
+        if( OptimizeCode )
+        {
+            if( VerboseMode )
+              cout << "stage 6: running optimizer" << endl;
+            
+            VirconCOptimizer Optimizer;
+            Optimizer.Optimize( Emitter );
+            
+            // when requested, log results of optimizer stage
+            if( DebugMode )
+              SaveOptimizerLog( ASMPath + ".optimizer.log", Optimizer );
+        }
         
-        Emitter.SaveAssembly( OutputPath );
+        // no need for debug output here (result is final)
+        if( !AssembleOutput )
+        {
+            if( VerboseMode )
+              cout << "saving output file" << endl;
+            
+            Emitter.SaveAssembly( OutputPath );
+            
+            // on debug compilation output an additional debug info file
+            if( CreateDebugVersion )
+              SaveDebugInfoFile( OutputPath + ".debug", OutputPath, Parser, Emitter );
+        }
         
         // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-        // on debug compilation output an additional debug info file
-        if( CreateDebugVersion )
-          SaveDebugInfoFile( OutputPath + ".debug", OutputPath, Parser, Emitter );
+        // STAGE 7: Run assembler
+        // (Assembly lines --> binary ROM or object file)
+        else
+        {
+            // debug info for the binary refers to lines in
+            // the ASM file, so it needs to be saved as well
+            if( CreateDebugVersion || DebugMode )
+            {
+                if( VerboseMode )
+                  cout << "saving assembly file" << endl;
+                
+                Emitter.SaveAssembly( ASMPath );
+                
+                if( CreateDebugVersion )
+                  SaveDebugInfoFile( ASMPath + ".debug", ASMPath, Parser, Emitter );
+            }
+            
+            if( VerboseMode )
+              cout << "stage 7: running assembler" << endl;
+            
+            // use the same options as when assembling separately
+            VirconASM::DebugMode = DebugMode;
+            VirconASM::VerboseMode = VerboseMode;
+            VirconASM::CreateDebugVersion = CreateDebugVersion;
+            VirconASM::CreateObjectFile = CompileOnly;
+            
+            if( ProgramIsBios )
+              VirconASM::InitialROMAddress = V32::Constants::BiosProgramROMFirstAddress;
+            
+            // assembly lines are passed in memory
+            VirconASM::AssembleLines( Emitter.ProgramLines, Emitter.DataLines, ASMPath, OutputPath );
+        }
     }
     
     catch( const exception& e )
@@ -1,6 +1,7 @@
 // *****************************************************************************
     // include project headers
     #include "MemoryPlacement.hpp"
+    #include "Globals.hpp"
     
     // declare used namespaces
     using namespace std;
@@ -18,6 +19,7 @@ MemoryPlacement::MemoryPlacement()
     IsGlobal = false;
     GlobalAddress = 0;
     UsesGlobalName = false;
+    OffsetFromGlobalName = 0;
     
     // local info
     OffsetFromBP = 0;
@@ -38,6 +40,7 @@ void MemoryPlacement::AddOffset( int Offset )
     if( IsGlobal )
     {
         GlobalAddress += Offset;
+        OffsetFromGlobalName += Offset;
         UsesGlobalName = false;
     }
     
@@ -57,11 +60,24 @@ string MemoryPlacement::AccessAddressString()
     // global placement
     if( IsGlobal )
     {
+        // in modules variables are labels for the linker,
+        // and assembler labels need to begin with '_'
+        string Prefix = (CompileOnly? "__global_" : "global_");
+        
         if( UsesGlobalName )
-          return "global_" + GlobalName;
+          return Prefix + GlobalName;
+        
+        // when compiling a module, RAM addresses are
+        // only known after linking, so keep the name
+        if( CompileOnly && !GlobalName.empty() )
+        {
+            if( OffsetFromGlobalName < 0 )
+              return Prefix + GlobalName + to_string( OffsetFromGlobalName );
+            
+            return Prefix + GlobalName + "+" + to_string( OffsetFromGlobalName );
+        }
         
-        else
-          return to_string( GlobalAddress );
+        return to_string( GlobalAddress );
     }
     
     // local placement
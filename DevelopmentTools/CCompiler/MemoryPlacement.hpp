@@ -23,6 +23,7 @@ class MemoryPlacement
         int32_t GlobalAddress;   // signed, but cannot be negative
         std::string GlobalName;
         bool UsesGlobalName;
+        int32_t OffsetFromGlobalName;
         
         // for local placement
         int32_t OffsetFromBP;    // may be negative
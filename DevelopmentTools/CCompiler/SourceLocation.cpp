@@ -2,11 +2,30 @@
     // include our headers
     #include "SourceLocation.hpp"
     
+    // include C/C++ headers
+    #include <unordered_set>    // [ C++ STL ] Unordered sets
+    
     // declare used namespaces
     using namespace std;
 // *****************************************************************************
 
 
+// =============================================================================
+//      SOURCE LOCATION CLASS
+// =============================================================================
+
+
+SourceLocation::SourceLocation()
+{
+    static const string* EmptyPath = InternFilePath( "" );
+    
+    FilePath = EmptyPath;
+    LogicalLine = 0;
+    Line = 0;
+    Column = 0;
+}
+
+
 // =============================================================================
 //      WORKING WITH LOCATIONS
 // =============================================================================
@@ -20,8 +39,19 @@ bool AreInSameLine( const SourceLocation& L1, const SourceLocation& L2 )
     // NOTE 2: we must compare the LOGICAL line, in
     // case a line has been continued with a '\'
     
+    // (paths are shared, so comparing pointers is enough)
     if( L1.FilePath != L2.FilePath )
       return false;
     
     return (L1.LogicalLine == L2.LogicalLine);
 }
+
+// -----------------------------------------------------------------------------
+
+const string* InternFilePath( const string& FilePath )
+{
+    // elements of a set never move in memory, so
+    // their addresses are valid for the whole run
+    static unordered_set< string > FilePaths;
+    return &*FilePaths.insert( FilePath ).first;
+}
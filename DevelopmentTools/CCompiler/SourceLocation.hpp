@@ -13,14 +13,22 @@
 // =============================================================================
 
 
+// Every token and node stores a location, so instead of
+// a full copy of its file path each one points to a single
+// shared copy. Paths are never released during compilation.
 class SourceLocation
 {
     public:
         
-        std::string FilePath;
+        const std::string* FilePath;
         int LogicalLine;        // for lines continued with '\'
         int Line;
         int Column;
+        
+    public:
+        
+        // instance handling
+        SourceLocation();
 };
 
 
@@ -31,6 +39,10 @@ class SourceLocation
 
 bool AreInSameLine( const SourceLocation& L1, const SourceLocation& L2 );
 
+// returns the shared copy of a file path (the same
+// path will always give the same pointer)
+const std::string* InternFilePath( const std::string& FilePath );
+
 
 
 // *****************************************************************************
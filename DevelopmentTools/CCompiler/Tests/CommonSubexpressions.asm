@@ -0,0 +1,38 @@
+; program start section
+  call __global_scope_initialization
+  call __function_main
+  hlt
+
+; location of global variables
+
+__global_scope_initialization:
+  push BP
+  mov BP, SP
+  pop BP
+  ret
+
+__function_main:
+  push BP
+  mov BP, SP
+  isub SP, 5
+  mov R0, 7
+  mov [BP-2], R0
+  mov R0, 5
+  imul R0, 7
+  mov [BP-3], R0
+  mov R0, 5
+  imul R0, 7
+  mov R2, 7
+  mov R1, R0
+  iadd R0, R1
+  mov [BP-4], R0
+  mov R0, 6
+  mov [BP-1], R0
+  mov R1, 7
+  imul R0, 7
+  mov [BP-5], R0
+__function_main_return:
+  mov SP, BP
+  pop BP
+  ret
+
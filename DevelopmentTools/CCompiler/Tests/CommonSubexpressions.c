@@ -0,0 +1,13 @@
+void main()
+{
+    // (compile with -O2 to test the optimizer)
+    // an operation repeated on the same values
+    // reuses the register holding its result
+    int a = 5, b = 7;
+    int x = a * b;
+    int y = (a * b) + (a * b);
+    
+    // but not after one of the operands changes
+    a = 6;
+    int z = a * b;
+}
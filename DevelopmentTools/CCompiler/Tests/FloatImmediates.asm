@@ -0,0 +1,34 @@
+; program start section
+  call __global_scope_initialization
+  call __function_main
+  hlt
+
+; location of global variables
+
+__global_scope_initialization:
+  push BP
+  mov BP, SP
+  pop BP
+  ret
+
+__function_main:
+  push BP
+  mov BP, SP
+  isub SP, 3
+  mov R0, 1065353216
+  mov [BP-1], R0
+  mov R0, 3.000000
+  mov R1, 1065353216
+  fmul R0, R1
+  mov [BP-2], R0
+  mov R0, 2.000000
+  mov [BP-3], R0
+  mov R0, [BP-2]
+  mov R1, 2.000000
+  fmul R0, 2.000000
+  mov [BP-2], R0
+__function_main_return:
+  mov SP, BP
+  pop BP
+  ret
+
@@ -0,0 +1,21 @@
+union FloatBits
+{
+    int AsInt;
+    float AsFloat;
+};
+
+void main()
+{
+    // (compile with -O2 to test the optimizer)
+    // registers holding known constants are replaced by
+    // those constants in float operations, but only if
+    // they are written as float values
+    FloatBits One;
+    One.AsInt = 1065353216;
+    float x = 3.0;
+    x = x * One.AsFloat;
+    
+    // this one can be replaced
+    float y = 2.0;
+    x = x * y;
+}
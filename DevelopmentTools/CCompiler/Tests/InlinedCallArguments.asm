@@ -0,0 +1,65 @@
+; program start section
+  call __global_scope_initialization
+  call __function_main
+  hlt
+
+; location of global variables
+  %define global_g 0
+
+__global_scope_initialization:
+  push BP
+  mov BP, SP
+  mov R0, 5
+  mov [global_g], R0
+  pop BP
+  ret
+
+__function_clob:
+  push BP
+  mov BP, SP
+  mov R1, 100
+  mov R2, 200
+  mov R3, 300
+  mov R4, 400
+  mov R5, 500
+  mov R6, 600
+  mov R7, 700
+  mov R8, 800
+  mov R0, 3
+__function_clob_return:
+  mov SP, BP
+  pop BP
+  ret
+
+__function_add:
+  push BP
+  mov BP, SP
+  push R1
+  mov R0, [BP+2]
+  mov R1, [BP+3]
+  iadd R0, R1
+__function_add_return:
+  pop R1
+  mov SP, BP
+  pop BP
+  ret
+
+__function_main:
+  push BP
+  mov BP, SP
+  isub SP, 4
+  call __function_clob
+  mov R1, R0
+  mov [BP-2], R1
+  mov R1, [global_g]
+  mov R2, [BP-2]
+  mov R0, R1
+  mov R3, R2
+  iadd R0, R3
+  mov [BP-1], R0
+  mov [global_g], R0
+__function_main_return:
+  mov SP, BP
+  pop BP
+  ret
+
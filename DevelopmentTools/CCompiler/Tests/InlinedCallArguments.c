@@ -0,0 +1,34 @@
+int g = 5;
+
+// too long to be inlined; it overwrites
+// registers that inlined calls could use
+int clob()
+{
+    asm
+    {
+        "mov R1, 100"
+        "mov R2, 200"
+        "mov R3, 300"
+        "mov R4, 400"
+        "mov R5, 500"
+        "mov R6, 600"
+        "mov R7, 700"
+        "mov R8, 800"
+        "mov R0, 3"
+    }
+}
+
+int add( int a, int b )
+{
+    return a + b;
+}
+
+void main()
+{
+    // (compile with -O2 to test the inliner)
+    // parameters that use calls are evaluated first,
+    // so that the call does not overwrite the value
+    // of g that was already loaded for argument a
+    int r = add( g, clob() );
+    g = r;
+}
@@ -0,0 +1,38 @@
+// runtime test for the optimizer: the program must end
+// with R0 = 353408 when compiled with and without -O2
+
+int add( int x, int y )
+{
+    return x + y;
+}
+
+int twice( int x )
+{
+    return x * 2;
+}
+
+int square( int x )
+{
+    return x * x;
+}
+
+void main( void )
+{
+    int a = 3, b = 5;
+    
+    // calls in the arguments of inlined calls
+    int r = add( a, twice( b ) );
+    r += add( twice( a ), add( b, twice( 4 ) ) );
+    r += add( square( a + 1 ), square( b - 1 ) ) * 10;
+    
+    // results of calls used several times
+    int s = twice( r ) + twice( r );
+    int result = r * 1000 + s;
+    
+    // leave the result for the tester and stop
+    asm
+    {
+        "mov R0, {result}"
+        "hlt"
+    }
+}
@@ -0,0 +1,32 @@
+// runtime test for the optimizer: the program must end
+// with R0 = 6200 when compiled with and without -O2
+
+int[ 10 ] values;
+
+void main( void )
+{
+    int a = 7, b = 12, total = 0;
+    
+    for( int i = 0; i < 10; i++ )
+    {
+        values[ i ] = a * i + b;
+        total += (a * i + b) * 2 - values[ i ];
+        total += (a * i + b) % 5;
+        
+        // the same expression on other values
+        a = a + 1;
+        total += a * i + b;
+    }
+    
+    int x = values[ 3 ] * values[ 4 ];
+    int y = values[ 3 ] * values[ 4 ] + 1;
+    int z = (x - y) * (x - y) + (x - y);
+    int result = total + x + y + z;
+    
+    // leave the result for the tester and stop
+    asm
+    {
+        "mov R0, {result}"
+        "hlt"
+    }
+}
@@ -0,0 +1,41 @@
+// runtime test for the optimizer: the program must end
+// with R0 = 352470 when compiled with and without -O2
+
+float half = 0.5;
+
+union FloatBits
+{
+    int AsInt;
+    float AsFloat;
+};
+
+void main( void )
+{
+    // integer constants converted to float
+    float f = 3;
+    int n = 4;
+    float g = f * n + half;
+    
+    // float constants converted to integer
+    int k = 2.75;
+    int m = (g * 4.0) + k;
+    
+    // repeated float operations
+    float h = 1.5;
+    float s = h * h + h * h;
+    float t = h * h - 0.25;
+    
+    // integer bits of a float used in float operations
+    FloatBits Two;
+    Two.AsInt = 1073741824;
+    float u = h * Two.AsFloat;
+    
+    int result = (int)u * 100000 + m * 1000 + (int)(s * 100.0) + (int)(t * 10.0);
+    
+    // leave the result for the tester and stop
+    asm
+    {
+        "mov R0, {result}"
+        "hlt"
+    }
+}
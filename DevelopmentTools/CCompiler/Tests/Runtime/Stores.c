@@ -0,0 +1,36 @@
+// runtime test for the optimizer: the program must end
+// with R0 = 3484 when compiled with and without -O2
+
+int g = 1;
+
+void main( void )
+{
+    // stores through pointers alias named variables
+    int a = 1;
+    int* p = &a;
+    a = 2;
+    *p = 3;
+    int b = a;
+    a = 4;
+    
+    int[ 4 ] values;
+    values[ 0 ] = 1;
+    values[ 0 ] = 2;
+    int* q = values;
+    q[ 0 ] += 5;
+    
+    // globals are stored before calls
+    int* r = &g;
+    g = 6;
+    *r += 1;
+    g = g * 2;
+    
+    int result = b * 1000 + a * 100 + values[ 0 ] * 10 + g;
+    
+    // leave the result for the tester and stop
+    asm
+    {
+        "mov R0, {result}"
+        "hlt"
+    }
+}
@@ -6,6 +6,7 @@
     #include "VirconCAnalyzer.hpp"
     #include "CheckNodes.hpp"
     #include "CompilerInfrastructure.hpp"
+    #include "Globals.hpp"
     
     // include C/C++ headers
     #include <iostream>         // [ C++ STL ] I/O Streams
@@ -194,7 +195,10 @@ void VirconCAnalyzer::AnalyzeVariable( VariableNode* Variable )
     }
     
     // watch for unused variables
-    if( !Variable->IsExtern && !Variable->IsReferenced )
+    // (in modules, globals can be used from other modules)
+    bool CanBeUsedElsewhere = CompileOnly && Variable->Placement.IsGlobal;
+    
+    if( !Variable->IsExtern && !Variable->IsReferenced && !CanBeUsedElsewhere )
       RaiseWarning( Variable->Location, "variable \"" + Variable->Name + "\" is not used" );
 }
 
@@ -633,7 +637,20 @@ void VirconCAnalyzer::AnalyzeGlobalVariables()
         // if a full definition was declared at some point,
         // it will be the one that remains in the scope
         // (previous partial ones will be replaced)
-        if( Variable->IsExtern )
+        if( !Variable->IsExtern )
+          continue;
+        
+        // when compiling a module, the variable can be defined
+        // in another one: access it by name and let the linker
+        // resolve it (there is no RAM to allocate here)
+        if( CompileOnly )
+        {
+            Variable->Placement.IsGlobal = true;
+            Variable->Placement.GlobalName = Variable->Name;
+            Variable->Placement.UsesGlobalName = true;
+        }
+        
+        else
           RaiseError( Variable->Location, string("variable '") + Variable->Name + "' has been declared but not fully defined" );
     }
 }
@@ -655,8 +672,9 @@ void VirconCAnalyzer::AnalyzeFunctions()
         
         // if a full definition was declared at some point,
         // it will be the one that remains in the scope
-        // (previous partial ones will be replaced)
-        if( !Function->HasBody )
+        // (previous partial ones will be replaced);
+        // modules can call functions from other modules
+        if( !Function->HasBody && !CompileOnly )
           RaiseError( Function->Location, string("function '") + Function->Name + "' has been declared but not fully defined" );
     }
 }
@@ -730,7 +748,9 @@ void VirconCAnalyzer::Analyze( TopLevelNode& ProgramAST_, bool IsBios )
     AnalyzeFunctions();
     
     // at program level, analyze the main function
-    AnalyzeMainFunction();
+    // (when compiling a module it can be in another one)
+    if( !CompileOnly || ProgramAST->ResolveIdentifier( "main" ) )
+      AnalyzeMainFunction();
     
     // if this is a BIOS program, we need to have a
     // specific function for handling hardware errors
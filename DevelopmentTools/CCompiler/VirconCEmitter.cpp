@@ -5,6 +5,7 @@
     // include project headers
     #include "VirconCEmitter.hpp"
     #include "CompilerInfrastructure.hpp"
+    #include "Globals.hpp"
     
     // include C/C++ headers
     #include <iostream>         // [ C++ STL ] I/O Streams
@@ -23,6 +24,7 @@
 VirconCEmitter::VirconCEmitter()
 {
     ProgramAST = nullptr;
+    EmittingInlinedCode = false;
 }
 
 // -----------------------------------------------------------------------------
@@ -44,6 +46,11 @@ void VirconCEmitter::AddDebugInfo( CNode* Node )
     if( Node->IsPartialDefinition() )
       return;
     
+    // inlined code belongs to the call site, not to
+    // the source lines of the function being inlined
+    if( EmittingInlinedCode )
+      return;
+    
     // add each C source line to the list only once
     if( !LineMapping.empty() )
     {
@@ -59,6 +66,19 @@ void VirconCEmitter::AddDebugInfo( CNode* Node )
     LineMapping[ ProgramLines.size() + 2 ] = Node;
 }
 
+// -----------------------------------------------------------------------------
+
+// these are marked as shared, so that the linker
+// uses only one of them instead of reporting them
+// as ambiguous (or keeping separate variables)
+bool VirconCEmitter::IsSharedDefinition( CNode* Node )
+{
+    if( !CompileOnly )
+      return false;
+    
+    return (Node->Location.FilePath != ProgramAST->Location.FilePath);
+}
+
 
 // =============================================================================
 //      VIRCON C EMITTER: EMIT FUNCTIONS FOR ABSTRACT NODE TYPES
@@ -371,11 +391,15 @@ void VirconCEmitter::EmitGlobalScopeFunction()
 void VirconCEmitter::EmitProgramStartSection()
 {
     // now emit a jump to main functions, that will avoid function code
-    ProgramLines.push_back( "; program start section" );
-    ProgramLines.push_back( "call __global_scope_initialization" );
-    ProgramLines.push_back( "call __function_main" );
-    ProgramLines.push_back( "hlt" );
-    ProgramLines.push_back( "" );
+    // (for modules, the linker creates a start section for all of them)
+    if( !CompileOnly )
+    {
+        ProgramLines.push_back( "; program start section" );
+        ProgramLines.push_back( "call __global_scope_initialization" );
+        ProgramLines.push_back( "call __function_main" );
+        ProgramLines.push_back( "hlt" );
+        ProgramLines.push_back( "" );
+    }
     
     //  emit names of global variables (but not their initialization)
     ProgramLines.push_back( "; location of global variables" );
@@ -393,8 +417,19 @@ void VirconCEmitter::EmitProgramStartSection()
             if( Variable->IsExtern )
               continue;
             
+            // modules only name their variables, since
+            // the linker will place them in RAM with others
+            if( CompileOnly )
+            {
+                if( IsSharedDefinition( Variable ) )
+                  ProgramLines.push_back( "shared __global_" + Variable->Name );
+                
+                ProgramLines.push_back( "ram __global_" + Variable->Name + ", " + to_string(Variable->DeclaredType->SizeInWords()) );
+            }
+            
             // emit variable name for easier reading
-            ProgramLines.push_back( "%define global_" + Variable->Name + " " + to_string(Variable->Placement.GlobalAddress) );
+            else
+              ProgramLines.push_back( "%define global_" + Variable->Name + " " + to_string(Variable->Placement.GlobalAddress) );
         }
     }
     
@@ -630,38 +665,45 @@ void VirconCEmitter::Emit( TopLevelNode& ProgramAST_, bool IsBios )
 
 // -----------------------------------------------------------------------------
 
-void VirconCEmitter::SaveAssembly( const std::string& FilePath )
+void VirconCEmitter::WriteAssembly( ostream& Output )
 {
-    // open output file, in text mode
-    ofstream OutputFile;
-    OpenOutputFile( OutputFile, FilePath, ios_base::out );
-    
-    if( OutputFile.fail() )
-      throw runtime_error( "cannot open output file \"" + FilePath + "\"" );
-    
     // write the whole program assembly into the output
-    for( string Line: ProgramLines )
+    for( const string& Line: ProgramLines )
     {
         // all lines are indented except
         // for labels and comments
         if( !Line.empty() )
           if( Line[0] != ';' && Line[0] != '_' )
-            OutputFile << "  ";
+            Output << "  ";
         
-        OutputFile << Line << endl;
+        Output << Line << '\n';
     }
     
     // write the whole data assembly into the output
-    for( string Line: DataLines )
+    for( const string& Line: DataLines )
     {
         // all lines are indented except
         // for labels and comments
         if( !Line.empty() )
           if( Line[0] != ';' && Line[0] != '_' )
-            OutputFile << "  ";
+            Output << "  ";
         
-        OutputFile << Line << endl;
+        Output << Line << '\n';
     }
+}
+
+// -----------------------------------------------------------------------------
+
+void VirconCEmitter::SaveAssembly( const std::string& FilePath )
+{
+    // open output file, in text mode
+    ofstream OutputFile;
+    OpenOutputFile( OutputFile, FilePath, ios_base::out );
+    
+    if( OutputFile.fail() )
+      throw runtime_error( "cannot open output file \"" + FilePath + "\"" );
+    
+    WriteAssembly( OutputFile );
     
     // close output
     OutputFile.close();
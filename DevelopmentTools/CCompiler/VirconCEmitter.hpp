@@ -6,6 +6,9 @@
     // include project headers
     #include "CNodes.hpp"
     #include "RegisterAllocation.hpp"
+    
+    // include C/C++ headers
+    #include <ostream>          // [ C++ STL ] Output streams
 // *****************************************************************************
 
 
@@ -30,12 +33,21 @@ class VirconCEmitter
         // debug info: C->ASM line correspondence
         std::map< int, CNode* > LineMapping;
         
+        // state for inlining of small leaf functions
+        std::map< FunctionNode*, bool > InlinableFunctions;
+        std::map< VariableNode*, int > InlinedArguments;
+        bool EmittingInlinedCode;
+        
     public:
         
         // called when emitting ASM to keep track of
         // C -> ASM line correspondence (for debug info)
         void AddDebugInfo( CNode* Node );
         
+        // in modules, definitions from included files
+        // are repeated in every module including them
+        bool IsSharedDefinition( CNode* Node );
+        
         // emit functions for abstract node types
         int EmitCNode( CNode* Node );
         int EmitRootExpression( ExpressionNode* Expression );
@@ -129,6 +141,12 @@ class VirconCEmitter
         // helper function for all compound assignments
         void EmitComplementaryAssignment( BinaryOperationNode* BinaryOperation, RegisterAllocation& Registers, int ResultRegister );
         
+        // inlining of calls to small leaf functions
+        bool IsInlinableFunction( FunctionNode* Function );
+        bool IsInlinableAssembly( FunctionNode* Function, AssemblyBlockNode* AssemblyBlock, int& InlinedSize );
+        bool IsInlinableExpression( FunctionNode* Function, ExpressionNode* Expression, int& InlinedSize );
+        void EmitInlinedFunctionCall( FunctionCallNode* FunctionCall, RegisterAllocation& Registers, int ResultRegister );
+        
         // non-node emission functions
         void EmitLabel( const std::string& LabelName );
         void EmitRegisterTypeConversion( int RegisterNumber, PrimitiveTypes ProducedType, PrimitiveTypes NeededType );
@@ -151,6 +169,7 @@ class VirconCEmitter
         
         // main emission function
         void Emit( TopLevelNode& ProgramAST_, bool IsBios );
+        void WriteAssembly( std::ostream& Output );
         void SaveAssembly( const std::string& FilePath );
 };
 
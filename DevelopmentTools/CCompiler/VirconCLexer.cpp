@@ -94,7 +94,7 @@ VirconCLexer::VirconCLexer()
 
 VirconCLexer::~VirconCLexer()
 {
-    for( CTokenList Line: TokenLines )
+    for( CTokenList& Line: TokenLines )
     {
         for( CToken* T : Line )
           delete T;
@@ -129,7 +129,7 @@ void VirconCLexer::OpenFile( const string& FilePath )
     InputDirectory = GetPathDirectory( FilePath );
     
     // reset any previous reads
-    ReadLocation.FilePath = FilePath;
+    ReadLocation.FilePath = InternFilePath( FilePath );
     ReadLocation.Line = 1;
     ReadLocation.LogicalLine = 1;
     ReadLocation.Column = 1;
@@ -137,7 +137,7 @@ void VirconCLexer::OpenFile( const string& FilePath )
     LineIsContinued = false;
     
     // reset any previous results
-    for( CTokenList Line: TokenLines )
+    for( CTokenList& Line: TokenLines )
     {
         for( CToken* T : Line )
           delete T;
@@ -0,0 +1,1081 @@
+// *****************************************************************************
+    // include project headers
+    #include "VirconCOptimizer.hpp"
+    #include "CompilerInfrastructure.hpp"
+    #include "Globals.hpp"
+    
+    // include C/C++ headers
+    #include <iostream>         // [ C++ STL ] I/O Streams
+    #include <set>              // [ C++ STL ] Sets
+    #include <cctype>           // [ ANSI C ] Character handling
+    #include <cstdlib>          // [ ANSI C ] Standard library
+    
+    // declare used namespaces
+    using namespace std;
+// *****************************************************************************
+
+
+// =============================================================================
+//      AUXILIARY FUNCTIONS
+// =============================================================================
+
+
+// classification of all CPU instructions
+const map< string, AssemblyLineTypes > InstructionTypes =
+{
+    { "hlt",   AssemblyLineTypes::BlockEnd },
+    { "jmp",   AssemblyLineTypes::BlockEnd },
+    { "call",  AssemblyLineTypes::BlockEnd },
+    { "ret",   AssemblyLineTypes::BlockEnd },
+    { "jt",    AssemblyLineTypes::BlockEnd },
+    { "jf",    AssemblyLineTypes::BlockEnd },
+    { "wait",  AssemblyLineTypes::Wait },
+    { "mov",   AssemblyLineTypes::Move },
+    { "lea",   AssemblyLineTypes::LoadAddress },
+    { "push",  AssemblyLineTypes::Push },
+    { "pop",   AssemblyLineTypes::Pop },
+    { "in",    AssemblyLineTypes::PortInput },
+    { "out",   AssemblyLineTypes::PortOutput },
+    { "ieq",   AssemblyLineTypes::IntegerOperation },
+    { "ine",   AssemblyLineTypes::IntegerOperation },
+    { "igt",   AssemblyLineTypes::IntegerOperation },
+    { "ige",   AssemblyLineTypes::IntegerOperation },
+    { "ilt",   AssemblyLineTypes::IntegerOperation },
+    { "ile",   AssemblyLineTypes::IntegerOperation },
+    { "and",   AssemblyLineTypes::IntegerOperation },
+    { "or",    AssemblyLineTypes::IntegerOperation },
+    { "xor",   AssemblyLineTypes::IntegerOperation },
+    { "shl",   AssemblyLineTypes::IntegerOperation },
+    { "iadd",  AssemblyLineTypes::IntegerOperation },
+    { "isub",  AssemblyLineTypes::IntegerOperation },
+    { "imul",  AssemblyLineTypes::IntegerOperation },
+    { "idiv",  AssemblyLineTypes::IntegerOperation },
+    { "imod",  AssemblyLineTypes::IntegerOperation },
+    { "imin",  AssemblyLineTypes::IntegerOperation },
+    { "imax",  AssemblyLineTypes::IntegerOperation },
+    { "feq",   AssemblyLineTypes::FloatOperation },
+    { "fne",   AssemblyLineTypes::FloatOperation },
+    { "fgt",   AssemblyLineTypes::FloatOperation },
+    { "fge",   AssemblyLineTypes::FloatOperation },
+    { "flt",   AssemblyLineTypes::FloatOperation },
+    { "fle",   AssemblyLineTypes::FloatOperation },
+    { "fadd",  AssemblyLineTypes::FloatOperation },
+    { "fsub",  AssemblyLineTypes::FloatOperation },
+    { "fmul",  AssemblyLineTypes::FloatOperation },
+    { "fdiv",  AssemblyLineTypes::FloatOperation },
+    { "fmod",  AssemblyLineTypes::FloatOperation },
+    { "fmin",  AssemblyLineTypes::FloatOperation },
+    { "fmax",  AssemblyLineTypes::FloatOperation },
+    { "atan2", AssemblyLineTypes::RegisterOperation },
+    { "pow",   AssemblyLineTypes::RegisterOperation },
+    { "cif",   AssemblyLineTypes::UnaryOperation },
+    { "cfi",   AssemblyLineTypes::UnaryOperation },
+    { "cib",   AssemblyLineTypes::UnaryOperation },
+    { "cfb",   AssemblyLineTypes::UnaryOperation },
+    { "not",   AssemblyLineTypes::UnaryOperation },
+    { "bnot",  AssemblyLineTypes::UnaryOperation },
+    { "isgn",  AssemblyLineTypes::UnaryOperation },
+    { "iabs",  AssemblyLineTypes::UnaryOperation },
+    { "fsgn",  AssemblyLineTypes::UnaryOperation },
+    { "fabs",  AssemblyLineTypes::UnaryOperation },
+    { "flr",   AssemblyLineTypes::UnaryOperation },
+    { "ceil",  AssemblyLineTypes::UnaryOperation },
+    { "round", AssemblyLineTypes::UnaryOperation },
+    { "sin",   AssemblyLineTypes::UnaryOperation },
+    { "acos",  AssemblyLineTypes::UnaryOperation },
+    { "log",   AssemblyLineTypes::UnaryOperation }
+    
+    // movs, sets and cmps are left out on purpose:
+    // they use several registers and memory implicitly,
+    // so they are handled as barriers
+};
+
+// -----------------------------------------------------------------------------
+
+string TrimSpaces( const string& Text )
+{
+    size_t First = Text.find_first_not_of( " \t\r" );
+    
+    if( First == string::npos )
+      return "";
+    
+    size_t Last = Text.find_last_not_of( " \t\r" );
+    return Text.substr( First, Last - First + 1 );
+}
+
+// -----------------------------------------------------------------------------
+
+// only decimal integers are considered, so that
+// they can be used as immediates by any instruction
+bool IsIntegerLiteral( const string& Text )
+{
+    unsigned Start = (Text[ 0 ] == '-'? 1 : 0);
+    
+    if( Text.size() <= Start )
+      return false;
+    
+    for( unsigned i = Start; i < Text.size(); i++ )
+      if( !isdigit( (unsigned char)Text[ i ] ) )
+        return false;
+    
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+
+bool IsFloatLiteral( const string& Text )
+{
+    unsigned Start = (Text[ 0 ] == '-'? 1 : 0);
+    
+    if( Text.size() <= Start )
+      return false;
+    
+    int Dots = 0;
+    
+    for( unsigned i = Start; i < Text.size(); i++ )
+    {
+        if( Text[ i ] == '.' )
+          Dots++;
+        
+        else if( !isdigit( (unsigned char)Text[ i ] ) )
+          return false;
+    }
+    
+    return (Dots == 1);
+}
+
+// -----------------------------------------------------------------------------
+
+string RegisterName( int Register )
+{
+    if( Register == 14 ) return "BP";
+    if( Register == 15 ) return "SP";
+    return "R" + to_string( Register );
+}
+
+// -----------------------------------------------------------------------------
+
+// (instructions writing a register always have it as first operand)
+bool WritesRegister( const OptimizedLine& Line, int Register )
+{
+    if( Line.Operands.empty() || Line.Operands[ 0 ].Type != AssemblyOperandTypes::Register )
+      return false;
+    
+    if( Line.Type == AssemblyLineTypes::PortOutput || Line.Type == AssemblyLineTypes::Push )
+      return false;
+    
+    return (Line.Operands[ 0 ].RegisterNumber == Register);
+}
+
+
+// =============================================================================
+//      VIRCON C OPTIMIZER: INSTANCE HANDLING
+// =============================================================================
+
+
+VirconCOptimizer::VirconCOptimizer()
+{
+    RewrittenLines = 0;
+    RemovedLines = 0;
+    NextValue = 0;
+}
+
+// -----------------------------------------------------------------------------
+
+VirconCOptimizer::~VirconCOptimizer()
+{
+    // (do nothing)
+}
+
+
+// =============================================================================
+//      VIRCON C OPTIMIZER: PARSING OF ASSEMBLY LINES
+// =============================================================================
+
+
+AssemblyOperand VirconCOptimizer::ParseOperand( const string& Text )
+{
+    AssemblyOperand Operand;
+    Operand.Text = Text;
+    Operand.RegisterNumber = -1;
+    
+    // case 1: memory addresses
+    if( Text.size() >= 2 && Text[ 0 ] == '[' && Text.back() == ']' )
+    {
+        Operand.Type = AssemblyOperandTypes::OtherMemory;
+        
+        // remove brackets and all spaces
+        string Address;
+        
+        for( char c: Text.substr( 1, Text.size() - 2 ) )
+          if( c != ' ' && c != '\t' )
+            Address += c;
+        
+        Operand.Text = Address;
+        
+        // named global variables (in modules they are labels)
+        bool IsGlobalName = (Address.compare( 0, 7, "global_" ) == 0 || Address.compare( 0, 9, "__global_" ) == 0);
+        
+        if( IsGlobalName && Address.find_first_of( "+-" ) == string::npos )
+        {
+            Operand.Type = AssemblyOperandTypes::GlobalMemory;
+            return Operand;
+        }
+        
+        // local variables and function arguments; their
+        // address is normalized as BP+n or BP-n to detect
+        // all references to the same position
+        string UpperAddress = Address;
+        
+        for( char& c: UpperAddress )
+          c = toupper( (unsigned char)c );
+        
+        if( UpperAddress.compare( 0, 2, "BP" ) == 0 )
+        {
+            string Offset = UpperAddress.substr( 2 );
+            
+            if( Offset.empty() )
+              Offset = "+0";
+            
+            if( Offset[ 0 ] != '+' && Offset[ 0 ] != '-' )
+              return Operand;
+            
+            string OffsetDigits = Offset.substr( 1 );
+            
+            if( !IsIntegerLiteral( OffsetDigits ) || OffsetDigits[ 0 ] == '-' )
+              return Operand;
+            
+            int OffsetValue = stoi( OffsetDigits );
+            
+            if( Offset[ 0 ] == '-' )
+              OffsetValue = -OffsetValue;
+            
+            Operand.Type = AssemblyOperandTypes::LocalMemory;
+            Operand.Text = "BP" + string( OffsetValue < 0? "-" : "+" ) + to_string( abs( OffsetValue ) );
+        }
+        
+        return Operand;
+    }
+    
+    // case 2: registers
+    string UpperText = Text;
+    
+    for( char& c: UpperText )
+      c = toupper( (unsigned char)c );
+    
+    Operand.RegisterNumber = AssemblyRegisterNumber( UpperText );
+    
+    if( Operand.RegisterNumber >= 0 )
+    {
+        Operand.Type = AssemblyOperandTypes::Register;
+        return Operand;
+    }
+    
+    // case 3: anything else is an immediate
+    // (numbers, labels, port names, etc)
+    Operand.Type = AssemblyOperandTypes::Immediate;
+    return Operand;
+}
+
+// -----------------------------------------------------------------------------
+
+void VirconCOptimizer::ParseLine( OptimizedLine& Line )
+{
+    string Text = TrimSpaces( Line.Text );
+    Line.Mnemonic.clear();
+    Line.Operands.clear();
+    
+    // empty lines and comments
+    if( Text.empty() || Text[ 0 ] == ';' )
+    {
+        Line.Type = AssemblyLineTypes::NonCode;
+        return;
+    }
+    
+    // labels
+    if( Text.back() == ':' )
+    {
+        Line.Type = AssemblyLineTypes::Label;
+        return;
+    }
+    
+    // preprocessor directives and strings are not
+    // analyzed, they may contain any characters
+    if( Text[ 0 ] == '%' || Text.find_first_of( "\";" ) != string::npos )
+    {
+        Line.Type = AssemblyLineTypes::Barrier;
+        return;
+    }
+    
+    // separate the mnemonic
+    size_t MnemonicEnd = Text.find_first_of( " \t" );
+    Line.Mnemonic = Text.substr( 0, MnemonicEnd );
+    
+    for( char& c: Line.Mnemonic )
+      c = tolower( (unsigned char)c );
+    
+    // separate operands
+    if( MnemonicEnd != string::npos )
+    {
+        string OperandsText = Text.substr( MnemonicEnd + 1 );
+        size_t Start = 0;
+        
+        while( Start <= OperandsText.size() )
+        {
+            size_t Comma = OperandsText.find( ',', Start );
+            
+            if( Comma == string::npos )
+              Comma = OperandsText.size();
+            
+            string OperandText = TrimSpaces( OperandsText.substr( Start, Comma - Start ) );
+            
+            if( !OperandText.empty() )
+              Line.Operands.push_back( ParseOperand( OperandText ) );
+            
+            Start = Comma + 1;
+        }
+    }
+    
+    // classify the instruction
+    auto Position = InstructionTypes.find( Line.Mnemonic );
+    
+    if( Position == InstructionTypes.end() )
+    {
+        Line.Type = AssemblyLineTypes::Barrier;
+        return;
+    }
+    
+    Line.Type = Position->second;
+    
+    // discard any unexpected operand patterns, so that
+    // the passes can rely on the operands being valid
+    unsigned ExpectedOperands = 0;
+    
+    switch( Line.Type )
+    {
+        case AssemblyLineTypes::Move:
+        case AssemblyLineTypes::LoadAddress:
+        case AssemblyLineTypes::IntegerOperation:
+        case AssemblyLineTypes::FloatOperation:
+        case AssemblyLineTypes::RegisterOperation:
+        case AssemblyLineTypes::PortInput:
+        case AssemblyLineTypes::PortOutput:
+            ExpectedOperands = 2;
+            break;
+        
+        case AssemblyLineTypes::UnaryOperation:
+        case AssemblyLineTypes::Push:
+        case AssemblyLineTypes::Pop:
+            ExpectedOperands = 1;
+            break;
+        
+        default:
+            return;
+    }
+    
+    if( Line.Operands.size() != ExpectedOperands )
+    {
+        Line.Type = AssemblyLineTypes::Barrier;
+        return;
+    }
+    
+    // all instructions that write a register
+    // must have that register as first operand
+    if( Line.Type != AssemblyLineTypes::PortOutput && Line.Type != AssemblyLineTypes::Push )
+      if( Line.Type != AssemblyLineTypes::Move )
+        if( Line.Operands[ 0 ].Type != AssemblyOperandTypes::Register )
+          Line.Type = AssemblyLineTypes::Barrier;
+}
+
+// -----------------------------------------------------------------------------
+
+void VirconCOptimizer::FindBasicBlocks()
+{
+    Blocks.clear();
+    BasicBlock CurrentBlock;
+    CurrentBlock.FirstLine = 0;
+    
+    for( int i = 0; i < (int)Lines.size(); i++ )
+    {
+        // labels start a new block
+        if( Lines[ i ].Type == AssemblyLineTypes::Label )
+        {
+            CurrentBlock.EndLine = i;
+            
+            if( CurrentBlock.EndLine > CurrentBlock.FirstLine )
+              Blocks.push_back( CurrentBlock );
+            
+            CurrentBlock.FirstLine = i;
+        }
+        
+        // jumps, calls, etc. end the current block
+        else if( Lines[ i ].Type == AssemblyLineTypes::BlockEnd )
+        {
+            CurrentBlock.EndLine = i + 1;
+            Blocks.push_back( CurrentBlock );
+            CurrentBlock.FirstLine = i + 1;
+        }
+    }
+    
+    CurrentBlock.EndLine = Lines.size();
+    
+    if( CurrentBlock.EndLine > CurrentBlock.FirstLine )
+      Blocks.push_back( CurrentBlock );
+}
+
+
+// =============================================================================
+//      VIRCON C OPTIMIZER: MODIFICATION OF LINES
+// =============================================================================
+
+
+void VirconCOptimizer::RemoveLine( OptimizedLine& Line, const string& Reason )
+{
+    Line.Removed = true;
+    Line.Note = Reason;
+    RemovedLines++;
+}
+
+// -----------------------------------------------------------------------------
+
+void VirconCOptimizer::RewriteLine( OptimizedLine& Line, const string& NewText )
+{
+    Line.Text = NewText;
+    Line.Note = "rewritten from \"" + Line.OriginalText + "\"";
+    ParseLine( Line );
+    RewrittenLines++;
+}
+
+
+// =============================================================================
+//      VIRCON C OPTIMIZER: HELPERS FOR VALUE NUMBERING
+// =============================================================================
+
+
+void VirconCOptimizer::ForgetAllValues()
+{
+    // each register starts with its own unknown value
+    for( int r = 0; r < 16; r++ )
+      RegisterValues[ r ] = NextValue++;
+    
+    MemoryValues.clear();
+    ImmediateValues.clear();
+    ValueConstants.clear();
+    ExpressionValues.clear();
+}
+
+// -----------------------------------------------------------------------------
+
+void VirconCOptimizer::ForgetMemoryValues( AssemblyOperandTypes StoredType, const string& Address )
+{
+    // a write to a named position can only affect
+    // itself, but any other write may have aliases
+    if( StoredType == AssemblyOperandTypes::LocalMemory || StoredType == AssemblyOperandTypes::GlobalMemory )
+      MemoryValues.erase( Address );
+    
+    else
+      MemoryValues.clear();
+}
+
+// -----------------------------------------------------------------------------
+
+int VirconCOptimizer::GetOperandValue( const AssemblyOperand& Operand )
+{
+    switch( Operand.Type )
+    {
+        case AssemblyOperandTypes::Register:
+            return RegisterValues[ Operand.RegisterNumber ];
+        
+        case AssemblyOperandTypes::Immediate:
+        {
+            auto Position = ImmediateValues.find( Operand.Text );
+            
+            if( Position != ImmediateValues.end() )
+              return Position->second;
+            
+            int Value = NextValue++;
+            ImmediateValues[ Operand.Text ] = Value;
+            ValueConstants[ Value ] = Operand.Text;
+            return Value;
+        }
+        
+        case AssemblyOperandTypes::LocalMemory:
+        case AssemblyOperandTypes::GlobalMemory:
+        {
+            auto Position = MemoryValues.find( Operand.Text );
+            
+            if( Position != MemoryValues.end() )
+              return Position->second;
+            
+            int Value = NextValue++;
+            MemoryValues[ Operand.Text ] = Value;
+            return Value;
+        }
+        
+        // we cannot know what other memory contains
+        default:
+            return NextValue++;
+    }
+}
+
+// -----------------------------------------------------------------------------
+
+// an operation is identified by its instruction and the
+// values of its operands, so repeating it on the same
+// values produces the same value as the first time
+int VirconCOptimizer::GetExpressionValue( const OptimizedLine& Line )
+{
+    string Expression = Line.Mnemonic;
+    
+    for( const AssemblyOperand& Operand: Line.Operands )
+      Expression += " " + to_string( GetOperandValue( Operand ) );
+    
+    auto Position = ExpressionValues.find( Expression );
+    
+    if( Position != ExpressionValues.end() )
+      return Position->second;
+    
+    int Value = NextValue++;
+    ExpressionValues[ Expression ] = Value;
+    return Value;
+}
+
+// -----------------------------------------------------------------------------
+
+// when another register still holds the result of an
+// operation, the operation is replaced by a copy of it
+bool VirconCOptimizer::ReuseComputedValue( OptimizedLine& Line, int Value )
+{
+    int Register = Line.Operands[ 0 ].RegisterNumber;
+    
+    if( Register >= 14 )
+      return false;
+    
+    for( int r = 0; r < 14; r++ )
+      if( r != Register && RegisterValues[ r ] == Value )
+      {
+          RewriteLine( Line, "mov " + RegisterName( Register ) + ", " + RegisterName( r ) );
+          return true;
+      }
+    
+    return false;
+}
+
+
+// =============================================================================
+//      VIRCON C OPTIMIZER: HELPERS FOR LIVENESS
+// =============================================================================
+
+
+void VirconCOptimizer::GetRegisterUsage( const OptimizedLine& Line, bool* ReadRegisters, bool* WrittenRegisters )
+{
+    for( int r = 0; r < 16; r++ )
+    {
+        ReadRegisters[ r ] = false;
+        WrittenRegisters[ r ] = false;
+    }
+    
+    // lines we cannot analyze may read any register
+    if( Line.Type == AssemblyLineTypes::Barrier || Line.Type == AssemblyLineTypes::BlockEnd || Line.Type == AssemblyLineTypes::Label )
+    {
+        for( int r = 0; r < 16; r++ )
+          ReadRegisters[ r ] = true;
+        
+        return;
+    }
+    
+    // registers used to form memory addresses are read
+    for( const AssemblyOperand& Operand: Line.Operands )
+    {
+        if( Operand.Type == AssemblyOperandTypes::Register || Operand.Type == AssemblyOperandTypes::Immediate )
+          continue;
+        
+        for( const string& Word: SplitAssemblyWords( Operand.Text ) )
+        {
+            int Register = AssemblyRegisterNumber( Word );
+            
+            if( Register >= 0 )
+              ReadRegisters[ Register ] = true;
+        }
+    }
+    
+    // now check each instruction type
+    switch( Line.Type )
+    {
+        case AssemblyLineTypes::Move:
+            if( Line.Operands[ 1 ].Type == AssemblyOperandTypes::Register )
+              ReadRegisters[ Line.Operands[ 1 ].RegisterNumber ] = true;
+            
+            if( Line.Operands[ 0 ].Type == AssemblyOperandTypes::Register )
+              WrittenRegisters[ Line.Operands[ 0 ].RegisterNumber ] = true;
+            
+            break;
+        
+        case AssemblyLineTypes::LoadAddress:
+        case AssemblyLineTypes::PortInput:
+            WrittenRegisters[ Line.Operands[ 0 ].RegisterNumber ] = true;
+            break;
+        
+        case AssemblyLineTypes::IntegerOperation:
+        case AssemblyLineTypes::FloatOperation:
+        case AssemblyLineTypes::RegisterOperation:
+            if( Line.Operands[ 1 ].Type == AssemblyOperandTypes::Register )
+              ReadRegisters[ Line.Operands[ 1 ].RegisterNumber ] = true;
+            
+            ReadRegisters[ Line.Operands[ 0 ].RegisterNumber ] = true;
+            WrittenRegisters[ Line.Operands[ 0 ].RegisterNumber ] = true;
+            break;
+        
+        case AssemblyLineTypes::UnaryOperation:
+            ReadRegisters[ Line.Operands[ 0 ].RegisterNumber ] = true;
+            WrittenRegisters[ Line.Operands[ 0 ].RegisterNumber ] = true;
+            break;
+        
+        case AssemblyLineTypes::Push:
+            if( Line.Operands[ 0 ].Type == AssemblyOperandTypes::Register )
+              ReadRegisters[ Line.Operands[ 0 ].RegisterNumber ] = true;
+            
+            ReadRegisters[ 15 ] = true;
+            WrittenRegisters[ 15 ] = true;
+            break;
+        
+        case AssemblyLineTypes::Pop:
+            WrittenRegisters[ Line.Operands[ 0 ].RegisterNumber ] = true;
+            ReadRegisters[ 15 ] = true;
+            WrittenRegisters[ 15 ] = true;
+            break;
+        
+        case AssemblyLineTypes::PortOutput:
+            if( Line.Operands[ 1 ].Type == AssemblyOperandTypes::Register )
+              ReadRegisters[ Line.Operands[ 1 ].RegisterNumber ] = true;
+            
+            break;
+        
+        default:
+            break;
+    }
+}
+
+
+
+// =============================================================================
+//      VIRCON C OPTIMIZER: OPTIMIZATION PASSES
+// =============================================================================
+
+
+// value numbering within the block: every value held
+// in a register or named memory position gets a number,
+// so that we can detect redundant copies, replace register
+// operands by the constants they hold and reuse the results
+// of operations that were already computed
+bool VirconCOptimizer::PropagateValues( BasicBlock& Block )
+{
+    bool Changed = false;
+    ForgetAllValues();
+    
+    for( int i = Block.FirstLine; i < Block.EndLine; i++ )
+    {
+        OptimizedLine& Line = Lines[ i ];
+        
+        if( Line.Removed )
+          continue;
+        
+        switch( Line.Type )
+        {
+            case AssemblyLineTypes::NonCode:
+            case AssemblyLineTypes::Wait:
+                break;
+            
+            case AssemblyLineTypes::Move:
+            {
+                AssemblyOperand& Destination = Line.Operands[ 0 ];
+                AssemblyOperand& Source = Line.Operands[ 1 ];
+                
+                // case 1: write to a register
+                if( Destination.Type == AssemblyOperandTypes::Register )
+                {
+                    int Register = Destination.RegisterNumber;
+                    int Value = GetOperandValue( Source );
+                    
+                    if( PropagateCopies && RegisterValues[ Register ] == Value )
+                    {
+                        RemoveLine( Line, "register already holds this value" );
+                        Changed = true;
+                        break;
+                    }
+                    
+                    // a register or memory position with a known
+                    // constant can be replaced by that constant
+                    if( PropagateConstants && Source.Type != AssemblyOperandTypes::Immediate && ValueConstants.count( Value ) )
+                    {
+                        string Constant = ValueConstants[ Value ];
+                        
+                        if( IsIntegerLiteral( Constant ) || IsFloatLiteral( Constant ) )
+                        {
+                            RewriteLine( Line, "mov " + RegisterName( Register ) + ", " + Constant );
+                            Changed = true;
+                        }
+                    }
+                    
+                    RegisterValues[ Register ] = Value;
+                    
+                    // local addresses are relative to BP
+                    if( Register == 14 )
+                      MemoryValues.clear();
+                }
+                
+                // case 2: write to memory
+                else
+                {
+                    int Value = GetOperandValue( Source );
+                    bool IsNamed = (Destination.Type == AssemblyOperandTypes::LocalMemory || Destination.Type == AssemblyOperandTypes::GlobalMemory);
+                    
+                    if( PropagateCopies && IsNamed && MemoryValues.count( Destination.Text ) && MemoryValues[ Destination.Text ] == Value )
+                    {
+                        RemoveLine( Line, "memory already holds this value" );
+                        Changed = true;
+                        break;
+                    }
+                    
+                    ForgetMemoryValues( Destination.Type, Destination.Text );
+                    
+                    if( IsNamed )
+                      MemoryValues[ Destination.Text ] = Value;
+                }
+                
+                break;
+            }
+            
+            case AssemblyLineTypes::IntegerOperation:
+            case AssemblyLineTypes::FloatOperation:
+            {
+                AssemblyOperand& Destination = Line.Operands[ 0 ];
+                AssemblyOperand& Source = Line.Operands[ 1 ];
+                
+                if( PropagateConstants && Source.Type == AssemblyOperandTypes::Register )
+                {
+                    int Value = RegisterValues[ Source.RegisterNumber ];
+                    
+                    if( ValueConstants.count( Value ) )
+                    {
+                        // each type of instruction only accepts its own type of
+                        // immediates: the assembler would read an integer given
+                        // to a float instruction as a number, not as its bits
+                        string Constant = ValueConstants[ Value ];
+                        bool Accepted = IsIntegerLiteral( Constant );
+                        
+                        if( Line.Type == AssemblyLineTypes::FloatOperation )
+                          Accepted = IsFloatLiteral( Constant );
+                        
+                        if( Accepted )
+                        {
+                            RewriteLine( Line, Line.Mnemonic + " " + RegisterName( Destination.RegisterNumber ) + ", " + Constant );
+                            Changed = true;
+                        }
+                    }
+                }
+                
+                int Register = Destination.RegisterNumber;
+                int Value = GetExpressionValue( Line );
+                
+                if( EliminateCommonSubexpressions )
+                  Changed |= ReuseComputedValue( Line, Value );
+                
+                RegisterValues[ Register ] = Value;
+                
+                if( Register == 14 )
+                  MemoryValues.clear();
+                
+                break;
+            }
+            
+            case AssemblyLineTypes::RegisterOperation:
+            case AssemblyLineTypes::UnaryOperation:
+            {
+                int Register = Line.Operands[ 0 ].RegisterNumber;
+                int Value = GetExpressionValue( Line );
+                
+                if( EliminateCommonSubexpressions )
+                  Changed |= ReuseComputedValue( Line, Value );
+                
+                RegisterValues[ Register ] = Value;
+                
+                if( Register == 14 )
+                  MemoryValues.clear();
+                
+                break;
+            }
+            
+            case AssemblyLineTypes::PortOutput:
+            {
+                AssemblyOperand& Source = Line.Operands[ 1 ];
+                
+                if( PropagateConstants && Source.Type == AssemblyOperandTypes::Register )
+                {
+                    int Value = RegisterValues[ Source.RegisterNumber ];
+                    
+                    if( ValueConstants.count( Value ) )
+                    {
+                        string Constant = ValueConstants[ Value ];
+                        
+                        if( IsIntegerLiteral( Constant ) || IsFloatLiteral( Constant ) )
+                        {
+                            RewriteLine( Line, "out " + Line.Operands[ 0 ].Text + ", " + Constant );
+                            Changed = true;
+                        }
+                    }
+                }
+                
+                break;
+            }
+            
+            case AssemblyLineTypes::LoadAddress:
+            case AssemblyLineTypes::PortInput:
+                RegisterValues[ Line.Operands[ 0 ].RegisterNumber ] = NextValue++;
+                
+                if( Line.Operands[ 0 ].RegisterNumber == 14 )
+                  MemoryValues.clear();
+                
+                break;
+            
+            case AssemblyLineTypes::Push:
+                // the stack may overlap local variables
+                MemoryValues.clear();
+                RegisterValues[ 15 ] = NextValue++;
+                break;
+            
+            case AssemblyLineTypes::Pop:
+                RegisterValues[ Line.Operands[ 0 ].RegisterNumber ] = NextValue++;
+                RegisterValues[ 15 ] = NextValue++;
+                
+                if( Line.Operands[ 0 ].RegisterNumber == 14 )
+                  MemoryValues.clear();
+                
+                break;
+            
+            // labels, barriers and block ends
+            default:
+                ForgetAllValues();
+                break;
+        }
+    }
+    
+    return Changed;
+}
+
+// -----------------------------------------------------------------------------
+
+// backwards liveness analysis within the block: all registers
+// are considered live at the end, so only writes that are
+// overwritten within the same block can be found to be dead
+bool VirconCOptimizer::RemoveDeadRegisterWrites( BasicBlock& Block )
+{
+    bool Changed = false;
+    bool LiveRegisters[ 16 ];
+    bool ReadRegisters[ 16 ];
+    bool WrittenRegisters[ 16 ];
+    
+    for( int r = 0; r < 16; r++ )
+      LiveRegisters[ r ] = true;
+    
+    for( int i = Block.EndLine - 1; i >= Block.FirstLine; i-- )
+    {
+        OptimizedLine& Line = Lines[ i ];
+        
+        if( Line.Removed || Line.Type == AssemblyLineTypes::NonCode )
+          continue;
+        
+        // only plain moves are removed, since other instructions
+        // may have side effects (reading an invalid address, etc)
+        if( Line.Type == AssemblyLineTypes::Move || Line.Type == AssemblyLineTypes::LoadAddress )
+          if( Line.Operands[ 0 ].Type == AssemblyOperandTypes::Register && Line.Operands[ 1 ].Type != AssemblyOperandTypes::OtherMemory )
+          {
+              int Register = Line.Operands[ 0 ].RegisterNumber;
+              
+              if( Register < 14 && !LiveRegisters[ Register ] )
+              {
+                  RemoveLine( Line, "value is never read" );
+                  Changed = true;
+                  continue;
+              }
+          }
+        
+        GetRegisterUsage( Line, ReadRegisters, WrittenRegisters );
+        
+        for( int r = 0; r < 16; r++ )
+        {
+            if( WrittenRegisters[ r ] ) LiveRegisters[ r ] = false;
+            if( ReadRegisters[ r ] ) LiveRegisters[ r ] = true;
+        }
+    }
+    
+    return Changed;
+}
+
+// -----------------------------------------------------------------------------
+
+// backwards analysis within the block: a store to a named
+// memory position is dead when that same position is
+// overwritten later in the block, without being read before
+bool VirconCOptimizer::RemoveDeadMemoryStores( BasicBlock& Block )
+{
+    bool Changed = false;
+    set< string > OverwrittenAddresses;
+    
+    for( int i = Block.EndLine - 1; i >= Block.FirstLine; i-- )
+    {
+        OptimizedLine& Line = Lines[ i ];
+        
+        if( Line.Removed )
+          continue;
+        
+        switch( Line.Type )
+        {
+            case AssemblyLineTypes::NonCode:
+            case AssemblyLineTypes::Wait:
+            case AssemblyLineTypes::Push:
+                break;
+            
+            case AssemblyLineTypes::Move:
+            {
+                AssemblyOperand& Destination = Line.Operands[ 0 ];
+                AssemblyOperand& Source = Line.Operands[ 1 ];
+                
+                // stores to memory
+                if( Destination.Type == AssemblyOperandTypes::LocalMemory || Destination.Type == AssemblyOperandTypes::GlobalMemory )
+                {
+                    if( OverwrittenAddresses.count( Destination.Text ) )
+                    {
+                        RemoveLine( Line, "memory is overwritten before being read" );
+                        Changed = true;
+                    }
+                    
+                    else
+                      OverwrittenAddresses.insert( Destination.Text );
+                }
+                
+                // reads from memory
+                else if( Source.Type == AssemblyOperandTypes::LocalMemory || Source.Type == AssemblyOperandTypes::GlobalMemory )
+                  OverwrittenAddresses.erase( Source.Text );
+                
+                else if( Source.Type == AssemblyOperandTypes::OtherMemory )
+                  OverwrittenAddresses.clear();
+                
+                // changes to BP
+                if( WritesRegister( Line, 14 ) )
+                  OverwrittenAddresses.clear();
+                
+                break;
+            }
+            
+            case AssemblyLineTypes::LoadAddress:
+            case AssemblyLineTypes::IntegerOperation:
+            case AssemblyLineTypes::FloatOperation:
+            case AssemblyLineTypes::RegisterOperation:
+            case AssemblyLineTypes::UnaryOperation:
+            case AssemblyLineTypes::PortInput:
+            case AssemblyLineTypes::PortOutput:
+                if( WritesRegister( Line, 14 ) )
+                  OverwrittenAddresses.clear();
+                
+                break;
+            
+            // pop reads from the stack, and any
+            // other line may read from anywhere
+            default:
+                OverwrittenAddresses.clear();
+                break;
+        }
+    }
+    
+    return Changed;
+}
+
+
+// =============================================================================
+//      VIRCON C OPTIMIZER: MAIN OPTIMIZATION FUNCTION
+// =============================================================================
+
+
+void VirconCOptimizer::Optimize( VirconCEmitter& Emitter )
+{
+    if( VerboseMode )
+      cout << "optimizing program" << endl;
+    
+    // parse all program lines
+    Lines.clear();
+    RewrittenLines = 0;
+    RemovedLines = 0;
+    
+    for( string& Text: Emitter.ProgramLines )
+    {
+        OptimizedLine NewLine;
+        NewLine.Text = Text;
+        NewLine.OriginalText = Text;
+        NewLine.Removed = false;
+        ParseLine( NewLine );
+        Lines.push_back( NewLine );
+    }
+    
+    FindBasicBlocks();
+    
+    // each pass can enable further optimizations
+    // for the others, so run them a few times
+    const int MaximumIterations = 3;
+    
+    for( int Iteration = 0; Iteration < MaximumIterations; Iteration++ )
+    {
+        bool Changed = false;
+        
+        for( BasicBlock& Block: Blocks )
+        {
+            if( PropagateConstants || PropagateCopies || EliminateCommonSubexpressions )
+              Changed |= PropagateValues( Block );
+            
+            if( RemoveDeadCode )
+              Changed |= RemoveDeadRegisterWrites( Block );
+            
+            if( RemoveDeadStores )
+              Changed |= RemoveDeadMemoryStores( Block );
+        }
+        
+        if( !Changed )
+          break;
+    }
+    
+    // rebuild the program, keeping track of
+    // the new position for each original line
+    vector< int > NewLinePositions;
+    Emitter.ProgramLines.clear();
+    
+    for( OptimizedLine& Line: Lines )
+    {
+        NewLinePositions.push_back( Emitter.ProgramLines.size() );
+        
+        if( !Line.Removed )
+          Emitter.ProgramLines.push_back( Line.Text );
+    }
+    
+    // line mappings use file lines, so they are
+    // offset by 2 with respect to the line index
+    // (see VirconCEmitter::AddDebugInfo)
+    map< int, CNode* > NewLineMapping;
+    
+    for( auto& MapPair: Emitter.LineMapping )
+    {
+        int OldPosition = MapPair.first - 2;
+        int NewPosition = Emitter.ProgramLines.size();
+        
+        if( OldPosition < (int)NewLinePositions.size() )
+          NewPosition = NewLinePositions[ OldPosition ];
+        
+        // when several lines collapse keep the first
+        if( !NewLineMapping.count( NewPosition + 2 ) )
+          NewLineMapping[ NewPosition + 2 ] = MapPair.second;
+    }
+    
+    Emitter.LineMapping = NewLineMapping;
+    
+    if( VerboseMode )
+      cout << "optimizer removed " << RemovedLines << " lines and rewrote " << RewrittenLines << endl;
+}
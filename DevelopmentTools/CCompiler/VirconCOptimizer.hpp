@@ -0,0 +1,169 @@
+// *****************************************************************************
+    // start include guard
+    #ifndef VIRCONCOPTIMIZER_HPP
+    #define VIRCONCOPTIMIZER_HPP
+    
+    // include project headers
+    #include "VirconCEmitter.hpp"
+    
+    // include C/C++ headers
+    #include <string>           // [ C++ STL ] Strings
+    #include <vector>           // [ C++ STL ] Vectors
+    #include <map>              // [ C++ STL ] Maps
+// *****************************************************************************
+
+
+// =============================================================================
+//      AUXILIARY DEFINITIONS
+// =============================================================================
+
+
+enum class AssemblyOperandTypes
+{
+    Register,
+    Immediate,
+    LocalMemory,        // [BP], [BP+n], [BP-n]
+    GlobalMemory,       // [global_name]
+    OtherMemory         // indirect or numeric addresses
+};
+
+// -----------------------------------------------------------------------------
+
+class AssemblyOperand
+{
+    public:
+        
+        AssemblyOperandTypes Type;
+        std::string Text;           // for memory: the address within brackets
+        int RegisterNumber;         // only for registers
+};
+
+// -----------------------------------------------------------------------------
+
+// classification of instructions by the way they use their operands
+enum class AssemblyLineTypes
+{
+    NonCode,            // empty lines and comments
+    Label,              // starts a new basic block
+    BlockEnd,           // jumps, calls, returns and halts
+    Move,               // mov
+    LoadAddress,        // lea
+    IntegerOperation,   // 2 operands: reads both, writes the first (integer immediates)
+    FloatOperation,     // 2 operands: reads both, writes the first (float immediates)
+    RegisterOperation,  // 2 registers: reads both, writes the first
+    UnaryOperation,     // 1 register: reads and writes it
+    Push,
+    Pop,
+    PortInput,
+    PortOutput,
+    Wait,
+    Barrier             // anything else: may read or write anything
+};
+
+// -----------------------------------------------------------------------------
+
+// one line of the program section, as seen by the optimizer
+class OptimizedLine
+{
+    public:
+        
+        std::string Text;
+        std::string OriginalText;
+        AssemblyLineTypes Type;
+        std::string Mnemonic;
+        std::vector< AssemblyOperand > Operands;
+        
+        // optimization results
+        bool Removed;
+        std::string Note;
+};
+
+// -----------------------------------------------------------------------------
+
+// a basic block is the range of lines [FirstLine, EndLine)
+class BasicBlock
+{
+    public:
+        
+        int FirstLine;
+        int EndLine;
+};
+
+
+// =============================================================================
+//      VIRCON C OPTIMIZER
+// =============================================================================
+
+
+// The optimizer works on the assembly produced by the emitter,
+// which is already a 2-address code over CPU instructions. It
+// splits the program into basic blocks and runs local passes on
+// each of them, that can be individually enabled or disabled:
+// - constant propagation into register operands
+// - copy propagation (redundant moves via value numbering)
+// - common subexpression elimination (repeated operations
+//   on the same values reuse a register that holds the result)
+// - removal of dead writes to registers
+// - removal of dead stores to named memory positions
+
+class VirconCOptimizer
+{
+    public:
+        
+        // program being optimized
+        std::vector< OptimizedLine > Lines;
+        std::vector< BasicBlock > Blocks;
+        
+        // statistics
+        int RewrittenLines;
+        int RemovedLines;
+        
+    protected:
+        
+        // value numbering state within a block
+        int RegisterValues[ 16 ];
+        std::map< std::string, int > MemoryValues;
+        std::map< std::string, int > ImmediateValues;
+        std::map< int, std::string > ValueConstants;
+        std::map< std::string, int > ExpressionValues;
+        int NextValue;
+        
+        // parsing of assembly lines
+        void ParseLine( OptimizedLine& Line );
+        AssemblyOperand ParseOperand( const std::string& Text );
+        void FindBasicBlocks();
+        
+        // helpers for value numbering
+        void ForgetAllValues();
+        void ForgetMemoryValues( AssemblyOperandTypes StoredType, const std::string& Address );
+        int GetOperandValue( const AssemblyOperand& Operand );
+        int GetExpressionValue( const OptimizedLine& Line );
+        bool ReuseComputedValue( OptimizedLine& Line, int Value );
+        
+        // helpers for liveness
+        void GetRegisterUsage( const OptimizedLine& Line, bool* ReadRegisters, bool* WrittenRegisters );
+        
+        // optimization passes for a single block
+        bool PropagateValues( BasicBlock& Block );
+        bool RemoveDeadRegisterWrites( BasicBlock& Block );
+        bool RemoveDeadMemoryStores( BasicBlock& Block );
+        
+        // modification of lines
+        void RemoveLine( OptimizedLine& Line, const std::string& Reason );
+        void RewriteLine( OptimizedLine& Line, const std::string& NewText );
+        
+    public:
+        
+        // instance handling
+        VirconCOptimizer();
+        ~VirconCOptimizer();
+        
+        // main optimization function
+        void Optimize( VirconCEmitter& Emitter );
+};
+
+
+// *****************************************************************************
+    // end include guard
+    #endif
+// *****************************************************************************
@@ -5,6 +5,7 @@
     // include project headers
     #include "VirconCPreprocessor.hpp"
     #include "VirconCLexer.hpp"
+    #include "HeaderCache.hpp"
     #include "CompilerInfrastructure.hpp"
     #include "Globals.hpp"
     
@@ -21,14 +22,19 @@
 ProcessingContext::ProcessingContext()
 {
     LinePosition = SourceLines.begin();
+    IsRecorded = false;
+    CacheKey = 0;
+    FirstRecordedToken = 0;
+    PreviousErrors = 0;
+    PreviousWarnings = 0;
 }
 
 // -----------------------------------------------------------------------------
 
 ProcessingContext::~ProcessingContext()
 {
-    // delete all cloned tokens
-    for( CTokenList Line: SourceLines )
+    // delete all tokens not moved to the output
+    for( CTokenList& Line: SourceLines )
       for( CToken* T: Line )
         delete T;
 }
@@ -109,19 +115,14 @@ void VirconCPreprocessor::PushContext( VirconCLexer& Lexer )
     
     // this is safe since there are always start/end tokens
     CTokenList& FirstLine = Lexer.TokenLines.front();
-    NewContext.FilePath = FirstLine.front()->Location.FilePath;
+    NewContext.FilePath = *FirstLine.front()->Location.FilePath;
     
-    // clone all lexer lines into the current context
-    for( CTokenList Line: Lexer.TokenLines )
-    {
-        // insert a new empty line after the last one
-        NewContext.SourceLines.emplace_back();
-        CTokenList& ClonedList = NewContext.SourceLines.back();
-        
-        // clone all tokens into the new line
-        for( CToken* T: Line )
-          ClonedList.push_back( T->Clone() );
-    }
+    // move all lexer lines into the current context
+    // (tokens are not copied, they are just relinked)
+    for( CTokenList& Line: Lexer.TokenLines )
+      NewContext.SourceLines.emplace_back( move( Line ) );
+    
+    Lexer.TokenLines.clear();
     
     // finally initialize iteration
     NewContext.LinePosition = NewContext.SourceLines.begin();
@@ -131,23 +132,54 @@ void VirconCPreprocessor::PushContext( VirconCLexer& Lexer )
 
 void VirconCPreprocessor::PushContext( SourceLocation Location, const std::string& FilePath )
 {
-    // first, look for the file in the current reference directory
-    string PathToInclude = ContextStack.back().ReferenceFolder + PathSeparator + FilePath;
-    
-    // if not found, then look in the compiler's include directory
-    if( !FileExists( PathToInclude ) )
-      PathToInclude = CompilerFolder + "include" + PathSeparator + FilePath;
+    // look for the file in the current reference
+    // directory, then in the compiler's include directory
+    string ReferenceFolder = ContextStack.back().ReferenceFolder;
+    string PathToInclude = FindIncludeFile( ReferenceFolder, FilePath );
     
-    // if not found either, report the error
-    if( !FileExists( PathToInclude ) )
+    // if not found, report the error
+    if( PathToInclude.empty() )
       RaiseFatalError( Location, "cannot open include file \"" + FilePath + "\"" );
     
+    // when possible reuse the results of previous runs
+    uint64_t CacheKey = 0;
+    
+    if( !CacheFolder.empty() )
+    {
+        HeaderDependency Dependency;
+        Dependency.ReferenceFolder = ReferenceFolder;
+        Dependency.FilePath = FilePath;
+        Dependency.ResolvedPath = PathToInclude;
+        
+        if( !HashFileContents( PathToInclude, Dependency.ContentsHash ) )
+          RaiseFatalError( Location, "cannot read include file \"" + FilePath + "\"" );
+        
+        AddDependency( Dependency );
+        CacheKey = GetHeaderCacheKey( PathToInclude, Dependency.ContentsHash, Definitions );
+        
+        if( LoadFromHeaderCache( CacheKey, PathToInclude ) )
+          return;
+    }
+    
     // tokenize the whole file
     VirconCLexer Lexer;
+    int PreviousErrors = CompilationErrors;
+    int PreviousWarnings = CompilationWarnings;
     Lexer.TokenizeFile( PathToInclude );
     
     // now call the other version of this function
     PushContext( Lexer );
+    
+    // keep track of the results to save them later
+    if( !CacheFolder.empty() )
+    {
+        ProcessingContext& NewContext = ContextStack.back();
+        NewContext.IsRecorded = true;
+        NewContext.CacheKey = CacheKey;
+        NewContext.FirstRecordedToken = ProcessedTokens.size();
+        NewContext.PreviousErrors = PreviousErrors;
+        NewContext.PreviousWarnings = PreviousWarnings;
+    }
 }
 
 // -----------------------------------------------------------------------------
@@ -157,11 +189,63 @@ void VirconCPreprocessor::PopContext()
     if( ContextStack.empty() )
       return;
     
-    // cloned token lines are deleted by the destructor
+    // remaining token lines are deleted by the destructor
     ContextStack.pop_back();
 }
 
 
+// =============================================================================
+//      VIRCON C PREPROCESSOR: USE OF THE HEADER CACHE
+// =============================================================================
+
+
+// every file being recorded depends on all
+// files that get included while processing it
+void VirconCPreprocessor::AddDependency( const HeaderDependency& Dependency )
+{
+    for( ProcessingContext& Context: ContextStack )
+      if( Context.IsRecorded )
+        Context.Dependencies.push_back( Dependency );
+}
+
+// -----------------------------------------------------------------------------
+
+// a cached file is not processed: its results are
+// added to the output and the definitions it leaves
+// replace the current ones (that were part of the key)
+bool VirconCPreprocessor::LoadFromHeaderCache( uint64_t Key, const string& HeaderPath )
+{
+    CachedHeader Header;
+    
+    if( !LoadCachedHeader( Key, HeaderPath, Header ) )
+      return false;
+    
+    for( HeaderDependency& Dependency: Header.Dependencies )
+      AddDependency( Dependency );
+    
+    ProcessedTokens.splice( ProcessedTokens.end(), Header.ProcessedTokens );
+    
+    // the previous definitions are deleted with the header
+    Definitions.swap( Header.Definitions );
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+
+// only files with no issues are saved, since
+// reusing them later will not report anything
+void VirconCPreprocessor::SaveToHeaderCache( ProcessingContext& Context )
+{
+    if( CompilationErrors != Context.PreviousErrors || CompilationWarnings != Context.PreviousWarnings )
+      return;
+    
+    CTokenIterator FirstToken = ProcessedTokens.begin();
+    advance( FirstToken, Context.FirstRecordedToken );
+    
+    SaveCachedHeader( Context.CacheKey, Context.FilePath, Context.Dependencies, FirstToken, ProcessedTokens.end(), Definitions );
+}
+
+
 // =============================================================================
 //      VIRCON C PREPROCESSOR: INSERTION FUNCTIONS
 // =============================================================================
@@ -202,6 +286,7 @@ bool VirconCPreprocessor::ReplaceDefinitions( CTokenList& Line )
         CTokenList& ValueTokens = Pair->second;
         
         // (1) remove the identifier (not needed anymore)
+        delete NextToken;
         Position = Line.erase( Position );
         
         // (2) The definition value can be composed of several tokens.
@@ -215,7 +300,7 @@ bool VirconCPreprocessor::ReplaceDefinitions( CTokenList& Line )
             ClonedToken->Location = OriginalLocation;
             
             // now insert it
-            Position = ProcessedTokens.insert( Position, ClonedToken );
+            Position = Line.insert( Position, ClonedToken );
             Position++;
         }
     }
@@ -279,9 +364,9 @@ void VirconCPreprocessor::ProcessLine()
                   RaiseFatalError( Line.front()->Location, "definition replacement is too deep (possible circular reference)" );
             }
             
-            // now copy the replaced line to the output
-            for( CToken* T: Line )
-              ProcessedTokens.push_back( T->Clone() );
+            // now move the replaced line to the output
+            // (this line will not be processed again)
+            ProcessedTokens.splice( ProcessedTokens.end(), Line );
         }
         
         return;
@@ -627,6 +712,9 @@ void VirconCPreprocessor::Preprocess( VirconCLexer& Lexer )
             ContextBeingProcessed.Advance();
         }
         
+        if( ContextStack.back().IsRecorded )
+          SaveToHeaderCache( ContextStack.back() );
+        
         PopContext();
     }
     
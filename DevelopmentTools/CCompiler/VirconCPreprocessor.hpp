@@ -6,6 +6,7 @@
     // include project headers
     #include "CTokens.hpp"
     #include "VirconCLexer.hpp"
+    #include "HeaderCache.hpp"
     
     // include C/C++ headers
     #include <map>          // [ C++ STL ] Maps
@@ -47,12 +48,20 @@ class ProcessingContext
         std::string ReferenceFolder;
         
         // parsing progress within lexer lines
-        std::list< CTokenList > SourceLines;   // copies so that nested lexers can be destroyed
+        std::list< CTokenList > SourceLines;   // taken from lexers, so that they can be destroyed
         std::list< CTokenList >::iterator LinePosition;
         
         // nested "if" contexts
         std::list< IfContext > IfStack;
         
+        // included files whose results will be saved to the cache
+        bool IsRecorded;
+        uint64_t CacheKey;
+        size_t FirstRecordedToken;
+        int PreviousErrors;
+        int PreviousWarnings;
+        std::vector< HeaderDependency > Dependencies;
+        
     public:
         
         // instance handling
@@ -80,8 +89,8 @@ class VirconCPreprocessor
         
     public:
         
-        // resulting tokens (all tokens are actually
-        // a copy to account for modified locations)
+        // resulting tokens (taken from the lexer lines,
+        // and copies for replaced definition values)
         CTokenList ProcessedTokens;
         
     protected:
@@ -91,6 +100,11 @@ class VirconCPreprocessor
         void PushContext( SourceLocation Location, const std::string& FilePath );
         void PopContext();
         
+        // use of the header cache
+        void AddDependency( const HeaderDependency& Dependency );
+        bool LoadFromHeaderCache( uint64_t Key, const std::string& HeaderPath );
+        void SaveToHeaderCache( ProcessingContext& Context );
+        
         // insertion functions
         bool ReplaceDefinitions( CTokenList& Line );
         void IncludeFile( SourceLocation Location, const std::string& FilePath );
@@ -118,6 +132,7 @@ class VirconCPreprocessor
        ~VirconCPreprocessor();
         
         // main processing function
+        // (tokens are taken from the lexer)
         void Preprocess( VirconCLexer& Lexer );
 };
 
@@ -7,6 +7,7 @@
     #include <iomanip>      // [ C++ STL ] I/O Manipulation
     #include <iostream>     // [ C++ STL ] I/O Streams
     #include <map>          // [ C++ STL ] Maps
+    #include <unordered_map>    // [ C++ STL ] Unordered maps
     #include <stdexcept>    // [ C++ STL ] Exceptions
     
     // declare used namespaces
@@ -365,101 +366,119 @@ string SPUChannelStateToString( IOPortValues PortValue )
 
 
 // =============================================================================
-//      CONVERSIONS STRING --> ENUM
+//      STRING --> ENUM MAPS
 // =============================================================================
 
 
-bool IsOpCodeName( std::string Word )
+// names are matched regardless of case, so inverse
+// maps use uppercase names; when several values share
+// a name the first one is kept, as in a linear search
+template< typename EnumType >
+unordered_map< string, EnumType > InvertNamesMap( const map< EnumType, string >& NamesMap )
 {
-    // allow lowercase too
-    string WordUpper = Word;
-    for( char& c : WordUpper ) c = toupper( c );
+    unordered_map< string, EnumType > Inverse;
     
-    // search in the map
-    for( auto MapPair : OpCodeNames )
-      if( MapPair.second == WordUpper )
-        return true;
+    for( auto& MapPair: NamesMap )
+      Inverse.emplace( ToUpperCase( MapPair.second ), MapPair.first );
     
-    return false;
+    return Inverse;
 }
 
 // -----------------------------------------------------------------------------
 
-bool IsRegisterName( std::string Word )
+// these are created on first use, so that the
+// direct maps are always initialized before
+const unordered_map< string, InstructionOpCodes >& OpCodesByName()
 {
-    // allow lowercase too
-    string WordUpper = Word;
-    for( char& c : WordUpper ) c = toupper( c );
-    
-    // search in the map
-    for( auto MapPair : RegisterNames )
-      if( MapPair.second == WordUpper )
-        return true;
+    static const unordered_map< string, InstructionOpCodes > Inverse = InvertNamesMap( OpCodeNames );
+    return Inverse;
+}
+
+// -----------------------------------------------------------------------------
+
+unordered_map< string, CPURegisters > CreateRegistersByName()
+{
+    unordered_map< string, CPURegisters > Inverse = InvertNamesMap( RegisterNames );
     
     // account for register aliases
-    if( WordUpper == "R11" ) return true;
-    if( WordUpper == "R12" ) return true;
-    if( WordUpper == "R13" ) return true;
-    if( WordUpper == "R14" ) return true;
-    if( WordUpper == "R15" ) return true;
+    Inverse.emplace( "R11", CPURegisters::CountRegister );
+    Inverse.emplace( "R12", CPURegisters::SourceRegister );
+    Inverse.emplace( "R13", CPURegisters::DestinationRegister );
+    Inverse.emplace( "R14", CPURegisters::BasePointer );
+    Inverse.emplace( "R15", CPURegisters::StackPointer );
     
-    return false;
+    return Inverse;
+}
+
+// -----------------------------------------------------------------------------
+
+const unordered_map< string, CPURegisters >& RegistersByName()
+{
+    static const unordered_map< string, CPURegisters > Inverse = CreateRegistersByName();
+    return Inverse;
 }
 
 // -----------------------------------------------------------------------------
 
-bool IsPortName( std::string Word )
+const unordered_map< string, IOPorts >& PortsByName()
+{
+    static const unordered_map< string, IOPorts > Inverse = InvertNamesMap( PortNames );
+    return Inverse;
+}
+
+// -----------------------------------------------------------------------------
+
+const unordered_map< string, IOPortValues >& PortValuesByName()
+{
+    static const unordered_map< string, IOPortValues > Inverse = InvertNamesMap( PortValueNames );
+    return Inverse;
+}
+
+
+// =============================================================================
+//      CONVERSIONS STRING --> ENUM
+// =============================================================================
+
+
+bool IsOpCodeName( const std::string& Word )
 {
     // allow lowercase too
-    string WordUpper = Word;
-    for( char& c : WordUpper ) c = toupper( c );
-    
-    // search in the map
-    for( auto MapPair : PortNames )
-    {
-        string PortUpper = MapPair.second;
-        for( char& c : PortUpper ) c = toupper( c );
-        
-        if( PortUpper == WordUpper )
-          return true;
-    }
-    
-    return false;
+    return OpCodesByName().count( ToUpperCase( Word ) ) > 0;
 }
 
 // -----------------------------------------------------------------------------
 
-bool IsPortValueName( std::string Word )
+bool IsRegisterName( const std::string& Word )
 {
     // allow lowercase too
-    string WordUpper = Word;
-    for( char& c : WordUpper ) c = toupper( c );
-    
-    // search in the map
-    for( auto MapPair : PortValueNames )
-    {
-        string PortValueUpper = MapPair.second;
-        for( char& c : PortValueUpper ) c = toupper( c );
-        
-        if( PortValueUpper == WordUpper )
-          return true;
-    }
-    
-    return false;
+    return RegistersByName().count( ToUpperCase( Word ) ) > 0;
+}
+
+// -----------------------------------------------------------------------------
+
+bool IsPortName( const std::string& Word )
+{
+    // allow lowercase too
+    return PortsByName().count( ToUpperCase( Word ) ) > 0;
 }
 
 // -----------------------------------------------------------------------------
 
-InstructionOpCodes StringToOpCode( string& Word )
+bool IsPortValueName( const std::string& Word )
 {
     // allow lowercase too
-    string NameUpper = Word;
-    for( char& c : NameUpper ) c = toupper( c );
+    return PortValuesByName().count( ToUpperCase( Word ) ) > 0;
+}
+
+// -----------------------------------------------------------------------------
+
+InstructionOpCodes StringToOpCode( const string& Word )
+{
+    // allow lowercase too
+    auto MapPair = OpCodesByName().find( ToUpperCase( Word ) );
     
-    // now search in the map
-    for( auto MapPair : OpCodeNames )
-      if( MapPair.second == NameUpper )
-        return MapPair.first;
+    if( MapPair != OpCodesByName().end() )
+      return MapPair->second;
     
     // not found
     throw runtime_error( "String cannot be converted to an instruction opcode" );
@@ -467,23 +486,13 @@ InstructionOpCodes StringToOpCode( string& Word )
 
 // -----------------------------------------------------------------------------
 
-CPURegisters StringToRegister( string& Word )
+CPURegisters StringToRegister( const string& Word )
 {
     // allow lowercase too
-    string NameUpper = Word;
-    for( char& c : NameUpper ) c = toupper( c );
+    auto MapPair = RegistersByName().find( ToUpperCase( Word ) );
     
-    // now search in the map
-    for( auto MapPair : RegisterNames )
-      if( MapPair.second == NameUpper )
-        return MapPair.first;
-    
-    // account for register aliases
-    if( NameUpper == "R11" )  return CPURegisters::CountRegister;
-    if( NameUpper == "R12" )  return CPURegisters::SourceRegister;
-    if( NameUpper == "R13" )  return CPURegisters::DestinationRegister;
-    if( NameUpper == "R14" )  return CPURegisters::BasePointer;
-    if( NameUpper == "R15" )  return CPURegisters::StackPointer;
+    if( MapPair != RegistersByName().end() )
+      return MapPair->second;
     
     // not found
     throw runtime_error( "String cannot be converted to a CPU register" );
@@ -491,21 +500,13 @@ CPURegisters StringToRegister( string& Word )
 
 // -----------------------------------------------------------------------------
 
-IOPorts StringToPort( string& Word )
+IOPorts StringToPort( const string& Word )
 {
     // allow lowercase too
-    string NameUpper = Word;
-    for( char& c : NameUpper ) c = toupper( c );
+    auto MapPair = PortsByName().find( ToUpperCase( Word ) );
     
-    // now search in the map
-    for( auto MapPair : PortNames )
-    {
-        string PortUpper = MapPair.second;
-        for( char& c : PortUpper ) c = toupper( c );
-        
-        if( PortUpper == NameUpper )
-          return MapPair.first;
-    }
+    if( MapPair != PortsByName().end() )
+      return MapPair->second;
     
     // not found
     throw runtime_error( "String cannot be converted to an I/O port" );
@@ -513,21 +514,13 @@ IOPorts StringToPort( string& Word )
 
 // -----------------------------------------------------------------------------
 
-IOPortValues StringToPortValue( string& Word )
+IOPortValues StringToPortValue( const string& Word )
 {
     // allow lowercase too
-    string NameUpper = Word;
-    for( char& c : NameUpper ) c = toupper( c );
+    auto MapPair = PortValuesByName().find( ToUpperCase( Word ) );
     
-    // now search in the map
-    for( auto MapPair : PortValueNames )
-    {
-        string PortValueUpper = MapPair.second;
-        for( char& c : PortValueUpper ) c = toupper( c );
-        
-        if( PortValueUpper == NameUpper )
-          return MapPair.first;
-    }
+    if( MapPair != PortValuesByName().end() )
+      return MapPair->second;
     
     // not found
     throw runtime_error( "String cannot be converted to an I/O port value" );
@@ -35,17 +35,17 @@ std::string SPUChannelStateToString( V32::IOPortValues PortValue );
 
 
 // detection of enum type from a string
-bool IsOpCodeName( std::string Word );
-bool IsRegisterName( std::string Word );
-bool IsPortName( std::string Word );
-bool IsPortValueName( std::string Word );
+bool IsOpCodeName( const std::string& Word );
+bool IsRegisterName( const std::string& Word );
+bool IsPortName( const std::string& Word );
+bool IsPortValueName( const std::string& Word );
 
 // actual conversion to enum values
 // (when not valid, a string with the hex number will be returned)
-V32::InstructionOpCodes StringToOpCode( std::string& Word );
-V32::CPURegisters StringToRegister( std::string& Word );
-V32::IOPorts StringToPort( std::string& Word );
-V32::IOPortValues StringToPortValue( std::string& Word );
+V32::InstructionOpCodes StringToOpCode( const std::string& Word );
+V32::CPURegisters StringToRegister( const std::string& Word );
+V32::IOPorts StringToPort( const std::string& Word );
+V32::IOPortValues StringToPortValue( const std::string& Word );
 
 
 // *****************************************************************************
@@ -194,6 +194,44 @@ bool DirectoryExists( const string& Path )
 }
 
 
+// =============================================================================
+//      FILE INFORMATION
+// =============================================================================
+
+
+// returns false if the file cannot be found;
+// times are given in seconds, as in the OS
+bool GetFileStatus( const string& FilePath, uint64_t& Size, int64_t& ModificationTime )
+{
+    #if defined(WINDOWS_OS)
+    
+      struct _stat Info;
+      wstring FilePathUTF16 = ToUTF16( FilePath );
+      
+      if( _wstat( FilePathUTF16.c_str(), &Info ) != 0 )
+        return false;
+      
+      if( Info.st_mode & _S_IFDIR )
+        return false;
+      
+    #else
+        
+      struct stat Info;
+      
+      if( stat( FilePath.c_str(), &Info ) != 0 )
+        return false;
+      
+      if( Info.st_mode & S_IFDIR )
+        return false;
+      
+    #endif
+    
+    Size = Info.st_size;
+    ModificationTime = Info.st_mtime;
+    return true;
+}
+
+
 // =============================================================================
 //      CREATING DIRECTORIES
 // =============================================================================
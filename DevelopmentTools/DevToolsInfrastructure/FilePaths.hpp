@@ -8,6 +8,7 @@
     #include <iostream>         // [ C++ STL ] I/O streams
     #include <fstream>          // [ C++ STL ] File streams
     #include <stdio.h>          // [ ANSI C ] Standard I/O
+    #include <cstdint>          // [ ANSI C ] Standard integer types
     
     // detection of Windows
     #if defined(__WIN32__) || defined(_WIN32) || defined(_WIN64)
@@ -38,6 +39,9 @@ bool IsFileNameValid( const std::string& FileName );
 bool FileExists( const std::string &FilePath );
 bool DirectoryExists( const std::string &Path );
 
+// file information
+bool GetFileStatus( const std::string& FilePath, uint64_t& Size, int64_t& ModificationTime );
+
 // creating directories
 bool CreateNewDirectory( const std::string& DirectoryPath );
 
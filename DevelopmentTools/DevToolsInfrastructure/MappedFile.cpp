@@ -0,0 +1,191 @@
+// *****************************************************************************
+    // include project headers
+    #include "MappedFile.hpp"
+    
+    // include OS headers for memory mapping
+    #if defined(WINDOWS_OS)
+      #include <windows.h>      // [ WINDOWS ] Main header
+    #else
+      #include <sys/mman.h>     // [ POSIX ] Memory mapping
+      #include <sys/stat.h>     // [ POSIX ] File status
+      #include <fcntl.h>        // [ POSIX ] File control
+      #include <unistd.h>       // [ POSIX ] Standard symbols
+    #endif
+    
+    // declare used namespaces
+    using namespace std;
+// *****************************************************************************
+
+
+// =============================================================================
+//      MAPPED FILE: INSTANCE HANDLING
+// =============================================================================
+
+
+// empty files can't be mapped, but are still valid
+static const uint8_t EmptyFileData[ 1 ] = { 0 };
+
+// -----------------------------------------------------------------------------
+
+MappedFile::MappedFile()
+{
+    #if defined(WINDOWS_OS)
+      FileHandle = INVALID_HANDLE_VALUE;
+      MappingHandle = NULL;
+    #endif
+    
+    Data = nullptr;
+    Size = 0;
+}
+
+// -----------------------------------------------------------------------------
+
+MappedFile::~MappedFile()
+{
+    Close();
+}
+
+
+// =============================================================================
+//      MAPPED FILE: FILE HANDLING
+// =============================================================================
+
+
+bool MappedFile::Open( const string& FilePathUTF8 )
+{
+    Close();
+    
+    #if defined(WINDOWS_OS)
+      
+      wstring FilePathUTF16 = ToUTF16( FilePathUTF8 );
+      FileHandle = CreateFileW( FilePathUTF16.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL );
+      
+      if( FileHandle == INVALID_HANDLE_VALUE )
+        return false;
+      
+      LARGE_INTEGER FileSize;
+      
+      if( !GetFileSizeEx( FileHandle, &FileSize ) )
+      {
+          Close();
+          return false;
+      }
+      
+      Size = FileSize.QuadPart;
+      
+      if( Size == 0 )
+      {
+          Data = EmptyFileData;
+          return true;
+      }
+      
+      MappingHandle = CreateFileMappingW( FileHandle, NULL, PAGE_READONLY, 0, 0, NULL );
+      
+      if( !MappingHandle )
+      {
+          Close();
+          return false;
+      }
+      
+      Data = (const uint8_t*)MapViewOfFile( MappingHandle, FILE_MAP_READ, 0, 0, 0 );
+    
+    #else
+      
+      int FileDescriptor = open( FilePathUTF8.c_str(), O_RDONLY );
+      
+      if( FileDescriptor < 0 )
+        return false;
+      
+      struct stat Info;
+      
+      if( fstat( FileDescriptor, &Info ) != 0 || !S_ISREG( Info.st_mode ) )
+      {
+          close( FileDescriptor );
+          return false;
+      }
+      
+      Size = Info.st_size;
+      
+      if( Size == 0 )
+      {
+          close( FileDescriptor );
+          Data = EmptyFileData;
+          return true;
+      }
+      
+      // the mapping stays valid after closing the file
+      void* Mapping = mmap( nullptr, Size, PROT_READ, MAP_PRIVATE, FileDescriptor, 0 );
+      close( FileDescriptor );
+      
+      if( Mapping != MAP_FAILED )
+      {
+          // contents are mostly read in order
+          madvise( Mapping, Size, MADV_SEQUENTIAL );
+          Data = (const uint8_t*)Mapping;
+      }
+    
+    #endif
+    
+    if( !Data )
+    {
+        Close();
+        return false;
+    }
+    
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+
+void MappedFile::Close()
+{
+    #if defined(WINDOWS_OS)
+      
+      if( Data && Data != EmptyFileData )
+        UnmapViewOfFile( Data );
+      
+      if( MappingHandle )
+        CloseHandle( MappingHandle );
+      
+      if( FileHandle != INVALID_HANDLE_VALUE )
+        CloseHandle( FileHandle );
+      
+      FileHandle = INVALID_HANDLE_VALUE;
+      MappingHandle = NULL;
+    
+    #else
+      
+      if( Data && Data != EmptyFileData )
+        munmap( (void*)Data, Size );
+    
+    #endif
+    
+    Data = nullptr;
+    Size = 0;
+}
+
+// -----------------------------------------------------------------------------
+
+void MappedFile::Release( const uint8_t* Start, uint64_t Length )
+{
+    if( !Data || Data == EmptyFileData )
+      return;
+    
+    #if defined(WINDOWS_OS)
+      
+      // unlocking pages that are not locked just
+      // removes them from this process working set
+      VirtualUnlock( (void*)Start, Length );
+    
+    #else
+      
+      // only whole pages inside the region can be released
+      uintptr_t PageSize = sysconf( _SC_PAGESIZE );
+      uintptr_t First = ((uintptr_t)Start + PageSize - 1) & ~(PageSize - 1);
+      uintptr_t End = ((uintptr_t)Start + Length) & ~(PageSize - 1);
+      
+      if( End > First )
+        madvise( (void*)First, End - First, MADV_DONTNEED );
+    
+    #endif
+}
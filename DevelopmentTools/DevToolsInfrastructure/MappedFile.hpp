@@ -0,0 +1,59 @@
+// *****************************************************************************
+    // start include guard
+    #ifndef MAPPEDFILE_HPP
+    #define MAPPEDFILE_HPP
+    
+    // include project headers
+    #include "FilePaths.hpp"
+    
+    // include C/C++ headers
+    #include <string>           // [ C++ STL ] Strings
+    #include <cstdint>          // [ ANSI C ] Standard integer types
+    #include <cstddef>          // [ ANSI C ] Standard definitions
+// *****************************************************************************
+
+
+// =============================================================================
+//      READ-ONLY MEMORY MAPPED FILES
+// =============================================================================
+
+
+// Gives direct access to the contents of a file without
+// reading it into allocated memory. The OS loads its pages
+// on demand and can drop them at any time, so files much
+// larger than the available memory can still be used.
+class MappedFile
+{
+    protected:
+        
+        #if defined(WINDOWS_OS)
+          void* FileHandle;
+          void* MappingHandle;
+        #endif
+        
+    public:
+        
+        // file contents (null when not open)
+        const uint8_t* Data;
+        uint64_t Size;
+        
+    public:
+        
+        // instance handling
+        MappedFile();
+       ~MappedFile();
+        
+        // returns false if the file could not be mapped
+        bool Open( const std::string& FilePathUTF8 );
+        void Close();
+        
+        // tells the OS that a region will not be used again,
+        // so its pages don't need to stay in this process
+        void Release( const uint8_t* Start, uint64_t Length );
+};
+
+
+// *****************************************************************************
+    // end include guard
+    #endif
+// *****************************************************************************
@@ -0,0 +1,119 @@
+// *****************************************************************************
+    // include project headers
+    #include "MemoryPools.hpp"
+    
+    // include C/C++ headers
+    #include <new>              // [ C++ STL ] Memory allocation
+    
+    // declare used namespaces
+    using namespace std;
+// *****************************************************************************
+
+
+// =============================================================================
+//      POOL PARAMETERS
+// =============================================================================
+
+
+// sizes are rounded up to keep all objects aligned
+const size_t PoolGranularity = 16;
+
+// larger objects are rare, so they are not pooled
+const size_t MaximumPooledSize = 1024;
+
+// size of each block requested from the system
+const size_t PoolBlockSize = 1024 * 1024;
+
+
+// =============================================================================
+//      MEMORY POOL CLASS
+// =============================================================================
+
+
+MemoryPool::MemoryPool()
+:   ReleasedObjects( MaximumPooledSize / PoolGranularity + 1, nullptr )
+{
+    NextFreeByte = nullptr;
+    RemainingBytes = 0;
+}
+
+// -----------------------------------------------------------------------------
+
+MemoryPool::~MemoryPool()
+{
+    for( char* Block: Blocks )
+      delete[] Block;
+}
+
+// -----------------------------------------------------------------------------
+
+void* MemoryPool::Allocate( size_t Size )
+{
+    if( Size > MaximumPooledSize )
+      return ::operator new( Size );
+    
+    size_t SizeClass = (Size + PoolGranularity - 1) / PoolGranularity;
+    size_t RoundedSize = SizeClass * PoolGranularity;
+    
+    // first try to reuse a released object
+    void* Object = ReleasedObjects[ SizeClass ];
+    
+    if( Object )
+    {
+        ReleasedObjects[ SizeClass ] = *(void**)Object;
+        return Object;
+    }
+    
+    // otherwise take it from the last block
+    if( RemainingBytes < RoundedSize )
+    {
+        Blocks.push_back( new char[ PoolBlockSize ] );
+        NextFreeByte = Blocks.back();
+        RemainingBytes = PoolBlockSize;
+    }
+    
+    Object = NextFreeByte;
+    NextFreeByte += RoundedSize;
+    RemainingBytes -= RoundedSize;
+    return Object;
+}
+
+// -----------------------------------------------------------------------------
+
+void MemoryPool::Release( void* Object, size_t Size )
+{
+    if( !Object )
+      return;
+    
+    if( Size > MaximumPooledSize )
+    {
+        ::operator delete( Object );
+        return;
+    }
+    
+    // link the object at the start of the list for
+    // its size, storing the link within the object
+    size_t SizeClass = (Size + PoolGranularity - 1) / PoolGranularity;
+    *(void**)Object = ReleasedObjects[ SizeClass ];
+    ReleasedObjects[ SizeClass ] = Object;
+}
+
+
+// =============================================================================
+//      POOLS USED BY COMPILER AND ASSEMBLER
+// =============================================================================
+
+
+MemoryPool& TokensPool()
+{
+    static MemoryPool Pool;
+    return Pool;
+}
+
+// -----------------------------------------------------------------------------
+
+MemoryPool& NodesPool()
+{
+    static MemoryPool Pool;
+    return Pool;
+}
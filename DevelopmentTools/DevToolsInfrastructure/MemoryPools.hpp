@@ -0,0 +1,58 @@
+// *****************************************************************************
+    // start include guard
+    #ifndef MEMORYPOOLS_HPP
+    #define MEMORYPOOLS_HPP
+    
+    // include C/C++ headers
+    #include <vector>           // [ C++ STL ] Vectors
+    #include <cstddef>          // [ ANSI C ] Standard definitions
+// *****************************************************************************
+
+
+// =============================================================================
+//      MEMORY POOLS FOR TOKENS AND NODES
+// =============================================================================
+
+
+// Compiling or assembling a program creates and destroys
+// millions of small tokens and nodes. Instead of requesting
+// each one separately from the system, pools take them
+// consecutively from large blocks. Released objects are kept
+// in a list for each size so that their memory is reused by
+// the next ones created.
+class MemoryPool
+{
+    protected:
+        
+        // all blocks requested so far
+        std::vector< char* > Blocks;
+        
+        // unused space in the last block
+        char* NextFreeByte;
+        size_t RemainingBytes;
+        
+        // first released object for each size
+        std::vector< void* > ReleasedObjects;
+        
+    public:
+        
+        // instance handling
+        MemoryPool();
+       ~MemoryPool();
+        
+        // size must be the same for both functions
+        void* Allocate( size_t Size );
+        void Release( void* Object, size_t Size );
+};
+
+// -----------------------------------------------------------------------------
+
+// pools used by compiler and assembler
+MemoryPool& TokensPool();
+MemoryPool& NodesPool();
+
+
+// *****************************************************************************
+    // end include guard
+    #endif
+// *****************************************************************************
@@ -0,0 +1,239 @@
+// *****************************************************************************
+    // include common Vircon headers
+    #include "../../VirconDefinitions/Constants.hpp"
+    
+    // include project headers
+    #include "ObjectFiles.hpp"
+    #include "FilePaths.hpp"
+    #include "FileSignatures.hpp"
+    
+    // include C/C++ headers
+    #include <stdexcept>        // [ C++ STL ] Exceptions
+    #include <cstring>          // [ ANSI C ] Strings
+    
+    // declare used namespaces
+    using namespace std;
+    using namespace V32;
+// *****************************************************************************
+
+
+// =============================================================================
+//      AUXILIARY FUNCTIONS FOR BINARY I/O
+// =============================================================================
+
+
+void WriteObjectString( ofstream& OutputFile, const string& Value )
+{
+    uint32_t Length = Value.size();
+    OutputFile.write( (char*)(&Length), 4 );
+    OutputFile.write( Value.data(), Length );
+}
+
+// -----------------------------------------------------------------------------
+
+string ReadObjectString( ifstream& InputFile )
+{
+    uint32_t Length = 0;
+    InputFile.read( (char*)(&Length), 4 );
+    
+    // symbol names are never that long, so
+    // this can only happen in a corrupted file
+    if( InputFile.fail() || Length > 65536 )
+      throw runtime_error( "object file is corrupted" );
+    
+    string Value( Length, ' ' );
+    
+    if( Length > 0 )
+      InputFile.read( &Value[ 0 ], Length );
+    
+    return Value;
+}
+
+
+// =============================================================================
+//      OBJECT FILE CLASS
+// =============================================================================
+
+
+ObjectFile::ObjectFile()
+{
+    RAMSize = 0;
+}
+
+// -----------------------------------------------------------------------------
+
+// linkers look up a symbol for every relocation,
+// so they need to be found without a linear search
+void ObjectFile::IndexSymbols()
+{
+    SymbolIndices.clear();
+    
+    for( unsigned i = 0; i < Symbols.size(); i++ )
+      SymbolIndices[ Symbols[ i ].Name ] = i;
+}
+
+// -----------------------------------------------------------------------------
+
+// returns -1 if this module does not define the symbol
+int ObjectFile::FindSymbolIndex( const string& Name ) const
+{
+    auto Pair = SymbolIndices.find( Name );
+    
+    if( Pair == SymbolIndices.end() )
+      return -1;
+    
+    return Pair->second;
+}
+
+// -----------------------------------------------------------------------------
+
+// returns nullptr if this module does not define the symbol
+const ObjectSymbol* ObjectFile::FindSymbol( const string& Name ) const
+{
+    int Index = FindSymbolIndex( Name );
+    
+    if( Index < 0 )
+      return nullptr;
+    
+    return &Symbols[ Index ];
+}
+
+// -----------------------------------------------------------------------------
+
+void ObjectFile::Load( const string& FilePath )
+{
+    ifstream InputFile;
+    OpenInputFile( InputFile, FilePath, ios_base::in | ios_base::binary );
+    
+    if( InputFile.fail() )
+      throw runtime_error( "cannot open object file \"" + FilePath + "\"" );
+    
+    // find the file size
+    InputFile.seekg( 0, ios_base::end );
+    uint64_t FileSize = InputFile.tellg();
+    InputFile.seekg( 0, ios_base::beg );
+    
+    // read and check the header
+    ObjectFileFormat::Header ObjectHeader;
+    InputFile.read( (char*)(&ObjectHeader), sizeof(ObjectFileFormat::Header) );
+    
+    if( InputFile.fail() || !CheckSignature( ObjectHeader.Signature, ObjectFileFormat::Signature ) )
+      throw runtime_error( "file \"" + FilePath + "\" is not a valid object file" );
+    
+    if( ObjectHeader.Version != ObjectFileFormat::Version )
+      throw runtime_error( "object file \"" + FilePath + "\" was created by an incompatible assembler version" );
+    
+    // check that sizes in the header are possible before
+    // allocating anything (each symbol and relocation
+    // takes at least its numbers and a string length)
+    uint64_t MinimumFileSize = sizeof(ObjectFileFormat::Header)
+                             + (uint64_t)ObjectHeader.NumberOfWords * 4
+                             + (uint64_t)ObjectHeader.NumberOfSymbols * 16
+                             + (uint64_t)ObjectHeader.NumberOfRelocations * 8;
+    
+    if( ObjectHeader.NumberOfWords > (uint32_t)Constants::MaximumCartridgeProgramROM
+    ||  ObjectHeader.RAMSize > (uint32_t)Constants::RAMSize
+    ||  MinimumFileSize > FileSize )
+      throw runtime_error( "object file \"" + FilePath + "\" is corrupted" );
+    
+    // read the ROM words
+    Words.resize( ObjectHeader.NumberOfWords );
+    RAMSize = ObjectHeader.RAMSize;
+    
+    if( ObjectHeader.NumberOfWords > 0 )
+      InputFile.read( (char*)(&Words[ 0 ]), ObjectHeader.NumberOfWords * 4 );
+    
+    // read all symbols
+    Symbols.clear();
+    
+    for( uint32_t i = 0; i < ObjectHeader.NumberOfSymbols; i++ )
+    {
+        ObjectSymbol Symbol;
+        int32_t Section = 0, Flags = 0;
+        
+        Symbol.Name = ReadObjectString( InputFile );
+        InputFile.read( (char*)(&Section), 4 );
+        InputFile.read( (char*)(&Symbol.Offset), 4 );
+        InputFile.read( (char*)(&Flags), 4 );
+        Symbol.Section = (Section == 0? ObjectSections::ROM : ObjectSections::RAM);
+        Symbol.IsShared = ((Flags & 1) != 0);
+        
+        // labels can be placed at the end of the ROM words
+        int32_t SectionSize = (Section == 0? (int32_t)Words.size() + 1 : RAMSize);
+        
+        if( Section < 0 || Section > 1 || Symbol.Offset < 0 || Symbol.Offset >= SectionSize )
+          throw runtime_error( "object file \"" + FilePath + "\" is corrupted" );
+        
+        Symbols.push_back( Symbol );
+    }
+    
+    IndexSymbols();
+    
+    // read all relocations
+    Relocations.clear();
+    
+    for( uint32_t i = 0; i < ObjectHeader.NumberOfRelocations; i++ )
+    {
+        ObjectRelocation Relocation;
+        InputFile.read( (char*)(&Relocation.WordOffset), 4 );
+        Relocation.SymbolName = ReadObjectString( InputFile );
+        
+        if( Relocation.WordOffset < 0 || Relocation.WordOffset >= (int32_t)Words.size() )
+          throw runtime_error( "object file \"" + FilePath + "\" is corrupted" );
+        
+        Relocations.push_back( Relocation );
+    }
+    
+    if( InputFile.fail() )
+      throw runtime_error( "object file \"" + FilePath + "\" is corrupted" );
+    
+    InputFile.close();
+}
+
+// -----------------------------------------------------------------------------
+
+void ObjectFile::Save( const string& FilePath ) const
+{
+    // open the file in binary mode
+    ofstream OutputFile;
+    OpenOutputFile( OutputFile, FilePath, ios_base::out | ios_base::binary );
+    
+    if( OutputFile.fail() )
+      throw runtime_error( "cannot open output file \"" + FilePath + "\"" );
+    
+    // write the header
+    ObjectFileFormat::Header ObjectHeader;
+    memcpy( ObjectHeader.Signature, ObjectFileFormat::Signature, 8 );
+    ObjectHeader.Version = ObjectFileFormat::Version;
+    ObjectHeader.NumberOfWords = Words.size();
+    ObjectHeader.RAMSize = RAMSize;
+    ObjectHeader.NumberOfSymbols = Symbols.size();
+    ObjectHeader.NumberOfRelocations = Relocations.size();
+    
+    OutputFile.write( (char*)(&ObjectHeader), sizeof(ObjectFileFormat::Header) );
+    
+    // write the ROM words
+    if( !Words.empty() )
+      OutputFile.write( (char*)(&Words[ 0 ]), Words.size() * 4 );
+    
+    // write all symbols
+    for( const ObjectSymbol& Symbol: Symbols )
+    {
+        int32_t Section = (Symbol.Section == ObjectSections::ROM? 0 : 1);
+        int32_t Flags = (Symbol.IsShared? 1 : 0);
+        
+        WriteObjectString( OutputFile, Symbol.Name );
+        OutputFile.write( (char*)(&Section), 4 );
+        OutputFile.write( (char*)(&Symbol.Offset), 4 );
+        OutputFile.write( (char*)(&Flags), 4 );
+    }
+    
+    // write all relocations
+    for( const ObjectRelocation& Relocation: Relocations )
+    {
+        OutputFile.write( (char*)(&Relocation.WordOffset), 4 );
+        WriteObjectString( OutputFile, Relocation.SymbolName );
+    }
+    
+    OutputFile.close();
+}
@@ -0,0 +1,124 @@
+// *****************************************************************************
+    // start include guard
+    #ifndef OBJECTFILES_HPP
+    #define OBJECTFILES_HPP
+    
+    // include common Vircon headers
+    #include "../../VirconDefinitions/DataStructures.hpp"
+    
+    // include C/C++ headers
+    #include <cstdint>          // [ ANSI C ] Standard integer types
+    #include <string>           // [ C++ STL ] Strings
+    #include <vector>           // [ C++ STL ] Vectors
+    #include <unordered_map>    // [ C++ STL ] Unordered maps
+// *****************************************************************************
+
+
+// =============================================================================
+//      FORMAT FOR OBJECT FILES
+// =============================================================================
+
+
+// Object files contain the ROM words for a single assembled
+// module, which the linker joins with other modules to form
+// the final program. All addresses in the module are stored
+// as relocations, since they are only known after linking.
+namespace ObjectFileFormat
+{
+    // expected file signature
+    const char Signature[] = "V32-VOBJ";
+    
+    // increase when the format changes
+    const int32_t Version = 2;
+    
+    // initial header, followed by the words, then
+    // the symbols and finally the relocations
+    typedef struct
+    {
+        char Signature[ 8 ];            // no null termination! (always taken as 8 characters)
+        int32_t Version;
+        uint32_t NumberOfWords;         // length of the ROM words
+        uint32_t RAMSize;               // RAM words needed by the module
+        uint32_t NumberOfSymbols;
+        uint32_t NumberOfRelocations;
+    }
+    Header;
+}
+
+// -----------------------------------------------------------------------------
+
+enum class ObjectSections
+{
+    ROM,
+    RAM
+};
+
+// -----------------------------------------------------------------------------
+
+// a name defined in the module: a label in
+// its ROM words or a variable in its RAM
+// (shared symbols can be defined by other
+// modules too, and only one of them is used)
+class ObjectSymbol
+{
+    public:
+        
+        std::string Name;
+        ObjectSections Section;
+        int32_t Offset;             // from the start of the section
+        bool IsShared;
+};
+
+// -----------------------------------------------------------------------------
+
+// a ROM word that holds the address of a symbol; it
+// can be defined in this module or in any other one
+// (the word itself contains the offset to be added)
+class ObjectRelocation
+{
+    public:
+        
+        int32_t WordOffset;
+        std::string SymbolName;
+};
+
+
+// =============================================================================
+//      OBJECT FILE CLASS
+// =============================================================================
+
+
+class ObjectFile
+{
+    public:
+        
+        std::vector< V32::V32Word > Words;
+        int32_t RAMSize;
+        std::vector< ObjectSymbol > Symbols;
+        std::vector< ObjectRelocation > Relocations;
+        
+        // position of each symbol by name
+        std::unordered_map< std::string, int > SymbolIndices;
+        
+    public:
+        
+        // instance handling
+        ObjectFile();
+        
+        // call after changing the symbols
+        void IndexSymbols();
+        
+        // query functions
+        const ObjectSymbol* FindSymbol( const std::string& Name ) const;
+        int FindSymbolIndex( const std::string& Name ) const;
+        
+        // file operations (they throw on errors)
+        void Load( const std::string& FilePath );
+        void Save( const std::string& FilePath ) const;
+};
+
+
+// *****************************************************************************
+    // end include guard
+    #endif
+// *****************************************************************************
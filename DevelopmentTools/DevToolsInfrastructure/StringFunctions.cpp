@@ -119,14 +119,27 @@ string EscapeXML( const string& Unescaped )
 // =============================================================================
 
 
+// this is called for every word in disassembly and debug
+// output, so it is formatted directly without streams
 string Hex( uint32_t Value, int Digits )
 {
-    std::stringstream ss;
-    ss << nouppercase << "0x";
-    ss << uppercase << hex << setfill('0') << setw(Digits);
-    ss << Value;
-
-    return ss.str();
+    const char HexDigits[] = "0123456789ABCDEF";
+    
+    // like setw, values never get truncated
+    int ValueDigits = 1;
+    
+    while( ValueDigits < 8 && (Value >> (4 * ValueDigits)) )
+      ValueDigits++;
+    
+    Digits = max( Digits, ValueDigits );
+    
+    string Result( 2 + Digits, '0' );
+    Result[ 1 ] = 'x';
+    
+    for( int i = 0; i < ValueDigits; i++ )
+      Result[ 1 + Digits - i ] = HexDigits[ (Value >> (4 * i)) & 15 ];
+    
+    return Result;
 }
 
 // -----------------------------------------------------------------------------
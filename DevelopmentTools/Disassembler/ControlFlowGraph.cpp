@@ -0,0 +1,394 @@
+// *****************************************************************************
+    // include infrastructure headers
+    #include "../DevToolsInfrastructure/StringFunctions.hpp"
+    #include "../DevToolsInfrastructure/FilePaths.hpp"
+    
+    // include project headers
+    #include "ControlFlowGraph.hpp"
+    
+    // include external headers
+    #include <fstream>      // [ C++ STL ] File streams
+    #include <algorithm>    // [ C++ STL ] Algorithms
+    #include <stdexcept>    // [ C++ STL ] Exceptions
+    #include <cstring>      // [ ANSI C ] Strings
+    
+    // declare used namespaces
+    using namespace std;
+    using namespace V32;
+    using namespace CFGFileFormat;
+// *****************************************************************************
+
+
+// =============================================================================
+//      AUXILIARY FUNCTIONS
+// =============================================================================
+
+
+string EscapeJSON( const string& Text )
+{
+    string Result;
+    
+    for( char c: Text )
+    {
+        if( c == '"' || c == '\\' )
+          Result += '\\';
+        
+        if( (unsigned char)c < 0x20 )
+          Result += "\\u00" + Hex( (unsigned char)c, 2 ).substr( 2 );
+        else
+          Result += c;
+    }
+    
+    return Result;
+}
+
+
+// =============================================================================
+//      CONTROL FLOW GRAPH: INSTANCE HANDLING
+// =============================================================================
+
+
+ControlFlowGraph::ControlFlowGraph()
+{
+    ROMWords = 0;
+    InitialAddress = 0;
+}
+
+
+// =============================================================================
+//      CONTROL FLOW GRAPH: CONSTRUCTION
+// =============================================================================
+
+
+// all blocks are found in a single pass through ROM
+void ControlFlowGraph::FindBlocks( const VirconDisassembler& Disassembler )
+{
+    Blocks.clear();
+    bool BlockOpen = false;
+    uint32_t ROMIndex = 0;
+    
+    while( ROMIndex < ROMWords )
+    {
+        uint8_t WordFlags = Disassembler.GetFlags( ROMIndex );
+        
+        // data words end any block
+        if( !(WordFlags & WordFlags::Instruction) )
+        {
+            BlockOpen = false;
+            ROMIndex++;
+            continue;
+        }
+        
+        // jump destinations always start a new block
+        if( !BlockOpen || (WordFlags & (WordFlags::JumpTarget | WordFlags::FunctionEntry)) )
+        {
+            Block NewBlock;
+            NewBlock.FirstWord = ROMIndex;
+            NewBlock.NumberOfWords = 0;
+            NewBlock.FirstEdge = NewBlock.NumberOfEdges = 0;
+            NewBlock.Function = NoIndex;
+            NewBlock.Flags = (WordFlags & WordFlags::FunctionEntry)? BlockFlags::FunctionEntry : 0;
+            
+            Blocks.push_back( NewBlock );
+            BlockOpen = true;
+        }
+        
+        // add this instruction to the block
+        CPUInstruction Instruction = Disassembler.ROM[ ROMIndex ].AsInstruction;
+        uint32_t InstructionWords = min< uint32_t >( Instruction.UsesImmediate? 2 : 1, ROMWords - ROMIndex );
+        Blocks.back().NumberOfWords += InstructionWords;
+        ROMIndex += InstructionWords;
+        
+        // any change of flow ends the block
+        if( IsEndOfBranch( Instruction ) || IsInconditionalJump( Instruction ) || IsConditionalJump( Instruction ) )
+          BlockOpen = false;
+    }
+}
+
+// -----------------------------------------------------------------------------
+
+// returns NoIndex if no block starts there
+uint32_t ControlFlowGraph::FindBlock( uint32_t ROMIndex ) const
+{
+    auto Position = lower_bound
+    (
+        Blocks.begin(), Blocks.end(), ROMIndex,
+        []( const Block& B, uint32_t Index ){ return B.FirstWord < Index; }
+    );
+    
+    if( Position == Blocks.end() || Position->FirstWord != ROMIndex )
+      return NoIndex;
+    
+    return Position - Blocks.begin();
+}
+
+// -----------------------------------------------------------------------------
+
+void ControlFlowGraph::FindEdges( const VirconDisassembler& Disassembler )
+{
+    Edges.clear();
+    Calls.clear();
+    
+    for( uint32_t BlockIndex = 0; BlockIndex < Blocks.size(); BlockIndex++ )
+    {
+        Block& B = Blocks[ BlockIndex ];
+        B.FirstEdge = Edges.size();
+        uint32_t BlockEnd = B.FirstWord + B.NumberOfWords;
+        
+        // check all instructions, to find calls
+        // and then the one that ends the block
+        CPUInstruction Instruction = {};
+        uint32_t Destination = NoIndex;
+        uint32_t ROMIndex = B.FirstWord;
+        
+        while( ROMIndex < BlockEnd )
+        {
+            Instruction = Disassembler.ROM[ ROMIndex ].AsInstruction;
+            Destination = NoIndex;
+            
+            if( Instruction.UsesImmediate && ROMIndex + 1 < ROMWords )
+              Destination = Disassembler.ROM[ ROMIndex + 1 ].AsBinary - InitialAddress;
+            
+            if( IsSubroutineCall( Instruction ) )
+            {
+                // callee is stored as a block for now
+                if( !Instruction.UsesImmediate )
+                  B.Flags |= BlockFlags::IndirectCall;
+                
+                else if( FindBlock( Destination ) != NoIndex )
+                  Calls.push_back( Call{ BlockIndex, FindBlock( Destination ) } );
+            }
+            
+            ROMIndex += Instruction.UsesImmediate? 2 : 1;
+        }
+        
+        // add edges depending on the last instruction
+        bool FallsThrough = true;
+        
+        if( Instruction.OpCode == (int)InstructionOpCodes::RET )
+        {
+            B.Flags |= BlockFlags::Return;
+            FallsThrough = false;
+        }
+        
+        else if( Instruction.OpCode == (int)InstructionOpCodes::HLT )
+        {
+            B.Flags |= BlockFlags::Halt;
+            FallsThrough = false;
+        }
+        
+        else if( IsInconditionalJump( Instruction ) || IsConditionalJump( Instruction ) )
+        {
+            if( !Instruction.UsesImmediate )
+              B.Flags |= BlockFlags::IndirectJump;
+            
+            else if( FindBlock( Destination ) != NoIndex )
+              Edges.push_back( Edge{ FindBlock( Destination ), IsConditionalJump( Instruction )? EdgeTypes::Branch : EdgeTypes::Jump } );
+            
+            FallsThrough = IsConditionalJump( Instruction );
+        }
+        
+        // only if execution continues into the next block
+        if( FallsThrough && BlockIndex + 1 < Blocks.size() && Blocks[ BlockIndex + 1 ].FirstWord == BlockEnd )
+          Edges.push_back( Edge{ BlockIndex + 1, EdgeTypes::Fallthrough } );
+        
+        B.NumberOfEdges = Edges.size() - B.FirstEdge;
+    }
+}
+
+// -----------------------------------------------------------------------------
+
+void ControlFlowGraph::FindFunctions( const VirconDisassembler& Disassembler )
+{
+    Functions.clear();
+    Names.clear();
+    
+    // entry blocks belong to their own function
+    for( uint32_t BlockIndex = 0; BlockIndex < Blocks.size(); BlockIndex++ )
+    {
+        if( !(Blocks[ BlockIndex ].Flags & BlockFlags::FunctionEntry) )
+          continue;
+        
+        Function NewFunction;
+        NewFunction.EntryBlock = BlockIndex;
+        NewFunction.FirstCall = NewFunction.NumberOfCalls = 0;
+        NewFunction.NameOffset = Names.size();
+        
+        // use the same name given in the listing
+        auto Name = Disassembler.JumpDestinationNames.find( Blocks[ BlockIndex ].FirstWord );
+        
+        if( Name != Disassembler.JumpDestinationNames.end() )
+          Names += Name->second;
+        
+        Names += '\0';
+        Blocks[ BlockIndex ].Function = Functions.size();
+        Functions.push_back( NewFunction );
+    }
+    
+    // then every function takes all blocks it reaches
+    // that were not already taken by a previous one
+    vector< uint32_t > PendingBlocks;
+    
+    for( uint32_t FunctionIndex = 0; FunctionIndex < Functions.size(); FunctionIndex++ )
+    {
+        PendingBlocks.assign( 1, Functions[ FunctionIndex ].EntryBlock );
+        
+        while( !PendingBlocks.empty() )
+        {
+            Block& B = Blocks[ PendingBlocks.back() ];
+            PendingBlocks.pop_back();
+            
+            for( uint32_t i = 0; i < B.NumberOfEdges; i++ )
+            {
+                Block& Target = Blocks[ Edges[ B.FirstEdge + i ].TargetBlock ];
+                
+                if( Target.Function == NoIndex )
+                {
+                    Target.Function = FunctionIndex;
+                    PendingBlocks.push_back( Edges[ B.FirstEdge + i ].TargetBlock );
+                }
+            }
+        }
+    }
+    
+    // now calls can refer to functions; the ones
+    // made from code outside functions are removed
+    vector< Call > FunctionCalls;
+    
+    for( Call& C: Calls )
+      if( Blocks[ C.CallerBlock ].Function != NoIndex )
+        FunctionCalls.push_back( Call{ C.CallerBlock, Blocks[ C.CalleeFunction ].Function } );
+    
+    // group calls by their caller function
+    stable_sort
+    (
+        FunctionCalls.begin(), FunctionCalls.end(),
+        [&]( const Call& C1, const Call& C2 ){ return Blocks[ C1.CallerBlock ].Function < Blocks[ C2.CallerBlock ].Function; }
+    );
+    
+    for( uint32_t i = 0; i < FunctionCalls.size(); i++ )
+    {
+        Function& Caller = Functions[ Blocks[ FunctionCalls[ i ].CallerBlock ].Function ];
+        
+        if( Caller.NumberOfCalls == 0 )
+          Caller.FirstCall = i;
+        
+        Caller.NumberOfCalls++;
+    }
+    
+    Calls = FunctionCalls;
+}
+
+// -----------------------------------------------------------------------------
+
+void ControlFlowGraph::Build( const VirconDisassembler& Disassembler )
+{
+    ROMWords = Disassembler.ROM.size();
+    InitialAddress = InitialROMAddress;
+    
+    FindBlocks( Disassembler );
+    FindEdges( Disassembler );
+    FindFunctions( Disassembler );
+}
+
+
+// =============================================================================
+//      CONTROL FLOW GRAPH: SAVING RESULTS
+// =============================================================================
+
+
+void ControlFlowGraph::SaveBinary( const string& FilePath )
+{
+    FILE* OutputFile = OpenOutputFile( FilePath );
+    
+    if( !OutputFile )
+      throw runtime_error( "cannot open output file \"" + FilePath + "\"" );
+    
+    Header CFGHeader;
+    memcpy( CFGHeader.Signature, Signature, 8 );
+    CFGHeader.ROMWords = ROMWords;
+    CFGHeader.InitialAddress = InitialAddress;
+    CFGHeader.NumberOfBlocks = Blocks.size();
+    CFGHeader.NumberOfEdges = Edges.size();
+    CFGHeader.NumberOfFunctions = Functions.size();
+    CFGHeader.NumberOfCalls = Calls.size();
+    CFGHeader.NamesSize = Names.size();
+    
+    fwrite( &CFGHeader, sizeof(Header), 1, OutputFile );
+    fwrite( Blocks.data(), sizeof(Block), Blocks.size(), OutputFile );
+    fwrite( Edges.data(), sizeof(Edge), Edges.size(), OutputFile );
+    fwrite( Functions.data(), sizeof(Function), Functions.size(), OutputFile );
+    fwrite( Calls.data(), sizeof(Call), Calls.size(), OutputFile );
+    fwrite( Names.data(), 1, Names.size(), OutputFile );
+    
+    bool WriteFailed = ferror( OutputFile );
+    fclose( OutputFile );
+    
+    if( WriteFailed )
+      throw runtime_error( "cannot write to output file \"" + FilePath + "\"" );
+}
+
+// -----------------------------------------------------------------------------
+
+void ControlFlowGraph::SaveJSON( const string& FilePath )
+{
+    ofstream OutputFile;
+    OpenOutputFile( OutputFile, FilePath );
+    
+    if( OutputFile.fail() )
+      throw runtime_error( "cannot open output file \"" + FilePath + "\"" );
+    
+    const char* EdgeTypeNames[] = { "fallthrough", "jump", "branch" };
+    const char* FlagNames[] = { "entry", "return", "halt", "indirect_jump", "indirect_call" };
+    
+    OutputFile << "{\n";
+    OutputFile << "  \"rom_words\": " << ROMWords << ",\n";
+    OutputFile << "  \"initial_address\": \"" << Hex( InitialAddress, 8 ) << "\",\n";
+    
+    // one line per block
+    OutputFile << "  \"blocks\":\n  [\n";
+    
+    for( uint32_t i = 0; i < Blocks.size(); i++ )
+    {
+        Block& B = Blocks[ i ];
+        OutputFile << "    { \"address\": \"" << Hex( InitialAddress + B.FirstWord, 8 ) << "\"";
+        OutputFile << ", \"words\": " << B.NumberOfWords;
+        OutputFile << ", \"function\": " << (B.Function == NoIndex? -1 : (int64_t)B.Function);
+        OutputFile << ", \"flags\": [";
+        
+        for( int Flag = 0, Written = 0; Flag < 5; Flag++ )
+          if( B.Flags & (1 << Flag) )
+            OutputFile << (Written++? ", \"" : "\"") << FlagNames[ Flag ] << "\"";
+        
+        OutputFile << "], \"successors\": [";
+        
+        for( uint32_t e = 0; e < B.NumberOfEdges; e++ )
+        {
+            Edge& E = Edges[ B.FirstEdge + e ];
+            OutputFile << (e? ", " : "") << "[" << E.TargetBlock << ", \"" << EdgeTypeNames[ (int)E.Type ] << "\"]";
+        }
+        
+        OutputFile << "] }" << (i + 1 < Blocks.size()? "," : "") << '\n';
+    }
+    
+    OutputFile << "  ],\n";
+    
+    // one line per function
+    OutputFile << "  \"functions\":\n  [\n";
+    
+    for( uint32_t i = 0; i < Functions.size(); i++ )
+    {
+        Function& F = Functions[ i ];
+        OutputFile << "    { \"name\": \"" << EscapeJSON( &Names[ F.NameOffset ] ) << "\"";
+        OutputFile << ", \"entry_block\": " << F.EntryBlock;
+        OutputFile << ", \"calls\": [";
+        
+        for( uint32_t c = 0; c < F.NumberOfCalls; c++ )
+          OutputFile << (c? ", " : "") << Calls[ F.FirstCall + c ].CalleeFunction;
+        
+        OutputFile << "] }" << (i + 1 < Functions.size()? "," : "") << '\n';
+    }
+    
+    OutputFile << "  ]\n}\n";
+    OutputFile.close();
+}
@@ -0,0 +1,161 @@
+// *****************************************************************************
+    // start include guard
+    #ifndef CONTROLFLOWGRAPH_HPP
+    #define CONTROLFLOWGRAPH_HPP
+    
+    // include project headers
+    #include "VirconDisassembler.hpp"
+    
+    // include C/C++ headers
+    #include <string>       // [ C++ STL ] Strings
+    #include <vector>       // [ C++ STL ] Vectors
+    #include <cstdint>      // [ ANSI C ] Standard integer types
+// *****************************************************************************
+
+
+// =============================================================================
+//      FORMAT FOR CONTROL FLOW GRAPH FILES
+// =============================================================================
+
+
+// The binary file is a header followed by 5 tables,
+// in this order and with no padding: blocks, edges,
+// functions, calls, and the names of functions (each
+// one terminated by a 0 byte). All entries have a
+// fixed size, so the file can be memory-mapped and
+// used directly. Indices refer to entries in those
+// tables, and ROM positions are word indices.
+namespace CFGFileFormat
+{
+    // expected file signature
+    const char Signature[]  = "V32-VCFG";
+    
+    // value for indices that don't exist
+    const uint32_t NoIndex = 0xFFFFFFFF;
+    
+    typedef struct
+    {
+        char Signature[ 8 ];        // no null termination! (always taken as 8 characters)
+        uint32_t ROMWords;          // size of the analyzed binary
+        uint32_t InitialAddress;    // address of ROM word 0 at runtime
+        uint32_t NumberOfBlocks;
+        uint32_t NumberOfEdges;
+        uint32_t NumberOfFunctions;
+        uint32_t NumberOfCalls;
+        uint32_t NamesSize;         // in bytes
+    }
+    Header;
+    
+    // -----------------------------------------------------------------------------
+    
+    // how a block ends
+    namespace BlockFlags
+    {
+        const uint32_t FunctionEntry = 1;
+        const uint32_t Return        = 2;   // ends with RET
+        const uint32_t Halt          = 4;   // ends with HLT
+        const uint32_t IndirectJump  = 8;   // has a jump to a register
+        const uint32_t IndirectCall  = 16;  // has a call to a register
+    }
+    
+    // basic block: a sequence of instructions
+    // that can only be entered at the start
+    typedef struct
+    {
+        uint32_t FirstWord;
+        uint32_t NumberOfWords;
+        uint32_t FirstEdge;         // its successors are contiguous
+        uint32_t NumberOfEdges;
+        uint32_t Function;          // NoIndex if not reachable from any
+        uint32_t Flags;
+    }
+    Block;
+    
+    // -----------------------------------------------------------------------------
+    
+    enum class EdgeTypes: uint32_t
+    {
+        Fallthrough = 0,            // to the next block in ROM
+        Jump,                       // JMP
+        Branch                      // JT/JF when the jump is taken
+    };
+    
+    typedef struct
+    {
+        uint32_t TargetBlock;
+        EdgeTypes Type;
+    }
+    Edge;
+    
+    // -----------------------------------------------------------------------------
+    
+    typedef struct
+    {
+        uint32_t EntryBlock;
+        uint32_t FirstCall;         // its calls are contiguous
+        uint32_t NumberOfCalls;
+        uint32_t NameOffset;        // within the names table
+    }
+    Function;
+    
+    // -----------------------------------------------------------------------------
+    
+    typedef struct
+    {
+        uint32_t CallerBlock;
+        uint32_t CalleeFunction;
+    }
+    Call;
+}
+
+
+// =============================================================================
+//      CONTROL FLOW GRAPH OF A DISASSEMBLED PROGRAM
+// =============================================================================
+
+
+// Built from the results of exploration: every explored
+// instruction belongs to exactly one block. Blocks end at
+// jumps, returns and halts, or before jump destinations.
+// Calls don't end blocks, and are stored separately to
+// form the call graph. Each block is assigned to the first
+// function (in ROM order) that reaches it without calls.
+class ControlFlowGraph
+{
+    public:
+        
+        std::vector< CFGFileFormat::Block > Blocks;
+        std::vector< CFGFileFormat::Edge > Edges;
+        std::vector< CFGFileFormat::Function > Functions;
+        std::vector< CFGFileFormat::Call > Calls;
+        std::string Names;
+        
+    protected:
+        
+        uint32_t ROMWords;
+        uint32_t InitialAddress;
+        
+        // construction stages
+        void FindBlocks( const VirconDisassembler& Disassembler );
+        void FindEdges( const VirconDisassembler& Disassembler );
+        void FindFunctions( const VirconDisassembler& Disassembler );
+        uint32_t FindBlock( uint32_t ROMIndex ) const;
+        
+    public:
+        
+        ControlFlowGraph();
+        
+        // the disassembler must have explored
+        // and named labels before calling this
+        void Build( const VirconDisassembler& Disassembler );
+        
+        // saving results
+        void SaveBinary( const std::string& FilePath );
+        void SaveJSON( const std::string& FilePath );
+};
+
+
+// *****************************************************************************
+    // end include guard
+    #endif
+// *****************************************************************************
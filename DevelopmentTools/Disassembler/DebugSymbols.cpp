@@ -0,0 +1,162 @@
+// *****************************************************************************
+    // include infrastructure headers
+    #include "../DevToolsInfrastructure/StringFunctions.hpp"
+    #include "../DevToolsInfrastructure/FilePaths.hpp"
+    
+    // include project headers
+    #include "DebugSymbols.hpp"
+    
+    // include external headers
+    #include <fstream>      // [ C++ STL ] File streams
+    #include <iostream>     // [ C++ STL ] I/O Streams
+    #include <stdexcept>    // [ C++ STL ] Exceptions
+    
+    // declare used namespaces
+    using namespace std;
+// *****************************************************************************
+
+
+// =============================================================================
+//      DEBUG SYMBOLS: LOADING FILES
+// =============================================================================
+
+
+void DebugSymbols::LoadAssemblerLine( const vector< string >& Fields )
+{
+    // format: ROM address, ASM file path, line[, label]
+    if( Fields.size() < 3 )
+      throw runtime_error( "incorrect assembler debug info line" );
+    
+    uint32_t Address = stoul( Fields[ 0 ], nullptr, 16 );
+    int Line = stoi( Fields[ 2 ] );
+    LineAddresses[ Fields[ 1 ] ][ Line ] = Address;
+    
+    if( Fields.size() > 3 && !Fields[ 3 ].empty() )
+      Labels[ Address ] = Fields[ 3 ];
+}
+
+// -----------------------------------------------------------------------------
+
+void DebugSymbols::LoadCompilerLine( const vector< string >& Fields )
+{
+    // format: ASM file path, ASM line, C file path, C line[, function]
+    if( Fields.size() < 4 )
+      throw runtime_error( "incorrect compiler debug info line" );
+    
+    // only functions are of interest
+    if( Fields.size() < 5 || Fields[ 4 ].empty() )
+      return;
+    
+    CFunction NewFunction;
+    NewFunction.ASMFilePath = Fields[ 0 ];
+    NewFunction.ASMLine = stoi( Fields[ 1 ] );
+    NewFunction.CFilePath = Fields[ 2 ];
+    NewFunction.CLine = stoi( Fields[ 3 ] );
+    NewFunction.Name = Fields[ 4 ];
+    CFunctions.push_back( NewFunction );
+}
+
+// -----------------------------------------------------------------------------
+
+void DebugSymbols::LoadFile( const string& FilePath )
+{
+    if( VerboseMode )
+      cout << "loading debug info file \"" << FilePath << "\"" << endl;
+    
+    ifstream InputFile;
+    OpenInputFile( InputFile, FilePath );
+    
+    if( InputFile.fail() )
+      throw runtime_error( "cannot open debug info file \"" + FilePath + "\"" );
+    
+    string Line;
+    int LineNumber = 0;
+    
+    while( getline( InputFile, Line ) )
+    {
+        LineNumber++;
+        
+        // accept files with Windows line endings
+        if( !Line.empty() && Line.back() == '\r' )
+          Line.pop_back();
+        
+        if( Line.empty() )
+          continue;
+        
+        // assembler lines start with a hex address
+        try
+        {
+            vector< string > Fields = SplitString( Line, ',' );
+            
+            if( Line.compare( 0, 2, "0x" ) == 0 )
+              LoadAssemblerLine( Fields );
+            else
+              LoadCompilerLine( Fields );
+        }
+        
+        catch( const exception& )
+        {
+            throw runtime_error( "debug info file \"" + FilePath + "\", line " + to_string( LineNumber ) + ": invalid format" );
+        }
+    }
+    
+    InputFile.close();
+}
+
+
+// =============================================================================
+//      DEBUG SYMBOLS: APPLYING TO A DISASSEMBLY
+// =============================================================================
+
+
+// paths may have been given differently to each program,
+// so if there is no exact match just compare file names
+const map< int, uint32_t >* DebugSymbols::FindASMFile( const string& FilePath ) const
+{
+    auto Exact = LineAddresses.find( FilePath );
+    
+    if( Exact != LineAddresses.end() )
+      return &Exact->second;
+    
+    for( auto& Pair: LineAddresses )
+      if( GetPathFileName( Pair.first ) == GetPathFileName( FilePath ) )
+        return &Pair.second;
+    
+    return nullptr;
+}
+
+// -----------------------------------------------------------------------------
+
+void DebugSymbols::Apply( VirconDisassembler& Disassembler ) const
+{
+    uint32_t ROMSize = Disassembler.ROM.size();
+    
+    // assembler labels name their positions
+    for( auto& Pair: Labels )
+    {
+        uint32_t ROMIndex = Pair.first - InitialROMAddress;
+        
+        if( ROMIndex < ROMSize )
+          Disassembler.ImportedNames[ ROMIndex ] = Pair.second;
+    }
+    
+    // the line for a C function is its label, which has no
+    // address: use the first instruction after that line
+    for( const CFunction& Function: CFunctions )
+    {
+        const map< int, uint32_t >* Lines = FindASMFile( Function.ASMFilePath );
+        
+        if( !Lines )
+          continue;
+        
+        auto Position = Lines->lower_bound( Function.ASMLine );
+        
+        if( Position == Lines->end() )
+          continue;
+        
+        uint32_t ROMIndex = Position->second - InitialROMAddress;
+        
+        if( ROMIndex < ROMSize )
+          Disassembler.ImportedComments[ ROMIndex ] = "C function " + Function.Name + " (" + Function.CFilePath + " line " + to_string( Function.CLine ) + ")";
+    }
+}
@@ -0,0 +1,69 @@
+// *****************************************************************************
+    // start include guard
+    #ifndef DEBUGSYMBOLS_HPP
+    #define DEBUGSYMBOLS_HPP
+    
+    // include project headers
+    #include "VirconDisassembler.hpp"
+    
+    // include C/C++ headers
+    #include <string>       // [ C++ STL ] Strings
+    #include <vector>       // [ C++ STL ] Vectors
+    #include <map>          // [ C++ STL ] Maps
+    #include <cstdint>      // [ ANSI C ] Standard integer types
+// *****************************************************************************
+
+
+// =============================================================================
+//      SYMBOLS IMPORTED FROM DEBUG INFO FILES
+// =============================================================================
+
+
+// Reads the debug info files written by the assembler and
+// the C compiler when using -g. Assembler files give the
+// ROM address of every line and the names of labels, so
+// they are enough to name jump destinations. C compiler
+// files relate C functions to lines in their ASM file, and
+// those lines can only be placed in ROM if the assembler
+// file for that same ASM has also been loaded.
+class DebugSymbols
+{
+    protected:
+        
+        // from assembler files: for each ASM
+        // file, the address of each line
+        std::map< std::string, std::map< int, uint32_t > > LineAddresses;
+        std::map< uint32_t, std::string > Labels;
+        
+        // from C compiler files
+        struct CFunction
+        {
+            std::string ASMFilePath;
+            int ASMLine;
+            std::string CFilePath;
+            int CLine;
+            std::string Name;
+        };
+        
+        std::vector< CFunction > CFunctions;
+        
+        // loading each file type
+        void LoadAssemblerLine( const std::vector< std::string >& Fields );
+        void LoadCompilerLine( const std::vector< std::string >& Fields );
+        const std::map< int, uint32_t >* FindASMFile( const std::string& FilePath ) const;
+        
+    public:
+        
+        // the file type is detected from its contents
+        void LoadFile( const std::string& FilePath );
+        
+        // gives names and descriptions to the disassembler
+        // (only for positions within its loaded ROM)
+        void Apply( VirconDisassembler& Disassembler ) const;
+};
+
+
+// *****************************************************************************
+    // end include guard
+    #endif
+// *****************************************************************************
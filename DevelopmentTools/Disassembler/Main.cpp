@@ -9,6 +9,8 @@
     
     // include project headers
     #include "VirconDisassembler.hpp"
+    #include "ControlFlowGraph.hpp"
+    #include "DebugSymbols.hpp"
     
     // include external headers
     #include <string>       // [ C++ STL ] Strings
@@ -17,6 +19,8 @@
     #include <map>          // [ C++ STL ] Maps
     #include <list>         // [ C++ STL ] Lists
     #include <vector>       // [ C++ STL ] Vectors
+    #include <thread>       // [ C++ STL ] Threads
+    #include <algorithm>    // [ C++ STL ] Algorithms
     
     // on Windows include headers for unicode conversion
     #if defined(__WIN32__) || defined(_WIN32) || defined(_WIN64)
@@ -44,6 +48,10 @@ void PrintUsage()
     cout << "  --version    Displays program version" << endl;
     cout << "  -o <file>    Output file, default name is the same as input" << endl;
     cout << "  -b           Disassembles the code as a BIOS" << endl;
+    cout << "  -g <file>    Takes names from a debug info file (can be repeated)" << endl;
+    cout << "               in addition to the file's own .debug, if present" << endl;
+    cout << "  --cfg <file> Saves the control flow graph (JSON if extension is .json)" << endl;
+    cout << "  -j <number>  Number of threads for code exploration" << endl;
     cout << "  -v           Displays additional information (verbose)" << endl;
 }
 
@@ -69,7 +77,9 @@ int main( int NumberOfArguments, char* Arguments[] )
         // Process command line arguments
         
         // variables to capture input parameters
-        string InputPath, OutputPath;
+        string InputPath, OutputPath, CFGPath;
+        vector< string > DebugInfoPaths;
+        int NumberOfThreads = max( 1u, thread::hardware_concurrency() );
         
         // to treat arguments the same in any OS we
         // will convert them to UTF-8 in all cases
@@ -138,6 +148,54 @@ int main( int NumberOfArguments, char* Arguments[] )
                 continue;
             }
             
+            if( ArgumentsUTF8[i] == string("-g") )
+            {
+                // expect another argument
+                i++;
+                
+                if( i >= NumberOfArguments )
+                  throw runtime_error( "missing filename after '-g'" );
+                
+                DebugInfoPaths.push_back( ArgumentsUTF8[ i ] );
+                continue;
+            }
+            
+            if( ArgumentsUTF8[i] == string("--cfg") )
+            {
+                // expect another argument
+                i++;
+                
+                if( i >= NumberOfArguments )
+                  throw runtime_error( "missing filename after '--cfg'" );
+                
+                CFGPath = ArgumentsUTF8[ i ];
+                continue;
+            }
+            
+            if( ArgumentsUTF8[i] == string("-j") )
+            {
+                // expect another argument
+                i++;
+                
+                if( i >= NumberOfArguments )
+                  throw runtime_error( "missing number after '-j'" );
+                
+                try
+                {
+                    NumberOfThreads = stoi( ArgumentsUTF8[ i ] );
+                }
+                
+                catch( const exception& )
+                {
+                    NumberOfThreads = 0;
+                }
+                
+                if( NumberOfThreads < 1 )
+                  throw runtime_error( "invalid number of threads '" + ArgumentsUTF8[ i ] + "'" );
+                
+                continue;
+            }
+            
             // these options are accepted but have no effect
             if( ArgumentsUTF8[i] == string("-s")  )  continue;
             
@@ -186,6 +244,24 @@ int main( int NumberOfArguments, char* Arguments[] )
         VirconDisassembler Disassembler;
         Disassembler.LoadROM( InputPath );
         
+        // find all code that can be reached
+        Disassembler.Explore( NumberOfThreads );
+        
+        // the assembler saves debug info next to the binary,
+        // so use it along with any other files that were given
+        string AdjacentDebugPath = InputPath + ".debug";
+        
+        if( FileExists( AdjacentDebugPath )
+        &&  find( DebugInfoPaths.begin(), DebugInfoPaths.end(), AdjacentDebugPath ) == DebugInfoPaths.end() )
+          DebugInfoPaths.insert( DebugInfoPaths.begin(), AdjacentDebugPath );
+        
+        DebugSymbols Symbols;
+        
+        for( string& DebugInfoPath: DebugInfoPaths )
+          Symbols.LoadFile( DebugInfoPath );
+        
+        Symbols.Apply( Disassembler );
+        
         // now open output file
         ofstream OutputFile;
         OpenOutputFile( OutputFile, OutputPath, ios_base::out );
@@ -198,6 +274,19 @@ int main( int NumberOfArguments, char* Arguments[] )
         
         // close output
         OutputFile.close();
+        
+        // save the graph after disassembly, since
+        // it uses the same names for functions
+        if( !CFGPath.empty() )
+        {
+            ControlFlowGraph Graph;
+            Graph.Build( Disassembler );
+            
+            if( ToLowerCase( GetFileExtension( CFGPath ) ) == "json" )
+              Graph.SaveJSON( CFGPath );
+            else
+              Graph.SaveBinary( CFGPath );
+        }
     }
     
     catch( const exception& e )
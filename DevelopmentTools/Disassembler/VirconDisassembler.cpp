@@ -17,6 +17,7 @@
     #include <iostream>     // [ C++ STL ] I/O Streams
     #include <sstream>      // [ C++ STL ] String Streams
     #include <iomanip>      // [ C++ STL ] I/O Manipulation
+    #include <thread>       // [ C++ STL ] Threads
     
     // declare used namespaces
     using namespace std;
@@ -112,7 +113,7 @@ WriterFunction OperandWriteFunctions[] =
 // =============================================================================
 
 
-bool IsInconditionalJump( CPUInstruction& Instruction )
+bool IsInconditionalJump( const CPUInstruction& Instruction )
 {
     if( Instruction.OpCode == (int)InstructionOpCodes::JMP ) return true;
     return false;
@@ -120,7 +121,7 @@ bool IsInconditionalJump( CPUInstruction& Instruction )
 
 // -----------------------------------------------------------------------------
 
-bool IsConditionalJump( CPUInstruction& Instruction )
+bool IsConditionalJump( const CPUInstruction& Instruction )
 {
     if( Instruction.OpCode == (int)InstructionOpCodes::JT ) return true;
     if( Instruction.OpCode == (int)InstructionOpCodes::JF ) return true;
@@ -129,7 +130,7 @@ bool IsConditionalJump( CPUInstruction& Instruction )
 
 // -----------------------------------------------------------------------------
 
-bool IsSubroutineCall( CPUInstruction& Instruction )
+bool IsSubroutineCall( const CPUInstruction& Instruction )
 {
     if( Instruction.OpCode == (int)InstructionOpCodes::CALL ) return true;
     return false;
@@ -137,7 +138,7 @@ bool IsSubroutineCall( CPUInstruction& Instruction )
 
 // -----------------------------------------------------------------------------
 
-bool IsEndOfBranch( CPUInstruction& Instruction )
+bool IsEndOfBranch( const CPUInstruction& Instruction )
 {
     if( Instruction.OpCode == (int)InstructionOpCodes::RET ) return true;
     if( Instruction.OpCode == (int)InstructionOpCodes::HLT ) return true;
@@ -146,7 +147,59 @@ bool IsEndOfBranch( CPUInstruction& Instruction )
 
 
 // =============================================================================
-//      VIRCON DISASSEMBLER: DISASSEMBLY FUNCTIONS
+//      EXPLORATION QUEUE
+// =============================================================================
+
+
+ExplorationQueue::ExplorationQueue()
+{
+    BusyWorkers = 0;
+}
+
+// -----------------------------------------------------------------------------
+
+void ExplorationQueue::Push( uint32_t ROMIndex )
+{
+    lock_guard< mutex > Lock( QueueMutex );
+    PendingEntries.push_back( ROMIndex );
+    QueueChanged.notify_one();
+}
+
+// -----------------------------------------------------------------------------
+
+bool ExplorationQueue::TakeEntry( uint32_t& ROMIndex )
+{
+    unique_lock< mutex > Lock( QueueMutex );
+    
+    // while others work, new entries may still appear
+    while( PendingEntries.empty() && BusyWorkers > 0 )
+      QueueChanged.wait( Lock );
+    
+    if( PendingEntries.empty() )
+      return false;
+    
+    ROMIndex = PendingEntries.back();
+    PendingEntries.pop_back();
+    BusyWorkers++;
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+
+void ExplorationQueue::EndEntry()
+{
+    lock_guard< mutex > Lock( QueueMutex );
+    BusyWorkers--;
+    
+    // when the last worker ends with no more entries,
+    // all others are waiting and must be released
+    if( BusyWorkers == 0 && PendingEntries.empty() )
+      QueueChanged.notify_all();
+}
+
+
+// =============================================================================
+//      VIRCON DISASSEMBLER: LOADING ROMS
 // =============================================================================
 
 
@@ -164,7 +217,7 @@ void VirconDisassembler::LoadROM( const string& InputPath )
     
     // get size and ensure it is a multiple of 4
     // (otherwise file contents are wrong)
-    unsigned FileBytes = InputFile.tellg();
+    uint64_t FileBytes = InputFile.tellg();
     
     if( (FileBytes % 4) != 0 )
       throw runtime_error( "incorrect VBIN file format (file size must be a multiple of 4)" );
@@ -183,101 +236,195 @@ void VirconDisassembler::LoadROM( const string& InputPath )
       throw runtime_error( "incorrect VBIN file format (file does not have a valid signature)" );
     
     // check for the correct file size
-    uint32_t ExpectedFileSize = sizeof(BinaryFileFormat::Header) + 4*BinaryHeader.NumberOfWords;
+    uint64_t ExpectedFileSize = sizeof(BinaryFileFormat::Header) + 4 * (uint64_t)BinaryHeader.NumberOfWords;
     
     if( FileBytes != ExpectedFileSize )
       throw runtime_error( "incorrect VBIN file format (file size does not match indicated binary size)" );
     
     // load the whole binary content as bytes
     ROM.resize( BinaryHeader.NumberOfWords );
-    InputFile.read( (char*)(&ROM[0]), 4*BinaryHeader.NumberOfWords );
+    InputFile.read( (char*)ROM.data(), 4 * (uint64_t)BinaryHeader.NumberOfWords );
     
     // finally, close the file
     InputFile.close();
+    
+    // all words start as unexplored
+    ROMWordFlags = vector< atomic< uint8_t > >( ROM.size() );
+}
+
+
+// =============================================================================
+//      VIRCON DISASSEMBLER: EXPLORATION OF CODE
+// =============================================================================
+
+
+// marks a jump destination; if it is a new function
+// entry, it is also queued to be explored
+void VirconDisassembler::MarkDestination( uint32_t ROMIndex, uint8_t Flags, ExplorationQueue* Queue )
+{
+    if( ROMIndex >= ROM.size() )
+      return;
+    
+    uint8_t PreviousFlags = ROMWordFlags[ ROMIndex ].fetch_or( Flags );
+    
+    if( Queue && !(PreviousFlags & WordFlags::FunctionEntry) )
+      Queue->Push( ROMIndex );
 }
 
 // -----------------------------------------------------------------------------
 
-void VirconDisassembler::DisassembleBranch( uint32_t ROMIndex )
+// Follows a path of execution, with conditional jumps kept in a
+// local list. Each instruction is claimed atomically, so that when
+// paths from several threads meet only the first one continues.
+// The resulting set of instructions is the same for any number of
+// threads, and also the same found by the old recursive method.
+void VirconDisassembler::ExploreFrom( uint32_t EntryIndex, ExplorationQueue& Queue )
 {
-    while( ROMIndex < ROM.size() )
+    vector< uint32_t > PendingPaths( 1, EntryIndex );
+    uint32_t ROMSize = ROM.size();
+    
+    while( !PendingPaths.empty() )
     {
-        // end branch as soon as some instruction was already visited
-        if( VisitedInstructions.find( ROMIndex ) != VisitedInstructions.end() )
-          return;
-        
-        // fetch the instruction
-        CPUInstruction Instruction = ROM[ ROMIndex ].AsInstruction;
-        V32Word ImmediateWord = {0};
+        uint32_t ROMIndex = PendingPaths.back();
+        PendingPaths.pop_back();
         
-        // add this location to the visited instructions
-        VisitedInstructions[ ROMIndex ] = Instruction;
-        ROMIndex++;
-        
-        // obtain immediate value, if it is used
-        if( Instruction.UsesImmediate )
+        while( ROMIndex < ROMSize )
         {
-            ImmediateWord = ROM[ ROMIndex ];
+            // end branch as soon as some instruction was already visited
+            uint8_t PreviousFlags = ROMWordFlags[ ROMIndex ].fetch_or( WordFlags::Instruction );
+            
+            if( PreviousFlags & WordFlags::Instruction )
+              break;
+            
+            // fetch the instruction
+            CPUInstruction Instruction = ROM[ ROMIndex ].AsInstruction;
+            V32Word ImmediateWord = {0};
+            uint32_t InstructionIndex = ROMIndex;
             ROMIndex++;
-        }
-        
-        // CASE 1: this branch has ended
-        if( IsEndOfBranch( Instruction ) )
-          return;
-        
-        // CASE 2: branching path for subroutine
-        if( IsSubroutineCall( Instruction ) && Instruction.UsesImmediate )
-        {
-            uint32_t DestinationROMIndex = ImmediateWord.AsInteger - InitialROMAddress;
-            JumpDestinationNames[ DestinationROMIndex ] = "";
             
-            // recurse into the a branch for the sub
-            DisassembleBranch( DestinationROMIndex );
-        }
-        
-        // CASE 3: direct jump (same branch, but continued elsewhere)
-        else if( IsInconditionalJump( Instruction ) && Instruction.UsesImmediate )
-        {
-            ROMIndex = ImmediateWord.AsInteger - InitialROMAddress;
-            JumpDestinationNames[ ROMIndex ] = "";
-        }
-        
-        // CASE 4: branching path for conditional jumps
-        else if( IsConditionalJump( Instruction ) && Instruction.UsesImmediate )
-        {
+            // obtain immediate value, if it is used
+            if( Instruction.UsesImmediate )
+            {
+                if( ROMIndex < ROMSize )
+                  ImmediateWord = ROM[ ROMIndex ];
+                
+                ROMIndex++;
+            }
+            
+            // CASE 1: this branch has ended
+            if( IsEndOfBranch( Instruction ) )
+              break;
+            
+            // jumps to registers can't be followed; as before,
+            // exploration just continues after them
+            bool IsJump = IsInconditionalJump( Instruction ) || IsConditionalJump( Instruction ) || IsSubroutineCall( Instruction );
+            
+            if( IsJump && !Instruction.UsesImmediate )
+              ROMWordFlags[ InstructionIndex ].fetch_or( WordFlags::IndirectJump );
+            
+            if( !IsJump || !Instruction.UsesImmediate )
+              continue;
+            
             uint32_t DestinationROMIndex = ImmediateWord.AsInteger - InitialROMAddress;
-            JumpDestinationNames[ DestinationROMIndex ] = "";
             
-            // recurse into the a branch for the sub
-            DisassembleBranch( DestinationROMIndex );
+            // CASE 2: a new function, for any thread to explore
+            if( IsSubroutineCall( Instruction ) )
+              MarkDestination( DestinationROMIndex, WordFlags::JumpTarget | WordFlags::FunctionEntry, &Queue );
+            
+            // CASE 3: direct jump (same branch, but continued elsewhere)
+            else if( IsInconditionalJump( Instruction ) )
+            {
+                MarkDestination( DestinationROMIndex, WordFlags::JumpTarget, nullptr );
+                ROMIndex = DestinationROMIndex;
+            }
+            
+            // CASE 4: branching path for conditional jumps
+            else
+            {
+                MarkDestination( DestinationROMIndex, WordFlags::JumpTarget, nullptr );
+                PendingPaths.push_back( DestinationROMIndex );
+            }
         }
-        
-        // for other instructions, just continue
     }
 }
 
 // -----------------------------------------------------------------------------
 
-void VirconDisassembler::Disassemble( ostream& Output, bool IncludeDescriptions )
+void VirconDisassembler::ExplorationWorker( ExplorationQueue& Queue )
+{
+    uint32_t EntryIndex;
+    
+    while( Queue.TakeEntry( EntryIndex ) )
+    {
+        ExploreFrom( EntryIndex, Queue );
+        Queue.EndEntry();
+    }
+}
+
+// -----------------------------------------------------------------------------
+
+void VirconDisassembler::Explore( int NumberOfThreads )
 {
+    if( ROM.empty() )
+      return;
+    
     // find all accessible branches from ROM start
     // (i.e. cartridge ROM index 0, that corresponds to address 0x20000000 at runtime)
-    DisassembleBranch( 0 );
+    ExplorationQueue Queue;
+    MarkDestination( 0, WordFlags::FunctionEntry, &Queue );
+    
+    // the calling thread works too
+    vector< thread > Workers;
     
+    for( int i = 1; i < NumberOfThreads; i++ )
+      Workers.emplace_back( &VirconDisassembler::ExplorationWorker, this, ref( Queue ) );
+    
+    ExplorationWorker( Queue );
+    
+    for( thread& Worker: Workers )
+      Worker.join();
+}
+
+// -----------------------------------------------------------------------------
+
+bool VirconDisassembler::IsInstruction( uint32_t ROMIndex ) const
+{
+    return ROMIndex < ROM.size() && (ROMWordFlags[ ROMIndex ] & WordFlags::Instruction);
+}
+
+// -----------------------------------------------------------------------------
+
+uint8_t VirconDisassembler::GetFlags( uint32_t ROMIndex ) const
+{
+    return (ROMIndex < ROM.size())? ROMWordFlags[ ROMIndex ].load() : 0;
+}
+
+
+// =============================================================================
+//      VIRCON DISASSEMBLER: WRITING THE LISTING
+// =============================================================================
+
+
+void VirconDisassembler::Disassemble( ostream& Output, bool IncludeDescriptions )
+{
     // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-    // now do a first pass to name all labels in order
+    // now do a first pass to name all labels in order;
+    // names from debug info are used when available
     uint32_t ROMIndex = 0;
     uint32_t ROMSize = ROM.size();
     int LabelNumber = 1;
-
+    JumpDestinationNames.clear();
+    
     while( ROMIndex < ROMSize )
     {
-        auto VJD = JumpDestinationNames.find( ROMIndex );
-        bool HasLabel = (VJD != JumpDestinationNames.end());
+        auto Imported = ImportedNames.find( ROMIndex );
         
-        if( HasLabel )
+        if( Imported != ImportedNames.end() )
+          JumpDestinationNames[ ROMIndex ] = Imported->second;
+        
+        else if( ROMWordFlags[ ROMIndex ] & WordFlags::JumpTarget )
         {
-            VJD->second = string("_label") + to_string( LabelNumber );
+            JumpDestinationNames[ ROMIndex ] = string("_label") + to_string( LabelNumber );
             LabelNumber++;
         }
         
@@ -286,6 +433,8 @@ void VirconDisassembler::Disassemble( ostream& Output, bool IncludeDescriptions
     
     // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
     // on second pass, actually output the results byte per byte
+    // (lines end with '\n' instead of endl, to avoid flushing
+    // the output on every line)
     
     ROMIndex = 0;
     bool PreviousIndexWasCode = true;
@@ -299,32 +448,35 @@ void VirconDisassembler::Disassemble( ostream& Output, bool IncludeDescriptions
         if( HasLabel )
         {
             // add the ROM position as a comment
-            Output << endl << "; ROM address " << Hex(InitialROMAddress + VJD->first, 8) << endl;
+            Output << '\n' << "; ROM address " << Hex(InitialROMAddress + VJD->first, 8) << '\n';
             
-            // write the label
-            Output << VJD->second << ":" << endl;
+            // add any imported description
+            auto Comment = ImportedComments.find( ROMIndex );
             
-            LabelNumber++;
+            if( Comment != ImportedComments.end() )
+              Output << "; " << Comment->second << '\n';
+            
+            // write the label
+            Output << VJD->second << ":" << '\n';
         }
         
         // check if there is an instruction here
-        auto VIns = VisitedInstructions.find( ROMIndex );
-        bool CurrentIndexIsCode = (VIns != VisitedInstructions.end());
+        bool CurrentIndexIsCode = IsInstruction( ROMIndex );
         
         // separate code sections from data sections
         if( !HasLabel )
           if( PreviousIndexWasCode != CurrentIndexIsCode )
-            Output << endl;
+            Output << '\n';
         
         // for instructions, write their disassembly
         // and optionally, a description of what they do
         if( CurrentIndexIsCode )
         {
-            CPUInstruction Instruction = VIns->second;
+            CPUInstruction Instruction = ROM[ ROMIndex ].AsInstruction;
             V32Word ImmediateValue = {0};
             ROMIndex++;
             
-            if( Instruction.UsesImmediate )
+            if( Instruction.UsesImmediate && ROMIndex < ROMSize )
             {
                 ImmediateValue = ROM[ ROMIndex ];
                 ROMIndex++;
@@ -332,7 +484,7 @@ void VirconDisassembler::Disassemble( ostream& Output, bool IncludeDescriptions
             
             Output << "  " << OpCodeToString( (InstructionOpCodes)Instruction.OpCode );
             Output << OperandWriteFunctions[ Instruction.OpCode ]( *this, Instruction, ImmediateValue );
-            Output << endl;
+            Output << '\n';
         }
         
         // otherwise keep writing integers as data
@@ -356,14 +508,13 @@ void VirconDisassembler::Disassemble( ostream& Output, bool IncludeDescriptions
                   break;
                 
                 // continue if next value is also data
-                VIns = VisitedInstructions.find( ROMIndex );
-                CurrentIndexIsCode = (VIns != VisitedInstructions.end());
+                CurrentIndexIsCode = IsInstruction( ROMIndex );
                 
                 if( CurrentIndexIsCode )
                   break;
             }
             
-            Output << endl;
+            Output << '\n';
         }
         
         PreviousIndexWasCode = CurrentIndexIsCode;
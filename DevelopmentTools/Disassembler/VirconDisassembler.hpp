@@ -17,9 +17,57 @@
     #include <string>       // [ C++ STL ] Strings
     #include <vector>       // [ C++ STL ] Vectors
     #include <map>          // [ C++ STL ] Maps
+    #include <atomic>       // [ C++ STL ] Atomic variables
+    #include <mutex>        // [ C++ STL ] Mutexes
+    #include <condition_variable>   // [ C++ STL ] Condition variables
 // *****************************************************************************
 
 
+// =============================================================================
+//      CLASSIFICATION OF ROM WORDS
+// =============================================================================
+
+
+// bit flags kept for every word in the ROM
+namespace WordFlags
+{
+    const uint8_t Instruction   = 1;    // an instruction starts here
+    const uint8_t JumpTarget    = 2;    // destination of any jump or call
+    const uint8_t FunctionEntry = 4;    // destination of a call (or ROM start)
+    const uint8_t IndirectJump  = 8;    // instruction jumps to a register
+}
+
+
+// =============================================================================
+//      SHARED LIST OF PENDING ENTRY POINTS
+// =============================================================================
+
+
+// Entry points found during exploration are queued here,
+// so that any free thread can take them. Workers finish
+// when the queue is empty and no one else is working
+// (since then no more entry points can appear).
+class ExplorationQueue
+{
+    protected:
+        
+        std::mutex QueueMutex;
+        std::condition_variable QueueChanged;
+        std::vector< uint32_t > PendingEntries;
+        int BusyWorkers;
+        
+    public:
+        
+        ExplorationQueue();
+        void Push( uint32_t ROMIndex );
+        
+        // returns false when all exploration is done;
+        // after a true return, call EndEntry when done
+        bool TakeEntry( uint32_t& ROMIndex );
+        void EndEntry();
+};
+
+
 // =============================================================================
 //      VIRCON DISASSEMBLER
 // =============================================================================
@@ -30,9 +78,14 @@ class VirconDisassembler
     public:
         
         // internal intermediate results
-        std::map< uint32_t, V32::CPUInstruction > VisitedInstructions;
+        std::vector< std::atomic< uint8_t > > ROMWordFlags;
         std::map< uint32_t, std::string > JumpDestinationNames;
         
+        // names imported from debug info, and
+        // descriptions to show at their positions
+        std::map< uint32_t, std::string > ImportedNames;
+        std::map< uint32_t, std::string > ImportedComments;
+        
     public:
         
         // results
@@ -40,17 +93,35 @@ class VirconDisassembler
         
     protected:
         
-        // partial disassembly function
-        void DisassembleBranch( uint32_t ROMIndex );
+        // exploration of code
+        void ExploreFrom( uint32_t ROMIndex, ExplorationQueue& Queue );
+        void ExplorationWorker( ExplorationQueue& Queue );
+        void MarkDestination( uint32_t ROMIndex, uint8_t Flags, ExplorationQueue* Queue );
         
     public:
         
         // main disassembly functions
         void LoadROM( const std::string& InputPath );
+        void Explore( int NumberOfThreads );
         void Disassemble( std::ostream& Output, bool IncludeDescriptions = false );
+        
+        // access to results
+        bool IsInstruction( uint32_t ROMIndex ) const;
+        uint8_t GetFlags( uint32_t ROMIndex ) const;
 };
 
 
+// =============================================================================
+//      INSTRUCTION CLASSIFICATION FUNCTIONS
+// =============================================================================
+
+
+bool IsInconditionalJump( const V32::CPUInstruction& Instruction );
+bool IsConditionalJump( const V32::CPUInstruction& Instruction );
+bool IsSubroutineCall( const V32::CPUInstruction& Instruction );
+bool IsEndOfBranch( const V32::CPUInstruction& Instruction );
+
+
 // *****************************************************************************
     // end include guard
     #endif
@@ -0,0 +1,13 @@
+// *****************************************************************************
+    // include project headers
+    #include "Globals.hpp"
+// *****************************************************************************
+
+
+// =============================================================================
+//      GLOBAL VARIABLES
+// =============================================================================
+
+
+// debug configuration
+bool VerboseMode = false;
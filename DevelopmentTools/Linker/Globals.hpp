@@ -0,0 +1,20 @@
+// *****************************************************************************
+    // start include guard
+    #ifndef GLOBALS_HPP
+    #define GLOBALS_HPP
+// *****************************************************************************
+
+
+// =============================================================================
+//      GLOBAL VARIABLES
+// =============================================================================
+
+
+// debug configuration
+extern bool VerboseMode;
+
+
+// *****************************************************************************
+    // end include guard
+    #endif
+// *****************************************************************************
@@ -0,0 +1,212 @@
+// *****************************************************************************
+    // include common Vircon headers
+    #include "../../VirconDefinitions/Constants.hpp"
+    #include "../../VirconDefinitions/FileFormats.hpp"
+    
+    // include infrastructure headers
+    #include "../DevToolsInfrastructure/FilePaths.hpp"
+    #include "../DevToolsInfrastructure/StringFunctions.hpp"
+    
+    // include project headers
+    #include "VirconLinker.hpp"
+    #include "Globals.hpp"
+    
+    // include external headers
+    #include <string>       // [ C++ STL ] Strings
+    #include <fstream>      // [ C++ STL ] File streams
+    #include <iostream>     // [ C++ STL ] I/O Streams
+    #include <vector>       // [ C++ STL ] Vectors
+    #include <cstring>      // [ ANSI C ] Strings
+    
+    // on Windows include headers for unicode conversion
+    #if defined(__WIN32__) || defined(_WIN32) || defined(_WIN64)
+      #define WINDOWS_OS
+      #include <windows.h>      // [ WINDOWS ] Main header
+      #include <shellapi.h>     // [ WINDOWS ] Shell API
+    #endif
+    
+    // declare used namespaces
+    using namespace std;
+    using namespace V32;
+// *****************************************************************************
+
+
+// =============================================================================
+//      AUXILIARY FUNCTIONS
+// =============================================================================
+
+
+void PrintUsage()
+{
+    cout << "USAGE: linkobjs [options] files" << endl;
+    cout << "Options:" << endl;
+    cout << "  --help       Displays this information" << endl;
+    cout << "  --version    Displays program version" << endl;
+    cout << "  -o <file>    Output file, default name is the same as first input" << endl;
+    cout << "  -v           Displays additional information (verbose)" << endl;
+    cout << "Input files are object files created with 'assemble -c'." << endl;
+    cout << "They are placed in the program in the order given." << endl;
+}
+
+// -----------------------------------------------------------------------------
+
+void PrintVersion()
+{
+    cout << "linkobjs v25.1.19" << endl;
+    cout << "Vircon32 object linker by Javier Carracedo" << endl;
+}
+
+
+// =============================================================================
+//      MAIN FUNCTION
+// =============================================================================
+
+
+int main( int NumberOfArguments, char* Arguments[] )
+{
+    try
+    {
+        // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+        // Process command line arguments
+        
+        // variables to capture input parameters
+        vector< string > InputPaths;
+        string OutputPath;
+        
+        // to treat arguments the same in any OS we
+        // will convert them to UTF-8 in all cases
+        vector< string > ArgumentsUTF8;
+        
+        #if defined(WINDOWS_OS)
+          
+          // on Windows we can't rely on the arguments received
+          // in main: ask Windows for the UTF-16 command line
+          wchar_t* CommandLineUTF16 = GetCommandLineW();
+          wchar_t** ArgumentsUTF16 = CommandLineToArgvW( CommandLineUTF16, &NumberOfArguments );
+          
+          // now convert every program argument to UTF-8
+          for( int i = 0; i < NumberOfArguments; i++ )
+            ArgumentsUTF8.push_back( ToUTF8( ArgumentsUTF16[i] ) );
+          
+          LocalFree( ArgumentsUTF16 );
+        
+        #else
+          
+          // on Linux/Mac arguments in main are already UTF-8
+          for( int i = 0; i < NumberOfArguments; i++ )
+            ArgumentsUTF8.push_back( Arguments[i] );
+        
+        #endif
+        
+        // process arguments
+        for( int i = 1; i < NumberOfArguments; i++ )
+        {
+            if( ArgumentsUTF8[i] == string("--help") )
+            {
+                PrintUsage();
+                return 0;
+            }
+            
+            if( ArgumentsUTF8[i] == string("--version") )
+            {
+                PrintVersion();
+                return 0;
+            }
+            
+            if( ArgumentsUTF8[i] == string("-v") )
+            {
+                VerboseMode = true;
+                continue;
+            }
+            
+            if( ArgumentsUTF8[i] == string("-o") )
+            {
+                // expect another argument
+                i++;
+                
+                if( i >= NumberOfArguments )
+                  throw runtime_error( "missing filename after '-o'" );
+                
+                // now we can safely read the input path
+                OutputPath = ArgumentsUTF8[ i ];
+                continue;
+            }
+            
+            // discard any other parameters starting with '-'
+            if( ArgumentsUTF8[i][0] == '-' )
+              throw runtime_error( string("unrecognized command line option '") + ArgumentsUTF8[i] + "'" );
+            
+            // any non-option parameter is taken as an input file
+            InputPaths.push_back( ArgumentsUTF8[i] );
+        }
+        
+        // check if input paths were given
+        if( InputPaths.empty() )
+          throw runtime_error( "no input files" );
+        
+        // if output path was not given, just
+        // replace the extension in the first input
+        if( OutputPath.empty() )
+        {
+            OutputPath = ReplaceFileExtension( InputPaths[ 0 ], "vbin" );
+            
+            if( VerboseMode )
+              cout << "using output path: \"" << OutputPath << "\"" << endl;
+        }
+        
+        // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+        
+        // simple compilation checks to ensure correct ROM creation
+        if( sizeof( CPUInstruction ) != 4 )
+          throw runtime_error( "ABI is incorrect: CPU instructions must be 4 bytes in size" );
+        
+        // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+        
+        // load all objects and link them
+        VirconLinker Linker;
+        
+        for( string& InputPath: InputPaths )
+          Linker.AddObjectFile( InputPath );
+        
+        Linker.Link();
+        
+        // open output file, in binary!
+        ofstream OutputFile;
+        OpenOutputFile( OutputFile, OutputPath, ios_base::out | ios_base::binary );
+        
+        if( OutputFile.fail() )
+          throw runtime_error( "cannot open output file \"" + OutputPath + "\"" );
+        
+        // create the VBIN file header
+        BinaryFileFormat::Header VBINHeader;
+        memcpy( VBINHeader.Signature, BinaryFileFormat::Signature, 8 );
+        VBINHeader.NumberOfWords = Linker.ROM.size();
+        
+        // write the header and then the whole ROM
+        OutputFile.write( (char*)(&VBINHeader), sizeof(BinaryFileFormat::Header) );
+        
+        if( !Linker.ROM.empty() )
+          OutputFile.write( (char*)(&Linker.ROM[0]), Linker.ROM.size() * 4 );
+        
+        OutputFile.close();
+        
+        // finally, report size of the produced ROM
+        if( VerboseMode )
+        {
+            cout << "output file created, size: " << Linker.ROM.size() << " dwords = " << Linker.ROM.size() * 4 << " bytes" << endl;
+            cout << "RAM used by variables: " << Linker.RAMSize << " dwords" << endl;
+        }
+    }
+    
+    catch( const exception& e )
+    {
+        cerr << "linkobjs: error: " << e.what() << endl;
+        return 1;
+    }
+    
+    // report success
+    if( VerboseMode )
+      cout << "linking successful" << endl;
+    
+    return 0;
+}
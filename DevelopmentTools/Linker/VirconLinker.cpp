@@ -0,0 +1,324 @@
+// *****************************************************************************
+    // include common Vircon headers
+    #include "../../VirconDefinitions/Constants.hpp"
+    #include "../../VirconDefinitions/Enumerations.hpp"
+    
+    // include project headers
+    #include "VirconLinker.hpp"
+    #include "Globals.hpp"
+    
+    // include infrastructure headers
+    #include "../DevToolsInfrastructure/StringFunctions.hpp"
+    
+    // include C/C++ headers
+    #include <iostream>     // [ C++ STL ] I/O Streams
+    #include <stdexcept>    // [ C++ STL ] Exceptions
+    #include <algorithm>    // [ C++ STL ] Algorithms
+    
+    // declare used namespaces
+    using namespace std;
+    using namespace V32;
+// *****************************************************************************
+
+
+// =============================================================================
+//      VIRCON LINKER: INSTANCE HANDLING
+// =============================================================================
+
+
+VirconLinker::VirconLinker()
+{
+    RAMSize = 0;
+}
+
+
+// =============================================================================
+//      VIRCON LINKER: INTERNAL STEPS
+// =============================================================================
+
+
+// names used by the C compiler for the start of a program
+const string MainFunctionName = "__function_main";
+const string GlobalsInitializationName = "__global_scope_initialization";
+
+// -----------------------------------------------------------------------------
+
+// Each C module has its own function to initialize its
+// globals, so the start section calls all of them in
+// order and then calls main, as the compiler would do.
+// Pure assembly programs just begin at the first module.
+void VirconLinker::CreateStartSection()
+{
+    ROM.clear();
+    
+    auto MainPair = SymbolDefinitions.find( MainFunctionName );
+    
+    if( MainPair == SymbolDefinitions.end() )
+      return;
+    
+    if( MainPair->second.size() > 1 )
+      throw runtime_error( "function \"main\" is defined in more than 1 module" );
+    
+    if( VerboseMode )
+      cout << "creating start section for main function" << endl;
+    
+    // we only need the instruction sizes here: target
+    // addresses are written once modules are placed
+    V32Word ImmediateWord = {0};
+    
+    for( LinkedModule& Module: Modules )
+    {
+        if( !Module.Object.FindSymbol( GlobalsInitializationName ) )
+          continue;
+        
+        V32Word CallWord = {0};
+        CallWord.AsInstruction.OpCode = (int)InstructionOpCodes::CALL;
+        CallWord.AsInstruction.UsesImmediate = 1;
+        ROM.push_back( CallWord );
+        ROM.push_back( ImmediateWord );
+    }
+    
+    V32Word CallMainWord = {0};
+    CallMainWord.AsInstruction.OpCode = (int)InstructionOpCodes::CALL;
+    CallMainWord.AsInstruction.UsesImmediate = 1;
+    ROM.push_back( CallMainWord );
+    ROM.push_back( ImmediateWord );
+    
+    V32Word HaltWord = {0};
+    HaltWord.AsInstruction.OpCode = (int)InstructionOpCodes::HLT;
+    ROM.push_back( HaltWord );
+}
+
+// -----------------------------------------------------------------------------
+
+void VirconLinker::ChooseSharedDefinitions()
+{
+    SharedDefinitions.clear();
+    
+    for( auto& Pair: SymbolDefinitions )
+    {
+        const string& Name = Pair.first;
+        const vector< int >& DefiningModules = Pair.second;
+        
+        // a non-shared definition takes priority over
+        // shared ones, but there can only be one
+        vector< int > NonSharedModules;
+        bool IsShared = false;
+        
+        for( int ModuleIndex: DefiningModules )
+        {
+            if( Modules[ ModuleIndex ].Object.FindSymbol( Name )->IsShared )
+              IsShared = true;
+            else
+              NonSharedModules.push_back( ModuleIndex );
+        }
+        
+        if( !IsShared )
+          continue;
+        
+        if( NonSharedModules.size() > 1 )
+          throw runtime_error
+          (
+              "symbol \"" + Name + "\" is shared, but it is also defined in \""
+              + Modules[ NonSharedModules[ 0 ] ].FilePath + "\" and \"" + Modules[ NonSharedModules[ 1 ] ].FilePath + "\""
+          );
+        
+        int ChosenModule = (NonSharedModules.empty()? DefiningModules[ 0 ] : NonSharedModules[ 0 ]);
+        const ObjectFile& ChosenObject = Modules[ ChosenModule ].Object;
+        int ChosenIndex = ChosenObject.FindSymbolIndex( Name );
+        
+        // all definitions need to be interchangeable
+        for( int ModuleIndex: DefiningModules )
+        {
+            const LinkedModule& Module = Modules[ ModuleIndex ];
+            int SymbolIndex = Module.Object.FindSymbolIndex( Name );
+            
+            bool SameSection = (Module.Object.Symbols[ SymbolIndex ].Section == ChosenObject.Symbols[ ChosenIndex ].Section);
+            bool SameSize = (Module.RAMVariableSizes[ SymbolIndex ] == Modules[ ChosenModule ].RAMVariableSizes[ ChosenIndex ]);
+            
+            if( !SameSection || !SameSize )
+              throw runtime_error
+              (
+                  "shared symbol \"" + Name + "\" has different definitions in \""
+                  + Modules[ ChosenModule ].FilePath + "\" and \"" + Module.FilePath + "\""
+              );
+        }
+        
+        SharedDefinitions[ Name ] = ChosenModule;
+    }
+}
+
+// -----------------------------------------------------------------------------
+
+void VirconLinker::PlaceModules()
+{
+    int32_t ROMAddress = Constants::CartridgeProgramROMFirstAddress + ROM.size();
+    RAMSize = 0;
+    
+    for( unsigned i = 0; i < Modules.size(); i++ )
+    {
+        LinkedModule& Module = Modules[ i ];
+        Module.ROMAddress = ROMAddress;
+        Module.RAMAddress = Constants::RAMFirstAddress + RAMSize;
+        Module.SymbolAddresses.assign( Module.Object.Symbols.size(), 0 );
+        
+        for( unsigned SymbolIndex = 0; SymbolIndex < Module.Object.Symbols.size(); SymbolIndex++ )
+        {
+            const ObjectSymbol& Symbol = Module.Object.Symbols[ SymbolIndex ];
+            
+            if( Symbol.Section == ObjectSections::ROM )
+              Module.SymbolAddresses[ SymbolIndex ] = ROMAddress + Symbol.Offset;
+        }
+        
+        // RAM is not reserved for shared variables
+        // when another module's definition is used
+        for( int SymbolIndex: Module.RAMVariables )
+        {
+            const ObjectSymbol& Symbol = Module.Object.Symbols[ SymbolIndex ];
+            
+            if( Symbol.IsShared && SharedDefinitions[ Symbol.Name ] != (int)i )
+              continue;
+            
+            Module.SymbolAddresses[ SymbolIndex ] = Constants::RAMFirstAddress + RAMSize;
+            RAMSize += Module.RAMVariableSizes[ SymbolIndex ];
+        }
+        
+        ROMAddress += Module.Object.Words.size();
+        
+        if( VerboseMode )
+          cout << "placed \"" << Module.FilePath << "\": ROM " << Hex( Module.ROMAddress, 8 )
+               << ", RAM " << Hex( Module.RAMAddress, 8 ) << endl;
+    }
+    
+    // check that the program fits in the console
+    if( (ROMAddress - Constants::CartridgeProgramROMFirstAddress) > Constants::MaximumCartridgeProgramROM )
+      throw runtime_error( "linked program is too large to fit in a cartridge" );
+    
+    if( RAMSize > Constants::RAMSize )
+      throw runtime_error( "variables in linked modules exceed the available RAM" );
+}
+
+// -----------------------------------------------------------------------------
+
+int32_t VirconLinker::GetSymbolAddress( int ModuleIndex, const string& Name )
+{
+    // shared symbols always use the chosen definition
+    int DefiningModule = ModuleIndex;
+    auto SharedPair = SharedDefinitions.find( Name );
+    
+    if( SharedPair != SharedDefinitions.end() )
+      DefiningModule = SharedPair->second;
+    
+    // other references within a module take priority,
+    // which keeps internal labels of each module apart
+    int SymbolIndex = Modules[ DefiningModule ].Object.FindSymbolIndex( Name );
+    
+    if( SymbolIndex < 0 )
+    {
+        auto Pair = SymbolDefinitions.find( Name );
+        
+        if( Pair == SymbolDefinitions.end() )
+          throw runtime_error( "in \"" + Modules[ ModuleIndex ].FilePath + "\": undefined reference to \"" + Name + "\"" );
+        
+        if( Pair->second.size() > 1 )
+          throw runtime_error
+          (
+              "in \"" + Modules[ ModuleIndex ].FilePath + "\": reference to \"" + Name + "\" is ambiguous, it is defined in \""
+              + Modules[ Pair->second[ 0 ] ].FilePath + "\" and \"" + Modules[ Pair->second[ 1 ] ].FilePath + "\""
+          );
+        
+        DefiningModule = Pair->second[ 0 ];
+        SymbolIndex = Modules[ DefiningModule ].Object.FindSymbolIndex( Name );
+    }
+    
+    return Modules[ DefiningModule ].SymbolAddresses[ SymbolIndex ];
+}
+
+
+// =============================================================================
+//      VIRCON LINKER: MAIN LINKING FUNCTIONS
+// =============================================================================
+
+
+void VirconLinker::AddObjectFile( const string& FilePath )
+{
+    if( VerboseMode )
+      cout << "loading object file \"" << FilePath << "\"" << endl;
+    
+    Modules.emplace_back();
+    LinkedModule& Module = Modules.back();
+    Module.FilePath = FilePath;
+    Module.Object.Load( FilePath );
+    
+    // register all symbols defined in the module
+    int ModuleIndex = Modules.size() - 1;
+    const vector< ObjectSymbol >& Symbols = Module.Object.Symbols;
+    
+    for( unsigned i = 0; i < Symbols.size(); i++ )
+    {
+        SymbolDefinitions[ Symbols[ i ].Name ].push_back( ModuleIndex );
+        
+        if( Symbols[ i ].Section == ObjectSections::RAM )
+          Module.RAMVariables.push_back( i );
+    }
+    
+    // RAM variables were placed consecutively, so each
+    // one takes the words until the next one begins
+    sort
+    (
+        Module.RAMVariables.begin(), Module.RAMVariables.end(),
+        [ &Symbols ]( int S1, int S2 ){ return Symbols[ S1 ].Offset < Symbols[ S2 ].Offset; }
+    );
+    
+    Module.RAMVariableSizes.assign( Symbols.size(), 0 );
+    
+    for( unsigned i = 0; i < Module.RAMVariables.size(); i++ )
+    {
+        int SymbolIndex = Module.RAMVariables[ i ];
+        bool IsLast = (i + 1 == Module.RAMVariables.size());
+        int32_t NextOffset = (IsLast? Module.Object.RAMSize : Symbols[ Module.RAMVariables[ i + 1 ] ].Offset);
+        Module.RAMVariableSizes[ SymbolIndex ] = NextOffset - Symbols[ SymbolIndex ].Offset;
+    }
+}
+
+// -----------------------------------------------------------------------------
+
+void VirconLinker::Link()
+{
+    if( Modules.empty() )
+      throw runtime_error( "no object files to link" );
+    
+    // first determine all addresses
+    ChooseSharedDefinitions();
+    CreateStartSection();
+    PlaceModules();
+    
+    // complete the start section, if any
+    if( !ROM.empty() )
+    {
+        int Position = 0;
+        
+        for( unsigned i = 0; i < Modules.size(); i++ )
+        {
+            if( !Modules[ i ].Object.FindSymbol( GlobalsInitializationName ) )
+              continue;
+            
+            ROM[ Position + 1 ].AsInteger = GetSymbolAddress( i, GlobalsInitializationName );
+            Position += 2;
+        }
+        
+        // main must be unique, so any module can resolve it
+        ROM[ Position + 1 ].AsInteger = GetSymbolAddress( SymbolDefinitions[ MainFunctionName ][ 0 ], MainFunctionName );
+    }
+    
+    // now add each module, resolving its relocations
+    for( unsigned i = 0; i < Modules.size(); i++ )
+    {
+        ObjectFile& Object = Modules[ i ].Object;
+        
+        for( const ObjectRelocation& Relocation: Object.Relocations )
+          Object.Words[ Relocation.WordOffset ].AsInteger += GetSymbolAddress( i, Relocation.SymbolName );
+        
+        ROM.insert( ROM.end(), Object.Words.begin(), Object.Words.end() );
+    }
+}
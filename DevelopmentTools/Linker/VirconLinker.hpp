@@ -0,0 +1,98 @@
+// *****************************************************************************
+    // start include guard
+    #ifndef VIRCONLINKER_HPP
+    #define VIRCONLINKER_HPP
+    
+    // include common Vircon headers
+    #include "../../VirconDefinitions/DataStructures.hpp"
+    
+    // include infrastructure headers
+    #include "../DevToolsInfrastructure/ObjectFiles.hpp"
+    
+    // include C/C++ headers
+    #include <string>       // [ C++ STL ] Strings
+    #include <vector>       // [ C++ STL ] Vectors
+    #include <unordered_map>    // [ C++ STL ] Unordered maps
+// *****************************************************************************
+
+
+// =============================================================================
+//      AUXILIARY DEFINITIONS
+// =============================================================================
+
+
+// an object file being linked, and where it is placed
+class LinkedModule
+{
+    public:
+        
+        std::string FilePath;
+        ObjectFile Object;
+        int32_t ROMAddress;
+        int32_t RAMAddress;
+        
+        // RAM variables in their original order, with
+        // the number of words taken by each of them
+        std::vector< int > RAMVariables;
+        std::vector< int32_t > RAMVariableSizes;
+        
+        // final address for each symbol in the object
+        std::vector< int32_t > SymbolAddresses;
+};
+
+
+// =============================================================================
+//      VIRCON LINKER
+// =============================================================================
+
+
+// Modules are placed in ROM in the same order they are
+// given, and their RAM variables are also placed in order.
+// A reference is resolved to a symbol in the same module if
+// it exists; otherwise exactly 1 other module must define it.
+// Shared symbols (like globals and functions in C headers) can
+// be defined by several modules: all references then go to a
+// single definition, and RAM is only reserved for that one.
+// When linking C programs, the linker creates a start section
+// that initializes globals in all modules and then calls main.
+
+class VirconLinker
+{
+    protected:
+        
+        // modules to link
+        std::vector< LinkedModule > Modules;
+        
+        // for each symbol name, the modules defining it
+        std::unordered_map< std::string, std::vector< int > > SymbolDefinitions;
+        
+        // for each shared symbol, the module whose definition is used
+        std::unordered_map< std::string, int > SharedDefinitions;
+        
+        // internal steps of linking
+        void ChooseSharedDefinitions();
+        void CreateStartSection();
+        void PlaceModules();
+        int32_t GetSymbolAddress( int ModuleIndex, const std::string& Name );
+        
+    public:
+        
+        // results
+        std::vector< V32::V32Word > ROM;
+        int32_t RAMSize;
+        
+    public:
+        
+        // instance handling
+        VirconLinker();
+        
+        // main linking functions
+        void AddObjectFile( const std::string& FilePath );
+        void Link();
+};
+
+
+// *****************************************************************************
+    // end include guard
+    #endif
+// *****************************************************************************
@@ -4,6 +4,7 @@
     
     // include infrastructure headers
     #include "../DevToolsInfrastructure/FilePaths.hpp"
+    #include "../DevToolsInfrastructure/StringFunctions.hpp"
     
     // include libpng headers
     #include <png.h>
@@ -13,6 +14,12 @@
     #include <string>       // [ C++ STL ] Strings
     #include <stdexcept>    // [ C++ STL ] Exceptions
     #include <vector>       // [ C++ STL ] Vectors
+    #include <algorithm>    // [ C++ STL ] Algorithms
+    #include <filesystem>   // [ C++ STL ] File system
+    #include <thread>       // [ C++ STL ] Threads
+    #include <mutex>        // [ C++ STL ] Mutexes
+    #include <atomic>       // [ C++ STL ] Atomics
+    #include <chrono>       // [ C++ STL ] Time
     #include <cstring>      // [ ANSI C ] Strings
     
     // on Windows include headers for unicode conversion
@@ -41,15 +48,23 @@ bool VerboseMode = false;
 // =============================================================================
 
 
-// use global variables to communicate the load and save functions
-int ImageWidth = 0, ImageHeight = 0;
-png_byte ColorType;
-png_byte BitDepth;
-png_bytep *RowPointers = nullptr;
+// Pixels of a loaded image. They are stored contiguously
+// in RGBA order, which is the same layout used in VTEX
+// files, so they can be saved without any conversion.
+// Buffers are kept when loading more images, so that
+// batch conversions don't need to allocate them again.
+class TextureImage
+{
+    public:
+        
+        int Width, Height;
+        vector< png_byte > Pixels;
+        vector< png_bytep > RowPointers;
+};
 
 // -----------------------------------------------------------------------------
 
-void LoadPNG( const char *PNGFilePath )
+void LoadPNG( const string& PNGFilePath, TextureImage& Image )
 {
     // open input file
     FILE *PNGFile = OpenInputFile( PNGFilePath );
@@ -61,30 +76,38 @@ void LoadPNG( const char *PNGFilePath )
     png_structp PNGHandler = png_create_read_struct( PNG_LIBPNG_VER_STRING, nullptr, nullptr, nullptr );
     
     if(!PNGHandler)
-      throw runtime_error( "cannot allocate PNG handler structure" );
-
+    {
+        fclose( PNGFile );
+        throw runtime_error( "cannot allocate PNG handler structure" );
+    }
+    
     png_infop PNGInfo = png_create_info_struct( PNGHandler );
     
     if(!PNGInfo)
-      throw runtime_error( "cannot allocate PNG information structure" );
+    {
+        png_destroy_read_struct( &PNGHandler, nullptr, nullptr );
+        fclose( PNGFile );
+        throw runtime_error( "cannot allocate PNG information structure" );
+    }
     
-    // define a callback function expected by libpng for error handling
+    // libpng will return here on any error; clean-up
+    // is needed since batch mode continues with other files
     if( setjmp( png_jmpbuf( PNGHandler ) ) )
-      throw runtime_error( "cannot define an error callback for PNG loading functions" );
+    {
+        png_destroy_read_struct( &PNGHandler, &PNGInfo, nullptr );
+        fclose( PNGFile );
+        throw runtime_error( string("cannot read PNG data from input file \"") + PNGFilePath + "\"" );
+    }
     
     // read basic information into the structures we created
     png_init_io( PNGHandler, PNGFile );
     png_read_info( PNGHandler, PNGInfo );
     
     // extract their basic fields using the premade functions
-    ImageWidth  = png_get_image_width ( PNGHandler, PNGInfo );
-    ImageHeight = png_get_image_height( PNGHandler, PNGInfo );
-    ColorType   = png_get_color_type  ( PNGHandler, PNGInfo );
-    BitDepth    = png_get_bit_depth   ( PNGHandler, PNGInfo );
-    
-    // start conversion phase
-    if( VerboseMode )
-      cout << "converting image to Vircon format" << endl;
+    Image.Width = png_get_image_width ( PNGHandler, PNGInfo );
+    Image.Height = png_get_image_height( PNGHandler, PNGInfo );
+    png_byte ColorType = png_get_color_type( PNGHandler, PNGInfo );
+    png_byte BitDepth = png_get_bit_depth( PNGHandler, PNGInfo );
     
     // Read any ColorType into 8bit depth, VTEX format
     if( BitDepth == 16 )
@@ -113,14 +136,16 @@ void LoadPNG( const char *PNGFilePath )
     
     png_read_update_info( PNGHandler, PNGInfo );
     
-    // save pointers for each row in the image
-    RowPointers = (png_bytep*)malloc( sizeof(png_bytep) * ImageHeight );
+    // all rows are read into a single buffer
+    size_t RowBytes = png_get_rowbytes( PNGHandler, PNGInfo );
+    Image.Pixels.resize( RowBytes * Image.Height );
+    Image.RowPointers.resize( Image.Height );
     
-    for( int y = 0; y < ImageHeight; y++ )
-      RowPointers[y] = (png_byte*)malloc( png_get_rowbytes(PNGHandler, PNGInfo) );
+    for( int y = 0; y < Image.Height; y++ )
+      Image.RowPointers[ y ] = &Image.Pixels[ y * RowBytes ];
     
-    // now read the actual pixel data for each row??
-    png_read_image( PNGHandler, RowPointers );
+    // now read the actual pixel data for each row
+    png_read_image( PNGHandler, Image.RowPointers.data() );
 
     // clean-up
     fclose( PNGFile );
@@ -129,7 +154,7 @@ void LoadPNG( const char *PNGFilePath )
 
 // -----------------------------------------------------------------------------
 
-void SaveVTEX( const char *VTEXFilePath )
+void SaveVTEX( const string& VTEXFilePath, const TextureImage& Image )
 {
     // open output file
     FILE *VTEXFile = OpenOutputFile( VTEXFilePath );
@@ -140,19 +165,137 @@ void SaveVTEX( const char *VTEXFilePath )
     // create the VTEX file header
     TextureFileFormat::Header VTEXHeader;
     memcpy( VTEXHeader.Signature, TextureFileFormat::Signature, 8 );
-    VTEXHeader.TextureWidth = ImageWidth;
-    VTEXHeader.TextureHeight = ImageHeight;
+    VTEXHeader.TextureWidth = Image.Width;
+    VTEXHeader.TextureHeight = Image.Height;
     
     // write the header in the file
     fseek( VTEXFile, 0, SEEK_SET );
     fwrite( &VTEXHeader, sizeof(TextureFileFormat::Header), 1, VTEXFile );
     
-    // now write every row of pixels
-    for( int y = 0; y < ImageHeight; y++ )
-      fwrite( RowPointers[ y ], ImageWidth*4, 1, VTEXFile );
+    // now write all pixels at once
+    size_t PixelBytes = (size_t)Image.Width * Image.Height * 4;
+    
+    if( PixelBytes > 0 )
+      fwrite( Image.Pixels.data(), PixelBytes, 1, VTEXFile );
     
     // clean-up
+    bool WriteFailed = ferror( VTEXFile );
     fclose( VTEXFile );
+    
+    if( WriteFailed )
+      throw runtime_error( string("cannot write output file \"") + VTEXFilePath + "\"" );
+}
+
+
+// =============================================================================
+//      BATCH CONVERSION
+// =============================================================================
+
+
+class BatchFile
+{
+    public:
+        
+        string InputPath;
+        string OutputPath;
+        
+        // results of the conversion
+        string Error;
+        uint64_t ConvertedPixels;
+};
+
+// -----------------------------------------------------------------------------
+
+// inputs can be files or folders; for folders
+// all PNG files inside them are converted
+void AddBatchInput( const string& InputPath, const string& OutputFolder, vector< BatchFile >& Files )
+{
+    filesystem::path InputFSPath = filesystem::u8path( InputPath );
+    vector< string > InputFiles;
+    
+    if( filesystem::is_directory( InputFSPath ) )
+    {
+        for( auto const& DirEntry : filesystem::directory_iterator{ InputFSPath } )
+          if( DirEntry.is_regular_file() && ToLowerCase( DirEntry.path().extension().string() ) == ".png" )
+            InputFiles.push_back( DirEntry.path().u8string() );
+        
+        // iteration order is not defined
+        sort( InputFiles.begin(), InputFiles.end() );
+    }
+    
+    else InputFiles.push_back( InputPath );
+    
+    // outputs are next to each input, unless
+    // an output folder was given for all of them
+    for( const string& InputFile: InputFiles )
+    {
+        BatchFile File;
+        File.InputPath = InputFile;
+        File.ConvertedPixels = 0;
+        
+        if( OutputFolder.empty() )
+          File.OutputPath = ReplaceFileExtension( InputFile, "vtex" );
+        else
+          File.OutputPath = ReplaceFileExtension( OutputFolder + PathSeparator + GetPathFileName( InputFile ), "vtex" );
+        
+        Files.push_back( File );
+    }
+}
+
+// -----------------------------------------------------------------------------
+
+// files are converted by a number of threads,
+// each of them taking the next pending file
+void ConvertBatch( vector< BatchFile >& Files, int NumberOfThreads )
+{
+    atomic< size_t > NextFile( 0 );
+    mutex OutputMutex;
+    
+    auto ConvertPendingFiles = [ & ]()
+    {
+        // each thread reuses its own buffers
+        TextureImage Image;
+        
+        while( true )
+        {
+            size_t FileIndex = NextFile++;
+            
+            if( FileIndex >= Files.size() )
+              return;
+            
+            BatchFile& File = Files[ FileIndex ];
+            
+            try
+            {
+                LoadPNG( File.InputPath, Image );
+                SaveVTEX( File.OutputPath, Image );
+                File.ConvertedPixels = (uint64_t)Image.Width * Image.Height;
+            }
+            
+            catch( const exception& e )
+            {
+                File.Error = e.what();
+                continue;
+            }
+            
+            if( VerboseMode )
+            {
+                lock_guard< mutex > Lock( OutputMutex );
+                cout << "converted \"" << File.InputPath << "\" to \"" << File.OutputPath << "\"" << endl;
+            }
+        }
+    };
+    
+    // the calling thread also converts files
+    vector< thread > Workers;
+    
+    for( int i = 1; i < NumberOfThreads && i < (int)Files.size(); i++ )
+      Workers.emplace_back( ConvertPendingFiles );
+    
+    ConvertPendingFiles();
+    
+    for( thread& Worker: Workers )
+      Worker.join();
 }
 
 
@@ -164,10 +307,14 @@ void SaveVTEX( const char *VTEXFilePath )
 void PrintUsage()
 {
     cout << "USAGE: png2vircon [options] file" << endl;
+    cout << "       png2vircon -b [options] files/folders" << endl;
     cout << "Options:" << endl;
     cout << "  --help       Displays this information" << endl;
     cout << "  --version    Displays program version" << endl;
     cout << "  -o <file>    Output file, default name is the same as input" << endl;
+    cout << "               (in batch mode, output folder for all files)" << endl;
+    cout << "  -b           Batch mode: converts many files, or all PNG files in folders" << endl;
+    cout << "  -j <jobs>    Number of files to convert in parallel (batch mode)" << endl;
     cout << "  -v           Displays additional information (verbose)" << endl;
 }
 
@@ -194,6 +341,9 @@ int main( int NumberOfArguments, char* Arguments[] )
         
         // variables to capture input parameters
         string InputPath, OutputPath;
+        vector< string > BatchInputs;
+        bool BatchMode = false;
+        int Jobs = thread::hardware_concurrency();
         
         // to treat arguments the same in any OS we
         // will convert them to UTF-8 in all cases
@@ -241,6 +391,36 @@ int main( int NumberOfArguments, char* Arguments[] )
                 continue;
             }
             
+            if( ArgumentsUTF8[i] == string("-b") )
+            {
+                BatchMode = true;
+                continue;
+            }
+            
+            if( ArgumentsUTF8[i] == string("-j") )
+            {
+                // expect another argument
+                i++;
+                
+                if( i >= NumberOfArguments )
+                  throw runtime_error( "missing number after '-j'" );
+                
+                // try to parse an integer from jobs argument
+                try
+                {
+                    Jobs = stoi( ArgumentsUTF8[ i ] );
+                }
+                catch( const exception& e )
+                {
+                    throw runtime_error( "cannot read number of jobs as an integer" );
+                }
+                
+                if( Jobs < 1 )
+                  throw runtime_error( "number of jobs must be at least 1" );
+                
+                continue;
+            }
+            
             if( ArgumentsUTF8[i] == string("-o") )
             {
                 // expect another argument
@@ -258,19 +438,69 @@ int main( int NumberOfArguments, char* Arguments[] )
             if( ArgumentsUTF8[i][0] == '-' )
               throw runtime_error( string("unrecognized command line option '") + ArgumentsUTF8[i] + "'" );
             
-            // any non-option parameter is taken as the input file
-            if( InputPath.empty() )
-              InputPath = ArgumentsUTF8[i];
-            
-            // only a single input file is supported!
-            else
-              throw runtime_error( "too many input files, only 1 is supported" );
+            // any non-option parameter is taken as an input
+            BatchInputs.push_back( ArgumentsUTF8[i] );
         }
         
         // check if an input path was given
-        if( InputPath.empty() )
+        if( BatchInputs.empty() )
           throw runtime_error( "no input file" );
         
+        // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+        // In batch mode convert all files and report throughput
+        
+        if( BatchMode )
+        {
+            vector< BatchFile > Files;
+            
+            for( const string& BatchInput: BatchInputs )
+              AddBatchInput( BatchInput, OutputPath, Files );
+            
+            if( Jobs < 1 )
+              Jobs = 1;
+            
+            auto StartTime = chrono::steady_clock::now();
+            ConvertBatch( Files, Jobs );
+            auto EndTime = chrono::steady_clock::now();
+            
+            // report all errors, not only the first one
+            uint64_t TotalPixels = 0;
+            int FailedFiles = 0;
+            
+            for( BatchFile& File: Files )
+            {
+                if( !File.Error.empty() )
+                {
+                    cerr << "png2vircon: error: " << File.Error << endl;
+                    FailedFiles++;
+                }
+                
+                TotalPixels += File.ConvertedPixels;
+            }
+            
+            if( VerboseMode )
+            {
+                double Seconds = chrono::duration< double >( EndTime - StartTime ).count();
+                double Megapixels = TotalPixels / 1000000.0;
+                cout << "converted " << (Files.size() - FailedFiles) << " files, " << Megapixels << " megapixels in ";
+                cout << Seconds << " s (" << (Seconds > 0? Megapixels / Seconds : 0) << " megapixels/s)" << endl;
+            }
+            
+            if( FailedFiles > 0 )
+              throw runtime_error( to_string( FailedFiles ) + " of " + to_string( Files.size() ) + " files could not be converted" );
+            
+            if( VerboseMode )
+              cout << "conversion successful" << endl;
+            
+            return 0;
+        }
+        
+        // only a single input file is supported!
+        if( BatchInputs.size() > 1 )
+          throw runtime_error( "too many input files, only 1 is supported (use -b for batch mode)" );
+        
+        InputPath = BatchInputs[ 0 ];
+        
         // if output path was not given, just
         // replace the extension in the input
         if( OutputPath.empty() )
@@ -287,7 +517,11 @@ int main( int NumberOfArguments, char* Arguments[] )
         if( VerboseMode )
           cout << "loading input file \"" << InputPath << "\"" << endl;
         
-        LoadPNG( InputPath.c_str() );
+        if( VerboseMode )
+          cout << "converting image to Vircon format" << endl;
+        
+        TextureImage Image;
+        LoadPNG( InputPath, Image );
         
         // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
         // STEP 2: Save the VTEX file
@@ -296,7 +530,7 @@ int main( int NumberOfArguments, char* Arguments[] )
         if( VerboseMode )
           cout << "saving output file \"" << OutputPath << "\"" << endl;
         
-        SaveVTEX( OutputPath.c_str() );
+        SaveVTEX( OutputPath, Image );
     }
     
     catch( const exception& e )
@@ -305,12 +539,6 @@ int main( int NumberOfArguments, char* Arguments[] )
         return 1;
     }
     
-    // perform clean-up
-    for( int y = 0; y < ImageHeight; y++ )
-      free( RowPointers[ y ] );
-    
-    free( RowPointers );
-    
     // report success
     if( VerboseMode )
       cout << "conversion successful" << endl;
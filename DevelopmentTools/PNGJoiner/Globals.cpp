@@ -29,7 +29,7 @@ float HotspotProportionY = 0;
 // working objects
 list< PNGImage > LoadedImages;
 list< PNGImage* > SortedImages;
-RectangleNode TextureRectangle;
+TexturePacker Packer;
 
 
 // =============================================================================
@@ -37,39 +37,18 @@ RectangleNode TextureRectangle;
 // =============================================================================
 
 
-// traverses rectangle partitions to find where
-// a particular image was placed by the algorithm
-RectangleNode* FindImageRectangle( PNGImage* Image, RectangleNode* BaseRectangle )
-{
-    if( BaseRectangle->Part1 )
-    {
-        RectangleNode* Result1 = FindImageRectangle( Image, BaseRectangle->Part1 );
-        RectangleNode* Result2 = FindImageRectangle( Image, BaseRectangle->Part2 );
-        return (Result1? Result1 : Result2);
-    }
-    
-    if( BaseRectangle->PlacedImage == Image )
-      return BaseRectangle;
-    
-    else return nullptr;
-}
-
-// -----------------------------------------------------------------------------
-
 void ExportSingleRegion( PNGImage& Image, ofstream& XMLFile )
 {
-    // find where this image was placed
-    RectangleNode* ImagePlacement = FindImageRectangle( &Image, &TextureRectangle );
-    
-    if( !ImagePlacement )
+    // check that this image was placed
+    if( Image.PlacedX < 0 )
       throw runtime_error( "Cannot find rectangle where image was placed" );
     
     // determine basic properties
-    int MinX = ImagePlacement->MinX;
+    int MinX = Image.PlacedX;
     int MaxX = MinX + Image.Width - 1;
     int HotspotX = MinX + (Image.Width-1) * HotspotProportionX;
     
-    int MinY = ImagePlacement->MinY;
+    int MinY = Image.PlacedY;
     int MaxY = MinY + Image.Height - 1;
     int HotspotY = MinY + (Image.Height-1) * HotspotProportionY;
     
@@ -89,10 +68,8 @@ void ExportSingleRegion( PNGImage& Image, ofstream& XMLFile )
 
 void ExportRegionMatrix( PNGImage& Image, ofstream& XMLFile )
 {
-    // find where this image was placed
-    RectangleNode* ImagePlacement = FindImageRectangle( &Image, &TextureRectangle );
-    
-    if( !ImagePlacement )
+    // check that this image was placed
+    if( Image.PlacedX < 0 )
       throw runtime_error( "Cannot find rectangle where image was placed" );
     
     // determine single region properties
@@ -100,11 +77,11 @@ void ExportRegionMatrix( PNGImage& Image, ofstream& XMLFile )
     int RegionHeight = (Image.Height - (Image.TilesY-1) * Image.TilesGap) / Image.TilesY;
     
     // determine basic properties
-    int MinX = ImagePlacement->MinX;
+    int MinX = Image.PlacedX;
     int MaxX = MinX + RegionWidth - 1;
     int HotspotX = MinX + (RegionWidth-1) * HotspotProportionX;
     
-    int MinY = ImagePlacement->MinY;
+    int MinY = Image.PlacedY;
     int MaxY = MinY + RegionHeight - 1;
     int HotspotY = MinY + (RegionHeight-1) * HotspotProportionY;
     
@@ -5,7 +5,7 @@
     
     // include project headers
     #include "PNGImage.hpp"
-    #include "RectangleNode.hpp"
+    #include "TexturePacker.hpp"
     
     // include C/C++ headers
     #include <string>       // [ C++ STL ] Strings
@@ -27,7 +27,7 @@ extern float HotspotProportionY;
 // working objects
 extern std::list< PNGImage > LoadedImages;
 extern std::list< PNGImage* > SortedImages;
-extern RectangleNode TextureRectangle;
+extern TexturePacker Packer;
 
 
 // =============================================================================
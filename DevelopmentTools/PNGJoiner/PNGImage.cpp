@@ -33,6 +33,7 @@ PNGImage::PNGImage()
     TilesX = TilesY = 1;
     TilesGap = 0;
     RowPixels = nullptr;
+    PlacedX = PlacedY = -1;
 }
 
 // -----------------------------------------------------------------------------
@@ -46,6 +47,8 @@ PNGImage::PNGImage( const PNGImage& Copied )
     TilesX = Copied.TilesX;
     TilesY = Copied.TilesY;
     TilesGap = Copied.TilesGap;
+    PlacedX = Copied.PlacedX;
+    PlacedY = Copied.PlacedY;
     
     // recursively copy children
     RowPixels = nullptr;
@@ -31,6 +31,10 @@ class PNGImage
         // pixel data
         uint8_t** RowPixels;
         
+        // top-left position in the joined texture
+        // (both are -1 until the image is placed)
+        int PlacedX, PlacedY;
+        
     public:
     
         // auxiliary functions
@@ -5,7 +5,7 @@
     
     // include project headers
     #include "PNGImage.hpp"
-    #include "RectangleNode.hpp"
+    #include "TexturePacker.hpp"
     #include "Globals.hpp"
     
     // include C/C++ headers
@@ -262,12 +262,6 @@ int main( int NumberOfArguments, char* Arguments[] )
         if( VerboseMode )
           cout << "running the join algorithm" << endl;
         
-        // extend texture with the separation gap
-        // at bottom and right, so that the actual
-        // usable area is still the same
-        TextureRectangle.MaxX += GapBetweenImages;
-        TextureRectangle.MaxY += GapBetweenImages;
-        
         // run the algorithm to place all images
         PlaceAllImages();
         
@@ -279,13 +273,13 @@ int main( int NumberOfArguments, char* Arguments[] )
         
         // create an empty image to hold all subimages
         int MaxUsedX, MaxUsedY;
-        TextureRectangle.GetContentsLimit( MaxUsedX, MaxUsedY );
+        Packer.GetContentsLimit( MaxUsedX, MaxUsedY );
         
         PNGImage TextureImage;
         TextureImage.CreateEmpty( (MaxUsedX+1) - GapBetweenImages, (MaxUsedY+1) - GapBetweenImages );
         
         // copy all subimages into the output image and save it
-        CreateOutputImage( TextureImage, TextureRectangle );
+        CreateOutputImage( TextureImage );
         TextureImage.SaveToFile( OutputFile );
         
         // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
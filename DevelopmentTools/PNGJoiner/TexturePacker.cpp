@@ -0,0 +1,296 @@
+// *****************************************************************************
+    // include Vircon common headers
+    #include "../../VirconDefinitions/Constants.hpp"
+    
+    // include project headers
+    #include "TexturePacker.hpp"
+    #include "Globals.hpp"
+    
+    // include C/C++ headers
+    #include <stdexcept>    // [ C++ STL ] Exceptions
+    #include <algorithm>    // [ C++ STL ] Algorithms
+    
+    // declare used namespaces
+    using namespace std;
+    using namespace V32;
+// *****************************************************************************
+
+
+// =============================================================================
+//      RECTANGLES WITHIN THE TEXTURE
+// =============================================================================
+
+
+bool PackingRectangle::Contains( const PackingRectangle& Other ) const
+{
+    return Other.MinX >= MinX && Other.MaxX <= MaxX
+        && Other.MinY >= MinY && Other.MaxY <= MaxY;
+}
+
+// -----------------------------------------------------------------------------
+
+bool PackingRectangle::Intersects( const PackingRectangle& Other ) const
+{
+    return Other.MinX <= MaxX && Other.MaxX >= MinX
+        && Other.MinY <= MaxY && Other.MaxY >= MinY;
+}
+
+
+// =============================================================================
+//      TEXTURE PACKER: INSTANCE HANDLING
+// =============================================================================
+
+
+TexturePacker::TexturePacker()
+{
+    Initialize( Constants::GPUTextureSize, Constants::GPUTextureSize );
+}
+
+// -----------------------------------------------------------------------------
+
+void TexturePacker::Initialize( int TextureWidth, int TextureHeight )
+{
+    // the whole texture starts as a single free rectangle
+    PackingRectangle WholeTexture;
+    WholeTexture.MinX = WholeTexture.MinY = 0;
+    WholeTexture.MaxX = TextureWidth - 1;
+    WholeTexture.MaxY = TextureHeight - 1;
+    
+    FreeRectangles.clear();
+    FreeRectangles.push_back( WholeTexture );
+    ContentsMaxX = ContentsMaxY = -1;
+}
+
+
+// =============================================================================
+//      TEXTURE PACKER: UPDATING FREE RECTANGLES
+// =============================================================================
+
+
+// every free rectangle overlapping the used area is replaced
+// by the (up to 4) maximal parts of it that remain free
+void TexturePacker::SplitFreeRectangles( const PackingRectangle& Used )
+{
+    vector< PackingRectangle > NewRectangles;
+    size_t Position = 0;
+    
+    while( Position < FreeRectangles.size() )
+    {
+        PackingRectangle Free = FreeRectangles[ Position ];
+        
+        if( !Free.Intersects( Used ) )
+        {
+            Position++;
+            continue;
+        }
+        
+        // order is not relevant, so remove quickly
+        FreeRectangles[ Position ] = FreeRectangles.back();
+        FreeRectangles.pop_back();
+        
+        // part at the left
+        if( Used.MinX > Free.MinX )
+        {
+            NewRectangles.push_back( Free );
+            NewRectangles.back().MaxX = Used.MinX - 1;
+        }
+        
+        // part at the right
+        if( Used.MaxX < Free.MaxX )
+        {
+            NewRectangles.push_back( Free );
+            NewRectangles.back().MinX = Used.MaxX + 1;
+        }
+        
+        // part at the top
+        if( Used.MinY > Free.MinY )
+        {
+            NewRectangles.push_back( Free );
+            NewRectangles.back().MaxY = Used.MinY - 1;
+        }
+        
+        // part at the bottom
+        if( Used.MaxY < Free.MaxY )
+        {
+            NewRectangles.push_back( Free );
+            NewRectangles.back().MinY = Used.MaxY + 1;
+        }
+    }
+    
+    size_t FirstNewRectangle = FreeRectangles.size();
+    FreeRectangles.insert( FreeRectangles.end(), NewRectangles.begin(), NewRectangles.end() );
+    RemoveContainedRectangles( FirstNewRectangle );
+}
+
+// -----------------------------------------------------------------------------
+
+// Previous free rectangles never contain each other, so only
+// the new ones need to be compared with the rest. This keeps
+// the cost of each placement proportional to the number of
+// free rectangles, instead of its square.
+void TexturePacker::RemoveContainedRectangles( size_t FirstNewRectangle )
+{
+    size_t NumberOfRectangles = FreeRectangles.size();
+    vector< bool > Removed( NumberOfRectangles, false );
+    
+    // new rectangles contained in any other
+    // (equal rectangles only keep the last one)
+    for( size_t i = FirstNewRectangle; i < NumberOfRectangles; i++ )
+      for( size_t j = 0; j < NumberOfRectangles; j++ )
+        if( j != i && !Removed[ j ] && FreeRectangles[ j ].Contains( FreeRectangles[ i ] ) )
+        {
+            Removed[ i ] = true;
+            break;
+        }
+    
+    // previous rectangles contained in a new one
+    for( size_t i = 0; i < FirstNewRectangle; i++ )
+      for( size_t j = FirstNewRectangle; j < NumberOfRectangles; j++ )
+        if( !Removed[ j ] && FreeRectangles[ j ].Contains( FreeRectangles[ i ] ) )
+        {
+            Removed[ i ] = true;
+            break;
+        }
+    
+    // keep only the remaining ones
+    size_t Kept = 0;
+    
+    for( size_t i = 0; i < NumberOfRectangles; i++ )
+      if( !Removed[ i ] )
+        FreeRectangles[ Kept++ ] = FreeRectangles[ i ];
+    
+    FreeRectangles.resize( Kept );
+}
+
+
+// =============================================================================
+//      TEXTURE PACKER: PLACING IMAGES
+// =============================================================================
+
+
+bool TexturePacker::PlaceImage( PNGImage& Image )
+{
+    int ImageWidth = Image.PaddedWidth();
+    int ImageHeight = Image.PaddedHeight();
+    
+    // evaluate placing the image at the top-left
+    // corner of each free rectangle where it fits
+    const PackingRectangle* BestRectangle = nullptr;
+    int BestTextureArea = 0, BestShortSide = 0, BestLongSide = 0;
+    
+    for( const PackingRectangle& Free: FreeRectangles )
+    {
+        if( Free.Width() < ImageWidth || Free.Height() < ImageHeight )
+          continue;
+        
+        // rule 1: prefer less texture area
+        int NewMaxX = max( ContentsMaxX, Free.MinX + ImageWidth - 1 );
+        int NewMaxY = max( ContentsMaxY, Free.MinY + ImageHeight - 1 );
+        int TextureArea = (NewMaxX + 1) * (NewMaxY + 1);
+        
+        // rule 2: prefer rectangles that fit the image
+        // more closely, measured on its shortest side
+        int LeftoverX = Free.Width() - ImageWidth;
+        int LeftoverY = Free.Height() - ImageHeight;
+        int ShortSide = min( LeftoverX, LeftoverY );
+        int LongSide = max( LeftoverX, LeftoverY );
+        
+        if( BestRectangle )
+        {
+            if( TextureArea != BestTextureArea )
+            {
+                if( TextureArea > BestTextureArea )
+                  continue;
+            }
+            
+            else if( ShortSide != BestShortSide )
+            {
+                if( ShortSide > BestShortSide )
+                  continue;
+            }
+            
+            else if( LongSide != BestLongSide )
+            {
+                if( LongSide > BestLongSide )
+                  continue;
+            }
+            
+            // rule 3: prefer top-left positions, so that
+            // results do not depend on rectangle order
+            else if( Free.MinY != BestRectangle->MinY )
+            {
+                if( Free.MinY > BestRectangle->MinY )
+                  continue;
+            }
+            
+            else if( Free.MinX >= BestRectangle->MinX )
+              continue;
+        }
+        
+        BestRectangle = &Free;
+        BestTextureArea = TextureArea;
+        BestShortSide = ShortSide;
+        BestLongSide = LongSide;
+    }
+    
+    // check if we didn't find a suitable location
+    if( !BestRectangle )
+      return false;
+    
+    // place the image
+    PackingRectangle Used;
+    Used.MinX = BestRectangle->MinX;
+    Used.MinY = BestRectangle->MinY;
+    Used.MaxX = Used.MinX + ImageWidth - 1;
+    Used.MaxY = Used.MinY + ImageHeight - 1;
+    
+    Image.PlacedX = Used.MinX;
+    Image.PlacedY = Used.MinY;
+    
+    ContentsMaxX = max( ContentsMaxX, Used.MaxX );
+    ContentsMaxY = max( ContentsMaxY, Used.MaxY );
+    
+    SplitFreeRectangles( Used );
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+
+void TexturePacker::GetContentsLimit( int& MaxContentsX, int& MaxContentsY )
+{
+    MaxContentsX = ContentsMaxX;
+    MaxContentsY = ContentsMaxY;
+}
+
+
+// =============================================================================
+//      ALGORITHMS FOR IMAGE PLACEMENT
+// =============================================================================
+
+
+void PlaceAllImages()
+{
+    // extend texture with the separation gap
+    // at bottom and right, so that the actual
+    // usable area is still the same
+    int TextureSize = Constants::GPUTextureSize + GapBetweenImages;
+    Packer.Initialize( TextureSize, TextureSize );
+    
+    // sort images, this is important
+    LoadedImages.sort();
+    
+    // now place them all in that order
+    for( PNGImage& Image: LoadedImages )
+      if( !Packer.PlaceImage( Image ) )
+        throw runtime_error( "Cannot fit all images in the texture" );
+}
+
+// -----------------------------------------------------------------------------
+
+// copies all placed images onto the final
+// image at the coordinates they were given
+void CreateOutputImage( PNGImage& OutputImage )
+{
+    for( PNGImage& Image: LoadedImages )
+      OutputImage.CopySubImage( Image, Image.PlacedX, Image.PlacedY );
+}
@@ -0,0 +1,96 @@
+// *****************************************************************************
+    // start include guard
+    #ifndef TEXTUREPACKER_HPP
+    #define TEXTUREPACKER_HPP
+    
+    // include project headers
+    #include "PNGImage.hpp"
+    
+    // include C/C++ headers
+    #include <vector>       // [ C++ STL ] Vectors
+// *****************************************************************************
+
+
+// =============================================================================
+//      RECTANGLES WITHIN THE TEXTURE
+// =============================================================================
+
+
+class PackingRectangle
+{
+    public:
+        
+        // limits are inclusive, in pixels
+        int MinX, MaxX;
+        int MinY, MaxY;
+        
+    public:
+        
+        // properties (in pixels)
+        int Width()  const { return MaxX - MinX + 1; }
+        int Height() const { return MaxY - MinY + 1; }
+        int Area()   const { return Width() * Height(); }
+        
+        // relations with other rectangles
+        bool Contains( const PackingRectangle& Other ) const;
+        bool Intersects( const PackingRectangle& Other ) const;
+};
+
+
+// =============================================================================
+//      PACKING IMAGES IN A TEXTURE
+// =============================================================================
+
+
+// Images are packed with the MaxRects algorithm: the packer
+// keeps a list of all maximal free rectangles (which can
+// overlap each other) and places each image at the top-left
+// of one of them. Free rectangles intersecting the placed
+// image are then split, and any of them contained in another
+// is removed. Occupied limits of the texture are tracked as
+// images are placed, to choose placements that keep the
+// final texture size as small as possible.
+class TexturePacker
+{
+    protected:
+        
+        // all maximal free rectangles
+        std::vector< PackingRectangle > FreeRectangles;
+        
+        // max coordinates of placed images,
+        // or -1 while the texture is empty
+        int ContentsMaxX, ContentsMaxY;
+        
+        // updating free rectangles
+        void SplitFreeRectangles( const PackingRectangle& Used );
+        void RemoveContainedRectangles( size_t FirstNewRectangle );
+        
+    public:
+        
+        // instance handling
+        TexturePacker();
+        void Initialize( int TextureWidth, int TextureHeight );
+        
+        // returns false if the image does not fit
+        bool PlaceImage( PNGImage& Image );
+        
+        // provides the max X and Y coordinates that contain
+        // pixels, used to determine actual texture size
+        // (returns both as -1 when empty)
+        void GetContentsLimit( int& MaxContentsX, int& MaxContentsY );
+};
+
+
+// =============================================================================
+//      ALGORITHMS FOR IMAGE PLACEMENT
+// =============================================================================
+
+
+void PlaceAllImages();
+void CreateOutputImage( PNGImage& OutputImage );
+
+
+// *****************************************************************************
+    // end include guard
+    #endif
+// *****************************************************************************
@@ -0,0 +1,387 @@
+// *****************************************************************************
+    // include infrastructure headers
+    #include "../DevToolsInfrastructure/FilePaths.hpp"
+    
+    // include project headers
+    #include "BuildState.hpp"
+    
+    // include C/C++ headers
+    #include <fstream>          // [ C++ STL ] File streams
+    #include <sstream>          // [ C++ STL ] String streams
+    #include <stdexcept>        // [ C++ STL ] Exceptions
+    #include <ctime>            // [ ANSI C ] Date and time
+    
+    // declare used namespaces
+    using namespace std;
+// *****************************************************************************
+
+
+// =============================================================================
+//      CONTENT HASHING
+// =============================================================================
+
+
+uint64_t HashBytes( const void* Data, size_t Size, uint64_t Hash )
+{
+    const unsigned char* Bytes = (const unsigned char*)Data;
+    
+    for( size_t i = 0; i < Size; i++ )
+    {
+        Hash ^= Bytes[ i ];
+        Hash *= 0x100000001B3ULL;
+    }
+    
+    return Hash;
+}
+
+// -----------------------------------------------------------------------------
+
+uint64_t HashText( const string& Text, uint64_t Hash )
+{
+    return HashBytes( Text.data(), Text.size(), Hash );
+}
+
+// -----------------------------------------------------------------------------
+
+string HashToString( uint64_t Hash )
+{
+    const char* Digits = "0123456789abcdef";
+    string Result( 16, '0' );
+    
+    for( int i = 15; i >= 0; i-- )
+    {
+        Result[ i ] = Digits[ Hash & 15 ];
+        Hash >>= 4;
+    }
+    
+    return Result;
+}
+
+
+// =============================================================================
+//      FILE AUXILIARY FUNCTIONS
+// =============================================================================
+
+
+bool ReadWholeFile( const string& FilePath, string& Contents )
+{
+    ifstream InputFile;
+    OpenInputFile( InputFile, FilePath, ios_base::in | ios_base::binary );
+    
+    if( InputFile.fail() )
+      return false;
+    
+    stringstream Buffer;
+    Buffer << InputFile.rdbuf();
+    Contents = Buffer.str();
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+
+void CopyWholeFile( const string& SourcePath, const string& DestinationPath )
+{
+    string Contents;
+    
+    if( !ReadWholeFile( SourcePath, Contents ) )
+      throw runtime_error( "cannot open file \"" + SourcePath + "\"" );
+    
+    ofstream OutputFile;
+    OpenOutputFile( OutputFile, DestinationPath, ios_base::out | ios_base::binary );
+    
+    if( OutputFile.fail() )
+      throw runtime_error( "cannot open output file \"" + DestinationPath + "\"" );
+    
+    OutputFile.write( Contents.data(), Contents.size() );
+    OutputFile.close();
+}
+
+
+// =============================================================================
+//      BUILD STATE: AUXILIARY FUNCTIONS
+// =============================================================================
+
+
+string BuildState::GetStatePath()
+{
+    return CacheFolder + PathSeparator + "buildstate.txt";
+}
+
+// -----------------------------------------------------------------------------
+
+string BuildState::GetStoredPath( uint64_t StepHash )
+{
+    return CacheFolder + PathSeparator + "store" + PathSeparator + HashToString( StepHash );
+}
+
+// -----------------------------------------------------------------------------
+
+void BuildState::UpdateFileRecord( const string& FilePath, uint64_t Hash )
+{
+    FileRecord Record;
+    Record.Hash = Hash;
+    
+    if( !GetFileStatus( FilePath, Record.Size, Record.ModificationTime ) )
+    {
+        Files.erase( FilePath );
+        return;
+    }
+    
+    // times only have a precision of seconds, so a file
+    // written just now could still change without the
+    // time changing: don't rely on those records
+    if( Record.ModificationTime >= (int64_t)time( nullptr ) - 2 )
+    {
+        Files.erase( FilePath );
+        return;
+    }
+    
+    Files[ FilePath ] = Record;
+}
+
+
+// =============================================================================
+//      BUILD STATE: LOAD AND SAVE
+// =============================================================================
+
+
+void BuildState::Load( const string& CacheFolder_ )
+{
+    CacheFolder = CacheFolder_;
+    Files.clear();
+    Includes.clear();
+    Outputs.clear();
+    
+    // create the folders for a new cache
+    string StoreFolder = CacheFolder + PathSeparator + "store";
+    
+    if( !DirectoryExists( CacheFolder ) )
+      if( !CreateNewDirectory( CacheFolder ) )
+        throw runtime_error( "cannot create cache folder \"" + CacheFolder + "\"" );
+    
+    if( !DirectoryExists( StoreFolder ) )
+      if( !CreateNewDirectory( StoreFolder ) )
+        throw runtime_error( "cannot create cache folder \"" + StoreFolder + "\"" );
+    
+    // a missing state is the same as an empty one
+    ifstream StateFile;
+    OpenInputFile( StateFile, GetStatePath() );
+    
+    if( StateFile.fail() )
+      return;
+    
+    // each line is a record: paths go last,
+    // since they could contain any spaces
+    string Line;
+    
+    try
+    {
+        while( getline( StateFile, Line ) )
+          LoadRecord( Line );
+    }
+    
+    // a damaged state is also the same as an empty one
+    catch( const exception& e )
+    {
+        Files.clear();
+        Includes.clear();
+        Outputs.clear();
+    }
+}
+
+// -----------------------------------------------------------------------------
+
+void BuildState::LoadRecord( const string& Line )
+{
+    istringstream Fields( Line );
+    string Kind, Hash;
+    Fields >> Kind >> Hash;
+    
+    if( Kind == "file" )
+    {
+        FileRecord Record;
+        Record.Hash = stoull( Hash, nullptr, 16 );
+        Fields >> Record.Size >> Record.ModificationTime;
+        Fields.get();
+        
+        string FilePath;
+        getline( Fields, FilePath );
+        Files[ FilePath ] = Record;
+    }
+    
+    else if( Kind == "scanned" )
+      Includes[ stoull( Hash, nullptr, 16 ) ];
+    
+    else if( Kind == "include" )
+    {
+        Fields.get();
+        string IncludeName;
+        getline( Fields, IncludeName );
+        Includes[ stoull( Hash, nullptr, 16 ) ].push_back( IncludeName );
+    }
+    
+    else if( Kind == "output" )
+    {
+        OutputRecord Record;
+        Record.StepHash = stoull( Hash, nullptr, 16 );
+        
+        string ContentsHash;
+        Fields >> ContentsHash;
+        Record.Hash = stoull( ContentsHash, nullptr, 16 );
+        Fields.get();
+        
+        string OutputPath;
+        getline( Fields, OutputPath );
+        Outputs[ OutputPath ] = Record;
+    }
+}
+
+// -----------------------------------------------------------------------------
+
+void BuildState::Save()
+{
+    ofstream StateFile;
+    OpenOutputFile( StateFile, GetStatePath() );
+    
+    if( StateFile.fail() )
+      throw runtime_error( "cannot write build state to \"" + GetStatePath() + "\"" );
+    
+    for( auto& FilePair: Files )
+    {
+        StateFile << "file " << HashToString( FilePair.second.Hash ) << ' ';
+        StateFile << FilePair.second.Size << ' ' << FilePair.second.ModificationTime << ' ';
+        StateFile << FilePair.first << '\n';
+    }
+    
+    for( auto& IncludesPair: Includes )
+    {
+        StateFile << "scanned " << HashToString( IncludesPair.first ) << '\n';
+        
+        for( const string& IncludeName: IncludesPair.second )
+          StateFile << "include " << HashToString( IncludesPair.first ) << ' ' << IncludeName << '\n';
+    }
+    
+    for( auto& OutputPair: Outputs )
+    {
+        StateFile << "output " << HashToString( OutputPair.second.StepHash ) << ' ';
+        StateFile << HashToString( OutputPair.second.Hash ) << ' ' << OutputPair.first << '\n';
+    }
+    
+    StateFile.close();
+}
+
+
+// =============================================================================
+//      BUILD STATE: FILE CONTENTS
+// =============================================================================
+
+
+// returns false if the file does not exist
+bool BuildState::GetFileHash( const string& FilePath, uint64_t& Hash )
+{
+    uint64_t Size;
+    int64_t ModificationTime;
+    
+    if( !GetFileStatus( FilePath, Size, ModificationTime ) )
+      return false;
+    
+    // files that did not change are not read again
+    auto FilePair = Files.find( FilePath );
+    
+    if( FilePair != Files.end() )
+      if( FilePair->second.Size == Size && FilePair->second.ModificationTime == ModificationTime )
+      {
+          Hash = FilePair->second.Hash;
+          return true;
+      }
+    
+    // otherwise hash the current contents
+    string Contents;
+    
+    if( !ReadWholeFile( FilePath, Contents ) )
+      return false;
+    
+    Hash = HashText( Contents );
+    UpdateFileRecord( FilePath, Hash );
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+
+// returns false if that file contents were never scanned
+bool BuildState::GetIncludes( uint64_t FileHash, vector< string >& IncludeNames )
+{
+    auto IncludesPair = Includes.find( FileHash );
+    
+    if( IncludesPair == Includes.end() )
+      return false;
+    
+    IncludeNames = IncludesPair->second;
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+
+void BuildState::SetIncludes( uint64_t FileHash, const vector< string >& IncludeNames )
+{
+    Includes[ FileHash ] = IncludeNames;
+}
+
+
+// =============================================================================
+//      BUILD STATE: OUTPUTS OF BUILD STEPS
+// =============================================================================
+
+
+// true when the output was produced by this same
+// step and has not been modified since then
+bool BuildState::IsOutputCurrent( const string& OutputPath, uint64_t StepHash )
+{
+    auto OutputPair = Outputs.find( OutputPath );
+    
+    if( OutputPair == Outputs.end() || OutputPair->second.StepHash != StepHash )
+      return false;
+    
+    uint64_t OutputHash;
+    
+    if( !GetFileHash( OutputPath, OutputHash ) )
+      return false;
+    
+    return (OutputHash == OutputPair->second.Hash);
+}
+
+// -----------------------------------------------------------------------------
+
+void BuildState::RecordOutput( const string& OutputPath, uint64_t StepHash )
+{
+    OutputRecord Record;
+    Record.StepHash = StepHash;
+    
+    if( !GetFileHash( OutputPath, Record.Hash ) )
+      throw runtime_error( "output file \"" + OutputPath + "\" was not created" );
+    
+    Outputs[ OutputPath ] = Record;
+}
+
+// -----------------------------------------------------------------------------
+
+// returns false if this step was never run before
+bool BuildState::RestoreOutput( const string& OutputPath, uint64_t StepHash )
+{
+    string StoredPath = GetStoredPath( StepHash );
+    
+    if( !FileExists( StoredPath ) )
+      return false;
+    
+    CopyWholeFile( StoredPath, OutputPath );
+    RecordOutput( OutputPath, StepHash );
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+
+void BuildState::StoreOutput( const string& OutputPath, uint64_t StepHash )
+{
+    RecordOutput( OutputPath, StepHash );
+    CopyWholeFile( OutputPath, GetStoredPath( StepHash ) );
+}
@@ -0,0 +1,108 @@
+// *****************************************************************************
+    // start include guard
+    #ifndef BUILDSTATE_HPP
+    #define BUILDSTATE_HPP
+    
+    // include C/C++ headers
+    #include <string>           // [ C++ STL ] Strings
+    #include <vector>           // [ C++ STL ] Vectors
+    #include <map>              // [ C++ STL ] Maps
+    #include <cstdint>          // [ ANSI C ] Standard integer types
+// *****************************************************************************
+
+
+// =============================================================================
+//      CONTENT HASHING
+// =============================================================================
+
+
+// FNV-1a hash, used to identify file contents and build steps
+const uint64_t InitialHash = 0xCBF29CE484222325ULL;
+uint64_t HashBytes( const void* Data, size_t Size, uint64_t Hash = InitialHash );
+uint64_t HashText( const std::string& Text, uint64_t Hash = InitialHash );
+
+// hashes are written as 16 hex digits
+std::string HashToString( uint64_t Hash );
+
+// returns false if the file cannot be read
+bool ReadWholeFile( const std::string& FilePath, std::string& Contents );
+
+
+// =============================================================================
+//      BUILD STATE
+// =============================================================================
+
+
+// what is known about a file the last time it was hashed
+class FileRecord
+{
+    public:
+        
+        uint64_t Hash;
+        uint64_t Size;
+        int64_t ModificationTime;
+};
+
+// -----------------------------------------------------------------------------
+
+// an output file, the step that created it and its contents
+class OutputRecord
+{
+    public:
+        
+        uint64_t StepHash;
+        uint64_t Hash;
+};
+
+// -----------------------------------------------------------------------------
+
+// The state of previous builds is kept in a cache folder.
+// It contains a store with the output of every build step,
+// named after the hash of all its inputs (tool, options and
+// contents of all source files). It also contains a state
+// file, to avoid re-reading files that were not modified and
+// to know which step produced each of the current outputs.
+class BuildState
+{
+    protected:
+        
+        std::string CacheFolder;
+        
+        // files hashed in previous builds
+        std::map< std::string, FileRecord > Files;
+        
+        // included files found in each file contents
+        std::map< uint64_t, std::vector< std::string > > Includes;
+        
+        // step that produced each current output
+        std::map< std::string, OutputRecord > Outputs;
+        
+        // auxiliary functions
+        std::string GetStatePath();
+        void LoadRecord( const std::string& Line );
+        std::string GetStoredPath( uint64_t StepHash );
+        void UpdateFileRecord( const std::string& FilePath, uint64_t Hash );
+        
+    public:
+        
+        // load and save from the cache folder
+        void Load( const std::string& CacheFolder_ );
+        void Save();
+        
+        // file contents
+        bool GetFileHash( const std::string& FilePath, uint64_t& Hash );
+        bool GetIncludes( uint64_t FileHash, std::vector< std::string >& IncludeNames );
+        void SetIncludes( uint64_t FileHash, const std::vector< std::string >& IncludeNames );
+        
+        // outputs of build steps
+        bool IsOutputCurrent( const std::string& OutputPath, uint64_t StepHash );
+        void RecordOutput( const std::string& OutputPath, uint64_t StepHash );
+        bool RestoreOutput( const std::string& OutputPath, uint64_t StepHash );
+        void StoreOutput( const std::string& OutputPath, uint64_t StepHash );
+};
+
+
+// *****************************************************************************
+    // end include guard
+    #endif
+// *****************************************************************************
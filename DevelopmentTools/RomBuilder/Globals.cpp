@@ -0,0 +1,19 @@
+// *****************************************************************************
+    // include project headers
+    #include "Globals.hpp"
+    
+    // declare used namespaces
+    using namespace std;
+// *****************************************************************************
+
+
+// =============================================================================
+//      GLOBAL VARIABLES
+// =============================================================================
+
+
+// debug configuration
+bool VerboseMode = false;
+
+// folder containing the other development tools
+string ToolsFolder;
@@ -0,0 +1,27 @@
+// *****************************************************************************
+    // start include guard
+    #ifndef GLOBALS_HPP
+    #define GLOBALS_HPP
+    
+    // include C/C++ headers
+    #include <string>           // [ C++ STL ] Strings
+// *****************************************************************************
+
+
+// =============================================================================
+//      GLOBAL VARIABLES
+// =============================================================================
+
+
+// debug configuration
+extern bool VerboseMode;
+
+// folder containing this program, where the other
+// development tools are looked for before the system path
+extern std::string ToolsFolder;
+
+
+// *****************************************************************************
+    // end include guard
+    #endif
+// *****************************************************************************
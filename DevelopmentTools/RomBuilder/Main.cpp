@@ -0,0 +1,267 @@
+// *****************************************************************************
+    // include infrastructure headers
+    #include "../DevToolsInfrastructure/FilePaths.hpp"
+    
+    // include project headers
+    #include "RomBuilder.hpp"
+    #include "Globals.hpp"
+    
+    // include C/C++ headers
+    #include <string>       // [ C++ STL ] Strings
+    #include <iostream>     // [ C++ STL ] I/O Streams
+    #include <stdexcept>    // [ C++ STL ] Exceptions
+    #include <vector>       // [ C++ STL ] Vectors
+    #include <thread>       // [ C++ STL ] Threads
+    #include <chrono>       // [ C++ STL ] Time
+    
+    // include SDL headers
+    #define SDL_MAIN_HANDLED
+    #include "SDL.h"            // [ SDL2 ] Main header
+    
+    // on Windows include headers for unicode conversion
+    #if defined(__WIN32__) || defined(_WIN32) || defined(_WIN64)
+      #define WINDOWS_OS
+      #include <windows.h>      // [ WINDOWS ] Main header
+      #include <shellapi.h>     // [ WINDOWS ] Shell API
+    #endif
+    
+    // declare used namespaces
+    using namespace std;
+// *****************************************************************************
+
+
+// =============================================================================
+//      AUXILIARY FUNCTIONS
+// =============================================================================
+
+
+void PrintUsage()
+{
+    cout << "USAGE: buildrom [options] file" << endl;
+    cout << "File: a rom definition in XML format" << endl;
+    cout << "Options:" << endl;
+    cout << "  --help             Displays this information" << endl;
+    cout << "  --version          Displays program version" << endl;
+    cout << "  -o <file>          Output file, default name is the same as input" << endl;
+    cout << "  -j <jobs>          Number of conversions to run in parallel" << endl;
+    cout << "  --cachedir <dir>   Cache folder, default is .buildcache next to input" << endl;
+    cout << "  -v                 Displays additional information (verbose)" << endl;
+    cout << "Elements in the definition can have a \"source\" attribute" << endl;
+    cout << "to build their file, and \"options\" for the used tool" << endl;
+}
+
+// -----------------------------------------------------------------------------
+
+void PrintVersion()
+{
+    cout << "buildrom v25.1.19" << endl;
+    cout << "Vircon32 ROM builder by Javier Carracedo" << endl;
+}
+
+// -----------------------------------------------------------------------------
+
+// use this funcion to get the executable path
+// in a portable way (can't be done without libraries)
+string GetProgramFolder()
+{
+    if( SDL_Init( 0 ) )
+      throw runtime_error( "cannot initialize SDL" );
+    
+    char* SDLString = SDL_GetBasePath();
+    string Result = SDLString;
+    
+    SDL_free( SDLString );
+    SDL_Quit();
+    
+    return Result;
+}
+
+
+// =============================================================================
+//      MAIN FUNCTION
+// =============================================================================
+
+
+int main( int NumberOfArguments, char* Arguments[] )
+{
+    // measure build time
+    auto StartTime = chrono::steady_clock::now();
+    
+    try
+    {
+        // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+        // Process command line arguments
+        
+        // variables to capture input parameters
+        string InputPath, OutputPath, CacheFolder;
+        int Jobs = thread::hardware_concurrency();
+        
+        // to treat arguments the same in any OS we
+        // will convert them to UTF-8 in all cases
+        vector< string > ArgumentsUTF8;
+        
+        #if defined(WINDOWS_OS)
+          
+          // on Windows we can't rely on the arguments received
+          // in main: ask Windows for the UTF-16 command line
+          wchar_t* CommandLineUTF16 = GetCommandLineW();
+          wchar_t** ArgumentsUTF16 = CommandLineToArgvW( CommandLineUTF16, &NumberOfArguments );
+          
+          // now convert every program argument to UTF-8
+          for( int i = 0; i < NumberOfArguments; i++ )
+            ArgumentsUTF8.push_back( ToUTF8( ArgumentsUTF16[i] ) );
+          
+          LocalFree( ArgumentsUTF16 );
+        
+        #else
+          
+          // on Linux/Mac arguments in main are already UTF-8
+          for( int i = 0; i < NumberOfArguments; i++ )
+            ArgumentsUTF8.push_back( Arguments[i] );
+        
+        #endif
+        
+        // process arguments
+        for( int i = 1; i < NumberOfArguments; i++ )
+        {
+            if( ArgumentsUTF8[i] == string("--help") )
+            {
+                PrintUsage();
+                return 0;
+            }
+            
+            if( ArgumentsUTF8[i] == string("--version") )
+            {
+                PrintVersion();
+                return 0;
+            }
+            
+            if( ArgumentsUTF8[i] == string("-v") )
+            {
+                VerboseMode = true;
+                continue;
+            }
+            
+            if( ArgumentsUTF8[i] == string("-o") )
+            {
+                // expect another argument
+                i++;
+                
+                if( i >= NumberOfArguments )
+                  throw runtime_error( "missing filename after '-o'" );
+                
+                // now we can safely read the input path
+                OutputPath = ArgumentsUTF8[ i ];
+                continue;
+            }
+            
+            if( ArgumentsUTF8[i] == string("-j") )
+            {
+                // expect another argument
+                i++;
+                
+                if( i >= NumberOfArguments )
+                  throw runtime_error( "missing number after '-j'" );
+                
+                // now we can safely read the number of jobs
+                try
+                {
+                    Jobs = stoi( ArgumentsUTF8[ i ] );
+                }
+                
+                catch( const exception& e )
+                {
+                    throw runtime_error( "invalid number of jobs '" + ArgumentsUTF8[ i ] + "'" );
+                }
+                
+                if( Jobs < 1 )
+                  throw runtime_error( "number of jobs must be at least 1" );
+                
+                continue;
+            }
+            
+            if( ArgumentsUTF8[i] == string("--cachedir") )
+            {
+                // expect another argument
+                i++;
+                
+                if( i >= NumberOfArguments )
+                  throw runtime_error( "missing folder after '--cachedir'" );
+                
+                // now we can safely read the cache folder
+                CacheFolder = ArgumentsUTF8[ i ];
+                continue;
+            }
+            
+            // discard any other parameters starting with '-'
+            if( ArgumentsUTF8[i][0] == '-' )
+              throw runtime_error( string("unrecognized command line option '") + ArgumentsUTF8[i] + "'" );
+            
+            // any non-option parameter is taken as the input file
+            if( InputPath.empty() )
+            {
+                InputPath = ArgumentsUTF8[i];
+            }
+            
+            // only a single input file is supported!
+            else
+              throw runtime_error( "too many input files, only 1 is supported" );
+        }
+        
+        // check if an input path was given
+        if( InputPath.empty() )
+          throw runtime_error( "no input file" );
+        
+        // if output path was not given, just
+        // replace the extension in the input
+        if( OutputPath.empty() )
+        {
+            OutputPath = ReplaceFileExtension( InputPath, "v32" );
+            
+            if( VerboseMode )
+              cout << "using output path: \"" << OutputPath << "\"" << endl;
+        }
+        
+        // by default, keep the cache next to the definition
+        if( CacheFolder.empty() )
+          CacheFolder = GetPathDirectory( InputPath ) + ".buildcache";
+        
+        // the other tools are expected to be installed
+        // with this one, even if it was run from the path
+        ToolsFolder = GetProgramFolder();
+        
+        // if it is empty, we need at least a dot
+        if( ToolsFolder == "" || ToolsFolder == string(1,PathSeparator) )
+          ToolsFolder = string(".") + PathSeparator;
+        
+        if( Jobs < 1 )
+          Jobs = 1;
+        
+        // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+        // Build the ROM and everything it contains
+        RomBuilder Builder;
+        Builder.Build( InputPath, OutputPath, CacheFolder, Jobs );
+        
+        if( VerboseMode )
+        {
+            cout << "steps run: " << Builder.StepsRun << ", reused from cache: " << Builder.StepsRestored;
+            cout << ", up to date: " << Builder.StepsCurrent << endl;
+            cout << (Builder.ROMPacked? "ROM was packed" : "ROM is up to date") << endl;
+        }
+    }
+    
+    catch( const exception& e )
+    {
+        cerr << "buildrom: error: " << e.what() << endl;
+        return 1;
+    }
+    
+    // report success
+    if( VerboseMode )
+    {
+        auto ElapsedTime = chrono::duration_cast< chrono::milliseconds >( chrono::steady_clock::now() - StartTime );
+        cout << "build successful in " << ElapsedTime.count() << " ms" << endl;
+    }
+    
+    return 0;
+}
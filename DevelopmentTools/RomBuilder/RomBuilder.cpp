@@ -0,0 +1,597 @@
+// *****************************************************************************
+    // include common Vircon headers
+    #include "../../VirconDefinitions/Constants.hpp"
+    
+    // include infrastructure headers
+    #include "../DevToolsInfrastructure/FilePaths.hpp"
+    #include "../DevToolsInfrastructure/StringFunctions.hpp"
+    
+    // include project headers
+    #include "RomBuilder.hpp"
+    #include "Globals.hpp"
+    #include "../RomPacker/RomDefinition.hpp"
+    
+    // include C/C++ headers
+    #include <iostream>         // [ C++ STL ] I/O Streams
+    #include <stdexcept>        // [ C++ STL ] Exceptions
+    #include <thread>           // [ C++ STL ] Threads
+    #include <mutex>            // [ C++ STL ] Mutexes
+    #include <atomic>           // [ C++ STL ] Atomics
+    #include <cstdlib>          // [ ANSI C ] Standard library
+    
+    // include TinyXML2 headers
+    #include <tinyxml2.h>       // [ TinyXML2 ] Main header
+    
+    // tool executables are named differently on Windows
+    #if defined(__WIN32__) || defined(_WIN32) || defined(_WIN64)
+      #define WINDOWS_OS
+    #endif
+    
+    // declare used namespaces
+    using namespace std;
+    using namespace V32;
+    using namespace tinyxml2;
+// *****************************************************************************
+
+
+// =============================================================================
+//      AUXILIARY FUNCTIONS
+// =============================================================================
+
+
+// increase this when the meaning of step hashes changes,
+// so that outputs from older versions are never reused
+const char* BuilderHashVersion = "buildrom 2";
+
+// -----------------------------------------------------------------------------
+
+string GetToolName( BuildTools Tool )
+{
+    switch( Tool )
+    {
+        case BuildTools::Compiler:      return "compile";
+        case BuildTools::Assembler:     return "assemble";
+        case BuildTools::PNGConverter:  return "png2vircon";
+        case BuildTools::WAVConverter:  return "wav2vircon";
+        default:                        return "";
+    }
+}
+
+// -----------------------------------------------------------------------------
+
+// Finds the include directives in a source file. This
+// is not a full preprocessing, so conditional directives
+// are ignored and some of these files may not be used.
+// Directives are returned as "<keyword> <file path>".
+vector< string > ScanIncludes( const string& Contents, BuildTools Tool )
+{
+    vector< string > Directives;
+    size_t LineStart = 0;
+    
+    while( LineStart < Contents.size() )
+    {
+        size_t LineEnd = Contents.find( '\n', LineStart );
+        
+        if( LineEnd == string::npos )
+          LineEnd = Contents.size();
+        
+        string Line = Contents.substr( LineStart, LineEnd - LineStart );
+        LineStart = LineEnd + 1;
+        
+        // find the first word, allowing for "# include"
+        size_t WordStart = Line.find_first_not_of( " \t" );
+        
+        if( WordStart == string::npos )
+          continue;
+        
+        if( Tool == BuildTools::Compiler && Line[ WordStart ] == '#' )
+          WordStart = Line.find_first_not_of( " \t", WordStart + 1 );
+        
+        if( WordStart == string::npos )
+          continue;
+        
+        size_t WordEnd = Line.find_first_of( " \t\"", WordStart );
+        string Keyword = ToLowerCase( Line.substr( WordStart, WordEnd - WordStart ) );
+        
+        // check for directives of the given tool
+        if( Tool == BuildTools::Compiler )
+        {
+            if( Keyword != "include" )
+              continue;
+        }
+        
+        else if( Keyword != "%include" && Keyword != "datafile" )
+          continue;
+        
+        // take the path between quotes
+        size_t PathStart = Line.find( '"', WordStart );
+        
+        if( PathStart == string::npos )
+          continue;
+        
+        size_t PathEnd = Line.find( '"', PathStart + 1 );
+        
+        if( PathEnd == string::npos )
+          continue;
+        
+        Directives.push_back( Keyword + " " + Line.substr( PathStart + 1, PathEnd - PathStart - 1 ) );
+    }
+    
+    return Directives;
+}
+
+
+// =============================================================================
+//      ROM BUILDER: INSTANCE HANDLING
+// =============================================================================
+
+
+RomBuilder::RomBuilder()
+{
+    IsBios = false;
+    StepsRun = 0;
+    StepsRestored = 0;
+    StepsCurrent = 0;
+    ROMPacked = false;
+}
+
+
+// =============================================================================
+//      ROM BUILDER: LOADING THE DEFINITION
+// =============================================================================
+
+
+// same correction applied by the ROM packer
+string RomBuilder::ResolvePath( const string& Path )
+{
+    if( Path.find(':') == string::npos )
+      return BaseFolder + Path;
+    
+    return Path;
+}
+
+// -----------------------------------------------------------------------------
+
+void RomBuilder::AddStep( const string& OutputPath, const string& SourcePath, const string& Options )
+{
+    Steps.emplace_back();
+    BuildStep& Step = Steps.back();
+    Step.OutputPath = ResolvePath( OutputPath );
+    Step.Options = Options;
+    Step.Tool = BuildTools::None;
+    Step.StepHash = 0;
+    Step.ExitStatus = 0;
+    
+    // files with no source are used as they are
+    if( SourcePath.empty() )
+      return;
+    
+    Step.SourcePath = ResolvePath( SourcePath );
+    
+    // the tool is given by both file extensions
+    string SourceExtension = ToLowerCase( GetFileExtension( SourcePath ) );
+    string OutputExtension = ToLowerCase( GetFileExtension( OutputPath ) );
+    
+    if( OutputExtension == "vbin" && SourceExtension == "c" )
+      Step.Tool = BuildTools::Compiler;
+    
+    else if( OutputExtension == "vbin" && SourceExtension == "asm" )
+      Step.Tool = BuildTools::Assembler;
+    
+    else if( OutputExtension == "vtex" && SourceExtension == "png" )
+      Step.Tool = BuildTools::PNGConverter;
+    
+    else if( OutputExtension == "vsnd" && SourceExtension == "wav" )
+      Step.Tool = BuildTools::WAVConverter;
+    
+    else
+      throw runtime_error( "no tool can create \"" + OutputPath + "\" from \"" + SourcePath + "\"" );
+}
+
+// -----------------------------------------------------------------------------
+
+void RomBuilder::LoadDefinition()
+{
+    XMLDocument Loaded;
+    FILE* InputFile = OpenInputFile( DefinitionPath );
+    
+    if( !InputFile )
+      throw runtime_error( "cannot open input file \"" + DefinitionPath + "\"" );
+    
+    XMLError ErrorCode = Loaded.LoadFile( InputFile );
+    fclose( InputFile );
+    
+    if( ErrorCode != XML_SUCCESS )
+      throw runtime_error( "Cannot read XML from file path " + DefinitionPath );
+    
+    // only the elements needed for building are checked
+    // here; the packer will check the whole definition
+    XMLElement* Root = Loaded.FirstChildElement( "rom-definition" );
+    
+    if( !Root )
+      throw runtime_error( "Cannot find <rom-definition> root element" );
+    
+    XMLElement* Rom      = Root->FirstChildElement( "rom"      );
+    XMLElement* Binary   = Root->FirstChildElement( "binary"   );
+    XMLElement* Textures = Root->FirstChildElement( "textures" );
+    XMLElement* Sounds   = Root->FirstChildElement( "sounds"   );
+    
+    if( !Rom || !Binary || !Textures || !Sounds )
+      throw runtime_error( "ROM definition must contain elements <rom>, <binary>, <textures> and <sounds>" );
+    
+    const char* ROMType = Rom->Attribute( "type" );
+    IsBios = (ROMType && ToLowerCase( ROMType ) == "bios");
+    
+    // read every file in the same order as the packer
+    vector< XMLElement* > FileElements;
+    FileElements.push_back( Binary );
+    
+    for( XMLElement* Texture = Textures->FirstChildElement( "texture" ); Texture; Texture = Texture->NextSiblingElement( "texture" ) )
+      FileElements.push_back( Texture );
+    
+    for( XMLElement* Sound = Sounds->FirstChildElement( "sound" ); Sound; Sound = Sound->NextSiblingElement( "sound" ) )
+      FileElements.push_back( Sound );
+    
+    Steps.clear();
+    
+    for( XMLElement* Element: FileElements )
+    {
+        const char* Path = Element->Attribute( "path" );
+        const char* Source = Element->Attribute( "source" );
+        const char* Options = Element->Attribute( "options" );
+        
+        if( !Path )
+          throw runtime_error( string("Cannot find attribute 'path' inside <") + Element->Name() + ">" );
+        
+        AddStep( Path, Source? Source : "", Options? Options : "" );
+    }
+}
+
+
+// =============================================================================
+//      ROM BUILDER: HASHING INPUTS
+// =============================================================================
+
+
+// tools are expected to be installed with this
+// one, but they can also be found in the system path
+string RomBuilder::GetToolPath( BuildTools Tool )
+{
+    auto Pair = ToolPaths.find( Tool );
+    
+    if( Pair != ToolPaths.end() )
+      return Pair->second;
+    
+    #if defined(WINDOWS_OS)
+      string FileName = GetToolName( Tool ) + ".exe";
+      const char PathListSeparator = ';';
+    #else
+      string FileName = GetToolName( Tool );
+      const char PathListSeparator = ':';
+    #endif
+    
+    string ToolPath = ToolsFolder + FileName;
+    const char* SystemPath = getenv( "PATH" );
+    
+    if( !FileExists( ToolPath ) && SystemPath )
+    {
+        string Folders = SystemPath;
+        size_t Start = 0;
+        
+        while( Start <= Folders.size() )
+        {
+            size_t End = Folders.find( PathListSeparator, Start );
+            
+            if( End == string::npos )
+              End = Folders.size();
+            
+            string Folder = Folders.substr( Start, End - Start );
+            Start = End + 1;
+            
+            if( Folder.empty() )
+              continue;
+            
+            if( FileExists( Folder + PathSeparator + FileName ) )
+            {
+                ToolPath = Folder + PathSeparator + FileName;
+                break;
+            }
+        }
+    }
+    
+    // the tool itself is hashed, so it must exist
+    if( !FileExists( ToolPath ) )
+      throw runtime_error( "cannot find tool \"" + FileName + "\" in \"" + ToolsFolder + "\" or in the system path" );
+    
+    if( VerboseMode )
+      cout << "using tool \"" << ToolPath << "\"" << endl;
+    
+    ToolPaths[ Tool ] = ToolPath;
+    return ToolPath;
+}
+
+// -----------------------------------------------------------------------------
+
+// locate files in the same way as the tools
+string RomBuilder::GetIncludePath( const string& IncluderPath, const string& Directive )
+{
+    size_t SpacePosition = Directive.find( ' ' );
+    string Keyword = Directive.substr( 0, SpacePosition );
+    string FilePath = Directive.substr( SpacePosition + 1 );
+    
+    // the assembler reads data files from the working folder
+    if( Keyword == "datafile" )
+      return FilePath;
+    
+    string IncludePath = GetPathDirectory( IncluderPath ) + FilePath;
+    
+    // the compiler also has its own include folder
+    if( Keyword == "include" && !FileExists( IncludePath ) )
+      IncludePath = GetPathDirectory( GetToolPath( BuildTools::Compiler ) ) + "include" + PathSeparator + FilePath;
+    
+    return IncludePath;
+}
+
+// -----------------------------------------------------------------------------
+
+// adds a file and all files it includes, recursively
+void RomBuilder::HashFile( const string& FilePath, BuildTools Tool, set< string >& HashedFiles, uint64_t& Hash )
+{
+    if( HashedFiles.count( FilePath ) )
+      return;
+    
+    HashedFiles.insert( FilePath );
+    
+    // missing includes can be in unused conditional
+    // code; if needed, the tool will report them
+    uint64_t FileHash;
+    
+    if( !State.GetFileHash( FilePath, FileHash ) )
+    {
+        Hash = HashText( "missing\n", Hash );
+        return;
+    }
+    
+    Hash = HashText( HashToString( FileHash ) + "\n", Hash );
+    
+    if( Tool != BuildTools::Compiler && Tool != BuildTools::Assembler )
+      return;
+    
+    // files are only scanned when their contents change
+    vector< string > Directives;
+    
+    if( !State.GetIncludes( FileHash, Directives ) )
+    {
+        string Contents;
+        
+        if( ReadWholeFile( FilePath, Contents ) )
+          Directives = ScanIncludes( Contents, Tool );
+        
+        State.SetIncludes( FileHash, Directives );
+    }
+    
+    for( const string& Directive: Directives )
+    {
+        Hash = HashText( Directive + "\n", Hash );
+        BuildTools IncludeTool = (Directive.compare( 0, 9, "datafile " ) == 0)? BuildTools::None : Tool;
+        HashFile( GetIncludePath( FilePath, Directive ), IncludeTool, HashedFiles, Hash );
+    }
+}
+
+// -----------------------------------------------------------------------------
+
+void RomBuilder::HashStep( BuildStep& Step )
+{
+    // the tool itself is an input, so that
+    // updating tools will rebuild everything
+    string ToolPath = GetToolPath( Step.Tool );
+    uint64_t ToolHash = 0;
+    
+    if( !State.GetFileHash( ToolPath, ToolHash ) )
+      throw runtime_error( "cannot read tool \"" + ToolPath + "\"" );
+    
+    // a BIOS program is compiled and assembled differently
+    string Options = Step.Options;
+    
+    if( IsBios && (Step.Tool == BuildTools::Compiler || Step.Tool == BuildTools::Assembler) )
+      Options = "-b " + Options;
+    
+    // build the command for this step
+    Step.Command = "\"" + ToolPath + "\"";
+    Step.Command += " " + Options + " \"" + Step.SourcePath + "\" -o \"" + Step.OutputPath + "\"";
+    
+    // on Windows, a command starting with quotes
+    // needs an extra pair of quotes around it all
+    #if defined(WINDOWS_OS)
+      Step.Command = "\"" + Step.Command + "\"";
+    #endif
+    
+    // output paths are not hashed, so that
+    // the same inputs will reuse any outputs
+    uint64_t Hash = HashText( BuilderHashVersion );
+    Hash = HashText( GetToolName( Step.Tool ) + "\n" + HashToString( ToolHash ) + "\n", Hash );
+    Hash = HashText( Options + "\n", Hash );
+    
+    set< string > HashedFiles;
+    HashFile( Step.SourcePath, Step.Tool, HashedFiles, Hash );
+    Step.StepHash = Hash;
+}
+
+
+// =============================================================================
+//      ROM BUILDER: BUILDING
+// =============================================================================
+
+
+// tools will not create folders themselves
+void RomBuilder::CreateOutputFolder( const string& OutputPath )
+{
+    string OutputFolder = GetPathDirectory( OutputPath );
+    
+    if( !DirectoryExists( OutputFolder ) )
+      if( !CreateNewDirectory( OutputFolder ) )
+        throw runtime_error( "cannot create output folder \"" + OutputFolder + "\"" );
+}
+
+// -----------------------------------------------------------------------------
+
+// steps are independent, so they are run by a
+// number of threads that take the next pending one
+void RomBuilder::RunSteps( vector< BuildStep* >& PendingSteps, int Jobs )
+{
+    atomic< size_t > NextStep( 0 );
+    mutex OutputMutex;
+    
+    auto RunPendingSteps = [ & ]()
+    {
+        while( true )
+        {
+            size_t StepIndex = NextStep++;
+            
+            if( StepIndex >= PendingSteps.size() )
+              return;
+            
+            BuildStep* Step = PendingSteps[ StepIndex ];
+            
+            if( VerboseMode )
+            {
+                lock_guard< mutex > Lock( OutputMutex );
+                cout << Step->Command << endl;
+            }
+            
+            Step->ExitStatus = system( Step->Command.c_str() );
+        }
+    };
+    
+    // the calling thread also runs steps
+    vector< thread > Workers;
+    
+    for( int i = 1; i < Jobs && i < (int)PendingSteps.size(); i++ )
+      Workers.emplace_back( RunPendingSteps );
+    
+    RunPendingSteps();
+    
+    for( thread& Worker: Workers )
+      Worker.join();
+}
+
+// -----------------------------------------------------------------------------
+
+void RomBuilder::PackROM( const string& OutputPath )
+{
+    // the ROM depends on the definition and all files in it
+    uint64_t DefinitionHash;
+    
+    if( !State.GetFileHash( DefinitionPath, DefinitionHash ) )
+      throw runtime_error( "cannot open input file \"" + DefinitionPath + "\"" );
+    
+    uint64_t Hash = HashText( BuilderHashVersion );
+    Hash = HashText( "packrom " + to_string( Constants::VirconVersion ) + "." + to_string( Constants::VirconRevision ) + "\n", Hash );
+    Hash = HashText( HashToString( DefinitionHash ) + "\n", Hash );
+    
+    for( BuildStep& Step: Steps )
+    {
+        uint64_t FileHash;
+        
+        if( !State.GetFileHash( Step.OutputPath, FileHash ) )
+          throw runtime_error( "cannot open file \"" + Step.OutputPath + "\"" );
+        
+        Hash = HashText( HashToString( FileHash ) + "\n", Hash );
+    }
+    
+    if( State.IsOutputCurrent( OutputPath, Hash ) )
+      return;
+    
+    // pack the ROM just like packrom does
+    if( VerboseMode )
+      cout << "packing ROM contents into \"" << OutputPath << "\"" << endl;
+    
+    CreateOutputFolder( OutputPath );
+    
+    RomDefinition Definition;
+    Definition.BaseFolder = BaseFolder;
+    Definition.LoadXML( DefinitionPath );
+    Definition.PackROM( OutputPath );
+    
+    State.RecordOutput( OutputPath, Hash );
+    ROMPacked = true;
+}
+
+// -----------------------------------------------------------------------------
+
+void RomBuilder::Build( const string& DefinitionPath_, const string& OutputPath, const string& CacheFolder, int Jobs )
+{
+    DefinitionPath = DefinitionPath_;
+    BaseFolder = GetPathDirectory( DefinitionPath );
+    
+    StepsRun = 0;
+    StepsRestored = 0;
+    StepsCurrent = 0;
+    ROMPacked = false;
+    
+    State.Load( CacheFolder );
+    LoadDefinition();
+    
+    // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+    // STEP 1: Find the steps that need to be run
+    vector< BuildStep* > PendingSteps;
+    
+    for( BuildStep& Step: Steps )
+    {
+        if( Step.Tool == BuildTools::None )
+          continue;
+        
+        HashStep( Step );
+        
+        if( State.IsOutputCurrent( Step.OutputPath, Step.StepHash ) )
+        {
+            StepsCurrent++;
+            continue;
+        }
+        
+        // these same inputs could have been built before
+        CreateOutputFolder( Step.OutputPath );
+        
+        if( State.RestoreOutput( Step.OutputPath, Step.StepHash ) )
+        {
+            if( VerboseMode )
+              cout << "reused \"" << Step.OutputPath << "\" from cache" << endl;
+            
+            StepsRestored++;
+            continue;
+        }
+        
+        PendingSteps.push_back( &Step );
+    }
+    
+    // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+    // STEP 2: Run all pending steps
+    RunSteps( PendingSteps, Jobs );
+    
+    // keep the outputs of all successful steps,
+    // even if some other step has failed
+    string FailedOutputs;
+    
+    for( BuildStep* Step: PendingSteps )
+    {
+        if( Step->ExitStatus != 0 )
+        {
+            FailedOutputs += (FailedOutputs.empty()? "\"" : ", \"") + Step->OutputPath + "\"";
+            continue;
+        }
+        
+        State.StoreOutput( Step->OutputPath, Step->StepHash );
+        StepsRun++;
+    }
+    
+    if( !FailedOutputs.empty() )
+    {
+        State.Save();
+        throw runtime_error( "could not build " + FailedOutputs );
+    }
+    
+    // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+    // STEP 3: Pack the ROM if anything changed
+    PackROM( OutputPath );
+    State.Save();
+}
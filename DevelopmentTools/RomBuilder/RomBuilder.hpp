@@ -0,0 +1,121 @@
+// *****************************************************************************
+    // start include guard
+    #ifndef ROMBUILDER_HPP
+    #define ROMBUILDER_HPP
+    
+    // include project headers
+    #include "BuildState.hpp"
+    
+    // include C/C++ headers
+    #include <string>           // [ C++ STL ] Strings
+    #include <vector>           // [ C++ STL ] Vectors
+    #include <set>              // [ C++ STL ] Sets
+    #include <map>              // [ C++ STL ] Maps
+// *****************************************************************************
+
+
+// =============================================================================
+//      BUILD STEPS
+// =============================================================================
+
+
+enum class BuildTools
+{
+    None,
+    Compiler,
+    Assembler,
+    PNGConverter,
+    WAVConverter
+};
+
+// -----------------------------------------------------------------------------
+
+// a file listed in the ROM definition and, when
+// a source is given, the tool used to create it
+class BuildStep
+{
+    public:
+        
+        // paths are already relative to the definition
+        std::string OutputPath;
+        std::string SourcePath;
+        std::string Options;
+        BuildTools Tool;
+        
+        // hash of all inputs to the tool
+        uint64_t StepHash;
+        
+        // running the tool
+        std::string Command;
+        int ExitStatus;
+};
+
+
+// =============================================================================
+//      ROM BUILDER
+// =============================================================================
+
+
+// The builder reads a ROM definition, where the binary and
+// every texture and sound can have optional attributes
+// "source" and "options". Those are created with the tool
+// for their source extension: compile (.c), assemble (.asm),
+// png2vircon (.png) or wav2vircon (.wav). A step only runs
+// when its inputs change, and outputs of previous builds are
+// reused from a store in the cache folder. Pending steps run
+// in parallel and then the ROM is packed if anything changed.
+
+class RomBuilder
+{
+    protected:
+        
+        // ROM definition
+        std::string DefinitionPath;
+        std::string BaseFolder;
+        bool IsBios;
+        std::vector< BuildStep > Steps;
+        
+        // results of previous builds
+        BuildState State;
+        
+        // location of each tool, once it is found
+        std::map< BuildTools, std::string > ToolPaths;
+        
+        // loading the definition
+        std::string ResolvePath( const std::string& Path );
+        void LoadDefinition();
+        void AddStep( const std::string& OutputPath, const std::string& SourcePath, const std::string& Options );
+        
+        // hashing the inputs of each step
+        std::string GetToolPath( BuildTools Tool );
+        std::string GetIncludePath( const std::string& IncluderPath, const std::string& Directive );
+        void HashFile( const std::string& FilePath, BuildTools Tool, std::set< std::string >& HashedFiles, uint64_t& Hash );
+        void HashStep( BuildStep& Step );
+        
+        // building
+        void CreateOutputFolder( const std::string& OutputPath );
+        void RunSteps( std::vector< BuildStep* >& PendingSteps, int Jobs );
+        void PackROM( const std::string& OutputPath );
+        
+    public:
+        
+        // statistics of the last build
+        int StepsRun;
+        int StepsRestored;
+        int StepsCurrent;
+        bool ROMPacked;
+        
+    public:
+        
+        // instance handling
+        RomBuilder();
+        
+        // main building function
+        void Build( const std::string& DefinitionPath_, const std::string& OutputPath, const std::string& CacheFolder, int Jobs );
+};
+
+
+// *****************************************************************************
+    // end include guard
+    #endif
+// *****************************************************************************
@@ -0,0 +1 @@
+hlt
\ No newline at end of file
@@ -16,6 +16,10 @@
     #include <iostream>         // [ C++ STL ] I/O Streams
     #include <fstream>          // [ C++ STL ] File streams
     #include <stdexcept>        // [ C++ STL ] Exceptions
+    #include <algorithm>        // [ C++ STL ] Algorithms
+    #include <thread>           // [ C++ STL ] Threads
+    #include <atomic>           // [ C++ STL ] Atomics
+    #include <cstring>          // [ ANSI C ] Strings
     
     // include TinyXML2 headers
     #include <tinyxml2.h>       // [ TinyXML2 ] Main header
@@ -99,6 +103,41 @@ void CopySignature( char* Destination, const char* Value )
 
 // -----------------------------------------------------------------------------
 
+// copies a whole file to the output in blocks, so that
+// memory used does not depend on the size of the file
+void CopyFileContents( const string& FilePath, uint64_t FileBytes, ofstream& OutputFile )
+{
+    ifstream InputFile;
+    OpenInputFile( InputFile, FilePath, ios_base::binary );
+    
+    if( !InputFile.good() )
+      throw runtime_error( "cannot open file" );
+    
+    vector< char > Buffer( 1024 * 1024 );
+    uint64_t RemainingBytes = FileBytes;
+    
+    while( RemainingBytes > 0 )
+    {
+        uint32_t BlockBytes = (uint32_t)min( RemainingBytes, (uint64_t)Buffer.size() );
+        InputFile.read( &Buffer[ 0 ], BlockBytes );
+        
+        // sizes must still be the same as when checked
+        if( (uint32_t)InputFile.gcount() != BlockBytes )
+          throw runtime_error( "file was modified while packing" );
+        
+        OutputFile.write( &Buffer[ 0 ], BlockBytes );
+        RemainingBytes -= BlockBytes;
+    }
+    
+    if( InputFile.peek() != EOF )
+      throw runtime_error( "file was modified while packing" );
+    
+    if( OutputFile.fail() )
+      throw runtime_error( "cannot write file contents to output" );
+}
+
+// -----------------------------------------------------------------------------
+
 void ParseVersionString( const string& VersionText, uint32_t& Version, uint32_t& Revision )
 {
     // check that there are only digits and dots
@@ -131,12 +170,21 @@ void ParseVersionString( const string& VersionText, uint32_t& Version, uint32_t&
 // =============================================================================
 
 
-void RomDefinition::ProcessBinary( string& BinaryPath, vector< uint32_t >& ProgramROM )
+string RomDefinition::ResolvePath( const string& Path )
 {
     // correction for path folder (only if relative)
-    if( BinaryPath.find(':') == string::npos )
-      BinaryPath = BaseFolder + PathSeparator + BinaryPath;
+    if( Path.find(':') == string::npos )
+      return BaseFolder + PathSeparator + Path;
     
+    return Path;
+}
+
+// -----------------------------------------------------------------------------
+
+// only the header is read: file contents
+// are not needed until the ROM is written
+uint64_t RomDefinition::CheckBinary( const string& BinaryPath )
+{
     // open the file
     ifstream BinaryFile;
     OpenInputFile( BinaryFile, BinaryPath, ios_base::binary | ios_base::ate );
@@ -146,14 +194,14 @@ void RomDefinition::ProcessBinary( string& BinaryPath, vector< uint32_t >& Progr
     
     // get size and ensure it is a multiple of 4
     // (otherwise file contents are wrong)
-    unsigned FileBytes = BinaryFile.tellg();
+    uint64_t FileBytes = BinaryFile.tellg();
     
     if( (FileBytes % 4) != 0 )
       throw runtime_error( "incorrect VBIN format (file size must be a multiple of 4)" );
     
     // file size should be at least 4 dwords
     // (i.e. header + 1 instruction)
-    unsigned FileWords = FileBytes / 4;
+    uint64_t FileWords = FileBytes / 4;
     
     if( FileWords < 4 )
       throw runtime_error( "incorrect VBIN format (file is too small)" );
@@ -168,27 +216,17 @@ void RomDefinition::ProcessBinary( string& BinaryPath, vector< uint32_t >& Progr
       throw runtime_error( "incorrect VBIN format (file size does contain a VBIN signature)" );
     
     // file size must match the indicated program size
-    if( FileWords != BinaryHeader.NumberOfWords + 3 )
+    if( FileWords != BinaryHeader.NumberOfWords + (uint64_t)3 )
       throw runtime_error( "incorrect VBIN format (file size does not match indicated program size)" );
     
-    // now we can just copy the whole file to program rom,
-    // since the header is also included in the final rom
-    ProgramROM.resize( FileWords );
-    BinaryFile.seekg( 0, ios_base::beg );
-    BinaryFile.read( (char*)(&ProgramROM[0]), FileBytes );
-    
-    // close the file
-    BinaryFile.close();
+    // the header is also included in the final rom
+    return FileBytes;
 }
 
 // -----------------------------------------------------------------------------
 
-void RomDefinition::ProcessTexture( string& TexturePath, vector< uint32_t >& TextureROM )
+uint64_t RomDefinition::CheckTexture( const string& TexturePath )
 {
-    // correction for path folder (only if relative)
-    if( TexturePath.find(':') == string::npos )
-      TexturePath = BaseFolder + PathSeparator + TexturePath;
-    
     // open the file
     ifstream TextureFile;
     OpenInputFile( TextureFile, TexturePath, ios_base::binary | ios_base::ate );
@@ -198,14 +236,14 @@ void RomDefinition::ProcessTexture( string& TexturePath, vector< uint32_t >& Tex
     
     // get size and ensure it is a multiple of 4
     // (otherwise file contents are wrong)
-    unsigned FileBytes = TextureFile.tellg();
+    uint64_t FileBytes = TextureFile.tellg();
     
     if( (FileBytes % 4) != 0 )
       throw runtime_error( "incorrect VTEX format (file size must be a multiple of 4)" );
     
     // file size should be at least 5 dwords
     // (i.e. header + 1 pixel)
-    unsigned FileWords = FileBytes / 4;
+    uint64_t FileWords = FileBytes / 4;
     
     if( FileWords < 5 )
       throw runtime_error( "incorrect VTEX format (file is too small)" );
@@ -220,7 +258,7 @@ void RomDefinition::ProcessTexture( string& TexturePath, vector< uint32_t >& Tex
       throw runtime_error( "incorrect VTEX format (file size does contain a VTEX signature)" );
     
     // file size must match the indicated dimensions
-    uint32_t TexturePixels = TextureHeader.TextureWidth * TextureHeader.TextureHeight;
+    uint64_t TexturePixels = (uint64_t)TextureHeader.TextureWidth * TextureHeader.TextureHeight;
     
     if( FileWords != TexturePixels + 4 )
       throw runtime_error( "incorrect VTEX format (file size does not match image dimensions)" );
@@ -229,24 +267,14 @@ void RomDefinition::ProcessTexture( string& TexturePath, vector< uint32_t >& Tex
     if( TextureHeader.TextureWidth > 1024u || TextureHeader.TextureHeight > 1024u )
       throw runtime_error( "texture size is larger than allowed by Vircon32 GPU" );
     
-    // now we can just copy the whole file to texture rom,
-    // since the header is also included in the final rom
-    TextureROM.resize( FileWords );
-    TextureFile.seekg( 0, ios_base::beg );
-    TextureFile.read( (char*)(&TextureROM[0]), FileBytes );
-    
-    // close the file
-    TextureFile.close();
+    // the header is also included in the final rom
+    return FileBytes;
 }
 
 // -----------------------------------------------------------------------------
 
-void RomDefinition::ProcessSound( string& SoundPath, vector< uint32_t >& SoundROM )
+uint64_t RomDefinition::CheckSound( const string& SoundPath )
 {
-    // correction for path folder (only if relative)
-    if( SoundPath.find(':') == string::npos )
-      SoundPath = BaseFolder + PathSeparator + SoundPath;
-    
     // open the file
     ifstream SoundFile;
     OpenInputFile( SoundFile, SoundPath, ios_base::binary | ios_base::ate );
@@ -256,14 +284,14 @@ void RomDefinition::ProcessSound( string& SoundPath, vector< uint32_t >& SoundRO
     
     // get size and ensure it is a multiple of 4
     // (otherwise file contents are wrong)
-    unsigned FileBytes = SoundFile.tellg();
+    uint64_t FileBytes = SoundFile.tellg();
     
     if( (FileBytes % 4) != 0 )
       throw runtime_error( "incorrect VSND format (file size must be a multiple of 4)" );
     
     // file size should be at least 4 dwords
     // (i.e. header + 1 sample)
-    unsigned FileWords = FileBytes / 4;
+    uint64_t FileWords = FileBytes / 4;
     
     if( FileWords < 4 )
       throw runtime_error( "incorrect VSND format (file is too small)" );
@@ -278,21 +306,79 @@ void RomDefinition::ProcessSound( string& SoundPath, vector< uint32_t >& SoundRO
       throw runtime_error( "incorrect VSND format (file size does contain a VSND signature)" );
     
     // file size must match the indicated sound length
-    if( FileWords != SoundHeader.SoundSamples + 3 )
+    if( FileWords != SoundHeader.SoundSamples + (uint64_t)3 )
       throw runtime_error( "incorrect VSND format (file size does not match indicated sound size)" );
     
     // check sound length limit
-    if( SoundHeader.SoundSamples > (int)Constants::SPUMaximumCartridgeSamples )
+    if( SoundHeader.SoundSamples > (uint32_t)Constants::SPUMaximumCartridgeSamples )
       throw runtime_error( "sound size is larger than allowed by Vircon32 SPU" );
     
-    // now we can just copy the whole file to sound rom,
-    // since the header is also included in the final rom
-    SoundROM.resize( FileWords );
-    SoundFile.seekg( 0, ios_base::beg );
-    SoundFile.read( (char*)(&SoundROM[0]), FileBytes );
+    // the header is also included in the final rom
+    return FileBytes;
+}
+
+// -----------------------------------------------------------------------------
+
+// errors are kept to be reported later, since
+// this can run in a different thread
+void RomDefinition::CheckFile( PackedFile& File )
+{
+    try
+    {
+        if( File.FileType == "binary" )
+          File.FileBytes = CheckBinary( File.Path );
+        
+        else if( File.FileType == "texture" )
+          File.FileBytes = CheckTexture( File.Path );
+        
+        else
+          File.FileBytes = CheckSound( File.Path );
+    }
+    
+    catch( const exception& e )
+    {
+        File.Error = e.what();
+    }
+}
+
+// -----------------------------------------------------------------------------
+
+void RomDefinition::CheckAllFiles( vector< PackedFile >& Files )
+{
+    // each thread takes the next file not yet checked
+    atomic< size_t > NextFile( 0 );
+    
+    auto CheckPendingFiles = [ & ]()
+    {
+        while( true )
+        {
+            size_t FileIndex = NextFile++;
+            
+            if( FileIndex >= Files.size() )
+              return;
+            
+            CheckFile( Files[ FileIndex ] );
+        }
+    };
+    
+    // checking files is mostly waiting for the
+    // disk, so use some threads even on few cores
+    size_t NumberOfThreads = max( 4u, thread::hardware_concurrency() );
+    vector< thread > Workers;
+    
+    for( size_t i = 1; i < NumberOfThreads && i < Files.size(); i++ )
+      Workers.emplace_back( CheckPendingFiles );
     
-    // close the file
-    SoundFile.close();
+    CheckPendingFiles();
+    
+    for( thread& Worker: Workers )
+      Worker.join();
+    
+    // report the first error in the same
+    // order that files would be processed
+    for( PackedFile& File: Files )
+      if( !File.Error.empty() )
+        throw runtime_error( "in " + File.FileType + " file \"" + File.Path + "\" " + File.Error );
 }
 
 
@@ -424,69 +510,25 @@ void RomDefinition::LoadXML( const string& InputPath )
 void RomDefinition::PackROM( const string& OutputPath )
 {
     // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-    // STEP 1: Load program ROM
+    // STEP 1: Check all files to be packed
     // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
     
-    // process the program file
-    vector< uint32_t > ProgramROM;
+    // files are listed in the same order as in the ROM
+    vector< PackedFile > Files;
+    Files.push_back( { ResolvePath( BinaryPath ), "binary", 0, "" } );
     
-    try
-    {
-        ProcessBinary( BinaryPath, ProgramROM );
-    }
-    
-    // do this to always report the specific file on an error
-    catch( const exception& e )
-    {
-        throw runtime_error( string("in binary file \"") + BinaryPath + "\" " + e.what() );
-    }
-    
-    // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-    // STEP 2: Build video ROM from all textures
-    // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+    for( const string& TexturePath: TexturePaths )
+      Files.push_back( { ResolvePath( TexturePath ), "texture", 0, "" } );
     
-    // process each texture file
-    vector< vector< uint32_t > > VideoROM;
+    for( const string& SoundPath: SoundPaths )
+      Files.push_back( { ResolvePath( SoundPath ), "sound", 0, "" } );
     
-    for( string TexturePath: TexturePaths )
-    {
-        try
-        {
-            VideoROM.emplace_back();
-            ProcessTexture( TexturePath, VideoROM.back() );
-        }
-        
-        // do this to always report the specific file on an error
-        catch( const exception& e )
-        {
-            throw runtime_error( string("in texture file \"") + TexturePath + "\" " + e.what() );
-        }
-    }
+    // this only reads file headers, so memory used
+    // by the packer does not depend on ROM size
+    CheckAllFiles( Files );
     
     // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-    // STEP 3: Build audio ROM from all sounds
-    // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-    
-    // process each sound file
-    vector< vector< uint32_t > > AudioROM;
-    
-    for( string SoundPath: SoundPaths )
-    {
-        try
-        {
-            AudioROM.emplace_back();
-            ProcessSound( SoundPath, AudioROM.back() );
-        }
-        
-        // do this to always report the specific file on an error
-        catch( const exception& e )
-        {
-            throw runtime_error( string("in sound file \"") + SoundPath + "\" " + e.what() );
-        }
-    }
-    
-    // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-    // STEP 4: Create the ROM file header
+    // STEP 2: Create the ROM file header
     // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
     
     // make ROM header initially empty to
@@ -505,31 +547,39 @@ void RomDefinition::PackROM( const string& OutputPath )
     ROMHeader.ROMRevision = Revision;
     
     // count the number of assets
-    ROMHeader.NumberOfTextures = VideoROM.size();
-    ROMHeader.NumberOfSounds = AudioROM.size();
+    ROMHeader.NumberOfTextures = TexturePaths.size();
+    ROMHeader.NumberOfSounds = SoundPaths.size();
+    
+    // calculate the total size in bytes of each section
+    // (in the file! not in console memory); offsets in
+    // the header are 32-bit, so check for overflows
+    uint64_t SectionBytes[ 3 ] = { 0, 0, 0 };
+    
+    for( PackedFile& File: Files )
+    {
+        int Section = (File.FileType == "binary")? 0 : (File.FileType == "texture")? 1 : 2;
+        SectionBytes[ Section ] += File.FileBytes;
+    }
+    
+    uint64_t TotalBytes = sizeof(ROMFileFormat::Header) + SectionBytes[ 0 ] + SectionBytes[ 1 ] + SectionBytes[ 2 ];
+    
+    if( TotalBytes > 0xFFFFFFFFULL )
+      throw runtime_error( "ROM contents are larger than the maximum ROM file size of 4GB" );
     
     // calculate bytes of program ROM in the file
     ROMHeader.ProgramROMLocation.StartOffset = sizeof(ROMFileFormat::Header);
-    ROMHeader.ProgramROMLocation.Length = ProgramROM.size() * 4;
+    ROMHeader.ProgramROMLocation.Length = SectionBytes[ 0 ];
     
-    // calculate the total size in bytes of video ROM
-    // (in the file! not in console GPU)
+    // locate video ROM after program ROM
     ROMHeader.VideoROMLocation.StartOffset = ROMHeader.ProgramROMLocation.StartOffset + ROMHeader.ProgramROMLocation.Length;
-    ROMHeader.VideoROMLocation.Length = 0;
-    
-    for( vector< uint32_t > TextureROM: VideoROM )
-      ROMHeader.VideoROMLocation.Length += 4 * TextureROM.size();
+    ROMHeader.VideoROMLocation.Length = SectionBytes[ 1 ];
     
-    // calculate the total size in bytes of audio ROM
-    // (in the file! not in console SPU)
+    // locate audio ROM after video ROM
     ROMHeader.AudioROMLocation.StartOffset = ROMHeader.VideoROMLocation.StartOffset + ROMHeader.VideoROMLocation.Length;
-    ROMHeader.AudioROMLocation.Length = 0;
-    
-    for( vector< uint32_t > SoundROM: AudioROM )
-      ROMHeader.AudioROMLocation.Length += 4 * SoundROM.size();
+    ROMHeader.AudioROMLocation.Length = SectionBytes[ 2 ];
     
     // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-    // STEP 4: Build the output file from all partial ROMs
+    // STEP 3: Build the output file from all packed files
     // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
     
     // open the output file
@@ -542,17 +592,25 @@ void RomDefinition::PackROM( const string& OutputPath )
     // write global header to file
     OutputFile.write( (char*)(&ROMHeader), sizeof(ROMFileFormat::Header) );
     
-    // write program ROM
-    OutputFile.write( (char*)(&ProgramROM[ 0 ]), ProgramROM.size() * 4 );
-    
-    // write video ROM
-    for( vector< uint32_t >& TextureROM: VideoROM )
-      OutputFile.write( (char*)(&TextureROM[ 0 ]), TextureROM.size() * 4 );
-    
-    // write audio ROM
-    for( vector< uint32_t >& SoundROM: AudioROM )
-      OutputFile.write( (char*)(&SoundROM[ 0 ]), SoundROM.size() * 4 );
+    // now each file is copied as it is, since
+    // its header is also included in the rom
+    for( PackedFile& File: Files )
+    {
+        try
+        {
+            CopyFileContents( File.Path, File.FileBytes, OutputFile );
+        }
+        
+        // do this to always report the specific file on an error
+        catch( const exception& e )
+        {
+            throw runtime_error( "in " + File.FileType + " file \"" + File.Path + "\" " + e.what() );
+        }
+    }
     
     // close the output file
     OutputFile.close();
+    
+    if( OutputFile.fail() )
+      throw runtime_error( string("cannot write output file \"") + OutputPath + "\"" );
 }
@@ -9,6 +9,27 @@
 // *****************************************************************************
 
 
+// =============================================================================
+//      FILES PACKED IN THE ROM
+// =============================================================================
+
+
+// files are checked before writing the ROM, so
+// that their contents can be copied as they are
+class PackedFile
+{
+    public:
+        
+        // full path and type of file
+        std::string Path;
+        std::string FileType;
+        
+        // results of checking the file
+        uint64_t FileBytes;
+        std::string Error;
+};
+
+
 // =============================================================================
 //      DEFINITION OF ROM CONTENTS
 // =============================================================================
@@ -35,9 +56,12 @@ class RomDefinition
     private:
         
         // secondary functions
-        void ProcessBinary ( std::string& BinaryPath , std::vector< uint32_t >& ProgramROM );
-        void ProcessTexture( std::string& TexturePath, std::vector< uint32_t >& TextureROM );
-        void ProcessSound  ( std::string& SoundPath  , std::vector< uint32_t >& SoundROM   );
+        std::string ResolvePath( const std::string& Path );
+        uint64_t CheckBinary ( const std::string& BinaryPath  );
+        uint64_t CheckTexture( const std::string& TexturePath );
+        uint64_t CheckSound  ( const std::string& SoundPath   );
+        void CheckFile( PackedFile& File );
+        void CheckAllFiles( std::vector< PackedFile >& Files );
         
     public:
         
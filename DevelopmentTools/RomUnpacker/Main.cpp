@@ -17,6 +17,8 @@
     #include <iostream>     // [ C++ STL ] I/O Streams
     #include <stdexcept>    // [ C++ STL ] Exceptions
     #include <vector>       // [ C++ STL ] Vectors
+    #include <thread>       // [ C++ STL ] Threads
+    #include <algorithm>    // [ C++ STL ] Algorithms
     
     // on Windows include headers for unicode conversion
     #if defined(__WIN32__) || defined(_WIN32) || defined(_WIN64)
@@ -55,6 +57,7 @@ void PrintUsage()
     cout << "  --help       Displays this information" << endl;
     cout << "  --version    Displays program version" << endl;
     cout << "  -v           Displays additional information (verbose)" << endl;
+    cout << "  -j <number>  Number of threads writing extracted files" << endl;
 }
 
 // -----------------------------------------------------------------------------
@@ -106,6 +109,7 @@ int main( int NumberOfArguments, char* Arguments[] )
         
         // variables to capture input parameters
         string InputPath, OutputPath;
+        int NumberOfThreads = max( 1u, thread::hardware_concurrency() );
         
         // to treat arguments the same in any OS we
         // will convert them to UTF-8 in all cases
@@ -166,6 +170,30 @@ int main( int NumberOfArguments, char* Arguments[] )
                 continue;
             }
             
+            if( ArgumentsUTF8[i] == string("-j") )
+            {
+                // expect another argument
+                i++;
+                
+                if( i >= NumberOfArguments )
+                  throw runtime_error( "missing number after '-j'" );
+                
+                try
+                {
+                    NumberOfThreads = stoi( ArgumentsUTF8[ i ] );
+                }
+                
+                catch( const exception& )
+                {
+                    NumberOfThreads = 0;
+                }
+                
+                if( NumberOfThreads < 1 )
+                  throw runtime_error( "invalid number of threads '" + ArgumentsUTF8[ i ] + "'" );
+                
+                continue;
+            }
+            
             // discard any other parameters starting with '-'
             if( ArgumentsUTF8[i][0] == '-' )
               throw runtime_error( string("unrecognized command line option '") + ArgumentsUTF8[i] + "'" );
@@ -215,7 +243,7 @@ int main( int NumberOfArguments, char* Arguments[] )
           cout << "unpacking ROM contents into output folder" << endl;
         
         RomDefinition Definition;
-        Definition.UnpackROM( InputPath, OutputPath );
+        Definition.UnpackROM( InputPath, OutputPath, NumberOfThreads );
     }
     
     catch( const exception& e )
@@ -12,6 +12,10 @@
     #include <iostream>         // [ C++ STL ] I/O Streams
     #include <fstream>          // [ C++ STL ] File streams
     #include <stdexcept>        // [ C++ STL ] Exceptions
+    #include <algorithm>        // [ C++ STL ] Algorithms
+    #include <thread>           // [ C++ STL ] Threads
+    #include <atomic>           // [ C++ STL ] Atomics
+    #include <cstring>          // [ ANSI C ] Strings
     
     // declare used namespaces
     using namespace std;
@@ -24,61 +28,87 @@
 // =============================================================================
 
 
-void RomDefinition::ExtractBinary( BinaryFileFormat::Header& BinaryHeader, vector< V32Word >& BinaryWords )
+// gives the position of a part of the ROM, checking
+// first that it is fully contained in the file
+const uint8_t* RomDefinition::GetROMRegion( uint64_t Offset, uint64_t Bytes, const string& Name )
 {
-    // determine file path
-    string BinaryFilePath = BaseFolder + PathSeparator + RomFileName + ".vbin";
+    if( Offset > ROMFile.Size || Bytes > ROMFile.Size - Offset )
+      throw runtime_error( "Incorrect V32 file format (" + Name + " exceeds the end of file)" );
     
-    // open output file as binary
-    ofstream BinaryFile;
-    OpenOutputFile( BinaryFile, BinaryFilePath, ios_base::binary );
-    
-    // write all data into the file
-    BinaryFile.write( (char*)(&BinaryHeader), sizeof( BinaryFileFormat::Header ) );
-    BinaryFile.write( (char*)(&BinaryWords[ 0 ]), 4 * BinaryWords.size() );
-    BinaryFile.close();
+    return ROMFile.Data + Offset;
 }
 
 // -----------------------------------------------------------------------------
 
-void RomDefinition::ExtractTexture( TextureFileFormat::Header& TextureHeader, vector< V32Word >& TexturePixels )
+void RomDefinition::ExtractAsset( ROMAsset& Asset )
 {
-    // determine current file path
-    string TextureFilePath = BaseFolder + PathSeparator + "textures"
-    + PathSeparator + "texture" + to_string( ExtractedTextures ) + ".vtex";
+    FILE* OutputFile = OpenOutputFile( Asset.FilePath );
     
-    // open output file as binary
-    ofstream TextureFile;
-    OpenOutputFile( TextureFile, TextureFilePath, ios_base::binary );
+    if( !OutputFile )
+    {
+        Asset.Error = "cannot create file \"" + Asset.FilePath + "\"";
+        return;
+    }
     
-    // write all data into the file
-    TextureFile.write( (char*)(&TextureHeader), sizeof( TextureFileFormat::Header ) );
-    TextureFile.write( (char*)(&TexturePixels[ 0 ]), 4 * TexturePixels.size() );
-    TextureFile.close();
+    // write in blocks, releasing each one after it is written
+    // so that memory use does not grow with the ROM size
+    const uint64_t BlockBytes = 8 * 1024 * 1024;
+    uint64_t WrittenBytes = 0;
     
-    // count the textures
-    ExtractedTextures++;
+    while( WrittenBytes < Asset.Bytes )
+    {
+        uint64_t Bytes = min( BlockBytes, Asset.Bytes - WrittenBytes );
+        
+        if( fwrite( Asset.Start + WrittenBytes, 1, Bytes, OutputFile ) != Bytes )
+        {
+            Asset.Error = "cannot write to file \"" + Asset.FilePath + "\"";
+            break;
+        }
+        
+        ROMFile.Release( Asset.Start + WrittenBytes, Bytes );
+        WrittenBytes += Bytes;
+    }
+    
+    if( fclose( OutputFile ) != 0 && Asset.Error.empty() )
+      Asset.Error = "cannot write to file \"" + Asset.FilePath + "\"";
 }
 
 // -----------------------------------------------------------------------------
 
-void RomDefinition::ExtractSound( SoundFileFormat::Header& SoundHeader, vector< V32Word >& SoundSamples )
+// files are written by a number of threads,
+// each of them taking the next pending file
+void RomDefinition::ExtractAllAssets( int NumberOfThreads )
 {
-    // determine current file path
-    string SoundFilePath = BaseFolder + PathSeparator + "sounds"
-    + PathSeparator + "sound" + to_string( ExtractedSounds ) + ".vsnd";
-    
-    // open output file as binary
-    ofstream SoundFile;
-    OpenOutputFile( SoundFile, SoundFilePath, ios_base::binary );
+    atomic< size_t > NextAsset( 0 );
     
-    // write all data into the file
-    SoundFile.write( (char*)(&SoundHeader), sizeof( SoundFileFormat::Header ) );
-    SoundFile.write( (char*)(&SoundSamples[ 0 ]), 4 * SoundSamples.size() );
-    SoundFile.close();
-    
-    // count the sounds
-    ExtractedSounds++;
+    auto ExtractPendingAssets = [ & ]()
+    {
+        while( true )
+        {
+            size_t AssetIndex = NextAsset++;
+            
+            if( AssetIndex >= Assets.size() )
+              return;
+            
+            ExtractAsset( Assets[ AssetIndex ] );
+        }
+    };
+    
+    // the calling thread also writes files
+    vector< thread > Workers;
+    
+    for( int i = 1; i < NumberOfThreads && i < (int)Assets.size(); i++ )
+      Workers.emplace_back( ExtractPendingAssets );
+    
+    ExtractPendingAssets();
+    
+    for( thread& Worker: Workers )
+      Worker.join();
+    
+    // report the first error found
+    for( ROMAsset& Asset: Assets )
+      if( !Asset.Error.empty() )
+        throw runtime_error( Asset.Error );
 }
 
 // -----------------------------------------------------------------------------
@@ -226,7 +256,7 @@ void RomDefinition::CreateMakeSH()
 // =============================================================================
 
 
-void RomDefinition::UnpackROM( const std::string& InputPath, const std::string& OutputPath )
+void RomDefinition::UnpackROM( const std::string& InputPath, const std::string& OutputPath, int NumberOfThreads )
 {
     // store base folder path
     RomFileName = GetPathFileName( InputPath );
@@ -234,20 +264,20 @@ void RomDefinition::UnpackROM( const std::string& InputPath, const std::string&
     
     BaseFolder = OutputPath;
     
-    // open the ROM file
-    ifstream InputFile;
-    OpenInputFile( InputFile, InputPath, ios_base::binary | ios_base::ate );
-    
-    if( !InputFile.good() )
+    // map the ROM file instead of reading it: extracted
+    // files are written directly from the mapped contents
+    if( !ROMFile.Open( InputPath ) )
       throw runtime_error( "cannot open input file" );
     
+    Assets.clear();
+    
     // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
     // STEP 1: Load global information
     // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
     
     // get size and ensure it is a multiple of 4
     // (otherwise file contents are wrong)
-    unsigned FileBytes = InputFile.tellg();
+    uint64_t FileBytes = ROMFile.Size;
     
     if( (FileBytes % 4) != 0 )
       throw runtime_error( "incorrect V32 file format (file size must be a multiple of 4)" );
@@ -257,9 +287,8 @@ void RomDefinition::UnpackROM( const std::string& InputPath, const std::string&
       throw runtime_error( "incorrect V32 file format (file is too small)" );
     
     // now we can safely read the global header
-    InputFile.seekg( 0, ios_base::beg );
     ROMFileFormat::Header ROMHeader;
-    InputFile.read( (char*)(&ROMHeader), sizeof(ROMFileFormat::Header) );
+    memcpy( &ROMHeader, ROMFile.Data, sizeof(ROMFileFormat::Header) );
     
     // check if the ROM is actually a BIOS
     if( CheckSignature( ROMHeader.Signature, ROMFileFormat::CartridgeSignature ) )
@@ -316,18 +345,21 @@ void RomDefinition::UnpackROM( const std::string& InputPath, const std::string&
       throw runtime_error( "Incorrect V32 file format (audio ROM is not located after video ROM)" );
     
     // check for correct file size
-    uint32_t SizeAfterAudioROM = ROMHeader.AudioROMLocation.StartOffset + ROMHeader.AudioROMLocation.Length;
+    uint64_t SizeAfterAudioROM = (uint64_t)ROMHeader.AudioROMLocation.StartOffset + ROMHeader.AudioROMLocation.Length;
     
     if( FileBytes != SizeAfterAudioROM )
       throw runtime_error( "Incorrect V32 file format (file size does not match indicated ROM contents)" );
     
     // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-    // STEP 3: Extract program binary
+    // STEP 3: Locate program binary
     // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
     
+    // embedded files are read in order after the header
+    uint64_t ROMPosition = sizeof(ROMFileFormat::Header);
+    
     // load a binary file signature
     BinaryFileFormat::Header BinaryHeader;
-    InputFile.read( (char*)(&BinaryHeader), sizeof(BinaryFileFormat::Header) );
+    memcpy( &BinaryHeader, GetROMRegion( ROMPosition, sizeof(BinaryFileFormat::Header), "cartridge binary" ), sizeof(BinaryFileFormat::Header) );
     
     // check signature for embedded binary
     if( !CheckSignature( BinaryHeader.Signature, BinaryFileFormat::Signature ) )
@@ -337,17 +369,16 @@ void RomDefinition::UnpackROM( const std::string& InputPath, const std::string&
     if( !IsBetween( BinaryHeader.NumberOfWords, 1, Constants::MaximumCartridgeProgramROM ) )
       throw runtime_error( "Cartridge program ROM does not have a correct size (from 1 word up to 128M words)" );
     
-    // load the binary words
-    vector< V32Word > LoadedBinary;
-    LoadedBinary.resize( BinaryHeader.NumberOfWords );
-    InputFile.read( (char*)(&LoadedBinary[ 0 ]), BinaryHeader.NumberOfWords * 4 );
-    
-    // extract contents of program binary
-    ExtractBinary( BinaryHeader, LoadedBinary );
-    LoadedBinary.clear();
+    // add the binary to the extracted files
+    ROMAsset BinaryAsset;
+    BinaryAsset.FilePath = BaseFolder + PathSeparator + RomFileName + ".vbin";
+    BinaryAsset.Bytes = sizeof(BinaryFileFormat::Header) + 4 * (uint64_t)BinaryHeader.NumberOfWords;
+    BinaryAsset.Start = GetROMRegion( ROMPosition, BinaryAsset.Bytes, "cartridge binary" );
+    Assets.push_back( BinaryAsset );
+    ROMPosition += BinaryAsset.Bytes;
     
     // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-    // STEP 4: Extract texture binaries
+    // STEP 4: Locate texture binaries
     // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
     
     // create the textures folder if needed
@@ -360,14 +391,12 @@ void RomDefinition::UnpackROM( const std::string& InputPath, const std::string&
             throw runtime_error( "Cannot create textures folder" );
     }
     
-    // keep extracting textures
-    ExtractedTextures = 0;
-    
-    for( unsigned i = 0; i < ROMHeader.NumberOfTextures; i++ )
+    // keep locating textures
+    for( ExtractedTextures = 0; ExtractedTextures < (int)ROMHeader.NumberOfTextures; ExtractedTextures++ )
     {
         // load a texture file signature
         TextureFileFormat::Header TextureHeader;
-        InputFile.read( (char*)(&TextureHeader), sizeof(TextureFileFormat::Header) );
+        memcpy( &TextureHeader, GetROMRegion( ROMPosition, sizeof(TextureFileFormat::Header), "cartridge texture" ), sizeof(TextureFileFormat::Header) );
         
         // check signature for embedded texture
         if( !CheckSignature( TextureHeader.Signature, TextureFileFormat::Signature ) )
@@ -378,19 +407,18 @@ void RomDefinition::UnpackROM( const std::string& InputPath, const std::string&
         ||  !IsBetween( TextureHeader.TextureHeight, 1, 1024 ) )
           throw runtime_error( "Cartridge texture does not have correct dimensions (1x1 up to 1024x1024 pixels)" );
         
-        // load the texture pixels
-        vector< V32Word > LoadedTexture;
-        int NumberOfPixels = TextureHeader.TextureWidth * TextureHeader.TextureHeight;
-        LoadedTexture.resize( NumberOfPixels );
-        InputFile.read( (char*)(&LoadedTexture[ 0 ]), NumberOfPixels * 4 );
-        
-        // extract contents of texture binary
-        ExtractTexture( TextureHeader, LoadedTexture );
-        LoadedTexture.clear();
+        // add the texture to the extracted files
+        ROMAsset TextureAsset;
+        TextureAsset.FilePath = BaseFolder + PathSeparator + "textures"
+        + PathSeparator + "texture" + to_string( ExtractedTextures ) + ".vtex";
+        TextureAsset.Bytes = sizeof(TextureFileFormat::Header) + 4 * (uint64_t)TextureHeader.TextureWidth * TextureHeader.TextureHeight;
+        TextureAsset.Start = GetROMRegion( ROMPosition, TextureAsset.Bytes, "cartridge texture" );
+        Assets.push_back( TextureAsset );
+        ROMPosition += TextureAsset.Bytes;
     }
     
     // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-    // STEP 5: Extract sound binaries
+    // STEP 5: Locate sound binaries
     // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
     
     // create the sounds folder if needed
@@ -403,15 +431,14 @@ void RomDefinition::UnpackROM( const std::string& InputPath, const std::string&
             throw runtime_error( "Cannot create sounds folder" );
     }
     
-    // keep extracting sounds
-    ExtractedSounds = 0;
+    // keep locating sounds
     uint32_t TotalSPUSamples = 0;
     
-    for( unsigned i = 0; i < ROMHeader.NumberOfSounds; i++ )
+    for( ExtractedSounds = 0; ExtractedSounds < (int)ROMHeader.NumberOfSounds; ExtractedSounds++ )
     {
         // load a sound file signature
         SoundFileFormat::Header SoundHeader;
-        InputFile.read( (char*)(&SoundHeader), sizeof(SoundFileFormat::Header) );
+        memcpy( &SoundHeader, GetROMRegion( ROMPosition, sizeof(SoundFileFormat::Header), "cartridge sound" ), sizeof(SoundFileFormat::Header) );
         
         // check signature for embedded sound
         if( !CheckSignature( SoundHeader.Signature, SoundFileFormat::Signature ) )
@@ -427,21 +454,27 @@ void RomDefinition::UnpackROM( const std::string& InputPath, const std::string&
         if( TotalSPUSamples > (uint32_t)Constants::SPUMaximumCartridgeSamples )
           throw runtime_error( "Cartridge sounds contain too many total samples (Vircon SPU only allows up to 256M total samples)" );
         
-        // load the sound samples
-        vector< V32Word > LoadedSound;
-        LoadedSound.resize( SoundHeader.SoundSamples );
-        InputFile.read( (char*)(&LoadedSound[ 0 ]), SoundHeader.SoundSamples * 4 );
-        
-        // extract contents of sound binary
-        ExtractSound( SoundHeader, LoadedSound );
-        LoadedSound.clear();
+        // add the sound to the extracted files
+        ROMAsset SoundAsset;
+        SoundAsset.FilePath = BaseFolder + PathSeparator + "sounds"
+        + PathSeparator + "sound" + to_string( ExtractedSounds ) + ".vsnd";
+        SoundAsset.Bytes = sizeof(SoundFileFormat::Header) + 4 * (uint64_t)SoundHeader.SoundSamples;
+        SoundAsset.Start = GetROMRegion( ROMPosition, SoundAsset.Bytes, "cartridge sound" );
+        Assets.push_back( SoundAsset );
+        ROMPosition += SoundAsset.Bytes;
     }
     
+    // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+    // STEP 6: Extract all files
+    // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+    
+    ExtractAllAssets( NumberOfThreads );
+    
     // we can now close the input ROM file
-    InputFile.close();
+    ROMFile.Close();
     
     // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-    // STEP 6: Create XML definition and make scripts
+    // STEP 7: Create XML definition and make scripts
     // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
     
     // create the XML file for rom definition
@@ -8,12 +8,33 @@
     #include "../../VirconDefinitions/DataStructures.hpp"
     #include "../../VirconDefinitions/FileFormats.hpp"
     
+    // include infrastructure headers
+    #include "../DevToolsInfrastructure/MappedFile.hpp"
+    
     // include C/C++ headers
     #include <string>               // [ C++ STL ] Strings
     #include <vector>               // [ C++ STL ] Vectors
 // *****************************************************************************
 
 
+// =============================================================================
+//      FILES TO EXTRACT FROM A ROM
+// =============================================================================
+
+
+// Each binary, texture and sound in a ROM is stored exactly
+// like its separate file (header + data), so extracting it
+// only needs to write its region of the mapped ROM
+typedef struct
+{
+    std::string FilePath;
+    const uint8_t* Start;
+    uint64_t Bytes;
+    std::string Error;      // empty on success
+}
+ROMAsset;
+
+
 // =============================================================================
 //      DEFINITION OF ROM CONTENTS
 // =============================================================================
@@ -39,10 +60,14 @@ class RomDefinition
         
     private:
         
+        // input ROM and all files found in it
+        MappedFile ROMFile;
+        std::vector< ROMAsset > Assets;
+        
         // secondary functions
-        void ExtractBinary( V32::BinaryFileFormat::Header& BinaryHeader, std::vector< V32::V32Word >& BinaryWords );
-        void ExtractTexture( V32::TextureFileFormat::Header& TextureHeader, std::vector< V32::V32Word >& TexturePixels );
-        void ExtractSound( V32::SoundFileFormat::Header& SoundHeader, std::vector< V32::V32Word >& SoundSamples );
+        const uint8_t* GetROMRegion( uint64_t Offset, uint64_t Bytes, const std::string& Name );
+        void ExtractAsset( ROMAsset& Asset );
+        void ExtractAllAssets( int NumberOfThreads );
         void CreateDefinitionXML();
         void CreateMakeBAT();
         void CreateMakeSH();
@@ -50,7 +75,7 @@ class RomDefinition
     public:
         
         // main methods
-        void UnpackROM( const std::string& InputPath, const std::string& OutputPath );
+        void UnpackROM( const std::string& InputPath, const std::string& OutputPath, int NumberOfThreads = 1 );
 };
 
 
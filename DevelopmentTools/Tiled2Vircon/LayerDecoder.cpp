@@ -0,0 +1,354 @@
+// *****************************************************************************
+    // include project headers
+    #include "LayerDecoder.hpp"
+    
+    // include C/C++ headers
+    #include <stdexcept>        // [ C++ STL ] Exceptions
+    #include <cstring>          // [ ANSI C ] Strings
+    #include <cctype>           // [ ANSI C ] Character types
+    
+    // declare used namespaces
+    using namespace std;
+// *****************************************************************************
+
+
+// =============================================================================
+//      BUFFER SIZES
+// =============================================================================
+
+
+// tiles written to the file at once
+const size_t OutputBlockTiles = 16384;
+
+// bytes decoded or decompressed at once
+const size_t ByteBlockSize = 65536;
+
+// -----------------------------------------------------------------------------
+
+// value of each base64 character, or -1 if not valid
+int Base64Value( char c )
+{
+    if( c >= 'A' && c <= 'Z' ) return c - 'A';
+    if( c >= 'a' && c <= 'z' ) return c - 'a' + 26;
+    if( c >= '0' && c <= '9' ) return c - '0' + 52;
+    if( c == '+' ) return 62;
+    if( c == '/' ) return 63;
+    return -1;
+}
+
+// -----------------------------------------------------------------------------
+
+// same values in a table, to decode faster
+class Base64Table
+{
+    public:
+        
+        int8_t Values[ 256 ];
+        
+        Base64Table()
+        {
+            for( int c = 0; c < 256; c++ )
+              Values[ c ] = Base64Value( (char)c );
+        }
+};
+
+const Base64Table Base64Values;
+
+
+// =============================================================================
+//      LAYER DECODER: INSTANCE HANDLING
+// =============================================================================
+
+
+LayerDecoder::LayerDecoder()
+{
+    OutputFile = nullptr;
+    FirstTileID = 0;
+    Encoding = LayerEncoding::CSV;
+    Compression = LayerCompression::None;
+    CSVNumber = 0;
+    CSVInNumber = false;
+    Base64Bits = 0;
+    Base64BitCount = 0;
+    ZlibActive = ZlibEnded = false;
+    PartialBytes = 0;
+    NumberOfTiles = 0;
+}
+
+// -----------------------------------------------------------------------------
+
+LayerDecoder::~LayerDecoder()
+{
+    if( ZlibActive )
+      inflateEnd( &ZlibStream );
+}
+
+
+// =============================================================================
+//      LAYER DECODER: DECODING STAGES
+// =============================================================================
+
+
+// numbers are scanned directly, and any other
+// characters (commas, spaces) act as separators
+void LayerDecoder::AddCSVText( const char* Text, size_t Length )
+{
+    for( size_t i = 0; i < Length; i++ )
+    {
+        unsigned Digit = (unsigned char)Text[ i ] - '0';
+        
+        if( Digit < 10 )
+        {
+            CSVNumber = CSVNumber * 10 + Digit;
+            CSVInNumber = true;
+        }
+        
+        else if( CSVInNumber )
+        {
+            AddTile( CSVNumber );
+            CSVNumber = 0;
+            CSVInNumber = false;
+        }
+    }
+}
+
+// -----------------------------------------------------------------------------
+
+void LayerDecoder::AddBase64Text( const char* Text, size_t Length )
+{
+    for( size_t i = 0; i < Length; i++ )
+    {
+        char c = Text[ i ];
+        int Value = Base64Values.Values[ (unsigned char)c ];
+        
+        if( Value < 0 )
+        {
+            // padding and spaces carry no data
+            if( c == '=' || isspace( (unsigned char)c ) )
+              continue;
+            
+            throw runtime_error( string("invalid character '") + c + "' in base64 layer data" );
+        }
+        
+        Base64Bits = (Base64Bits << 6) | Value;
+        Base64BitCount += 6;
+        
+        if( Base64BitCount >= 8 )
+        {
+            Base64BitCount -= 8;
+            DecodedBytes.push_back( (Base64Bits >> Base64BitCount) & 0xFF );
+            
+            if( DecodedBytes.size() >= ByteBlockSize )
+            {
+                AddDecodedBytes( DecodedBytes.data(), DecodedBytes.size() );
+                DecodedBytes.clear();
+            }
+        }
+    }
+}
+
+// -----------------------------------------------------------------------------
+
+void LayerDecoder::AddDecodedBytes( const uint8_t* Bytes, size_t Length )
+{
+    if( Compression == LayerCompression::None )
+    {
+        AddTileBytes( Bytes, Length );
+        return;
+    }
+    
+    // anything after the compressed stream is ignored
+    if( ZlibEnded )
+      return;
+    
+    ZlibStream.next_in = (Bytef*)Bytes;
+    ZlibStream.avail_in = Length;
+    
+    while( ZlibStream.avail_in > 0 && !ZlibEnded )
+    {
+        ZlibStream.next_out = InflatedBytes.data();
+        ZlibStream.avail_out = InflatedBytes.size();
+        int Result = inflate( &ZlibStream, Z_NO_FLUSH );
+        
+        if( Result == Z_STREAM_END )
+          ZlibEnded = true;
+        
+        else if( Result != Z_OK && Result != Z_BUF_ERROR )
+          throw runtime_error( "cannot decompress layer data (corrupt or not in the stated format)" );
+        
+        AddTileBytes( InflatedBytes.data(), InflatedBytes.size() - ZlibStream.avail_out );
+    }
+}
+
+// -----------------------------------------------------------------------------
+
+// tiles are 32-bit little endian, but blocks
+// can end at any byte within a tile
+void LayerDecoder::AddTileBytes( const uint8_t* Bytes, size_t Length )
+{
+    size_t Position = 0;
+    
+    while( PartialBytes > 0 && PartialBytes < (int)sizeof( PartialTile ) && Position < Length )
+    {
+        PartialTile[ PartialBytes++ ] = Bytes[ Position++ ];
+        
+        if( PartialBytes == 4 )
+        {
+            AddTile( PartialTile[ 0 ] | (PartialTile[ 1 ] << 8) | (PartialTile[ 2 ] << 16) | ((uint32_t)PartialTile[ 3 ] << 24) );
+            PartialBytes = 0;
+        }
+    }
+    
+    for( ; Position + 4 <= Length; Position += 4 )
+    {
+        const uint8_t* Tile = &Bytes[ Position ];
+        AddTile( Tile[ 0 ] | (Tile[ 1 ] << 8) | (Tile[ 2 ] << 16) | ((uint32_t)Tile[ 3 ] << 24) );
+    }
+    
+    while( PartialBytes < (int)sizeof( PartialTile ) && Position < Length )
+      PartialTile[ PartialBytes++ ] = Bytes[ Position++ ];
+}
+
+// -----------------------------------------------------------------------------
+
+void LayerDecoder::FlushOutput()
+{
+    if( OutputTiles.empty() )
+      return;
+    
+    if( fwrite( OutputTiles.data(), 4, OutputTiles.size(), OutputFile ) != OutputTiles.size() )
+      throw runtime_error( "Cannot write to output file" );
+    
+    OutputTiles.clear();
+}
+
+
+// =============================================================================
+//      LAYER DECODER: DECODING A LAYER
+// =============================================================================
+
+
+void LayerDecoder::Begin( FILE* VMAPFile, int FirstID, LayerEncoding DataEncoding, LayerCompression DataCompression )
+{
+    if( DataEncoding != LayerEncoding::Base64 && DataCompression != LayerCompression::None )
+      throw runtime_error( "compression is only supported for base64 layer data" );
+    
+    OutputFile = VMAPFile;
+    FirstTileID = FirstID;
+    Encoding = DataEncoding;
+    Compression = DataCompression;
+    OutputTiles.clear();
+    OutputTiles.reserve( OutputBlockTiles );
+    NumberOfTiles = 0;
+    
+    // reset all decoding stages
+    CSVNumber = 0;
+    CSVInNumber = false;
+    Base64Bits = 0;
+    Base64BitCount = 0;
+    DecodedBytes.clear();
+    DecodedBytes.reserve( ByteBlockSize );
+    PartialBytes = 0;
+    
+    if( ZlibActive )
+      inflateEnd( &ZlibStream );
+    
+    ZlibActive = ZlibEnded = false;
+    
+    if( Compression != LayerCompression::None )
+    {
+        memset( &ZlibStream, 0, sizeof(z_stream) );
+        
+        // for gzip, zlib needs its window size
+        // increased by 16 to expect that header
+        int WindowBits = (Compression == LayerCompression::Gzip)? (16 + MAX_WBITS) : MAX_WBITS;
+        
+        if( inflateInit2( &ZlibStream, WindowBits ) != Z_OK )
+          throw runtime_error( "cannot initialize zlib decompression" );
+        
+        ZlibActive = true;
+        InflatedBytes.resize( ByteBlockSize );
+    }
+}
+
+// -----------------------------------------------------------------------------
+
+void LayerDecoder::AddText( const char* Text, size_t Length )
+{
+    if( Encoding == LayerEncoding::CSV )
+      AddCSVText( Text, Length );
+    
+    else if( Encoding == LayerEncoding::Base64 )
+      AddBase64Text( Text, Length );
+}
+
+// -----------------------------------------------------------------------------
+
+void LayerDecoder::AddTile( uint32_t TileID )
+{
+    // save the tile value normalized to the first id
+    if( (int)TileID < FirstTileID )
+      TileID = FirstTileID;
+    
+    OutputTiles.push_back( TileID - FirstTileID );
+    NumberOfTiles++;
+    
+    if( OutputTiles.size() >= OutputBlockTiles )
+      FlushOutput();
+}
+
+// -----------------------------------------------------------------------------
+
+void LayerDecoder::End()
+{
+    // complete the last number or byte block
+    if( Encoding == LayerEncoding::CSV && CSVInNumber )
+      AddTile( CSVNumber );
+    
+    if( Encoding == LayerEncoding::Base64 )
+      AddDecodedBytes( DecodedBytes.data(), DecodedBytes.size() );
+    
+    DecodedBytes.clear();
+    CSVInNumber = false;
+    
+    if( ZlibActive )
+    {
+        inflateEnd( &ZlibStream );
+        ZlibActive = false;
+        
+        if( !ZlibEnded )
+          throw runtime_error( "compressed layer data is incomplete" );
+    }
+    
+    if( PartialBytes > 0 )
+      throw runtime_error( "layer data size is not a multiple of 4 bytes" );
+    
+    FlushOutput();
+}
+
+
+// =============================================================================
+//      READING LAYER FORMATS
+// =============================================================================
+
+
+LayerEncoding ParseLayerEncoding( const string& Name )
+{
+    // Tiled omits encoding for XML tiles
+    if( Name.empty() )  return LayerEncoding::XML;
+    if( Name == "csv" )    return LayerEncoding::CSV;
+    if( Name == "base64" ) return LayerEncoding::Base64;
+    
+    throw runtime_error( "layer data encoding \"" + Name + "\" is not supported" );
+}
+
+// -----------------------------------------------------------------------------
+
+LayerCompression ParseLayerCompression( const string& Name )
+{
+    if( Name.empty() )  return LayerCompression::None;
+    if( Name == "zlib" ) return LayerCompression::Zlib;
+    if( Name == "gzip" ) return LayerCompression::Gzip;
+    
+    throw runtime_error( "layer data compression \"" + Name + "\" is not supported (use zlib, gzip or none)" );
+}
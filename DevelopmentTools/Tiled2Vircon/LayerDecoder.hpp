@@ -0,0 +1,116 @@
+// *****************************************************************************
+    // start include guard
+    #ifndef LAYERDECODER_HPP
+    #define LAYERDECODER_HPP
+    
+    // include C/C++ headers
+    #include <string>           // [ C++ STL ] Strings
+    #include <vector>           // [ C++ STL ] Vectors
+    #include <cstdio>           // [ ANSI C ] Standard I/O
+    #include <cstdint>          // [ ANSI C ] Standard integer types
+    
+    // include zlib headers
+    #include <zlib.h>           // [ zlib ] Main header
+// *****************************************************************************
+
+
+// =============================================================================
+//      ENCODINGS FOR TILED LAYER DATA
+// =============================================================================
+
+
+enum class LayerEncoding
+{
+    XML,        // one <tile> element per tile
+    CSV,        // text, comma separated
+    Base64      // binary, 32-bit little endian
+};
+
+// -----------------------------------------------------------------------------
+
+enum class LayerCompression
+{
+    None,
+    Zlib,
+    Gzip
+};
+
+
+// =============================================================================
+//      DECODING LAYER DATA TO A VMAP FILE
+// =============================================================================
+
+
+// Converts the data of a layer to tile indices in a VMAP file
+// as it is received: text is given in blocks of any size, and
+// each decoding stage keeps its state between blocks. Base64
+// is decoded and (if needed) decompressed into small buffers,
+// so nothing proportional to the map size is ever stored.
+class LayerDecoder
+{
+    protected:
+        
+        // output
+        FILE* OutputFile;
+        int FirstTileID;
+        std::vector< uint32_t > OutputTiles;
+        
+        // decoding state
+        LayerEncoding Encoding;
+        LayerCompression Compression;
+        uint32_t CSVNumber;
+        bool CSVInNumber;
+        uint32_t Base64Bits;
+        int Base64BitCount;
+        std::vector< uint8_t > DecodedBytes;
+        
+        // decompression state
+        z_stream ZlibStream;
+        bool ZlibActive;
+        bool ZlibEnded;
+        std::vector< uint8_t > InflatedBytes;
+        
+        // bytes of an incomplete tile
+        uint8_t PartialTile[ 4 ];
+        int PartialBytes;
+        
+        // each decoding stage
+        void AddCSVText( const char* Text, size_t Length );
+        void AddBase64Text( const char* Text, size_t Length );
+        void AddDecodedBytes( const uint8_t* Bytes, size_t Length );
+        void AddTileBytes( const uint8_t* Bytes, size_t Length );
+        void FlushOutput();
+        
+    public:
+        
+        // number of tiles written
+        uint64_t NumberOfTiles;
+        
+    public:
+        
+        // instance handling
+        LayerDecoder();
+       ~LayerDecoder();
+        
+        // a layer is decoded between Begin and End
+        void Begin( FILE* VMAPFile, int FirstID, LayerEncoding DataEncoding, LayerCompression DataCompression );
+        void AddText( const char* Text, size_t Length );
+        void AddTile( uint32_t TileID );
+        void End();
+};
+
+
+// =============================================================================
+//      READING LAYER FORMATS
+// =============================================================================
+
+
+// throw for formats that are not supported
+LayerEncoding ParseLayerEncoding( const std::string& Name );
+LayerCompression ParseLayerCompression( const std::string& Name );
+
+
+// *****************************************************************************
+    // end include guard
+    #endif
+// *****************************************************************************
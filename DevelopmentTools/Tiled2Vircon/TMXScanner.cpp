@@ -0,0 +1,415 @@
+// *****************************************************************************
+    // include infrastructure headers
+    #include "../DevToolsInfrastructure/FilePaths.hpp"
+    
+    // include project headers
+    #include "TMXScanner.hpp"
+    
+    // include C/C++ headers
+    #include <stdexcept>        // [ C++ STL ] Exceptions
+    #include <algorithm>        // [ C++ STL ] Algorithms
+    #include <cstring>          // [ ANSI C ] Strings
+    #include <cstdlib>          // [ ANSI C ] Standard library
+    #include <cctype>           // [ ANSI C ] Character types
+    
+    // declare used namespaces
+    using namespace std;
+// *****************************************************************************
+
+
+// =============================================================================
+//      TMX SCANNER: INSTANCE HANDLING
+// =============================================================================
+
+
+// bytes read from the file at once
+const size_t ScannerBufferSize = 65536;
+
+// -----------------------------------------------------------------------------
+
+TMXScanner::TMXScanner()
+{
+    InputFile = nullptr;
+    BufferPosition = BufferEnd = 0;
+    LineNumber = 1;
+    IsClosingTag = IsSelfClosingTag = false;
+}
+
+// -----------------------------------------------------------------------------
+
+TMXScanner::~TMXScanner()
+{
+    Close();
+}
+
+
+// =============================================================================
+//      TMX SCANNER: FILE HANDLING
+// =============================================================================
+
+
+bool TMXScanner::Open( const string& FilePath )
+{
+    Close();
+    InputFile = OpenInputFile( FilePath );
+    
+    if( !InputFile )
+      return false;
+    
+    Buffer.resize( ScannerBufferSize );
+    BufferPosition = BufferEnd = 0;
+    LineNumber = 1;
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+
+void TMXScanner::Close()
+{
+    if( InputFile )
+      fclose( InputFile );
+    
+    InputFile = nullptr;
+}
+
+
+// =============================================================================
+//      TMX SCANNER: READING CHARACTERS
+// =============================================================================
+
+
+bool TMXScanner::FillBuffer()
+{
+    if( BufferPosition < BufferEnd )
+      return true;
+    
+    if( !InputFile )
+      return false;
+    
+    BufferPosition = 0;
+    BufferEnd = fread( Buffer.data(), 1, Buffer.size(), InputFile );
+    return (BufferEnd > 0);
+}
+
+// -----------------------------------------------------------------------------
+
+// returns -1 at the end of the file
+int TMXScanner::NextChar()
+{
+    if( !FillBuffer() )
+      return -1;
+    
+    char c = Buffer[ BufferPosition++ ];
+    
+    if( c == '\n' )
+      LineNumber++;
+    
+    return (unsigned char)c;
+}
+
+// -----------------------------------------------------------------------------
+
+int TMXScanner::PeekChar()
+{
+    if( !FillBuffer() )
+      return -1;
+    
+    return (unsigned char)Buffer[ BufferPosition ];
+}
+
+
+// =============================================================================
+//      TMX SCANNER: PARSING
+// =============================================================================
+
+
+void TMXScanner::ThrowSyntaxError()
+{
+    throw runtime_error( "XML syntax error in line " + to_string( LineNumber ) );
+}
+
+// -----------------------------------------------------------------------------
+
+void TMXScanner::SkipUntil( const char* Ending )
+{
+    size_t EndingLength = strlen( Ending );
+    size_t Matched = 0;
+    
+    while( Matched < EndingLength )
+    {
+        int c = NextChar();
+        
+        if( c < 0 )
+          ThrowSyntaxError();
+        
+        if( c == Ending[ Matched ] )
+          Matched++;
+        else
+          Matched = (c == Ending[ 0 ])? 1 : 0;
+    }
+}
+
+// -----------------------------------------------------------------------------
+
+void TMXScanner::SkipSpaces()
+{
+    while( isspace( PeekChar() ) )
+      NextChar();
+}
+
+// -----------------------------------------------------------------------------
+
+string TMXScanner::ReadName()
+{
+    string Name;
+    
+    while( true )
+    {
+        int c = PeekChar();
+        
+        if( c < 0 || isspace( c ) || c == '=' || c == '/' || c == '>' )
+          break;
+        
+        Name += (char)NextChar();
+    }
+    
+    if( Name.empty() )
+      ThrowSyntaxError();
+    
+    return Name;
+}
+
+// -----------------------------------------------------------------------------
+
+string TMXScanner::ReadAttributeValue()
+{
+    int Quote = NextChar();
+    
+    if( Quote != '"' && Quote != '\'' )
+      ThrowSyntaxError();
+    
+    string Value;
+    
+    while( true )
+    {
+        int c = NextChar();
+        
+        if( c < 0 || c == '<' )
+          ThrowSyntaxError();
+        
+        if( c == Quote )
+          return Value;
+        
+        if( c != '&' )
+        {
+            Value += (char)c;
+            continue;
+        }
+        
+        // decode an entity
+        string Entity;
+        
+        while( (c = NextChar()) != ';' )
+        {
+            if( c < 0 || Entity.size() > 10 )
+              ThrowSyntaxError();
+            
+            Entity += (char)c;
+        }
+        
+        if( Entity == "amp" )  Value += '&';
+        else if( Entity == "lt" )   Value += '<';
+        else if( Entity == "gt" )   Value += '>';
+        else if( Entity == "quot" ) Value += '"';
+        else if( Entity == "apos" ) Value += '\'';
+        
+        // character references are encoded back to UTF-8
+        else if( Entity.size() > 1 && Entity[ 0 ] == '#' )
+        {
+            bool Hexadecimal = (Entity[ 1 ] == 'x');
+            unsigned long Code = strtoul( Entity.c_str() + (Hexadecimal? 2 : 1), nullptr, Hexadecimal? 16 : 10 );
+            
+            if( Code < 0x80 )
+              Value += (char)Code;
+            
+            else if( Code < 0x800 )
+            {
+                Value += (char)(0xC0 | (Code >> 6));
+                Value += (char)(0x80 | (Code & 0x3F));
+            }
+            
+            else if( Code < 0x10000 )
+            {
+                Value += (char)(0xE0 | (Code >> 12));
+                Value += (char)(0x80 | ((Code >> 6) & 0x3F));
+                Value += (char)(0x80 | (Code & 0x3F));
+            }
+            
+            else
+            {
+                Value += (char)(0xF0 | (Code >> 18));
+                Value += (char)(0x80 | ((Code >> 12) & 0x3F));
+                Value += (char)(0x80 | ((Code >> 6) & 0x3F));
+                Value += (char)(0x80 | (Code & 0x3F));
+            }
+        }
+        
+        else ThrowSyntaxError();
+    }
+}
+
+// -----------------------------------------------------------------------------
+
+bool TMXScanner::ReadNextTag()
+{
+    while( true )
+    {
+        // skip any text before the tag
+        while( true )
+        {
+            if( !FillBuffer() )
+              return false;
+            
+            const char* Start = &Buffer[ BufferPosition ];
+            const char* TagStart = (const char*)memchr( Start, '<', BufferEnd - BufferPosition );
+            const char* TextEnd = TagStart? TagStart : Buffer.data() + BufferEnd;
+            
+            LineNumber += count( Start, TextEnd, '\n' );
+            BufferPosition += TextEnd - Start;
+            
+            if( TagStart )
+              break;
+        }
+        
+        NextChar();
+        int c = PeekChar();
+        
+        // skip declarations and processing instructions
+        if( c == '?' )
+        {
+            SkipUntil( "?>" );
+            continue;
+        }
+        
+        // skip comments, CDATA sections and DTDs
+        if( c == '!' )
+        {
+            NextChar();
+            
+            if( PeekChar() == '-' )
+              SkipUntil( "-->" );
+            else if( PeekChar() == '[' )
+              SkipUntil( "]]>" );
+            else
+              SkipUntil( ">" );
+            
+            continue;
+        }
+        
+        // read the tag name
+        IsClosingTag = (c == '/');
+        IsSelfClosingTag = false;
+        Attributes.clear();
+        
+        if( IsClosingTag )
+          NextChar();
+        
+        TagName = ReadName();
+        
+        // read attributes until the tag ends
+        while( true )
+        {
+            SkipSpaces();
+            c = NextChar();
+            
+            if( c == '>' )
+              return true;
+            
+            if( c == '/' )
+            {
+                if( NextChar() != '>' )
+                  ThrowSyntaxError();
+                
+                IsSelfClosingTag = true;
+                return true;
+            }
+            
+            if( c < 0 || IsClosingTag )
+              ThrowSyntaxError();
+            
+            BufferPosition--;
+            string AttributeName = ReadName();
+            SkipSpaces();
+            
+            if( NextChar() != '=' )
+              ThrowSyntaxError();
+            
+            SkipSpaces();
+            Attributes[ AttributeName ] = ReadAttributeValue();
+        }
+    }
+}
+
+// -----------------------------------------------------------------------------
+
+size_t TMXScanner::ReadText( char* Destination, size_t MaxCharacters )
+{
+    size_t CharactersRead = 0;
+    
+    while( CharactersRead < MaxCharacters && FillBuffer() )
+    {
+        const char* Start = &Buffer[ BufferPosition ];
+        size_t Available = min( BufferEnd - BufferPosition, MaxCharacters - CharactersRead );
+        const char* TagStart = (const char*)memchr( Start, '<', Available );
+        size_t Length = TagStart? (TagStart - Start) : Available;
+        
+        memcpy( Destination + CharactersRead, Start, Length );
+        LineNumber += count( Start, Start + Length, '\n' );
+        BufferPosition += Length;
+        CharactersRead += Length;
+        
+        if( TagStart )
+          break;
+    }
+    
+    return CharactersRead;
+}
+
+
+// =============================================================================
+//      TMX SCANNER: ACCESS TO ATTRIBUTES
+// =============================================================================
+
+
+bool TMXScanner::HasAttribute( const string& Name )
+{
+    return Attributes.find( Name ) != Attributes.end();
+}
+
+// -----------------------------------------------------------------------------
+
+string TMXScanner::GetRequiredAttribute( const string& Name )
+{
+    auto Position = Attributes.find( Name );
+    
+    if( Position == Attributes.end() )
+      throw runtime_error( string("Cannot find attribute '") + Name + "' inside <" + TagName + ">" );
+    
+    return Position->second;
+}
+
+// -----------------------------------------------------------------------------
+
+int TMXScanner::GetRequiredIntegerAttribute( const string& Name )
+{
+    string Value = GetRequiredAttribute( Name );
+    
+    // attempt integer conversion
+    char* End = nullptr;
+    long Number = strtol( Value.c_str(), &End, 10 );
+    
+    if( Value.empty() || *End != 0 )
+      throw runtime_error( string("Attribute '") + Name + "' inside <" + TagName + "> must be an integer number" );
+    
+    return (int)Number;
+}
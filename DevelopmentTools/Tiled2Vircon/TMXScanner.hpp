@@ -0,0 +1,86 @@
+// *****************************************************************************
+    // start include guard
+    #ifndef TMXSCANNER_HPP
+    #define TMXSCANNER_HPP
+    
+    // include C/C++ headers
+    #include <string>           // [ C++ STL ] Strings
+    #include <vector>           // [ C++ STL ] Vectors
+    #include <map>              // [ C++ STL ] Maps
+    #include <cstdio>           // [ ANSI C ] Standard I/O
+// *****************************************************************************
+
+
+// =============================================================================
+//      STREAMING SCANNER FOR TMX FILES
+// =============================================================================
+
+
+// Reads the XML in a TMX file one tag at a time, without
+// building a document in memory. Element text (like layer
+// data) is not stored either: it is given to the caller
+// in blocks with ReadText. This only covers the parts of
+// XML that Tiled writes: declarations, comments and CDATA
+// sections are skipped, and only the standard entities
+// are decoded (in attribute values).
+class TMXScanner
+{
+    protected:
+        
+        FILE* InputFile;
+        std::vector< char > Buffer;
+        size_t BufferPosition;
+        size_t BufferEnd;
+        
+        // reading characters
+        bool FillBuffer();
+        int NextChar();
+        int PeekChar();
+        
+        // parsing
+        void SkipUntil( const char* Ending );
+        void SkipSpaces();
+        std::string ReadName();
+        std::string ReadAttributeValue();
+        void ThrowSyntaxError();
+        
+    public:
+        
+        // file position, for error messages
+        int LineNumber;
+        
+        // last tag read
+        std::string TagName;
+        bool IsClosingTag;
+        bool IsSelfClosingTag;
+        std::map< std::string, std::string > Attributes;
+        
+    public:
+        
+        // instance handling
+        TMXScanner();
+       ~TMXScanner();
+        
+        // file handling
+        bool Open( const std::string& FilePath );
+        void Close();
+        
+        // skips any text until the next tag, and reads
+        // it; returns false at the end of the file
+        bool ReadNextTag();
+        
+        // copies text up to the next tag (which is not
+        // read); returns 0 when that tag is reached
+        size_t ReadText( char* Destination, size_t MaxCharacters );
+        
+        // access to attributes of the last tag
+        bool HasAttribute( const std::string& Name );
+        std::string GetRequiredAttribute( const std::string& Name );
+        int GetRequiredIntegerAttribute( const std::string& Name );
+};
+
+
+// *****************************************************************************
+    // end include guard
+    #endif
+// *****************************************************************************
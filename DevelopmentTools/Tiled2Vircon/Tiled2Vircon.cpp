@@ -2,16 +2,16 @@
     // include infrastructure headers
     #include "../DevToolsInfrastructure/FilePaths.hpp"
     
+    // include project headers
+    #include "TMXScanner.hpp"
+    #include "LayerDecoder.hpp"
+    
     // include C/C++ headers
     #include <string>           // [ C++ STL ] Strings
     #include <stdexcept>        // [ C++ STL ] Exceptions
     #include <iostream>         // [ C++ STL ] I/O streams
-    #include <fstream>          // [ C++ STL ] File streams
-    #include <sstream>          // [ C++ STL ] String streams
     #include <vector>           // [ C++ STL ] Vectors
-    
-    // include TinyXML2 headers
-    #include <tinyxml2.h>       // [ TinyXML2 ] Main header
+    #include <cstdlib>          // [ ANSI C ] Standard library
     
     // on Windows include headers for unicode conversion
     #if defined(__WIN32__) || defined(_WIN32) || defined(_WIN64)
@@ -22,7 +22,6 @@
     
     // declare used namespaces
     using namespace std;
-    using namespace tinyxml2;
 // *****************************************************************************
 
 
@@ -36,61 +35,61 @@ bool VerboseMode = false;
 
 
 // =============================================================================
-//      XML HELPER FUNCTIONS
+//      CONVERSION OF MAP LAYERS
 // =============================================================================
 
 
-// automation for child elements in XML
-XMLElement* GetRequiredElement( XMLElement* Parent, const string& ChildName )
-{
-    if( !Parent )
-      throw runtime_error( "Parent element NULL" );
-    
-    XMLElement* Child = Parent->FirstChildElement( ChildName.c_str() );
-    
-    if( !Child )
-      throw runtime_error( string("Cannot find element <") + ChildName + "> inside <" + Parent->Name() + ">" );
-    
-    return Child;
-}
+// characters read from layer data at once
+const size_t TextBlockSize = 65536;
 
 // -----------------------------------------------------------------------------
 
-// automation for string attributes in XML
-string GetRequiredStringAttribute( XMLElement* Element, const string& AtributeName )
+// the scanner must be placed just after the <data> tag;
+// returns the number of tiles written to the output
+uint64_t ConvertLayerData( TMXScanner& Scanner, FILE* VMAPFile, int FirstTileID )
 {
-    if( !Element )
-      throw runtime_error( "Parent element NULL" );
+    LayerEncoding Encoding = ParseLayerEncoding( Scanner.HasAttribute( "encoding" )? Scanner.Attributes[ "encoding" ] : "" );
+    LayerCompression Compression = ParseLayerCompression( Scanner.HasAttribute( "compression" )? Scanner.Attributes[ "compression" ] : "" );
     
-    const XMLAttribute* Attribute = Element->FindAttribute( AtributeName.c_str() );
-
-    if( !Attribute )
-      throw runtime_error( string("Cannot find attribute '") + AtributeName + "' inside <" + Element->Name() + ">" );
+    LayerDecoder Decoder;
+    Decoder.Begin( VMAPFile, FirstTileID, Encoding, Compression );
     
-    return Attribute->Value();
-}
-
-// -----------------------------------------------------------------------------
-
-// automation for integer attributes in XML
-int GetRequiredIntegerAttribute( XMLElement* Element, const string& AtributeName )
-{
-    if( !Element )
-      throw runtime_error( "Parent element NULL" );
-    
-    const XMLAttribute* Attribute = Element->FindAttribute( AtributeName.c_str() );
-
-    if( !Attribute )
-      throw runtime_error( string("Cannot find attribute '") + AtributeName + "' inside <" + Element->Name() + ">" );
+    // an empty layer has no contents
+    if( Scanner.IsSelfClosingTag )
+    {
+        Decoder.End();
+        return Decoder.NumberOfTiles;
+    }
     
-    // attempt integer conversion
-    int Number = 0;
-    XMLError ErrorCode = Element->QueryIntAttribute( AtributeName.c_str(), &Number );
+    // text encodings are decoded in blocks
+    if( Encoding != LayerEncoding::XML )
+    {
+        vector< char > TextBlock( TextBlockSize );
+        size_t TextLength;
+        
+        while( (TextLength = Scanner.ReadText( TextBlock.data(), TextBlock.size() )) > 0 )
+          Decoder.AddText( TextBlock.data(), TextLength );
+    }
     
-    if( ErrorCode != XML_SUCCESS )
-      throw runtime_error( string("Attribute '") + AtributeName + "' inside <" + Element->Name() + "> must be an integer number" );
+    // process elements until the end of data
+    while( true )
+    {
+        if( !Scanner.ReadNextTag() )
+          throw runtime_error( "unexpected end of file inside <data>" );
+        
+        if( Scanner.TagName == "data" && Scanner.IsClosingTag )
+          break;
+        
+        if( Scanner.TagName == "chunk" )
+          throw runtime_error( "infinite maps are not supported" );
+        
+        // empty tiles can omit their ID
+        if( Encoding == LayerEncoding::XML && Scanner.TagName == "tile" && !Scanner.IsClosingTag )
+          Decoder.AddTile( Scanner.HasAttribute( "gid" )? strtoul( Scanner.Attributes[ "gid" ].c_str(), nullptr, 10 ) : 0 );
+    }
     
-    return Number;
+    Decoder.End();
+    return Decoder.NumberOfTiles;
 }
 
 
@@ -226,51 +225,26 @@ int main( int NumberOfArguments, char* Arguments[] )
         // STEP 1: Open the source XML and read basic information
         // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
         
-        FILE* InputFile = nullptr;
-        tinyxml2::XMLDocument LoadedMap;
+        // the map is read as it is converted,
+        // so it never needs to be fully loaded
+        TMXScanner Scanner;
         
-        try
-        {
-            // open the file
-            InputFile = OpenInputFile( InputPath );
-            
-            if( !InputFile )
-              throw runtime_error( string("cannot open input file \"") + InputPath + "\"" );
-            
-            // load file as an XML document
-            XMLError ErrorCode = LoadedMap.LoadFile( InputFile );
-            
-            if( ErrorCode != XML_SUCCESS )
-              throw runtime_error( "Cannot read XML from file path " + InputPath );
+        if( !Scanner.Open( InputPath ) )
+          throw runtime_error( string("cannot open input file \"") + InputPath + "\"" );
         
-            // close the file
-            fclose( InputFile );
-            InputFile = nullptr;
-        }
-        catch(...)
-        {
-            // ensure the file is never left open
-            if( InputFile )
-              fclose( InputFile );
-            
-            // and then rethrow the exception&
-            throw;
-        }
-        
-        // obtain XML root
-        XMLElement* MapRoot = LoadedMap.FirstChildElement( "map" );
-        
-        if( !MapRoot )
-          throw runtime_error( "Cannot find <map> root element" );
+        // find the XML root
+        while( Scanner.TagName != "map" || Scanner.IsClosingTag )
+          if( !Scanner.ReadNextTag() )
+            throw runtime_error( "Cannot find <map> root element" );
         
         // obtain map dimensions
-        int MapWidth = GetRequiredIntegerAttribute( MapRoot, "width" );
-        int MapHeight = GetRequiredIntegerAttribute( MapRoot, "height" );
+        int MapWidth = Scanner.GetRequiredIntegerAttribute( "width" );
+        int MapHeight = Scanner.GetRequiredIntegerAttribute( "height" );
         
         // in Tiled, tile IDs never start from 0, so
         // identify the first tile ID for the tileset
-        XMLElement* MapTileSet = GetRequiredElement( MapRoot, "tileset" );
-        int FirstTileID = GetRequiredIntegerAttribute( MapTileSet, "firstgid" );
+        // (tilesets are always placed before layers)
+        int FirstTileID = -1;
         
         // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
         // STEP 2: Save each tile map layers to a separate file
@@ -278,60 +252,54 @@ int main( int NumberOfArguments, char* Arguments[] )
         
         // iterate all layers, saving each layer to
         // a different embedded file using the layer name
-        XMLElement* MapLayer = MapRoot->FirstChildElement( "layer" );
+        string LayerName;
         
-        while( MapLayer != nullptr )
+        while( Scanner.ReadNextTag() )
         {
-            // read its name
-            string LayerName = GetRequiredStringAttribute( MapLayer, "name" );
-            string FilePath = OutputFolder + LayerName + ".vmap";
+            if( Scanner.IsClosingTag )
+              continue;
+            
+            if( Scanner.TagName == "tileset" && FirstTileID < 0 )
+              FirstTileID = Scanner.GetRequiredIntegerAttribute( "firstgid" );
+            
+            if( Scanner.TagName == "layer" )
+              LayerName = Scanner.GetRequiredAttribute( "name" );
             
+            // each layer has its tiles in a <data> element
+            if( Scanner.TagName != "data" )
+              continue;
+            
+            if( FirstTileID < 0 )
+              throw runtime_error( "Cannot find element <tileset> inside <map>" );
+            
+            string FilePath = OutputFolder + LayerName + ".vmap";
             cout << "Saving layer \"" << FilePath << "\"" << endl;
             
             // create a file with that name
-            ofstream OutputFile;
-            OpenOutputFile( OutputFile, FilePath, ios_base::binary | ios_base::trunc );
+            FILE* OutputFile = OpenOutputFile( FilePath );
             
-            if( !OutputFile.good() )
+            if( !OutputFile )
               throw runtime_error( "Cannot open output file" );
-              
-            // now transfer the actual tile data
-            XMLElement* TileData = GetRequiredElement( MapLayer, "data" );
-            string TilesText = TileData->GetText();
             
-            // load all tile positions as a CSV
-            // using a stringstream to make it easier
-            stringstream TilesStream( TilesText );
-            int NumberOfTiles = 0;
+            // now transfer the actual tile data
+            uint64_t NumberOfTiles = 0;
             
-            while( TilesStream )
+            try
             {
-                // get next number using comma as delimiter
-                string ValueText;
-                if( !getline( TilesStream, ValueText, ',' ) ) break;
-                
-                // convert number string to integer
-                uint32_t Number = atoi( ValueText.c_str() );
-                
-                // save the tile value normalized to the first id
-                if( (int)Number < FirstTileID )
-                  Number = FirstTileID;
-                
-                Number -= FirstTileID;
-                OutputFile.write( (char*)(&Number), 4 );
-                
-                // count the tiles
-                NumberOfTiles++;
+                NumberOfTiles = ConvertLayerData( Scanner, OutputFile, FirstTileID );
+                fclose( OutputFile );
+            }
+            catch(...)
+            {
+                // ensure the file is never left open
+                fclose( OutputFile );
+                throw;
             }
             
             // check that we have obtained the correct number of tiles
-            if( NumberOfTiles != (MapWidth * MapHeight) )
+            if( NumberOfTiles != (uint64_t)MapWidth * MapHeight )
               cout << "Warning: Expected " << MapWidth << "x" << MapHeight << " tiles (total "
-                   << MapWidth * MapHeight << "), found " << NumberOfTiles << endl;
-            
-            // go to next layer
-            OutputFile.close();
-            MapLayer = MapLayer->NextSiblingElement( "layer" );
+                   << (uint64_t)MapWidth * MapHeight << "), found " << NumberOfTiles << endl;
         }
     }
     
@@ -0,0 +1,269 @@
+// *****************************************************************************
+    // include project headers
+    #include "SincResampler.hpp"
+    
+    // include C/C++ headers
+    #include <algorithm>        // [ C++ STL ] Algorithms
+    #include <stdexcept>        // [ C++ STL ] Exceptions
+    #include <cmath>            // [ ANSI C ] Mathematics
+    
+    // use SSE for the filter when the target has it
+    #if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+      #define RESAMPLER_USE_SSE
+      #include <xmmintrin.h>    // [ SSE ] Intrinsics
+    #endif
+    
+    // declare used namespaces
+    using namespace std;
+// *****************************************************************************
+
+
+// =============================================================================
+//      FILTER DESIGN
+// =============================================================================
+
+
+const double Pi = 3.14159265358979323846;
+
+// filter settings for each quality level
+const int    QualityTaps[ 4 ]   = { 8, 16, 32, 64 };
+const double QualityBetas[ 4 ]  = { 5.0, 6.5, 8.0, 9.5 };
+const double QualityCutoff[ 4 ] = { 0.85, 0.90, 0.94, 0.96 };
+
+// limits to keep the filter table small
+const int MaxPhases = 4096;
+const int MaxTaps = 1024;
+
+// input frames to discard at once from history
+const size_t HistoryDiscardFrames = 4096;
+
+// -----------------------------------------------------------------------------
+
+// modified Bessel function of order 0, used by
+// the Kaiser window (its series converges fast)
+double BesselI0( double x )
+{
+    double Sum = 1, Term = 1;
+    
+    for( int k = 1; k < 50; k++ )
+    {
+        double Factor = x / (2 * k);
+        Term *= Factor * Factor;
+        Sum += Term;
+        
+        if( Term < Sum * 1e-17 )
+          break;
+    }
+    
+    return Sum;
+}
+
+// -----------------------------------------------------------------------------
+
+double Sinc( double x )
+{
+    if( fabs( x ) < 1e-12 )
+      return 1;
+    
+    return sin( Pi * x ) / (Pi * x);
+}
+
+// -----------------------------------------------------------------------------
+
+uint64_t GreatestCommonDivisor( uint64_t a, uint64_t b )
+{
+    while( b )
+    {
+        uint64_t Remainder = a % b;
+        a = b;
+        b = Remainder;
+    }
+    
+    return a;
+}
+
+
+// =============================================================================
+//      SINC RESAMPLER: INSTANCE HANDLING
+// =============================================================================
+
+
+SincResampler::SincResampler()
+{
+    UpFactor = DownFactor = 1;
+    Taps = Phases = 0;
+    HistoryFirstFrame = 0;
+    OutputFrame = 0;
+}
+
+// -----------------------------------------------------------------------------
+
+void SincResampler::Initialize( int InputRate, int OutputRate, int Quality )
+{
+    if( InputRate <= 0 || OutputRate <= 0 )
+      throw runtime_error( "invalid sample rates for conversion" );
+    
+    Quality = max( 0, min( Quality, 3 ) );
+    
+    uint64_t Divisor = GreatestCommonDivisor( InputRate, OutputRate );
+    UpFactor = OutputRate / Divisor;
+    DownFactor = InputRate / Divisor;
+    
+    // when lowering the rate the filter gets wider,
+    // so that its cutoff follows the output rate
+    double Stretch = max( 1.0, (double)InputRate / OutputRate );
+    double Cutoff = 0.5 * QualityCutoff[ Quality ] / Stretch;
+    
+    Taps = (int)ceil( QualityTaps[ Quality ] * Stretch );
+    Taps = min( Taps + (Taps & 1), MaxTaps );
+    Phases = (int)min< uint64_t >( UpFactor, MaxPhases );
+    
+    // compute the filter for every phase; each is
+    // normalized so that it keeps constant signals
+    Coefficients.resize( 2 * Phases * Taps );
+    double Beta = QualityBetas[ Quality ];
+    double HalfTaps = Taps / 2;
+    
+    for( int p = 0; p < Phases; p++ )
+    {
+        double Offset = (double)p / Phases;
+        vector< double > Filter( Taps );
+        double Sum = 0;
+        
+        for( int t = 0; t < Taps; t++ )
+        {
+            // distance from the output position
+            double x = t - (HalfTaps - 1) - Offset;
+            double WindowPosition = x / HalfTaps;
+            double Window = BesselI0( Beta * sqrt( max( 0.0, 1 - WindowPosition * WindowPosition ) ) ) / BesselI0( Beta );
+            
+            Filter[ t ] = 2 * Cutoff * Sinc( 2 * Cutoff * x ) * Window;
+            Sum += Filter[ t ];
+        }
+        
+        float* PhaseCoefficients = &Coefficients[ 2 * p * Taps ];
+        
+        for( int t = 0; t < Taps; t++ )
+        {
+            PhaseCoefficients[ 2 * t     ] = Filter[ t ] / Sum;
+            PhaseCoefficients[ 2 * t + 1 ] = Filter[ t ] / Sum;
+        }
+    }
+    
+    // the first output frame is centered on input
+    // frame 0, so history starts with silence
+    History.assign( 2 * (Taps / 2 - 1), 0.0f );
+    HistoryFirstFrame = -(Taps / 2 - 1);
+    OutputFrame = 0;
+}
+
+
+// =============================================================================
+//      SINC RESAMPLER: INPUT
+// =============================================================================
+
+
+void SincResampler::AddInput( const float* StereoFrames, size_t NumberOfFrames )
+{
+    History.insert( History.end(), StereoFrames, StereoFrames + 2 * NumberOfFrames );
+}
+
+// -----------------------------------------------------------------------------
+
+// silence after the end lets the filter reach
+// output frames centered on the last input ones
+void SincResampler::Finish()
+{
+    History.resize( History.size() + 2 * (Taps / 2), 0.0f );
+}
+
+
+// =============================================================================
+//      SINC RESAMPLER: OUTPUT
+// =============================================================================
+
+
+size_t SincResampler::ProduceOutput( vector< SoundSample >& Output, size_t MaxFrames )
+{
+    Output.clear();
+    int64_t HistoryFrames = History.size() / 2;
+    
+    while( Output.size() < MaxFrames )
+    {
+        // find the position of this frame in the input
+        uint64_t InputPosition = OutputFrame * DownFactor;
+        int64_t CenterFrame = InputPosition / UpFactor;
+        uint64_t PhaseIndex = (InputPosition % UpFactor) * Phases / UpFactor;
+        
+        // check that all needed input is available
+        int64_t FirstFrame = CenterFrame - (Taps / 2 - 1);
+        
+        if( FirstFrame + Taps > HistoryFirstFrame + HistoryFrames )
+          break;
+        
+        const float* Input = &History[ 2 * (FirstFrame - HistoryFirstFrame) ];
+        const float* Filter = &Coefficients[ 2 * PhaseIndex * Taps ];
+        float Left, Right;
+        
+        #if defined(RESAMPLER_USE_SSE)
+          
+          // with interleaved input and repeated coefficients,
+          // both channels are filtered at once: each register
+          // holds 2 stereo frames, and taps are always even
+          __m128 Sum = _mm_setzero_ps();
+          
+          for( int i = 0; i < 2 * Taps; i += 4 )
+            Sum = _mm_add_ps( Sum, _mm_mul_ps( _mm_loadu_ps( Input + i ), _mm_loadu_ps( Filter + i ) ) );
+          
+          float Lanes[ 4 ];
+          _mm_storeu_ps( Lanes, Sum );
+          Left = Lanes[ 0 ] + Lanes[ 2 ];
+          Right = Lanes[ 1 ] + Lanes[ 3 ];
+        
+        #else
+          
+          Left = Right = 0;
+          
+          for( int i = 0; i < 2 * Taps; i += 2 )
+          {
+              Left += Input[ i ] * Filter[ i ];
+              Right += Input[ i + 1 ] * Filter[ i + 1 ];
+          }
+        
+        #endif
+        
+        SoundSample Sample;
+        Sample.LeftSample = FloatToSample( Left );
+        Sample.RightSample = FloatToSample( Right );
+        Output.push_back( Sample );
+        OutputFrame++;
+    }
+    
+    // discard input no longer needed, but only in
+    // large blocks to avoid moving history too often
+    int64_t NextFirstFrame = (int64_t)(OutputFrame * DownFactor / UpFactor) - (Taps / 2 - 1);
+    int64_t UnusedFrames = NextFirstFrame - HistoryFirstFrame;
+    
+    if( UnusedFrames >= (int64_t)HistoryDiscardFrames )
+    {
+        History.erase( History.begin(), History.begin() + 2 * UnusedFrames );
+        HistoryFirstFrame = NextFirstFrame;
+    }
+    
+    return Output.size();
+}
+
+
+// =============================================================================
+//      SAMPLE CONVERSION
+// =============================================================================
+
+
+int16_t FloatToSample( float Value )
+{
+    float Scaled = roundf( Value * 32768.0f );
+    
+    if( Scaled > 32767.0f )  return 32767;
+    if( Scaled < -32768.0f ) return -32768;
+    return (int16_t)Scaled;
+}
@@ -0,0 +1,81 @@
+// *****************************************************************************
+    // start include guard
+    #ifndef SINCRESAMPLER_HPP
+    #define SINCRESAMPLER_HPP
+    
+    // include project headers
+    #include "WavFormat.hpp"
+    
+    // include C/C++ headers
+    #include <vector>           // [ C++ STL ] Vectors
+    #include <cstddef>          // [ ANSI C ] Standard definitions
+    #include <cstdint>          // [ ANSI C ] Standard integer types
+// *****************************************************************************
+
+
+// =============================================================================
+//      STREAMING SAMPLE RATE CONVERSION
+// =============================================================================
+
+
+// Band-limited resampler for stereo sounds. Rates are
+// reduced to a ratio of integers L/M, and every output
+// frame is computed as a dot product of the input frames
+// around it with one of the phases of a Kaiser-windowed
+// sinc filter, precomputed on initialization. When the
+// rate is lowered the filter cutoff follows the output
+// rate, so that frequencies it can't represent are removed
+// instead of folding back into the audible range.
+// Input is given in blocks, and only the frames still
+// needed by the filter are kept.
+class SincResampler
+{
+    protected:
+        
+        // rate ratio
+        uint64_t UpFactor;
+        uint64_t DownFactor;
+        
+        // filter for each phase, with every
+        // coefficient repeated for both channels
+        int Taps;
+        int Phases;
+        std::vector< float > Coefficients;
+        
+        // stereo input not yet fully used
+        std::vector< float > History;
+        int64_t HistoryFirstFrame;
+        
+        // next frame to produce
+        uint64_t OutputFrame;
+        
+    public:
+        
+        // instance handling
+        SincResampler();
+        void Initialize( int InputRate, int OutputRate, int Quality );
+        
+        // adding input (as interleaved stereo floats);
+        // after the last block, call Finish to flush
+        void AddInput( const float* StereoFrames, size_t NumberOfFrames );
+        void Finish();
+        
+        // produces as many output frames as the
+        // current input allows, up to a maximum
+        size_t ProduceOutput( std::vector< SoundSample >& Output, size_t MaxFrames );
+};
+
+
+// =============================================================================
+//      SAMPLE CONVERSION
+// =============================================================================
+
+
+// rounds and saturates to 16 bits
+int16_t FloatToSample( float Value );
+
+
+// *****************************************************************************
+    // end include guard
+    #endif
+// *****************************************************************************
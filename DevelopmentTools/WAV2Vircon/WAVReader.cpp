@@ -0,0 +1,302 @@
+// *****************************************************************************
+    // include infrastructure headers
+    #include "../DevToolsInfrastructure/FilePaths.hpp"
+    
+    // include project headers
+    #include "WAVReader.hpp"
+    #include "WavFormat.hpp"
+    
+    // include C/C++ headers
+    #include <algorithm>        // [ C++ STL ] Algorithms
+    #include <cstring>          // [ ANSI C ] Strings
+    
+    // declare used namespaces
+    using namespace std;
+// *****************************************************************************
+
+
+// =============================================================================
+//      FORMAT CODES IN WAV FILES
+// =============================================================================
+
+
+const uint16_t WAVFormatPCM        = 0x0001;
+const uint16_t WAVFormatFloat      = 0x0003;
+const uint16_t WAVFormatExtensible = 0xFFFE;
+
+// frames read from the file at once
+const size_t ReadBlockFrames = 4096;
+
+
+// =============================================================================
+//      WAV READER: INSTANCE HANDLING
+// =============================================================================
+
+
+WAVReader::WAVReader()
+{
+    WAVFile = nullptr;
+    RemainingFrames = 0;
+    BytesPerSample = BlockAlign = 0;
+    SampleRate = NumberOfChannels = BitsPerSample = 0;
+    IsFloat = false;
+    NumberOfFrames = 0;
+    IsTruncated = false;
+}
+
+// -----------------------------------------------------------------------------
+
+WAVReader::~WAVReader()
+{
+    Close();
+}
+
+
+// =============================================================================
+//      WAV READER: AUXILIARY FUNCTIONS
+// =============================================================================
+
+
+bool WAVReader::ReadFormat( uint32_t FormatSize )
+{
+    if( FormatSize < sizeof(FormatSubchunkBody) )
+      return false;
+    
+    FormatSubchunkBody Format;
+    
+    if( fread( &Format, sizeof(FormatSubchunkBody), 1, WAVFile ) != 1 )
+      return false;
+    
+    uint16_t FormatCode = Format.AudioFormat;
+    
+    // extensible format gives the actual
+    // format code in its sub-format GUID
+    if( FormatCode == WAVFormatExtensible )
+    {
+        uint8_t Extension[ 24 ];
+        
+        if( FormatSize < sizeof(FormatSubchunkBody) + 24 )
+          return false;
+        
+        if( fread( Extension, 24, 1, WAVFile ) != 1 )
+          return false;
+        
+        memcpy( &FormatCode, &Extension[ 8 ], 2 );
+    }
+    
+    SampleRate = Format.SampleRate;
+    NumberOfChannels = Format.NumberOfChannels;
+    BitsPerSample = Format.BitsPerSample;
+    BlockAlign = Format.BlockAlign;
+    BytesPerSample = (BitsPerSample + 7) / 8;
+    
+    // other formats are compressed
+    if( FormatCode == WAVFormatPCM )
+    {
+        IsFloat = false;
+        
+        if( BitsPerSample < 8 || BitsPerSample > 32 )
+          return false;
+    }
+    
+    else if( FormatCode == WAVFormatFloat )
+    {
+        IsFloat = true;
+        
+        if( BitsPerSample != 32 && BitsPerSample != 64 )
+          return false;
+    }
+    
+    else return false;
+    
+    // discard inconsistent formats
+    if( SampleRate <= 0 || NumberOfChannels < 1 )
+      return false;
+    
+    return (BlockAlign >= NumberOfChannels * BytesPerSample);
+}
+
+// -----------------------------------------------------------------------------
+
+double WAVReader::ReadSample( const uint8_t* SampleBytes )
+{
+    if( IsFloat )
+    {
+        if( BytesPerSample == 4 )
+        {
+            float Value;
+            memcpy( &Value, SampleBytes, 4 );
+            return Value;
+        }
+        
+        double Value;
+        memcpy( &Value, SampleBytes, 8 );
+        return Value;
+    }
+    
+    // 8-bit samples are the only unsigned ones
+    if( BytesPerSample == 1 )
+      return (SampleBytes[ 0 ] - 128) / 128.0;
+    
+    // place the sample bytes at the top of a 32-bit
+    // integer; this also sign extends the sample
+    uint32_t Bits = 0;
+    
+    for( int i = 0; i < BytesPerSample; i++ )
+      Bits |= (uint32_t)SampleBytes[ i ] << (8 * (4 - BytesPerSample + i));
+    
+    return (int32_t)Bits / 2147483648.0;
+}
+
+
+// =============================================================================
+//      WAV READER: READING FILES
+// =============================================================================
+
+
+bool WAVReader::Open( const string& FilePath )
+{
+    Close();
+    IsTruncated = false;
+    
+    // we need the file size to check data length
+    uint64_t FileSize;
+    int64_t ModificationTime;
+    
+    if( !GetFileStatus( FilePath, FileSize, ModificationTime ) )
+      return false;
+    
+    WAVFile = OpenInputFile( FilePath );
+    
+    if( !WAVFile )
+      return false;
+    
+    // check the RIFF header
+    RIFFChunkHeader RIFFHeader;
+    
+    if( fread( &RIFFHeader, sizeof(RIFFChunkHeader), 1, WAVFile ) != 1
+    ||  memcmp( RIFFHeader.ChunkID, "RIFF", 4 )
+    ||  memcmp( RIFFHeader.Format, "WAVE", 4 ) )
+    {
+        Close();
+        return false;
+    }
+    
+    // find the format and data subchunks; any
+    // others are skipped (with their padding)
+    uint64_t FilePosition = sizeof(RIFFChunkHeader);
+    bool FormatFound = false;
+    
+    while( true )
+    {
+        SubchunkHeader Subchunk;
+        
+        if( fread( &Subchunk, sizeof(SubchunkHeader), 1, WAVFile ) != 1 )
+        {
+            Close();
+            return false;
+        }
+        
+        FilePosition += sizeof(SubchunkHeader);
+        
+        if( !memcmp( Subchunk.SubchunkID, "fmt ", 4 ) )
+        {
+            if( !ReadFormat( Subchunk.SubchunkSize ) )
+            {
+                Close();
+                return false;
+            }
+            
+            FormatFound = true;
+        }
+        
+        else if( !memcmp( Subchunk.SubchunkID, "data", 4 ) )
+        {
+            if( !FormatFound )
+            {
+                Close();
+                return false;
+            }
+            
+            // writers that don't know the data size in advance
+            // set it to the maximum, so take the rest of the file
+            uint64_t DataBytes = Subchunk.SubchunkSize;
+            uint64_t RemainingBytes = FileSize - FilePosition;
+            
+            if( Subchunk.SubchunkSize == 0xFFFFFFFF )
+              DataBytes = RemainingBytes;
+            
+            // otherwise a shorter file has lost part of the data
+            if( DataBytes > RemainingBytes )
+            {
+                IsTruncated = true;
+                DataBytes = RemainingBytes;
+            }
+            
+            NumberOfFrames = DataBytes / BlockAlign;
+            RemainingFrames = NumberOfFrames;
+            ReadBuffer.resize( ReadBlockFrames * BlockAlign );
+            return true;
+        }
+        
+        // skip the rest of this subchunk
+        uint64_t SubchunkEnd = FilePosition + Subchunk.SubchunkSize + (Subchunk.SubchunkSize & 1);
+        
+        if( SubchunkEnd >= FileSize || fseek( WAVFile, (long)SubchunkEnd, SEEK_SET ) != 0 )
+        {
+            Close();
+            return false;
+        }
+        
+        FilePosition = SubchunkEnd;
+    }
+}
+
+// -----------------------------------------------------------------------------
+
+void WAVReader::Close()
+{
+    if( WAVFile )
+      fclose( WAVFile );
+    
+    WAVFile = nullptr;
+    RemainingFrames = 0;
+}
+
+// -----------------------------------------------------------------------------
+
+size_t WAVReader::ReadFrames( float* StereoFrames, size_t MaxFrames )
+{
+    size_t FramesRead = 0;
+    
+    while( FramesRead < MaxFrames && RemainingFrames > 0 )
+    {
+        size_t BlockFrames = min< uint64_t >( min( MaxFrames - FramesRead, ReadBlockFrames ), RemainingFrames );
+        size_t BlockFramesRead = fread( ReadBuffer.data(), BlockAlign, BlockFrames, WAVFile );
+        
+        // with multiple channels, take left and right
+        // as the first 2; mono sounds go in both
+        int RightOffset = (NumberOfChannels > 1)? BytesPerSample : 0;
+        
+        for( size_t i = 0; i < BlockFramesRead; i++ )
+        {
+            const uint8_t* Frame = &ReadBuffer[ i * BlockAlign ];
+            StereoFrames[ 2 * FramesRead     ] = ReadSample( Frame );
+            StereoFrames[ 2 * FramesRead + 1 ] = ReadSample( Frame + RightOffset );
+            FramesRead++;
+        }
+        
+        // a file shorter than its header says
+        // ends the data at the last full frame
+        if( BlockFramesRead < BlockFrames )
+        {
+            IsTruncated = true;
+            RemainingFrames = 0;
+            break;
+        }
+        
+        RemainingFrames -= BlockFramesRead;
+    }
+    
+    return FramesRead;
+}
@@ -0,0 +1,74 @@
+// *****************************************************************************
+    // start include guard
+    #ifndef WAVREADER_HPP
+    #define WAVREADER_HPP
+    
+    // include C/C++ headers
+    #include <string>           // [ C++ STL ] Strings
+    #include <vector>           // [ C++ STL ] Vectors
+    #include <cstdio>           // [ ANSI C ] Standard I/O
+    #include <cstdint>          // [ ANSI C ] Standard integer types
+// *****************************************************************************
+
+
+// =============================================================================
+//      STREAMING READER FOR WAV FILES
+// =============================================================================
+
+
+// Reads uncompressed WAV files (integer PCM of 8, 16, 24
+// or 32 bits, or 32/64-bit float) a block at a time, so
+// that memory use does not depend on the file length.
+// Samples are given as stereo pairs of floats in range
+// [-1,1]: mono files are duplicated in both channels, and
+// for more than 2 channels only the first 2 are used.
+class WAVReader
+{
+    protected:
+        
+        FILE* WAVFile;
+        uint64_t RemainingFrames;
+        std::vector< uint8_t > ReadBuffer;
+        
+        // format details
+        int BytesPerSample;
+        int BlockAlign;
+        
+        // auxiliary functions
+        bool ReadFormat( uint32_t FormatSize );
+        double ReadSample( const uint8_t* SampleBytes );
+        
+    public:
+        
+        // format of the input
+        int SampleRate;
+        int NumberOfChannels;
+        int BitsPerSample;
+        bool IsFloat;
+        uint64_t NumberOfFrames;
+        
+        // set when the file ends before the
+        // data size given in its header
+        bool IsTruncated;
+        
+    public:
+        
+        // instance handling
+        WAVReader();
+       ~WAVReader();
+        
+        // returns false if the file is not a WAV
+        // or its format is not supported for streaming
+        bool Open( const std::string& FilePath );
+        void Close();
+        
+        // returns the number of frames read,
+        // which is only 0 at the end of the data
+        size_t ReadFrames( float* StereoFrames, size_t MaxFrames );
+};
+
+
+// *****************************************************************************
+    // end include guard
+    #endif
+// *****************************************************************************
@@ -2,6 +2,9 @@
     // start include guard
     #ifndef WAVFORMAT_HPP
     #define WAVFORMAT_HPP
+    
+    // include C/C++ headers
+    #include <cstdint>          // [ ANSI C ] Standard integer types
 // *****************************************************************************
 
 
@@ -5,6 +5,10 @@
     // include infrastructure headers
     #include "../DevToolsInfrastructure/FilePaths.hpp"
     
+    // include project headers
+    #include "WAVReader.hpp"
+    #include "SincResampler.hpp"
+    
     // include C/C++ headers
     #include <iostream>         // [ C++ STL ] I/O Streams
     #include <string>           // [ C++ STL ] Strings
@@ -34,6 +38,7 @@
 
 
 bool VerboseMode = false;
+int ResamplingQuality = 2;
 
 
 // =============================================================================
@@ -115,6 +120,14 @@ void LoadWAV( const char *WAVFilePath, int OutputRate )
 
 // -----------------------------------------------------------------------------
 
+void WriteOutputData( const void* Data, size_t Size, size_t Count, FILE* OutputFile )
+{
+    if( fwrite( Data, Size, Count, OutputFile ) != Count )
+      throw runtime_error( "cannot write to output file" );
+}
+
+// -----------------------------------------------------------------------------
+
 void SaveVSND( const char *VSNDFilePath )
 {
     // open output file
@@ -128,15 +141,175 @@ void SaveVSND( const char *VSNDFilePath )
     memcpy( VSNDHeader.Signature, SoundFileFormat::Signature, 8 );
     VSNDHeader.SoundSamples = NumberOfSamples;
     
-    // write the header in the file
-    fseek( VSNDFile, 0, SEEK_SET );
-    fwrite( &VSNDHeader, sizeof(SoundFileFormat::Header), 1, VSNDFile );
+    // write the header and then all samples,
+    // never leaving an incomplete file behind
+    try
+    {
+        fseek( VSNDFile, 0, SEEK_SET );
+        WriteOutputData( &VSNDHeader, sizeof(SoundFileFormat::Header), 1, VSNDFile );
+        
+        if( NumberOfSamples > 0 )
+          WriteOutputData( &RawSamples[0], 4, NumberOfSamples, VSNDFile );
+    }
     
-    // now write all samples
-    fwrite( &RawSamples[0], NumberOfSamples*4, 1, VSNDFile );
+    catch( ... )
+    {
+        fclose( VSNDFile );
+        remove( VSNDFilePath );
+        throw;
+    }
     
     // close our file
-    fclose( VSNDFile );
+    if( fclose( VSNDFile ) != 0 )
+    {
+        remove( VSNDFilePath );
+        throw runtime_error( "cannot write to output file" );
+    }
+}
+
+
+// =============================================================================
+//      STREAMING SOUND CONVERSION
+// =============================================================================
+
+
+// frames processed at once when streaming
+const size_t StreamBlockFrames = 16384;
+
+// -----------------------------------------------------------------------------
+
+void CheckInputIsComplete( const WAVReader& Reader )
+{
+    if( Reader.IsTruncated )
+      throw runtime_error( "input file is truncated: it has less sound data than its header says" );
+}
+
+// -----------------------------------------------------------------------------
+
+// Converts uncompressed WAV files a block at a time, so memory
+// use stays constant for any sound length. Returns false when
+// the input format is not supported here (compressed formats),
+// and then the conversion must be done by SDL instead.
+bool ConvertWAVStreaming( const string& WAVFilePath, const string& VSNDFilePath, int OutputRate )
+{
+    WAVReader Reader;
+    
+    if( !Reader.Open( WAVFilePath ) )
+      return false;
+    
+    CheckInputIsComplete( Reader );
+    
+    if( VerboseMode )
+    {
+        cout << "input format: " << Reader.SampleRate << " Hz, " << Reader.NumberOfChannels << " channels, ";
+        cout << Reader.BitsPerSample << " bits" << (Reader.IsFloat? " float" : "") << endl;
+    }
+    
+    // for output rate = 0 do not alter the input rate
+    if( OutputRate == 0 )
+    {
+        OutputRate = Reader.SampleRate;
+        
+        if( VerboseMode )
+          cout << "using input sample rate of " << OutputRate << " Hz" << endl;
+    }
+    
+    // output length is known before conversion,
+    // so the header can be written in advance
+    uint64_t OutputSamples = (Reader.NumberOfFrames * OutputRate + Reader.SampleRate - 1) / Reader.SampleRate;
+    
+    if( OutputSamples > 0xFFFFFFFFu / 4 )
+      throw runtime_error( "sound is too long for a VSND file" );
+    
+    FILE *VSNDFile = OpenOutputFile( VSNDFilePath );
+    
+    if( !VSNDFile )
+      throw runtime_error( string("Cannot open output file \"") + VSNDFilePath + "\"" );
+    
+    // an incomplete output file must not remain,
+    // so on any error it is closed and deleted
+    try
+    {
+        SoundFileFormat::Header VSNDHeader;
+        memcpy( VSNDHeader.Signature, SoundFileFormat::Signature, 8 );
+        VSNDHeader.SoundSamples = OutputSamples;
+        WriteOutputData( &VSNDHeader, sizeof(SoundFileFormat::Header), 1, VSNDFile );
+        
+        if( VerboseMode )
+          cout << "converting sound to Vircon format" << endl;
+        
+        // without a rate change samples are just converted,
+        // which keeps 16-bit stereo input exactly the same
+        bool Resampling = (OutputRate != Reader.SampleRate);
+        SincResampler Resampler;
+        
+        if( Resampling )
+          Resampler.Initialize( Reader.SampleRate, OutputRate, ResamplingQuality );
+        
+        vector< float > InputBlock( 2 * StreamBlockFrames );
+        vector< SoundSample > OutputBlock;
+        uint64_t SamplesWritten = 0;
+        bool InputEnded = false;
+        
+        while( SamplesWritten < OutputSamples )
+        {
+            size_t FramesRead = 0;
+            
+            if( !InputEnded )
+            {
+                FramesRead = Reader.ReadFrames( InputBlock.data(), StreamBlockFrames );
+                InputEnded = (FramesRead == 0);
+                CheckInputIsComplete( Reader );
+            }
+            
+            if( Resampling )
+            {
+                if( FramesRead > 0 )
+                  Resampler.AddInput( InputBlock.data(), FramesRead );
+                else
+                  Resampler.Finish();
+                
+                Resampler.ProduceOutput( OutputBlock, OutputSamples - SamplesWritten );
+            }
+            
+            else
+            {
+                OutputBlock.resize( FramesRead );
+                
+                for( size_t i = 0; i < FramesRead; i++ )
+                {
+                    OutputBlock[ i ].LeftSample = FloatToSample( InputBlock[ 2 * i ] );
+                    OutputBlock[ i ].RightSample = FloatToSample( InputBlock[ 2 * i + 1 ] );
+                }
+            }
+            
+            // all input was read, so only rounding of the
+            // output length can leave a last sample or so
+            if( InputEnded && OutputBlock.empty() )
+              OutputBlock.resize( OutputSamples - SamplesWritten, SoundSample{ 0, 0 } );
+            
+            if( !OutputBlock.empty() )
+              WriteOutputData( OutputBlock.data(), sizeof(SoundSample), OutputBlock.size(), VSNDFile );
+            
+            SamplesWritten += OutputBlock.size();
+        }
+    }
+    
+    catch( ... )
+    {
+        fclose( VSNDFile );
+        remove( VSNDFilePath.c_str() );
+        throw;
+    }
+    
+    // buffered data is only written when closing
+    if( fclose( VSNDFile ) != 0 )
+    {
+        remove( VSNDFilePath.c_str() );
+        throw runtime_error( "cannot write to output file" );
+    }
+    
+    return true;
 }
 
 
@@ -154,6 +327,7 @@ void PrintUsage()
     cout << "  -o <file>    Output file, default name is the same as input" << endl;
     cout << "  -r <rate>    Output sample rate. Default is 44100Hz (Vircon32 native)" << endl;
     cout << "               Rate = 0 means output keeps same sample rate as input" << endl;
+    cout << "  -q <level>   Resampling quality from 0 (fastest) to 3 (best), default is 2" << endl;
     cout << "  -v           Displays additional information (verbose)" << endl;
 }
 
@@ -266,6 +440,30 @@ int main( int NumberOfArguments, char* Arguments[] )
                 continue;
             }
             
+            if( ArgumentsUTF8[i] == string("-q") )
+            {
+                // expect another argument
+                i++;
+                
+                if( i >= NumberOfArguments )
+                  throw runtime_error( "missing quality level after '-q'" );
+                
+                // try to parse an integer from quality argument
+                try
+                {
+                    ResamplingQuality = stoi( ArgumentsUTF8[ i ] );
+                }
+                catch( const exception& e )
+                {
+                    throw runtime_error( "cannot read quality level as an integer" );
+                }
+                
+                if( ResamplingQuality < 0 || ResamplingQuality > 3 )
+                  throw runtime_error( "bad quality level (valid range is 0-3)" );
+                
+                continue;
+            }
+            
             // discard any other parameters starting with '-'
             if( ArgumentsUTF8[i][0] == '-' )
               throw runtime_error( string("unrecognized command line option '") + ArgumentsUTF8[i] + "'" );
@@ -296,28 +494,40 @@ int main( int NumberOfArguments, char* Arguments[] )
         }
         
         // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-        // STEP 1: Load the WAV sound
+        // Convert uncompressed WAV files while reading them
         
-        // initialize SDL
-        if( SDL_Init( SDL_INIT_AUDIO ) != 0 )
-          throw runtime_error( string("cannot initialize SDL: ") + SDL_GetError() );
+        // first check if the file exists
+        if( !FileExists( InputPath ) )
+          throw runtime_error( string("cannot open input file \"") + InputPath + "\"" );
         
-        // now we can actually load the wav file
         if( VerboseMode )
           cout << "loading input file \"" << InputPath << "\"" << endl;
         
-        LoadWAV( InputPath.c_str(), OutputRate );
-        
-        // we are done with SDL
-        SDL_Quit();
-        
-        // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-        // STEP 2: Save the VSND file
-        
-        if( VerboseMode )
-          cout << "saving output file \"" << OutputPath << "\"" << endl;
-        
-        SaveVSND( OutputPath.c_str() );
+        if( !ConvertWAVStreaming( InputPath, OutputPath, OutputRate ) )
+        {
+            // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+            // STEP 1: Load other WAV sounds with SDL
+            
+            if( VerboseMode )
+              cout << "input format is not uncompressed PCM, using SDL to load it" << endl;
+            
+            // initialize SDL
+            if( SDL_Init( SDL_INIT_AUDIO ) != 0 )
+              throw runtime_error( string("cannot initialize SDL: ") + SDL_GetError() );
+            
+            LoadWAV( InputPath.c_str(), OutputRate );
+            
+            // we are done with SDL
+            SDL_Quit();
+            
+            // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+            // STEP 2: Save the VSND file
+            
+            if( VerboseMode )
+              cout << "saving output file \"" << OutputPath << "\"" << endl;
+            
+            SaveVSND( OutputPath.c_str() );
+        }
     }
     
     catch( const exception& e )